@@ -11,6 +11,9 @@
 #ifdef HAVE_HSEARCHR
 #include <search.h>
 #endif
+#ifdef __linux__
+#include <sched.h>
+#endif
 #include <sys/time.h>
 
 struct timeval start;
@@ -48,6 +51,131 @@ int timeGetDiffMicroseconds (void)
 	return (int) diff;
 }
 
+/**
+ * Statistical harness
+ *
+ * Shared by all benchmark targets instead of hand-rolled timing loops.
+ * benchmarkMeasure() runs warmup iterations first, samples every
+ * iteration with a monotonic clock and reports order statistics, so
+ * single outliers (page faults, scheduler noise) do not distort the
+ * numbers. Pass `--output=json` or `--output=csv` (or set the
+ * environment variable KDB_BENCHMARK_OUTPUT) for machine-readable
+ * output and `--pin=<cpu>` to pin the process to one CPU.
+ */
+
+static const char * benchmarkOutput = "text";
+static int benchmarkReportedRuns = 0;
+
+void benchmarkHarnessInit (int argc, char ** argv)
+{
+	const char * env = getenv ("KDB_BENCHMARK_OUTPUT");
+	if (env != NULL) benchmarkOutput = env;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strncmp (argv[i], "--output=", 9) == 0)
+		{
+			benchmarkOutput = argv[i] + 9;
+		}
+		else if (strncmp (argv[i], "--pin=", 6) == 0)
+		{
+			if (benchmarkPinCpu (atoi (argv[i] + 6)) != 0)
+			{
+				fprintf (stderr, "warning: could not pin process to cpu %s\n", argv[i] + 6);
+			}
+		}
+	}
+}
+
+int benchmarkPinCpu (int cpu)
+{
+#ifdef __linux__
+	cpu_set_t cpus;
+	CPU_ZERO (&cpus);
+	CPU_SET (cpu, &cpus);
+	return sched_setaffinity (0, sizeof (cpus), &cpus);
+#else
+	(void) cpu;
+	return -1;
+#endif
+}
+
+static int benchmarkCompareSamples (const void * a, const void * b)
+{
+	const long long * la = a;
+	const long long * lb = b;
+	return (*la > *lb) - (*la < *lb);
+}
+
+static long long benchmarkPercentile (const long long * samples, size_t n, unsigned int percent)
+{
+	return samples[(percent * (n - 1) + 50) / 100];
+}
+
+void benchmarkMeasure (const char * name, size_t warmups, size_t iterations, BenchmarkFunction benchmark, void * data)
+{
+	if (iterations == 0) return;
+
+	long long * samples = elektraMalloc (iterations * sizeof (long long));
+
+	for (size_t i = 0; i < warmups; ++i)
+	{
+		benchmark (data);
+	}
+
+	double mean = 0.0;
+	for (size_t i = 0; i < iterations; ++i)
+	{
+		struct timespec begin, end;
+		clock_gettime (CLOCK_MONOTONIC, &begin);
+		benchmark (data);
+		clock_gettime (CLOCK_MONOTONIC, &end);
+		samples[i] = (end.tv_sec - begin.tv_sec) * 1000000LL + (end.tv_nsec - begin.tv_nsec) / 1000;
+		mean += (double) samples[i];
+	}
+	mean /= (double) iterations;
+
+	qsort (samples, iterations, sizeof (long long), benchmarkCompareSamples);
+
+	long long min = samples[0];
+	long long max = samples[iterations - 1];
+	long long median = benchmarkPercentile (samples, iterations, 50);
+	long long p90 = benchmarkPercentile (samples, iterations, 90);
+	long long p99 = benchmarkPercentile (samples, iterations, 99);
+
+	if (strcmp (benchmarkOutput, "json") == 0)
+	{
+		printf ("%s\n", benchmarkReportedRuns == 0 ? "[" : ",");
+		printf ("  { \"name\": \"%s\", \"unit\": \"us\", \"iterations\": %zu, \"warmups\": %zu, \"min\": %lld, "
+			"\"median\": %lld, \"mean\": %.2f, \"p90\": %lld, \"p99\": %lld, \"max\": %lld }",
+			name, iterations, warmups, min, median, mean, p90, p99, max);
+	}
+	else if (strcmp (benchmarkOutput, "csv") == 0)
+	{
+		if (benchmarkReportedRuns == 0)
+		{
+			printf ("name,unit,iterations,warmups,min,median,mean,p90,p99,max\n");
+		}
+		printf ("%s,us,%zu,%zu,%lld,%lld,%.2f,%lld,%lld,%lld\n", name, iterations, warmups, min, median, mean, p90, p99, max);
+	}
+	else
+	{
+		printf ("%20s: median %lld us (n=%zu, min %lld, mean %.2f, p90 %lld, p99 %lld, max %lld)\n", name, median, iterations,
+			min, mean, p90, p99, max);
+	}
+
+	++benchmarkReportedRuns;
+	elektraFree (samples);
+}
+
+void benchmarkHarnessFinish (void)
+{
+	if (strcmp (benchmarkOutput, "json") == 0 && benchmarkReportedRuns > 0)
+	{
+		printf ("\n]\n");
+	}
+}
+
 void benchmarkCreate (void)
 {
 	large = ksNew (num_key * num_dir, KS_END);
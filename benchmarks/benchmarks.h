@@ -32,10 +32,28 @@
 
 #define BUF_SIZ 50
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 void timeInit (void);
 void timePrint (char * msg);
 int timeGetDiffMicroseconds (void);
 
+/**
+ * Statistical harness
+ */
+
+#define BENCHMARK_WARMUPS 3
+#define BENCHMARK_ITERATIONS 11
+
+typedef void (*BenchmarkFunction) (void * data);
+
+void benchmarkHarnessInit (int argc, char ** argv);
+int benchmarkPinCpu (int cpu);
+void benchmarkMeasure (const char * name, size_t warmups, size_t iterations, BenchmarkFunction benchmark, void * data);
+void benchmarkHarnessFinish (void);
+
 void benchmarkCreate (void);
 void benchmarkFillup (void);
 
@@ -148,4 +166,8 @@ KeySet * generateKeySet (const size_t size, int32_t * seed, KeySetShape * shape)
 
 void printExit (const char * msg);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
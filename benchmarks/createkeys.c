@@ -13,7 +13,10 @@ void benchmarkDel (void)
 	ksDel (large);
 }
 
-int benchmarkIterate (void)
+// volatile so that the iteration loop is not optimized away
+static volatile int iterateCount;
+
+static void benchmarkIterate (void * data ELEKTRA_UNUSED)
 {
 	ksRewind (large);
 	Key * cur;
@@ -23,12 +26,12 @@ int benchmarkIterate (void)
 		// count to make sure the loop is executed
 		++c;
 	}
-	return c;
+	iterateCount = c;
 }
 
 int main (int argc, char ** argv)
 {
-	if (argc != 3)
+	if (argc < 3)
 	{
 		printf ("no arguments given, will exit\n");
 		printf ("usage %s dir key (both dir+key are numbers)\n", argv[0]);
@@ -41,6 +44,8 @@ int main (int argc, char ** argv)
 		printf ("Using %d dirs %d keys\n", num_dir, num_key);
 	}
 
+	benchmarkHarnessInit (argc, argv);
+
 	timeInit ();
 	benchmarkCreate ();
 	timePrint ("Created empty keyset");
@@ -48,9 +53,8 @@ int main (int argc, char ** argv)
 	benchmarkFillup ();
 	timePrint ("New large keyset");
 
-	benchmarkIterate ();
-	timePrint ("Iterated over keyset");
+	benchmarkMeasure ("ksIterate", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkIterate, NULL);
+	benchmarkHarnessFinish ();
 
 	benchmarkDel ();
-	timePrint ("Del large keyset");
 }
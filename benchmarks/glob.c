@@ -0,0 +1,107 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the glob plugin on large keysets
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <benchmarks.h>
+#include <kdbmodule.h>
+#include <kdbprivate.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_KEYS 100000
+#define KEYS_PER_DIR 100
+
+typedef struct
+{
+	Plugin * plugin;
+	KeySet * ks;
+	Key * parentKey;
+} BenchmarkData;
+
+static KeySet * generateGlobKeySet (size_t numKeys)
+{
+	KeySet * ks = ksNew ((ssize_t) numKeys, KS_END);
+	for (size_t i = 0; i < numKeys; ++i)
+	{
+		Key * key = keyNew (KEY_ROOT, KEY_VALUE, "value", KEY_END);
+		char name[64];
+		snprintf (name, sizeof (name), "dir%zu", i / KEYS_PER_DIR);
+		keyAddBaseName (key, name);
+		snprintf (name, sizeof (name), "key%zu", i % KEYS_PER_DIR);
+		keyAddBaseName (key, name);
+		ksAppendKey (ks, key);
+	}
+	return ks;
+}
+
+static void benchmarkGlobGet (void * data)
+{
+	BenchmarkData * benchmarkData = data;
+	benchmarkData->plugin->kdbGet (benchmarkData->plugin, benchmarkData->ks, benchmarkData->parentKey);
+}
+
+static void benchmarkGlobSet (void * data)
+{
+	BenchmarkData * benchmarkData = data;
+	benchmarkData->plugin->kdbSet (benchmarkData->plugin, benchmarkData->ks, benchmarkData->parentKey);
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkHarnessInit (argc, argv);
+
+	size_t numKeys = NUM_KEYS;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strncmp (argv[i], "--keys=", 7) == 0)
+		{
+			numKeys = strtoul (argv[i] + 7, NULL, 10);
+		}
+	}
+
+	/* a mix of patterns, so keys fall through to different depths of the list;
+	 * the values starting with '/' are completed with the parent key name */
+	KeySet * conf = ksNew (20, keyNew ("user:/glob/#1", KEY_VALUE, "/dir1/*", KEY_META, "benchmark/first", "1", KEY_END),
+			       keyNew ("user:/glob/#2", KEY_VALUE, "/*/key1", KEY_META, "benchmark/second", "2", KEY_END),
+			       keyNew ("user:/glob/#3", KEY_VALUE, "/*/key2?", KEY_META, "benchmark/third", "3", KEY_END),
+			       keyNew ("user:/glob/#3/flags", KEY_VALUE, "pathname,noescape", KEY_END),
+			       keyNew ("user:/glob/#4", KEY_VALUE, "/*/key*", KEY_META, "benchmark/fourth", "4", KEY_END), KS_END);
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, NULL);
+	Key * errorKey = keyNew ("/", KEY_END);
+	Plugin * plugin = elektraPluginOpen ("glob", modules, conf, errorKey);
+	keyDel (errorKey);
+
+	if (plugin == NULL)
+	{
+		fprintf (stderr, "notice: could not open plugin glob, skipping\n");
+		elektraModulesClose (modules, NULL);
+		ksDel (modules);
+		benchmarkHarnessFinish ();
+		return 0;
+	}
+
+	BenchmarkData data;
+	data.plugin = plugin;
+	data.ks = generateGlobKeySet (numKeys);
+	data.parentKey = keyNew (KEY_ROOT, KEY_END);
+
+	benchmarkMeasure ("glob/get", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkGlobGet, &data);
+	benchmarkMeasure ("glob/set", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkGlobSet, &data);
+
+	ksDel (data.ks);
+	keyDel (data.parentKey);
+	elektraPluginClose (plugin, NULL);
+	elektraModulesClose (modules, NULL);
+	ksDel (modules);
+
+	benchmarkHarnessFinish ();
+	return 0;
+}
@@ -11,26 +11,26 @@
 KDB * kdb;
 Key * key;
 
-void benchmarkOpen (void)
+void benchmarkOpen (void * data ELEKTRA_UNUSED)
 {
 	kdb = kdbOpen (NULL, key);
 }
 
-void benchmarkInread (void)
+void benchmarkInread (void * data ELEKTRA_UNUSED)
 {
 	KeySet * n = ksNew (0, KS_END);
 	kdbGet (kdb, n, key);
 	ksDel (n);
 }
 
-void benchmarkReadin (void)
+void benchmarkReadin (void * data ELEKTRA_UNUSED)
 {
 	KeySet * n = ksNew (0, KS_END);
 	kdbGet (kdb, n, key);
 	ksDel (n);
 }
 
-void benchmarkLookupByName (void)
+void benchmarkLookupByName (void * data ELEKTRA_UNUSED)
 {
 	int i, j;
 	char name[KEY_NAME_LENGTH + 1];
@@ -47,70 +47,50 @@ void benchmarkLookupByName (void)
 	}
 }
 
-void benchmarkReread (void)
+void benchmarkReread (void * data ELEKTRA_UNUSED)
 {
 	kdbGet (kdb, large, key);
 }
 
-void benchmarkInwrite (void)
+void benchmarkInwrite (void * data ELEKTRA_UNUSED)
 {
 	kdbSet (kdb, large, key);
 }
 
-void benchmarkRewrite (void)
+void benchmarkWriteout (void * data ELEKTRA_UNUSED)
 {
 	kdbSet (kdb, large, key);
 }
 
-void benchmarkWriteout (void)
-{
-	kdbSet (kdb, large, key);
-}
-
-void benchmarkClose (void)
+void benchmarkClose (void * data ELEKTRA_UNUSED)
 {
 	kdbClose (kdb, key);
 }
 
 
-int main (void)
+int main (int argc, char ** argv)
 {
+	benchmarkHarnessInit (argc, argv);
+
 	key = keyNew (KEY_ROOT, KEY_END);
 
-	timeInit ();
 	benchmarkCreate ();
-	timePrint ("Created empty keyset");
-
 	benchmarkFillup ();
-	timePrint ("New large keyset");
 
-	benchmarkOpen ();
+	benchmarkOpen (NULL);
 	keySetName (key, KEY_ROOT);
-	timePrint ("Opened key database");
-
-	benchmarkInread ();
-	timePrint ("Initialize read");
-
-	benchmarkInwrite ();
-	timePrint ("Initialize write");
-
-	benchmarkWriteout ();
-	timePrint ("Write key database");
-
-	benchmarkRewrite ();
-	timePrint ("Rewrite key database");
-
-	benchmarkReadin ();
-	timePrint ("Read in key database");
 
-	benchmarkLookupByName ();
-	timePrint ("Lookup key database");
+	// make sure the key database exists before measuring
+	benchmarkInread (NULL);
+	benchmarkInwrite (NULL);
 
-	benchmarkReread ();
-	timePrint ("Re read key database");
+	benchmarkMeasure ("kdbSet", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkWriteout, NULL);
+	benchmarkMeasure ("kdbGet", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkReadin, NULL);
+	benchmarkMeasure ("ksLookupByName", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkLookupByName, NULL);
+	benchmarkMeasure ("kdbGet/reuse", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkReread, NULL);
 
-	benchmarkClose ();
-	timePrint ("Closed key database");
+	benchmarkClose (NULL);
+	benchmarkHarnessFinish ();
 
 	ksDel (large);
 	keyDel (key);
@@ -2066,6 +2066,258 @@ static void benchmarkPredictionTime (char * name)
  * START ================================================= Prints all KeySetShapes =================================================== START
  */
 
+/**
+ * START ================================================= Corpus Search Time ======================================================== START
+ *
+ * This benchmark measures the ksLookup () latency distribution on recorded key name corpora, comparing the binary search
+ * with the OPMPHM at multiple KeySet sizes. The synthetic uniform names of the other benchmarks miss the deep hierarchies,
+ * shared prefixes and array indices (#0..#n) of real configurations, which stress the name comparisons differently.
+ * Set the environment variable KDB_BENCHMARK_CORPUS to a file holding one key name per line to benchmark a recorded corpus,
+ * without it a hierarchical corpus with array parts is generated.
+ * Each sample performs a batch of lookups (every tenth one a deliberate miss) and the samples are summarized by the
+ * statistical harness, so the order statistics over the samples are reported instead of a single mean.
+ * Pass --output=json (see benchmarks.c) for machine-readable output to drive the predictor tuning.
+ *
+ * This benchmark takes no seeds.
+ */
+
+#define CORPUS_QUERIES 4096
+#define CORPUS_BATCH 128
+
+typedef struct
+{
+	KeySet * ks;		   /*!< the KeySet to search in */
+	char ** queries;	   /*!< the query names, cycled through */
+	size_t numQueries;	   /*!< number of query names */
+	size_t cursor;		   /*!< next query, advances so every sample sees a different query mix */
+	elektraLookupFlags option; /*!< KDB_O_OPMPHM or KDB_O_BINSEARCH */
+} CorpusSearchData;
+
+static void benchmarkCorpusSearchRun (void * data)
+{
+	CorpusSearchData * d = data;
+	for (size_t i = 0; i < CORPUS_BATCH; ++i)
+	{
+		ksLookupByName (d->ks, d->queries[d->cursor], d->option | KDB_O_NOCASCADING);
+		d->cursor = (d->cursor + 1) % d->numQueries;
+	}
+}
+
+/**
+ * @brief Writes an Elektra array part (#0, #_10, #__100, ...) to a string.
+ *
+ * @param dest buffer, must hold at least 23 bytes
+ * @param index the array index
+ *
+ * @return number of bytes written
+ */
+static size_t benchmarkCorpusArrayPart (char * dest, size_t index)
+{
+	char digits[21];
+	size_t numDigits = snprintf (digits, sizeof (digits), "%zu", index);
+	size_t pos = 0;
+	dest[pos++] = '#';
+	for (size_t i = 1; i < numDigits; ++i)
+	{
+		dest[pos++] = '_';
+	}
+	memcpy (&dest[pos], digits, numDigits + 1);
+	return pos + numDigits;
+}
+
+/**
+ * @brief Generates a corpus of deep hierarchical key names with array parts.
+ *
+ * The names mimic recorded configurations: a shared mountpoint prefix,
+ * nested arrays and a few leaves per array element.
+ *
+ * @param n number of names to generate
+ *
+ * @return array of n malloc'd names
+ */
+static char ** benchmarkCorpusGenerate (size_t n)
+{
+	char ** names = elektraMalloc (n * sizeof (char *));
+	if (!names)
+	{
+		printExit ("malloc");
+	}
+	const char * const leaves[] = { "name", "address", "timeout", "retries" };
+	const size_t numLeaves = sizeof (leaves) / sizeof (leaves[0]);
+	size_t i = 0;
+	for (size_t server = 0; i < n; ++server)
+	{
+		char prefix[KEY_NAME_LENGTH];
+		size_t prefixLen = snprintf (prefix, sizeof (prefix), "user:/sw/org/benchmark/current/servers/");
+		prefixLen += benchmarkCorpusArrayPart (&prefix[prefixLen], server);
+		for (size_t connection = 0; connection < 8 && i < n; ++connection)
+		{
+			char part[KEY_NAME_LENGTH];
+			size_t partLen = snprintf (part, sizeof (part), "%s/connections/", prefix);
+			partLen += benchmarkCorpusArrayPart (&part[partLen], connection);
+			for (size_t leaf = 0; leaf < numLeaves && i < n; ++leaf)
+			{
+				names[i] = elektraFormat ("%s/%s", part, leaves[leaf]);
+				++i;
+			}
+		}
+	}
+	return names;
+}
+
+/**
+ * @brief Loads a corpus of key names from a file, one name per line.
+ *
+ * @param fileName the corpus file
+ * @param n is set to the number of loaded names
+ *
+ * @return array of n malloc'd names
+ */
+static char ** benchmarkCorpusLoad (const char * fileName, size_t * n)
+{
+	FILE * in = fopen (fileName, "r");
+	if (!in)
+	{
+		fprintf (stderr, "could not open corpus file %s\n", fileName);
+		printExit ("open corpus file");
+	}
+	size_t alloc = 1024;
+	size_t count = 0;
+	char ** names = elektraMalloc (alloc * sizeof (char *));
+	if (!names)
+	{
+		printExit ("malloc");
+	}
+	char line[KEY_NAME_LENGTH];
+	while (fgets (line, sizeof (line), in))
+	{
+		line[strcspn (line, "\n")] = '\0';
+		if (line[0] == '\0')
+		{
+			continue;
+		}
+		if (count == alloc)
+		{
+			alloc *= 2;
+			if (elektraRealloc ((void **) &names, alloc * sizeof (char *)) < 0)
+			{
+				printExit ("realloc");
+			}
+		}
+		names[count] = elektraStrDup (line);
+		++count;
+	}
+	fclose (in);
+	if (count == 0)
+	{
+		printExit ("corpus file contains no names");
+	}
+	*n = count;
+	return names;
+}
+
+static void benchmarkCorpusSearchTime (char * name ELEKTRA_UNUSED)
+{
+	const size_t sizes[] = { 1000, 10000, 50000, 200000 };
+	const size_t numSizes = sizeof (sizes) / sizeof (sizes[0]);
+
+	// fixed seed for the OPMPHM builds, the runs should be reproducible
+	elektraRandBenchmarkInitSeed = 0x5ca1ab1e;
+
+	// load or generate the corpus
+	size_t corpusCount = sizes[numSizes - 1];
+	char ** corpus;
+	const char * corpusFile = getenv ("KDB_BENCHMARK_CORPUS");
+	if (corpusFile)
+	{
+		corpus = benchmarkCorpusLoad (corpusFile, &corpusCount);
+	}
+	else
+	{
+		corpus = benchmarkCorpusGenerate (corpusCount);
+	}
+
+	size_t previousN = 0;
+	for (size_t sizeI = 0; sizeI < numSizes; ++sizeI)
+	{
+		size_t n = sizes[sizeI] < corpusCount ? sizes[sizeI] : corpusCount;
+		if (n == previousN)
+		{
+			continue;
+		}
+		previousN = n;
+
+		// the first n corpus names, invalid names are skipped
+		KeySet * ks = ksNew (n, KS_END);
+		for (size_t i = 0; i < n; ++i)
+		{
+			Key * key = keyNew (corpus[i], KEY_END);
+			if (key)
+			{
+				ksAppendKey (ks, key);
+			}
+		}
+		if (ksGetSize (ks) == 0)
+		{
+			printExit ("no valid key names in corpus");
+		}
+
+		// sample the queries, every tenth one is a deliberate miss
+		char ** queries = elektraMalloc (CORPUS_QUERIES * sizeof (char *));
+		char ** misses = elektraCalloc (CORPUS_QUERIES * sizeof (char *));
+		if (!queries || !misses)
+		{
+			printExit ("malloc");
+		}
+		int32_t seed = 0x5ca1ab1e; // fixed, the query mix should be reproducible
+		for (size_t q = 0; q < CORPUS_QUERIES; ++q)
+		{
+			elektraRand (&seed);
+			size_t idx = (uint32_t) seed % n;
+			if (q % 10 == 9)
+			{
+				misses[q] = elektraFormat ("%s/benchmark/miss", corpus[idx]);
+				queries[q] = misses[q];
+			}
+			else
+			{
+				queries[q] = corpus[idx];
+			}
+		}
+
+		CorpusSearchData data = { .ks = ks, .queries = queries, .numQueries = CORPUS_QUERIES, .cursor = 0, .option = 0 };
+		char runName[BUF_SIZ];
+
+		data.option = KDB_O_BINSEARCH;
+		snprintf (runName, sizeof (runName), "corpussearch/binsearch/n=%zu", n);
+		benchmarkMeasure (runName, BENCHMARK_WARMUPS, 256, benchmarkCorpusSearchRun, &data);
+
+		// the first warmup run builds the OPMPHM, so only lookups are sampled
+		data.option = KDB_O_OPMPHM;
+		data.cursor = 0;
+		snprintf (runName, sizeof (runName), "corpussearch/opmphm/n=%zu", n);
+		benchmarkMeasure (runName, BENCHMARK_WARMUPS, 256, benchmarkCorpusSearchRun, &data);
+
+		for (size_t q = 0; q < CORPUS_QUERIES; ++q)
+		{
+			if (misses[q]) elektraFree (misses[q]);
+		}
+		elektraFree (misses);
+		elektraFree (queries);
+		ksDel (ks);
+	}
+
+	for (size_t i = 0; i < corpusCount; ++i)
+	{
+		elektraFree (corpus[i]);
+	}
+	elektraFree (corpus);
+}
+
+/**
+ * END =================================================== Corpus Search Time ========================================================== END
+ */
+
 static void benchmarkPrintAllKeySetShapes (char * name)
 {
 	printf ("%s\n", name);
@@ -2102,7 +2354,7 @@ static void benchmarkPrintAllKeySetShapes (char * name)
 int main (int argc, char ** argv)
 {
 	// define all benchmarks
-	size_t benchmarksCount = 9;
+	size_t benchmarksCount = 10;
 #ifdef HAVE_HSEARCHR
 	// hsearchbuildtime
 	++benchmarksCount;
@@ -2158,6 +2410,11 @@ int main (int argc, char ** argv)
 	benchmarks[8].name = benchmarkNamePredictionTime;
 	benchmarks[8].benchmarkF = benchmarkPredictionTime;
 	benchmarks[8].numberOfSeedsNeeded = 3496500;
+	// corpussearchtime
+	char * benchmarkNameCorpusSearchTime = "corpussearchtime";
+	benchmarks[9].name = benchmarkNameCorpusSearchTime;
+	benchmarks[9].benchmarkF = benchmarkCorpusSearchTime;
+	benchmarks[9].numberOfSeedsNeeded = 0;
 #ifdef HAVE_HSEARCHR
 	// hsearchbuildtime
 	char * benchmarkNameHsearchBuildTime = "hsearchbuildtime";
@@ -2179,11 +2436,13 @@ int main (int argc, char ** argv)
 		elektraFree (benchmarks);
 		return EXIT_FAILURE;
 	}
+	benchmarkHarnessInit (argc, argv);
 	for (size_t i = 0; i < benchmarksCount; ++i)
 	{
 		if (!strncmp (benchmarks[i].name, argv[1], strlen (argv[1])))
 		{
 			benchmarks[i].benchmarkF (benchmarks[i].name);
+			benchmarkHarnessFinish ();
 			elektraFree (benchmarks);
 			return EXIT_SUCCESS;
 		}
@@ -0,0 +1,201 @@
+/**
+ * @file
+ *
+ * @brief Comparative benchmark matrix for storage plugins
+ *
+ * Drives every storage plugin that is compiled into the build through
+ * write/read roundtrips with synthetic keysets of several sizes, value
+ * lengths and metadata densities. Plugins that are not available or
+ * cannot handle a cell of the matrix are skipped with a notice, so the
+ * benchmark can run against any plugin selection.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <benchmarks.h>
+#include <tests.h>
+
+#define NUM_PLUGINS 9
+#define NUM_SCALES 3
+#define NUM_VARIANTS 4
+
+static char * pluginNames[NUM_PLUGINS] = { "dump", "quickdump", "mmapstorage", "toml", "yajl", "yamlcpp", "ni", "kconfig", "simpleini" };
+
+static KeySet * modules[NUM_PLUGINS];
+static Plugin * plugins[NUM_PLUGINS];
+
+typedef struct
+{
+	const char * label;
+	size_t numKeys;
+	size_t iterations;
+} Scale;
+
+/* larger keysets get fewer samples to keep the total runtime bounded */
+static const Scale scales[NUM_SCALES] = {
+	{ "1k", 1000, BENCHMARK_ITERATIONS },
+	{ "100k", 100000, 5 },
+	{ "1m", 1000000, 3 },
+};
+
+typedef struct
+{
+	const char * label;
+	size_t valueSize;
+	int withMeta;
+} Variant;
+
+static const Variant variants[NUM_VARIANTS] = {
+	{ "v16", 16, 0 },
+	{ "v16+meta", 16, 1 },
+	{ "v256", 256, 0 },
+	{ "v256+meta", 256, 1 },
+};
+
+typedef struct
+{
+	Plugin * plugin;
+	KeySet * ks;
+	Key * parentKey;
+	int error;
+} MatrixCell;
+
+static void benchmarkOpenPlugins (void)
+{
+	for (size_t i = 0; i < NUM_PLUGINS; ++i)
+	{
+		modules[i] = ksNew (0, KS_END);
+		elektraModulesInit (modules[i], 0);
+		KeySet * conf = ksNew (0, KS_END);
+		Key * errorKey = keyNew ("/", KEY_END);
+		plugins[i] = elektraPluginOpen (pluginNames[i], modules[i], conf, errorKey);
+
+		if (plugins[i] == 0)
+		{
+			fprintf (stderr, "Plugin %s is not available, skipping\n", pluginNames[i]);
+		}
+
+		keyDel (errorKey);
+	}
+}
+
+static void benchmarkClosePlugins (void)
+{
+	for (size_t i = 0; i < NUM_PLUGINS; ++i)
+	{
+		if (plugins[i] != 0)
+		{
+			elektraPluginClose (plugins[i], 0);
+		}
+		elektraModulesClose (modules[i], 0);
+		ksDel (modules[i]);
+	}
+}
+
+static KeySet * generateMatrixKeySet (size_t numKeys, size_t valueSize, int withMeta)
+{
+	char name[KEY_NAME_LENGTH];
+	char * value = elektraMalloc (valueSize + 1);
+	memset (value, 'x', valueSize);
+	value[valueSize] = '\0';
+
+	KeySet * ks = ksNew ((ssize_t) numKeys, KS_END);
+	for (size_t i = 0; i < numKeys; ++i)
+	{
+		snprintf (name, sizeof (name), KEY_ROOT "/dir%zu/key%zu", i / 100, i % 100);
+		Key * key = keyNew (name, KEY_VALUE, value, KEY_END);
+		if (withMeta)
+		{
+			keySetMeta (key, "comment", "generated benchmark entry");
+		}
+		ksAppendKey (ks, key);
+	}
+
+	elektraFree (value);
+	return ks;
+}
+
+static void benchmarkSet (void * data)
+{
+	MatrixCell * cell = (MatrixCell *) data;
+	if (cell->plugin->kdbSet (cell->plugin, cell->ks, cell->parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+	{
+		cell->error = 1;
+	}
+}
+
+static void benchmarkGet (void * data)
+{
+	MatrixCell * cell = (MatrixCell *) data;
+	KeySet * returned = ksNew (0, KS_END);
+	if (cell->plugin->kdbGet (cell->plugin, returned, cell->parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+	{
+		cell->error = 1;
+	}
+	ksDel (returned);
+}
+
+int main (int argc, char ** argv)
+{
+	size_t maxKeys = scales[NUM_SCALES - 1].numKeys;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strncmp (argv[i], "--max-keys=", 11) == 0)
+		{
+			maxKeys = strtoul (argv[i] + 11, NULL, 10);
+		}
+	}
+
+	benchmarkHarnessInit (argc, argv);
+	benchmarkOpenPlugins ();
+	init (argc, argv);
+
+	char benchmarkName[BUF_SIZ * 2];
+	for (size_t s = 0; s < NUM_SCALES; ++s)
+	{
+		if (scales[s].numKeys > maxKeys) continue;
+
+		for (size_t v = 0; v < NUM_VARIANTS; ++v)
+		{
+			KeySet * ks = generateMatrixKeySet (scales[s].numKeys, variants[v].valueSize, variants[v].withMeta);
+
+			for (size_t p = 0; p < NUM_PLUGINS; ++p)
+			{
+				if (plugins[p] == 0) continue;
+
+				MatrixCell cell = { plugins[p], ks, keyNew (KEY_ROOT, KEY_VALUE, tmpfilename, KEY_END), 0 };
+
+				/* untimed probe roundtrip: detect plugins that cannot
+				 * handle this cell before polluting the measurements */
+				benchmarkSet (&cell);
+				if (!cell.error) benchmarkGet (&cell);
+				if (cell.error)
+				{
+					fprintf (stderr, "Plugin %s failed the %s/%s roundtrip, skipping\n", pluginNames[p],
+						 scales[s].label, variants[v].label);
+					keyDel (cell.parentKey);
+					continue;
+				}
+
+				snprintf (benchmarkName, sizeof (benchmarkName), "%s/%s/%s/set", pluginNames[p], scales[s].label,
+					  variants[v].label);
+				benchmarkMeasure (benchmarkName, 1, scales[s].iterations, benchmarkSet, &cell);
+
+				snprintf (benchmarkName, sizeof (benchmarkName), "%s/%s/%s/get", pluginNames[p], scales[s].label,
+					  variants[v].label);
+				benchmarkMeasure (benchmarkName, 1, scales[s].iterations, benchmarkGet, &cell);
+
+				keyDel (cell.parentKey);
+			}
+
+			ksDel (ks);
+		}
+	}
+
+	benchmarkClosePlugins ();
+	benchmarkHarnessFinish ();
+	return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the validation pass of the email plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbmodule.h>
+
+#define NUM_ADDRESSES 100000
+
+#define WORST_CASE_MIN_LENGTH 1000
+#define WORST_CASE_MAX_LENGTH 64000
+#define WORST_CASE_REPEATS 200
+
+static Plugin * plugin;
+static KeySet * modules;
+static Key * parentKey;
+static KeySet * addresses;
+
+static const char atext[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!#$%&'*+/=?^_`{|}~-";
+
+static char randAtext (int32_t * seed)
+{
+	elektraRand (seed);
+	return atext[*seed % (int32_t) (sizeof (atext) - 1)];
+}
+
+/**
+ * Generates NUM_ADDRESSES distinct, syntactically valid addresses with
+ * pseudo-random atext runs in the local part, so one kdbSet scans the
+ * whole list without failing early.
+ */
+static KeySet * generateAddresses (void)
+{
+	int32_t seed = elektraRandGetInitSeed ();
+	KeySet * ks = ksNew (NUM_ADDRESSES, KS_END);
+	char name[sizeof (KEY_ROOT) + BUF_SIZ];
+	char address[BUF_SIZ];
+	for (int i = 0; i < NUM_ADDRESSES; ++i)
+	{
+		int pos = 0;
+		for (int run = 0; run < 3; ++run)
+		{
+			if (run) address[pos++] = '.';
+			for (int j = 0; j < 5; ++j)
+				address[pos++] = randAtext (&seed);
+		}
+		snprintf (address + pos, sizeof (address) - pos, "%d@example.com", i);
+		snprintf (name, sizeof (name), KEY_ROOT "/%d", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, address, KEY_META, "check/email", "", KEY_END));
+	}
+	return ks;
+}
+
+static void benchmarkValidateList (void * data ELEKTRA_UNUSED)
+{
+	plugin->kdbSet (plugin, addresses, parentKey);
+}
+
+/**
+ * Fills value with an adversarial input of the given length. The shapes are
+ * the classic backtracking killers for the regex the plugin used before:
+ * long dot-separated runs ending in a character that forces a mismatch only
+ * at the very end, plus a fuzzed mix of atext, dots and '@'. A linear-time
+ * validator handles all of them in time proportional to the length.
+ */
+static void fillWorstCase (char * value, int length, int shape, int32_t * seed)
+{
+	switch (shape)
+	{
+	case 0: /* a.a.a...a! */
+		for (int i = 0; i < length - 1; ++i)
+			value[i] = (i % 2) ? '.' : 'a';
+		value[length - 1] = '!';
+		break;
+	case 1: /* aaa...a (no @ at all) */
+		memset (value, 'a', length);
+		break;
+	default: /* fuzz: random atext, dots and separators */
+		for (int i = 0; i < length; ++i)
+		{
+			elektraRand (seed);
+			int32_t r = *seed % 10;
+			if (r == 0)
+				value[i] = '.';
+			else if (r == 1)
+				value[i] = '@';
+			else
+				value[i] = randAtext (seed);
+		}
+		break;
+	}
+	value[length] = '\0';
+}
+
+/**
+ * Validates adversarial inputs of doubling lengths and prints the time per
+ * input byte; a flat last column demonstrates worst-case linearity.
+ */
+static void benchmarkWorstCase (void)
+{
+	char * value = elektraMalloc (WORST_CASE_MAX_LENGTH + 1);
+	int32_t seed = elektraRandGetInitSeed ();
+
+	printf ("%10s %6s %12s %12s\n", "length", "shape", "us total", "ns/byte");
+	for (int length = WORST_CASE_MIN_LENGTH; length <= WORST_CASE_MAX_LENGTH; length *= 2)
+	{
+		for (int shape = 0; shape < 3; ++shape)
+		{
+			fillWorstCase (value, length, shape, &seed);
+
+			timeInit ();
+			for (int repeat = 0; repeat < WORST_CASE_REPEATS; ++repeat)
+			{
+				Key * repeatParent = keyNew ("user:/benchmark", KEY_END);
+				KeySet * ks = ksNew (1, keyNew (KEY_ROOT, KEY_VALUE, value, KEY_META, "check/email", "", KEY_END),
+						     KS_END);
+				plugin->kdbSet (plugin, ks, repeatParent);
+				ksDel (ks);
+				keyDel (repeatParent);
+			}
+			int us = timeGetDiffMicroseconds ();
+			printf ("%10d %6d %12d %12.2f\n", length, shape, us, us * 1000.0 / WORST_CASE_REPEATS / length);
+		}
+	}
+
+	elektraFree (value);
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkHarnessInit (argc, argv);
+
+	KeySet * conf = ksNew (0, KS_END);
+	modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * errorKey = keyNew ("/", KEY_END);
+	plugin = elektraPluginOpen ("email", modules, conf, errorKey);
+	keyDel (errorKey);
+	if (!plugin)
+	{
+		fprintf (stderr, "could not open email plugin\n");
+		return 1;
+	}
+
+	parentKey = keyNew ("user:/benchmark", KEY_END);
+
+	timeInit ();
+	addresses = generateAddresses ();
+	timePrint ("Generated addresses");
+
+	benchmarkMeasure ("validateAddressList", BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkValidateList, NULL);
+
+	benchmarkWorstCase ();
+
+	benchmarkHarnessFinish ();
+
+	ksDel (addresses);
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	return 0;
+}
@@ -16,6 +16,13 @@ set (
 	"ALL;-EXPERIMENTAL"
 	CACHE STRING ${PLUGINS_DOC})
 
+set (PRELOADED_PLUGINS_DOC
+     "Which plugins should additionally be linked directly into libelektra-core, so they are loaded without dlopen? See doc/COMPILE.md")
+set (
+	PRELOADED_PLUGINS
+	""
+	CACHE STRING ${PRELOADED_PLUGINS_DOC})
+
 set (INFO_PLUGINS_DOC "only for informational purposes. Modify PLUGINS to change the list.")
 set (ADDED_PLUGINS_DOC "List of plugins already added, ${INFO_PLUGINS_DOC}")
 set (
@@ -70,7 +77,7 @@ if (TOOLS MATCHES "DEFAULT")
 endif ()
 
 if (TOOLS MATCHES "NODEP")
-	set (TOOLS_LIST race)
+	set (TOOLS_LIST race trace)
 	set (TOOLS_FORCE FORCE)
 	list (REMOVE_ITEM TOOLS NODEP)
 endif ()
@@ -86,6 +93,7 @@ if (TOOLS MATCHES "ALL")
 		pythongen
 		qt-gui
 		race
+		trace
 		webd
 		website
 		webui)
@@ -264,6 +272,8 @@ set (
 	"${PROJECT_SOURCE_DIR}"
 	CACHE FILEPATH "Full path to common prefix of build+source directory")
 
+option (ENABLE_MALLOC_TRACE "Record per call site statistics for all allocations done through elektraMalloc(). Requires glibc.")
+
 option (ENABLE_DEBUG "Build with assertions and use RTLD_NODELETE. Intended for developing and debugging Elektra.")
 if (ENABLE_DEBUG)
 	set (DEBUG "1")
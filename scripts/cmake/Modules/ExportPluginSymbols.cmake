@@ -65,3 +65,44 @@ function (elektra_export_plugin_symbols)
 
 	file (APPEND ${ARG_SOURCE} "\t{ 0 , 0 }\n" "};\n")
 endfunction (elektra_export_plugin_symbols)
+
+# ~~~
+# Generates the registry of plugins linked directly into libelektra-core
+# (see the PRELOADED_PLUGINS build option). The registry is consulted by
+# elektraModulesLoad() before falling back to dlopen().
+# ~~~
+function (elektra_export_preloaded_plugins)
+	cmake_parse_arguments (ARG "" "SOURCE;HEADER" "PLUGINS" ${ARGN})
+
+	if (NOT ARG_SOURCE)
+		message (FATAL_ERROR "SOURCE must be provided")
+	endif ()
+
+	if (NOT ARG_HEADER)
+		message (FATAL_ERROR "HEADER must be provided")
+	endif ()
+
+	file (
+		WRITE ${ARG_HEADER}
+		"/* preloaded_plugins.h generated by elektra_export_preloaded_plugins\n"
+		" *\n"
+		" * Registry of plugins linked directly into libelektra-core.\n"
+		" * Consulted by elektraModulesLoad() before falling back to dlopen().\n"
+		" */\n\n"
+		"typedef struct {\n"
+		"	const char *name;\n"
+		"	void (*function)(void);\n"
+		"} kdblib_preloaded_plugin;\n\n"
+		"extern kdblib_preloaded_plugin kdb_preloaded_plugins[];\n\n")
+
+	file (WRITE ${ARG_SOURCE} "/* preloaded_plugins.c generated by elektra_export_preloaded_plugins */\n\n"
+				  "#include <preloaded_plugins.h>\n\n" "kdblib_preloaded_plugin kdb_preloaded_plugins[] =\n" "{\n")
+
+	foreach (PLUGIN ${ARG_PLUGINS})
+		file (APPEND ${ARG_HEADER} "extern void libelektra_${PLUGIN}_LTX_elektraPluginSymbol (void);\n")
+
+		file (APPEND ${ARG_SOURCE} "\t{\"${PLUGIN}\", &libelektra_${PLUGIN}_LTX_elektraPluginSymbol},\n")
+	endforeach ()
+
+	file (APPEND ${ARG_SOURCE} "\t{ 0 , 0 }\n" "};\n")
+endfunction (elektra_export_preloaded_plugins)
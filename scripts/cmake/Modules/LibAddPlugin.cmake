@@ -687,6 +687,17 @@ function (add_plugin PLUGIN_SHORT_NAME)
 		set_property (GLOBAL APPEND PROPERTY "elektra-full_SRCS" ${PLUGIN_TARGET_OBJS} ${ARG_OBJECT_SOURCES})
 
 		set_property (GLOBAL APPEND PROPERTY "elektra-full_LIBRARIES" "${ARG_LINK_LIBRARIES}")
+
+		# plugins listed in PRELOADED_PLUGINS are linked directly into libelektra-core
+		# for shared builds, so they are loaded without dlopen
+		if (BUILD_SHARED AND PRELOADED_PLUGINS)
+			list (FIND PRELOADED_PLUGINS "${PLUGIN_SHORT_NAME}" PRELOADED_INDEX)
+			if (PRELOADED_INDEX GREATER -1)
+				set_property (GLOBAL APPEND PROPERTY "elektra-preloaded_SRCS" ${PLUGIN_TARGET_OBJS} ${ARG_OBJECT_SOURCES})
+				set_property (GLOBAL APPEND PROPERTY "elektra-preloaded_LIBRARIES" "${ARG_LINK_LIBRARIES}")
+				set_property (GLOBAL APPEND PROPERTY "elektra-preloaded_PLUGINS" "${PLUGIN_SHORT_NAME}")
+			endif ()
+		endif ()
 	endif (NOT ARG_ONLY_SHARED)
 
 	# cleanup
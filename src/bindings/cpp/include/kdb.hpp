@@ -61,6 +61,18 @@ public:
 	virtual inline int set (KeySet & returned, std::string const & keyname);
 	virtual inline int set (KeySet & returned, Key & parentKey);
 
+	/**
+	 * @brief Passes out the raw kdb pointer
+	 *
+	 * @return pointer to internal ckdb KDB
+	 *
+	 * @note the ownership remains in the object
+	 */
+	ckdb::KDB * getKdb () const
+	{
+		return handle;
+	}
+
 private:
 	ckdb::KDB * handle; ///< holds an kdb handle
 };
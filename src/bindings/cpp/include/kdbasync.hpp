@@ -0,0 +1,220 @@
+/**
+ * @file
+ *
+ * @brief
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef ELEKTRA_KDBASYNC_HPP
+#define ELEKTRA_KDBASYNC_HPP
+
+#include <kdb.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace kdb
+{
+
+/**
+ * @brief Access to the key database without blocking the calling thread.
+ *
+ * Works like KDB, but getAsync()/setAsync() enqueue the operation and
+ * return immediately. Every AsyncKDB owns one worker thread and all
+ * operations of the handle run on it, so the single-threaded contract of
+ * a KDB handle is kept (handle affinity) while slow backends overlap
+ * with application work.
+ *
+ * The caller keeps ownership of the passed KeySet and parent Key and
+ * must keep them alive and untouched until the returned future is ready
+ * or the completion handler was invoked.
+ *
+ * The synchronous get()/set() of the base class remain available, but
+ * must not be called while an asynchronous operation is pending.
+ */
+class AsyncKDB : public KDB
+{
+public:
+	AsyncKDB () : KDB (), m_stop (false), m_worker (&AsyncKDB::workerMain, this)
+	{
+	}
+
+	explicit AsyncKDB (KeySet & contract) : KDB (contract), m_stop (false), m_worker (&AsyncKDB::workerMain, this)
+	{
+	}
+
+	/**
+	 * Waits for all pending operations, then closes the database.
+	 */
+	~AsyncKDB () throw ()
+	{
+		{
+			std::unique_lock<std::mutex> lock (m_mutex);
+			m_stop = true;
+		}
+		m_condition.notify_all ();
+		m_worker.join ();
+	}
+
+	inline std::future<int> getAsync (KeySet & returned, Key & parentKey);
+	inline std::future<int> setAsync (KeySet & returned, Key & parentKey);
+
+	inline void getAsync (KeySet & returned, Key & parentKey, std::function<void (std::exception_ptr, int)> handler);
+	inline void setAsync (KeySet & returned, Key & parentKey, std::function<void (std::exception_ptr, int)> handler);
+
+private:
+	inline void enqueue (std::function<void ()> task);
+	inline void workerMain ();
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	std::deque<std::function<void ()>> m_tasks;
+	bool m_stop;
+	std::thread m_worker;
+};
+
+/**
+ * Get all keys below parentKey inside returned, without blocking the
+ * calling thread.
+ *
+ * @param returned the keyset where the keys will be in
+ * @param parentKey the parentKey of returned
+ *
+ * @return a future holding the result of KDB::get; waiting on it
+ * rethrows the KDBException of a failed operation
+ */
+inline std::future<int> AsyncKDB::getAsync (KeySet & returned, Key & parentKey)
+{
+	auto promise = std::make_shared<std::promise<int>> ();
+	std::future<int> future = promise->get_future ();
+	enqueue ([this, promise, &returned, &parentKey] () {
+		try
+		{
+			promise->set_value (this->get (returned, parentKey));
+		}
+		catch (...)
+		{
+			promise->set_exception (std::current_exception ());
+		}
+	});
+	return future;
+}
+
+/**
+ * Set all keys below parentKey, without blocking the calling thread.
+ *
+ * @param returned the keyset where the keys are passed to the user
+ * @param parentKey the parentKey of returned
+ *
+ * @return a future holding the result of KDB::set; waiting on it
+ * rethrows the KDBException of a failed operation
+ */
+inline std::future<int> AsyncKDB::setAsync (KeySet & returned, Key & parentKey)
+{
+	auto promise = std::make_shared<std::promise<int>> ();
+	std::future<int> future = promise->get_future ();
+	enqueue ([this, promise, &returned, &parentKey] () {
+		try
+		{
+			promise->set_value (this->set (returned, parentKey));
+		}
+		catch (...)
+		{
+			promise->set_exception (std::current_exception ());
+		}
+	});
+	return future;
+}
+
+/**
+ * Get all keys below parentKey inside returned and invoke a completion
+ * handler afterwards.
+ *
+ * The handler is invoked on the worker thread with the exception of a
+ * failed operation (or nullptr) and the result of KDB::get. Reactor
+ * based applications can post the continuation back to their own
+ * executor from the handler (e.g. boost::asio::post or QMetaObject::invokeMethod).
+ *
+ * @param returned the keyset where the keys will be in
+ * @param parentKey the parentKey of returned
+ * @param handler the completion handler
+ */
+inline void AsyncKDB::getAsync (KeySet & returned, Key & parentKey, std::function<void (std::exception_ptr, int)> handler)
+{
+	enqueue ([this, &returned, &parentKey, handler] () {
+		try
+		{
+			int ret = this->get (returned, parentKey);
+			handler (nullptr, ret);
+		}
+		catch (...)
+		{
+			handler (std::current_exception (), -1);
+		}
+	});
+}
+
+/**
+ * Set all keys below parentKey and invoke a completion handler
+ * afterwards.
+ *
+ * @see getAsync (KeySet &, Key &, std::function<void (std::exception_ptr, int)>)
+ *
+ * @param returned the keyset where the keys are passed to the user
+ * @param parentKey the parentKey of returned
+ * @param handler the completion handler
+ */
+inline void AsyncKDB::setAsync (KeySet & returned, Key & parentKey, std::function<void (std::exception_ptr, int)> handler)
+{
+	enqueue ([this, &returned, &parentKey, handler] () {
+		try
+		{
+			int ret = this->set (returned, parentKey);
+			handler (nullptr, ret);
+		}
+		catch (...)
+		{
+			handler (std::current_exception (), -1);
+		}
+	});
+}
+
+inline void AsyncKDB::enqueue (std::function<void ()> task)
+{
+	{
+		std::unique_lock<std::mutex> lock (m_mutex);
+		m_tasks.push_back (std::move (task));
+	}
+	m_condition.notify_all ();
+}
+
+inline void AsyncKDB::workerMain ()
+{
+	for (;;)
+	{
+		std::function<void ()> task;
+		{
+			std::unique_lock<std::mutex> lock (m_mutex);
+			m_condition.wait (lock, [this] () { return m_stop || !m_tasks.empty (); });
+			if (m_tasks.empty ())
+			{
+				// m_stop is set and all pending operations are done
+				return;
+			}
+			task = std::move (m_tasks.front ());
+			m_tasks.pop_front ();
+		}
+		task ();
+	}
+}
+
+} // end of namespace kdb
+
+#endif
@@ -222,32 +222,73 @@ public:
 	std::string evaluate (std::string const & key_name) const
 	{
 		return evaluate (key_name, [&] (std::string const & current_id, std::string & ret, bool in_group) {
-			auto f = m_active_layers.find (current_id);
-			bool left_group = true;
-			if (f != m_active_layers.end ())
+			return appendLayer (current_id, ret, in_group);
+		});
+	}
+
+	/**
+	 * @brief Evaluate a preparsed specification (name) and return
+	 * a key name under current context
+	 *
+	 * @param name the preparsed name with placeholders to be evaluated
+	 */
+	std::string evaluate (ParsedName const & name) const
+	{
+		std::string ret;
+		// heuristic how much too allocate
+		ret.reserve (name.fullName ().size () * 2);
+		evaluate (name, ret);
+		return ret;
+	}
+
+	/**
+	 * @brief Evaluate a preparsed specification into a caller-owned
+	 * buffer
+	 *
+	 * Only the current layer values are spliced between the static
+	 * fragments, the name is not scanned again. The evaluated name
+	 * is appended to @p ret, so a buffer kept across evaluations is
+	 * reused including its capacity and no allocation happens once
+	 * it grew large enough.
+	 *
+	 * @param name the preparsed name with placeholders to be evaluated
+	 * @param ret the buffer to append the evaluated name to
+	 */
+	void evaluate (ParsedName const & name, std::string & ret) const
+	{
+		for (auto const & fragment : name.fragments ())
+		{
+			if (fragment.ids.empty ())
 			{
-				assert (f->second && "no null pointers in active_layers");
-				std::string r = (*f->second) ();
-				if (!r.empty ())
+				ret += fragment.text;
+			}
+			else if (fragment.ids.size () == 1)
+			{
+				appendLayer (fragment.ids[0], ret, false);
+			}
+			else
+			{
+				bool is_in_group = false;
+				for (size_t i = 0; i < fragment.ids.size (); ++i)
 				{
-					if (in_group)
+					bool const left_group = appendLayer (fragment.ids[i], ret, true);
+					if (i + 1 == fragment.ids.size ())
 					{
-						ret += "%";
+						break;
 					}
-					ret += r;
-					left_group = false;
-				}
-				else if (!in_group)
-				{
-					ret += "%";
+					if (left_group)
+					{
+						// layers that do not matter in the group anymore
+						if (!is_in_group)
+						{
+							ret += "%"; // empty groups
+						}
+						break;
+					}
+					is_in_group = true;
 				}
 			}
-			else if (!in_group)
-			{
-				ret += "%";
-			}
-			return left_group;
-		});
+		}
 	}
 
 	/**
@@ -410,6 +451,29 @@ public:
 		return layer;
 	}
 
+	/**
+	 * @brief Globally activate many layers at once
+	 *
+	 * All layers are activated before any observer is notified,
+	 * and every affected observer is notified exactly once.
+	 *
+	 * @param layers the layers to activate
+	 */
+	void activateLayers (std::vector<std::shared_ptr<Layer>> const & layers)
+	{
+		Events events;
+		for (auto const & layer : layers)
+		{
+			auto p = m_active_layers.emplace (std::make_pair (layer->id (), layer));
+			if (!p.second)
+			{
+				p.first->second = layer; // update
+			}
+			events.push_back (layer->id ());
+		}
+		notifyByEvents (events);
+	}
+
 protected:
 	template <typename T, typename... Args>
 	void lazyDeactivate (Args &&... args)
@@ -468,6 +532,25 @@ public:
 		return layer;
 	}
 
+	/**
+	 * @brief Globally deactivate many layers at once
+	 *
+	 * Counterpart of activateLayers(), every affected observer
+	 * is notified exactly once.
+	 *
+	 * @param layers the layers to deactivate
+	 */
+	void deactivateLayers (std::vector<std::shared_ptr<Layer>> const & layers)
+	{
+		Events events;
+		for (auto const & layer : layers)
+		{
+			m_active_layers.erase (layer->id ());
+			events.push_back (layer->id ());
+		}
+		notifyByEvents (events);
+	}
+
 public:
 	Context & withl (std::shared_ptr<Layer> & l)
 	{
@@ -510,6 +593,41 @@ public:
 private:
 	typedef std::vector<std::pair<std::string, std::shared_ptr<Layer>>> WithStack;
 
+	/**
+	 * @brief Splice the value of one layer into an evaluated name.
+	 *
+	 * @retval true if the layer did not contribute a value and the
+	 *         rest of its group is to be ignored
+	 */
+	bool appendLayer (std::string const & current_id, std::string & ret, bool in_group) const
+	{
+		auto f = m_active_layers.find (current_id);
+		bool left_group = true;
+		if (f != m_active_layers.end ())
+		{
+			assert (f->second && "no null pointers in active_layers");
+			std::string r = (*f->second) ();
+			if (!r.empty ())
+			{
+				if (in_group)
+				{
+					ret += "%";
+				}
+				ret += r;
+				left_group = false;
+			}
+			else if (!in_group)
+			{
+				ret += "%";
+			}
+		}
+		else if (!in_group)
+		{
+			ret += "%";
+		}
+		return left_group;
+	}
+
 	void execHelper (std::function<void ()> const & f)
 	{
 		WithStack with_stack = m_with_stack;
@@ -14,7 +14,9 @@
 #include <kdb.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <mutex>
 #include <thread>
@@ -80,6 +82,16 @@ public:
 		return key_name;
 	}
 
+	std::string evaluate (ParsedName const & name) const
+	{
+		return name.fullName ();
+	}
+
+	void evaluate (ParsedName const & name, std::string & ret) const
+	{
+		ret += name.fullName ();
+	}
+
 	/**
 	 * @brief (Re)attaches a ValueSubject to a thread or simply
 	 *        execute code in a locked section.
@@ -172,6 +184,18 @@ public:
 private:
 	friend class ThreadContext;
 
+	/**
+	 * @brief Counter of global context changes.
+	 *
+	 * Incremented on every global assignment and layer
+	 * (de)activation, so ThreadContexts can skip taking the
+	 * global mutex when nothing changed since their last sync.
+	 */
+	uint64_t epoch () const
+	{
+		return m_epoch.load (std::memory_order_acquire);
+	}
+
 	void attach (ThreadSubject * c)
 	{
 		std::lock_guard<std::mutex> lock (m_mutex);
@@ -214,6 +238,7 @@ private:
 			{
 				i.second.toUpdate.append (Key (c.newKey, KEY_END));
 			}
+			m_epoch.fetch_add (1, std::memory_order_release);
 		}
 	}
 
@@ -244,6 +269,7 @@ private:
 			if (cc == c.first) continue;
 			c.second.toActivate.insert (std::make_pair (layer->id (), LayerAction (true, layer)));
 		}
+		m_epoch.fetch_add (1, std::memory_order_release);
 	}
 
 	void runOnDeactivate (std::shared_ptr<Layer> layer)
@@ -267,6 +293,45 @@ private:
 			if (cc == c.first) continue;
 			c.second.toActivate.insert (std::make_pair (layer->id (), LayerAction (false, layer)));
 		}
+		m_epoch.fetch_add (1, std::memory_order_release);
+	}
+
+	/**
+	 * @brief Request that many layers need to be globally
+	 * (de)activated at once.
+	 *
+	 * Takes every mutex only once, no matter how many layers
+	 * are given.
+	 *
+	 * @param cc requests it and already has them applied itself
+	 * @param layers the layers to apply for all threads
+	 * @param activate whether the layers are activated or deactivated
+	 */
+	void globalBatch (ThreadSubject * cc, std::vector<std::shared_ptr<Layer>> const & layers, bool activate)
+	{
+		{
+			std::lock_guard<std::mutex> lock (activate ? m_mutexOnActivate : m_mutexOnDeactivate);
+			FunctionMap & fm = activate ? m_onActivate : m_onDeactivate;
+			for (auto const & layer : layers)
+			{
+				for (auto && f : fm[layer->id ()])
+				{
+					f ();
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> lock (m_mutex);
+		for (auto & c : m_updates)
+		{
+			// caller itself has them already applied
+			if (cc == c.first) continue;
+			for (auto const & layer : layers)
+			{
+				c.second.toActivate.insert (std::make_pair (layer->id (), LayerAction (activate, layer)));
+			}
+		}
+		m_epoch.fetch_add (1, std::memory_order_release);
 	}
 
 	/**
@@ -292,6 +357,8 @@ private:
 	std::mutex m_mutexOnActivate;
 	FunctionMap m_onDeactivate;
 	std::mutex m_mutexOnDeactivate;
+	/// bumped on every global change, see epoch()
+	std::atomic<uint64_t> m_epoch{ 0 };
 };
 
 class ThreadContext : public ThreadSubject, public Context
@@ -376,8 +443,43 @@ public:
 		return layer;
 	}
 
+	/**
+	 * @brief Activate many layers in one transaction.
+	 *
+	 * Unlike calling activate() per layer, the coordinator
+	 * mutex is taken only once and every observer is notified
+	 * once, no matter how many layers are given.
+	 *
+	 * @param layers the layers to activate
+	 */
+	void activateLayers (std::vector<std::shared_ptr<Layer>> const & layers)
+	{
+		syncLayers ();
+		Context::activateLayers (layers);
+		m_gc.globalBatch (this, layers, true);
+	}
+
+	/**
+	 * @brief Deactivate many layers in one transaction.
+	 *
+	 * Counterpart of activateLayers().
+	 *
+	 * @param layers the layers to deactivate
+	 */
+	void deactivateLayers (std::vector<std::shared_ptr<Layer>> const & layers)
+	{
+		syncLayers ();
+		Context::deactivateLayers (layers);
+		m_gc.globalBatch (this, layers, false);
+	}
+
 	void syncLayers () override
 	{
+		// skip the global mutex entirely while nothing changed globally,
+		// which makes syncs on the read-mostly path lock-free
+		uint64_t const epoch = m_gc.epoch ();
+		if (epoch == m_lastEpoch) return;
+
 		// now activate/deactive layers
 		Events e;
 		for (auto const & l : m_gc.fetchGlobalActivation (this))
@@ -396,6 +498,9 @@ public:
 
 		// pull in assignments from other threads
 		m_gc.updateNewlyAssignedValues (this);
+
+		// changes after the epoch was read are picked up by the next sync
+		m_lastEpoch = epoch;
 	}
 
 	virtual void sync ()
@@ -448,6 +553,8 @@ private:
 	 * @brief A map of values this ThreadContext is responsible for.
 	 */
 	std::unordered_map<std::string, ValueRef> m_keys;
+	/// last coordinator epoch this context synced with
+	uint64_t m_lastEpoch = 0;
 };
 
 template <typename T, typename PolicySetter1 = DefaultPolicyArgs, typename PolicySetter2 = DefaultPolicyArgs,
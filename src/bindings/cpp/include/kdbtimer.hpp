@@ -18,10 +18,38 @@
 #include <sys/time.h>
 #include <vector>
 
+#include <kdbhelper.h>
+
 #ifdef __GNUC__
 #define TIMER_NOINLINE __attribute__ ((noinline))
 #endif
 
+/**
+ * @brief Scoped facade for the elektraTimer API from kdbhelper.h
+ *
+ * Opens the named section on construction and closes it on destruction,
+ * so the section cannot stay unbalanced on early returns. Like the C API
+ * it records nothing unless the environment variable `KDB_TIMER` is set,
+ * and the name must outlive the process (a string literal).
+ */
+class TimerScope
+{
+public:
+	explicit TimerScope (const char * name_) : name (name_)
+	{
+		ckdb::elektraTimerBegin (name);
+	}
+	~TimerScope ()
+	{
+		ckdb::elektraTimerEnd (name);
+	}
+	TimerScope (TimerScope const &) = delete;
+	TimerScope & operator= (TimerScope const &) = delete;
+
+private:
+	const char * name;
+};
+
 class Timer
 {
 public:
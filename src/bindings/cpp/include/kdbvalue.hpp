@@ -209,6 +209,116 @@ public:
 	std::string newKey; // new name after assignment
 };
 
+/**
+ * @brief A specification name parsed into its fragments once.
+ *
+ * The specification name of a contextual value is fixed, only the
+ * layer values spliced into it change. Parsing the placeholder
+ * structure ahead of time lets a context evaluate the name without
+ * rescanning it character by character on every context switch.
+ *
+ * @see Context::evaluate(ParsedName const &, std::string &) const
+ */
+class ParsedName
+{
+public:
+	/**
+	 * @brief One piece of a specification name.
+	 *
+	 * Either a literal fragment (ids empty) or a placeholder
+	 * with one (plain layer) or more (layer group) layer ids.
+	 */
+	struct Fragment
+	{
+		std::string text;	      ///< literal text, empty for placeholders
+		std::vector<std::string> ids; ///< layer ids, empty for literal fragments
+	};
+
+	ParsedName ()
+	{
+	}
+
+	explicit ParsedName (std::string const & key_name) : m_fullName (key_name)
+	{
+		std::string literal;
+		std::string current_id;
+		bool capture_id = false;
+		Fragment placeholder;
+
+		for (std::string::size_type i = 0; i < key_name.size (); ++i)
+		{
+			char const c = key_name[i];
+			if (c == '%')
+			{
+				if (capture_id)
+				{
+					// finish capturing
+					placeholder.ids.push_back (current_id);
+					current_id.clear ();
+					m_fragments.push_back (placeholder);
+					placeholder.ids.clear ();
+					capture_id = false;
+				}
+				else
+				{
+					// start capturing
+					if (!literal.empty ())
+					{
+						Fragment f;
+						f.text = literal;
+						m_fragments.push_back (f);
+						literal.clear ();
+					}
+					capture_id = true;
+				}
+			}
+			else if (capture_id && c == ' ')
+			{
+				// found group separator
+				placeholder.ids.push_back (current_id);
+				current_id.clear ();
+			}
+			else if (capture_id)
+			{
+				current_id += c;
+			}
+			else
+			{
+				literal += c;
+			}
+		}
+
+		assert (!capture_id && "number of % incorrect");
+
+		if (!literal.empty ())
+		{
+			Fragment f;
+			f.text = literal;
+			m_fragments.push_back (f);
+		}
+	}
+
+	/**
+	 * @return the unevaluated name the fragments were parsed from
+	 */
+	std::string const & fullName () const
+	{
+		return m_fullName;
+	}
+
+	/**
+	 * @return the fragments in the order they appear in the name
+	 */
+	std::vector<Fragment> const & fragments () const
+	{
+		return m_fragments;
+	}
+
+private:
+	std::string m_fullName;
+	std::vector<Fragment> m_fragments;
+};
+
 // Default Policies for Value
 
 class NoContext
@@ -239,6 +349,16 @@ public:
 		return key_name;
 	}
 
+	std::string evaluate (ParsedName const & name) const
+	{
+		return name.fullName ();
+	}
+
+	void evaluate (ParsedName const & name, std::string & ret) const
+	{
+		ret += name.fullName ();
+	}
+
 	/**
 	 * @brief (Re)attaches a ValueSubject to a thread or simply
 	 *        execute code in a locked section.
@@ -443,12 +563,12 @@ public:
 	// not to be constructed yourself
 	Value<T, PolicySetter1, PolicySetter2, PolicySetter3, PolicySetter4, PolicySetter5, PolicySetter6> (
 		KeySet & ks, typename Policies::ContextPolicy & context_, kdb::Key spec)
-	: m_cache (), m_hasChanged (false), m_ks (ks), m_context (context_), m_spec (spec)
+	: m_cache (), m_hasChanged (false), m_ks (ks), m_context (context_), m_spec (spec), m_parsedSpec (spec.getName ())
 	{
 		assert (m_spec.getName ()[0] == '/' && "spec keys are not yet supported");
 		m_context.attachByName (m_spec.getName (), *this);
 		Command::Func fun = [this] () -> Command::Pair {
-			auto evaluatedName = m_context.evaluate (m_spec.getName ());
+			auto evaluatedName = m_context.evaluate (m_parsedSpec);
 			evaluatedName = evaluatedName == "/%" ? "/" : evaluatedName;
 			this->unsafeUpdateKeyUsingContext (evaluatedName);
 			this->unsafeSyncCache (); // set m_cache
@@ -717,7 +837,11 @@ private:
 
 	virtual void updateContext (bool write) const override
 	{
-		std::string evaluatedName = m_context.evaluate (m_spec.getName ());
+		// the buffer keeps its capacity, so no allocation happens
+		// here once it grew large enough
+		m_nameBuffer.clear ();
+		m_context.evaluate (m_parsedSpec, m_nameBuffer);
+		std::string & evaluatedName = m_nameBuffer;
 #if DEBUG && VERBOSE
 		std::cout << "update context " << evaluatedName << " from " << m_spec.getName () << " with write " << write << std::endl;
 #endif
@@ -801,12 +925,24 @@ private:
 	 */
 	Key m_spec;
 
+	/**
+	 * @brief The specification name preparsed into its fragments.
+	 *
+	 * @see ParsedName
+	 */
+	ParsedName m_parsedSpec;
+
 	/**
 	 * @brief The current key the Value is bound to.
 	 *
 	 * @invariant: Is never a null key
 	 */
 	mutable Key m_key;
+
+	/**
+	 * @brief Reused buffer for evaluated names.
+	 */
+	mutable std::string m_nameBuffer;
 };
 
 template <typename T, typename PolicySetter1, typename PolicySetter2, typename PolicySetter3, typename PolicySetter4,
@@ -16,6 +16,12 @@
 #include <sstream>
 #include <string>
 
+#if __cplusplus >= 201703L
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+#endif
+
 #include <keyexcept.hpp>
 
 #include <kdb.h>
@@ -91,6 +97,7 @@ public:
 	inline Key (ckdb::Key * k);
 	inline Key (Key & k);
 	inline Key (Key const & k);
+	inline Key (Key && k) noexcept;
 
 	inline explicit Key (const char * keyName, ...);
 	inline explicit Key (const std::string keyName, ...);
@@ -113,6 +120,7 @@ public:
 
 	inline Key & operator= (ckdb::Key * k);
 	inline Key & operator= (const Key & k);
+	inline Key & operator= (Key && k) noexcept;
 
 	inline void copy (const Key & other, elektraCopyFlags flags = KEY_CP_ALL);
 	inline void clear ();
@@ -137,9 +145,18 @@ public:
 	inline std::string getBaseName () const;
 	inline ssize_t getBaseNameSize () const;
 
+#if __cplusplus >= 201703L
+	inline std::string_view getNameView () const;
+	inline std::string_view getBaseNameView () const;
+#endif
+
+	inline void setName (const char * newName);
 	inline void setName (const std::string & newName);
+	inline void addName (const char * addedName);
 	inline void addName (const std::string & addedName);
+	inline void setBaseName (const char * baseName);
 	inline void setBaseName (const std::string & baseName);
+	inline void addBaseName (const char * baseName);
 	inline void addBaseName (const std::string & baseName);
 	inline void delBaseName ();
 
@@ -190,6 +207,9 @@ public:
 	inline void set (T x);
 
 	inline std::string getString () const;
+#if __cplusplus >= 201703L
+	inline std::string_view getStringView () const;
+#endif
 	inline void setString (const char * newString);
 	inline void setString (const std::string & newString);
 	inline ssize_t getStringSize () const;
@@ -596,6 +616,21 @@ inline Key::Key (Key const & k) : key (k.key)
 	operator++ ();
 }
 
+/**
+ * Takes over the reference of another key.
+ *
+ * The reference counter stays untouched,
+ * the other key is a null key afterwards.
+ *
+ * @param k the key to take the reference from
+ *
+ * @see isNull()
+ */
+inline Key::Key (Key && k) noexcept : key (k.key)
+{
+	k.key = nullptr;
+}
+
 /**
  * @copydoc keyNew
  *
@@ -729,6 +764,23 @@ inline Key & Key::operator= (const Key & k)
 	return *this;
 }
 
+/**
+ * Take over the reference of another key.
+ *
+ * Will call del() on the old key,
+ * the other key is a null key afterwards.
+ */
+inline Key & Key::operator= (Key && k) noexcept
+{
+	if (this != &k)
+	{
+		del ();
+		key = k.key;
+		k.key = nullptr;
+	}
+	return *this;
+}
+
 /**
  * @copydoc keyCopy
  */
@@ -872,55 +924,107 @@ inline std::string Key::getBaseName () const
 	return std::string (ckdb::keyBaseName (key));
 }
 
+#if __cplusplus >= 201703L
+/**
+ * @copydoc keyName
+ *
+ * @throw KeyException if key is null
+ *
+ * @note Unlike getName() no copy of the name is made.
+ * The view is only valid until the name of the key is changed
+ * or the key is destroyed.
+ */
+inline std::string_view Key::getNameView () const
+{
+	if (!key) throw KeyException ();
+	return std::string_view (ckdb::keyName (key), static_cast<size_t> (ckdb::keyGetNameSize (key)) - 1);
+}
+
+/**
+ * @copydoc keyBaseName
+ *
+ * @throw KeyException if key is null
+ *
+ * @note Unlike getBaseName() no copy of the base name is made.
+ * The view is only valid until the name of the key is changed
+ * or the key is destroyed.
+ */
+inline std::string_view Key::getBaseNameView () const
+{
+	if (!key) throw KeyException ();
+	return std::string_view (ckdb::keyBaseName (key), static_cast<size_t> (ckdb::keyGetBaseNameSize (key)) - 1);
+}
+#endif
+
 /**
  * @copydoc keySetName
  *
  * @throw KeyInvalidName if the name is not valid
  * */
-inline void Key::setName (const std::string & newName)
+inline void Key::setName (const char * newName)
 {
-	if (ckdb::keySetName (getKey (), newName.c_str ()) == -1)
+	if (ckdb::keySetName (getKey (), newName) == -1)
 	{
 		throw KeyInvalidName (newName, "");
 	}
 }
 
-inline void Key::addName (const std::string & addedName)
+inline void Key::setName (const std::string & newName)
+{
+	setName (newName.c_str ());
+}
+
+inline void Key::addName (const char * addedName)
 {
-	if (ckdb::keyAddName (getKey (), addedName.c_str ()) == -1)
+	if (ckdb::keyAddName (getKey (), addedName) == -1)
 	{
 		throw KeyInvalidName (addedName, "(added to end)");
 	}
 }
 
+inline void Key::addName (const std::string & addedName)
+{
+	addName (addedName.c_str ());
+}
+
 /**Sets a base name for a key.
  *
  * @copydoc keySetBaseName
  *
  * @throw KeyInvalidName if the name is not valid
  */
-inline void Key::setBaseName (const std::string & baseName)
+inline void Key::setBaseName (const char * baseName)
 {
-	if (ckdb::keySetBaseName (getKey (), baseName.c_str ()) == -1)
+	if (ckdb::keySetBaseName (getKey (), baseName) == -1)
 	{
 		throw KeyInvalidName (baseName, "(as base name)");
 	}
 }
 
+inline void Key::setBaseName (const std::string & baseName)
+{
+	setBaseName (baseName.c_str ());
+}
+
 /** Adds a base name for a key
  *
  * @copydoc keyAddBaseName
  *
  * @throw KeyInvalidName if the name is not valid
  */
-inline void Key::addBaseName (const std::string & baseName)
+inline void Key::addBaseName (const char * baseName)
 {
-	if (ckdb::keyAddBaseName (getKey (), baseName.c_str ()) == -1)
+	if (ckdb::keyAddBaseName (getKey (), baseName) == -1)
 	{
 		throw KeyInvalidName (baseName, "(as base name)");
 	}
 }
 
+inline void Key::addBaseName (const std::string & baseName)
+{
+	addBaseName (baseName.c_str ());
+}
+
 /** Delete the baseName of a key.
  *
  * @throw KeyInvalidName if the name is not valid
@@ -1054,20 +1158,61 @@ inline QColor Key::get() const
  * @copydoc getString
  *
  * This method tries to serialise the string to the given type.
+ *
+ * For integral and floating-point types (except `bool` and character
+ * types, which keep their stream semantics) the conversion reads the
+ * C value buffer directly via std::from_chars, without constructing
+ * a stream or copying the value. It accepts the same grammar as the
+ * stream conversion: leading whitespace and an explicit plus sign are
+ * allowed, trailing characters are not. The one deliberate difference
+ * is that negative values for unsigned types throw KeyTypeConversion
+ * instead of silently wrapping around like a stream does.
  */
 template <class T>
 inline T Key::get () const
 {
-	std::string str = getString ();
-	std::istringstream ist (str);
-	ist.imbue (std::locale ("C"));
-	T x;
-	ist >> x; // convert string to type
-	if (ist.fail () || !ist.eof ())
+#if __cplusplus >= 201703L
+	constexpr bool viaFastPath =
+#ifdef __cpp_lib_to_chars
+		std::is_floating_point_v<T> ||
+#endif
+		(std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, signed char> &&
+		 !std::is_same_v<T, unsigned char>);
+	if constexpr (viaFastPath)
 	{
-		throw KeyTypeConversion ();
+		// parse directly from the C value buffer, the stream machinery
+		// below costs several times as much per conversion
+		std::string_view str = getStringView ();
+		// std::from_chars alone is stricter than the stream grammar
+		// below: also skip leading whitespace and an explicit plus sign
+		size_t skip = str.find_first_not_of (" \t\n\v\f\r");
+		str.remove_prefix (skip == std::string_view::npos ? str.size () : skip);
+		if (str.size () >= 2 && str[0] == '+' && (str[1] == '.' || (str[1] >= '0' && str[1] <= '9')))
+		{
+			str.remove_prefix (1);
+		}
+		T x;
+		std::from_chars_result res = std::from_chars (str.data (), str.data () + str.size (), x);
+		if (res.ec != std::errc () || res.ptr != str.data () + str.size ())
+		{
+			throw KeyTypeConversion ();
+		}
+		return x;
+	}
+	else
+#endif
+	{
+		std::string str = getString ();
+		std::istringstream ist (str);
+		ist.imbue (std::locale ("C"));
+		T x;
+		ist >> x; // convert string to type
+		if (ist.fail () || !ist.eof ())
+		{
+			throw KeyTypeConversion ();
+		}
+		return x;
 	}
-	return x;
 }
 
 
@@ -1133,6 +1278,33 @@ inline std::string Key::getString () const
 	return str;
 }
 
+#if __cplusplus >= 201703L
+/**
+ * @return a view of the string directly from the key.
+ *
+ * @throw KeyException on null key
+ * @throw KeyTypeMismatch if key holds binary data and not a string
+ *
+ * @note Unlike getString() no copy of the value is made.
+ * The view is only valid until the value of the key is changed
+ * or the key is destroyed.
+ *
+ * @see isString(), getString()
+ */
+inline std::string_view Key::getStringView () const
+{
+	if (!key) throw KeyException ();
+	if (!isString ()) throw KeyTypeMismatch ();
+
+	ssize_t csize = ckdb::keyGetValueSize (key);
+	if (csize <= 1)
+	{
+		return std::string_view ();
+	}
+	return std::string_view (static_cast<const char *> (ckdb::keyValue (key)), static_cast<size_t> (csize) - 1);
+}
+#endif
+
 /**
  * @copydoc keyGetValueSize()
  */
@@ -1660,7 +1832,11 @@ struct hash<kdb::Key>
 	size_t operator() (kdb::Key const & k) const
 	{
 		// use key name as hash value
+#if __cplusplus >= 201703L
+		return std::hash<std::string_view> () (k.getNameView ());
+#else
 		return std::hash<std::string> () (k.getName ());
+#endif
 	}
 };
 } // end of namespace std
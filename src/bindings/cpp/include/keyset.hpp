@@ -14,6 +14,7 @@
 #endif
 
 #include <string>
+#include <utility>
 
 #include <key.hpp>
 
@@ -25,6 +26,11 @@ namespace kdb
 #ifndef ELEKTRA_WITHOUT_ITERATOR
 class KeySetIterator;
 class KeySetReverseIterator;
+class KeySetRange;
+template <typename Predicate>
+class KeySetFilterView;
+struct KeySetDirectBelowPredicate;
+struct KeySetHasMetaPredicate;
 #endif
 
 
@@ -58,6 +64,7 @@ public:
 	inline KeySet ();
 	inline KeySet (ckdb::KeySet * k);
 	inline KeySet (const KeySet & other);
+	inline KeySet (KeySet && other) noexcept;
 
 	ELEKTRA_WRONG explicit KeySet (Key, ...);
 
@@ -72,6 +79,7 @@ public:
 	void setKeySet (ckdb::KeySet * k);
 
 	KeySet & operator= (KeySet const & other);
+	KeySet & operator= (KeySet && other) noexcept;
 
 	ssize_t size () const;
 
@@ -126,6 +134,11 @@ public:
 	const_iterator cend () const noexcept;
 	const_reverse_iterator crbegin () const noexcept;
 	const_reverse_iterator crend () const noexcept;
+
+	// views
+	KeySetRange below (const Key & parent) const;
+	KeySetFilterView<KeySetDirectBelowPredicate> children (const Key & parent) const;
+	KeySetFilterView<KeySetHasMetaPredicate> withMeta (const std::string & metaName) const;
 #endif // ELEKTRA_WITHOUT_ITERATOR
 
 private:
@@ -479,6 +492,299 @@ inline KeySet::const_reverse_iterator KeySet::crend () const noexcept
 {
 	return KeySet::const_reverse_iterator (*this, -1);
 }
+
+/**
+ * @brief A contiguous range of keys within a keyset.
+ *
+ * Lightweight view over a part of the underlying keyset,
+ * no keys are copied and no Key wrapper is constructed
+ * before an iterator is dereferenced.
+ *
+ * @code
+	for (Key k : ks.below (parent))
+	{
+		std::cout << k.getName () << std::endl;
+	}
+ * @endcode
+ *
+ * @note the view is only valid as long as the keyset
+ * is not modified.
+ *
+ * @see KeySet::below()
+ */
+class KeySetRange
+{
+public:
+	typedef KeySetIterator iterator;
+	typedef KeySetIterator const_iterator;
+
+	KeySetRange (KeySet const & k, elektraCursor begin_, elektraCursor end_) : ks (k), beginCursor (begin_), endCursor (end_)
+	{
+	}
+
+	iterator begin () const
+	{
+		return iterator (ks, beginCursor);
+	}
+	iterator end () const
+	{
+		return iterator (ks, endCursor);
+	}
+
+	ssize_t size () const
+	{
+		return endCursor - beginCursor;
+	}
+	bool empty () const
+	{
+		return endCursor <= beginCursor;
+	}
+
+private:
+	KeySet const & ks;
+	elektraCursor beginCursor;
+	elektraCursor endCursor;
+};
+
+/**
+ * @brief Matches keys directly below a given parent.
+ *
+ * @see KeySet::children()
+ */
+struct KeySetDirectBelowPredicate
+{
+	Key parent;
+
+	bool operator() (const ckdb::Key * k) const
+	{
+		return ckdb::keyIsDirectlyBelow (parent.getKey (), k) == 1;
+	}
+};
+
+/**
+ * @brief Matches keys carrying a given metakey.
+ *
+ * @see KeySet::withMeta()
+ */
+struct KeySetHasMetaPredicate
+{
+	std::string metaName;
+
+	bool operator() (const ckdb::Key * k) const
+	{
+		return ckdb::keyGetMeta (k, metaName.c_str ()) != nullptr;
+	}
+};
+
+/**
+ * @brief Iterates over the keys of a range that match a predicate.
+ *
+ * Keys not matching the predicate are skipped, a Key wrapper is
+ * only constructed when the iterator is dereferenced.
+ *
+ * @see KeySetFilterView
+ */
+template <typename Predicate>
+class KeySetFilterIterator
+{
+public:
+	typedef Key value_type;
+	typedef elektraCursor difference_type;
+	typedef Key pointer;
+	typedef Key reference;
+	typedef std::forward_iterator_tag iterator_category;
+
+	KeySetFilterIterator (KeySet const & k, elektraCursor current_, elektraCursor end_, Predicate const & predicate_)
+	: ks (k), current (current_), endCursor (end_), predicate (predicate_)
+	{
+		skip ();
+	}
+
+	Key get () const
+	{
+		return Key (ckdb::ksAtCursor (ks.getKeySet (), current));
+	}
+
+	reference operator* () const
+	{
+		return get ();
+	}
+	pointer operator-> () const
+	{
+		return get ();
+	}
+	KeySetFilterIterator & operator++ ()
+	{
+		++current;
+		skip ();
+		return *this;
+	}
+	KeySetFilterIterator operator++ (int)
+	{
+		KeySetFilterIterator ret (*this);
+		++current;
+		skip ();
+		return ret;
+	}
+	const elektraCursor & base () const
+	{
+		return current;
+	}
+
+private:
+	void skip ()
+	{
+		while (current < endCursor && !predicate (ckdb::ksAtCursor (ks.getKeySet (), current)))
+		{
+			++current;
+		}
+	}
+
+	KeySet const & ks;
+	elektraCursor current;
+	elektraCursor endCursor;
+	Predicate predicate;
+};
+
+template <typename Predicate>
+inline bool operator== (const KeySetFilterIterator<Predicate> & lhs, const KeySetFilterIterator<Predicate> & rhs)
+{
+	return lhs.base () == rhs.base ();
+}
+
+template <typename Predicate>
+inline bool operator!= (const KeySetFilterIterator<Predicate> & lhs, const KeySetFilterIterator<Predicate> & rhs)
+{
+	return lhs.base () != rhs.base ();
+}
+
+/**
+ * @brief A filtered view over a part of a keyset.
+ *
+ * Lightweight view, no keys are copied and no Key wrapper is
+ * constructed before an iterator is dereferenced.
+ *
+ * @code
+	for (Key k : ks.withMeta ("type"))
+	{
+		std::cout << k.getName () << std::endl;
+	}
+ * @endcode
+ *
+ * @note the view is only valid as long as the keyset
+ * is not modified.
+ *
+ * @see KeySet::children(), KeySet::withMeta()
+ */
+template <typename Predicate>
+class KeySetFilterView
+{
+public:
+	typedef KeySetFilterIterator<Predicate> iterator;
+	typedef KeySetFilterIterator<Predicate> const_iterator;
+
+	KeySetFilterView (KeySet const & k, elektraCursor begin_, elektraCursor end_, Predicate const & predicate_)
+	: ks (k), beginCursor (begin_), endCursor (end_), predicate (predicate_)
+	{
+	}
+
+	iterator begin () const
+	{
+		return iterator (ks, beginCursor, endCursor, predicate);
+	}
+	iterator end () const
+	{
+		return iterator (ks, endCursor, endCursor, predicate);
+	}
+
+private:
+	KeySet const & ks;
+	elektraCursor beginCursor;
+	elektraCursor endCursor;
+	Predicate predicate;
+};
+
+/**
+ * @brief View of all keys below a parent key.
+ *
+ * The keys below a parent are contiguous in the sorted keyset,
+ * so the range is found with two binary searches and iterating
+ * it costs nothing beyond the plain iterators.
+ *
+ * @param parent the parent key, it is itself not part of the view
+ *
+ * @note @p parent must carry a fully qualified name,
+ * for cascading names lookup the namespaces one by one.
+ *
+ * @return a view of the keys below @p parent
+ */
+inline KeySetRange KeySet::below (const Key & parent) const
+{
+	// first key after the parent itself
+	elektraCursor lo = 0;
+	elektraCursor hi = size ();
+	while (lo < hi)
+	{
+		elektraCursor mid = lo + (hi - lo) / 2;
+		if (ckdb::keyCmp (ckdb::ksAtCursor (ks, mid), parent.getKey ()) <= 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	elektraCursor first = lo;
+
+	// the keys below the parent follow directly, find the first that is not
+	hi = size ();
+	while (lo < hi)
+	{
+		elektraCursor mid = lo + (hi - lo) / 2;
+		if (ckdb::keyIsBelow (parent.getKey (), ckdb::ksAtCursor (ks, mid)) == 1)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return KeySetRange (*this, first, lo);
+}
+
+/**
+ * @brief View of the keys directly below a parent key.
+ *
+ * Like below(), but grandchildren and deeper keys are skipped.
+ *
+ * @param parent the parent key, it is itself not part of the view
+ *
+ * @note @p parent must carry a fully qualified name,
+ * for cascading names lookup the namespaces one by one.
+ *
+ * @return a view of the keys directly below @p parent
+ */
+inline KeySetFilterView<KeySetDirectBelowPredicate> KeySet::children (const Key & parent) const
+{
+	KeySetRange range = below (parent);
+	KeySetDirectBelowPredicate predicate = { parent };
+	return KeySetFilterView<KeySetDirectBelowPredicate> (*this, range.begin ().base (), range.end ().base (), predicate);
+}
+
+/**
+ * @brief View of all keys carrying a given metakey.
+ *
+ * @param metaName the name of the metakey to look for
+ *
+ * @return a view of the keys where the metakey is set
+ */
+inline KeySetFilterView<KeySetHasMetaPredicate> KeySet::withMeta (const std::string & metaName) const
+{
+	KeySetHasMetaPredicate predicate = { metaName };
+	return KeySetFilterView<KeySetHasMetaPredicate> (*this, 0, size (), predicate);
+}
 #endif // ELEKTRA_WITHOUT_ITERATOR
 
 
@@ -527,6 +833,19 @@ inline KeySet::KeySet (const KeySet & other)
 	ks = other.dup ();
 }
 
+/**
+ * Take over the keyset of another keyset.
+ *
+ * No keys are duplicated, the other keyset
+ * holds an empty keyset afterwards.
+ *
+ * @param other the keyset to take the keys from
+ */
+inline KeySet::KeySet (KeySet && other) noexcept : ks (other.ks)
+{
+	other.ks = ckdb::ksNew (0, KS_END);
+}
+
 /**
  * @brief Create a new keyset.
  *
@@ -628,6 +947,21 @@ inline KeySet & KeySet::operator= (KeySet const & other)
 	return *this;
 }
 
+/**
+ * Take over the keyset of another keyset.
+ *
+ * No keys are duplicated, the other keyset
+ * holds an empty keyset afterwards.
+ */
+inline KeySet & KeySet::operator= (KeySet && other) noexcept
+{
+	if (this != &other)
+	{
+		std::swap (ks, other.ks);
+	}
+	return *this;
+}
+
 /**
  * @brief The size of the keyset
  *
@@ -10,6 +10,7 @@
 #define ELEKTRA_KEYSET_IO_HPP
 
 #include <iostream>
+#include <string>
 
 #include <keyio.hpp>
 
@@ -85,6 +86,181 @@ inline std::istream & operator>> (std::istream & is, kdb::KeySet & ks)
 
 	return is;
 }
+
+/**
+ * @brief Renders keysets for diagnostics without per-field stream calls
+ *
+ * The operator<< overloads above cost one virtual ostream call per field,
+ * which makes dumping large keysets slower than fetching them. This
+ * formatter renders names, values and metadata of a whole keyset into one
+ * growable buffer and hands it to the stream with a single write(), so
+ * diagnostic dumps of very large keysets stay feasible.
+ *
+ * Each key is rendered as `name = "value"` (escaped, binary values as
+ * `(binary, n bytes)`) followed by one indented line per metakey. The
+ * output is for humans and cannot be parsed back; use the plugin
+ * framework for serialization.
+ *
+ * For a size-bounded summary set maxKeys() and/or maxValueLength():
+ * keys beyond the bound are counted instead of rendered, overlong
+ * values are cut with an ellipsis.
+ */
+class KeySetFormatter
+{
+public:
+	KeySetFormatter () : m_maxKeys (0), m_maxValueLength (0)
+	{
+	}
+
+	/**
+	 * @brief Render at most @p n keys, 0 means all (the default)
+	 */
+	KeySetFormatter & maxKeys (size_t n)
+	{
+		m_maxKeys = n;
+		return *this;
+	}
+
+	/**
+	 * @brief Render at most @p n characters per value, 0 means all (the default)
+	 */
+	KeySetFormatter & maxValueLength (size_t n)
+	{
+		m_maxValueLength = n;
+		return *this;
+	}
+
+	/**
+	 * @brief Renders the whole keyset into one string
+	 */
+	std::string format (kdb::KeySet const & ks) const
+	{
+		std::string out;
+		out.reserve (ks.size () > 0 ? static_cast<size_t> (ks.size ()) * 48 : 16);
+
+		size_t rendered = 0;
+		for (ssize_t it = 0; it < ks.size (); ++it)
+		{
+			if (m_maxKeys > 0 && rendered >= m_maxKeys) break;
+			formatKey (out, ks.at (it).getKey ());
+			++rendered;
+		}
+
+		if (rendered < static_cast<size_t> (ks.size ()))
+		{
+			out += "... ";
+			appendNumber (out, ks.size () - rendered);
+			out += " more keys\n";
+		}
+		return out;
+	}
+
+	/**
+	 * @brief Renders the whole keyset and writes it with a single call
+	 */
+	std::ostream & write (std::ostream & os, kdb::KeySet const & ks) const
+	{
+		const std::string out = format (ks);
+		os.write (out.data (), out.size ());
+		return os;
+	}
+
+private:
+	void formatKey (std::string & out, ckdb::Key const * key) const
+	{
+		ckdb::Key * k = const_cast<ckdb::Key *> (key);
+		out.append (ckdb::keyName (k), ckdb::keyGetNameSize (k) - 1);
+		out += " = ";
+		formatValue (out, k);
+		out += '\n';
+
+		ckdb::KeySet * meta = ckdb::keyMeta (k);
+		for (ssize_t it = 0; it < ckdb::ksGetSize (meta); ++it)
+		{
+			ckdb::Key * m = ckdb::ksAtCursor (meta, it);
+			out += "  ";
+			out.append (ckdb::keyName (m), ckdb::keyGetNameSize (m) - 1);
+			out += " = ";
+			formatValue (out, m);
+			out += '\n';
+		}
+	}
+
+	void formatValue (std::string & out, ckdb::Key * k) const
+	{
+		if (ckdb::keyIsBinary (k))
+		{
+			out += "(binary, ";
+			appendNumber (out, ckdb::keyGetValueSize (k));
+			out += " bytes)";
+			return;
+		}
+
+		const char * value = ckdb::keyString (k);
+		size_t size = ckdb::keyGetValueSize (k) > 0 ? ckdb::keyGetValueSize (k) - 1 : 0;
+		size_t bound = m_maxValueLength > 0 && m_maxValueLength < size ? m_maxValueLength : size;
+
+		out += '"';
+		for (size_t i = 0; i < bound; ++i)
+		{
+			appendEscaped (out, value[i]);
+		}
+		out += '"';
+		if (bound < size)
+		{
+			out += "... (";
+			appendNumber (out, size);
+			out += " bytes)";
+		}
+	}
+
+	static void appendEscaped (std::string & out, char c)
+	{
+		switch (c)
+		{
+		case '"':
+			out += "\\\"";
+			return;
+		case '\\':
+			out += "\\\\";
+			return;
+		case '\n':
+			out += "\\n";
+			return;
+		case '\t':
+			out += "\\t";
+			return;
+		case '\r':
+			out += "\\r";
+			return;
+		}
+		unsigned char u = static_cast<unsigned char> (c);
+		if (u < 0x20)
+		{
+			const char * hex = "0123456789abcdef";
+			out += "\\x";
+			out += hex[u >> 4];
+			out += hex[u & 0xf];
+			return;
+		}
+		out += c;
+	}
+
+	static void appendNumber (std::string & out, unsigned long long v)
+	{
+		char buffer[20]; // enough digits for 2^64-1
+		char * p = buffer + sizeof (buffer);
+		do
+		{
+			*--p = static_cast<char> ('0' + v % 10);
+			v /= 10;
+		} while (v > 0);
+		out.append (p, buffer + sizeof (buffer) - p);
+	}
+
+	size_t m_maxKeys;
+	size_t m_maxValueLength;
+};
 } // namespace kdb
 
 #endif
@@ -0,0 +1,94 @@
+/**
+ * @file
+ *
+ * @brief
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <tests.hpp>
+
+#include <kdbasync.hpp>
+
+#include <atomic>
+#include <future>
+
+TEST (kdbasync, getSetFuture)
+{
+	// write keys through the asynchronous interface
+	{
+		KeySet ks;
+		Key parent ("user:/tests/async", KEY_END);
+		AsyncKDB kdb;
+		kdb.getAsync (ks, parent).wait ();
+		ks.append (Key ("user:/tests/async/key1", KEY_VALUE, "value1", KEY_END));
+		ks.append (Key ("user:/tests/async/key2", KEY_VALUE, "value2", KEY_END));
+		std::future<int> result = kdb.setAsync (ks, parent);
+		succeed_if (result.get () != -1, "async set failed");
+	}
+
+	// check if they were written, synchronously
+	{
+		KDB kdb;
+		KeySet ks;
+		kdb.get (ks, "user:/tests/async");
+		exit_if_fail (ks.lookup ("user:/tests/async/key1"), "could not find previously written key");
+		succeed_if (ks.lookup ("user:/tests/async/key2").get<std::string> () == "value2", "could not get value");
+	}
+
+	// queued operations must run in order on the same handle
+	{
+		KeySet ks;
+		Key parent ("user:/tests/async", KEY_END);
+		AsyncKDB kdb;
+		std::future<int> got = kdb.getAsync (ks, parent);
+		std::future<int> gotAgain = kdb.getAsync (ks, parent);
+		succeed_if (got.get () != -1, "async get failed");
+		succeed_if (gotAgain.get () != -1, "queued async get failed");
+		succeed_if (ks.lookup ("user:/tests/async/key1"), "async get did not return the key");
+	}
+
+	// cleanup
+	{
+		KeySet ks;
+		Key parent ("user:/tests/async", KEY_END);
+		AsyncKDB kdb;
+		kdb.getAsync (ks, parent).wait ();
+		ks.cut (Key ("user:/tests/async", KEY_END));
+		succeed_if (kdb.setAsync (ks, parent).get () != -1, "async cleanup set failed");
+	}
+}
+
+TEST (kdbasync, completionHandler)
+{
+	KeySet ks;
+	Key parent ("user:/tests/async", KEY_END);
+	AsyncKDB kdb;
+
+	std::promise<int> done;
+	kdb.getAsync (ks, parent, [&done] (std::exception_ptr error, int ret) {
+		if (error)
+		{
+			done.set_exception (error);
+			return;
+		}
+		done.set_value (ret);
+	});
+	succeed_if (done.get_future ().get () != -1, "async get with handler failed");
+}
+
+TEST (kdbasync, pendingOnDestruction)
+{
+	// the destructor must wait for pending operations instead of dropping them
+	std::atomic<int> handled (0);
+	{
+		KeySet ks;
+		Key parent ("user:/tests/async", KEY_END);
+		AsyncKDB kdb;
+		for (int i = 0; i < 5; ++i)
+		{
+			kdb.getAsync (ks, parent, [&handled] (std::exception_ptr, int) { ++handled; });
+		}
+	}
+	succeed_if (handled == 5, "pending operations were dropped on destruction");
+}
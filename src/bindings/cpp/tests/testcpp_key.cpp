@@ -63,6 +63,53 @@ TEST (key, typebool)
 	ASSERT_TRUE (k.get<bool> ());
 }
 
+// the grammar accepted by get<T>() must not depend on whether the
+// std::from_chars fast path or the stream fallback is compiled in
+TEST (key, getNumberGrammar)
+{
+	Key k ("user:/key", KEY_VALUE, "5", KEY_END);
+	EXPECT_EQ (k.get<int> (), 5);
+	EXPECT_EQ (k.get<long long> (), 5);
+	EXPECT_EQ (k.get<unsigned int> (), 5u);
+	EXPECT_EQ (k.get<double> (), 5.0);
+
+	// leading whitespace and an explicit plus sign are accepted
+	k.setString ("+5");
+	EXPECT_EQ (k.get<int> (), 5);
+	EXPECT_EQ (k.get<unsigned int> (), 5u);
+	EXPECT_EQ (k.get<double> (), 5.0);
+	k.setString (" 5");
+	EXPECT_EQ (k.get<int> (), 5);
+	EXPECT_EQ (k.get<double> (), 5.0);
+	k.setString ("\t +5");
+	EXPECT_EQ (k.get<int> (), 5);
+	k.setString ("-5");
+	EXPECT_EQ (k.get<int> (), -5);
+	k.setString ("+.5");
+	EXPECT_EQ (k.get<double> (), 0.5);
+
+	// trailing characters and a detached or repeated sign are not
+	k.setString ("5 ");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString ("+ 5");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString ("+-5");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString ("++5");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString (" ");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+	k.setString ("");
+	EXPECT_THROW (k.get<int> (), KeyTypeConversion);
+
+#if __cplusplus >= 201703L
+	// documented difference of the fast path: a negative value for an
+	// unsigned type throws instead of wrapping around like a stream
+	k.setString ("-5");
+	EXPECT_THROW (k.get<unsigned int> (), KeyTypeConversion);
+#endif
+}
+
 
 TEST (key, keynew)
 {
@@ -7,6 +7,7 @@
  */
 
 #include <keyio.hpp>
+#include <keysetio.hpp>
 
 #include <tests.hpp>
 
@@ -51,3 +52,26 @@ TEST (keyio, inmeta)
 	ss >> k2;
 	EXPECT_EQ (k, k2);
 }
+
+TEST (keysetio, format)
+{
+	KeySet ks (3, *Key ("user:/a", KEY_VALUE, "say \"hi\"\n", KEY_META, "type", "string", KEY_END),
+		   *Key ("user:/b", KEY_BINARY, KEY_SIZE, 4, KEY_VALUE, "\x01\x02\x03\x04", KEY_END), KS_END);
+	std::string out = KeySetFormatter ().format (ks);
+	EXPECT_NE (out.find ("user:/a = \"say \\\"hi\\\"\\n\"\n"), std::string::npos);
+	EXPECT_NE (out.find ("  meta:/type = \"string\"\n"), std::string::npos);
+	EXPECT_NE (out.find ("user:/b = (binary, 4 bytes)\n"), std::string::npos);
+
+	std::ostringstream os;
+	KeySetFormatter ().write (os, ks);
+	EXPECT_EQ (os.str (), out);
+}
+
+TEST (keysetio, formatSummary)
+{
+	KeySet ks (3, *Key ("user:/a", KEY_VALUE, "0123456789", KEY_END), *Key ("user:/b", KEY_END), *Key ("user:/c", KEY_END), KS_END);
+	std::string out = KeySetFormatter ().maxKeys (1).maxValueLength (4).format (ks);
+	EXPECT_NE (out.find ("user:/a = \"0123\"... (10 bytes)\n"), std::string::npos);
+	EXPECT_NE (out.find ("... 2 more keys\n"), std::string::npos);
+	EXPECT_EQ (out.find ("user:/b"), std::string::npos);
+}
@@ -354,6 +354,22 @@ public interface Elektra extends Library {
 
 	@Nullable Pointer ksAtCursor (Pointer ks, int cursor);
 
+	/**
+	 * Serializes the keys in the range [{@code start}, {@code end}) of the key
+	 * set into {@code buffer} with a single native call. See
+	 * {@link KeySet#bulkRead(int, int)} for the record format consumer.
+	 *
+	 * @param ks     {@link Pointer} to the key set
+	 * @param start  index of the first key
+	 * @param end    index after the last key
+	 * @param buffer direct {@link java.nio.ByteBuffer} receiving the records, or
+	 *               {@code null} to query the required buffer size
+	 * @param size   capacity of {@code buffer} in bytes
+	 * @return number of bytes written, the required buffer size if
+	 *         {@code buffer} is {@code null}, or -1 on error
+	 */
+	long elektraKsSerialize (Pointer ks, long start, long end, @Nullable java.nio.ByteBuffer buffer, long size);
+
 	@Nullable Pointer ksLookup (Pointer ks, Pointer key, int options);
 
 	@Nullable Pointer ksLookupByName (Pointer ks, String name, int options);
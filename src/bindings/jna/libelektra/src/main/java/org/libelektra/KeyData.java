@@ -0,0 +1,68 @@
+package org.libelektra;
+
+import java.nio.charset.StandardCharsets;
+import java.util.Map;
+import javax.annotation.Nonnull;
+
+/**
+ * Immutable snapshot of one key's name, value and metadata, produced by
+ * {@link KeySet#bulkRead(int, int)}. Unlike {@link Key} it is a plain Java
+ * object without a native handle, so reading it causes no native calls.
+ */
+public class KeyData
+{
+
+	private final String name;
+	private final byte[] value;
+	private final boolean binary;
+	private final Map<String, String> meta;
+
+	KeyData (String name, byte[] value, boolean binary, Map<String, String> meta)
+	{
+		this.name = name;
+		this.value = value;
+		this.binary = binary;
+		this.meta = meta;
+	}
+
+	/**
+	 * @return Key name (key part of "key-value" pair)
+	 */
+	@Nonnull public String getName ()
+	{
+		return name;
+	}
+
+	/**
+	 * @return True if the value of the key is binary, false otherwise
+	 */
+	public boolean isBinary ()
+	{
+		return binary;
+	}
+
+	/**
+	 * @return Key value as string, the empty string for binary keys
+	 */
+	@Nonnull public String getString ()
+	{
+		return binary ? "" : new String (value, 0, value.length > 0 ? value.length - 1 : 0, StandardCharsets.UTF_8);
+	}
+
+	/**
+	 * @return Key value in binary format
+	 */
+	@Nonnull public byte[] getBinary ()
+	{
+		return value.clone ();
+	}
+
+	/**
+	 * @return Metadata of the key, mapping metakey names (e.g. "meta:/type")
+	 *         to their values
+	 */
+	@Nonnull public Map<String, String> getMeta ()
+	{
+		return meta;
+	}
+}
@@ -6,8 +6,16 @@ import static org.libelektra.ValidationUtil.checkKeyPointer;
 
 import com.sun.jna.Pointer;
 import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
 import java.util.Arrays;
+import java.util.Collections;
 import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
 import java.util.NoSuchElementException;
 import java.util.Optional;
 import java.util.stream.Stream;
@@ -321,6 +329,75 @@ public class KeySet implements Iterable<Key>
 		return checkKeyPointer (Elektra.INSTANCE.ksAtCursor (getPointer (), cursor), IndexOutOfBoundsException::new);
 	}
 
+	/**
+	 * Reads the names, values and metadata of the keys at cursor positions
+	 * [{@code start}, {@code end}) with a single native call.<br>
+	 * <br>
+	 * In contrast to iterating {@link Key keys} obtained via {@link #at(int)},
+	 * which crosses the native boundary for every name, value and metadata
+	 * access, this copies the whole range into one direct
+	 * {@link ByteBuffer} and materializes plain Java objects from it, so large
+	 * key sets can be consumed at array speed.
+	 *
+	 * @param start Cursor position of the first key; starting from 0
+	 * @param end   Cursor position after the last key; clamped to the key set
+	 *              size
+	 * @return Snapshots of the keys in the range
+	 * @throws KeySetReleasedException   if this {@link KeySet} has already been
+	 *                                   released
+	 * @throws IndexOutOfBoundsException if the range is invalid
+	 */
+	@Nonnull public List<KeyData> bulkRead (int start, int end)
+	{
+		long required = Elektra.INSTANCE.elektraKsSerialize (getPointer (), start, end, null, 0);
+		if (required < 0)
+		{
+			throw new IndexOutOfBoundsException ();
+		}
+
+		ByteBuffer buffer = ByteBuffer.allocateDirect ((int) required).order (ByteOrder.nativeOrder ());
+		if (Elektra.INSTANCE.elektraKsSerialize (getPointer (), start, end, buffer, required) < 0)
+		{
+			throw new IndexOutOfBoundsException ();
+		}
+
+		List<KeyData> result = new ArrayList<> ();
+		while (buffer.remaining () > 0)
+		{
+			int nameSize = buffer.getInt ();
+			int valueSize = buffer.getInt ();
+			boolean binary = buffer.getInt () != 0;
+			int metaCount = buffer.getInt ();
+
+			String name = readString (buffer, nameSize);
+			byte[] value = new byte[valueSize];
+			buffer.get (value);
+
+			Map<String, String> meta = new LinkedHashMap<> ();
+			for (int i = 0; i < metaCount; ++i)
+			{
+				int metaNameSize = buffer.getInt ();
+				int metaValueSize = buffer.getInt ();
+				String metaName = readString (buffer, metaNameSize);
+				String metaValue = readString (buffer, metaValueSize);
+				meta.put (metaName, metaValue);
+			}
+
+			result.add (new KeyData (name, value, binary, Collections.unmodifiableMap (meta)));
+		}
+		return result;
+	}
+
+	/**
+	 * Reads a null terminated string of {@code size} bytes from {@code buffer}
+	 */
+	@Nonnull private static String readString (ByteBuffer buffer, int size)
+	{
+		byte[] bytes = new byte[size];
+		buffer.get (bytes);
+		return new String (bytes, 0, size > 0 ? size - 1 : 0, StandardCharsets.UTF_8);
+	}
+
 	/**
 	 * Search for a key in the key set
 	 *
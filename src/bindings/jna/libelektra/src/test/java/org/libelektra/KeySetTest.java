@@ -80,6 +80,25 @@ public class KeySetTest
 		assertFalse (iterator.hasNext ());
 	}
 
+	@Test public void test_keySetBulkRead_shouldPass ()
+	{
+		var ks = KeySet.create (6, key, key2, key3, key4, key5, key6);
+		var keyData = ks.bulkRead (0, ks.size ());
+
+		assertEquals (6, keyData.size ());
+		assertEquals (KEY_1_NAME, keyData.get (0).getName ());
+		assertEquals (KEY_1_VALUE, keyData.get (0).getString ());
+		assertFalse (keyData.get (0).isBinary ());
+		assertEquals (KEY_6_NAME, keyData.get (5).getName ());
+		assertEquals (KEY_6_VALUE, keyData.get (5).getString ());
+
+		var range = ks.bulkRead (1, 3);
+
+		assertEquals (2, range.size ());
+		assertEquals (KEY_2_NAME, range.get (0).getName ());
+		assertEquals (KEY_3_NAME, range.get (1).getName ());
+	}
+
 	@Test public void test_keySetIteratorDelete_shouldPass ()
 	{
 		var ks = KeySet.create (6, key, key2, key3, key4, key5, key6);
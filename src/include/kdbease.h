@@ -22,7 +22,9 @@ int elektraArrayValidateBaseNameString (const char * baseName);
 const char * elektraKeyGetRelativeName (Key const * cur, Key const * parentKey);
 
 KeySet * elektraArrayGet (const Key * arrayParent, KeySet * keys);
+KeySet * elektraArrayGetRange (const Key * arrayParent, KeySet * keys, kdb_long_long_t start, kdb_long_long_t end);
 Key * elektraArrayGetNextKey (KeySet * arrayKeys);
+Key * elektraArrayAppendNextKey (KeySet * arrayKeys);
 
 elektraKeyFlags keyCompare (const Key * key1, const Key * key2);
 elektraKeyFlags keyCompareMeta (const Key * key1, const Key * key2);
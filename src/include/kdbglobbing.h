@@ -11,9 +11,16 @@ extern "C" {
 
 #define ELEKTRA_GLOB_NOMATCH (-1)
 
+typedef struct _ElektraGlobPattern ElektraGlobPattern;
+
 int elektraKeyGlob (const Key * key, const char * pattern);
 int elektraKsGlob (KeySet * result, KeySet * input, const char * pattern);
 
+ElektraGlobPattern * elektraGlobCompile (const char * pattern);
+int elektraKeyGlobCompiled (const Key * key, const ElektraGlobPattern * pattern);
+size_t elektraGlobPatternPrefix (const ElektraGlobPattern * pattern, const char ** prefix);
+void elektraGlobPatternDel (ElektraGlobPattern * pattern);
+
 #ifdef __cplusplus
 }
 }
@@ -12,6 +12,10 @@
 #ifndef KDB_HELPER
 #define KDB_HELPER
 
+#ifdef HAVE_KDBCONFIG_H
+#include "kdbconfig.h"
+#endif
+
 #include <kdbmacros.h>
 #include <kdbtypes.h>
 
@@ -33,6 +37,21 @@ int elektraRealloc (void ** buffer, size_t size);
 char * elektraStrDup (const char * s);
 void * elektraMemDup (const void * s, size_t l);
 
+#ifdef ELEKTRA_MALLOC_TRACE
+/* tagged variants recording per call site statistics, see internal.c */
+void * elektraMallocTrace (size_t size, const char * file, int line);
+void * elektraCallocTrace (size_t size, const char * file, int line);
+int elektraReallocTrace (void ** buffer, size_t size, const char * file, int line);
+char * elektraStrDupTrace (const char * s, const char * file, int line);
+void * elektraMemDupTrace (const void * s, size_t l, const char * file, int line);
+
+#define elektraMalloc(size) elektraMallocTrace (size, __FILE__, __LINE__)
+#define elektraCalloc(size) elektraCallocTrace (size, __FILE__, __LINE__)
+#define elektraRealloc(buffer, size) elektraReallocTrace (buffer, size, __FILE__, __LINE__)
+#define elektraStrDup(s) elektraStrDupTrace (s, __FILE__, __LINE__)
+#define elektraMemDup(s, l) elektraMemDupTrace (s, l, __FILE__, __LINE__)
+#endif
+
 char * elektraFormat (const char * format, ...) ELEKTRA_ATTRIBUTE_FORMAT (printf, 1, 2);
 char * elektraVFormat (const char * format, va_list arg_list);
 
@@ -47,6 +66,14 @@ int elektraMemCaseCmp (const char * s1, const char * s2, size_t size);
 size_t elektraStrLen (const char * s);
 int elektraWriteArrayNumber (char * newName, kdb_long_long_t newIndex);
 
+/* Micro profiling, recording only when the environment variable KDB_TIMER is set (see timer.c) */
+int elektraTimerEnabled (void);
+kdb_unsigned_long_long_t elektraTimerTicks (void);
+void elektraTimerBegin (const char * name);
+void elektraTimerEnd (const char * name);
+void elektraTimerAdd (const char * name, kdb_unsigned_long_long_t value);
+void elektraTimerDump (const char * path);
+
 
 /**
  * @brief More lookup options
@@ -141,6 +141,13 @@
 #define ELEKTRA_DEPRECATED
 #endif
 
+#ifdef __GNUC__
+/** Declares a symbol as weak, so it may be left undefined. */
+#define ELEKTRA_WEAK __attribute__ ((weak))
+#else
+#define ELEKTRA_WEAK
+#endif
+
 /**
  * Helper macro to create a versioned name of a symbol.
  *
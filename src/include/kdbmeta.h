@@ -12,6 +12,7 @@
 #define KDBMETA_H
 
 #include "kdb.h"
+#include "kdbtypes.h"
 
 #ifdef __cplusplus
 namespace ckdb
@@ -34,6 +35,9 @@ char * elektraMetaArrayToString (const Key *, const char *, const char *);
 
 int elektraSortTopology (KeySet *, Key **);
 
+ssize_t elektraMetaOrderRange (KeySet * ks, elektraCursor start, elektraCursor end, kdb_long_long_t startIndex);
+ssize_t elektraMetaCopyRange (KeySet * ks, elektraCursor start, elektraCursor end, const Key * source);
+
 #ifdef __cplusplus
 }
 }
@@ -18,7 +18,12 @@ namespace ckdb
 extern "C" {
 #endif
 
+typedef struct _ElektraOptsSpec ElektraOptsSpec;
+
 int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** envp, Key * parentKey);
+ElektraOptsSpec * elektraGetOptsSpecProcess (KeySet * ks, Key * parentKey);
+int elektraGetOptsSpec (ElektraOptsSpec * spec, KeySet * ks, int argc, const char ** argv, const char ** envp, Key * parentKey);
+void elektraGetOptsSpecDel (ElektraOptsSpec * spec);
 char * elektraGetOptsHelpMessage (Key * helpKey, const char * usage, const char * prefix);
 
 #ifdef __cplusplus
@@ -32,6 +32,10 @@
 	it says how much can actually be stored.*/
 #define KEYSET_SIZE 16
 
+/** Capacity of the OPMPHM insert side-table. When more keys are
+	inserted without a rebuild, the OPMPHM is discarded. */
+#define OPMPHM_MAX_INSERTS 32
+
 /** How many plugins can exist in an backend. */
 #define NR_OF_PLUGINS 10
 
@@ -68,6 +72,30 @@
 /** All keys below this are used for cache metadata in the global keyset */
 #define KDB_CACHE_PREFIX "system:/elektra/cache"
 
+/** Suffix of the commit journal kdbSet() writes next to every configuration
+ * file involved in a commit that spans more than one backend. The resolver
+ * replays it on the next get if a crash interrupted the renames. */
+#define ELEKTRA_COMMIT_JOURNAL_SUFFIX ".journal"
+
+/** First line of a commit journal, also carries its format version */
+#define ELEKTRA_COMMIT_JOURNAL_HEADER "elektra commit journal v1"
+
+/** Suffix of the per mountpoint change journal files kdbSet() appends to
+ * when the system:/elektra/contract/journal contract key is set */
+#define ELEKTRA_CHANGE_JOURNAL_SUFFIX ".changes"
+
+/** Magic bytes at the start of a change journal file, the last byte
+ * carries the format version */
+#define ELEKTRA_CHANGE_JOURNAL_MAGIC "EKC1"
+
+/** A change journal file is compacted down to half of this size whenever
+ * an append lets it grow beyond it, dropping the oldest records */
+#define ELEKTRA_CHANGE_JOURNAL_MAX_SIZE (256 * 1024)
+
+/** Flush interval in milliseconds used by the write-behind contract when
+ * the system:/elektra/contract/writebehind key carries no usable value */
+#define ELEKTRA_WRITE_BEHIND_DEFAULT_INTERVAL 1000
+
 
 #ifdef __cplusplus
 namespace ckdb
@@ -89,6 +117,8 @@ typedef int (*kdbSetPtr) (Plugin * handle, KeySet * returned, Key * parentKey);
 typedef int (*kdbErrorPtr) (Plugin * handle, KeySet * returned, Key * parentKey);
 typedef int (*kdbCommitPtr) (Plugin * handle, KeySet * returned, Key * parentKey);
 
+typedef KeySet * (*kdbContractPtr) (void);
+
 typedef Backend * (*OpenMapper) (const char *, const char *, KeySet *);
 typedef int (*CloseMapper) (Backend *);
 
@@ -146,11 +176,18 @@ typedef enum {
 			 This flag is set once a Key name has been moved to a mapped region,
 			 and is removed if the name moves out of the mapped region.
 			 It prevents erroneous free() calls on these keys. */
-	KEY_FLAG_MMAP_DATA = 1 << 6	/*!<
+	KEY_FLAG_MMAP_DATA = 1 << 6,	/*!<
 			 Key value lies inside a mmap region.
 			 This flag is set once a Key value has been moved to a mapped region,
 			 and is removed if the value moves out of the mapped region.
 			 It prevents erroneous free() calls on these keys. */
+	KEY_FLAG_SMALL_DATA = 1 << 7	/*!<
+			 Key value is stored inline in the struct.
+			 Values small enough for the data union are stored in its
+			 small member instead of a separate heap allocation.
+			 It prevents erroneous free() calls on these keys.
+			 Never set together with #KEY_FLAG_MMAP_DATA.
+			 @see keyDataPtr() */
 } keyflag_t;
 
 
@@ -203,6 +240,8 @@ struct _Key
 {
 	/**
 	 * The value, which is a NULL terminated string or binary.
+	 * Values smaller than the union are stored inline in the small
+	 * member (see #KEY_FLAG_SMALL_DATA); use keyDataPtr() to read.
 	 * @see keyString(), keyBinary(),
 	 * @see keyGetString(), keyGetBinary(),
 	 * @see keySetString(), keySetBinary()
@@ -210,6 +249,7 @@ struct _Key
 	union {
 		char * c;
 		void * v;
+		char small[16];
 	} data;
 
 	/**
@@ -243,11 +283,26 @@ struct _Key
 	 */
 	size_t keyUSize;
 
+	/**
+	 * The first bytes of the unescaped name, zero-padded.
+	 * Lets keyCmp() decide most comparisons without dereferencing ukey.
+	 * Must be refreshed via keyUpdateNamePrefix() whenever ukey changes.
+	 */
+	char ukeyPrefix[8];
+
 	/**
 	 * Some control and internal flags.
 	 */
 	keyflag_t flags;
 
+	/**
+	 * Offset into ukey where the basename starts, 0 while unknown.
+	 * Kept up to date by keyUpdateNamePrefix(), so keyBaseName() is
+	 * plain index math instead of a backward scan. Fits into the
+	 * padding between flags and ksReference.
+	 */
+	uint32_t ukeyBaseOffset;
+
 	/**
 	 * In how many keysets the key resists.
 	 * keySetName() is only allowed if ksReference is 0.
@@ -262,6 +317,27 @@ struct _Key
 };
 
 
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+/**
+ * Counters describing how ksLookup() searched a KeySet.
+ *
+ * Intended for tuning the OPMPHM predictor against a concrete
+ * workload, see ksLookupStatsEnable().
+ */
+struct _KsLookupStats
+{
+	size_t lookups;		/*!< lookups since the statistics were enabled */
+	size_t binarySearches;	/*!< lookups answered by binary search */
+	size_t opmphmSearches;	/*!< lookups answered by the OPMPHM */
+	size_t opmphmBuilds;	/*!< times the OPMPHM was (re)build */
+	size_t opmphmBuildMappings; /*!< seed sets tried over all OPMPHM builds */
+	size_t opmphmBuildNs;	/*!< wall-clock nanoseconds spent building the OPMPHM */
+	size_t predictions;	/*!< times the predictor was asked after a modification */
+	size_t predictedOpmphm; /*!< predictions that chose the OPMPHM */
+};
+#endif
+
+
 /**
  * The private KeySet structure.
  *
@@ -290,15 +366,78 @@ struct _KeySet
 	 */
 	ksflag_t flags;
 
+	/**
+	 * Number of keys sharing this KeySet as their metadata,
+	 * 0 while it is exclusively owned.
+	 * @see keyMetaShare(), keyMetaDetach()
+	 */
+	size_t metaRefs;
+
+	/**
+	 * Slab arena owning the memory of keys created via ksArenaKeyNew().
+	 * NULL unless the KeySet was created with ksNewWithArena().
+	 */
+	struct _KsArena * arena;
+
+	/**
+	 * Flat copy of the source KeySet pinning the keys whose name
+	 * buffers are shared with this KeySet, see ksCowDup().
+	 */
+	KeySet * cowSource;
+
+	/**
+	 * Inverted metadata index (metakey name -> key positions) built
+	 * lazily by ksFindByMeta(), NULL until first use.
+	 */
+	struct _KsMetaIndex * metaIndex;
+
+	/**
+	 * Incremented on every structural modification (keys added, removed
+	 * or replaced), so cached key positions can be validated cheaply.
+	 * @see ksLookupCached()
+	 */
+	size_t generation;
+
+	/**
+	 * Namespace slice boundaries of array, built lazily by binary search
+	 * lookups on larger KeySets and valid only while generation matches.
+	 * NULL until first use, see elektraLookupBinarySearch().
+	 */
+	struct _KsNsIndex * nsIndex;
+
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	/**
 	 * The Order Preserving Minimal Perfect Hash Map.
 	 */
 	Opmphm * opmphm;
+	/**
+	 * Lookup statistics, NULL until enabled with ksLookupStatsEnable().
+	 */
+	struct _KsLookupStats * lookupStats;
+	/**
+	 * Pinned search strategy applied to every lookup:
+	 * #KDB_O_OPMPHM, #KDB_O_BINSEARCH or 0 to let the predictor decide.
+	 * @see ksPinLookupStrategy()
+	 */
+	elektraLookupFlags lookupPin;
 	/**
 	 * The Order Preserving Minimal Perfect Hash Map Predictor.
 	 */
 	OpmphmPredictor * opmphmPredictor;
+	/**
+	 * Number of keys in the KeySet when the OPMPHM was build,
+	 * 0 if unknown (e.g. mmap()ed KeySets).
+	 */
+	size_t opmphmSize;
+	/**
+	 * Sorted current positions of keys inserted since the OPMPHM was
+	 * build (overflow side-table), NULL when not allocated yet.
+	 */
+	size_t * opmphmInserts;
+	/**
+	 * Number of valid entries in opmphmInserts.
+	 */
+	size_t opmphmInsertCount;
 #endif
 };
 
@@ -337,9 +476,44 @@ struct _KDB
 
 	Plugin * globalPlugins[NR_GLOBAL_POSITIONS][NR_GLOBAL_SUBPOSITIONS];
 
+	uint32_t globalPluginMask; /*!< Bitmask with one bit per GlobalpluginPositions entry that
+			holds at least one plugin. Recomputed by elektraGlobalMaskUpdate()
+			whenever globalPlugins changes, so the dispatch helpers can skip
+			unoccupied positions with a single branch.*/
+
+	uint64_t globalPluginCalls; /*!< Number of global plugin invocations made through the
+			elektraGlobal*() dispatch helpers, see elektraGlobalGetCalls().*/
+
 	KeySet * global; /*!< This keyset can be used by plugins to pass data through
 			the KDB and communicate with other plugins. Plugins shall clean
 			up their parts of the global keyset, which they do not need any more.*/
+
+	int parallelGet; /*!< When nonzero, independent backends run their get plugins
+			on separate threads during kdbGet(). Opt-in via the
+			system:/elektra/contract/parallelget contract key; requires
+			all mounted plugins to be reentrant.*/
+
+	int parallelSet; /*!< When nonzero, the precommit plugins (i.e. the fsync of
+			the sync plugin) of independent backends run on separate
+			threads during kdbSet(). Opt-in via the
+			system:/elektra/contract/parallelset contract key; requires
+			all mounted precommit plugins to be reentrant.*/
+
+	char * changeJournalDir; /*!< When set, every successful kdbSet() appends one
+			delta record per committed backend to a bounded journal
+			file in this directory, readable via kdbJournalRead().
+			Opt-in via the system:/elektra/contract/journal contract
+			key, whose value names the directory.*/
+
+	int writeBehindIntervalMs; /*!< When > 0, kdbSet() only records the commit and
+			returns; the backends are written at most once per this many
+			milliseconds, on the next kdbGet(), on kdbFlush() or on
+			kdbClose(). Opt-in via the system:/elektra/contract/writebehind
+			contract key, whose value is the interval.*/
+
+	struct _KdbWriteBehind * writeBehind; /*!< Deferred commit kept back by the
+			write-behind contract, lazily allocated by the first deferred
+			kdbSet(). See kdbFlush().*/
 };
 
 
@@ -375,6 +549,11 @@ struct _Backend
 	Plugin * getplugins[NR_OF_PLUGINS];
 	Plugin * errorplugins[NR_OF_PLUGINS];
 
+	Plugin * getChain[NR_OF_PLUGINS]; /*!< all getplugins after the resolver that implement kdbGet,
+		compacted by backendUpdateChains() when the backend is opened.
+		Lets the hot get path skip empty plugin positions. */
+	size_t getChainSize; /*!< number of entries in getChain */
+
 	ssize_t specsize;	/*!< The size of the spec key from the previous get.
 		-1 if still uninitialized.
 		Needed to know if a key was removed from a keyset. */
@@ -388,6 +567,12 @@ struct _Backend
 		-1 if still uninitialized.
 		Needed to know if a key was removed from a keyset. */
 
+	int partialGet; /*!< The previous get on this backend returned only the
+		requested subtree (a storage plugin honored the get/below
+		parent key metadata, see kdbGet()). kdbSet() refuses to write
+		such a backend until a full get happened, because the keyset
+		is missing the unread keys. */
+
 	size_t refcounter; /*!< This refcounter shows how often the backend
 	   is used.  Not cascading or default backends have 1 in it.
 	   More than three is not possible, because a backend
@@ -424,6 +609,9 @@ struct _Plugin
 	kdbErrorPtr kdbError; /*!< The pointer to kdbError_template() of the backend. */
 	kdbCommitPtr kdbCommit; /*!< The pointer to kdbCommit_template() of the backend. */
 
+	kdbContractPtr kdbContract; /*!< Optional function returning the plugin's contract keyset
+	 without instantiating the plugin. @see elektraPluginGetContract() */
+
 	const char * name; /*!< The name of the module responsible for that plugin. */
 
 	size_t refcounter; /*!< This refcounter shows how often the plugin
@@ -435,6 +623,12 @@ struct _Plugin
 	KeySet * global; /*!< This keyset can be used by plugins to pass data through
 			the KDB and communicate with other plugins. Plugins shall clean
 			up their parts of the global keyset, which they do not need any more.*/
+
+	KeySet * memo; /*!< The cached kdbGet result of a plugin whose contract declares
+	 infos/memoize. @see elektraPluginMemoGet() */
+
+	short memoization; /*!< Whether the plugin declared infos/memoize in its contract.
+	 0: not yet queried, 1: no memoization, 2: data is static per process */
 };
 
 
@@ -447,6 +641,24 @@ struct _Plugin
  * in a hierarchy where backends are mounted - you need the backend mounted
  * closest to the parentKey.
  */
+/**
+ * One node of the flattened trie built by trieFinalize().
+ *
+ * The nodes are laid out in BFS order, so all children of one node are
+ * stored next to each other and sorted by the first character of their
+ * text. A lookup therefore only scans one small contiguous range per
+ * level instead of chasing pointers through KDB_MAX_UCHAR-sized nodes.
+ */
+typedef struct _TrieFlatNode
+{
+	size_t textOffset;    /*!< Start of the text inside Trie::flatText */
+	size_t textLen;	      /*!< Length of the text */
+	size_t firstChild;    /*!< Index of the first child node */
+	size_t childCount;    /*!< Number of children, contiguous because of the BFS layout */
+	Backend * value;      /*!< Pointer to a backend mounted at the end of this text */
+	Backend * emptyValue; /*!< Fallback backend of the node this text leads to */
+} TrieFlatNode;
+
 struct _Trie
 {
 	struct _Trie * children[KDB_MAX_UCHAR]; /*!< The children building up the trie recursively */
@@ -454,6 +666,8 @@ struct _Trie
 	size_t textlen[KDB_MAX_UCHAR];		/*!< Length of the text */
 	Backend * value[KDB_MAX_UCHAR];		/*!< Pointer to a backend */
 	Backend * empty_value;			/*!< Pointer to a backend for the empty string "" */
+	TrieFlatNode * flat;			/*!< Flattened copy used by lookups, only set on the root, see trieFinalize() */
+	char * flatText;			/*!< Texts of all flat nodes in one allocation */
 };
 
 typedef enum {
@@ -530,11 +744,15 @@ Backend * backendOpenModules (KeySet * modules, KeySet * global, Key * errorKey)
 Backend * backendOpenVersion (KeySet * global, Key * errorKey);
 int backendClose (Backend * backend, Key * errorKey);
 
+void backendUpdateChains (Backend * backend);
 int backendUpdateSize (Backend * backend, Key * parent, int size);
+ssize_t backendGetSize (Backend * backend, Key * parent);
 
 /*Plugin handling*/
 Plugin * elektraPluginOpen (const char * backendname, KeySet * modules, KeySet * config, Key * errorKey);
 int elektraPluginClose (Plugin * handle, Key * errorKey);
+int elektraPluginMemoGet (Plugin * plugin, KeySet * returned, Key * parentKey);
+KeySet * elektraPluginGetContract (const char * pluginName, KeySet * modules, Key * errorKey);
 int elektraProcessPlugin (Key * cur, int * pluginNumber, char ** pluginName, char ** referenceName, Key * errorKey);
 int elektraProcessPlugins (Plugin ** plugins, KeySet * modules, KeySet * referencePlugins, KeySet * config, KeySet * systemConfig,
 			   KeySet * global, Key * errorKey);
@@ -546,8 +764,9 @@ Plugin * elektraPluginVersion (void);
 
 /*Trie handling*/
 int trieClose (Trie * trie, Key * errorKey);
-Backend * trieLookup (Trie * trie, const char * name);
+Backend * trieLookup (const Trie * trie, const char * name);
 Trie * trieInsert (Trie * trie, const char * name, Backend * value);
+void trieFinalize (Trie * trie);
 
 /*Mounting handling */
 int mountOpen (KDB * kdb, KeySet * config, KeySet * modules, Key * errorKey);
@@ -562,20 +781,54 @@ Backend * mountGetBackend (KDB * handle, const char * where);
 
 void keyInit (Key * key);
 
+void keyUpdateNamePrefix (Key * key);
+
 int keyClearSync (Key * key);
 
+KeySet * keyMetaShare (KeySet * meta);
+void keyMetaRelease (KeySet * meta);
+int keyMetaDetach (Key * key);
+
 int keyReplacePrefix (Key * key, const Key * oldPrefix, const Key * newPrefix);
 
 /*Private helper for keyset*/
 int ksInit (KeySet * ks);
 int ksClose (KeySet * ks);
 
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+int ksLookupStatsEnable (KeySet * ks);
+const struct _KsLookupStats * ksLookupStats (const KeySet * ks);
+int ksPinLookupStrategy (KeySet * ks, elektraLookupFlags strategy);
+
+/**
+ * Opaque memo of one ksLookupCached() result.
+ * Zero-initialize before first use, treat as invalidated whenever it is
+ * used with a different KeySet.
+ */
+typedef struct
+{
+	size_t generation; /*!< generation of the KeySet plus one when the memo was recorded, 0 while empty */
+	size_t position;   /*!< position of the found Key at that generation */
+} ElektraLookupHint;
+
+Key * ksLookupCached (KeySet * ks, Key * key, elektraLookupFlags options, ElektraLookupHint * hint);
+#endif
+
+#ifdef ELEKTRA_MALLOC_TRACE
+ssize_t elektraMallocStats (KeySet * ks);
+#endif
+
 int ksResize (KeySet * ks, size_t size);
 size_t ksGetAlloc (const KeySet * ks);
 KeySet * ksDeepDup (const KeySet * source);
 
 Key * elektraKsPopAtCursor (KeySet * ks, elektraCursor pos);
 
+ssize_t ksRemoveIf (KeySet * ks, int (*predicate) (Key * key, void * argument), void * argument);
+ssize_t ksRetainRange (KeySet * ks, elektraCursor start, elektraCursor end);
+
+ssize_t elektraKsSerialize (KeySet * ks, elektraCursor start, elektraCursor end, void * buffer, size_t size);
+
 ssize_t ksSearchInternal (const KeySet * ks, const Key * toAppend);
 
 /*Used for internal memcpy/memmove*/
@@ -591,6 +844,35 @@ KeySet * ksRenameKeys (KeySet * config, const char * name);
 ssize_t ksRename (KeySet * ks, const Key * root, const Key * newRoot);
 
 elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCursor * end);
+elektraCursor ksFindNextChild (const KeySet * ks, const Key * root, elektraCursor pos);
+
+ssize_t ksFindByMeta (KeySet * ks, const char * metaName, elektraCursor startPos);
+void ksMetaIndexInvalidate (KeySet * ks);
+
+KeySet * ksNewWithArena (size_t slabSize);
+Key * ksArenaKeyNew (KeySet * ks, const char * name, const char * value);
+
+KeySet * ksCowDup (const KeySet * source);
+Key * ksLookupReadOnly (const KeySet * ks, const Key * key);
+
+ssize_t ksAppendBatch (KeySet * ks, Key ** keys, size_t n);
+
+typedef int (*ElektraGetStreamCallback) (KeySet * chunk, Key * chunkParent, void * context);
+int kdbGetStream (KDB * handle, Key * parentKey, ElektraGetStreamCallback callback, void * context);
+
+int kdbGetMulti (KDB * handle, Key ** parents, size_t n, KeySet ** results);
+
+typedef struct _KdbSnapshot KdbSnapshot;
+KdbSnapshot * kdbSnapshot (KDB * handle, Key * parentKey);
+KeySet * kdbSnapshotAcquire (KdbSnapshot * snapshot);
+void kdbSnapshotRelease (KdbSnapshot * snapshot, KeySet * view);
+unsigned int kdbSnapshotGeneration (KdbSnapshot * snapshot);
+int kdbSnapshotRefresh (KdbSnapshot * snapshot, KDB * handle, Key * parentKey);
+void kdbSnapshotDel (KdbSnapshot * snapshot);
+
+KeySet * kdbJournalRead (KDB * handle, const Key * mountpoint, kdb_unsigned_long_long_t since, kdb_unsigned_long_long_t * lastSeq);
+
+int kdbFlush (KDB * handle, Key * parentKey);
 
 
 /* Conveniences Methods for Making Tests */
@@ -612,6 +894,8 @@ size_t elektraKeyNameEscapePart (const char * part, char ** escapedPart);
 int elektraGlobalGet (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition);
 int elektraGlobalSet (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition);
 int elektraGlobalError (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition);
+void elektraGlobalMaskUpdate (KDB * handle);
+uint64_t elektraGlobalGetCalls (KDB * handle);
 
 /** Test a bit. @see set_bit(), clear_bit() */
 #define test_bit(var, bit) (((unsigned long long) (var)) & ((unsigned long long) (bit)))
@@ -620,6 +904,18 @@ int elektraGlobalError (KDB * handle, KeySet * ks, Key * parentKey, int position
 /** Clear a bit. @see set_bit() */
 #define clear_bit(var, bit) ((var) &= ~((unsigned long long) (bit)))
 
+/**
+ * @internal
+ *
+ * Returns a pointer to the value of a Key, regardless of whether it is
+ * stored inline in the struct (see #KEY_FLAG_SMALL_DATA) or on the heap.
+ * Never free the returned pointer; it may point into the struct.
+ */
+static inline void * keyDataPtr (const struct _Key * key)
+{
+	return test_bit (key->flags, KEY_FLAG_SMALL_DATA) ? (void *) key->data.small : key->data.v;
+}
+
 #ifdef __cplusplus
 }
 }
@@ -627,9 +923,47 @@ int elektraGlobalError (KDB * handle, KeySet * ks, Key * parentKey, int position
 #define KDB ckdb::KDB
 #define Key ckdb::Key
 #define KeySet ckdb::KeySet
+#define ElektraLookupHint ckdb::ElektraLookupHint
 extern "C" {
 #endif
 
+/** Number of slots in the find cache of an Elektra instance. Must be a power of 2. */
+#define ELEKTRA_FIND_CACHE_SIZE 64
+
+/**
+ * Memoized result of elektraFindKey().
+ * A slot is only valid while its @c generation matches the @c configGeneration
+ * of the owning Elektra instance.
+ */
+struct _ElektraFindCacheSlot
+{
+	char * name; /*!< relative name of the found key (owned); NULL if the slot is empty */
+	size_t generation; /*!< value of configGeneration when the slot was filled */
+	elektraCursor index; /*!< position of the found key in the config KeySet */
+	ElektraLookupHint hint; /*!< core lookup memo, revalidates the position with one
+		name compare when configGeneration changed without a structural
+		modification of the config KeySet */
+	KDBType valueType; /*!< type of the memoized native value; NULL if no value is memoized */
+	union
+	{
+		const char * stringValue;
+		kdb_boolean_t booleanValue;
+		kdb_char_t charValue;
+		kdb_octet_t octetValue;
+		kdb_short_t shortValue;
+		kdb_unsigned_short_t unsignedShortValue;
+		kdb_long_t longValue;
+		kdb_unsigned_long_t unsignedLongValue;
+		kdb_long_long_t longLongValue;
+		kdb_unsigned_long_long_t unsignedLongLongValue;
+		kdb_float_t floatValue;
+		kdb_double_t doubleValue;
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+		kdb_long_double_t longDoubleValue;
+#endif
+	} value; /*!< native value converted from the key's string value */
+};
+
 struct _Elektra
 {
 	KDB * kdb;
@@ -640,6 +974,8 @@ struct _Elektra
 	ElektraErrorHandler fatalErrorHandler;
 	char * resolvedReference;
 	size_t parentKeyLength;
+	size_t configGeneration;
+	struct _ElektraFindCacheSlot findCache[ELEKTRA_FIND_CACHE_SIZE];
 };
 
 struct _ElektraError
@@ -676,6 +1012,7 @@ ElektraError * elektraErrorMinimalValidationFailed (const char * function);
 #undef Key
 #undef KeySet
 #undef KDB
+#undef ElektraLookupHint
 #endif
 
 #endif /* KDBPRIVATE_H */
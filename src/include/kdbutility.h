@@ -1,6 +1,8 @@
 #ifndef KDBUTILITY_H
 #define KDBUTILITY_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 namespace ckdb
 {
@@ -12,6 +14,18 @@ char * elektraLskip (char const * const keyname);
 char * elektraRstrip (char * const start, char ** end);
 char * elektraStrip (char * text);
 
+/* Line-oriented file scanning */
+typedef struct
+{
+	char * buffer; /*!< contents of the whole file, lines are terminated in place */
+	size_t size;   /*!< number of bytes in the buffer */
+	size_t offset; /*!< current position of the scanner */
+} ElektraLineScanner;
+
+int elektraLineScannerOpen (ElektraLineScanner * scanner, const char * filename);
+char * elektraLineScannerNext (ElektraLineScanner * scanner, size_t * length);
+void elektraLineScannerClose (ElektraLineScanner * scanner);
+
 #ifdef __cplusplus
 }
 }
@@ -0,0 +1,20 @@
+#ifndef ELEKTRA_KDBWIRE_H
+#define ELEKTRA_KDBWIRE_H
+
+#include <kdb.h>
+
+#ifdef __cplusplus
+namespace ckdb
+{
+extern "C" {
+#endif
+
+ssize_t elektraWireEncode (KeySet * ks, const Key * parentKey, void ** buffer, size_t * bufferSize);
+KeySet * elektraWireDecode (const void * buffer, size_t size, const Key * parentKey);
+
+#ifdef __cplusplus
+}
+}
+#endif
+
+#endif // ELEKTRA_KDBWIRE_H
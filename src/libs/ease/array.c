@@ -11,11 +11,13 @@
 #include <kdb.h>
 #include <kdbease.h>
 #include <kdbhelper.h>
+#include <kdbprivate.h> // ksSearchInternal()
 #include <kdbtypes.h>
 
 #include <ctype.h>
 #include <errno.h>
 #include <limits.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -90,33 +92,21 @@ int elektraArrayValidateBaseNameString (const char * baseName)
 
 int elektraReadArrayNumber (const char * baseName, kdb_long_long_t * oldIndex)
 {
+	// the array syntax only allows plain digits here, so the index is
+	// accumulated directly instead of paying for sscanf() on every call
+	const char * current = baseName;
+	if (!isdigit ((unsigned char) *current)) return -1;
 
-	int errnosave = errno;
-	errno = 0;
-	if (sscanf (baseName, ELEKTRA_LONG_LONG_F, oldIndex) != 1)
-	{
-		errno = errnosave;
-		return -1;
-	}
-
-	if (errno != 0) // any error
-	{
-		errno = errnosave;
-		return -1;
-	}
-
-	if (*oldIndex < 0) // underflow
+	kdb_long_long_t index = 0;
+	while (isdigit ((unsigned char) *current))
 	{
-		return -1;
+		int digit = *current - '0';
+		if (index > (INT64_MAX - digit) / 10) return -1; // overflow
+		index = index * 10 + digit;
+		++current;
 	}
 
-	/*
-	overflow not possible, cannot be larger than largest number
-	if (*oldIndex >= INT64_MAX) // overflow
-	{
-		return -1;
-	}
-	*/
+	*oldIndex = index;
 	return 0;
 }
 
@@ -283,3 +273,101 @@ Key * elektraArrayGetNextKey (KeySet * arrayKeys)
 
 	return newKey;
 }
+
+/**
+ * @brief Return the array keys with an index in [start, end) as a slice
+ *
+ * The slice is located with a binary search for the first requested
+ * element instead of filtering the whole keyset, and the returned keyset
+ * shares the keys with @p keys instead of copying them. Subkeys of the
+ * array elements (e.g. `user:/config/#1/key`) are not included.
+ *
+ * The caller must `ksDel` the resulting keyset.
+ *
+ * @param arrayParent the parent of the array, see elektraArrayGet()
+ * @param keys the keyset containing the array keys
+ * @param start the first array index of the slice
+ * @param end the first array index after the slice
+ *
+ * @return a keyset containing the array keys with an index in [start, end)
+ * @retval NULL on `NULL` pointers or if `start` is negative or larger than `end`
+ */
+KeySet * elektraArrayGetRange (const Key * arrayParent, KeySet * keys, kdb_long_long_t start, kdb_long_long_t end)
+{
+	if (!arrayParent) return 0;
+
+	if (!keys) return 0;
+
+	if (start < 0 || end < start) return 0;
+
+	KeySet * range = ksNew ((size_t) (end - start), KS_END);
+	if (start == end) return range;
+
+	char elementName[ELEKTRA_MAX_ARRAY_SIZE];
+	elektraWriteArrayNumber (elementName, start);
+	Key * startKey = keyDup (arrayParent, KEY_CP_NAME);
+	keyAddBaseName (startKey, elementName);
+
+	// a negative result is the position where the first element would be inserted
+	elektraCursor cursor = ksSearchInternal (keys, startKey);
+	if (cursor < 0) cursor = -cursor - 1;
+	keyDel (startKey);
+
+	for (; cursor < ksGetSize (keys); ++cursor)
+	{
+		Key * current = ksAtCursor (keys, cursor);
+		if (!keyIsBelow (arrayParent, current)) break;
+		if (!keyIsDirectlyBelow (arrayParent, current)) continue; // skip subkeys of the elements
+
+		const char * baseName = keyBaseName (current);
+		int offsetIndex = elektraArrayValidateBaseNameString (baseName);
+		if (offsetIndex < 1) break;
+
+		kdb_long_long_t index = 0;
+		if (elektraReadArrayNumber (baseName + offsetIndex, &index) == -1) break;
+		if (index >= end) break;
+
+		ksAppendKey (range, current);
+	}
+
+	return range;
+}
+
+/**
+ * @brief Append the next key to the given array.
+ *
+ * Works like elektraArrayGetNextKey(), but appends the new key to
+ * @p arrayKeys right away. The index of the new key is derived from the
+ * last element of the sorted keyset, so no other element is inspected.
+ *
+ * The returned key is owned by the keyset, so the caller must not
+ * `keyDel` it.
+ *
+ * @pre The supplied keyset must contain only valid array keys.
+ *
+ * @param arrayKeys the array the new key will be appended to
+ *
+ * @return the new array key on success
+ * @retval NULL if the passed array is empty
+ * @retval NULL on NULL pointers or if an error occurs
+ */
+Key * elektraArrayAppendNextKey (KeySet * arrayKeys)
+{
+	if (!arrayKeys) return 0;
+
+	Key * last = ksAtCursor (arrayKeys, ksGetSize (arrayKeys) - 1);
+
+	if (!last) return 0;
+
+	Key * newKey = keyDup (last, KEY_CP_NAME);
+	int ret = elektraArrayIncName (newKey);
+
+	if (ret == -1)
+	{
+		keyDel (newKey);
+		return 0;
+	}
+
+	ksAppendKey (arrayKeys, newKey);
+	return newKey;
+}
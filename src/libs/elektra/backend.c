@@ -56,6 +56,29 @@ static Backend * elektraBackendAllocate (void)
 }
 
 
+/**
+ * @brief Pre-resolve the plugin chains of a backend.
+ *
+ * Compacts all getplugins after the resolver that actually implement
+ * kdbGet into getChain, so that the hot path of kdbGet() dispatches
+ * through a flat table instead of probing all NR_OF_PLUGINS positions
+ * on every call. Must be called (again) whenever the plugin arrays of
+ * @p backend change.
+ *
+ * @param backend the backend whose chains should be updated
+ */
+void backendUpdateChains (Backend * backend)
+{
+	backend->getChainSize = 0;
+	for (size_t p = 1; p < NR_OF_PLUGINS; ++p)
+	{
+		if (backend->getplugins[p] && backend->getplugins[p]->kdbGet)
+		{
+			backend->getChain[backend->getChainSize++] = backend->getplugins[p];
+		}
+	}
+}
+
 /**
  * @brief sets mountpoint
  *
@@ -127,6 +150,8 @@ static Backend * backendOpenMissing (KeySet * global, Key * mp)
 	backend->mountpoint = mp;
 	keyIncRef (backend->mountpoint);
 
+	backendUpdateChains (backend);
+
 	return backend;
 }
 
@@ -257,6 +282,8 @@ Backend * backendOpen (KeySet * elektraConfig, KeySet * modules, KeySet * global
 	ksDel (elektraConfig);
 	ksDel (referencePlugins);
 
+	backendUpdateChains (backend);
+
 	return backend;
 }
 
@@ -325,6 +352,8 @@ Backend * backendOpenDefault (KeySet * modules, KeySet * global, const char * fi
 	storage->refcounter = 2;
 
 	backend->mountpoint = NULL;
+
+	backendUpdateChains (backend);
 	return backend;
 }
 
@@ -371,6 +400,8 @@ Backend * backendOpenModules (KeySet * modules, KeySet * global, Key * errorKey)
 
 	ksSetCursor (modules, save);
 
+	backendUpdateChains (backend);
+
 	return backend;
 }
 
@@ -403,6 +434,8 @@ Backend * backendOpenVersion (KeySet * global, Key * errorKey ELEKTRA_UNUSED)
 	backend->mountpoint = mp;
 	keyIncRef (backend->mountpoint);
 
+	backendUpdateChains (backend);
+
 	return backend;
 }
 
@@ -452,6 +485,37 @@ int backendUpdateSize (Backend * backend, Key * parent, int size)
 	return 0;
 }
 
+/**
+ * @brief Get the stored size for the namespace of @p parent
+ *
+ * @param backend the backend to ask
+ * @param parent for parent
+ *
+ * @return the number of keys of the last update
+ * @retval -1 if no size was stored yet or the parent is invalid
+ */
+ssize_t backendGetSize (Backend * backend, Key * parent)
+{
+	switch (keyGetNamespace (parent))
+	{
+	case KEY_NS_SPEC:
+		return backend->specsize;
+	case KEY_NS_DIR:
+		return backend->dirsize;
+	case KEY_NS_USER:
+		return backend->usersize;
+	case KEY_NS_SYSTEM:
+		return backend->systemsize;
+	case KEY_NS_PROC:
+	case KEY_NS_META:
+	case KEY_NS_CASCADING:
+	case KEY_NS_NONE:
+	case KEY_NS_DEFAULT:
+		break;
+	}
+	return -1;
+}
+
 int backendClose (Backend * backend, Key * errorKey)
 {
 	int errorOccurred = 0;
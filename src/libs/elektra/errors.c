@@ -8,6 +8,7 @@
 
 #include <kdberrors.h>
 
+#include <stdio.h>
 #include <string.h>
 
 #ifdef __cplusplus
@@ -33,6 +34,41 @@ using namespace ckdb;
 #define ELEKTRA_ERROR_CODE_VALIDATION_SEMANTIC "C03200"
 #define ELEKTRA_ERROR_CODE_VALIDATION_SEMANTIC_NAME "Validation Semantic"
 
+/**
+ * Sets the reason metakey from a format string.
+ *
+ * The reason cannot be formatted lazily, because the arguments (e.g. results
+ * of keyName() or strerror()) need not outlive the emitting stack frame and
+ * the metadata is read directly by arbitrary consumers. Instead the common
+ * cases avoid the heap: plain messages without conversion specifiers are set
+ * directly and short formatted messages stay in a stack buffer.
+ */
+static void setReasonMeta (Key * key, const char * metaName, const char * reasonFmt, va_list va)
+{
+	if (strchr (reasonFmt, '%') == NULL)
+	{
+		// no conversion specifiers -> the format string already is the reason
+		keySetMeta (key, metaName, reasonFmt);
+		return;
+	}
+
+	va_list copy;
+	va_copy (copy, va);
+	char buffer[256];
+	int written = vsnprintf (buffer, sizeof (buffer), reasonFmt, copy);
+	va_end (copy);
+
+	if (written >= 0 && (size_t) written < sizeof (buffer))
+	{
+		keySetMeta (key, metaName, buffer);
+		return;
+	}
+
+	char * reason = elektraVFormat (reasonFmt, va);
+	keySetMeta (key, metaName, reason);
+	elektraFree (reason);
+}
+
 static void addWarning (Key * key, const char * code, const char * name, const char * file, const char * line, const char * module,
 			const char * reasonFmt, va_list va)
 {
@@ -81,9 +117,7 @@ static void addWarning (Key * key, const char * code, const char * name, const c
 	strcpy (end, "/configfile");
 	keySetMeta (key, buffer, keyString (key));
 	strcpy (end, "/reason");
-	char * reason = elektraVFormat (reasonFmt, va);
-	keySetMeta (key, buffer, reason);
-	elektraFree (reason);
+	setReasonMeta (key, buffer, reasonFmt, va);
 }
 
 static void setError (Key * key, const char * code, const char * name, const char * file, const char * line, const char * module,
@@ -108,9 +142,7 @@ static void setError (Key * key, const char * code, const char * name, const cha
 		keySetMeta (key, "error/line", line);
 		keySetMeta (key, "error/mountpoint", keyName (key));
 		keySetMeta (key, "error/configfile", keyString (key));
-		char * reason = elektraVFormat (reasonFmt, va);
-		keySetMeta (key, "error/reason", reason);
-		elektraFree (reason);
+		setReasonMeta (key, "error/reason", reasonFmt, va);
 	}
 }
 
@@ -14,12 +14,58 @@
  * Helper functions to execute global plugins
  */
 
+/**
+ * @internal
+ *
+ * Recomputes the bitmask of occupied global plugin positions.
+ *
+ * Must be called whenever the globalPlugins table of @p handle changed
+ * (currently only mountGlobals() modifies it). The dispatch helpers
+ * below use the mask to skip unoccupied positions with a single branch
+ * instead of probing the table on every phase of kdbGet() and kdbSet().
+ *
+ * @param handle the KDB handle whose mask should be updated
+ */
+void elektraGlobalMaskUpdate (KDB * handle)
+{
+	uint32_t mask = 0;
+	for (int position = 0; position < NR_GLOBAL_POSITIONS; ++position)
+	{
+		for (int subPosition = 0; subPosition < NR_GLOBAL_SUBPOSITIONS; ++subPosition)
+		{
+			if (handle->globalPlugins[position][subPosition] != NULL)
+			{
+				mask |= 1u << position;
+				break;
+			}
+		}
+	}
+	handle->globalPluginMask = mask;
+}
+
+/**
+ * @internal
+ *
+ * Returns the number of global plugin invocations made through the
+ * dispatch helpers since the handle was opened.
+ *
+ * Useful for benchmarks that want to see what a global plugin stack
+ * costs for a given workload.
+ *
+ * @param handle the KDB handle to query
+ */
+uint64_t elektraGlobalGetCalls (KDB * handle)
+{
+	return handle == NULL ? 0 : handle->globalPluginCalls;
+}
+
 int elektraGlobalGet (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition)
 {
 	int ret = 0;
 	Plugin * plugin;
-	if (handle && (plugin = handle->globalPlugins[position][subPosition]))
+	if (handle && (handle->globalPluginMask & (1u << position)) && (plugin = handle->globalPlugins[position][subPosition]))
 	{
+		++handle->globalPluginCalls;
 		ret = plugin->kdbGet (plugin, ks, parentKey);
 	}
 	return ret;
@@ -29,8 +75,9 @@ int elektraGlobalSet (KDB * handle, KeySet * ks, Key * parentKey, int position,
 {
 	int ret = 0;
 	Plugin * plugin;
-	if (handle && (plugin = handle->globalPlugins[position][subPosition]))
+	if (handle && (handle->globalPluginMask & (1u << position)) && (plugin = handle->globalPlugins[position][subPosition]))
 	{
+		++handle->globalPluginCalls;
 		ret = plugin->kdbSet (plugin, ks, parentKey);
 	}
 	return ret;
@@ -40,8 +87,9 @@ int elektraGlobalError (KDB * handle, KeySet * ks, Key * parentKey, int position
 {
 	int ret = 0;
 	Plugin * plugin;
-	if (handle && (plugin = handle->globalPlugins[position][subPosition]))
+	if (handle && (handle->globalPluginMask & (1u << position)) && (plugin = handle->globalPlugins[position][subPosition]))
 	{
+		++handle->globalPluginCalls;
 		ret = plugin->kdbError (plugin, ks, parentKey);
 	}
 	return ret;
@@ -43,6 +43,22 @@
 #include "kdbinternal.h"
 #include <kdbassert.h>
 
+#ifdef ELEKTRA_MALLOC_TRACE
+#include <malloc.h> // malloc_usable_size()
+#include <stdint.h> // uintptr_t
+#ifdef ELEKTRA_HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+/* kdbhelper.h redirects the allocation functions to their tagged variants
+ * when ELEKTRA_MALLOC_TRACE is active. This file defines the real functions. */
+#undef elektraMalloc
+#undef elektraCalloc
+#undef elektraRealloc
+#undef elektraStrDup
+#undef elektraMemDup
+#endif
+
 /**
  * @brief Internal Methods for Elektra
  *
@@ -194,11 +210,42 @@ int elektraStrNCaseCmp (const char * s1, const char * s2, size_t n)
  * @retval 0 if s1 matches s2
  * @return a positive number if s1 is greater than s2
  */
+/**
+ * @internal
+ * Uppercases the bytes 'a'..'z' of a word in parallel.
+ * All bytes must be ASCII (high bit clear).
+ */
+static uint64_t upperCaseWord (uint64_t w)
+{
+	const uint64_t ones = 0x0101010101010101ULL;
+	const uint64_t high = 0x8080808080808080ULL;
+	uint64_t geA = (w + (0x80 - 'a') * ones) & high;  // high bit set where byte >= 'a'
+	uint64_t gtZ = (w + (0x7F - 'z') * ones) & high;  // high bit set where byte > 'z'
+	uint64_t isLower = geA & ~gtZ;
+	return w ^ (isLower >> 2); // clears/sets bit 0x20 on the lowercase bytes
+}
+
 int elektraMemCaseCmp (const char * s1, const char * s2, size_t size)
 {
-	size_t i;
+	size_t i = 0;
 	ELEKTRA_ASSERT (s1 != NULL && s2 != NULL, "Got null pointer s1: %p s2: %p", (void *) s1, (void *) s2);
-	for (i = 0; i < size; i++)
+
+	/* Word-at-a-time fast path: uppercase and compare 8 bytes per step.
+	 * The bit tricks only work for ASCII, so words containing bytes with
+	 * the high bit set are deferred to the bytewise toupper() loop below,
+	 * which also resolves the first differing byte of an unequal word. */
+	while (i + sizeof (uint64_t) <= size)
+	{
+		uint64_t w1;
+		uint64_t w2;
+		memcpy (&w1, s1 + i, sizeof (w1));
+		memcpy (&w2, s2 + i, sizeof (w2));
+		if (((w1 | w2) & 0x8080808080808080ULL) != 0) break;
+		if (upperCaseWord (w1) != upperCaseWord (w2)) break;
+		i += sizeof (uint64_t);
+	}
+
+	for (; i < size; i++)
 	{
 		const unsigned char cmp1 = s1[i];
 		const unsigned char cmp2 = s2[i];
@@ -210,6 +257,285 @@ int elektraMemCaseCmp (const char * s1, const char * s2, size_t size)
 	return 0;
 }
 
+#ifdef ELEKTRA_MALLOC_TRACE
+
+/**
+ * @defgroup malloctrace Allocation tracing
+ *
+ * With the cmake option `ENABLE_MALLOC_TRACE` every allocation done through
+ * elektraMalloc(), elektraCalloc(), elektraRealloc(), elektraStrDup() and
+ * elektraMemDup() is recorded per call site. kdbhelper.h redirects those
+ * functions to tagged variants carrying `__FILE__` and `__LINE__`, so the
+ * recorded statistics attribute memory to the subsystem that requested it
+ * (e.g. keyname.c vs. keyvalue.c vs. keymeta.c). Code compiled without the
+ * redirection (external callers) is still accounted, but under the site
+ * "untagged".
+ *
+ * Live bytes are tracked with malloc_usable_size(), which makes elektraFree()
+ * work without a size argument but requires glibc. elektraMallocStats() dumps
+ * the counters as keys below `system:/elektra/memstats`.
+ */
+
+/** an upper bound for distinct call sites; sites beyond it are counted as dropped */
+#define ELEKTRA_MALLOC_TRACE_SITES (512)
+
+/** site used for allocations done without the kdbhelper.h redirection */
+#define ELEKTRA_MALLOC_TRACE_UNTAGGED "untagged"
+
+typedef struct
+{
+	const char * file; /*!< string literal passed by the call site, identity is by pointer */
+	int line;	   /*!< line number of the call site */
+	size_t allocations; /*!< allocation events at this site */
+	size_t bytes;	    /*!< usable bytes requested at this site, realloc counts growth only */
+} MallocTraceSite;
+
+static MallocTraceSite mallocTraceSites[ELEKTRA_MALLOC_TRACE_SITES];
+static size_t mallocTraceDropped;     /*!< allocations whose site did not fit the table */
+static size_t mallocTraceLive;	      /*!< usable bytes currently allocated */
+static size_t mallocTraceHighwater;   /*!< maximum of mallocTraceLive ever seen */
+static size_t mallocTraceAllocations; /*!< allocation events over all sites */
+static size_t mallocTraceBytes;	      /*!< usable bytes requested over all sites */
+
+#ifdef ELEKTRA_HAVE_PTHREAD
+static pthread_mutex_t mallocTraceLock = PTHREAD_MUTEX_INITIALIZER;
+#define MALLOC_TRACE_LOCK() pthread_mutex_lock (&mallocTraceLock)
+#define MALLOC_TRACE_UNLOCK() pthread_mutex_unlock (&mallocTraceLock)
+#else
+#define MALLOC_TRACE_LOCK()
+#define MALLOC_TRACE_UNLOCK()
+#endif
+
+/**
+ * @internal
+ *
+ * @brief Records one allocation event.
+ *
+ * @param file call site file, a string literal
+ * @param line call site line
+ * @param newBytes usable size of the new allocation
+ * @param oldBytes usable size of the allocation it replaced (realloc), 0 otherwise
+ */
+static void mallocTraceAccount (const char * file, int line, size_t newBytes, size_t oldBytes)
+{
+	size_t growth = newBytes > oldBytes ? newBytes - oldBytes : 0;
+
+	MALLOC_TRACE_LOCK ();
+	size_t index = (((uintptr_t) file >> 4) + (size_t) line) % ELEKTRA_MALLOC_TRACE_SITES;
+	size_t probed = 0;
+	while (probed < ELEKTRA_MALLOC_TRACE_SITES)
+	{
+		MallocTraceSite * site = &mallocTraceSites[index];
+		if (site->file == 0)
+		{
+			site->file = file;
+			site->line = line;
+		}
+		if (site->file == file && site->line == line)
+		{
+			++site->allocations;
+			site->bytes += growth;
+			break;
+		}
+		index = (index + 1) % ELEKTRA_MALLOC_TRACE_SITES;
+		++probed;
+	}
+	if (probed == ELEKTRA_MALLOC_TRACE_SITES) ++mallocTraceDropped;
+
+	++mallocTraceAllocations;
+	mallocTraceBytes += growth;
+	mallocTraceLive += newBytes;
+	mallocTraceLive -= oldBytes > mallocTraceLive ? mallocTraceLive : oldBytes;
+	if (mallocTraceLive > mallocTraceHighwater) mallocTraceHighwater = mallocTraceLive;
+	MALLOC_TRACE_UNLOCK ();
+}
+
+/**
+ * @internal
+ *
+ * @brief Removes a freed allocation from the live byte counter.
+ *
+ * @param bytes the usable size of the freed allocation
+ */
+static void mallocTraceRelease (size_t bytes)
+{
+	MALLOC_TRACE_LOCK ();
+	mallocTraceLive -= bytes > mallocTraceLive ? mallocTraceLive : bytes;
+	MALLOC_TRACE_UNLOCK ();
+}
+
+/**
+ * @brief Tagged variant of elektraMalloc(), used via the kdbhelper.h redirection.
+ *
+ * @param size the requested size
+ * @param file call site file, must outlive the allocation (a string literal)
+ * @param line call site line
+ *
+ * @see elektraMalloc
+ * @ingroup malloctrace
+ */
+void * elektraMallocTrace (size_t size, const char * file, int line)
+{
+	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
+	void * ret = malloc (size);
+	ELEKTRA_ASSERT (ret, "Memory allocation failed with size %zu", size);
+	if (ret) mallocTraceAccount (file, line, malloc_usable_size (ret), 0);
+	return ret;
+}
+
+/**
+ * @brief Tagged variant of elektraCalloc(), used via the kdbhelper.h redirection.
+ *
+ * @see elektraMallocTrace
+ * @ingroup malloctrace
+ */
+void * elektraCallocTrace (size_t size, const char * file, int line)
+{
+	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
+	void * ret = calloc (1, size);
+	ELEKTRA_ASSERT (ret, "Memory allocation failed with size %zu", size);
+	if (ret) mallocTraceAccount (file, line, malloc_usable_size (ret), 0);
+	return ret;
+}
+
+/**
+ * @brief Tagged variant of elektraRealloc(), used via the kdbhelper.h redirection.
+ *
+ * Only the growth of the buffer is added to the per-site byte counter, so
+ * a buffer that grows by doubling is not counted once per doubling step.
+ *
+ * @see elektraRealloc
+ * @ingroup malloctrace
+ */
+int elektraReallocTrace (void ** buffer, size_t size, const char * file, int line)
+{
+	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
+	void * ptr;
+	void * svr = *buffer;
+	size_t oldSize = *buffer ? malloc_usable_size (*buffer) : 0;
+
+	ptr = realloc (*buffer, size);
+	ELEKTRA_ASSERT (ptr, "Memory (re)allocation failed with size %zu", size);
+	if (ptr == NULL)
+	{
+		*buffer = svr; /* restore old buffer*/
+		return -1;
+	}
+
+	*buffer = ptr;
+	mallocTraceAccount (file, line, malloc_usable_size (ptr), oldSize);
+	return 0;
+}
+
+/**
+ * @brief Tagged variant of elektraStrDup(), used via the kdbhelper.h redirection.
+ *
+ * @see elektraStrDup
+ * @ingroup malloctrace
+ */
+char * elektraStrDupTrace (const char * s, const char * file, int line)
+{
+	ELEKTRA_ASSERT (s, "Tried to duplicate null pointer");
+
+	size_t l = elektraStrLen (s);
+	ELEKTRA_ASSERT (l, "Size of string to duplicate is zero");
+	char * tmp = elektraMallocTrace (l, file, line);
+	if (tmp) memcpy (tmp, s, l);
+
+	return tmp;
+}
+
+/**
+ * @brief Tagged variant of elektraMemDup(), used via the kdbhelper.h redirection.
+ *
+ * @see elektraMemDup
+ * @ingroup malloctrace
+ */
+void * elektraMemDupTrace (const void * s, size_t n, const char * file, int line)
+{
+	ELEKTRA_ASSERT (n, "Size of memory to duplicate is zero");
+
+	void * tmp = elektraMallocTrace (n, file, line);
+	if (tmp) memcpy (tmp, s, n);
+
+	return tmp;
+}
+
+/**
+ * @brief Dumps the allocation statistics as keys below `system:/elektra/memstats`.
+ *
+ * The totals are stored directly below the prefix:
+ * - `system:/elektra/memstats/allocations` allocation events over all sites
+ * - `system:/elektra/memstats/bytes` usable bytes requested over all sites
+ * - `system:/elektra/memstats/live` usable bytes currently allocated
+ * - `system:/elektra/memstats/highwater` maximum of live bytes ever seen
+ *
+ * Each call site becomes `system:/elektra/memstats/sites/<file>/<line>` with
+ * the requested bytes as value and the allocation count in the metakey
+ * `allocations`. `<file>` is the basename of the source file, which is what
+ * groups the numbers by subsystem.
+ *
+ * @param ks the keyset to append the statistics to
+ *
+ * @retval >=0 the number of keys appended
+ * @retval -1 if @p ks is NULL
+ * @ingroup malloctrace
+ */
+ssize_t elektraMallocStats (KeySet * ks)
+{
+	if (!ks) return -1;
+
+	MallocTraceSite snapshot[ELEKTRA_MALLOC_TRACE_SITES];
+	size_t numSites = 0;
+	MALLOC_TRACE_LOCK ();
+	for (size_t i = 0; i < ELEKTRA_MALLOC_TRACE_SITES; ++i)
+	{
+		if (mallocTraceSites[i].file) snapshot[numSites++] = mallocTraceSites[i];
+	}
+	size_t dropped = mallocTraceDropped;
+	size_t live = mallocTraceLive;
+	size_t highwater = mallocTraceHighwater;
+	size_t allocations = mallocTraceAllocations;
+	size_t bytes = mallocTraceBytes;
+	MALLOC_TRACE_UNLOCK ();
+
+	/* keyNew() below allocates through the traced functions itself,
+	 * which is safe because the counters were already snapshotted */
+	ssize_t appended = 0;
+	char buffer[32];
+
+	snprintf (buffer, sizeof (buffer), "%zu", allocations);
+	ksAppendKey (ks, keyNew ("system:/elektra/memstats/allocations", KEY_VALUE, buffer, KEY_END));
+	snprintf (buffer, sizeof (buffer), "%zu", bytes);
+	ksAppendKey (ks, keyNew ("system:/elektra/memstats/bytes", KEY_VALUE, buffer, KEY_END));
+	snprintf (buffer, sizeof (buffer), "%zu", live);
+	ksAppendKey (ks, keyNew ("system:/elektra/memstats/live", KEY_VALUE, buffer, KEY_END));
+	snprintf (buffer, sizeof (buffer), "%zu", highwater);
+	ksAppendKey (ks, keyNew ("system:/elektra/memstats/highwater", KEY_VALUE, buffer, KEY_END));
+	snprintf (buffer, sizeof (buffer), "%zu", dropped);
+	ksAppendKey (ks, keyNew ("system:/elektra/memstats/dropped", KEY_VALUE, buffer, KEY_END));
+	appended += 5;
+
+	for (size_t i = 0; i < numSites; ++i)
+	{
+		const char * base = strrchr (snapshot[i].file, '/');
+		base = base ? base + 1 : snapshot[i].file;
+
+		char * name = elektraFormat ("system:/elektra/memstats/sites/%s/%d", base, snapshot[i].line);
+		snprintf (buffer, sizeof (buffer), "%zu", snapshot[i].bytes);
+		Key * key = keyNew (name, KEY_VALUE, buffer, KEY_END);
+		snprintf (buffer, sizeof (buffer), "%zu", snapshot[i].allocations);
+		keySetMeta (key, "allocations", buffer);
+		ksAppendKey (ks, key);
+		elektraFree (name);
+		++appended;
+	}
+
+	return appended;
+}
+
+#endif /* ELEKTRA_MALLOC_TRACE */
+
 /**Reallocate Storage in a save way.
  *
  *@code
@@ -233,6 +559,9 @@ if (elektraRealloc ((void **) & buffer, new_length) < 0) {
  */
 int elektraRealloc (void ** buffer, size_t size)
 {
+#ifdef ELEKTRA_MALLOC_TRACE
+	return elektraReallocTrace (buffer, size, ELEKTRA_MALLOC_TRACE_UNTAGGED, 0);
+#else
 	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
 	void * ptr;
 	void * svr = *buffer;
@@ -249,6 +578,7 @@ int elektraRealloc (void ** buffer, size_t size)
 		*buffer = ptr;
 		return 0;
 	}
+#endif
 }
 
 /**
@@ -273,10 +603,14 @@ if ((buffer = elektraMalloc (length)) == 0) {
  */
 void * elektraMalloc (size_t size)
 {
+#ifdef ELEKTRA_MALLOC_TRACE
+	return elektraMallocTrace (size, ELEKTRA_MALLOC_TRACE_UNTAGGED, 0);
+#else
 	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
 	void * ret = malloc (size);
 	ELEKTRA_ASSERT (ret, "Memory allocation failed with size %zu", size);
 	return ret;
+#endif
 }
 
 /**Allocate memory for Elektra.
@@ -288,10 +622,14 @@ void * elektraMalloc (size_t size)
  */
 void * elektraCalloc (size_t size)
 {
+#ifdef ELEKTRA_MALLOC_TRACE
+	return elektraCallocTrace (size, ELEKTRA_MALLOC_TRACE_UNTAGGED, 0);
+#else
 	ELEKTRA_ASSERT (size, "Size to allocate is zero (implementation defined behavior)");
 	void * ret = calloc (1, size);
 	ELEKTRA_ASSERT (ret, "Memory allocation failed with size %zu", size);
 	return ret;
+#endif
 }
 
 /**Free memory of Elektra or its backends.
@@ -305,6 +643,9 @@ void * elektraCalloc (size_t size)
  */
 void elektraFree (void * ptr)
 {
+#ifdef ELEKTRA_MALLOC_TRACE
+	if (ptr) mallocTraceRelease (malloc_usable_size (ptr));
+#endif
 	free (ptr);
 }
 
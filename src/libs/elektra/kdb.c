@@ -45,6 +45,20 @@
 #include <errno.h>
 #endif
 
+#ifdef HAVE_UNISTD_H
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+
+#ifdef ELEKTRA_HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
 #include <kdbinternal.h>
 
 
@@ -362,6 +376,34 @@ static int ensureContract (KDB * handle, const KeySet * contract, Key * parentKe
 	KeySet * dup = ksDeepDup (contract);
 
 	ensureContractGlobalKs (handle, dup);
+
+	if (ksLookupByName (dup, "system:/elektra/contract/parallelget", 0) != NULL)
+	{
+		// honored by kdbGet() only when thread support was compiled in
+		handle->parallelGet = 1;
+	}
+
+	if (ksLookupByName (dup, "system:/elektra/contract/parallelset", 0) != NULL)
+	{
+		// honored by kdbSet() only when thread support was compiled in
+		handle->parallelSet = 1;
+	}
+
+	Key * journal = ksLookupByName (dup, "system:/elektra/contract/journal", 0);
+	if (journal != NULL && keyString (journal)[0] != '\0')
+	{
+		// the value names the directory the change journal files are kept in
+		handle->changeJournalDir = elektraStrDup (keyString (journal));
+	}
+
+	Key * writeBehind = ksLookupByName (dup, "system:/elektra/contract/writebehind", 0);
+	if (writeBehind != NULL)
+	{
+		// the value is the flush interval in milliseconds
+		int interval = atoi (keyString (writeBehind));
+		handle->writeBehindIntervalMs = interval > 0 ? interval : ELEKTRA_WRITE_BEHIND_DEFAULT_INTERVAL;
+	}
+
 	int ret = ensureContractMountGlobal (handle, dup, parentKey);
 
 	ksDel (dup);
@@ -369,6 +411,199 @@ static int ensureContract (KDB * handle, const KeySet * contract, Key * parentKe
 	return ret;
 }
 
+#ifdef HAVE_UNISTD_H
+/**
+ * @internal
+ *
+ * @brief Constructs the file name of the compiled mountpoint cache.
+ *
+ * The cache lives in the user's cache directory, next to the caches
+ * written by the cache plugin.
+ *
+ * @return the allocated file name, to be freed with elektraFree()
+ * @retval NULL if no cache directory could be determined
+ */
+static char * elektraBootstrapCacheName (void)
+{
+	const char * cacheDir = getenv ("XDG_CACHE_HOME");
+	if (cacheDir != NULL && cacheDir[0] == '/')
+	{
+		return elektraFormat ("%s/elektra/bootstrap.mmap", cacheDir);
+	}
+
+	const char * home = getenv ("HOME");
+	if (home != NULL && home[0] == '/')
+	{
+		return elektraFormat ("%s/.cache/elektra/bootstrap.mmap", home);
+	}
+
+	return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Formats the version stamp guarding the compiled mountpoint cache.
+ *
+ * @return the allocated stamp, to be freed with elektraFree()
+ */
+static char * elektraBootstrapCacheStamp (struct stat * buf)
+{
+	return elektraFormat ("%llu.%llu.%llu", (unsigned long long) ELEKTRA_STAT_SECONDS ((*buf)),
+			      (unsigned long long) ELEKTRA_STAT_NANO_SECONDS ((*buf)), (unsigned long long) buf->st_size);
+}
+#endif
+
+/**
+ * @internal
+ *
+ * @brief Loads the mountpoint configuration from the compiled cache.
+ *
+ * Every kdbOpen() parses `system:/elektra/mountpoints` through the default
+ * backend, even though the configuration rarely changes. After a successful
+ * bootstrap the parsed keyset is therefore serialized with the mmapstorage
+ * plugin (see elektraBootstrapCacheStore()), together with a stamp recording
+ * modification time and size of the bootstrap file. As long as the stamp
+ * still matches the file, later kdbOpen() calls map the compiled cache
+ * directly and skip the default backend entirely.
+ *
+ * Everything here is best effort: a missing cache file, a missing
+ * mmapstorage plugin or a stamp mismatch simply falls back to the normal
+ * bootstrap, which refreshes the cache.
+ *
+ * @retval 1 the cache was loaded into @p keys
+ * @retval 0 cache miss, @p keys is untouched
+ */
+static int elektraBootstrapCacheLoad (KDB * handle ELEKTRA_UNUSED, KeySet * keys ELEKTRA_UNUSED, Key * errorKey ELEKTRA_UNUSED)
+{
+#ifdef HAVE_UNISTD_H
+	char * cacheName = elektraBootstrapCacheName ();
+	if (cacheName == NULL) return 0;
+	if (access (cacheName, R_OK) != 0)
+	{
+		elektraFree (cacheName);
+		return 0;
+	}
+
+	Plugin * storage = elektraPluginOpen ("mmapstorage", handle->modules, ksNew (0, KS_END), errorKey);
+	if (storage == NULL)
+	{
+		elektraFree (cacheName);
+		return 0;
+	}
+
+	Key * cacheParent = keyNew (KDB_SYSTEM_ELEKTRA, KEY_VALUE, cacheName, KEY_END);
+	KeySet * cache = ksNew (0, KS_END);
+	int result = storage->kdbGet (storage, cache, cacheParent);
+	keyDel (cacheParent);
+	elektraPluginClose (storage, errorKey);
+
+	int hit = 0;
+	if (result == ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		Key * stampFile = ksLookupByName (cache, KDB_CACHE_PREFIX "/bootstrap/file", 0);
+		Key * stampValue = ksLookupByName (cache, KDB_CACHE_PREFIX "/bootstrap/stamp", 0);
+		struct stat buf;
+		if (stampFile != NULL && stampValue != NULL && stat (keyString (stampFile), &buf) == 0)
+		{
+			char * stamp = elektraBootstrapCacheStamp (&buf);
+			hit = elektraStrCmp (keyString (stampValue), stamp) == 0;
+			elektraFree (stamp);
+		}
+	}
+
+	if (hit)
+	{
+		ELEKTRA_LOG ("bootstrap cache hit: %s", cacheName);
+		Key * cutpoint = keyNew (KDB_CACHE_PREFIX, KEY_END);
+		ksDel (ksCut (cache, cutpoint));
+		keyDel (cutpoint);
+		ksAppend (keys, cache);
+	}
+	else
+	{
+		ELEKTRA_LOG ("bootstrap cache miss: %s", cacheName);
+	}
+
+	ksDel (cache);
+	elektraFree (cacheName);
+	return hit;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * @internal
+ *
+ * @brief Serializes the parsed mountpoint configuration with mmapstorage.
+ *
+ * Counterpart of elektraBootstrapCacheLoad(). Called after a successful
+ * bootstrap through the default backend; @p bootstrapFile is the resolved
+ * file name the configuration was read from, its modification time and
+ * size form the version stamp. The cache is written to a temporary file
+ * first, so concurrent kdbOpen() calls never see a partial cache.
+ *
+ * Failures only produce a log message: the next kdbOpen() simply
+ * bootstraps through the default backend again.
+ */
+static void elektraBootstrapCacheStore (KDB * handle ELEKTRA_UNUSED, KeySet * keys ELEKTRA_UNUSED, const char * bootstrapFile ELEKTRA_UNUSED,
+					Key * errorKey ELEKTRA_UNUSED)
+{
+#ifdef HAVE_UNISTD_H
+	struct stat buf;
+	if (bootstrapFile == NULL || bootstrapFile[0] != '/' || stat (bootstrapFile, &buf) != 0) return;
+
+	char * cacheName = elektraBootstrapCacheName ();
+	if (cacheName == NULL) return;
+
+	// create the cache directory if necessary
+	for (char * p = strchr (cacheName + 1, '/'); p != NULL; p = strchr (p + 1, '/'))
+	{
+		*p = '\0';
+		int ret = mkdir (cacheName, KDB_FILE_MODE | KDB_DIR_MODE);
+		*p = '/';
+		if (ret == -1 && errno != EEXIST)
+		{
+			elektraFree (cacheName);
+			return;
+		}
+	}
+
+	Plugin * storage = elektraPluginOpen ("mmapstorage", handle->modules, ksNew (0, KS_END), errorKey);
+	if (storage == NULL)
+	{
+		elektraFree (cacheName);
+		return;
+	}
+
+	char * tmpName = elektraFormat ("%s.%d.tmp", cacheName, getpid ());
+	char * stamp = elektraBootstrapCacheStamp (&buf);
+
+	KeySet * cache = ksDup (keys);
+	ksAppendKey (cache, keyNew (KDB_CACHE_PREFIX "/bootstrap/file", KEY_VALUE, bootstrapFile, KEY_END));
+	ksAppendKey (cache, keyNew (KDB_CACHE_PREFIX "/bootstrap/stamp", KEY_VALUE, stamp, KEY_END));
+	elektraFree (stamp);
+
+	Key * cacheParent = keyNew (KDB_SYSTEM_ELEKTRA, KEY_VALUE, tmpName, KEY_END);
+	if (storage->kdbSet (storage, cache, cacheParent) == ELEKTRA_PLUGIN_STATUS_SUCCESS && rename (tmpName, cacheName) == 0)
+	{
+		ELEKTRA_LOG ("stored bootstrap cache: %s", cacheName);
+	}
+	else
+	{
+		ELEKTRA_LOG_WARNING ("could not store bootstrap cache: %s", cacheName);
+		unlink (tmpName);
+	}
+
+	keyDel (cacheParent);
+	ksDel (cache);
+	elektraPluginClose (storage, errorKey);
+	elektraFree (tmpName);
+	elektraFree (cacheName);
+#endif
+}
+
 
 /**
  * Opens the session with the Key database.
@@ -388,6 +623,12 @@ static int ensureContract (KDB * handle, const KeySet * contract, Key * parentKe
  * Finally, the libraries for backends will be loaded and with it the
  * @p KDB data structure will be initialized.
  *
+ * If the mmapstorage plugin is available, the parsed mountpoint
+ * configuration is additionally kept in a compiled cache in the user's
+ * cache directory. Subsequent calls map this cache instead of parsing
+ * the bootstrap file again, as long as a version stamp shows that the
+ * file is unchanged.
+ *
  * The pointer to the @p KDB structure returned will be initialized
  * like described above, and it must be passed along on any kdb*()
  * method your application calls.
@@ -448,29 +689,37 @@ KDB * kdbOpen (const KeySet * contract, Key * errorKey)
 
 	KeySet * keys = ksNew (0, KS_END);
 	int inFallback = 0;
-	switch (elektraOpenBootstrap (handle, keys, errorKey))
+	int fromCache = elektraBootstrapCacheLoad (handle, keys, errorKey);
+	if (!fromCache)
 	{
-	case -1:
-		ksDel (handle->global);
-		ksDel (handle->modules);
-		elektraFree (handle);
-		ELEKTRA_SET_INSTALLATION_ERROR (errorKey,
-						"Could not open default backend. See other warning or error messages for concrete details");
+		switch (elektraOpenBootstrap (handle, keys, errorKey))
+		{
+		case -1:
+			ksDel (handle->global);
+			ksDel (handle->modules);
+			elektraFree (handle);
+			ELEKTRA_SET_INSTALLATION_ERROR (
+				errorKey, "Could not open default backend. See other warning or error messages for concrete details");
 
-		keySetName (errorKey, keyName (initialParent));
-		keySetString (errorKey, keyString (initialParent));
-		keyDel (initialParent);
-		errno = errnosave;
-		ksDel (keys);
-		return 0;
-	case 0:
-		ELEKTRA_ADD_INSTALLATION_WARNING (errorKey, "Initial 'kdbGet()' failed, you should either fix " KDB_DB_INIT
-							    " or the fallback " KDB_DB_FILE);
-		break;
-	case 2:
-		ELEKTRA_LOG ("entered fallback code for bootstrapping");
-		inFallback = 1;
-		break;
+			keySetName (errorKey, keyName (initialParent));
+			keySetString (errorKey, keyString (initialParent));
+			keyDel (initialParent);
+			errno = errnosave;
+			ksDel (keys);
+			return 0;
+		case 0:
+			ELEKTRA_ADD_INSTALLATION_WARNING (errorKey, "Initial 'kdbGet()' failed, you should either fix " KDB_DB_INIT
+								    " or the fallback " KDB_DB_FILE);
+			break;
+		case 2:
+			ELEKTRA_LOG ("entered fallback code for bootstrapping");
+			inFallback = 1;
+			break;
+		case 1:
+			// the value of errorKey is the resolved bootstrap file, see kdbGet()
+			elektraBootstrapCacheStore (handle, keys, keyString (errorKey), errorKey);
+			break;
+		}
 	}
 
 	keySetString (errorKey, "kdbOpen(): mountGlobals");
@@ -484,8 +733,12 @@ KDB * kdbOpen (const KeySet * contract, Key * errorKey)
 	keySetName (errorKey, keyName (initialParent));
 	keySetString (errorKey, "kdbOpen(): backendClose");
 
-	backendClose (handle->defaultBackend, errorKey);
-	splitDel (handle->split);
+	if (!fromCache)
+	{
+		// on a cache hit the default backend was never opened
+		backendClose (handle->defaultBackend, errorKey);
+		splitDel (handle->split);
+	}
 	handle->split = 0;
 	handle->defaultBackend = 0;
 	handle->trie = 0;
@@ -552,6 +805,13 @@ KDB * kdbOpen (const KeySet * contract, Key * errorKey)
 		ELEKTRA_ADD_INTERNAL_WARNING (errorKey, "Mounting modules did not work");
 	}
 
+	/* Mounting is finished, the trie will not be modified anymore.
+	 * Flatten it into the compact form used by lookups and republish it
+	 * with release semantics so that lookups from other threads (see
+	 * mountGetBackend()) see a fully built trie. */
+	trieFinalize (handle->trie);
+	__atomic_store_n (&handle->trie, handle->trie, __ATOMIC_RELEASE);
+
 	keySetName (errorKey, keyName (initialParent));
 	keySetString (errorKey, keyString (initialParent));
 	keyDel (initialParent);
@@ -561,6 +821,113 @@ KDB * kdbOpen (const KeySet * contract, Key * errorKey)
 }
 
 
+static int copyError (Key * dest, Key * src);
+
+/**
+ * @internal
+ *
+ * Deferred commit kept back by the write-behind contract, see kdbFlush().
+ * Lazily allocated by the first kdbSet() that defers a commit.
+ */
+struct _KdbWriteBehind
+{
+	KeySet * pending; /*!< duplicate of the keyset passed to the last deferred kdbSet() */
+	Key * parentKey;  /*!< duplicate of the matching parent key */
+	kdb_unsigned_long_long_t lastFlush; /*!< monotonic time of the last flush, in milliseconds */
+	int dirty;			    /*!< nonzero while pending holds an unwritten commit */
+	int flushing; /*!< breaks the recursion when the flush itself calls kdbSet() */
+};
+
+/**
+ * @internal
+ *
+ * @brief Monotonic wall clock in milliseconds, for write-behind flush pacing.
+ */
+static kdb_unsigned_long_long_t elektraWriteBehindNow (void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (kdb_unsigned_long_long_t) now.tv_sec * 1000ULL + (kdb_unsigned_long_long_t) now.tv_nsec / 1000000ULL;
+#else
+	return (kdb_unsigned_long_long_t) time (NULL) * 1000ULL;
+#endif
+}
+
+/**
+ * @internal
+ *
+ * @brief Writes the deferred commit through the regular kdbSet() path.
+ *
+ * @param handle the handle holding the deferred commit
+ * @param errorKey when non-NULL and the flush fails, the error from the
+ * deferred parent key is copied here
+ *
+ * @retval 1 the pending commit was written
+ * @retval 0 nothing was pending
+ * @retval -1 the flush failed
+ */
+static int elektraWriteBehindFlush (KDB * handle, Key * errorKey)
+{
+	struct _KdbWriteBehind * wb = handle->writeBehind;
+	if (wb == NULL || !wb->dirty) return 0;
+
+	wb->flushing = 1;
+	int ret = kdbSet (handle, wb->pending, wb->parentKey);
+	wb->flushing = 0;
+	wb->dirty = 0;
+	wb->lastFlush = elektraWriteBehindNow ();
+
+	if (ret == -1 && errorKey != NULL)
+	{
+		copyError (errorKey, wb->parentKey);
+	}
+	return ret;
+}
+
+/**
+ * @internal
+ *
+ * @brief Records a kdbSet() commit for a later flush instead of writing it.
+ *
+ * Only the newest keyset per parent is kept: state that is updated at a high
+ * rate collapses into a single disk write per flush interval. A commit under
+ * a different parent key than the pending one cannot share the snapshot, so
+ * the pending commit is written first.
+ *
+ * @retval 1 the commit was recorded (or recorded and flushed)
+ * @retval 0 a triggered interval flush found nothing to write
+ * @retval -1 flushing a pending commit failed
+ */
+static int elektraWriteBehindDefer (KDB * handle, KeySet * ks, Key * parentKey)
+{
+	if (handle->writeBehind == NULL)
+	{
+		handle->writeBehind = elektraCalloc (sizeof (struct _KdbWriteBehind));
+		handle->writeBehind->lastFlush = elektraWriteBehindNow ();
+	}
+
+	struct _KdbWriteBehind * wb = handle->writeBehind;
+
+	if (wb->dirty && elektraStrCmp (keyName (wb->parentKey), keyName (parentKey)) != 0)
+	{
+		if (elektraWriteBehindFlush (handle, parentKey) == -1) return -1;
+	}
+
+	ksDel (wb->pending);
+	wb->pending = ksDup (ks);
+	keyDel (wb->parentKey);
+	wb->parentKey = keyDup (parentKey, KEY_CP_ALL);
+	wb->dirty = 1;
+
+	if (elektraWriteBehindNow () - wb->lastFlush >= (kdb_unsigned_long_long_t) handle->writeBehindIntervalMs)
+	{
+		return elektraWriteBehindFlush (handle, parentKey);
+	}
+
+	return 1;
+}
+
 /**
  * Closes the session with the Key database.
  *
@@ -597,6 +964,16 @@ int kdbClose (KDB * handle, Key * errorKey)
 	Key * initialParent = keyDup (errorKey, KEY_CP_ALL);
 	int errnosave = errno;
 
+	if (handle->writeBehind != NULL)
+	{
+		// best effort: write the deferred commit out while the backends are still open
+		elektraWriteBehindFlush (handle, errorKey);
+		ksDel (handle->writeBehind->pending);
+		keyDel (handle->writeBehind->parentKey);
+		elektraFree (handle->writeBehind);
+		handle->writeBehind = NULL;
+	}
+
 	if (handle->split)
 	{
 		splitDel (handle->split);
@@ -634,6 +1011,7 @@ int kdbClose (KDB * handle, Key * errorKey)
 
 	if (handle->global) ksDel (handle->global);
 
+	elektraFree (handle->changeJournalDir);
 	elektraFree (handle);
 
 	keySetName (errorKey, keyName (initialParent));
@@ -675,7 +1053,14 @@ static int elektraGetCheckUpdateNeeded (Split * split, Key * parentKey)
 			// no keys in that backend
 			ELEKTRA_LOG_DEBUG ("backend: %s,%s ;; ret: %d", keyName (split->parents[i]), keyString (split->parents[i]), ret);
 
-			backendUpdateSize (backend, split->parents[i], 0);
+			if (ret != ELEKTRA_PLUGIN_STATUS_NO_UPDATE || backendGetSize (backend, split->parents[i]) < 0)
+			{
+				// the real size is set during postprocessing;
+				// when nothing changed, an already stored size still
+				// describes the backend's content exactly and is
+				// needed to detect removals on the next kdbSet()
+				backendUpdateSize (backend, split->parents[i], 0);
+			}
 		}
 		// TODO: set error in else case!
 
@@ -740,25 +1125,133 @@ static int elektraGetDoUpdate (Split * split, Key * parentKey)
 		keySetName (parentKey, keyName (split->parents[i]));
 		keySetString (parentKey, keyString (split->parents[i]));
 
-		for (size_t p = 1; p < NR_OF_PLUGINS; ++p)
+		// the chain contains exactly the plugins after the resolver that implement kdbGet
+		for (size_t p = 0; p < backend->getChainSize; ++p)
 		{
-			int ret = 0;
-			if (backend->getplugins[p] && backend->getplugins[p]->kdbGet)
-			{
-				ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], split->keysets[i], parentKey);
-			}
-
-			if (ret == -1)
+			Plugin * plugin = backend->getChain[p];
+			if (elektraPluginMemoGet (plugin, split->keysets[i], parentKey) == -1)
 			{
 				// Ohh, an error occurred,
 				// lets stop the process.
 				return -1;
 			}
 		}
+
+		// a storage plugin that honored the get/below hint reports back
+		// that it parsed only the requested subtree
+		backend->partialGet = keyGetMeta (parentKey, "get/partial") != NULL;
+		keySetMeta (parentKey, "get/partial", NULL);
 	}
 	return 0;
 }
 
+static int copyError (Key * dest, Key * src);
+static int elektraWriteBehindFlush (KDB * handle, Key * errorKey);
+
+#ifdef ELEKTRA_HAVE_PTHREAD
+typedef struct
+{
+	Split * split;	 /*!< the split this job belongs to */
+	size_t index;	 /*!< index of the backend within the split */
+	Key * parentKey; /*!< private parent key, so that plugins of different backends never share a key */
+	int running;	 /*!< whether a thread was started for this job */
+	int result;	 /*!< 0 on success, -1 on error */
+} ElektraGetBackendJob;
+
+static void * elektraGetDoUpdateJob (void * data)
+{
+	ElektraGetBackendJob * job = data;
+	Split * split = job->split;
+	size_t i = job->index;
+	Backend * backend = split->handles[i];
+
+	ksRewind (split->keysets[i]);
+	for (size_t p = 0; p < backend->getChainSize; ++p)
+	{
+		Plugin * plugin = backend->getChain[p];
+		if (elektraPluginMemoGet (plugin, split->keysets[i], job->parentKey) == -1)
+		{
+			job->result = -1;
+			return NULL;
+		}
+	}
+
+	job->result = 0;
+	return NULL;
+}
+
+/**
+ * @internal
+ * @brief Do the real update, with independent backends updated concurrently.
+ *
+ * Used instead of elektraGetDoUpdate() when the parallelget contract was
+ * given at kdbOpen(). Each backend that needs a sync runs its storage and
+ * postgetstorage plugins on an own thread with an own parent key; the
+ * keysets of different backends are disjoint, so the threads share no
+ * mutable state. Cold-start latency is therefore bounded by the slowest
+ * backend instead of the sum of all backends. The caller must ensure that
+ * all mounted plugins are reentrant before opting in.
+ *
+ * @retval -1 on error
+ * @retval 0 on success
+ */
+static int elektraGetDoUpdateParallel (Split * split, Key * parentKey)
+{
+	const int bypassedSplits = 1;
+	size_t jobCount = split->size - bypassedSplits;
+
+	ElektraGetBackendJob * jobs = elektraCalloc (jobCount * sizeof (ElektraGetBackendJob));
+	pthread_t * threads = elektraCalloc (jobCount * sizeof (pthread_t));
+
+	for (size_t i = 0; i < jobCount; i++)
+	{
+		if (!test_bit (split->syncbits[i], SPLIT_FLAG_SYNC))
+		{
+			// skip it, update is not needed
+			continue;
+		}
+
+		jobs[i].split = split;
+		jobs[i].index = i;
+		jobs[i].parentKey =
+			keyNew (keyName (split->parents[i]), KEY_VALUE, keyString (split->parents[i]), KEY_END);
+		keyCopyMeta (jobs[i].parentKey, parentKey, "get/below");
+		jobs[i].running = pthread_create (&threads[i], NULL, elektraGetDoUpdateJob, &jobs[i]) == 0;
+
+		if (!jobs[i].running)
+		{
+			// could not start a thread, do the work right here
+			elektraGetDoUpdateJob (&jobs[i]);
+		}
+	}
+
+	int ret = 0;
+	for (size_t i = 0; i < jobCount; i++)
+	{
+		if (jobs[i].running)
+		{
+			pthread_join (threads[i], NULL);
+		}
+
+		if (jobs[i].parentKey != NULL)
+		{
+			if (jobs[i].result == -1 && ret == 0)
+			{
+				// report the first failing backend
+				copyError (parentKey, jobs[i].parentKey);
+				ret = -1;
+			}
+			split->handles[i]->partialGet = keyGetMeta (jobs[i].parentKey, "get/partial") != NULL;
+			keyDel (jobs[i].parentKey);
+		}
+	}
+
+	elektraFree (threads);
+	elektraFree (jobs);
+	return ret;
+}
+#endif
+
 static KeySet * prepareGlobalKS (KeySet * ks, Key * parentKey)
 {
 	ksRewind (ks);
@@ -865,7 +1358,7 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 						continue;
 					}
 
-					ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], split->keysets[i], parentKey);
+					ret = elektraPluginMemoGet (backend->getplugins[p], split->keysets[i], parentKey);
 				}
 				else
 				{
@@ -910,13 +1403,73 @@ static int copyError (Key * dest, Key * src)
 	}
 	return 1;
 }
-static void clearError (Key * key)
+
+/**
+ * @internal
+ *
+ * Appends the warnings of src to the warning array of dest, advancing
+ * dest's warning index with the same circular numbering that issuing a
+ * warning directly on dest would use.
+ */
+static void copyWarnings (Key * dest, Key * src)
 {
-	keySetMeta (key, "error", 0);
-	keySetMeta (key, "error/number", 0);
-	keySetMeta (key, "error/description", 0);
-	keySetMeta (key, "error/reason", 0);
-	keySetMeta (key, "error/module", 0);
+	if (keyGetMeta (src, "warnings") == NULL) return;
+
+	static const char * const fields[] = { "number", "description", "module", "file", "line", "mountpoint", "configfile", "reason" };
+
+	keyRewindMeta (src);
+	const Key * meta;
+	while ((meta = keyNextMeta (src)) != NULL)
+	{
+		const char * srcName = keyName (meta);
+		if (strncmp (srcName, "meta:/warnings/#", sizeof ("meta:/warnings/#") - 1) != 0) continue;
+		// only react to the base entry of each warning, the fields are copied below
+		if (strchr (srcName + sizeof ("meta:/warnings/#") - 1, '/') != NULL) continue;
+
+		char buffer[64] = "warnings/#0\0\0\0";
+		char * end = &buffer[11];
+		const Key * indexMeta = keyGetMeta (dest, "warnings");
+		const char * old = indexMeta == NULL ? NULL : keyString (indexMeta);
+		if (old && strcmp (old, "#_99") < 0)
+		{
+			int i = old[1] == '_' ? ((old[2] - '0') * 10 + (old[3] - '0')) : (old[1] - '0');
+			i = (i + 1) % 100;
+
+			if (i < 10)
+			{
+				buffer[10] = '0' + i;
+				end = &buffer[11];
+			}
+			else
+			{
+				buffer[10] = '_';
+				buffer[11] = '0' + (i / 10);
+				buffer[12] = '0' + (i % 10);
+				end = &buffer[13];
+			}
+		}
+		keySetMeta (dest, "warnings", &buffer[9]);
+		keySetMeta (dest, buffer, keyString (meta));
+
+		char fieldName[64];
+		for (size_t f = 0; f < sizeof (fields) / sizeof (fields[0]); ++f)
+		{
+			snprintf (fieldName, sizeof (fieldName), "%s/%s", srcName, fields[f]);
+			const Key * field = keyGetMeta (src, fieldName);
+			if (field == NULL) continue;
+			*end = '/';
+			strcpy (end + 1, fields[f]);
+			keySetMeta (dest, buffer, keyString (field));
+		}
+	}
+}
+static void clearError (Key * key)
+{
+	keySetMeta (key, "error", 0);
+	keySetMeta (key, "error/number", 0);
+	keySetMeta (key, "error/description", 0);
+	keySetMeta (key, "error/reason", 0);
+	keySetMeta (key, "error/module", 0);
 	keySetMeta (key, "error/file", 0);
 	keySetMeta (key, "error/line", 0);
 	keySetMeta (key, "error/configfile", 0);
@@ -1148,6 +1701,15 @@ static int elektraCacheLoadSplit (KDB * handle, Split * split, KeySet * ks, KeyS
  *     Make sure to not touch or remove Keys outside the Keys of interest,
  *     because others may need them!
  *
+ * @note When @p parentKey is below a mountpoint, the requested name is also
+ *     passed to the storage plugins as the `get/below` metadata on the parent
+ *     key of the backend. A storage plugin that can do so is allowed to parse
+ *     only the requested subtree of its file and answer with the `get/partial`
+ *     metadata (e.g. the quickdump plugin does this). Such a partial result is
+ *     never cached and kdbSet() refuses to write a partially loaded backend
+ *     until a full kdbGet() happened, so the optimization stays invisible to
+ *     read-only callers and cannot lose keys.
+ *
  * @par Example:
  * This example demonstrates the typical usecase within an application
  * (without error handling).
@@ -1207,6 +1769,16 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 		return -1;
 	}
 
+	if (handle != NULL && handle->writeBehind != NULL && handle->writeBehind->dirty)
+	{
+		// read-your-writes: make the deferred commit visible before reading, see kdbFlush()
+		if (elektraWriteBehindFlush (handle, parentKey) == -1)
+		{
+			keyDel (oldError);
+			return -1;
+		}
+	}
+
 	int errnosave = errno;
 	Key * initialParent = keyDup (parentKey, KEY_CP_ALL);
 
@@ -1260,12 +1832,27 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 		elektraCacheLoad (handle, cache, parentKey, initialParent, cacheParent); // parentkey different from initialParent
 	}
 
+	// If the cache plugin proved via its shared-memory generation counter
+	// that the cache is current, skip the resolver round-trip over all
+	// backends entirely
+	int shmHit = cache != 0 && handle->global != 0 && ksLookupByName (handle->global, KDB_CACHE_PREFIX "/shm/uptodate", 0) != 0;
+
 	// Check if a update is needed at all
-	switch (elektraGetCheckUpdateNeeded (split, parentKey))
+	elektraTimerBegin ("kdbGet/resolver");
+	int updateNeeded = shmHit ? -2 : elektraGetCheckUpdateNeeded (split, parentKey);
+	elektraTimerEnd ("kdbGet/resolver");
+
+	switch (updateNeeded)
 	{
 	case -2: // We have a cache hit
 		if (elektraCacheLoadSplit (handle, split, ks, &cache, &cacheParent, parentKey, initialParent, debugGlobalPositions) != 0)
 		{
+			// resolve the backend files after all, the full get
+			// path below needs them
+			if (shmHit && elektraGetCheckUpdateNeeded (split, parentKey) == -1)
+			{
+				goto error;
+			}
 			goto cachemiss;
 		}
 
@@ -1384,6 +1971,7 @@ cachemiss:
 
 		keySetName (parentKey, keyName (initialParent));
 
+		elektraTimerBegin ("kdbGet/postprocess");
 		if (splitGet (split, parentKey, handle) == -1)
 		{
 			ELEKTRA_ADD_PLUGIN_MISBEHAVIOR_WARNINGF (parentKey, "Wrong keys in postprocessing: %s", keyName (ksCurrent (ks)));
@@ -1391,6 +1979,7 @@ cachemiss:
 		}
 		ksClear (ks);
 		splitMergeBackends (split, ks);
+		elektraTimerEnd ("kdbGet/postprocess");
 
 		clearError (parentKey);
 		if (elektraGetDoUpdateWithGlobalHooks (handle, split, ks, parentKey, initialParent, LAST) == -1)
@@ -1408,8 +1997,27 @@ cachemiss:
 		/* Now do the real updating,
 		   but not for bypassed keys in split->size-1 */
 		clearError (parentKey);
+		// tell capable storage plugins which subtree was actually requested,
+		// so they can skip parsing the rest of their file; plugins honoring
+		// the hint answer with get/partial and the backend is marked, see
+		// struct _Backend.partialGet
+		keySetMeta (parentKey, "get/below", keyName (initialParent));
 		// do everything up to position get_storage
-		if (elektraGetDoUpdate (split, parentKey) == -1)
+		int updateRet;
+		elektraTimerBegin ("kdbGet/storage");
+#ifdef ELEKTRA_HAVE_PTHREAD
+		if (handle->parallelGet)
+		{
+			updateRet = elektraGetDoUpdateParallel (split, parentKey);
+		}
+		else
+#endif
+		{
+			updateRet = elektraGetDoUpdate (split, parentKey);
+		}
+		elektraTimerEnd ("kdbGet/storage");
+		keySetMeta (parentKey, "get/below", NULL);
+		if (updateRet == -1)
 		{
 			goto error;
 		}
@@ -1419,6 +2027,7 @@ cachemiss:
 		}
 
 		/* Now post-process the updated keysets */
+		elektraTimerBegin ("kdbGet/postprocess");
 		if (splitGet (split, parentKey, handle) == -1)
 		{
 			ELEKTRA_ADD_PLUGIN_MISBEHAVIOR_WARNINGF (parentKey, "Wrong keys in postprocessing: %s", keyName (ksCurrent (ks)));
@@ -1427,6 +2036,7 @@ cachemiss:
 
 		ksClear (ks);
 		splitMergeBackends (split, ks);
+		elektraTimerEnd ("kdbGet/postprocess");
 	}
 
 	keySetName (parentKey, keyName (initialParent));
@@ -1444,8 +2054,16 @@ cachemiss:
 		goto error;
 	}
 
-	if (handle->globalPlugins[POSTGETCACHE][MAXONCE])
+	int partialGet = 0;
+	for (size_t i = 0; i < split->size; i++)
+	{
+		// the bypassed default split has no backend
+		if (split->handles[i] != NULL && split->handles[i]->partialGet) partialGet = 1;
+	}
+
+	if (!partialGet && handle->globalPlugins[POSTGETCACHE][MAXONCE])
 	{
+		elektraTimerBegin ("kdbGet/cachestore");
 		splitCacheStoreState (handle, split, handle->global, cacheParent, initialParent);
 		KeySet * proc = elektraCutProc (ks); // remove proc keys before caching
 		if (elektraGlobalSet (handle, ks, cacheParent, POSTGETCACHE, MAXONCE) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
@@ -1456,9 +2074,11 @@ cachemiss:
 			elektraCacheCutMeta (handle);
 		}
 		elektraRestoreProc (ks, proc);
+		elektraTimerEnd ("kdbGet/cachestore");
 	}
 	else
 	{
+		// partial results must never end up in the cache
 		elektraCacheCutMeta (handle);
 	}
 	keyDel (cacheParent);
@@ -1482,6 +2102,8 @@ error:
 	ELEKTRA_LOG_DEBUG ("now in error state");
 	if (cacheParent) keyDel (cacheParent);
 	if (cache) ksDel (cache);
+	keySetMeta (parentKey, "get/below", NULL);
+	keySetMeta (parentKey, "get/partial", NULL);
 	keySetName (parentKey, keyName (initialParent));
 	elektraGlobalError (handle, ks, parentKey, POSTGETSTORAGE, INIT);
 	elektraGlobalError (handle, ks, parentKey, POSTGETSTORAGE, MAXONCE);
@@ -1496,6 +2118,513 @@ error:
 	return -1;
 }
 
+/**
+ * Streaming variant of kdbGet() for iterating over huge configurations once.
+ *
+ * Instead of materializing all keys below @p parentKey at once, the relevant
+ * backends are fetched one at a time and each backend's keys below
+ * @p parentKey are passed to @p callback. After the callback returns the
+ * chunk is deleted again, so resident memory is bounded by the largest
+ * single backend below @p parentKey instead of the sum of all of them.
+ *
+ * Each chunk is produced by a regular kdbGet() with the backend's mountpoint
+ * as parent, so plugins (including global plugins) see the same data as with
+ * a non-streaming kdbGet(). Chunks are emitted in mountpoint order. A chunk
+ * is never smaller than one backend: splitting a single storage file would
+ * require chunked parsing support in every storage plugin. Like with
+ * kdbGet() a chunk contains every key of its backend, including keys not
+ * below @p parentKey, so the callback has to filter (e.g. via ksCut())
+ * when only the requested subtree is of interest.
+ *
+ * The chunk KeySet is owned by kdbGetStream() and deleted after the
+ * callback returns; the callback may freely modify it. Keys that should
+ * outlive the callback have to be moved into a KeySet owned by the caller,
+ * e.g. via ksAppendKey(). Warnings issued by the backends are collected
+ * on @p parentKey like with kdbGet().
+ *
+ * @param handle    contains internal information of @link kdbOpen() opened @endlink key database
+ * @param parentKey Keys below this key are streamed to @p callback
+ * @param callback  invoked once per backend; must return 0 to continue or
+ *                  a negative value to abort the iteration
+ * @param context   opaque pointer passed through to @p callback
+ *
+ * @retval 1 when the iteration completed
+ * @retval -1 on failure or when @p callback aborted
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ * @see kdbGet() when random access or repeated lookups are needed
+ */
+int kdbGetStream (KDB * handle, Key * parentKey, ElektraGetStreamCallback callback, void * context)
+{
+	elektraNamespace ns = keyGetNamespace (parentKey);
+	if (ns == KEY_NS_NONE)
+	{
+		return -1;
+	}
+	if (ns == KEY_NS_META)
+	{
+		ELEKTRA_SET_INTERFACE_ERRORF (parentKey, "Metakey with name '%s' passed to kdbGetStream as parentkey",
+					      keyName (parentKey));
+		return -1;
+	}
+	if (!handle || !callback)
+	{
+		ELEKTRA_SET_INTERFACE_ERROR (parentKey, "NULL pointer passed for handle or callback");
+		return -1;
+	}
+
+	Split * split = splitNew ();
+	if (splitBuildup (split, handle, parentKey) == -1)
+	{
+		ELEKTRA_SET_INTERNAL_ERROR (parentKey, "Error in splitBuildup");
+		splitDel (split);
+		return -1;
+	}
+
+	int ret = 1;
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		// narrow the chunk to the requested parent within this backend's
+		// namespace, so a broadly mounted backend (e.g. a namespace root)
+		// does not pull in unrelated parts of its namespace
+		Key * chunkParent = keyNew (keyName (split->parents[i]), KEY_END);
+		Key * requested = keyNew ("/", KEY_END);
+		keySetNamespace (requested, keyGetNamespace (chunkParent));
+		keyAddName (requested, strchr (keyName (parentKey), '/'));
+		if (keyIsBelow (chunkParent, requested) == 1) keySetName (chunkParent, keyName (requested));
+		keyDel (requested);
+		KeySet * chunk = ksNew (0, KS_END);
+
+		if (kdbGet (handle, chunk, chunkParent) == -1)
+		{
+			copyError (parentKey, chunkParent);
+			copyWarnings (parentKey, chunkParent);
+			ret = -1;
+		}
+		else
+		{
+			copyWarnings (parentKey, chunkParent);
+			int cbRet = callback (chunk, chunkParent, context);
+			if (cbRet < 0) ret = cbRet;
+		}
+
+		ksDel (chunk);
+		keyDel (chunkParent);
+		if (ret < 0) break;
+	}
+
+	splitDel (split);
+	return ret < 0 ? -1 : 1;
+}
+
+/**
+ * Retrieves several disjoint subtrees with one pass over the backends.
+ *
+ * Works like calling kdbGet() once per entry of @p parents, but the
+ * requests are planned against the mount trie together: every backend
+ * that is needed by any of the parent keys is fetched and post-processed
+ * exactly once and its keys are then distributed to all requesting
+ * result KeySets. When several parent keys touch overlapping backends
+ * (e.g. an application retrieving multiple subtrees of one mountpoint
+ * at startup), the resolver checks and the storage and postprocessing
+ * work for the shared backends are paid once instead of once per call.
+ *
+ * The update semantics of kdbGet() apply per backend: a backend that
+ * did not change since this @p handle last read it is not fetched again
+ * and contributes nothing, so the corresponding keys in @p results stay
+ * as they were. Newly retrieved keys are appended via ksAppendKey().
+ * Unlike kdbGet() the results only contain keys below their parent key,
+ * so they are not suitable for a later kdbSet() without a full kdbGet().
+ *
+ * @param handle  contains internal information of @link kdbOpen() opened @endlink key database
+ * @param parents the parent keys to retrieve; also used to add warnings
+ *                and set error information
+ * @param n       the number of entries in @p parents and @p results
+ * @param results one pre-initialized KeySet per parent key, receiving
+ *                the keys below it
+ *
+ * @retval 1 if keys were retrieved successfully
+ * @retval 0 if no backend had an update - no changes are made to the KeySets then
+ * @retval -1 on failure - no changes are made to the KeySets then
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ * @see kdbGet() for retrieving a single subtree and the full semantics
+ */
+int kdbGetMulti (KDB * handle, Key ** parents, size_t n, KeySet ** results)
+{
+	if (!handle || !parents || !results) return -1;
+	if (n == 0) return 0;
+
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (!parents[i] || !results[i]) return -1;
+		elektraNamespace ns = keyGetNamespace (parents[i]);
+		if (ns == KEY_NS_NONE) return -1;
+		if (ns == KEY_NS_META)
+		{
+			ELEKTRA_SET_INTERFACE_ERRORF (parents[i], "Metakey with name '%s' passed to kdbGetMulti as parentkey",
+						      keyName (parents[i]));
+			return -1;
+		}
+	}
+
+	// plan all requests at once: one split per parent to learn which
+	// backends it needs, plus the set of distinct mountpoints overall
+	Split ** plans = elektraCalloc (n * sizeof (Split *));
+	KeySet * mountpoints = ksNew (0, KS_END);
+
+	int ret = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		plans[i] = splitNew ();
+		if (splitBuildup (plans[i], handle, parents[i]) == -1)
+		{
+			clearError (parents[i]);
+			ELEKTRA_SET_INTERNAL_ERROR (parents[i], "Error in splitBuildup");
+			ret = -1;
+			break;
+		}
+		for (size_t b = 0; b < plans[i]->size; ++b)
+		{
+			ksAppendKey (mountpoints, keyNew (keyName (plans[i]->parents[b]), KEY_END));
+		}
+	}
+
+	// fetch every distinct backend a single time; the chunk is attached
+	// to the mountpoint key for the distribution below
+	ssize_t mountpointCount = ksGetSize (mountpoints);
+	for (elektraCursor m = 0; ret >= 0 && m < mountpointCount; ++m)
+	{
+		Key * mountpoint = ksAtCursor (mountpoints, m);
+		Key * chunkParent = keyNew (keyName (mountpoint), KEY_END);
+		KeySet * chunk = ksNew (0, KS_END);
+
+		int getRet = kdbGet (handle, chunk, chunkParent);
+		if (getRet == -1)
+		{
+			// the error affects every parent key using this backend
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t b = 0; b < plans[i]->size; ++b)
+				{
+					if (keyCmp (plans[i]->parents[b], mountpoint) == 0)
+					{
+						copyError (parents[i], chunkParent);
+						break;
+					}
+				}
+			}
+			ret = -1;
+		}
+		else if (getRet == 1)
+		{
+			keySetBinary (mountpoint, &chunk, sizeof (KeySet *));
+			chunk = NULL;
+			ret = 1;
+		}
+		// on 0 the backend is unchanged, there is nothing to distribute
+
+		if (chunk != NULL) ksDel (chunk);
+		keyDel (chunkParent);
+	}
+
+	// split the fetched chunks into the per-parent results
+	if (ret == 1)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t b = 0; b < plans[i]->size; ++b)
+			{
+				Key * mountpoint = ksLookup (mountpoints, plans[i]->parents[b], 0);
+				KeySet * chunk = NULL;
+				if (mountpoint != NULL && keyGetValueSize (mountpoint) == sizeof (KeySet *))
+				{
+					memcpy (&chunk, keyValue (mountpoint), sizeof (KeySet *));
+				}
+				if (chunk == NULL) continue;
+
+				// a chunk may feed several parents, only pass the keys below each
+				KeySet * dup = ksDup (chunk);
+				KeySet * below = ksCut (dup, parents[i]);
+				ksAppend (results[i], below);
+				ksDel (below);
+				ksDel (dup);
+			}
+		}
+	}
+
+	ssize_t size = ksGetSize (mountpoints);
+	for (elektraCursor m = 0; m < size; ++m)
+	{
+		Key * mountpoint = ksAtCursor (mountpoints, m);
+		KeySet * chunk = NULL;
+		if (keyGetValueSize (mountpoint) == sizeof (KeySet *))
+		{
+			memcpy (&chunk, keyValue (mountpoint), sizeof (KeySet *));
+		}
+		if (chunk != NULL) ksDel (chunk);
+	}
+	ksDel (mountpoints);
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (plans[i] != NULL) splitDel (plans[i]);
+	}
+	elektraFree (plans);
+
+	return ret;
+}
+
+/**
+ * @internal
+ * A frozen view of the configuration below one parent key, shared by
+ * several reader threads. See kdbSnapshot().
+ */
+struct _KdbSnapshot
+{
+#ifdef ELEKTRA_HAVE_PTHREAD
+	pthread_mutex_t lock; /**< guards all members and the shared reference counts */
+#endif
+	KeySet * master;	 /**< full kdbGet() result, reused across refreshes */
+	KeySet * data;		 /**< current generation: frozen COW view of master */
+	unsigned int generation; /**< incremented by every successful kdbSnapshotRefresh() */
+};
+
+static inline void snapshotLock (KdbSnapshot * snapshot ELEKTRA_UNUSED)
+{
+#ifdef ELEKTRA_HAVE_PTHREAD
+	pthread_mutex_lock (&snapshot->lock);
+#endif
+}
+
+static inline void snapshotUnlock (KdbSnapshot * snapshot ELEKTRA_UNUSED)
+{
+#ifdef ELEKTRA_HAVE_PTHREAD
+	pthread_mutex_unlock (&snapshot->lock);
+#endif
+}
+
+/**
+ * @internal
+ * Freezes the part of @p master below @p parentKey into a new
+ * generation: a copy-on-write duplicate whose keys are locked against
+ * name, value and metadata changes. The master keys themselves stay
+ * unlocked, they are needed again for the next kdbGet().
+ */
+static KeySet * snapshotFreeze (KeySet * master, Key * parentKey)
+{
+	// select without disturbing master: the flat dup shares the key
+	// structs, cutting only moves them between the temporary keysets
+	KeySet * dup = ksDup (master);
+	KeySet * below = ksCut (dup, parentKey);
+	KeySet * data = ksCowDup (below);
+	ksDel (below);
+	ksDel (dup);
+	if (data == NULL) return NULL;
+
+	ssize_t size = ksGetSize (data);
+	for (elektraCursor it = 0; it < size; ++it)
+	{
+		keyLock (ksAtCursor (data, it), KEY_LOCK_NAME | KEY_LOCK_VALUE | KEY_LOCK_META);
+	}
+	return data;
+}
+
+/**
+ * Creates a frozen, immutable view of the configuration below @p parentKey.
+ *
+ * A KDB handle must not be used from several threads without external
+ * locking. A snapshot decouples readers from the handle: it holds the
+ * result of one kdbGet(), with every key locked against modification,
+ * and hands out cheap copy-on-write views via kdbSnapshotAcquire() that
+ * worker threads can query without any synchronization. The handle is
+ * only needed again to refresh the snapshot, e.g. from a notification
+ * callback, via kdbSnapshotRefresh(); readers pick up the new
+ * generation by re-acquiring.
+ *
+ * @param handle    contains internal information of @link kdbOpen() opened @endlink key database
+ * @param parentKey keys below this key become part of the snapshot; also
+ *                  receives error information when the retrieval fails
+ *
+ * @return the new snapshot, to be freed with kdbSnapshotDel()
+ * @retval NULL when the retrieval failed
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ * @see kdbSnapshotAcquire() and kdbSnapshotRelease() for the reader side
+ * @see kdbSnapshotRefresh() for swapping in up-to-date data
+ */
+KdbSnapshot * kdbSnapshot (KDB * handle, Key * parentKey)
+{
+	if (!handle || !parentKey) return NULL;
+
+	KeySet * master = ksNew (0, KS_END);
+	if (kdbGet (handle, master, parentKey) == -1)
+	{
+		ksDel (master);
+		return NULL;
+	}
+
+	KeySet * data = snapshotFreeze (master, parentKey);
+	if (data == NULL)
+	{
+		ksDel (master);
+		return NULL;
+	}
+
+	KdbSnapshot * snapshot = elektraCalloc (sizeof (struct _KdbSnapshot));
+#ifdef ELEKTRA_HAVE_PTHREAD
+	pthread_mutex_init (&snapshot->lock, NULL);
+#endif
+	snapshot->master = master;
+	snapshot->data = data;
+	snapshot->generation = 1;
+	return snapshot;
+}
+
+/**
+ * Hands out a view of the snapshot's current generation.
+ *
+ * The view is a copy-on-write duplicate (see ksCowDup()) owned by the
+ * calling thread: lookups and iteration on it need no synchronization
+ * with other readers or with kdbSnapshotRefresh(). That includes
+ * keyGetMeta(): the metadata KeySets are shared between all views of a
+ * generation, so metadata lookups on them go through ksLookupReadOnly()
+ * instead of the mutating ksLookup(). The keys themselves
+ * stay locked, so the configuration cannot be modified through a view.
+ * Acquiring is the only synchronization point and amortizes over all
+ * queries on the view.
+ *
+ * @param snapshot the snapshot to read from
+ *
+ * @return the view, to be returned with kdbSnapshotRelease()
+ * @retval NULL on NULL @p snapshot or memory error
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ */
+KeySet * kdbSnapshotAcquire (KdbSnapshot * snapshot)
+{
+	if (!snapshot) return NULL;
+
+	snapshotLock (snapshot);
+	KeySet * view = ksCowDup (snapshot->data);
+	snapshotUnlock (snapshot);
+	return view;
+}
+
+/**
+ * Returns a view obtained from kdbSnapshotAcquire().
+ *
+ * Releasing has to go through the snapshot because the view shares
+ * reference-counted buffers with its generation, which may be released
+ * concurrently by other readers or by kdbSnapshotRefresh().
+ *
+ * @param snapshot the snapshot the view was acquired from
+ * @param view     the view to release, may be NULL
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ */
+void kdbSnapshotRelease (KdbSnapshot * snapshot, KeySet * view)
+{
+	if (!snapshot || !view) return;
+
+	snapshotLock (snapshot);
+	ksDel (view);
+	snapshotUnlock (snapshot);
+}
+
+/**
+ * Returns the current generation of @p snapshot.
+ *
+ * Starts at 1 and is incremented by every successful refresh, so
+ * readers can cheaply decide whether the view they hold is outdated.
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ */
+unsigned int kdbSnapshotGeneration (KdbSnapshot * snapshot)
+{
+	if (!snapshot) return 0;
+
+	snapshotLock (snapshot);
+	unsigned int generation = snapshot->generation;
+	snapshotUnlock (snapshot);
+	return generation;
+}
+
+/**
+ * Swaps up-to-date configuration into @p snapshot.
+ *
+ * Runs a kdbGet() on the calling thread (typically the one reacting to
+ * a change notification) and replaces the snapshot's data with the
+ * fresh generation. Views acquired before the swap stay valid and keep
+ * showing the old generation until they are released.
+ *
+ * @param snapshot  the snapshot to refresh
+ * @param handle    the handle the snapshot was created with
+ * @param parentKey the parent key the snapshot was created with
+ *
+ * @retval 1 a new generation was swapped in
+ * @retval 0 the backends reported no update, the snapshot is unchanged
+ * @retval -1 on failure - the snapshot keeps its current generation
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ */
+int kdbSnapshotRefresh (KdbSnapshot * snapshot, KDB * handle, Key * parentKey)
+{
+	if (!snapshot || !handle || !parentKey) return -1;
+
+	// the whole refresh runs under the lock: kdbGet reuses the master
+	// keyset (so unchanged backends keep their keys) and may touch
+	// reference counts of buffers shared with the current generation
+	snapshotLock (snapshot);
+	int ret = kdbGet (handle, snapshot->master, parentKey);
+	if (ret != 1)
+	{
+		snapshotUnlock (snapshot);
+		return ret;
+	}
+
+	KeySet * data = snapshotFreeze (snapshot->master, parentKey);
+	if (data == NULL)
+	{
+		snapshotUnlock (snapshot);
+		return -1;
+	}
+
+	KeySet * old = snapshot->data;
+	snapshot->data = data;
+	++snapshot->generation;
+	ksDel (old);
+	snapshotUnlock (snapshot);
+	return 1;
+}
+
+/**
+ * Frees @p snapshot.
+ *
+ * All views must have been released before, they share buffers with the
+ * snapshot's current generation.
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ */
+void kdbSnapshotDel (KdbSnapshot * snapshot)
+{
+	if (!snapshot) return;
+
+	ksDel (snapshot->data);
+	ksDel (snapshot->master);
+#ifdef ELEKTRA_HAVE_PTHREAD
+	pthread_mutex_destroy (&snapshot->lock);
+#endif
+	elektraFree (snapshot);
+}
+
 /**
  * @internal
  * @brief Does all set steps but not commit
@@ -1503,16 +2632,22 @@ error:
  * @param split all information for iteration
  * @param parentKey to add warnings (also passed to plugins for the same reason)
  * @param [out] errorKey may point to which key caused the error or 0 otherwise
+ * @param prepareEnd run the set plugins up to (excluding) this position;
+ *        COMMIT_PLUGIN for the full prepare phase, COMMIT_PLUGIN - 1 when the
+ *        precommit plugins run afterwards via elektraSetPrecommitParallel()
+ * @param [out] prepared when not NULL, prepared[i] is set to 1 for every
+ *        backend whose plugin chain actually ran (the resolver may skip it)
  *
  * @retval -1 on error
  * @retval 0 on success
  */
-static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, Plugin * hooks[][NR_GLOBAL_SUBPOSITIONS])
+static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, Plugin * hooks[][NR_GLOBAL_SUBPOSITIONS],
+			      size_t prepareEnd, int * prepared)
 {
 	int any_error = 0;
 	for (size_t i = 0; i < split->size; i++)
 	{
-		for (size_t p = 0; p < COMMIT_PLUGIN; ++p)
+		for (size_t p = 0; p < prepareEnd; ++p)
 		{
 			int ret = 0; // last return value
 
@@ -1547,6 +2682,12 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 						break;
 					}
 					keySetString (split->parents[i], keyString (parentKey));
+					// where the temporary file will be committed to,
+					// used for the commit journal of multi-backend
+					// transactions (see elektraSetJournalWrite())
+					keyCopyMeta (split->parents[i], parentKey, "commit/realfile");
+					keySetMeta (parentKey, "commit/realfile", NULL);
+					if (prepared != NULL) prepared[i] = 1;
 				}
 			}
 
@@ -1586,22 +2727,786 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 	return any_error;
 }
 
+#ifdef ELEKTRA_HAVE_PTHREAD
+typedef struct
+{
+	Split * split;	 /*!< the split this job belongs to */
+	size_t index;	 /*!< index of the backend within the split */
+	Key * parentKey; /*!< private parent key, so that plugins of different backends never share a key */
+	int running;	 /*!< whether a thread was started for this job */
+	int result;	 /*!< 0 on success, -1 on error */
+} ElektraSetBackendJob;
+
+static void * elektraSetPrecommitJob (void * data)
+{
+	ElektraSetBackendJob * job = data;
+	Split * split = job->split;
+	size_t i = job->index;
+	Plugin * plugin = split->handles[i]->setplugins[COMMIT_PLUGIN - 1];
+
+	ksRewind (split->keysets[i]);
+	job->result = plugin->kdbSet (plugin, split->keysets[i], job->parentKey) == -1 ? -1 : 0;
+	return NULL;
+}
+
 /**
  * @internal
- * @brief Does the commit
+ * @brief Runs the precommit plugins of all prepared backends concurrently
+ *
+ * Used instead of the precommit part of elektraSetPrepare() when the
+ * parallelset contract was given at kdbOpen(). The precommit position
+ * usually holds the sync plugin, whose fsync() dominates the latency of a
+ * commit; running it for independent backends on own threads bounds that
+ * latency by the slowest file instead of the sum of all files. Only the
+ * precommit position can be parallelized: the resolver holds a process wide
+ * mutex from prepare until commit, so the earlier positions have to stay on
+ * the calling thread. The caller must ensure that all mounted precommit
+ * plugins are reentrant before opting in.
  *
- * @param split all information for iteration
- * @param parentKey to add warnings (also passed to plugins for the same reason)
+ * @retval -1 on error
+ * @retval 0 on success
  */
-static void elektraSetCommit (Split * split, Key * parentKey)
+static int elektraSetPrecommitParallel (Split * split, Key * parentKey, const int * prepared)
 {
-	for (size_t p = COMMIT_PLUGIN; p < NR_OF_PLUGINS; ++p)
+	ElektraSetBackendJob * jobs = elektraCalloc (split->size * sizeof (ElektraSetBackendJob));
+	pthread_t * threads = elektraCalloc (split->size * sizeof (pthread_t));
+
+	for (size_t i = 0; i < split->size; i++)
 	{
-		for (size_t i = 0; i < split->size; i++)
+		Backend * backend = split->handles[i];
+		if (!prepared[i] || backend->setplugins[COMMIT_PLUGIN - 1] == NULL ||
+		    backend->setplugins[COMMIT_PLUGIN - 1]->kdbSet == NULL)
 		{
-			int ret = 0;
-			Backend * backend = split->handles[i];
-
+			continue;
+		}
+
+		jobs[i].split = split;
+		jobs[i].index = i;
+		// like in the serial prepare the value is the temporary file written by the resolver
+		jobs[i].parentKey = keyNew (keyName (split->parents[i]), KEY_VALUE, keyString (split->parents[i]), KEY_END);
+		jobs[i].running = pthread_create (&threads[i], NULL, elektraSetPrecommitJob, &jobs[i]) == 0;
+
+		if (!jobs[i].running)
+		{
+			// could not start a thread, do the work right here
+			elektraSetPrecommitJob (&jobs[i]);
+		}
+	}
+
+	int ret = 0;
+	for (size_t i = 0; i < split->size; i++)
+	{
+		if (jobs[i].running)
+		{
+			pthread_join (threads[i], NULL);
+		}
+
+		if (jobs[i].parentKey != NULL)
+		{
+			if (jobs[i].result == -1 && ret == 0)
+			{
+				// report the first failing backend
+				copyError (parentKey, jobs[i].parentKey);
+				ret = -1;
+			}
+			keyDel (jobs[i].parentKey);
+		}
+	}
+
+	elektraFree (threads);
+	elektraFree (jobs);
+	return ret;
+}
+#endif
+
+#ifdef HAVE_UNISTD_H
+/**
+ * @internal
+ * @brief Writes one copy of the commit journal atomically to @p name
+ *
+ * The content is first written and fsynced under a temporary name and then
+ * renamed into place, so a crash can never leave a torn journal behind.
+ *
+ * @retval 1 on success
+ * @retval 0 on failure
+ */
+static int elektraSetJournalWriteFile (Split * split, const char * name)
+{
+	char * tmpName = elektraFormat ("%s.tmp", name);
+	FILE * journal = fopen (tmpName, "w");
+	if (journal == NULL)
+	{
+		elektraFree (tmpName);
+		return 0;
+	}
+
+	int ok = fprintf (journal, "%s\n", ELEKTRA_COMMIT_JOURNAL_HEADER) > 0;
+	for (size_t i = 0; ok && i < split->size; i++)
+	{
+		const Key * realfile = keyGetMeta (split->parents[i], "commit/realfile");
+		if (realfile == NULL || keyString (split->parents[i])[0] == '\0') continue;
+		ok = fprintf (journal, "%s\n%s\n", keyString (split->parents[i]), keyString (realfile)) > 0;
+	}
+
+	if (ok) ok = fflush (journal) == 0 && fsync (fileno (journal)) == 0;
+	fclose (journal);
+	if (ok) ok = rename (tmpName, name) == 0;
+	if (!ok) unlink (tmpName);
+	elektraFree (tmpName);
+	return ok;
+}
+#endif
+
+/**
+ * @internal
+ * @brief Writes the commit journal for a commit spanning multiple backends
+ *
+ * The renames of elektraSetCommit() happen one after the other, so a crash
+ * in between leaves the backends in a mixed state. For commits involving at
+ * least two files this function therefore records all pending (temporary
+ * file, real file) pairs in a small journal before the first rename. One
+ * copy of the journal (a hard link where the filesystem allows it) is placed
+ * next to every involved configuration file, so whichever file is accessed
+ * first after a crash, the resolver finds the journal and finishes the
+ * renames of the whole transaction (see elektraJournalRecover() in the
+ * resolver plugin). After a successful commit the copies are removed again
+ * via elektraSetJournalRemove().
+ *
+ * The journal is best effort: when it cannot be written, the commit simply
+ * proceeds unjournaled like before, with a warning on @p parentKey.
+ *
+ * @returns a NULL terminated list of the journal file names,
+ *          or NULL when no journal was written
+ */
+static char ** elektraSetJournalWrite (Split * split, Key * parentKey ELEKTRA_UNUSED)
+{
+#ifdef HAVE_UNISTD_H
+	size_t count = 0;
+	for (size_t i = 0; i < split->size; i++)
+	{
+		if (keyGetMeta (split->parents[i], "commit/realfile") != NULL && keyString (split->parents[i])[0] != '\0') ++count;
+	}
+
+	// a commit of a single file is just one rename and atomic by itself
+	if (count < 2) return NULL;
+
+	char ** journalNames = elektraCalloc ((count + 1) * sizeof (char *));
+	size_t n = 0;
+	for (size_t i = 0; i < split->size && n < count; i++)
+	{
+		const Key * realfile = keyGetMeta (split->parents[i], "commit/realfile");
+		if (realfile == NULL || keyString (split->parents[i])[0] == '\0') continue;
+		journalNames[n] = elektraFormat ("%s%s", keyString (realfile), ELEKTRA_COMMIT_JOURNAL_SUFFIX);
+		++n;
+	}
+
+	if (!elektraSetJournalWriteFile (split, journalNames[0]))
+	{
+		ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not write commit journal '%s', committing without journal. Reason: %s",
+					       journalNames[0], strerror (errno));
+		for (size_t i = 0; i < count; i++)
+		{
+			elektraFree (journalNames[i]);
+		}
+		elektraFree (journalNames);
+		return NULL;
+	}
+
+	for (size_t i = 1; i < count; i++)
+	{
+		if (link (journalNames[0], journalNames[i]) == 0) continue;
+
+		// files on another filesystem cannot be hard linked, write a copy
+		if (!elektraSetJournalWriteFile (split, journalNames[i]))
+		{
+			ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not write commit journal copy '%s'. Reason: %s", journalNames[i],
+						       strerror (errno));
+		}
+	}
+
+	return journalNames;
+#else
+	(void) split;
+	return NULL;
+#endif
+}
+
+/**
+ * @internal
+ * @brief Removes the commit journal again after a successful commit
+ */
+static void elektraSetJournalRemove (char ** journalNames)
+{
+	if (journalNames == NULL) return;
+	for (size_t i = 0; journalNames[i] != NULL; i++)
+	{
+#ifdef HAVE_UNISTD_H
+		unlink (journalNames[i]);
+#endif
+		elektraFree (journalNames[i]);
+	}
+	elektraFree (journalNames);
+}
+
+/**
+ * @internal
+ * @brief Packs @p num into @p dest using the prefix-free varint encoding of
+ * the quickdump plugin
+ *
+ * The number of trailing zero bits in the first byte determines the total
+ * length: one byte for values below 2^7, up to nine bytes for a full
+ * 64 bit value.
+ *
+ * @returns the number of bytes written, at most 9
+ */
+static size_t elektraChangeJournalVarintPack (kdb_octet_t * dest, kdb_unsigned_long_long_t num)
+{
+	unsigned int len = 64 - __builtin_clzll (num | 1u);
+	len = 1 + (len - 1) / 7;
+
+	if (len > 8)
+	{
+		len = 9;
+		dest[0] = 0;
+	}
+	else
+	{
+		num = ((num << 1u) | 1u) << (len - 1);
+		dest[0] = num & 0xFFu;
+		num >>= 8u;
+	}
+
+	for (unsigned int i = 1; i < len; ++i)
+	{
+		dest[i] = num & 0xFFu;
+		num >>= 8u;
+	}
+	return len;
+}
+
+/**
+ * @internal
+ * @brief Counterpart to elektraChangeJournalVarintPack() reading from a buffer
+ *
+ * @retval 0 when the buffer ends before the varint does
+ * @retval 1 on success, with @p pos advanced past the varint
+ */
+static int elektraChangeJournalVarintParse (const kdb_octet_t * data, size_t size, size_t * pos, kdb_unsigned_long_long_t * result)
+{
+	if (*pos >= size) return 0;
+
+	const kdb_octet_t first = data[*pos];
+	unsigned int ctz = 0;
+	while (ctz < 8 && (first & (1u << ctz)) == 0)
+	{
+		++ctz;
+	}
+
+	unsigned int len = ctz == 8 ? 9 : ctz + 1;
+	if (*pos + len > size) return 0;
+
+	kdb_unsigned_long_long_t num = 0;
+	if (len == 9)
+	{
+		for (unsigned int i = 0; i < 8; ++i)
+		{
+			num |= (kdb_unsigned_long_long_t) data[*pos + 1 + i] << (i * 8u);
+		}
+	}
+	else
+	{
+		num = first >> len;
+		for (unsigned int i = 1; i < len; ++i)
+		{
+			num |= (kdb_unsigned_long_long_t) data[*pos + i] << (i * 8u - len);
+		}
+	}
+
+	*pos += len;
+	*result = num;
+	return 1;
+}
+
+/**
+ * @internal
+ * @brief Reads one varint from @p file
+ *
+ * @retval 0 on EOF or a truncated varint
+ * @retval 1 on success
+ */
+static int elektraChangeJournalVarintRead (FILE * file, kdb_unsigned_long_long_t * result)
+{
+	kdb_octet_t buf[9];
+
+	int c = fgetc (file);
+	if (c == EOF) return 0;
+	buf[0] = (kdb_octet_t) c;
+
+	unsigned int ctz = 0;
+	while (ctz < 8 && (buf[0] & (1u << ctz)) == 0)
+	{
+		++ctz;
+	}
+	unsigned int len = ctz == 8 ? 9 : ctz + 1;
+
+	if (len > 1 && fread (&buf[1], 1, len - 1, file) < len - 1) return 0;
+
+	size_t pos = 0;
+	return elektraChangeJournalVarintParse (buf, len, &pos, result);
+}
+
+/**
+ * @internal
+ * @brief 64 bit FNV-1a hash over the value of @p key
+ *
+ * Only meant to let journal consumers detect writes that did not actually
+ * change a value, not to be cryptographically strong.
+ */
+static kdb_unsigned_long_long_t elektraChangeJournalHash (const Key * key)
+{
+	kdb_unsigned_long_long_t hash = 0xcbf29ce484222325ULL;
+	const kdb_octet_t * data = keyValue (key);
+	ssize_t size = keyGetValueSize (key);
+	for (ssize_t i = 0; data != NULL && i < size; ++i)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/**
+ * @internal
+ * @brief Constructs the change journal file name for @p mountpoint
+ */
+static char * elektraChangeJournalFileName (KDB * handle, const Key * mountpoint)
+{
+	char * escaped = elektraStrDup (keyName (mountpoint));
+	for (char * p = escaped; *p != '\0'; ++p)
+	{
+		if (*p == '/' || *p == ':' || *p == '\\') *p = '_';
+	}
+	char * fileName = elektraFormat ("%s/%s%s", handle->changeJournalDir, escaped, ELEKTRA_CHANGE_JOURNAL_SUFFIX);
+	elektraFree (escaped);
+	return fileName;
+}
+
+/**
+ * @internal
+ * @brief Scans the records of an already opened change journal
+ *
+ * Leaves the newest sequence number in @p lastSeq and returns the offset
+ * directly behind the last complete record, so an append after a crash
+ * overwrites a torn tail instead of extending it.
+ */
+static long elektraChangeJournalScan (FILE * file, long fileSize, kdb_unsigned_long_long_t * lastSeq)
+{
+	long pos = sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1;
+	*lastSeq = 0;
+	while (pos < fileSize)
+	{
+		if (fseek (file, pos, SEEK_SET) != 0) break;
+		kdb_unsigned_long_long_t payloadLen;
+		if (!elektraChangeJournalVarintRead (file, &payloadLen)) break;
+		long payloadStart = ftell (file);
+		if (payloadStart < 0 || payloadStart + (long) payloadLen > fileSize) break;
+		kdb_unsigned_long_long_t seq;
+		if (!elektraChangeJournalVarintRead (file, &seq)) break;
+		*lastSeq = seq;
+		pos = payloadStart + (long) payloadLen;
+	}
+	return pos;
+}
+
+/**
+ * @internal
+ * @brief Rewrites the change journal, keeping only the bytes from
+ * @p keepFrom to @p end
+ *
+ * Like the commit journal this is best effort: the remaining records are
+ * written to a temporary file and renamed into place, on failure the
+ * journal is simply left as it is.
+ */
+static void elektraChangeJournalCompact (const char * fileName, FILE * file, long keepFrom, long end)
+{
+	char * tmpName = elektraFormat ("%s.tmp", fileName);
+	FILE * out = fopen (tmpName, "wb");
+	if (out == NULL)
+	{
+		elektraFree (tmpName);
+		return;
+	}
+
+	int ok = fwrite (ELEKTRA_CHANGE_JOURNAL_MAGIC, 1, sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1, out) ==
+		 sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1;
+	ok = ok && fseek (file, keepFrom, SEEK_SET) == 0;
+
+	char buffer[4096];
+	for (long pos = keepFrom; ok && pos < end;)
+	{
+		size_t chunk = (size_t) (end - pos) < sizeof (buffer) ? (size_t) (end - pos) : sizeof (buffer);
+		ok = fread (buffer, 1, chunk, file) == chunk && fwrite (buffer, 1, chunk, out) == chunk;
+		pos += (long) chunk;
+	}
+
+	ok = fclose (out) == 0 && ok;
+	if (ok) ok = rename (tmpName, fileName) == 0;
+	if (!ok) remove (tmpName);
+	elektraFree (tmpName);
+}
+
+/**
+ * @internal
+ * @brief Appends one delta record for the backend at index @p i of @p split
+ * to its change journal file
+ *
+ * The record carries the next sequence number, the mountpoint relative
+ * paths of all keys the backend just wrote together with a hash of their
+ * values, and a flag when keys were removed. When the file outgrows
+ * ELEKTRA_CHANGE_JOURNAL_MAX_SIZE, the oldest records are dropped.
+ *
+ * @retval 1 on success
+ * @retval 0 on failure
+ */
+static int elektraChangeJournalAppendBackend (KDB * handle, Split * split, size_t i)
+{
+	Key * parent = split->parents[i];
+	KeySet * ks = split->keysets[i];
+	// offset of the relative part in the name of a key below parent;
+	// only namespace roots already end in '/', everywhere else the
+	// separator after the parent name is skipped as well
+	size_t parentOffset = keyGetNameSize (parent);
+	if (keyName (parent)[parentOffset - 2] == '/') --parentOffset;
+
+	ssize_t oldSize = backendGetSize (split->handles[i], parent);
+
+	kdb_unsigned_long_long_t flags = 0;
+	if (oldSize >= 0 && ksGetSize (ks) < oldSize)
+	{
+		// keys were removed; which ones is unknown without the old state,
+		// so consumers have to do one full comparison for this record
+		flags |= 0x1u;
+	}
+
+	// first pass: count the written keys and size the payload
+	kdb_octet_t scratch[9];
+	kdb_unsigned_long_long_t count = 0;
+	size_t payloadSize = 0;
+	ssize_t ksSize = ksGetSize (ks);
+	for (elektraCursor it = 0; it < ksSize; ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+		if (!keyNeedSync (cur)) continue;
+		size_t nameSize = keyGetNameSize (cur);
+		size_t pathLen = nameSize <= parentOffset ? 0 : nameSize - 1 - parentOffset;
+		payloadSize += elektraChangeJournalVarintPack (scratch, pathLen) + pathLen;
+		payloadSize += elektraChangeJournalVarintPack (scratch, elektraChangeJournalHash (cur));
+		++count;
+	}
+
+	char * fileName = elektraChangeJournalFileName (handle, parent);
+	FILE * file = fopen (fileName, "r+b");
+	long fileSize = 0;
+	long end = sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1;
+	kdb_unsigned_long_long_t lastSeq = 0;
+
+	if (file != NULL)
+	{
+		char magic[sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1];
+		if (fread (magic, 1, sizeof (magic), file) != sizeof (magic) ||
+		    memcmp (magic, ELEKTRA_CHANGE_JOURNAL_MAGIC, sizeof (magic)) != 0 || fseek (file, 0, SEEK_END) != 0 ||
+		    (fileSize = ftell (file)) < 0)
+		{
+			// unknown format, start over
+			fclose (file);
+			file = NULL;
+			fileSize = 0;
+		}
+		else
+		{
+			end = elektraChangeJournalScan (file, fileSize, &lastSeq);
+		}
+	}
+
+	if (file == NULL)
+	{
+		file = fopen (fileName, "w+b");
+		if (file == NULL ||
+		    fwrite (ELEKTRA_CHANGE_JOURNAL_MAGIC, 1, sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1, file) !=
+			    sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1)
+		{
+			if (file != NULL) fclose (file);
+			elektraFree (fileName);
+			return 0;
+		}
+		end = fileSize = sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1;
+	}
+
+	kdb_unsigned_long_long_t seq = lastSeq + 1;
+	payloadSize += elektraChangeJournalVarintPack (scratch, seq);
+	payloadSize += elektraChangeJournalVarintPack (scratch, flags);
+	payloadSize += elektraChangeJournalVarintPack (scratch, count);
+
+	// second pass: build the record
+	kdb_octet_t * payload = elektraMalloc (payloadSize);
+	size_t off = 0;
+	off += elektraChangeJournalVarintPack (payload + off, seq);
+	off += elektraChangeJournalVarintPack (payload + off, flags);
+	off += elektraChangeJournalVarintPack (payload + off, count);
+	for (elektraCursor it = 0; it < ksSize; ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+		if (!keyNeedSync (cur)) continue;
+		size_t nameSize = keyGetNameSize (cur);
+		size_t pathLen = nameSize <= parentOffset ? 0 : nameSize - 1 - parentOffset;
+		off += elektraChangeJournalVarintPack (payload + off, pathLen);
+		memcpy (payload + off, keyName (cur) + parentOffset, pathLen);
+		off += pathLen;
+		off += elektraChangeJournalVarintPack (payload + off, elektraChangeJournalHash (cur));
+	}
+
+	kdb_octet_t lenBuf[9];
+	size_t lenLen = elektraChangeJournalVarintPack (lenBuf, payloadSize);
+
+	int ok = fseek (file, end, SEEK_SET) == 0 && fwrite (lenBuf, 1, lenLen, file) == lenLen &&
+		 fwrite (payload, 1, payloadSize, file) == payloadSize && fflush (file) == 0;
+	elektraFree (payload);
+
+	long newEnd = end + (long) lenLen + (long) payloadSize;
+	if (ok && (newEnd < fileSize || newEnd > ELEKTRA_CHANGE_JOURNAL_MAX_SIZE))
+	{
+		// overwrote a torn tail or outgrew the bound: rewrite the file,
+		// dropping the oldest records until at most half the bound remains
+		long keepFrom = sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1;
+		while (newEnd - keepFrom > ELEKTRA_CHANGE_JOURNAL_MAX_SIZE / 2)
+		{
+			if (fseek (file, keepFrom, SEEK_SET) != 0) break;
+			kdb_unsigned_long_long_t payloadLen;
+			if (!elektraChangeJournalVarintRead (file, &payloadLen)) break;
+			long next = ftell (file) + (long) payloadLen;
+			// always keep the newest record, even an oversized one
+			if (next >= newEnd) break;
+			keepFrom = next;
+		}
+		elektraChangeJournalCompact (fileName, file, keepFrom, newEnd);
+	}
+
+	fclose (file);
+	elektraFree (fileName);
+	return ok;
+}
+
+/**
+ * @internal
+ * @brief Appends the delta records of a successful commit to the change journal
+ *
+ * Has to run before splitUpdateSize() and before kdbSet() clears the sync
+ * flags, while the backend sizes of the previous get and the keys that were
+ * actually written are still recognizable. Like the commit journal this is
+ * best effort: when a record cannot be written, only a warning is added to
+ * @p parentKey.
+ *
+ * @see kdbJournalRead() for the record format and the reading side
+ */
+static void elektraChangeJournalAppend (KDB * handle, Split * split, Key * parentKey)
+{
+	for (size_t i = 0; i < split->size; i++)
+	{
+		if (!test_bit (split->syncbits[i], SPLIT_FLAG_SYNC)) continue;
+		if (!elektraChangeJournalAppendBackend (handle, split, i))
+		{
+			ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not append to change journal of '%s'. Reason: %s",
+						       keyName (split->parents[i]), strerror (errno));
+		}
+	}
+}
+
+/**
+ * Reads the change journal of @p mountpoint starting after sequence
+ * number @p since.
+ *
+ * When a KDB handle is opened with the system:/elektra/contract/journal
+ * contract key set (its value names a directory), every successful
+ * kdbSet() appends one compact record per committed backend to a journal
+ * file in that directory: a monotonically increasing sequence number, the
+ * mountpoint relative paths of the written keys and a hash of their
+ * values, reusing the varint framing of the quickdump plugin. A
+ * downstream consumer (e.g. a replicator) remembers the last sequence
+ * number it processed and periodically asks for everything newer, which
+ * is proportional to the number of changes instead of fetching and
+ * comparing the whole keyset.
+ *
+ * The returned keyset contains one key per changed path, named below
+ * @p mountpoint, with the metakeys `journal/seq` (decimal sequence number
+ * of the commit that wrote it) and `journal/hash` (hexadecimal FNV-1a
+ * hash of the value). When several commits changed the same path, only
+ * the newest record is kept. A commit that removed keys cannot name them
+ * individually; it is represented by the mountpoint key itself carrying
+ * the metakey `journal/removed`, and the consumer has to fall back to one
+ * full comparison.
+ *
+ * The journal file is bounded: when it grows too large, the oldest
+ * records are dropped. When @p since predates the oldest retained record,
+ * NULL is returned and the consumer has to do a full synchronization
+ * before resuming from @p lastSeq.
+ *
+ * @param handle     contains internal information of @link kdbOpen() opened @endlink key database
+ * @param mountpoint parent key of the mountpoint whose journal to read
+ * @param since      the last sequence number already processed, 0 for all
+ * @param lastSeq    when not NULL, set to the newest sequence number found
+ *                   in the journal, to be passed as @p since next time
+ *
+ * @return a newly allocated keyset with the changes after @p since,
+ *         empty when there are none
+ * @retval NULL when no journal is configured, the journal cannot be read,
+ *         or it no longer reaches back to @p since
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ * @see kdbSet() for the writing side
+ */
+KeySet * kdbJournalRead (KDB * handle, const Key * mountpoint, kdb_unsigned_long_long_t since, kdb_unsigned_long_long_t * lastSeq)
+{
+	if (!handle || !mountpoint || handle->changeJournalDir == NULL) return NULL;
+
+	char * fileName = elektraChangeJournalFileName (handle, mountpoint);
+	FILE * file = fopen (fileName, "rb");
+	elektraFree (fileName);
+	if (file == NULL) return NULL;
+
+	char magic[sizeof (ELEKTRA_CHANGE_JOURNAL_MAGIC) - 1];
+	long fileSize;
+	if (fread (magic, 1, sizeof (magic), file) != sizeof (magic) ||
+	    memcmp (magic, ELEKTRA_CHANGE_JOURNAL_MAGIC, sizeof (magic)) != 0 || fseek (file, 0, SEEK_END) != 0 ||
+	    (fileSize = ftell (file)) < 0)
+	{
+		fclose (file);
+		return NULL;
+	}
+
+	KeySet * ks = ksNew (0, KS_END);
+	kdb_unsigned_long_long_t newest = 0;
+	int first = 1;
+	int gap = 0;
+	int ok = 1;
+
+	long pos = sizeof (magic);
+	while (ok && pos < fileSize)
+	{
+		if (fseek (file, pos, SEEK_SET) != 0) break;
+		kdb_unsigned_long_long_t payloadLen;
+		if (!elektraChangeJournalVarintRead (file, &payloadLen)) break;
+		long payloadStart = ftell (file);
+		// an incomplete record is the torn tail of a crashed append, not an error
+		if (payloadStart < 0 || payloadLen == 0 || payloadStart + (long) payloadLen > fileSize) break;
+
+		kdb_octet_t * payload = elektraMalloc (payloadLen);
+		if (fread (payload, 1, payloadLen, file) != payloadLen)
+		{
+			elektraFree (payload);
+			break;
+		}
+
+		size_t off = 0;
+		kdb_unsigned_long_long_t seq = 0;
+		kdb_unsigned_long_long_t flags = 0;
+		kdb_unsigned_long_long_t count = 0;
+		ok = elektraChangeJournalVarintParse (payload, payloadLen, &off, &seq) &&
+		     elektraChangeJournalVarintParse (payload, payloadLen, &off, &flags) &&
+		     elektraChangeJournalVarintParse (payload, payloadLen, &off, &count);
+
+		if (ok && first)
+		{
+			first = 0;
+			// the oldest retained record has to connect to what the
+			// consumer already processed
+			if (seq > since + 1) gap = 1;
+		}
+		if (ok) newest = seq;
+
+		int wanted = ok && !gap && seq > since;
+		for (kdb_unsigned_long_long_t k = 0; ok && k < count; ++k)
+		{
+			kdb_unsigned_long_long_t pathLen;
+			kdb_unsigned_long_long_t hash;
+			ok = elektraChangeJournalVarintParse (payload, payloadLen, &off, &pathLen) && off + pathLen <= payloadLen;
+			if (!ok) break;
+			const char * path = (const char *) payload + off;
+			off += pathLen;
+			ok = elektraChangeJournalVarintParse (payload, payloadLen, &off, &hash);
+			if (!ok || !wanted) continue;
+
+			Key * key = keyNew (keyName (mountpoint), KEY_END);
+			if (pathLen > 0)
+			{
+				char * pathCopy = elektraMalloc (pathLen + 1);
+				memcpy (pathCopy, path, pathLen);
+				pathCopy[pathLen] = '\0';
+				keyAddName (key, pathCopy);
+				elektraFree (pathCopy);
+			}
+			else
+			{
+				// a change of the mountpoint key itself must not erase
+				// an earlier removal marker
+				Key * prev = ksLookup (ks, key, 0);
+				if (prev != NULL && keyGetMeta (prev, "journal/removed") != NULL)
+				{
+					keySetMeta (key, "journal/removed", "1");
+				}
+			}
+			char * str = elektraFormat ("%llu", (unsigned long long) seq);
+			keySetMeta (key, "journal/seq", str);
+			elektraFree (str);
+			str = elektraFormat ("%llx", (unsigned long long) hash);
+			keySetMeta (key, "journal/hash", str);
+			elektraFree (str);
+			ksAppendKey (ks, key);
+		}
+
+		if (wanted && ok && (flags & 0x1u) != 0)
+		{
+			Key * key = keyNew (keyName (mountpoint), KEY_END);
+			keySetMeta (key, "journal/removed", "1");
+			char * str = elektraFormat ("%llu", (unsigned long long) seq);
+			keySetMeta (key, "journal/seq", str);
+			elektraFree (str);
+			ksAppendKey (ks, key);
+		}
+
+		elektraFree (payload);
+		pos = payloadStart + (long) payloadLen;
+	}
+	fclose (file);
+
+	// an empty journal cannot prove continuity either
+	if (first && since > 0) gap = 1;
+
+	if (lastSeq != NULL) *lastSeq = newest;
+	if (!ok || gap)
+	{
+		ksDel (ks);
+		return NULL;
+	}
+	return ks;
+}
+
+/**
+ * @internal
+ * @brief Does the commit
+ *
+ * @param split all information for iteration
+ * @param parentKey to add warnings (also passed to plugins for the same reason)
+ */
+static void elektraSetCommit (Split * split, Key * parentKey)
+{
+	for (size_t p = COMMIT_PLUGIN; p < NR_OF_PLUGINS; ++p)
+	{
+		for (size_t i = 0; i < split->size; i++)
+		{
+			int ret = 0;
+			Backend * backend = split->handles[i];
+
 			if (backend->setplugins[p] && backend->setplugins[p]->kdbSet)
 			{
 				if (p != COMMIT_PLUGIN)
@@ -1718,6 +3623,24 @@ static void elektraSetRollback (Split * split, Key * parentKey)
  * If no key of a backend needs to be synced
  * any affairs to backends are omitted and 0 is returned.
  *
+ * @par Atomicity
+ * A commit first writes the temporary files of all involved backends and only
+ * then renames them into place one after the other. When more than one file is
+ * involved, a small journal is written before the first rename, so that a
+ * crash between the renames is finished by the resolver on the next access
+ * instead of leaving the files in a mixed state. With the
+ * `system:/elektra/contract/parallelset` contract the fsync() of the
+ * temporary files (the dominating latency of a commit) additionally runs for
+ * all backends in parallel.
+ *
+ * @par Write-behind
+ * With the `system:/elektra/contract/writebehind` contract kdbSet() only
+ * records the commit and returns immediately; the backends are written at
+ * most once per flush interval (the contract key's value, in milliseconds),
+ * on the next kdbGet(), on kdbFlush() or on kdbClose(). Use this for
+ * non-critical state that is updated at a high rate and call kdbFlush()
+ * wherever durability is actually needed.
+ *
  * @snippet kdbset.c set
  *
  * showElektraErrorDialog() and doElektraMerge() need to be implemented
@@ -1786,6 +3709,13 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 		return -1;
 	}
 
+	if (handle->writeBehindIntervalMs > 0 && (handle->writeBehind == NULL || !handle->writeBehind->flushing))
+	{
+		// write-behind contract: only record the commit, the disk write
+		// happens at most once per interval, see kdbFlush()
+		return elektraWriteBehindDefer (handle, ks, parentKey);
+	}
+
 	elektraNamespace ns = keyGetNamespace (parentKey);
 	Key * oldError = keyNew (keyName (parentKey), KEY_END);
 	copyError (oldError, parentKey);
@@ -1864,10 +3794,50 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	ELEKTRA_ASSERT (syncstate == 1, "syncstate not 1, but %d", syncstate);
 	ELEKTRA_LOG ("after 2.) Search for changed sizes");
 
+	for (size_t i = 0; i < split->size; i++)
+	{
+		if (test_bit (split->syncbits[i], SPLIT_FLAG_SYNC) && split->handles[i] != NULL && split->handles[i]->partialGet)
+		{
+			// the in-memory keyset misses the keys the storage plugin skipped,
+			// writing it out would silently drop them
+			clearError (parentKey); // clear previous error to set new one
+			ELEKTRA_SET_CONFLICTING_STATE_ERRORF (
+				parentKey,
+				"The backend %s was only partially read by the previous 'kdbGet()' (deep parent key), writing it would "
+				"lose the unread keys. Do a 'kdbGet()' with the mountpoint as parent key first",
+				keyName (split->parents[i]));
+			keySetName (parentKey, keyName (initialParent));
+			keyDel (initialParent);
+			splitDel (split);
+			errno = errnosave;
+			keyDel (oldError);
+			return -1;
+		}
+	}
+
 	splitPrepare (split);
 
 	clearError (parentKey); // clear previous error to set new one
-	if (elektraSetPrepare (split, parentKey, &errorKey, handle->globalPlugins) == -1)
+
+	elektraTimerBegin ("kdbSet/prepare");
+#ifdef ELEKTRA_HAVE_PTHREAD
+	int * prepared = handle->parallelSet ? elektraCalloc (split->size * sizeof (int)) : NULL;
+#else
+	int * prepared = NULL;
+#endif
+	size_t prepareEnd = prepared != NULL ? COMMIT_PLUGIN - 1 : COMMIT_PLUGIN;
+	int prepareRet = elektraSetPrepare (split, parentKey, &errorKey, handle->globalPlugins, prepareEnd, prepared);
+#ifdef ELEKTRA_HAVE_PTHREAD
+	if (prepareRet == 0 && prepared != NULL)
+	{
+		// all temporary files are written, now fsync them in parallel
+		prepareRet = elektraSetPrecommitParallel (split, parentKey, prepared);
+	}
+#endif
+	elektraFree (prepared);
+	elektraTimerEnd ("kdbSet/prepare");
+
+	if (prepareRet == -1)
 	{
 		goto error;
 	}
@@ -1882,12 +3852,26 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	elektraGlobalSet (handle, ks, parentKey, PRECOMMIT, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, PRECOMMIT, DEINIT);
 
+	// when the commit spans multiple files, make a crash between their renames recoverable
+	elektraTimerBegin ("kdbSet/commit");
+	char ** journalNames = elektraSetJournalWrite (split, parentKey);
+
 	elektraSetCommit (split, parentKey);
 
+	elektraSetJournalRemove (journalNames);
+	elektraTimerEnd ("kdbSet/commit");
+
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, INIT);
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, DEINIT);
 
+	if (handle->changeJournalDir != NULL)
+	{
+		elektraTimerBegin ("kdbSet/journal");
+		elektraChangeJournalAppend (handle, split, parentKey);
+		elektraTimerEnd ("kdbSet/journal");
+	}
+
 	splitUpdateSize (split);
 
 	keySetName (parentKey, keyName (initialParent));
@@ -1944,6 +3928,42 @@ error:
 	return -1;
 }
 
+/**
+ * Writes a commit deferred by the write-behind contract to disk.
+ *
+ * With the `system:/elektra/contract/writebehind` contract kdbSet() only
+ * records the commit and returns; this function is the explicit barrier
+ * that makes the recorded state durable. It is a cheap no-op when nothing
+ * is pending, so it is safe to call at every point that needs durability.
+ *
+ * Without the contract there is never anything to flush and 0 is returned.
+ *
+ * @param handle contains internal information of @link kdbOpen() opened @endlink key database
+ * @param parentKey used to add error information if the flush fails, may be NULL
+ *
+ * @retval 1 a pending commit was written
+ * @retval 0 nothing was pending
+ * @retval -1 the flush failed, an error was set on @p parentKey if possible
+ *
+ * @since 0.9.8
+ * @ingroup kdb
+ * @see kdbSet() for how commits become pending
+ */
+int kdbFlush (KDB * handle, Key * parentKey)
+{
+	if (handle == NULL)
+	{
+		if (parentKey != NULL)
+		{
+			clearError (parentKey);
+			ELEKTRA_SET_INTERFACE_ERROR (parentKey, "KDB handle null pointer passed");
+		}
+		return -1;
+	}
+
+	return elektraWriteBehindFlush (handle, parentKey);
+}
+
 /**
  * @}
  */
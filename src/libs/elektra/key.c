@@ -289,6 +289,10 @@ Key * keyVNew (const char * name, va_list va)
  * Since metadata uses copy-on-write semantics there is only a
  * constant memory cost to copying metadata.
  *
+ * When the existing name and value buffers of @p dest are big enough for
+ * the data of @p source, they are reused instead of reallocated, so
+ * repeatedly copying into the same Key does not stress the allocator.
+ *
  * When you pass a NULL-pointer as @p source the pieces of @p dest
  * specified by @p flags will be cleared.
  *
@@ -345,7 +349,16 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 		}
 		if (test_bit (flags, KEY_CP_META))
 		{
-			ksClear (dest->meta);
+			if (dest->meta != NULL && dest->meta->metaRefs > 0)
+			{
+				// shared with other keys -> just drop our reference
+				keyMetaRelease (dest->meta);
+				dest->meta = NULL;
+			}
+			else
+			{
+				ksClear (dest->meta);
+			}
 		}
 		return dest;
 	}
@@ -357,10 +370,33 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 	// remember original data of dest
 	Key orig = *dest;
 
+	// when the existing buffers of dest are big enough, the data is copied
+	// into them instead of allocating new ones, so copying keys in a loop
+	// does not churn the allocator; the actual memcpy happens after all
+	// allocations succeeded, see below
+	int reuseName = 0;
+	int reuseValue = 0;
+
 	// duplicate dynamic properties
 	if (test_bit (flags, KEY_CP_NAME))
 	{
-		if (source->key != NULL)
+		if (source->key != NULL && test_bit (source->flags, KEY_FLAG_MMAP_KEY))
+		{
+			// borrow the name from the mapped region instead of copying,
+			// a mutation materializes a private copy (see keySetName)
+			dest->key = source->key;
+			dest->keySize = source->keySize;
+			dest->ukey = source->ukey;
+			dest->keyUSize = source->keyUSize;
+			set_bit (dest->flags, KEY_FLAG_MMAP_KEY);
+		}
+		else if (source->key != NULL && !test_bit (orig.flags, KEY_FLAG_MMAP_KEY) && orig.key != NULL && orig.ukey != NULL &&
+			 orig.keySize >= source->keySize && orig.keyUSize >= source->keyUSize)
+		{
+			// both name buffers of dest can hold the new name
+			reuseName = 1;
+		}
+		else if (source->key != NULL)
 		{
 			dest->key = elektraMemDup (source->key, source->keySize);
 			if (!dest->key) goto memerror;
@@ -370,6 +406,7 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 			dest->ukey = elektraMemDup (source->ukey, source->keyUSize);
 			if (!dest->ukey) goto memerror;
 			dest->keyUSize = source->keyUSize;
+			clear_bit (dest->flags, KEY_FLAG_MMAP_KEY);
 		}
 		else
 		{
@@ -381,17 +418,56 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 			dest->ukey[1] = '\0';
 			dest->ukey[2] = '\0';
 			dest->keyUSize = 3;
+			clear_bit (dest->flags, KEY_FLAG_MMAP_KEY);
 		}
-		clear_bit (dest->flags, KEY_FLAG_MMAP_KEY);
+		if (!reuseName) keyUpdateNamePrefix (dest);
 	}
 
 	if (test_bit (flags, KEY_CP_STRING))
 	{
-		if (source->data.v != NULL)
+		if (test_bit (source->flags, KEY_FLAG_SMALL_DATA))
+		{
+			// inline value: copy the whole union
+			dest->data = source->data;
+			dest->dataSize = source->dataSize;
+			clear_bit (dest->flags, KEY_FLAG_MMAP_DATA);
+			set_bit (dest->flags, KEY_FLAG_SMALL_DATA);
+
+			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
+			{
+				keySetMeta (dest, "binary", "");
+			}
+		}
+		else if (source->data.v != NULL && test_bit (source->flags, KEY_FLAG_MMAP_DATA))
+		{
+			// borrow the value from the mapped region instead of copying
+			dest->data.v = source->data.v;
+			dest->dataSize = source->dataSize;
+			set_bit (dest->flags, KEY_FLAG_MMAP_DATA);
+			clear_bit (dest->flags, KEY_FLAG_SMALL_DATA);
+
+			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
+			{
+				keySetMeta (dest, "binary", "");
+			}
+		}
+		else if (source->data.v != NULL && !test_bit (orig.flags, KEY_FLAG_MMAP_DATA) &&
+			 !test_bit (orig.flags, KEY_FLAG_SMALL_DATA) && orig.data.v != NULL && orig.dataSize >= source->dataSize)
+		{
+			// the value buffer of dest can hold the new value
+			reuseValue = 1;
+
+			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
+			{
+				keySetMeta (dest, "binary", "");
+			}
+		}
+		else if (source->data.v != NULL)
 		{
 			dest->data.v = elektraMemDup (source->data.v, source->dataSize);
 			if (!dest->data.v) goto memerror;
 			dest->dataSize = source->dataSize;
+			clear_bit (dest->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
 
 			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
 			{
@@ -402,17 +478,55 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 		{
 			dest->data.v = NULL;
 			dest->dataSize = 0;
+			clear_bit (dest->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
 		}
-		clear_bit (dest->flags, KEY_FLAG_MMAP_DATA);
 	}
 
 	if (test_bit (flags, KEY_CP_VALUE))
 	{
-		if (source->data.v != NULL)
+		if (test_bit (source->flags, KEY_FLAG_SMALL_DATA))
+		{
+			// inline value: copy the whole union
+			dest->data = source->data;
+			dest->dataSize = source->dataSize;
+			clear_bit (dest->flags, KEY_FLAG_MMAP_DATA);
+			set_bit (dest->flags, KEY_FLAG_SMALL_DATA);
+
+			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
+			{
+				keySetMeta (dest, "binary", "");
+			}
+		}
+		else if (source->data.v != NULL && test_bit (source->flags, KEY_FLAG_MMAP_DATA))
+		{
+			// borrow the value from the mapped region instead of copying
+			dest->data.v = source->data.v;
+			dest->dataSize = source->dataSize;
+			set_bit (dest->flags, KEY_FLAG_MMAP_DATA);
+			clear_bit (dest->flags, KEY_FLAG_SMALL_DATA);
+
+			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
+			{
+				keySetMeta (dest, "binary", "");
+			}
+		}
+		else if (source->data.v != NULL && !test_bit (orig.flags, KEY_FLAG_MMAP_DATA) &&
+			 !test_bit (orig.flags, KEY_FLAG_SMALL_DATA) && orig.data.v != NULL && orig.dataSize >= source->dataSize)
+		{
+			// the value buffer of dest can hold the new value
+			reuseValue = 1;
+
+			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
+			{
+				keySetMeta (dest, "binary", "");
+			}
+		}
+		else if (source->data.v != NULL)
 		{
 			dest->data.v = elektraMemDup (source->data.v, source->dataSize);
 			if (!dest->data.v) goto memerror;
 			dest->dataSize = source->dataSize;
+			clear_bit (dest->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
 
 			if (!test_bit (flags, KEY_CP_META) && keyIsBinary (source))
 			{
@@ -423,16 +537,17 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 		{
 			dest->data.v = NULL;
 			dest->dataSize = 0;
+			clear_bit (dest->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
 		}
-		clear_bit (dest->flags, KEY_FLAG_MMAP_DATA);
 	}
 
 	if (test_bit (flags, KEY_CP_META))
 	{
 		if (source->meta != NULL)
 		{
-			dest->meta = ksDup (source->meta);
-			if (!dest->meta) goto memerror;
+			// share the whole KeySet instead of copying it,
+			// a later mutation of either key detaches it
+			dest->meta = keyMetaShare (source->meta);
 		}
 		else
 		{
@@ -440,21 +555,40 @@ Key * keyCopy (Key * dest, const Key * source, elektraCopyFlags flags)
 		}
 	}
 
+	// all allocations succeeded, the reused buffers may be overwritten now
+	if (reuseName)
+	{
+		memcpy (dest->key, source->key, source->keySize);
+		dest->keySize = source->keySize;
+		memcpy (dest->ukey, source->ukey, source->keyUSize);
+		dest->keyUSize = source->keyUSize;
+		keyUpdateNamePrefix (dest);
+	}
+	if (reuseValue)
+	{
+		memcpy (dest->data.v, source->data.v, source->dataSize);
+		dest->dataSize = source->dataSize;
+	}
+
 	// successful, now do the irreversible stuff: we obviously modified dest
 	set_bit (dest->flags, KEY_FLAG_SYNC);
 
 	// free old resources of destination
-	if (test_bit (flags, KEY_CP_NAME) && !test_bit (orig.flags, KEY_FLAG_MMAP_KEY)) elektraFree (orig.key);
-	if (test_bit (flags, KEY_CP_NAME) && !test_bit (orig.flags, KEY_FLAG_MMAP_KEY)) elektraFree (orig.ukey);
-	if (test_bit (flags, KEY_CP_VALUE) && !test_bit (orig.flags, KEY_FLAG_MMAP_DATA)) elektraFree (orig.data.c);
-	if (test_bit (flags, KEY_CP_META)) ksDel (orig.meta);
+	if (test_bit (flags, KEY_CP_NAME) && !reuseName && !test_bit (orig.flags, KEY_FLAG_MMAP_KEY)) elektraFree (orig.key);
+	if (test_bit (flags, KEY_CP_NAME) && !reuseName && !test_bit (orig.flags, KEY_FLAG_MMAP_KEY)) elektraFree (orig.ukey);
+	if (test_bit (flags, KEY_CP_VALUE) && !reuseValue && !test_bit (orig.flags, KEY_FLAG_MMAP_DATA) &&
+	    !test_bit (orig.flags, KEY_FLAG_SMALL_DATA))
+		elektraFree (orig.data.c);
+	if (test_bit (flags, KEY_CP_META)) keyMetaRelease (orig.meta);
 
 	return dest;
 
 memerror:
-	elektraFree (dest->key);
-	elektraFree (dest->data.v);
-	ksDel (dest->meta);
+	// buffers still shared with orig (e.g. when reusing them) must survive the rollback
+	if (!test_bit (dest->flags, KEY_FLAG_MMAP_KEY) && dest->key != orig.key) elektraFree (dest->key);
+	if (!test_bit (dest->flags, KEY_FLAG_MMAP_DATA) && !test_bit (dest->flags, KEY_FLAG_SMALL_DATA) && dest->data.v != orig.data.v)
+		elektraFree (dest->data.v);
+	keyMetaRelease (dest->meta);
 
 	*dest = orig;
 	return NULL;
@@ -464,7 +598,8 @@ static void keyClearNameValue (Key * key)
 {
 	if (key->key && !test_bit (key->flags, KEY_FLAG_MMAP_KEY)) elektraFree (key->key);
 	if (key->ukey && !test_bit (key->flags, KEY_FLAG_MMAP_KEY)) elektraFree (key->ukey);
-	if (key->data.v && !test_bit (key->flags, KEY_FLAG_MMAP_DATA)) elektraFree (key->data.v);
+	if (key->data.v && !test_bit (key->flags, KEY_FLAG_MMAP_DATA) && !test_bit (key->flags, KEY_FLAG_SMALL_DATA))
+		elektraFree (key->data.v);
 }
 
 
@@ -510,7 +645,7 @@ int keyDel (Key * key)
 
 	keyClearNameValue (key);
 
-	ksDel (key->meta);
+	keyMetaRelease (key->meta);
 
 	if (!keyInMmap)
 	{
@@ -565,7 +700,7 @@ int keyClear (Key * key)
 
 	keyClearNameValue (key);
 
-	ksDel (key->meta);
+	keyMetaRelease (key->meta);
 
 	keyInit (key);
 	if (keyStructInMmap) key->flags |= KEY_FLAG_MMAP_STRUCT;
@@ -39,3 +39,35 @@ void keyInit (Key * key)
 {
 	memset (key, 0, sizeof (Key));
 }
+
+/**
+ * @internal
+ *
+ * Refreshes the zero-padded prefix of the unescaped name cached inside
+ * the key struct. The prefix allows comparing keys without touching the
+ * ukey buffer, see keyCmp(). Also caches the offset where the basename
+ * starts, so keyBaseName() and friends need no backward scan.
+ *
+ * Must be called whenever key->ukey or key->keyUSize changes.
+ */
+void keyUpdateNamePrefix (Key * key)
+{
+	memset (key->ukeyPrefix, 0, sizeof (key->ukeyPrefix));
+	key->ukeyBaseOffset = 0;
+	if (key->ukey != NULL)
+	{
+		size_t size = key->keyUSize < sizeof (key->ukeyPrefix) ? key->keyUSize : sizeof (key->ukeyPrefix);
+		memcpy (key->ukeyPrefix, key->ukey, size);
+
+		if (key->keyUSize >= 3 && key->keyUSize <= UINT32_MAX)
+		{
+			// the basename starts after the last NUL separator
+			const char * base = key->ukey + key->keyUSize - 2;
+			while (*base != '\0')
+			{
+				--base;
+			}
+			key->ukeyBaseOffset = (uint32_t) (base + 1 - key->ukey);
+		}
+	}
+}
@@ -123,6 +123,127 @@
 #include <errno.h>
 #endif
 
+#ifdef ELEKTRA_HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+
+/** number of slots in the per-thread metadata intern table, must be a power of two */
+#define ELEKTRA_META_INTERN_SLOTS (256)
+
+/*
+ * Metadata keys are immutable once created (keySetMeta() marks their
+ * name, value and metadata read-only) and the same name=value pairs
+ * repeat across huge keysets: a `meta:/type = long` exists once per
+ * typed key. keySetMeta() therefore keeps a small recycling table of
+ * recently released metadata Keys and reuses a matching instance
+ * instead of allocating a fresh one per call.
+ *
+ * An instance is only handed out while the table holds the sole
+ * reference to it: metadata created by independent keySetMeta() calls
+ * must stay pairwise distinct Key objects (only keyCopyMeta() may
+ * share instances), so a Key currently held by any keyset is never
+ * returned again. This keeps the reuse unobservable to callers.
+ *
+ * The table is thread-local on purpose: reference counters of Keys are
+ * not atomic, so an interned Key must only ever be handed to keysets of
+ * the thread that owns it. The table is direct-mapped and bounded, a
+ * colliding pair simply evicts the previous tenant.
+ */
+#ifdef ELEKTRA_HAVE_PTHREAD
+static pthread_key_t metaInternDtorKey;
+static pthread_once_t metaInternOnce = PTHREAD_ONCE_INIT;
+static __thread Key ** metaInternTable = NULL;
+
+static void metaInternFreeTable (void * table)
+{
+	Key ** slots = table;
+	for (size_t i = 0; i < ELEKTRA_META_INTERN_SLOTS; ++i)
+	{
+		if (slots[i] != NULL)
+		{
+			keyDecRef (slots[i]);
+			keyDel (slots[i]);
+		}
+	}
+	elektraFree (slots);
+}
+
+static void metaInternInitDtor (void)
+{
+	pthread_key_create (&metaInternDtorKey, metaInternFreeTable);
+}
+
+static Key ** metaInternSlots (void)
+{
+	if (metaInternTable == NULL)
+	{
+		if (pthread_once (&metaInternOnce, metaInternInitDtor) != 0) return NULL;
+		metaInternTable = elektraCalloc (ELEKTRA_META_INTERN_SLOTS * sizeof (Key *));
+		if (metaInternTable == NULL) return NULL;
+		// so the references are dropped when the thread exits
+		pthread_setspecific (metaInternDtorKey, metaInternTable);
+	}
+	return metaInternTable;
+}
+#else
+static Key * metaInternStatic[ELEKTRA_META_INTERN_SLOTS];
+
+static Key ** metaInternSlots (void)
+{
+	return metaInternStatic;
+}
+#endif
+
+/**
+ * @internal
+ *
+ * Deduplicates the freshly created metadata Key @p toSet against the
+ * recycling table of the calling thread. Returns either @p toSet itself
+ * (now also referenced by the table) or an equal cached Key that no
+ * keyset holds anymore, in which case @p toSet has been deleted. The
+ * returned Key is ready to be appended to a metadata KeySet.
+ */
+static Key * metaIntern (Key * toSet)
+{
+	Key ** slots = metaInternSlots ();
+	if (slots == NULL) return toSet;
+
+	const char * value = keyDataPtr (toSet);
+
+	// FNV-1a over the escaped name and the value
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < toSet->keySize; ++i)
+	{
+		hash = (hash ^ (uint8_t) toSet->key[i]) * 16777619u;
+	}
+	for (size_t i = 0; i < toSet->dataSize; ++i)
+	{
+		hash = (hash ^ (uint8_t) value[i]) * 16777619u;
+	}
+
+	Key * cached = slots[hash & (ELEKTRA_META_INTERN_SLOTS - 1)];
+	if (cached != NULL && cached->ksReference == 1 && cached->keySize == toSet->keySize && cached->dataSize == toSet->dataSize &&
+	    memcmp (cached->key, toSet->key, toSet->keySize) == 0 && memcmp (keyDataPtr (cached), value, toSet->dataSize) == 0)
+	{
+		// an equal instance held by nothing but the table -> recycle it;
+		// a live instance is never returned again, so metadata created by
+		// independent keySetMeta() calls stays pairwise distinct
+		keyDel (toSet);
+		return cached;
+	}
+
+	if (cached != NULL)
+	{
+		// evict the previous tenant of the slot
+		keyDecRef (cached);
+		keyDel (cached);
+	}
+	keyIncRef (toSet);
+	slots[hash & (ELEKTRA_META_INTERN_SLOTS - 1)] = toSet;
+	return toSet;
+}
+
 
 /**
  * Rewind the internal iterator to the first entry in metadata keyset.
@@ -160,6 +281,9 @@ int keyRewindMeta (Key * key)
 	if (!key) return -1;
 	if (!key->meta) return 0;
 
+	// the cursor must not be shared with other keys
+	if (keyMetaDetach (key) == -1) return -1;
+
 	return ksRewind (key->meta);
 }
 
@@ -306,6 +430,7 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 	if (!source) return -1;
 	if (!dest) return -1;
 	if (dest->flags & KEY_FLAG_RO_META) return -1;
+	if (keyMetaDetach (dest) == -1) return -1;
 
 	ret = (Key *) keyGetMeta (source, metaName);
 
@@ -404,11 +529,14 @@ int keyCopyAllMeta (Key * dest, const Key * source)
 		/*Make sure that dest also does not have metaName*/
 		if (dest->meta)
 		{
+			if (keyMetaDetach (dest) == -1) return -1;
 			ksAppend (dest->meta, source->meta);
 		}
 		else
 		{
-			dest->meta = ksDup (source->meta);
+			// share the whole KeySet instead of copying it,
+			// a later mutation of either key detaches it
+			dest->meta = keyMetaShare (source->meta);
 		}
 		return 1;
 	}
@@ -464,7 +592,18 @@ const Key * keyGetMeta (const Key * key, const char * metaName)
 		keyAddName (search, metaName);
 	}
 
-	ret = ksLookup (key->meta, search, 0);
+	if (key->meta->metaRefs > 0)
+	{
+		// the metadata KeySet is shared with other keys (see
+		// keyMetaShare()), possibly owned by other threads through the
+		// views of a kdbSnapshot(); a regular ksLookup() would write to
+		// it (cursor, namespace slice index, OPMPHM predictor state)
+		ret = ksLookupReadOnly (key->meta, search);
+	}
+	else
+	{
+		ret = ksLookup (key->meta, search, 0);
+	}
 
 	keyDel (search);
 
@@ -521,6 +660,8 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	// optimization: we have nothing and want to remove something:
 	if (!key->meta && !newMetaString) return 0;
 
+	if (keyMetaDetach (key) == -1) return -1;
+
 	if (strncmp (metaName, "meta:/", sizeof ("meta:/") - 1) == 0)
 	{
 		toSet = keyNew (metaName, KEY_END);
@@ -548,19 +689,37 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	if (newMetaString != NULL)
 	{
 		/*Add the meta information to the key*/
-		metaStringDup = elektraMemDup (newMetaString, metaStringSize);
-		if (metaStringDup == NULL)
+		if ((size_t) metaStringSize <= sizeof (toSet->data.small))
 		{
-			// TODO: actually we might already have changed
-			// the key
-			keyDel (toSet);
-			return -1;
+			// store the value inline in the struct instead of on the heap
+			if (toSet->data.v && !test_bit (toSet->flags, KEY_FLAG_MMAP_DATA) && !test_bit (toSet->flags, KEY_FLAG_SMALL_DATA))
+			{
+				elektraFree (toSet->data.v);
+			}
+			memcpy (toSet->data.small, newMetaString, metaStringSize);
+			clear_bit (toSet->flags, (keyflag_t) KEY_FLAG_MMAP_DATA);
+			set_bit (toSet->flags, KEY_FLAG_SMALL_DATA);
+			toSet->dataSize = metaStringSize;
 		}
+		else
+		{
+			metaStringDup = elektraMemDup (newMetaString, metaStringSize);
+			if (metaStringDup == NULL)
+			{
+				// TODO: actually we might already have changed
+				// the key
+				keyDel (toSet);
+				return -1;
+			}
 
-		if (toSet->data.v && !test_bit (toSet->flags, KEY_FLAG_MMAP_DATA)) elektraFree (toSet->data.v);
-		clear_bit (toSet->flags, (keyflag_t) KEY_FLAG_MMAP_DATA);
-		toSet->data.c = metaStringDup;
-		toSet->dataSize = metaStringSize;
+			if (toSet->data.v && !test_bit (toSet->flags, KEY_FLAG_MMAP_DATA) && !test_bit (toSet->flags, KEY_FLAG_SMALL_DATA))
+			{
+				elektraFree (toSet->data.v);
+			}
+			clear_bit (toSet->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
+			toSet->data.c = metaStringDup;
+			toSet->dataSize = metaStringSize;
+		}
 	}
 	else
 	{
@@ -585,6 +744,9 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	set_bit (toSet->flags, KEY_FLAG_RO_VALUE);
 	set_bit (toSet->flags, KEY_FLAG_RO_META);
 
+	// recycle a released instance of a recurring name=value pair
+	toSet = metaIntern (toSet);
+
 	ksAppendKey (key->meta, toSet);
 	key->flags |= KEY_FLAG_SYNC;
 	return metaStringSize;
@@ -623,7 +785,77 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 KeySet * keyMeta (Key * key)
 {
 	if (!key) return 0;
+	if (keyMetaDetach (key) == -1) return 0;
 	if (!key->meta) key->meta = ksNew (0, KS_END);
 
 	return key->meta;
 }
+
+/**
+ * @internal
+ *
+ * Registers another owner of the metadata KeySet @p meta, so that
+ * keyDup()/keyCopy() can share it instead of copying it. The KeySet
+ * stays shared until one of its owners wants to mutate it and replaces
+ * it with a private copy via keyMetaDetach().
+ *
+ * @param meta the metadata KeySet to share, must not be NULL
+ *
+ * @return @p meta
+ */
+KeySet * keyMetaShare (KeySet * meta)
+{
+	meta->metaRefs = meta->metaRefs == 0 ? 2 : meta->metaRefs + 1;
+	return meta;
+}
+
+/**
+ * @internal
+ *
+ * Drops one owner of the metadata KeySet @p meta. Deletes the KeySet
+ * if it was exclusively owned, otherwise only decrements the sharing
+ * counter.
+ *
+ * @param meta the metadata KeySet to release, may be NULL
+ */
+void keyMetaRelease (KeySet * meta)
+{
+	if (meta == NULL) return;
+
+	if (meta->metaRefs > 0)
+	{
+		--meta->metaRefs;
+		if (meta->metaRefs == 1)
+		{
+			// only one owner left -> exclusively owned again
+			meta->metaRefs = 0;
+		}
+		return;
+	}
+
+	ksDel (meta);
+}
+
+/**
+ * @internal
+ *
+ * Ensures that the metadata KeySet of @p key is exclusively owned by
+ * @p key, so that it may be mutated. If the KeySet is shared with other
+ * keys, it is replaced by a private flat copy.
+ *
+ * @param key the key whose metadata is about to be mutated
+ *
+ * @retval  0 on success
+ * @retval -1 on memory error
+ */
+int keyMetaDetach (Key * key)
+{
+	if (key->meta == NULL || key->meta->metaRefs == 0) return 0;
+
+	KeySet * detached = ksDup (key->meta);
+	if (detached == NULL) return -1;
+
+	keyMetaRelease (key->meta);
+	key->meta = detached;
+	return 0;
+}
@@ -521,6 +521,7 @@ ssize_t keySetName (Key * key, const char * newName)
 	elektraRealloc ((void **) &key->ukey, key->keyUSize);
 
 	elektraKeyNameUnescape (key->key, key->ukey);
+	keyUpdateNamePrefix (key);
 
 	set_bit (key->flags, KEY_FLAG_SYNC);
 
@@ -609,6 +610,7 @@ ssize_t keyAddName (Key * key, const char * newName)
 	elektraRealloc ((void **) &key->ukey, key->keyUSize);
 
 	elektraKeyNameUnescape (key->key, key->ukey);
+	keyUpdateNamePrefix (key);
 
 	set_bit (key->flags, KEY_FLAG_SYNC);
 	return key->keySize;
@@ -701,6 +703,7 @@ int keyReplacePrefix (Key * key, const Key * oldPrefix, const Key * newPrefix)
 
 		key->ukey = elektraMemDup (newPrefix->ukey, newPrefix->keyUSize);
 		key->keyUSize = newPrefix->keyUSize;
+		keyUpdateNamePrefix (key);
 		return 1;
 	}
 
@@ -746,6 +749,7 @@ int keyReplacePrefix (Key * key, const Key * oldPrefix, const Key * newPrefix)
 
 	key->keySize = replacePrefix (&key->key, key->keySize, oldSize, newPrefix->key, newSize);
 	key->keyUSize = replacePrefix (&key->ukey, key->keyUSize, oldUSize, newPrefix->ukey, newUSize);
+	keyUpdateNamePrefix (key);
 
 	return 1;
 }
@@ -842,6 +846,45 @@ bool elektraKeyNameValidate (const char * name, bool isComplete)
 	return 1;
 }
 
+/**
+ * @brief Checks whether a validated key name is already canonical.
+ *
+ * Used as a fast path by elektraKeyNameCanonicalize(). The check is
+ * conservative: anything that needs a closer look (escape sequences,
+ * array parts, dot- and percent-parts) is reported as non-canonical
+ * and left to the full algorithm. Scanning between part separators is
+ * delegated to strcspn(), which processes multiple bytes per iteration
+ * on all common libcs.
+ *
+ * @param name key name without namespace prefix, starting at the root slash
+ *
+ * @retval true  @p name is its own canonical form
+ * @retval false @p name may need canonicalization
+ */
+static bool elektraKeyNameIsCanonical (const char * name)
+{
+	if (name[1] == '\0') return true; // root key
+
+	const char * cur = name;
+	while (*cur == '/')
+	{
+		++cur;
+		switch (*cur)
+		{
+		case '\0': // trailing slash
+		case '/':  // empty part
+		case '.':  // possible dot-part
+		case '%':  // possible empty part
+		case '#':  // possible non-canonical array part
+			return false;
+		}
+
+		cur += strcspn (cur, "/\\");
+		if (*cur == '\\') return false;
+	}
+	return *cur == '\0';
+}
+
 /**
  * Takes a valid (non-)canonical key name and produces its canonical form.
  * As a side-effect it can also calculate the size of the corresponding unescaped key name.
@@ -868,6 +911,25 @@ void elektraKeyNameCanonicalize (const char * name, char ** canonicalName, size_
 {
 	size_t nameLen = strlen (name) + 1;
 
+	// fast path: complete names that are already canonical are copied verbatim
+	if (offset == 0)
+	{
+		const char * root = *name == '/' ? name : strchr (name, ':') + 1;
+		if (elektraKeyNameIsCanonical (root))
+		{
+			*canonicalSizePtr = nameLen;
+			elektraRealloc ((void **) canonicalName, nameLen);
+			memcpy (*canonicalName, name, nameLen);
+
+			if (usizePtr != NULL)
+			{
+				// namespace byte + unescaped chars (no escapes present) + terminator
+				*usizePtr = nameLen - (root - name) + 1;
+			}
+			return;
+		}
+	}
+
 	// ensure output is at least as big as input
 	// output buffer will be enlarged when needed
 	// at the end we shrink to the correct size
@@ -1181,6 +1243,12 @@ void elektraKeyNameUnescape (const char * canonicalName, char * unescapedName)
 
 	while (*canonicalName != '\0')
 	{
+		// copy everything up to the next escape or part separator in one go
+		size_t chunk = strcspn (canonicalName, "\\/");
+		memcpy (outPtr, canonicalName, chunk);
+		outPtr += chunk;
+		canonicalName += chunk;
+
 		switch (*canonicalName)
 		{
 		case '\\':
@@ -1203,11 +1271,6 @@ void elektraKeyNameUnescape (const char * canonicalName, char * unescapedName)
 				++canonicalName;
 			}
 			break;
-		default:
-			// nothing special, just output
-			*outPtr++ = *canonicalName;
-			++canonicalName;
-			break;
 		}
 	}
 
@@ -1253,6 +1316,11 @@ const char * keyBaseName (const Key * key)
 	if (!key) return 0;
 	if (!key->key) return "";
 
+	if (key->ukeyBaseOffset > 0 && key->ukeyBaseOffset < key->keyUSize)
+	{
+		return key->ukey + key->ukeyBaseOffset;
+	}
+
 	const char * baseName = key->ukey + key->keyUSize - 2;
 	while (*baseName != '\0')
 	{
@@ -1439,16 +1507,30 @@ size_t elektraKeyNameEscapePart (const char * part, char ** escapedPart)
 
 	elektraRealloc ((void **) escapedPart, partLen + special + 1);
 
+	if (special == 0)
+	{
+		// the common case: nothing to escape, copy the part wholesale
+		memcpy (*escapedPart, part, partLen + 1);
+		return partLen;
+	}
+
+	// copy everything up to the next special character in one go
 	cur = part;
 	char * outPtr = *escapedPart;
-	while (*cur != '\0')
+	const char * next;
+	while ((next = strpbrk (cur, "/\\")) != NULL)
 	{
-		if (*cur == '/' || *cur == '\\')
-		{
-			*outPtr++ = '\\';
-		}
-		*outPtr++ = *cur++;
+		size_t chunk = next - cur;
+		memcpy (outPtr, cur, chunk);
+		outPtr += chunk;
+		*outPtr++ = '\\';
+		*outPtr++ = *next;
+		cur = next + 1;
 	}
+
+	size_t tail = part + partLen - cur;
+	memcpy (outPtr, cur, tail);
+	outPtr += tail;
 	*outPtr = '\0';
 
 	return outPtr - *escapedPart;
@@ -1514,6 +1596,7 @@ static size_t keyAddBaseNameInternal (Key * key, const char * baseName)
 		// for keySetBaseName
 		key->key[key->keySize - 1] = '\0';
 		key->ukey[key->keyUSize - 1] = '\0';
+		keyUpdateNamePrefix (key);
 
 		return key->keySize;
 	}
@@ -1550,6 +1633,7 @@ static size_t keyAddBaseNameInternal (Key * key, const char * baseName)
 	// set keyUSize and terminate escaped name
 	key->keyUSize += unescapedSize;
 	key->ukey[key->keyUSize - 1] = '\0';
+	keyUpdateNamePrefix (key);
 
 	set_bit (key->flags, KEY_FLAG_SYNC);
 	return key->keySize;
@@ -1666,10 +1750,18 @@ ssize_t keySetBaseName (Key * key, const char * baseName)
 	}
 	key->keySize = baseNamePtr - key->key + 1;
 
-	const char * ubaseNamePtr = key->ukey + key->keyUSize - 2;
-	while (*ubaseNamePtr != '\0')
+	const char * ubaseNamePtr;
+	if (key->ukeyBaseOffset > 0 && key->ukeyBaseOffset < key->keyUSize)
 	{
-		--ubaseNamePtr;
+		ubaseNamePtr = key->ukey + key->ukeyBaseOffset - 1;
+	}
+	else
+	{
+		ubaseNamePtr = key->ukey + key->keyUSize - 2;
+		while (*ubaseNamePtr != '\0')
+		{
+			--ubaseNamePtr;
+		}
 	}
 	key->keyUSize = ubaseNamePtr - key->ukey + 1;
 
@@ -1823,6 +1915,7 @@ ssize_t keySetNamespace (Key * key, elektraNamespace ns)
 	key->key[key->keySize - 1] = '\0';
 
 	key->ukey[0] = ns;
+	keyUpdateNamePrefix (key);
 
 	return key->keySize;
 }
@@ -34,6 +34,15 @@
 #include <kdbassert.h>
 #include <kdbrand.h>
 
+#if defined(ELEKTRA_ENABLE_OPTIMIZATIONS) && defined(ELEKTRA_HAVE_PTHREAD)
+#include <pthread.h>
+#include <unistd.h> // sysconf()
+#endif
+
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+#include <time.h> // clock_gettime()
+#endif
+
 
 #define ELEKTRA_MAX_PREFIX_SIZE sizeof ("namespace/")
 #define ELEKTRA_MAX_NAMESPACE_SIZE sizeof ("system")
@@ -51,9 +60,64 @@
  */
 static void elektraOpmphmInvalidate (KeySet * ks ELEKTRA_UNUSED)
 {
+	// the metadata index stores key positions, so it is invalidated at the same places
+	ksMetaIndexInvalidate (ks);
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	set_bit (ks->flags, KS_FLAG_NAME_CHANGE);
 	if (ks && ks->opmphm) opmphmClear (ks->opmphm);
+	if (ks)
+	{
+		ks->opmphmSize = 0;
+		ks->opmphmInsertCount = 0;
+	}
+#endif
+}
+
+/**
+ * @internal
+ *
+ * @brief Records an insert position instead of discarding the OPMPHM.
+ *
+ * Must be invoked by every function that inserts a Key into a KeySet.
+ * As long as the side-table has room, the build OPMPHM stays valid:
+ * elektraLookupOpmphmSearch() maps build-time indices to current
+ * positions with it and consults it for keys inserted after the build.
+ * On overflow the OPMPHM is discarded as before.
+ *
+ * @param ks the KeySet
+ * @param insertpos position of the freshly inserted Key in ks->array
+ */
+static void elektraOpmphmInsert (KeySet * ks ELEKTRA_UNUSED, size_t insertpos ELEKTRA_UNUSED)
+{
+	// inserting shifts key positions, so the metadata index is always discarded
+	ksMetaIndexInvalidate (ks);
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	set_bit (ks->flags, KS_FLAG_NAME_CHANGE);
+	if (!ks->opmphm || !opmphmIsBuild (ks->opmphm)) return;
+	if (ks->opmphmSize == 0 || ks->opmphmInsertCount >= OPMPHM_MAX_INSERTS)
+	{
+		elektraOpmphmInvalidate (ks);
+		return;
+	}
+	if (!ks->opmphmInserts)
+	{
+		ks->opmphmInserts = elektraMalloc (OPMPHM_MAX_INSERTS * sizeof (size_t));
+		if (!ks->opmphmInserts)
+		{
+			elektraOpmphmInvalidate (ks);
+			return;
+		}
+	}
+	// positions of previously inserted keys at or after insertpos
+	// shift by one, the table stays sorted
+	size_t i = ks->opmphmInsertCount;
+	while (i > 0 && ks->opmphmInserts[i - 1] >= insertpos)
+	{
+		ks->opmphmInserts[i] = ks->opmphmInserts[i - 1] + 1;
+		--i;
+	}
+	ks->opmphmInserts[i] = insertpos;
+	++ks->opmphmInsertCount;
 #endif
 }
 
@@ -99,10 +163,266 @@ static void elektraOpmphmCopy (KeySet * dest ELEKTRA_UNUSED, const KeySet * sour
 	if (dest->opmphm)
 	{
 		opmphmCopy (dest->opmphm, source->opmphm);
+		dest->opmphmSize = source->opmphmSize;
+		dest->opmphmInsertCount = 0;
+		if (source->opmphmInsertCount > 0)
+		{
+			if (!dest->opmphmInserts) dest->opmphmInserts = elektraMalloc (OPMPHM_MAX_INSERTS * sizeof (size_t));
+			if (dest->opmphmInserts)
+			{
+				memcpy (dest->opmphmInserts, source->opmphmInserts, source->opmphmInsertCount * sizeof (size_t));
+				dest->opmphmInsertCount = source->opmphmInsertCount;
+			}
+			else
+			{
+				elektraOpmphmInvalidate (dest);
+			}
+		}
 	}
 #endif
 }
 
+/**
+ * One entry of the inverted metadata index, see ksFindByMeta().
+ */
+typedef struct _KsMetaIndexEntry
+{
+	char * name;	    /**< Canonical metakey name (with `meta:/` prefix) */
+	size_t * positions; /**< Ascending positions of keys carrying the metakey */
+	size_t size;	    /**< Number of valid entries in positions */
+	size_t alloc;	    /**< Allocated number of entries in positions */
+} KsMetaIndexEntry;
+
+/**
+ * Inverted metadata index (metakey name -> key positions) of a KeySet,
+ * built lazily by ksFindByMeta().
+ */
+struct _KsMetaIndex
+{
+	KsMetaIndexEntry * entries; /**< One entry per distinct metakey name */
+	size_t size;		    /**< Number of valid entries */
+	size_t alloc;		    /**< Allocated number of entries */
+};
+
+/**
+ * @internal
+ *
+ * @brief Frees a metadata index and everything it owns.
+ *
+ * @param index the index to free
+ */
+static void metaIndexDel (struct _KsMetaIndex * index)
+{
+	for (size_t i = 0; i < index->size; ++i)
+	{
+		elektraFree (index->entries[i].name);
+		elektraFree (index->entries[i].positions);
+	}
+	elektraFree (index->entries);
+	elektraFree (index);
+}
+
+/**
+ * @internal
+ *
+ * @brief Finds the index entry for a metakey name.
+ *
+ * @param index the index to search
+ * @param name canonical metakey name
+ *
+ * @return the entry for @p name, or NULL if no key carries the metakey
+ */
+static KsMetaIndexEntry * metaIndexGetEntry (struct _KsMetaIndex * index, const char * name)
+{
+	for (size_t i = 0; i < index->size; ++i)
+	{
+		if (strcmp (index->entries[i].name, name) == 0) return &index->entries[i];
+	}
+	return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Records that the key at @p position carries the metakey @p name.
+ *
+ * @param index the index to extend
+ * @param name canonical metakey name
+ * @param position position of the key in the KeySet
+ *
+ * @retval 0 on success
+ * @retval -1 on memory problems
+ */
+static int metaIndexAddPosition (struct _KsMetaIndex * index, const char * name, size_t position)
+{
+	KsMetaIndexEntry * entry = metaIndexGetEntry (index, name);
+	if (!entry)
+	{
+		if (index->size == index->alloc)
+		{
+			index->alloc *= 2;
+			if (elektraRealloc ((void **) &index->entries, index->alloc * sizeof (KsMetaIndexEntry)) < 0) return -1;
+		}
+		entry = &index->entries[index->size];
+		entry->name = elektraStrDup (name);
+		if (!entry->name) return -1;
+		entry->size = 0;
+		entry->alloc = 4;
+		entry->positions = elektraMalloc (entry->alloc * sizeof (size_t));
+		if (!entry->positions)
+		{
+			elektraFree (entry->name);
+			return -1;
+		}
+		++index->size;
+	}
+
+	if (entry->size == entry->alloc)
+	{
+		entry->alloc *= 2;
+		if (elektraRealloc ((void **) &entry->positions, entry->alloc * sizeof (size_t)) < 0) return -1;
+	}
+	entry->positions[entry->size++] = position;
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * @brief Builds the inverted metadata index of a KeySet.
+ *
+ * Keys without any metadata only cost a single pointer check here,
+ * so building stays cheap for mostly meta-less KeySets.
+ *
+ * @param ks the KeySet to index
+ *
+ * @return the new index, or NULL on memory problems
+ */
+static struct _KsMetaIndex * metaIndexBuild (KeySet * ks)
+{
+	struct _KsMetaIndex * index = elektraMalloc (sizeof (struct _KsMetaIndex));
+	if (!index) return NULL;
+	index->size = 0;
+	index->alloc = 8;
+	index->entries = elektraMalloc (index->alloc * sizeof (KsMetaIndexEntry));
+	if (!index->entries)
+	{
+		elektraFree (index);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < ks->size; ++i)
+	{
+		const KeySet * meta = ks->array[i]->meta;
+		if (!meta) continue;
+		for (size_t j = 0; j < meta->size; ++j)
+		{
+			if (metaIndexAddPosition (index, keyName (meta->array[j]), i) == -1)
+			{
+				metaIndexDel (index);
+				return NULL;
+			}
+		}
+	}
+	return index;
+}
+
+/**
+ * @internal
+ *
+ * @brief Discards the inverted metadata index of a KeySet.
+ *
+ * Invoked whenever a Key is added to or removed from the KeySet, since the
+ * index stores key positions. Metadata added or removed via keySetMeta()
+ * after the index was built is not tracked automatically; call this function
+ * to force a rebuild on the next ksFindByMeta().
+ *
+ * @param ks the KeySet
+ */
+void ksMetaIndexInvalidate (KeySet * ks)
+{
+	if (!ks) return;
+	// every structural modification comes through here, so this doubles
+	// as the invalidation point for cached key positions
+	++ks->generation;
+	if (!ks->metaIndex) return;
+	metaIndexDel (ks->metaIndex);
+	ks->metaIndex = NULL;
+}
+
+/**
+ * @brief Finds the next Key in a KeySet carrying a given metakey.
+ *
+ * Searches for the first Key at or after @p startPos that has metadata
+ * with the name @p metaName. The name may be given with or without the
+ * `meta:/` namespace prefix, like for keyGetMeta().
+ *
+ * On the first call an inverted index (metakey name -> key positions) is
+ * built over the whole KeySet, so repeated queries do not rescan keys
+ * without metadata. The index is discarded whenever Keys are added to or
+ * removed from the KeySet. Metadata changed via keySetMeta() while the
+ * index exists is not reflected until ksMetaIndexInvalidate() is called.
+ *
+ * Iterate over all keys with a `type` metakey:
+ * @code
+for (elektraCursor it = ksFindByMeta (ks, "type", 0); it >= 0; it = ksFindByMeta (ks, "type", it + 1))
+{
+	Key * cur = ksAtCursor (ks, it);
+	// ...
+}
+ * @endcode
+ *
+ * @param ks the KeySet to search
+ * @param metaName name of the metakey to search for
+ * @param startPos position to start the search at
+ *
+ * @return position of the found Key
+ * @retval -1 if no Key at or after @p startPos carries the metakey
+ * @retval -1 on NULL pointers, invalid @p startPos or memory problems
+ */
+ssize_t ksFindByMeta (KeySet * ks, const char * metaName, elektraCursor startPos)
+{
+	if (!ks || !metaName) return -1;
+	if (startPos < 0 || (size_t) startPos >= ks->size) return -1;
+
+	if (!ks->metaIndex)
+	{
+		ks->metaIndex = metaIndexBuild (ks);
+		if (!ks->metaIndex) return -1;
+	}
+
+	// canonicalize the name the same way keyGetMeta() does
+	Key * search;
+	if (strncmp (metaName, "meta:/", sizeof ("meta:/") - 1) == 0)
+	{
+		search = keyNew (metaName, KEY_END);
+	}
+	else
+	{
+		search = keyNew ("meta:/", KEY_END);
+		keyAddName (search, metaName);
+	}
+	if (!search) return -1;
+
+	KsMetaIndexEntry * entry = metaIndexGetEntry (ks->metaIndex, keyName (search));
+	keyDel (search);
+	if (!entry) return -1;
+
+	// binary search for the first position >= startPos
+	size_t lo = 0;
+	size_t hi = entry->size;
+	while (lo < hi)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		if (entry->positions[mid] < (size_t) startPos)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == entry->size) return -1;
+	return entry->positions[lo];
+}
+
 /** @class doxygenFlatCopy
  *
  * @brief .
@@ -287,6 +607,212 @@ KeySet * ksVNew (size_t alloc, va_list va)
 	return keyset;
 }
 
+/**
+ * @internal
+ * A slab of arena memory. Slabs are chained, the most recently
+ * allocated one is carved from until it is exhausted.
+ */
+typedef struct _KsArenaSlab
+{
+	struct _KsArenaSlab * next; /**< older slabs */
+	size_t used;		    /**< bytes already carved from data */
+	size_t size;		    /**< usable bytes in data */
+	char data[];
+} KsArenaSlab;
+
+/**
+ * @internal
+ * Slab arena owned by a KeySet, see ksNewWithArena().
+ */
+struct _KsArena
+{
+	KsArenaSlab * slabs; /**< most recent slab first */
+	size_t slabSize;     /**< default size for new slabs */
+	char * scratch;	     /**< reused buffer for name canonicalization */
+	size_t scratchSize;  /**< allocated size of scratch */
+};
+
+/** @internal default slab size for ksNewWithArena (0) */
+#define KS_ARENA_SLABSIZE (64 * 1024)
+
+/**
+ * @internal
+ *
+ * Carves @p size bytes out of the arena, growing it by one slab if needed.
+ *
+ * With @p aligned the block (and the next carve) is aligned for any
+ * object type; without it the bytes are packed back to back, which is
+ * what the name and string value buffers use. The memory stays valid
+ * until the slabs are released.
+ *
+ * @retval 0 on allocation failure
+ */
+static void * ksArenaAllocEx (struct _KsArena * arena, size_t size, int aligned)
+{
+	if (aligned)
+	{
+		// keep carved blocks aligned for struct _Key
+		size = (size + (sizeof (void *) - 1)) & ~(sizeof (void *) - 1);
+	}
+
+	KsArenaSlab * slab = arena->slabs;
+	if (aligned && slab)
+	{
+		// packed carves may have left us misaligned
+		size_t used = (slab->used + (sizeof (void *) - 1)) & ~(sizeof (void *) - 1);
+		slab->used = used > slab->size ? slab->size : used;
+	}
+	if (!slab || slab->size - slab->used < size)
+	{
+		size_t slabSize = size > arena->slabSize ? size : arena->slabSize;
+		slab = elektraMalloc (sizeof (KsArenaSlab) + slabSize);
+		if (!slab) return 0;
+		slab->next = arena->slabs;
+		slab->used = 0;
+		slab->size = slabSize;
+		arena->slabs = slab;
+	}
+
+	void * mem = slab->data + slab->used;
+	slab->used += size;
+	return mem;
+}
+
+/**
+ * @internal
+ * Shorthand for an aligned carve, see ksArenaAllocEx().
+ */
+static void * ksArenaAlloc (struct _KsArena * arena, size_t size)
+{
+	return ksArenaAllocEx (arena, size, 1);
+}
+
+/**
+ * @internal
+ *
+ * Releases all slabs of @p arena, but keeps the arena reusable.
+ */
+static void ksArenaReleaseSlabs (struct _KsArena * arena)
+{
+	KsArenaSlab * slab = arena->slabs;
+	while (slab)
+	{
+		KsArenaSlab * next = slab->next;
+		elektraFree (slab);
+		slab = next;
+	}
+	arena->slabs = NULL;
+}
+
+/**
+ * Allocate a new KeySet with an attached slab arena.
+ *
+ * Keys created via ksArenaKeyNew() on such a KeySet are carved from
+ * contiguous slabs instead of individual allocations. This improves
+ * cache locality and cuts allocator traffic for bulk loads, e.g. in
+ * storage plugins creating hundreds of thousands of keys.
+ *
+ * The arena memory is released as a whole by ksDel(). Keys carved from
+ * the arena behave like keys from mmapstorage: modifying their name or
+ * value moves the affected buffer to the heap, but the key struct itself
+ * stays owned by the arena. Therefore such keys MUST NOT outlive the
+ * KeySet they were created for.
+ *
+ * @param slabSize size of the memory slabs in bytes, 0 for a default
+ *
+ * @return a new empty KeySet with arena support
+ * @retval 0 on memory error
+ *
+ * @see ksArenaKeyNew() for creating keys inside the arena
+ * @see ksDel() which releases the arena together with the KeySet
+ */
+KeySet * ksNewWithArena (size_t slabSize)
+{
+	KeySet * ks = ksNew (0, KS_END);
+	if (!ks) return 0;
+
+	ks->arena = elektraCalloc (sizeof (struct _KsArena));
+	if (!ks->arena)
+	{
+		ksDel (ks);
+		return 0;
+	}
+	ks->arena->slabSize = slabSize == 0 ? KS_ARENA_SLABSIZE : slabSize;
+
+	return ks;
+}
+
+/**
+ * Create a new Key inside the arena of @p ks and append it.
+ *
+ * Works like `ksAppendKey (ks, keyNew (name, KEY_VALUE, value, KEY_END))`,
+ * but the key struct, both name forms and the value are carved from the
+ * KeySet's arena, so the whole batch is freed in one shot by ksDel().
+ *
+ * @param ks a KeySet created with ksNewWithArena()
+ * @param name a valid key name
+ * @param value the string value of the key, may be NULL
+ *
+ * @return the appended key
+ * @retval 0 if @p ks has no arena, @p name is invalid or on memory error
+ *
+ * @see ksNewWithArena() for creating an arena-backed KeySet
+ */
+Key * ksArenaKeyNew (KeySet * ks, const char * name, const char * value)
+{
+	if (!ks || !ks->arena) return 0;
+	if (!name) return 0;
+
+	if (!elektraKeyNameValidate (name, true)) return 0;
+
+	struct _KsArena * arena = ks->arena;
+
+	size_t usize = 0;
+	elektraKeyNameCanonicalize (name, &arena->scratch, &arena->scratchSize, 0, &usize);
+
+	Key * key = ksArenaAlloc (arena, sizeof (struct _Key));
+	if (!key) return 0;
+	keyInit (key);
+
+	// the name forms and the value are plain byte buffers: pack them
+	// back to back instead of rounding each one up to pointer alignment
+	key->keySize = arena->scratchSize;
+	key->key = ksArenaAllocEx (arena, key->keySize, 0);
+	key->keyUSize = usize;
+	key->ukey = ksArenaAllocEx (arena, key->keyUSize, 0);
+	if (!key->key || !key->ukey) return 0;
+
+	memcpy (key->key, arena->scratch, key->keySize);
+	elektraKeyNameUnescape (key->key, key->ukey);
+	keyUpdateNamePrefix (key);
+
+	// the arena owns all buffers: free paths must skip them,
+	// mutation paths fall back to heap copies
+	key->flags = KEY_FLAG_SYNC | KEY_FLAG_MMAP_STRUCT | KEY_FLAG_MMAP_KEY | KEY_FLAG_MMAP_DATA;
+
+	if (value)
+	{
+		key->dataSize = elektraStrLen (value);
+		if (key->dataSize <= sizeof (key->data.small))
+		{
+			// small enough to live inline in the arena-allocated struct
+			memcpy (key->data.small, value, key->dataSize);
+			clear_bit (key->flags, (keyflag_t) KEY_FLAG_MMAP_DATA);
+			set_bit (key->flags, KEY_FLAG_SMALL_DATA);
+		}
+		else
+		{
+			key->data.c = ksArenaAllocEx (arena, key->dataSize, 0);
+			if (!key->data.c) return 0;
+			memcpy (key->data.c, value, key->dataSize);
+		}
+	}
+
+	if (ksAppendKey (ks, key) == -1) return 0;
+
+	return key;
+}
+
 /**
  * Return a duplicate of a KeySet.
  *
@@ -370,6 +896,122 @@ KeySet * ksDeepDup (const KeySet * source)
 	return keyset;
 }
 
+/**
+ * Return a copy-on-write duplicate of a KeySet.
+ *
+ * Like ksDeepDup() the result contains private Key objects, so the two
+ * KeySets can be modified independently. Unlike ksDeepDup() the payloads
+ * are not copied eagerly:
+ *
+ * - The name buffers are shared with the source keys. Key names are
+ *   read-only once a key is part of a KeySet, so sharing is safe. If a
+ *   duplicated key is popped and renamed, a private heap copy is
+ *   materialized first (same mechanism as for mmap()ed keys).
+ * - Metadata is shared via reference counting, exactly as keyCopy()
+ *   already does it. keySetMeta() on a duplicate materializes a private
+ *   meta key.
+ * - Values are copied, because they stay mutable through both handles
+ *   and the core has no per-buffer reference counting.
+ *
+ * This makes snapshotting large KeySets for concurrent readers
+ * considerably cheaper than a full deep copy.
+ *
+ * The source keys are kept alive by an internal reference, so the
+ * duplicate may outlive @p source. Keys of the duplicate however MUST
+ * NOT be moved into KeySets that outlive the duplicate.
+ *
+ * @param source has to be an initialized KeySet
+ *
+ * @return a copy-on-write copy of @p source on success
+ * @retval 0 on NULL pointer or memory error
+ *
+ * @see ksDeepDup() for an eager deep copy
+ * @see ksDup() for a flat copy sharing the Key objects
+ */
+KeySet * ksCowDup (const KeySet * source)
+{
+	if (!source) return 0;
+
+	KeySet * keyset = ksNew (source->alloc > 0 ? source->alloc - 1 : 0, KS_END);
+	if (!keyset) return 0;
+
+	for (size_t i = 0; i < source->size; ++i)
+	{
+		Key * k = source->array[i];
+		Key * d = elektraMalloc (sizeof (struct _Key));
+		if (!d)
+		{
+			ksDel (keyset);
+			return 0;
+		}
+		keyInit (d);
+
+		// share the name buffers, the source key stays the owner
+		d->key = k->key;
+		d->keySize = k->keySize;
+		d->ukey = k->ukey;
+		d->keyUSize = k->keyUSize;
+		keyUpdateNamePrefix (d);
+		d->flags = KEY_FLAG_MMAP_KEY;
+
+		if (test_bit (k->flags, KEY_FLAG_SMALL_DATA))
+		{
+			// inline value: copy the whole union
+			d->data = k->data;
+			d->dataSize = k->dataSize;
+			set_bit (d->flags, KEY_FLAG_SMALL_DATA);
+		}
+		else if (k->data.v)
+		{
+			d->data.v = elektraMalloc (k->dataSize);
+			if (!d->data.v)
+			{
+				keyDel (d);
+				ksDel (keyset);
+				return 0;
+			}
+			memcpy (d->data.v, k->data.v, k->dataSize);
+			d->dataSize = k->dataSize;
+		}
+
+		if (k->meta)
+		{
+			d->meta = keyMetaShare (k->meta);
+		}
+
+		if (test_bit (k->flags, KEY_FLAG_SYNC))
+		{
+			set_bit (d->flags, KEY_FLAG_SYNC);
+		}
+
+		// a read-only key stays read-only in the duplicate
+		set_bit (d->flags, k->flags & (KEY_FLAG_RO_NAME | KEY_FLAG_RO_VALUE | KEY_FLAG_RO_META));
+
+		if (ksAppendKey (keyset, d) == -1)
+		{
+			keyDel (d);
+			ksDel (keyset);
+			return 0;
+		}
+	}
+
+	// pin the source keys (and with them the shared name buffers)
+	// for the whole lifetime of the duplicate; when the source is itself
+	// a copy-on-write duplicate, its name buffers live in its own source,
+	// so the whole chain has to be pinned - otherwise a duplicate of a
+	// duplicate would dangle once the intermediate KeySet is deleted
+	keyset->cowSource = ksDup (source);
+	KeySet * pin = keyset->cowSource;
+	for (const KeySet * src = source; src->cowSource != NULL; src = src->cowSource)
+	{
+		pin->cowSource = ksDup (src->cowSource);
+		pin = pin->cowSource;
+	}
+
+	elektraOpmphmCopy (keyset, source);
+	return keyset;
+}
+
 
 /**
  * Replace the content of a KeySet with another one.
@@ -456,6 +1098,22 @@ int ksDel (KeySet * ks)
 
 	rc = ksClose (ks);
 
+	if (ks->arena)
+	{
+		ksArenaReleaseSlabs (ks->arena);
+		elektraFree (ks->arena->scratch);
+		elektraFree (ks->arena);
+		ks->arena = NULL;
+	}
+
+	if (ks->cowSource)
+	{
+		// release the pin on the source keys after our keys are gone
+		KeySet * source = ks->cowSource;
+		ks->cowSource = NULL;
+		ksDel (source);
+	}
+
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	if (ks->opmphm)
 	{
@@ -465,6 +1123,14 @@ int ksDel (KeySet * ks)
 	{
 		opmphmPredictorDel (ks->opmphmPredictor);
 	}
+	if (ks->opmphmInserts)
+	{
+		elektraFree (ks->opmphmInserts);
+	}
+	if (ks->lookupStats)
+	{
+		elektraFree (ks->lookupStats);
+	}
 
 #endif
 
@@ -496,6 +1162,17 @@ int ksClear (KeySet * ks)
 	ksClose (ks);
 	// ks->array empty now
 
+	// all arena keys are gone, reclaim their slabs but keep the arena usable
+	if (ks->arena) ksArenaReleaseSlabs (ks->arena);
+
+	if (ks->cowSource)
+	{
+		// no shared name buffers are referenced anymore
+		KeySet * source = ks->cowSource;
+		ks->cowSource = NULL;
+		ksDel (source);
+	}
+
 	if ((ks->array = elektraMalloc (sizeof (struct _Key *) * KEYSET_SIZE)) == 0)
 	{
 		ks->size = 0;
@@ -523,9 +1200,18 @@ static int keyCompareByName (const void * p1, const void * p2)
 	Key * k1 = *(Key **) p1;
 	Key * k2 = *(Key **) p2;
 
+	// most comparisons differ within the first few namespace/segment bytes,
+	// which are cached zero-padded inside the key struct; the zero padding
+	// keeps the sign consistent with the full comparison below
+	int cmp = memcmp (k1->ukeyPrefix, k2->ukeyPrefix, sizeof (k1->ukeyPrefix));
+	if (cmp != 0)
+	{
+		return cmp;
+	}
+
 	int k1Shorter = k1->keyUSize < k2->keyUSize;
 	size_t size = k1Shorter ? k1->keyUSize : k2->keyUSize;
-	int cmp = memcmp (k1->ukey, k2->ukey, size);
+	cmp = memcmp (k1->ukey, k2->ukey, size);
 	if (cmp != 0 || k1->keyUSize == k2->keyUSize)
 	{
 		return cmp;
@@ -785,6 +1471,9 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 		keyIncRef (toAppend);
 		ks->array[result] = toAppend;
 		ksSetCursor (ks, result);
+
+		/* the replacing key may carry different metadata */
+		ksMetaIndexInvalidate (ks);
 	}
 	else
 	{
@@ -834,7 +1523,7 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 			ks->array[insertpos] = toAppend;
 			ksSetCursor (ks, insertpos);
 		}
-		elektraOpmphmInvalidate (ks);
+		elektraOpmphmInsert (ks, (size_t) insertpos);
 	}
 
 	return ks->size;
@@ -883,11 +1572,217 @@ ssize_t ksAppend (KeySet * ks, const KeySet * toAppend)
 		;
 	ksResize (ks, toAlloc - 1);
 
-	/* TODO: here is lots of room for optimizations */
-	for (size_t i = 0; i < toAppend->size; ++i)
+	/* Both arrays are sorted, so instead of a binary search and a
+	 * memmove per key the two spans are merged in one linear pass.
+	 * This is what makes merging many backend keysets in splitMergeBackends()
+	 * cheap: runs of keys below one mountpoint are copied as a block. */
+	Key ** merged = elektraMalloc ((ks->size + toAppend->size + 1) * sizeof (Key *));
+	if (!merged)
+	{
+		/* fall back to the per-key path */
+		for (size_t i = 0; i < toAppend->size; ++i)
+		{
+			ksAppendKey (ks, toAppend->array[i]);
+		}
+		return ks->size;
+	}
+
+	size_t i = 0;
+	size_t j = 0;
+	size_t out = 0;
+	ssize_t lastAppended = -1;
+	int replaced = 0;
+	int inserted = 0;
+	while (i < ks->size && j < toAppend->size)
+	{
+		int cmp = keyCompareByName (&ks->array[i], &toAppend->array[j]);
+		if (cmp < 0)
+		{
+			merged[out++] = ks->array[i++];
+		}
+		else if (cmp > 0)
+		{
+			Key * k = toAppend->array[j++];
+			keyLock (k, KEY_LOCK_NAME);
+			keyIncRef (k);
+			lastAppended = out;
+			merged[out++] = k;
+			inserted = 1;
+		}
+		else
+		{
+			/* same name: like in ksAppendKey() the appended key wins */
+			Key * old = ks->array[i++];
+			Key * k = toAppend->array[j++];
+			if (old != k)
+			{
+				keyDecRef (old);
+				keyDel (old);
+				keyLock (k, KEY_LOCK_NAME);
+				keyIncRef (k);
+				replaced = 1;
+			}
+			lastAppended = out;
+			merged[out++] = k;
+		}
+	}
+	while (i < ks->size)
 	{
-		ksAppendKey (ks, toAppend->array[i]);
+		merged[out++] = ks->array[i++];
+	}
+	while (j < toAppend->size)
+	{
+		Key * k = toAppend->array[j++];
+		keyLock (k, KEY_LOCK_NAME);
+		keyIncRef (k);
+		lastAppended = out;
+		merged[out++] = k;
+		inserted = 1;
+	}
+
+	memcpy (ks->array, merged, out * sizeof (Key *));
+	ks->array[out] = 0;
+	ks->size = out;
+	elektraFree (merged);
+
+	/* the replacing keys may carry different metadata */
+	if (replaced) ksMetaIndexInvalidate (ks);
+	/* replacements keep names and positions, so the OPMPHM stays valid;
+	 * only actual insertions discard it, like in ksAppendKey() */
+	if (inserted) elektraOpmphmInvalidate (ks);
+	if (lastAppended >= 0) ksSetCursor (ks, lastAppended);
+
+	return ks->size;
+}
+
+/** @internal Key pointer plus its insertion rank for the stable batch sort. */
+typedef struct
+{
+	Key * key;
+	size_t order;
+} KsBatchEntry;
+
+/**
+ * @internal
+ *
+ * @brief Compares batch entries by key name, ties broken by insertion rank.
+ */
+static int ksBatchCompare (const void * p1, const void * p2)
+{
+	const KsBatchEntry * e1 = p1;
+	const KsBatchEntry * e2 = p2;
+	int cmp = keyCompareByName (&e1->key, &e2->key);
+	if (cmp != 0) return cmp;
+	return e1->order < e2->order ? -1 : 1;
+}
+
+/**
+ * Append an array of Keys to @p ks in one pass.
+ *
+ * Semantically equivalent to calling ksAppendKey() for every element of
+ * @p keys, but instead of a binary search and a memmove per key the
+ * whole batch is merged with a single sort and deduplication pass. For
+ * storage plugins creating large, not necessarily sorted key streams
+ * this turns the quadratic worst case of repeated inserts into
+ * O((n+m)·log (n+m)).
+ *
+ * Like with ksAppendKey() ownership of the keys is transferred to @p ks:
+ * keys that lose against a later key with the same name are deleted
+ * (unless still referenced elsewhere), the later key wins.
+ *
+ * @param ks the KeySet to append to
+ * @param keys array of @p n Key pointers, need not be sorted
+ * @param n number of keys in @p keys
+ *
+ * @return the size of the KeySet after appending
+ * @retval -1 on NULL pointers or memory error
+ *
+ * @see ksAppendKey() for appending a single Key
+ * @see ksAppend() for appending a whole KeySet
+ */
+ssize_t ksAppendBatch (KeySet * ks, Key ** keys, size_t n)
+{
+	if (!ks) return -1;
+	if (!keys && n > 0) return -1;
+	if (n == 0) return ks->size;
+
+	size_t origSize = ks->size;
+	KsBatchEntry * entries = elektraMalloc ((origSize + n) * sizeof (KsBatchEntry));
+	if (!entries) return -1;
+
+	size_t m = 0;
+	for (size_t i = 0; i < origSize; ++i)
+	{
+		entries[m].key = ks->array[i];
+		entries[m].order = m;
+		++m;
+	}
+	for (size_t i = 0; i < n; ++i)
+	{
+		Key * k = keys[i];
+		if (!k) continue;
+		if (!k->key)
+		{
+			// needed for ksAppendBatch with keyNew(0) members
+			keyDel (k);
+			continue;
+		}
+		keyLock (k, KEY_LOCK_NAME);
+		entries[m].key = k;
+		entries[m].order = m;
+		++m;
+	}
+
+	if (ksResize (ks, origSize + n) == -1)
+	{
+		elektraFree (entries);
+		return -1;
+	}
+
+	qsort (entries, m, sizeof (KsBatchEntry), ksBatchCompare);
+
+	size_t out = 0;
+	size_t i = 0;
+	while (i < m)
+	{
+		// find the run of equal names, the last entry wins
+		size_t j = i;
+		while (j + 1 < m && keyCompareByName (&entries[j].key, &entries[j + 1].key) == 0)
+		{
+			++j;
+		}
+		Key * survivor = entries[j].key;
+
+		int refCarried = 0;
+		for (size_t d = i; d < j; ++d)
+		{
+			Key * dropped = entries[d].key;
+			if (dropped == survivor)
+			{
+				// same identity, its reference carries over
+				if (entries[d].order < origSize) refCarried = 1;
+				continue;
+			}
+			if (entries[d].order < origSize) keyDecRef (dropped);
+			keyDel (dropped);
+		}
+
+		if (entries[j].order >= origSize && !refCarried)
+		{
+			keyIncRef (survivor);
+		}
+
+		ks->array[out++] = survivor;
+		i = j + 1;
 	}
+
+	ks->array[out] = 0;
+	ks->size = out;
+	elektraFree (entries);
+
+	ksRewind (ks);
+	elektraOpmphmInvalidate (ks);
+
 	return ks->size;
 }
 
@@ -1000,11 +1895,39 @@ ssize_t ksRename (KeySet * ks, const Key * root, const Key * newRoot)
 		return renamed;
 	}
 
+	// determine where newRoot belongs in the sort order, while the array
+	// is still sorted (newStart only says "not found" here)
+	ssize_t insertSearch = ksSearchInternal (ks, newRoot);
+	size_t insert = insertSearch < 0 ? (size_t) (-insertSearch - 1) : (size_t) insertSearch;
+
 	// rename everything below root
 	size_t renamed = ksRenameInternal (ks, start, end, root, newRoot);
 
-	// fix order and invalidate hashmap after renaming
-	qsort (ks->array, ks->size, sizeof (struct _Key *), keyCompareByName);
+	// The renamed keys kept their relative order: they all received the
+	// same new prefix and their suffixes are untouched. So instead of
+	// re-sorting the whole array, the span is only moved to the position
+	// where newRoot belongs; the rest of the array stays as it is.
+	// insert was computed before the rename, so it still refers to
+	// positions in the old array layout.
+	if (insert > (size_t) end)
+	{
+		Key ** span = elektraMalloc (renamed * sizeof (struct _Key *));
+		elektraMemcpy (span, ks->array + start, renamed);
+		elektraMemmove (ks->array + start, ks->array + end, insert - end);
+		elektraMemcpy (ks->array + insert - renamed, span, renamed);
+		elektraFree (span);
+	}
+	else if (insert < start)
+	{
+		Key ** span = elektraMalloc (renamed * sizeof (struct _Key *));
+		elektraMemcpy (span, ks->array + start, renamed);
+		elektraMemmove (ks->array + insert + renamed, ks->array + insert, start - insert);
+		elektraMemcpy (ks->array + insert, span, renamed);
+		elektraFree (span);
+	}
+	// otherwise newRoot sorts into the renamed span itself and the span
+	// already sits exactly where the renamed keys belong
+
 	elektraOpmphmInvalidate (ks);
 
 	return renamed;
@@ -1100,8 +2023,10 @@ elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCurso
 			// we just increment the namespace byte and search
 			// for the next theoretically possible namespace
 			root->ukey[0]++;
+			keyUpdateNamePrefix ((Key *) root);
 			ssize_t endSearch = ksSearchInternal (ks, root);
 			root->ukey[0]--;
+			keyUpdateNamePrefix ((Key *) root);
 			*end = endSearch < 0 ? -endSearch - 1 : endSearch;
 		}
 		else
@@ -1109,10 +2034,14 @@ elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCurso
 			// Very much a HACK to avoid allocating a new key name
 			// Overwriting the null terminator works fine, because
 			// all accesses to root->ukey inside of ksSearchInternal()
-			// use root->keyUSize explicitly.
+			// use root->keyUSize explicitly. The cached name prefix
+			// must be refreshed, because it covers the mutated byte
+			// for short names.
 			root->ukey[root->keyUSize - 1] = '\1';
+			keyUpdateNamePrefix ((Key *) root);
 			ssize_t endSearch = ksSearchInternal (ks, root);
 			root->ukey[root->keyUSize - 1] = '\0';
+			keyUpdateNamePrefix ((Key *) root);
 			*end = endSearch < 0 ? -endSearch - 1 : endSearch;
 		}
 	}
@@ -1120,6 +2049,169 @@ elektraCursor ksFindHierarchy (const KeySet * ks, const Key * root, elektraCurso
 	return it;
 }
 
+/**
+ * Finds the next child hierarchy of @p root in a KeySet.
+ *
+ * The children of @p root are iterated one level deep: for every direct
+ * child (including children that only exist implicitly, because keys
+ * below them exist) the position of its first key in @p ks is returned.
+ * Grandchildren are skipped with a binary search on the child prefix, so
+ * listing all children takes O(children * log n) and neither copies nor
+ * allocates, in contrast to filtering a ksBelow() copy or using ksCut().
+ *
+ * Typical use for a directory listing:
+ * @code
+ * for (elektraCursor it = ksFindNextChild (ks, root, 0); it >= 0; it = ksFindNextChild (ks, root, it + 1))
+ * {
+ * 	Key * first = ksAtCursor (ks, it);
+ * 	// the name of the child is the first part of first's name below root
+ * }
+ * @endcode
+ *
+ * If the key directly before @p pos belongs to the same child hierarchy
+ * as the key at @p pos, that hierarchy counts as already visited and is
+ * skipped. This is what makes the loop above return every child once.
+ *
+ * @param ks   The keyset to search in
+ * @param root The parent whose children are iterated
+ * @param pos  The position to continue the iteration at
+ *
+ * @return the position of the first key of the next child hierarchy
+ * @retval -1 if there is no further child, if @p pos is negative or
+ *         if @p ks or @p root are NULL
+ */
+elektraCursor ksFindNextChild (const KeySet * ks, const Key * root, elektraCursor pos)
+{
+	if (ks == NULL || root == NULL || pos < 0) return -1;
+
+	elektraCursor end;
+	elektraCursor start = ksFindHierarchy (ks, root, &end);
+	if (start < 0 || start >= end) return -1;
+
+	elektraCursor it = pos > start ? pos : start;
+	if (it < end && keyCmp (root, ks->array[it]) == 0) ++it;
+	if (it >= end) return -1;
+
+	const Key * cur = ks->array[it];
+
+	// size of the unescaped name of the direct child cur belongs to; for
+	// root keys the first part starts after the namespace byte and the
+	// empty first part, for all other keys after the root name itself
+	size_t childOffset = root->keyUSize == 3 ? 2 : root->keyUSize;
+	const char * partEnd = memchr (cur->ukey + childOffset, '\0', cur->keyUSize - childOffset);
+	if (partEnd == NULL) return -1;
+	size_t childUSize = (partEnd - cur->ukey) + 1;
+
+	// if the previous key is part of the same child hierarchy, the hierarchy
+	// was already visited and we skip it with a binary search on the prefix
+	const Key * prev = it > start ? ks->array[it - 1] : NULL;
+	if (prev != NULL && prev->keyUSize >= childUSize && memcmp (prev->ukey, cur->ukey, childUSize) == 0)
+	{
+		size_t lo = it + 1;
+		size_t hi = end;
+		while (lo < hi)
+		{
+			size_t mid = lo + (hi - lo) / 2;
+			const Key * k = ks->array[mid];
+			if (k->keyUSize >= childUSize && memcmp (k->ukey, cur->ukey, childUSize) == 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		it = lo;
+		if (it >= end) return -1;
+	}
+
+	return it;
+}
+
+/**
+ * Serializes the keys in the range [@p start, @p end) of @p ks into a
+ * caller provided buffer, so that language bindings can fetch the names,
+ * values and metadata of many keys with a single native call.
+ *
+ * The buffer holds one record per key. All integers are `uint32_t` in the
+ * native byte order of the platform:
+ *
+ * - name size (includes the null terminator)
+ * - value size (string values include the null terminator)
+ * - 1 if the value is binary, 0 otherwise
+ * - number of metakeys
+ * - the key name
+ * - the key value
+ * - per metakey: name size, value size, followed by the metakey name
+ *   (e.g. "meta:/type") and value, both with null terminator
+ *
+ * With @p buffer NULL the required buffer size for the range is returned,
+ * so callers can allocate (or reuse) a buffer of the right size and then
+ * call again.
+ *
+ * @param ks     the keyset to serialize
+ * @param start  index of the first key
+ * @param end    index after the last key, clamped to the size of @p ks
+ * @param buffer the target buffer, or NULL to query the required size
+ * @param size   the size of @p buffer in bytes
+ *
+ * @retval -1 if @p ks is NULL, the range is invalid or @p buffer is too small
+ * @return the number of bytes written, or needed if @p buffer is NULL
+ */
+ssize_t elektraKsSerialize (KeySet * ks, elektraCursor start, elektraCursor end, void * buffer, size_t size)
+{
+	if (ks == NULL || start < 0) return -1;
+	if (end > (elektraCursor) ks->size) end = ks->size;
+	if (start > end) return -1;
+
+	size_t needed = 0;
+	char * out = buffer;
+
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		Key * cur = ks->array[it];
+		KeySet * meta = keyMeta (cur);
+		ssize_t metaCount = ksGetSize (meta);
+
+		uint32_t header[4];
+		header[0] = (uint32_t) keyGetNameSize (cur);
+		header[1] = keyValue (cur) == NULL ? 0 : (uint32_t) keyGetValueSize (cur);
+		header[2] = keyIsBinary (cur) ? 1 : 0;
+		header[3] = (uint32_t) metaCount;
+
+		needed += sizeof (header) + header[0] + header[1];
+		for (elektraCursor m = 0; m < metaCount; ++m)
+		{
+			const Key * metaKey = ksAtCursor (meta, m);
+			needed += 2 * sizeof (uint32_t) + keyGetNameSize (metaKey) + keyGetValueSize (metaKey);
+		}
+
+		if (buffer == NULL) continue;
+		if (needed > size) return -1;
+
+		memcpy (out, header, sizeof (header));
+		out += sizeof (header);
+		memcpy (out, keyName (cur), header[0]);
+		out += header[0];
+		if (header[1] > 0)
+		{
+			memcpy (out, keyValue (cur), header[1]);
+			out += header[1];
+		}
+
+		for (elektraCursor m = 0; m < metaCount; ++m)
+		{
+			const Key * metaKey = ksAtCursor (meta, m);
+			uint32_t metaHeader[2] = { (uint32_t) keyGetNameSize (metaKey), (uint32_t) keyGetValueSize (metaKey) };
+			memcpy (out, metaHeader, sizeof (metaHeader));
+			out += sizeof (metaHeader);
+			memcpy (out, keyName (metaKey), metaHeader[0]);
+			out += metaHeader[0];
+			memcpy (out, keyValue (metaKey), metaHeader[1]);
+			out += metaHeader[1];
+		}
+	}
+
+	return needed;
+}
+
 /**
  * Searches for the start and end indicies corresponding to the given cutpoint.
  *
@@ -1283,6 +2375,7 @@ KeySet * ksCut (KeySet * ks, const Key * cutpoint)
 			case KEY_NS_SYSTEM:
 			case KEY_NS_META:
 				((Key *) cutpoint)->ukey[0] = ns;
+				keyUpdateNamePrefix ((Key *) cutpoint);
 				break;
 			case KEY_NS_NONE:
 			case KEY_NS_CASCADING:
@@ -1299,6 +2392,7 @@ KeySet * ksCut (KeySet * ks, const Key * cutpoint)
 
 		// restore old cascading name
 		((Key *) cutpoint)->ukey[0] = KEY_NS_CASCADING;
+		keyUpdateNamePrefix ((Key *) cutpoint);
 
 		// now look for cascading keys
 		// TODO: cascading keys shouldn't be allowed in KeySet anymore
@@ -1370,23 +2464,144 @@ ksDel (ks2);
  */
 Key * ksPop (KeySet * ks)
 {
-	Key * ret = 0;
+	Key * ret = 0;
+
+	if (!ks) return 0;
+
+	ks->flags |= KS_FLAG_SYNC;
+
+	if (ks->size == 0) return 0;
+
+	elektraOpmphmInvalidate (ks);
+
+	--ks->size;
+	if (ks->size + 1 < ks->alloc / 2) ksResize (ks, ks->alloc / 2 - 1);
+	ret = ks->array[ks->size];
+	ks->array[ks->size] = 0;
+	keyDecRef (ret);
+
+	return ret;
+}
+
+/**
+ * Removes every Key of a KeySet for which @p predicate returns non-zero.
+ *
+ * All removals happen in one compaction pass over the array, so filtering
+ * a KeySet costs O(n) regardless of how many Keys are removed. Removing
+ * Keys one by one with elektraKsPopAtCursor() instead moves the tail of
+ * the array once per removal and degenerates to O(n^2).
+ *
+ * Removed Keys are released like with ksPop() followed by keyDel(): they
+ * are only freed if the KeySet held the last reference. @p predicate is
+ * called exactly once per Key, in KeySet order, and must not modify the
+ * name of @p key or add/remove Keys from @p ks. @p argument is passed
+ * through unchanged.
+ *
+ * The internal cursor is rewound if any Key was removed.
+ *
+ * @param ks        the KeySet to filter
+ * @param predicate decides for each Key whether it is removed
+ * @param argument  arbitrary context passed to @p predicate
+ *
+ * @return the number of Keys removed
+ * @retval -1 if @p ks or @p predicate is NULL
+ *
+ * @see ksRetainRange() for keeping only a contiguous range
+ */
+ssize_t ksRemoveIf (KeySet * ks, int (*predicate) (Key * key, void * argument), void * argument)
+{
+	if (!ks || !predicate) return -1;
+
+	size_t kept = 0;
+	size_t removed = 0;
+	for (size_t i = 0; i < ks->size; ++i)
+	{
+		Key * cur = ks->array[i];
+		if (predicate (cur, argument))
+		{
+			keyDecRef (cur);
+			keyDel (cur);
+			++removed;
+		}
+		else
+		{
+			ks->array[kept++] = cur;
+		}
+	}
+
+	if (removed == 0) return 0;
+
+	ks->flags |= KS_FLAG_SYNC;
+	elektraOpmphmInvalidate (ks);
+
+	ks->size = kept;
+	ks->array[ks->size] = 0;
+	if (ks->size + 1 < ks->alloc / 2) ksResize (ks, ks->alloc / 2 - 1);
+	ksRewind (ks);
+
+	return (ssize_t) removed;
+}
+
+/**
+ * Removes every Key of a KeySet outside the range [@p start, @p end).
+ *
+ * Together with ksFindHierarchy() this gives keep-only-subtree semantics
+ * without copying: instead of cutting the subtree into a second KeySet and
+ * deleting the rest, the kept Keys are moved to the front of the array in
+ * a single pass.
+ *
+ * @code{.c}
+ * elektraCursor end;
+ * elektraCursor start = ksFindHierarchy (ks, root, &end);
+ * ksRetainRange (ks, start, end);
+ * @endcode
+ *
+ * An empty range (@p start equal to @p end) clears the KeySet. Removed
+ * Keys are released like with ksPop() followed by keyDel(). The internal
+ * cursor is rewound if any Key was removed.
+ *
+ * @param ks    the KeySet to filter
+ * @param start position of the first Key to keep
+ * @param end   position of the first Key after @p start that is not kept
+ *
+ * @return the number of Keys removed
+ * @retval -1 if @p ks is NULL or the range is not within the KeySet
+ *
+ * @see ksRemoveIf() for filtering by predicate
+ */
+ssize_t ksRetainRange (KeySet * ks, elektraCursor start, elektraCursor end)
+{
+	if (!ks) return -1;
+	if (start < 0 || end < start || (size_t) end > ks->size) return -1;
 
-	if (!ks) return 0;
+	size_t removed = ks->size - (size_t) (end - start);
+	if (removed == 0) return 0;
 
-	ks->flags |= KS_FLAG_SYNC;
+	for (elektraCursor i = 0; i < start; ++i)
+	{
+		keyDecRef (ks->array[i]);
+		keyDel (ks->array[i]);
+	}
+	for (size_t i = (size_t) end; i < ks->size; ++i)
+	{
+		keyDecRef (ks->array[i]);
+		keyDel (ks->array[i]);
+	}
 
-	if (ks->size == 0) return 0;
+	if (start > 0 && end > start)
+	{
+		memmove (ks->array, ks->array + start, (size_t) (end - start) * sizeof (Key *));
+	}
 
+	ks->flags |= KS_FLAG_SYNC;
 	elektraOpmphmInvalidate (ks);
 
-	--ks->size;
-	if (ks->size + 1 < ks->alloc / 2) ksResize (ks, ks->alloc / 2 - 1);
-	ret = ks->array[ks->size];
+	ks->size = (size_t) (end - start);
 	ks->array[ks->size] = 0;
-	keyDecRef (ret);
+	if (ks->size + 1 < ks->alloc / 2) ksResize (ks, ks->alloc / 2 - 1);
+	ksRewind (ks);
 
-	return ret;
+	return (ssize_t) removed;
 }
 
 
@@ -2014,14 +3229,97 @@ static Key * elektraLookupByCascading (KeySet * ks, Key * key, elektraLookupFlag
 	return found;
 }
 
+/** Minimum KeySet size before binary search lookups consult the namespace slice index */
+#define ELEKTRA_NS_SLICE_MIN_SIZE 16
+
+/** @internal Namespace slice boundaries of ks->array, see elektraKsNsSlice(). */
+struct _KsNsIndex
+{
+	size_t generation; /*!< ks->generation + 1 when built, 0 never matches */
+	size_t offsets[KEY_NS_DEFAULT + 2]; /*!< offsets[ns] = first position of namespace ns, offsets[ns + 1] its end */
+};
+
+/**
+ * @internal
+ * @brief Position of the first Key in @p ks with a namespace >= @p ns
+ */
+static size_t ksNsLowerBound (const KeySet * ks, elektraNamespace ns)
+{
+	size_t left = 0;
+	size_t right = ks->size;
+	while (left < right)
+	{
+		size_t mid = left + (right - left) / 2;
+		if (keyGetNamespace (ks->array[mid]) < ns)
+		{
+			left = mid + 1;
+		}
+		else
+		{
+			right = mid;
+		}
+	}
+	return left;
+}
+
+/**
+ * @internal
+ * @brief Yields the slice of ks->array holding the keys of namespace @p ns.
+ *
+ * The array is sorted namespace-first, so every namespace is one contiguous
+ * run. The boundaries of all runs are determined together on first use and
+ * memoized until the KeySet is modified structurally; while the memo is
+ * valid, a cascading lookup probing five namespaces pays for at most one
+ * boundary computation and skips empty namespaces without any search.
+ */
+static void elektraKsNsSlice (KeySet * ks, elektraNamespace ns, size_t * start, size_t * end)
+{
+	if (ks->nsIndex == NULL)
+	{
+		ks->nsIndex = elektraMalloc (sizeof (struct _KsNsIndex));
+		if (ks->nsIndex == NULL)
+		{
+			*start = 0;
+			*end = ks->size;
+			return;
+		}
+		ks->nsIndex->generation = 0;
+	}
+
+	struct _KsNsIndex * index = ks->nsIndex;
+	if (index->generation != ks->generation + 1)
+	{
+		for (int n = KEY_NS_NONE; n <= KEY_NS_DEFAULT; ++n)
+		{
+			index->offsets[n] = ksNsLowerBound (ks, (elektraNamespace) n);
+		}
+		index->offsets[KEY_NS_DEFAULT + 1] = ks->size;
+		index->generation = ks->generation + 1;
+	}
+
+	*start = index->offsets[ns];
+	*end = index->offsets[ns + 1];
+}
+
 static Key * elektraLookupBinarySearch (KeySet * ks, Key const * key, elektraLookupFlags options)
 {
 	elektraCursor cursor = 0;
 	cursor = ksGetCursor (ks);
 	Key ** found;
-	size_t jump = 0;
-	/*If there is a known offset in the beginning jump could be set*/
-	found = (Key **) bsearch (&key, ks->array + jump, ks->size - jump, sizeof (Key *), keyCompareByName);
+	size_t start = 0;
+	size_t end = ks->size;
+	// restrict the search to the slice of the key's namespace; below the
+	// threshold a full search is cheaper than maintaining the slice index
+	if (ks->size >= ELEKTRA_NS_SLICE_MIN_SIZE)
+	{
+		elektraKsNsSlice (ks, keyGetNamespace (key), &start, &end);
+		if (start == end)
+		{
+			ksSetCursor (ks, cursor);
+			return 0;
+		}
+	}
+	found = (Key **) bsearch (&key, ks->array + start, end - start, sizeof (Key *), keyCompareByName);
 
 	if (found)
 	{
@@ -2043,6 +3341,38 @@ static Key * elektraLookupBinarySearch (KeySet * ks, Key const * key, elektraLoo
 	return 0;
 }
 
+/**
+ * @internal
+ *
+ * @brief Looks up a Key by its full name without modifying @p ks in any way.
+ *
+ * A regular ksLookup() writes to the KeySet even when it only reads: it
+ * stores the cursor, lazily builds the namespace slice index and updates
+ * the OPMPHM predictor state. That is fine for a KeySet owned by one
+ * thread, but the metadata KeySets shared between keys via keyMetaShare()
+ * can be reached from several threads at once through the copy-on-write
+ * views of a kdbSnapshot(). This plain binary search leaves @p ks
+ * untouched, so concurrent callers need no synchronization.
+ *
+ * No cascading or spec resolution is done: @p key has to carry the full
+ * name of the Key to find, as is always the case for metadata lookups.
+ *
+ * @param ks the KeySet to search
+ * @param key the Key whose name is searched for
+ *
+ * @return the found Key
+ * @retval NULL on NULL pointers, a nameless @p key or when nothing was found
+ *
+ * @see ksLookup() for the mutating general-purpose lookup
+ */
+Key * ksLookupReadOnly (const KeySet * ks, const Key * key)
+{
+	if (ks == NULL || key == NULL || key->key == NULL || ks->size == 0) return NULL;
+
+	Key ** found = (Key **) bsearch (&key, ks->array, ks->size, sizeof (Key *), keyCompareByName);
+	return found != NULL ? *found : NULL;
+}
+
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 
 /**
@@ -2059,6 +3389,165 @@ static const char * elektraOpmphmGetString (void * data)
 	return keyName ((Key *) data);
 }
 
+/**
+ * Maximum number of seed sets tried before the OPMPHM build gives up.
+ */
+#define ELEKTRA_OPMPHM_MAX_MAPPINGS (10)
+
+#ifdef ELEKTRA_HAVE_PTHREAD
+
+/**
+ * Minimum number of keys before the seed search is parallelized.
+ * Below this size a mapping attempt is cheaper than spawning threads.
+ */
+#define ELEKTRA_OPMPHM_PARALLEL_MIN_N (100000)
+
+/**
+ * Maximum number of concurrent seed searchers.
+ * Every worker allocates its own graph, so this also bounds the transient memory usage.
+ */
+#define ELEKTRA_OPMPHM_MAX_WORKERS (4)
+
+typedef struct
+{
+	KeySet * ks;		/*!< the KeySet the OPMPHM is built for */
+	Opmphm * opmphm;	/*!< worker-private Opmphm holding the tried seeds */
+	OpmphmGraph * graph;	/*!< worker-private graph */
+	OpmphmInit init;	/*!< worker-private init with an own seed sequence */
+	size_t maxMappings;	/*!< mapping attempts this worker may do */
+	size_t mappings;	/*!< mapping attempts this worker did */
+	int won;		/*!< set when this worker found the first acyclic graph */
+	int running;		/*!< whether the thread was started */
+	int * done;		/*!< shared flag, set when any worker succeeded */
+	pthread_mutex_t * lock; /*!< protects done */
+} OpmphmBuildJob;
+
+/**
+ * @internal
+ *
+ * @brief Thread job for the parallel OPMPHM seed search.
+ *
+ * Tries mapping attempts with worker-private seeds until an acyclic
+ * graph is found, the attempts are exhausted or another worker won.
+ *
+ * @param data the OpmphmBuildJob
+ */
+static void * elektraOpmphmBuildJob (void * data)
+{
+	OpmphmBuildJob * job = data;
+	while (job->mappings < job->maxMappings)
+	{
+		pthread_mutex_lock (job->lock);
+		int stop = *job->done;
+		pthread_mutex_unlock (job->lock);
+		if (stop) return NULL;
+
+		++job->mappings;
+		if (opmphmMapping (job->opmphm, job->graph, &job->init, job->ks->size) == 0)
+		{
+			pthread_mutex_lock (job->lock);
+			if (!*job->done)
+			{
+				*job->done = 1;
+				job->won = 1;
+			}
+			pthread_mutex_unlock (job->lock);
+			return NULL;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @internal
+ *
+ * @brief Searches for an acyclic graph with several seed sets concurrently.
+ *
+ * Every worker tries mapping attempts on an own graph with an own seed
+ * sequence, the first acyclic graph wins and is assigned. This bounds the
+ * worst case build time under unlucky seeds by the slowest single attempt
+ * instead of the sum of all retries.
+ *
+ * @param ks the KeySet which OPMPHM is to build
+ * @param r the rUniPar
+ * @param c space influencing parameter
+ * @param mappings is incremented by the number of mapping attempts done
+ *
+ * @retval 0 on success
+ * @retval -1 when no seed set led to an acyclic graph or on memory error during assignment
+ * @retval 1 when the parallel search could not be set up, the caller should search sequentially
+ */
+static int elektraLookupBuildOpmphmParallel (KeySet * ks, uint8_t r, double c, size_t * mappings)
+{
+	long cores = sysconf (_SC_NPROCESSORS_ONLN);
+	size_t workers = cores < 2 ? 2 : (size_t) cores;
+	if (workers > ELEKTRA_OPMPHM_MAX_WORKERS) workers = ELEKTRA_OPMPHM_MAX_WORKERS;
+
+	OpmphmBuildJob * jobs = elektraCalloc (workers * sizeof (OpmphmBuildJob));
+	pthread_t * threads = elektraCalloc (workers * sizeof (pthread_t));
+	int done = 0;
+	pthread_mutex_t lock;
+	int ret = 1;
+
+	if (!jobs || !threads || pthread_mutex_init (&lock, NULL) != 0)
+	{
+		elektraFree (jobs);
+		elektraFree (threads);
+		return 1;
+	}
+
+	for (size_t i = 0; i < workers; ++i)
+	{
+		jobs[i].ks = ks;
+		jobs[i].opmphm = opmphmNew ();
+		jobs[i].graph = jobs[i].opmphm ? opmphmGraphNew (jobs[i].opmphm, r, ks->size, c) : NULL;
+		jobs[i].init.getName = elektraOpmphmGetString;
+		jobs[i].init.data = (void **) ks->array;
+		jobs[i].init.initSeed = elektraRandGetInitSeed ();
+		jobs[i].maxMappings = (ELEKTRA_OPMPHM_MAX_MAPPINGS + workers - 1) / workers;
+		jobs[i].done = &done;
+		jobs[i].lock = &lock;
+		if (!jobs[i].graph) goto cleanup;
+	}
+
+	size_t started = 0;
+	for (size_t i = 0; i < workers; ++i)
+	{
+		jobs[i].running = pthread_create (&threads[i], NULL, elektraOpmphmBuildJob, &jobs[i]) == 0;
+		if (jobs[i].running) ++started;
+	}
+	for (size_t i = 0; i < workers; ++i)
+	{
+		if (jobs[i].running) pthread_join (threads[i], NULL);
+	}
+	if (started == 0) goto cleanup;
+
+	ret = -1;
+	for (size_t i = 0; i < workers; ++i)
+	{
+		*mappings += jobs[i].mappings;
+		if (!jobs[i].won) continue;
+		// assign the winning graph and move the result into the KeySets OPMPHM
+		if (opmphmAssignment (jobs[i].opmphm, jobs[i].graph, ks->size, 1) == 0 && opmphmCopy (ks->opmphm, jobs[i].opmphm) == 0)
+		{
+			ret = 0;
+		}
+	}
+
+cleanup:
+	for (size_t i = 0; i < workers; ++i)
+	{
+		if (jobs[i].graph) opmphmGraphDel (jobs[i].graph);
+		if (jobs[i].opmphm) opmphmDel (jobs[i].opmphm);
+	}
+	pthread_mutex_destroy (&lock);
+	elektraFree (jobs);
+	elektraFree (threads);
+	return ret;
+}
+
+#endif
+
 /**
  * @internal
  *
@@ -2066,6 +3555,8 @@ static const char * elektraOpmphmGetString (void * data)
  *
  * Creates the OPMPHM when not here.
  * The passed KeySet must have a not build OPMPHM.
+ * For large KeySets the search for an acyclic graph is done with several
+ * seed sets concurrently, see elektraLookupBuildOpmphmParallel().
  *
  * @param ks the KeySet which OPMPHM is to build
  *
@@ -2087,43 +3578,74 @@ static int elektraLookupBuildOpmphm (KeySet * ks)
 		}
 	}
 	ELEKTRA_ASSERT (!opmphmIsBuild (ks->opmphm), "OPMPHM already build");
-	// make graph
 	uint8_t r = opmphmOptR (ks->size);
 	double c = opmphmMinC (r);
 	c += opmphmOptC (ks->size);
-	OpmphmGraph * graph = opmphmGraphNew (ks->opmphm, r, ks->size, c);
-	if (!graph)
-	{
-		return -1;
-	}
-	// make init
-	OpmphmInit init;
-	init.getName = elektraOpmphmGetString;
-	init.data = (void **) ks->array;
-	init.initSeed = elektraRandGetInitSeed ();
 
-	// mapping
+	struct timespec buildStart;
+	if (ks->lookupStats) clock_gettime (CLOCK_MONOTONIC, &buildStart);
+
 	size_t mappings = 0; // counts mapping invocations
-	int ret;
-	do
+	int built = 1;
+#ifdef ELEKTRA_HAVE_PTHREAD
+	if (ks->size >= ELEKTRA_OPMPHM_PARALLEL_MIN_N)
 	{
-		ret = opmphmMapping (ks->opmphm, graph, &init, ks->size);
-		++mappings;
-	} while (ret && mappings < 10);
-	if (ret && mappings == 10)
+		built = elektraLookupBuildOpmphmParallel (ks, r, c, &mappings);
+	}
+#endif
+	if (built == 1)
 	{
+		// sequential seed search
+		OpmphmGraph * graph = opmphmGraphNew (ks->opmphm, r, ks->size, c);
+		if (!graph)
+		{
+			return -1;
+		}
+		// make init
+		OpmphmInit init;
+		init.getName = elektraOpmphmGetString;
+		init.data = (void **) ks->array;
+		init.initSeed = elektraRandGetInitSeed ();
+
+		// mapping
+		int ret;
+		do
+		{
+			ret = opmphmMapping (ks->opmphm, graph, &init, ks->size);
+			++mappings;
+		} while (ret && mappings < ELEKTRA_OPMPHM_MAX_MAPPINGS);
+		if (ret)
+		{
+			opmphmGraphDel (graph);
+			return -1;
+		}
+
+		// assign
+		if (opmphmAssignment (ks->opmphm, graph, ks->size, 1))
+		{
+			opmphmGraphDel (graph);
+			return -1;
+		}
+
 		opmphmGraphDel (graph);
-		return -1;
+		built = 0;
 	}
-
-	// assign
-	if (opmphmAssignment (ks->opmphm, graph, ks->size, 1))
+	if (built != 0)
 	{
-		opmphmGraphDel (graph);
 		return -1;
 	}
 
-	opmphmGraphDel (graph);
+	ks->opmphmSize = ks->size;
+	ks->opmphmInsertCount = 0;
+	if (ks->lookupStats)
+	{
+		struct timespec buildEnd;
+		clock_gettime (CLOCK_MONOTONIC, &buildEnd);
+		++ks->lookupStats->opmphmBuilds;
+		ks->lookupStats->opmphmBuildMappings += mappings;
+		ks->lookupStats->opmphmBuildNs +=
+			(buildEnd.tv_sec - buildStart.tv_sec) * 1000000000ULL + (buildEnd.tv_nsec - buildStart.tv_nsec);
+	}
 	return 0;
 }
 
@@ -2147,15 +3669,50 @@ static Key * elektraLookupOpmphmSearch (KeySet * ks, Key const * key, elektraLoo
 	ELEKTRA_ASSERT (opmphmIsBuild (ks->opmphm), "OPMPHM not build");
 	elektraCursor cursor = 0;
 	cursor = ksGetCursor (ks);
-	size_t index = opmphmLookup (ks->opmphm, ks->size, keyName (key));
+	// the OPMPHM maps into the array as it was at build time
+	size_t n = ks->opmphmSize != 0 ? ks->opmphmSize : ks->size;
+	size_t index = opmphmLookup (ks->opmphm, n, keyName (key));
+	if (index >= n)
+	{
+		return 0;
+	}
+
+	// adjust for keys inserted since the build (side-table is sorted)
+	for (size_t i = 0; i < ks->opmphmInsertCount; ++i)
+	{
+		if (ks->opmphmInserts[i] <= index)
+		{
+			++index;
+		}
+		else
+		{
+			break;
+		}
+	}
 	if (index >= ks->size)
 	{
+		ksSetCursor (ks, cursor);
 		return 0;
 	}
 
 	Key * found = ks->array[index];
 
-	if (!strcmp (keyName (found), keyName (key)))
+	if (strcmp (keyName (found), keyName (key)) != 0)
+	{
+		// not in the build part, may be a key inserted since the build
+		found = 0;
+		for (size_t i = 0; i < ks->opmphmInsertCount; ++i)
+		{
+			if (!strcmp (keyName (ks->array[ks->opmphmInserts[i]]), keyName (key)))
+			{
+				index = ks->opmphmInserts[i];
+				found = ks->array[index];
+				break;
+			}
+		}
+	}
+
+	if (found)
 	{
 		cursor = index;
 		if (options & KDB_O_POP)
@@ -2175,6 +3732,70 @@ static Key * elektraLookupOpmphmSearch (KeySet * ks, Key const * key, elektraLoo
 	}
 }
 
+/**
+ * @internal
+ *
+ * @brief Starts collecting lookup statistics for @p ks.
+ *
+ * The counters are stored in the KeySet and updated by every
+ * subsequent ksLookup(). Calling this function again resets them.
+ *
+ * @param ks the KeySet
+ *
+ * @retval 0 on success
+ * @retval -1 on NULL pointer or allocation failure
+ */
+int ksLookupStatsEnable (KeySet * ks)
+{
+	if (!ks) return -1;
+	if (ks->lookupStats)
+	{
+		memset (ks->lookupStats, 0, sizeof (*ks->lookupStats));
+		return 0;
+	}
+	ks->lookupStats = elektraCalloc (sizeof (*ks->lookupStats));
+	if (!ks->lookupStats) return -1;
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * @brief Gives access to the lookup statistics of @p ks.
+ *
+ * @param ks the KeySet
+ *
+ * @return the statistics collected since ksLookupStatsEnable()
+ * @retval NULL when statistics were never enabled
+ */
+const struct _KsLookupStats * ksLookupStats (const KeySet * ks)
+{
+	if (!ks) return NULL;
+	return ks->lookupStats;
+}
+
+/**
+ * @internal
+ *
+ * @brief Pins the search strategy used by every ksLookup() on @p ks.
+ *
+ * Acts as if the given flag was passed to each lookup, overruling the
+ * OPMPHM predictor. Pass 0 to hand control back to the predictor.
+ *
+ * @param ks the KeySet
+ * @param strategy #KDB_O_OPMPHM, #KDB_O_BINSEARCH or 0
+ *
+ * @retval 0 on success
+ * @retval -1 on NULL pointer or invalid strategy
+ */
+int ksPinLookupStrategy (KeySet * ks, elektraLookupFlags strategy)
+{
+	if (!ks) return -1;
+	if (strategy != 0 && strategy != KDB_O_OPMPHM && strategy != KDB_O_BINSEARCH) return -1;
+	ks->lookupPin = strategy;
+	return 0;
+}
+
 #endif
 
 /**
@@ -2195,6 +3816,16 @@ static Key * elektraLookupSearch (KeySet * ks, Key * key, elektraLookupFlags opt
 	Key * found = 0;
 
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	if (ks->lookupStats)
+	{
+		++ks->lookupStats->lookups;
+	}
+	if (ks->lookupPin)
+	{
+		// a pinned strategy behaves like passing the flag to every lookup
+		set_bit (options, ks->lookupPin);
+	}
+
 	if (!ks->opmphmPredictor && ks->size > opmphmPredictorActionLimit)
 	{
 		// lazy loading of predictor when over action limit
@@ -2210,8 +3841,16 @@ static Key * elektraLookupSearch (KeySet * ks, Key * key, elektraLookupFlags opt
 			if (test_bit (ks->flags, KS_FLAG_NAME_CHANGE))
 			{
 				// KeySet changed ask predictor
+				if (ks->lookupStats)
+				{
+					++ks->lookupStats->predictions;
+				}
 				if (opmphmPredictor (ks->opmphmPredictor, ks->size))
 				{
+					if (ks->lookupStats)
+					{
+						++ks->lookupStats->predictedOpmphm;
+					}
 					set_bit (options, KDB_O_OPMPHM);
 				}
 				else
@@ -2247,11 +3886,13 @@ static Key * elektraLookupSearch (KeySet * ks, Key * key, elektraLookupFlags opt
 	}
 
 	// the actual lookup
+	int usedOpmphm = 0;
 	if ((options & (KDB_O_BINSEARCH | KDB_O_OPMPHM)) == KDB_O_OPMPHM)
 	{
 		if (opmphmIsBuild (ks->opmphm) || !elektraLookupBuildOpmphm (ks))
 		{
 			found = elektraLookupOpmphmSearch (ks, key, options);
+			usedOpmphm = 1;
 		}
 		else
 		{
@@ -2269,12 +3910,24 @@ static Key * elektraLookupSearch (KeySet * ks, Key * key, elektraLookupFlags opt
 		if (opmphmIsBuild (ks->opmphm))
 		{
 			found = elektraLookupOpmphmSearch (ks, key, options);
+			usedOpmphm = 1;
 		}
 		else
 		{
 			found = elektraLookupBinarySearch (ks, key, options);
 		}
 	}
+	if (ks->lookupStats)
+	{
+		if (usedOpmphm)
+		{
+			++ks->lookupStats->opmphmSearches;
+		}
+		else
+		{
+			++ks->lookupStats->binarySearches;
+		}
+	}
 
 	// remove flags to not interfere with callback
 	clear_bit (options, (KDB_O_OPMPHM | KDB_O_BINSEARCH));
@@ -2442,6 +4095,69 @@ Key * ksLookup (KeySet * ks, Key * key, elektraLookupFlags options)
 	return ret;
 }
 
+/**
+ * @brief Looks up a Key like ksLookup(), memoizing its position in @p hint.
+ *
+ * Applications that look up the same keys in a stable KeySet over and over
+ * (e.g. the highlevel API reading configuration values) pay for a full
+ * search on every call. This variant records the position of the found Key
+ * together with the KeySet's generation counter in @p hint, a small caller
+ * owned struct that must be zero-initialized before its first use. As long
+ * as the KeySet is not modified structurally, a repeated lookup with the
+ * same hint validates the memo with a single name comparison and returns
+ * the Key without searching.
+ *
+ * Only lookups by exact name profit: for cascading key names the found
+ * Key's name never matches the lookup name, so the memo never validates
+ * and every call falls through to ksLookup(). The options #KDB_O_POP and
+ * #KDB_O_DEL bypass the memo entirely because they modify the KeySet or
+ * the lookup Key.
+ *
+ * A hint must only ever be used with one KeySet. Between different KeySets
+ * the generation counters are not comparable and the memo could validate
+ * by accident.
+ *
+ * @param ks      the KeySet that should be searched
+ * @param key     the Key to look for
+ * @param options lookup options, see ksLookup()
+ * @param hint    memoized position from a previous call, may be NULL
+ *
+ * @return pointer to the Key found, like ksLookup()
+ * @retval 0 if no Key has been found
+ *
+ * @since 0.9.8
+ * @see ksLookup() for the search semantics
+ */
+Key * ksLookupCached (KeySet * ks, Key * key, elektraLookupFlags options, ElektraLookupHint * hint)
+{
+	if (!ks || !key) return 0;
+
+	if (options & (KDB_O_POP | KDB_O_DEL)) return ksLookup (ks, key, options);
+
+	if (hint != NULL && hint->generation == ks->generation + 1 && hint->position < ks->size)
+	{
+		Key * cached = ks->array[hint->position];
+		if (keyCmp (cached, key) == 0) return cached;
+	}
+
+	Key * found = ksLookup (ks, key, options);
+	if (hint != NULL)
+	{
+		hint->generation = 0;
+		if (found != NULL)
+		{
+			ssize_t position = ksSearchInternal (ks, found);
+			if (position >= 0)
+			{
+				// + 1 so a zeroed hint can never validate against a fresh KeySet
+				hint->generation = ks->generation + 1;
+				hint->position = (size_t) position;
+			}
+		}
+	}
+	return found;
+}
+
 /**
  * Convenience method to look for a Key contained in @p ks with name @p name.
  *
@@ -2600,11 +4316,22 @@ int ksInit (KeySet * ks)
 	ks->size = 0;
 	ks->alloc = 0;
 	ks->flags = 0;
+	ks->metaRefs = 0;
+	ks->arena = 0;
+	ks->cowSource = 0;
+	ks->metaIndex = 0;
+	ks->generation = 0;
+	ks->nsIndex = 0;
 
 	ksRewind (ks);
 
 #ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
 	ks->opmphm = NULL;
+	ks->opmphmSize = 0;
+	ks->opmphmInserts = NULL;
+	ks->opmphmInsertCount = 0;
+	ks->lookupStats = NULL;
+	ks->lookupPin = 0;
 	// first lookup should predict so invalidate it
 	elektraOpmphmInvalidate (ks);
 	ks->opmphmPredictor = NULL;
@@ -2647,6 +4374,9 @@ int ksClose (KeySet * ks)
 
 	ks->size = 0;
 
+	elektraFree (ks->nsIndex);
+	ks->nsIndex = 0;
+
 	elektraOpmphmInvalidate (ks);
 
 	return 0;
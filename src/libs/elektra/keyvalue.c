@@ -165,7 +165,7 @@ const void * keyValue (const Key * key)
 {
 	if (!key) return 0;
 
-	if (!key->data.v)
+	if (keyDataPtr (key) == NULL)
 	{
 		if (keyIsBinary (key))
 			return 0;
@@ -173,7 +173,7 @@ const void * keyValue (const Key * key)
 			return "";
 	}
 
-	return key->data.v;
+	return keyDataPtr (key);
 }
 
 
@@ -207,7 +207,7 @@ const char * keyString (const Key * key)
 {
 	if (!key) return "(null)";
 
-	if (!key->data.c)
+	if (keyDataPtr (key) == NULL)
 	{
 		return "";
 	}
@@ -217,7 +217,7 @@ const char * keyString (const Key * key)
 		return "(binary)";
 	}
 
-	return key->data.c;
+	return keyDataPtr (key);
 }
 
 
@@ -262,7 +262,7 @@ ssize_t keyGetValueSize (const Key * key)
 {
 	if (!key) return -1;
 
-	if (!key->data.v)
+	if (keyDataPtr (key) == NULL)
 	{
 		if (keyIsBinary (key))
 			return 0;
@@ -326,7 +326,7 @@ ssize_t keyGetString (const Key * key, char * returnedString, size_t maxSize)
 		return -1;
 	}
 
-	if (!key->data.v)
+	if (keyDataPtr (key) == NULL)
 	{
 		returnedString[0] = 0;
 		return 1;
@@ -338,7 +338,7 @@ ssize_t keyGetString (const Key * key, char * returnedString, size_t maxSize)
 	}
 
 
-	strncpy (returnedString, key->data.c, maxSize);
+	strncpy (returnedString, keyDataPtr (key), maxSize);
 	return key->dataSize;
 }
 
@@ -444,7 +444,7 @@ ssize_t keyGetBinary (const Key * key, void * returnedBinary, size_t maxSize)
 		return -1;
 	}
 
-	if (!key->data.v)
+	if (keyDataPtr (key) == NULL)
 	{
 		return 0;
 	}
@@ -454,7 +454,7 @@ ssize_t keyGetBinary (const Key * key, void * returnedBinary, size_t maxSize)
 		return -1;
 	}
 
-	memcpy (returnedBinary, key->data.v, key->dataSize);
+	memcpy (returnedBinary, keyDataPtr (key), key->dataSize);
 	return key->dataSize;
 }
 
@@ -538,11 +538,14 @@ ssize_t keySetRaw (Key * key, const void * newBinary, size_t dataSize)
 
 	if (!dataSize || !newBinary)
 	{
-		if (key->data.v)
+		if (keyDataPtr (key) != NULL)
 		{
-			if (!test_bit (key->flags, KEY_FLAG_MMAP_DATA)) elektraFree (key->data.v);
+			if (!test_bit (key->flags, KEY_FLAG_MMAP_DATA) && !test_bit (key->flags, KEY_FLAG_SMALL_DATA))
+			{
+				elektraFree (key->data.v);
+			}
 			key->data.v = NULL;
-			clear_bit (key->flags, (keyflag_t) KEY_FLAG_MMAP_DATA);
+			clear_bit (key->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
 		}
 		key->dataSize = 0;
 		set_bit (key->flags, KEY_FLAG_SYNC);
@@ -551,30 +554,41 @@ ssize_t keySetRaw (Key * key, const void * newBinary, size_t dataSize)
 	}
 
 	key->dataSize = dataSize;
-	if (key->data.v)
+	if (dataSize <= sizeof (key->data.small))
 	{
-		char * previous = key->data.v;
-
-		if (test_bit (key->flags, KEY_FLAG_MMAP_DATA))
+		// small-value optimization: store the value inline in the struct
+		char * previous = test_bit (key->flags, KEY_FLAG_MMAP_DATA) || test_bit (key->flags, KEY_FLAG_SMALL_DATA) ? NULL : key->data.v;
+
+		// the new value may alias the previous one, so copy before freeing
+		memmove (key->data.small, newBinary, dataSize);
+		if (previous != NULL) elektraFree (previous);
+		clear_bit (key->flags, (keyflag_t) KEY_FLAG_MMAP_DATA);
+		set_bit (key->flags, KEY_FLAG_SMALL_DATA);
+	}
+	else if (keyDataPtr (key) != NULL)
+	{
+		if (test_bit (key->flags, KEY_FLAG_MMAP_DATA) || test_bit (key->flags, KEY_FLAG_SMALL_DATA))
 		{
-			clear_bit (key->flags, (keyflag_t) KEY_FLAG_MMAP_DATA);
-			key->data.v = elektraMalloc (key->dataSize);
-			if (key->data.v == NULL) return -1;
+			// the new value may alias the mmap/inline value, so copy before overwriting data.v
+			char * p = elektraMalloc (key->dataSize);
+			if (NULL == p) return -1;
+			memcpy (p, newBinary, key->dataSize);
+			key->data.v = p;
+			clear_bit (key->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
 		}
 		else
 		{
+			char * previous = key->data.v;
 			if (-1 == elektraRealloc ((void **) &key->data.v, key->dataSize)) return -1;
-		}
-
-		if (-1 == elektraRealloc ((void **) &key->data.v, key->dataSize)) return -1;
-		if (previous == key->data.v)
-		{
-			// In case the regions overlap, use memmove to stay safe
-			memmove (key->data.v, newBinary, key->dataSize);
-		}
-		else
-		{
-			memcpy (key->data.v, newBinary, key->dataSize);
+			if (previous == key->data.v)
+			{
+				// In case the regions overlap, use memmove to stay safe
+				memmove (key->data.v, newBinary, key->dataSize);
+			}
+			else
+			{
+				memcpy (key->data.v, newBinary, key->dataSize);
+			}
 		}
 	}
 	else
@@ -456,6 +456,7 @@ int mountGlobals (KDB * kdb, KeySet * keys, KeySet * modules, Key * errorKey)
 	ksDel (keys);
 	ksDel (referencePlugins);
 	ksDel (system);
+	elektraGlobalMaskUpdate (kdb);
 	return retval;
 }
 
@@ -720,7 +721,10 @@ Backend * mountGetBackend (KDB * handle, const char * where)
 {
 	if (where == NULL || strlen (where) == 0) return handle->defaultBackend;
 
-	Backend * ret = trieLookup (handle->trie, where);
+	/* The trie is immutable after kdbOpen(). Reading the published pointer
+	 * with acquire semantics lets threads sharing a handle resolve backends
+	 * concurrently without a lock. */
+	Backend * ret = trieLookup (__atomic_load_n (&handle->trie, __ATOMIC_ACQUIRE), where);
 	if (!ret) return handle->defaultBackend;
 	return ret;
 }
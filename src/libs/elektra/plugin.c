@@ -314,6 +314,112 @@ err_clup:
 	return 0;
 }
 
+/**
+ * @brief Queries a plugin's contract without instantiating the plugin.
+ *
+ * elektraPluginOpen() runs the plugin's open function, which for some
+ * plugins opens sockets or spawns processes - side effects a pure contract
+ * query does not need. A plugin can therefore register a contract-only
+ * entry point with @c ELEKTRA_PLUGIN_CONTRACT in elektraPluginExport(),
+ * a function returning its static contract keyset. This function calls
+ * only that entry point; neither the plugin's open nor its get function
+ * is executed.
+ *
+ * @param pluginName the name of the plugin to query
+ * @param modules the keyset used for module loading, see elektraModulesInit()
+ * @param errorKey the key to store warnings in when loading fails
+ *
+ * @return the contract keyset, owned by the caller
+ * @retval NULL if the plugin could not be loaded or does not register the
+ * entry point; the caller then has to fall back to elektraPluginOpen()
+ * and the plugin's get function
+ * @ingroup plugin
+ * @see elektraPluginExport() for registering the entry point
+ */
+KeySet * elektraPluginGetContract (const char * pluginName, KeySet * modules, Key * errorKey)
+{
+	elektraPluginFactory pluginFactory = elektraModulesLoad (modules, pluginName, errorKey);
+	if (pluginFactory == 0)
+	{
+		/* warning already set by elektraModulesLoad */
+		return NULL;
+	}
+
+	Plugin * handle = pluginFactory ();
+	if (handle == 0)
+	{
+		ELEKTRA_ADD_INSTALLATION_WARNINGF (errorKey, "Could not call function exported by ELEKTRA_PLUGIN_EXPORT: %s", pluginName);
+		return NULL;
+	}
+
+	KeySet * contract = handle->kdbContract != NULL ? handle->kdbContract () : NULL;
+
+	// the factory handle was never opened, so there is nothing to close
+	elektraFree (handle);
+	return contract;
+}
+
+/**
+ * @internal
+ *
+ * @brief Calls the get function of the plugin, serving a cached result for
+ * plugins that declared their data immutable.
+ *
+ * A plugin declares memoization with the contract key
+ * system:/elektra/modules/<name>/infos/memoize set to "process"
+ * (usually via an `infos/memoize = process` line in its README).
+ * The first real get stores the keyset the plugin produced; subsequent
+ * gets append the cached keys - shared by reference count, nothing is
+ * copied - without invoking the plugin at all. Only plugins whose data
+ * is read only and stable for the lifetime of the process (hardware
+ * constants, package databases, session environment) may declare this.
+ *
+ * The declaration is looked up lazily from the plugin's own contract on
+ * the first call, so plugins without the contract key pay one cheap
+ * contract query and are then always called directly.
+ *
+ * @param plugin the plugin whose get function is to be called
+ * @param returned the keyset to append the result to
+ * @param parentKey the parent key for this get
+ *
+ * @return the return value of the plugin's get function, or 1 when the
+ *         cached keyset was served
+ */
+int elektraPluginMemoGet (Plugin * plugin, KeySet * returned, Key * parentKey)
+{
+	if (plugin->memoization == 0)
+	{
+		Key * contractParent = keyNew ("system:/elektra/modules", KEY_END);
+		keyAddBaseName (contractParent, plugin->name);
+		KeySet * contract = ksNew (0, KS_END);
+		plugin->kdbGet (plugin, contract, contractParent);
+		keyAddName (contractParent, "infos/memoize");
+		Key * memoizeKey = ksLookup (contract, contractParent, KDB_O_NONE);
+		plugin->memoization = memoizeKey && !elektraStrCmp (keyString (memoizeKey), "process") ? 2 : 1;
+		ksDel (contract);
+		keyDel (contractParent);
+	}
+
+	if (plugin->memoization == 1) return plugin->kdbGet (plugin, returned, parentKey);
+
+	if (!plugin->memo)
+	{
+		KeySet * fresh = ksNew (0, KS_END);
+		int ret = plugin->kdbGet (plugin, fresh, parentKey);
+		if (ret == -1)
+		{
+			ksDel (fresh);
+			return -1;
+		}
+		plugin->memo = fresh;
+		ksAppend (returned, plugin->memo);
+		return ret;
+	}
+
+	ksAppend (returned, plugin->memo);
+	return 1;
+}
+
 int elektraPluginClose (Plugin * handle, Key * errorKey)
 {
 	int rc = 0;
@@ -331,6 +437,7 @@ int elektraPluginClose (Plugin * handle, Key * errorKey)
 		if (rc == -1) ELEKTRA_ADD_RESOURCE_WARNING (errorKey, "Method 'kdbClose()' failed");
 	}
 
+	if (handle->memo) ksDel (handle->memo);
 	ksDel (handle->config);
 	elektraFree (handle);
 
@@ -0,0 +1,318 @@
+/**
+ * @file
+ *
+ * @brief Micro profiling with named timers and counters.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "kdbprivate.h"
+#include <kdb.h>
+#ifdef HAVE_KDBCONFIG_H
+#include "kdbconfig.h"
+#endif
+
+#ifdef HAVE_STDIO_H
+#include <stdio.h>
+#endif
+
+#ifdef HAVE_STDLIB_H
+#include <stdlib.h>
+#endif
+
+#ifdef HAVE_STRING_H
+#include <string.h>
+#endif
+
+#ifdef HAVE_TIME_H
+#include <time.h>
+#endif
+
+#ifdef ELEKTRA_HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <kdbassert.h>
+
+/**
+ * @defgroup timer Micro profiling
+ *
+ * A single timing surface for the core and for plugins, replacing
+ * plugin-local gettimeofday() wrappers. The timers are disabled unless
+ * the environment variable `KDB_TIMER` is set, so instrumented call
+ * sites only pay for one branch in production.
+ *
+ * Sections are named: elektraTimerBegin()/elektraTimerEnd() bracket a
+ * section, elektraTimerAdd() increments a named counter. On x86-64 the
+ * time stamp counter is read directly and calibrated against
+ * CLOCK_MONOTONIC when the results are reported, everywhere else
+ * clock_gettime() is used. kdbGet() and kdbSet() mark their phase
+ * boundaries, and the C++ binding wraps the API in kdbtimer.hpp.
+ *
+ * The recorded sections are dumped to stderr when the process exits, or
+ * explicitly with elektraTimerDump().
+ */
+
+/** an upper bound for distinct section names */
+#define ELEKTRA_TIMER_ENTRIES (128)
+
+/** an upper bound for nested elektraTimerBegin() calls per thread */
+#define ELEKTRA_TIMER_MAX_DEPTH (16)
+
+typedef struct
+{
+	const char * name;    /*!< section name, must outlive the process (a string literal) */
+	kdb_unsigned_long_long_t count; /*!< begin/end pairs or elektraTimerAdd() sum */
+	kdb_unsigned_long_long_t ticks; /*!< total raw ticks spent in the section */
+} TimerEntry;
+
+static TimerEntry timerEntries[ELEKTRA_TIMER_ENTRIES];
+static int timerEnabled = -1;
+
+#ifdef ELEKTRA_HAVE_PTHREAD
+static pthread_mutex_t timerLock = PTHREAD_MUTEX_INITIALIZER;
+#define TIMER_LOCK() pthread_mutex_lock (&timerLock)
+#define TIMER_UNLOCK() pthread_mutex_unlock (&timerLock)
+static __thread struct
+{
+	size_t entry;
+	kdb_unsigned_long_long_t start;
+} timerStack[ELEKTRA_TIMER_MAX_DEPTH];
+static __thread int timerDepth = 0;
+#else
+#define TIMER_LOCK()
+#define TIMER_UNLOCK()
+static struct
+{
+	size_t entry;
+	kdb_unsigned_long_long_t start;
+} timerStack[ELEKTRA_TIMER_MAX_DEPTH];
+static int timerDepth = 0;
+#endif
+
+static void timerDumpAtExit (void)
+{
+	elektraTimerDump (NULL);
+}
+
+/**
+ * @brief Whether the timers are recording.
+ *
+ * Controlled by the environment variable `KDB_TIMER`, checked once per
+ * process. Call sites doing more than a single elektraTimerBegin()/
+ * elektraTimerEnd() pair can skip their bookkeeping when it returns 0.
+ *
+ * @retval 1 the timers are recording
+ * @retval 0 the timers are disabled
+ * @ingroup timer
+ */
+int elektraTimerEnabled (void)
+{
+	if (timerEnabled == -1)
+	{
+		const char * env = getenv ("KDB_TIMER");
+		timerEnabled = env != NULL && env[0] != '\0' && strcmp (env, "0") != 0;
+		if (timerEnabled) atexit (timerDumpAtExit);
+	}
+	return timerEnabled;
+}
+
+/**
+ * @brief Reads the raw clock backing the timers.
+ *
+ * On x86-64 this is the time stamp counter, elsewhere CLOCK_MONOTONIC
+ * in nanoseconds. The unit is only meaningful relative to other calls
+ * within the same process; elektraTimerDump() converts to nanoseconds.
+ *
+ * @return the current raw tick count
+ * @ingroup timer
+ */
+kdb_unsigned_long_long_t elektraTimerTicks (void)
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+	unsigned int lo, hi;
+	__asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((kdb_unsigned_long_long_t) hi << 32) | lo;
+#else
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (kdb_unsigned_long_long_t) now.tv_sec * 1000000000ULL + (kdb_unsigned_long_long_t) now.tv_nsec;
+#endif
+}
+
+/**
+ * @internal
+ *
+ * @brief Finds or creates the entry for a section name.
+ *
+ * Must be called with the timer lock held.
+ *
+ * @retval ELEKTRA_TIMER_ENTRIES if the table is full
+ */
+static size_t timerFindEntry (const char * name)
+{
+	size_t hash = 5381;
+	for (const char * c = name; *c; ++c)
+	{
+		hash = hash * 33 + (unsigned char) *c;
+	}
+
+	size_t index = hash % ELEKTRA_TIMER_ENTRIES;
+	for (size_t probed = 0; probed < ELEKTRA_TIMER_ENTRIES; ++probed)
+	{
+		TimerEntry * entry = &timerEntries[index];
+		if (entry->name == NULL)
+		{
+			entry->name = name;
+			return index;
+		}
+		if (entry->name == name || strcmp (entry->name, name) == 0)
+		{
+			return index;
+		}
+		index = (index + 1) % ELEKTRA_TIMER_ENTRIES;
+	}
+	return ELEKTRA_TIMER_ENTRIES;
+}
+
+/**
+ * @brief Opens a named timer section.
+ *
+ * Sections may nest (up to 16 levels per thread), but
+ * elektraTimerEnd() must be called in reverse order of the begins,
+ * like a scope.
+ *
+ * @param name the section name, must be a string literal or otherwise
+ * outlive the process
+ * @ingroup timer
+ */
+void elektraTimerBegin (const char * name)
+{
+	if (!elektraTimerEnabled ()) return;
+	if (timerDepth >= ELEKTRA_TIMER_MAX_DEPTH) return;
+
+	TIMER_LOCK ();
+	size_t index = timerFindEntry (name);
+	TIMER_UNLOCK ();
+	if (index == ELEKTRA_TIMER_ENTRIES) return;
+
+	timerStack[timerDepth].entry = index;
+	timerStack[timerDepth].start = elektraTimerTicks ();
+	++timerDepth;
+}
+
+/**
+ * @brief Closes the innermost open timer section.
+ *
+ * @param name the section name passed to the matching
+ * elektraTimerBegin(), used to detect unbalanced sections
+ * @ingroup timer
+ */
+void elektraTimerEnd (const char * name)
+{
+	if (!elektraTimerEnabled ()) return;
+	kdb_unsigned_long_long_t now = elektraTimerTicks ();
+	if (timerDepth <= 0) return;
+
+	--timerDepth;
+	TimerEntry * entry = &timerEntries[timerStack[timerDepth].entry];
+	ELEKTRA_ASSERT (entry->name == name || strcmp (entry->name, name) == 0, "unbalanced timer section: began '%s', ended '%s'",
+			entry->name, name);
+	(void) name;
+
+	TIMER_LOCK ();
+	++entry->count;
+	entry->ticks += now - timerStack[timerDepth].start;
+	TIMER_UNLOCK ();
+}
+
+/**
+ * @brief Increments a named counter.
+ *
+ * Counters share the namespace with the timer sections and are
+ * reported with them, without a time column.
+ *
+ * @param name the counter name, must outlive the process
+ * @param value the amount to add
+ * @ingroup timer
+ */
+void elektraTimerAdd (const char * name, kdb_unsigned_long_long_t value)
+{
+	if (!elektraTimerEnabled ()) return;
+
+	TIMER_LOCK ();
+	size_t index = timerFindEntry (name);
+	if (index != ELEKTRA_TIMER_ENTRIES) timerEntries[index].count += value;
+	TIMER_UNLOCK ();
+}
+
+/**
+ * @internal
+ *
+ * @brief Measures how many raw ticks pass per nanosecond.
+ *
+ * Only needed on x86-64 where the raw ticks come from the time stamp
+ * counter; the calibration runs once, when the results are reported,
+ * so the hot path stays a single rdtsc.
+ */
+static double timerTicksPerNs (void)
+{
+#if defined(__x86_64__) && defined(__GNUC__)
+	static double ticksPerNs = 0.0;
+	if (ticksPerNs <= 0.0)
+	{
+		struct timespec begin, end;
+		struct timespec sleep = { 0, 10 * 1000 * 1000 }; // 10 ms
+		clock_gettime (CLOCK_MONOTONIC, &begin);
+		kdb_unsigned_long_long_t tscBegin = elektraTimerTicks ();
+		nanosleep (&sleep, NULL);
+		kdb_unsigned_long_long_t tscEnd = elektraTimerTicks ();
+		clock_gettime (CLOCK_MONOTONIC, &end);
+		kdb_unsigned_long_long_t elapsedNs =
+			(kdb_unsigned_long_long_t) (end.tv_sec - begin.tv_sec) * 1000000000ULL + (end.tv_nsec - begin.tv_nsec);
+		ticksPerNs = elapsedNs > 0 ? (double) (tscEnd - tscBegin) / (double) elapsedNs : 1.0;
+	}
+	return ticksPerNs;
+#else
+	return 1.0; // the raw ticks already are nanoseconds
+#endif
+}
+
+/**
+ * @brief Reports all recorded sections and counters.
+ *
+ * Writes one csv line `name,count,total_ns,avg_ns` per section, in the
+ * style of the Timer class in kdbtimer.hpp. Pure counters report their
+ * sum in the count column and 0 ns. When the timers are enabled, the
+ * report is also written to stderr when the process exits.
+ *
+ * @param path the file to append the report to, or NULL for stderr
+ * @ingroup timer
+ */
+void elektraTimerDump (const char * path)
+{
+	if (timerEnabled != 1) return;
+
+	FILE * out = stderr;
+	if (path != NULL)
+	{
+		out = fopen (path, "a");
+		if (out == NULL) return;
+	}
+
+	double ticksPerNs = timerTicksPerNs ();
+
+	TIMER_LOCK ();
+	for (size_t i = 0; i < ELEKTRA_TIMER_ENTRIES; ++i)
+	{
+		TimerEntry * entry = &timerEntries[i];
+		if (entry->name == NULL) continue;
+		kdb_unsigned_long_long_t totalNs = (kdb_unsigned_long_long_t) ((double) entry->ticks / ticksPerNs);
+		kdb_unsigned_long_long_t avgNs = entry->count > 0 ? totalNs / entry->count : 0;
+		fprintf (out, "%s," ELEKTRA_UNSIGNED_LONG_LONG_F "," ELEKTRA_UNSIGNED_LONG_LONG_F "," ELEKTRA_UNSIGNED_LONG_LONG_F "\n",
+			 entry->name, entry->count, totalNs, avgNs);
+	}
+	TIMER_UNLOCK ();
+
+	if (out != stderr) fclose (out);
+}
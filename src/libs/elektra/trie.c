@@ -33,7 +33,9 @@
 #include "kdbinternal.h"
 
 static char * elektraTrieStartsWith (const char * str, const char * substr);
-static Backend * elektraTriePrefixLookup (Trie * trie, const char * name);
+static Backend * elektraTriePrefixLookup (const Trie * trie, const char * name);
+static Backend * elektraTrieFlatLookup (const TrieFlatNode * flat, const char * flatText, const char * name);
+static void elektraTrieFlatDiscard (Trie * trie);
 
 /**
  * @brief The Trie structure
@@ -42,25 +44,37 @@ static Backend * elektraTriePrefixLookup (Trie * trie, const char * name);
 /**
  * Lookups a backend inside the trie.
  *
+ * The trie is only modified while mounting, i.e. during kdbOpen().
+ * Lookups never mutate the trie and do not allocate for typical
+ * name lengths, so once a trie has been published any number of
+ * threads may call trieLookup() on it concurrently.
+ *
+ * When the trie has been flattened with trieFinalize() the lookup
+ * runs on the compact BFS-ordered copy, otherwise it walks the
+ * pointer-based nodes directly.
+ *
  * @return the backend if found
  * @return 0 otherwise
  * @param trie the trie object to work with
  * @param key the name of this key will be looked up
  * @ingroup trie
  */
-Backend * trieLookup (Trie * trie, const char * name)
+Backend * trieLookup (const Trie * trie, const char * name)
 {
 	if (!name) return 0;
 	if (!trie) return 0;
 
 	size_t len = strlen (name) + 2;
 	if (len <= 1) return 0; // would crash otherwise
-	char * where = elektraMalloc (len);
+
+	char stackSpace[256];
+	char * where = len <= sizeof (stackSpace) ? stackSpace : elektraMalloc (len);
 	strncpy (where, name, len);
 	where[len - 2] = '/';
 
-	Backend * ret = elektraTriePrefixLookup (trie, where);
-	elektraFree (where);
+	Backend * ret = trie->flat != NULL ? elektraTrieFlatLookup (trie->flat, trie->flatText, where) :
+					     elektraTriePrefixLookup (trie, where);
+	if (where != stackSpace) elektraFree (where);
 
 	return ret;
 }
@@ -90,6 +104,7 @@ int trieClose (Trie * trie, Key * errorKey)
 	{
 		backendClose (trie->empty_value, errorKey);
 	}
+	elektraTrieFlatDiscard (trie);
 	elektraFree (trie);
 	return 0;
 }
@@ -115,6 +130,9 @@ Trie * trieInsert (Trie * trie, const char * name, Backend * value)
 	}
 	idx = (unsigned char) name[0];
 
+	// the flattened copy no longer matches once something is inserted
+	if (trie != NULL) elektraTrieFlatDiscard (trie);
+
 	if (trie == NULL)
 	{
 		trie = elektraCalloc (sizeof (Trie));
@@ -186,6 +204,106 @@ Trie * trieInsert (Trie * trie, const char * name, Backend * value)
 	return trie;
 }
 
+/**
+ * @internal
+ *
+ * Counts the entries and the total text size of a (sub)trie.
+ */
+static void elektraTrieFlatCount (const Trie * trie, size_t * nodes, size_t * textSize)
+{
+	if (trie == NULL) return;
+	for (size_t i = 0; i < KDB_MAX_UCHAR; ++i)
+	{
+		if (trie->text[i] == NULL) continue;
+		*nodes += 1;
+		*textSize += trie->textlen[i];
+		elektraTrieFlatCount (trie->children[i], nodes, textSize);
+	}
+}
+
+/**
+ * @brief Builds the flattened copy of the trie used by trieLookup().
+ *
+ * The pointer-based trie is convenient to build incrementally while
+ * mounting, but its nodes are large and sparse, so a lookup walks
+ * through several unrelated cache lines per level. This function packs
+ * the trie into a small array of TrieFlatNode laid out in BFS order:
+ * all children of one node are adjacent and their texts share a single
+ * buffer, so the descent done for every kdbGet()/kdbSet() stays within
+ * a few cache lines.
+ *
+ * Should be called once mounting is finished. A later trieInsert()
+ * discards the copy again, so the flattened and the pointer-based trie
+ * can never disagree.
+ *
+ * @param trie the trie to finalize (may be NULL)
+ * @ingroup trie
+ */
+void trieFinalize (Trie * trie)
+{
+	if (trie == NULL || trie->flat != NULL) return;
+
+	size_t nodes = 1; // pseudo-root node
+	size_t textSize = 0;
+	elektraTrieFlatCount (trie, &nodes, &textSize);
+
+	TrieFlatNode * flat = elektraMalloc (nodes * sizeof (TrieFlatNode));
+	char * flatText = textSize > 0 ? elektraMalloc (textSize) : NULL;
+	// queue[f] is the pointer-based node whose entries become the children of flat[f]
+	const Trie ** queue = elektraMalloc (nodes * sizeof (const Trie *));
+
+	flat[0].textOffset = 0;
+	flat[0].textLen = 0;
+	flat[0].value = NULL;
+	flat[0].emptyValue = trie->empty_value;
+	queue[0] = trie;
+
+	size_t used = 1;
+	size_t textUsed = 0;
+	for (size_t f = 0; f < used; ++f)
+	{
+		const Trie * node = queue[f];
+		flat[f].firstChild = used;
+		flat[f].childCount = 0;
+		if (node == NULL) continue;
+
+		for (size_t i = 0; i < KDB_MAX_UCHAR; ++i)
+		{
+			if (node->text[i] == NULL) continue;
+			flat[used].textOffset = textUsed;
+			flat[used].textLen = node->textlen[i];
+			memcpy (flatText + textUsed, node->text[i], node->textlen[i]);
+			textUsed += node->textlen[i];
+			flat[used].value = node->value[i];
+			flat[used].emptyValue = node->children[i] == NULL ? NULL : node->children[i]->empty_value;
+			queue[used] = node->children[i];
+			++used;
+			++flat[f].childCount;
+		}
+	}
+
+	elektraFree (queue);
+	trie->flat = flat;
+	trie->flatText = flatText;
+}
+
+/**
+ * @internal
+ *
+ * Frees the flattened copy of the trie, if one was built.
+ */
+static void elektraTrieFlatDiscard (Trie * trie)
+{
+	if (trie->flat == NULL) return;
+	elektraFree (trie->flat);
+	trie->flat = NULL;
+	if (trie->flatText != NULL)
+	{
+		elektraFree (trie->flatText);
+		trie->flatText = NULL;
+	}
+}
+
 
 #if 0
 
@@ -241,7 +359,7 @@ static char * elektraTrieStartsWith (const char * str, const char * substr)
 	return 0;
 }
 
-static Backend * elektraTriePrefixLookup (Trie * trie, const char * name)
+static Backend * elektraTriePrefixLookup (const Trie * trie, const char * name)
 {
 	if (trie == NULL) return NULL;
 
@@ -271,3 +389,48 @@ static Backend * elektraTriePrefixLookup (Trie * trie, const char * name)
 
 	return ret;
 }
+
+/**
+ * @internal
+ *
+ * Same lookup as elektraTriePrefixLookup(), but on the flattened copy
+ * built by trieFinalize(). The children of a node are adjacent and
+ * ordered by their first character, so each level is a short scan of
+ * one contiguous range instead of an indirection through a sparse
+ * KDB_MAX_UCHAR-sized node.
+ */
+static Backend * elektraTrieFlatLookup (const TrieFlatNode * flat, const char * flatText, const char * name)
+{
+	const TrieFlatNode * node = &flat[0];
+	// deepest backend a failed descent must fall back to, see elektraTriePrefixLookup()
+	Backend * found = NULL;
+
+	for (;;)
+	{
+		const TrieFlatNode * child = NULL;
+		for (size_t i = node->firstChild; i < node->firstChild + node->childCount; ++i)
+		{
+			if (flatText[flat[i].textOffset] == name[0])
+			{
+				child = &flat[i];
+				break;
+			}
+		}
+
+		if (child == NULL || strncmp (name, flatText + child->textOffset, child->textLen) != 0)
+		{
+			return node->emptyValue != NULL ? node->emptyValue : found;
+		}
+
+		if (child->value != NULL)
+		{
+			found = child->value;
+		}
+		else if (node->emptyValue != NULL)
+		{
+			found = node->emptyValue;
+		}
+		name += child->textLen;
+		node = child;
+	}
+}
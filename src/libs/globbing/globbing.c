@@ -56,6 +56,15 @@ static bool isArrayName (const char * name)
 	return elektraArrayValidateBaseNameString (name) > 0;
 }
 
+struct _ElektraGlobPattern
+{
+	char * pattern; /*!< the original globbing pattern */
+	char * fnmPattern; /*!< the pattern translated for fnmatch(3), truncated in prefix mode */
+	size_t slashes; /*!< number of relevant slashes in the pattern */
+	size_t literalPrefixLen; /*!< length of the leading part of fnmPattern without metacharacters */
+	bool prefixMode; /*!< whether the pattern ends with "/__" */
+};
+
 static int checkElektraExtensions (const char * name, const char * pattern)
 {
 	const char * ptr = pattern;
@@ -119,35 +128,170 @@ int elektraKeyGlob (const Key * key, const char * pattern)
 		return ELEKTRA_GLOB_NOMATCH;
 	}
 
-	size_t nameSize = (size_t) keyGetNameSize (key);
-	char * name = elektraMalloc (nameSize);
-	keyGetName (key, name, nameSize);
+	ElektraGlobPattern * compiled = elektraGlobCompile (pattern);
+	int rc = elektraKeyGlobCompiled (key, compiled);
+	elektraGlobPatternDel (compiled);
+	return rc;
+}
 
-	size_t len = strlen (pattern);
-	bool prefixMode = len >= 2 && elektraStrCmp (pattern + len - 3, "/__") == 0;
+/**
+ * @brief compiles a globbing pattern for repeated matching
+ *
+ * Translating a pattern for the matcher takes longer than matching a single
+ * key name against it. When the same pattern is matched against many keys
+ * (e.g. a spec glob against a whole KeySet), compile it once and use
+ * elektraKeyGlobCompiled() instead of elektraKeyGlob().
+ *
+ * @param pattern the globbing pattern to compile
+ * @return the compiled pattern (free with elektraGlobPatternDel()),
+ * 	   or NULL if @p pattern is NULL
+ *
+ * @see elektraKeyGlob(), for explanation of globbing patterns
+ */
+ElektraGlobPattern * elektraGlobCompile (const char * pattern)
+{
+	if (pattern == NULL)
+	{
+		return NULL;
+	}
+
+	ElektraGlobPattern * compiled = elektraMalloc (sizeof (struct _ElektraGlobPattern));
+	compiled->pattern = elektraStrDup (pattern);
 
-	size_t patternSlashes = strcnt (pattern, '/');
+	size_t len = strlen (pattern);
+	compiled->prefixMode = len >= 2 && elektraStrCmp (pattern + len - 3, "/__") == 0;
 
-	if (prefixMode)
+	compiled->slashes = strcnt (pattern, '/');
+	if (compiled->prefixMode)
 	{
 		// last slash in pattern is treated specially
-		patternSlashes--;
+		compiled->slashes--;
+	}
+
+	compiled->fnmPattern = elektraToFnmatchGlob (elektraStrDup (pattern));
+	if (compiled->prefixMode)
+	{
+		// remove __ from end
+		*(compiled->fnmPattern + len - 3) = '\0';
+	}
+
+	compiled->literalPrefixLen = strcspn (compiled->fnmPattern, "*?[");
+
+	return compiled;
+}
+
+/**
+ * @brief returns the literal leading key parts of a compiled pattern
+ *
+ * The returned prefix consists only of complete key name parts without any
+ * metacharacters, e.g. for the pattern "/server/po*&#47;timeout" it is "/server".
+ * Only keys below (or same as) this prefix can possibly match the pattern, so
+ * callers matching a pattern against a sorted KeySet can restrict the scan to
+ * the subtree of the prefix instead of testing every key.
+ *
+ * For patterns starting with a metacharacter part the prefix degenerates
+ * to "/".
+ *
+ * @param pattern the compiled pattern
+ * @param prefix set to the start of the prefix (borrowed from @p pattern,
+ * 	  valid until elektraGlobPatternDel()), or NULL if @p pattern is NULL
+ * @return the length of the prefix in bytes (it is not null-terminated)
+ */
+size_t elektraGlobPatternPrefix (const ElektraGlobPattern * pattern, const char ** prefix)
+{
+	if (pattern == NULL)
+	{
+		if (prefix != NULL) *prefix = NULL;
+		return 0;
+	}
+
+	if (prefix != NULL) *prefix = pattern->fnmPattern;
+
+	if (pattern->fnmPattern[pattern->literalPrefixLen] == '\0')
+	{
+		// the whole (translated) pattern is literal; in prefix mode the
+		// trailing "/__" is already cut off, so all parts are complete
+		return pattern->literalPrefixLen;
+	}
+
+	// cut back to the last complete part
+	size_t len = pattern->literalPrefixLen;
+	while (len > 0 && pattern->fnmPattern[len - 1] != '/')
+	{
+		--len;
+	}
+	if (len > 1)
+	{
+		--len; // drop the trailing slash, but keep a sole "/"
+	}
+	return len;
+}
+
+/**
+ * @brief frees a pattern compiled with elektraGlobCompile()
+ *
+ * @param pattern the compiled pattern to free. May be NULL.
+ */
+void elektraGlobPatternDel (ElektraGlobPattern * pattern)
+{
+	if (pattern == NULL)
+	{
+		return;
+	}
+
+	elektraFree (pattern->pattern);
+	elektraFree (pattern->fnmPattern);
+	elektraFree (pattern);
+}
+
+/**
+ * @brief checks whether a given Key matches a compiled globbing pattern
+ *
+ * Behaves like elektraKeyGlob(), but uses a pattern compiled with
+ * elektraGlobCompile(), so the pattern translation cost is paid only once.
+ * Keys whose name does not start with the literal (metacharacter-free) prefix
+ * of the pattern are rejected with a plain string comparison before the
+ * matcher runs.
+ *
+ * @param key the Key to match against the compiled globbing pattern
+ * @param pattern the compiled globbing pattern used
+ * @retval 0 if @p key is not NULL, @p pattern is not NULL and @p pattern matches @p key
+ * @retval ELEKTRA_GLOB_NOMATCH otherwise
+ *
+ * @see elektraKeyGlob(), for explanation of globbing patterns
+ */
+int elektraKeyGlobCompiled (const Key * key, const ElektraGlobPattern * pattern)
+{
+	if (key == NULL || pattern == NULL)
+	{
+		return ELEKTRA_GLOB_NOMATCH;
+	}
+
+	size_t nameSize = (size_t) keyGetNameSize (key);
+	char * name = elektraMalloc (nameSize);
+	keyGetName (key, name, nameSize);
+
+	if (strncmp (name, pattern->fnmPattern, pattern->literalPrefixLen) != 0)
+	{
+		// name does not start with the literal prefix of the pattern
+		elektraFree (name);
+		return ELEKTRA_GLOB_NOMATCH;
 	}
 
 	char * patternEnd = name;
-	for (size_t i = 0; i < patternSlashes; ++i)
+	for (size_t i = 0; i < pattern->slashes; ++i)
 	{
 		patternEnd = strchr (patternEnd + 1, '/');
 
 		if (patternEnd == NULL)
 		{
 			// more slashes in pattern, cannot match
-			free (name);
+			elektraFree (name);
 			return ELEKTRA_GLOB_NOMATCH;
 		}
 	}
 
-	if (prefixMode)
+	if (pattern->prefixMode)
 	{
 		// mark end of relevant part
 		char * next = strchr (patternEnd + 1, '/');
@@ -159,29 +303,21 @@ int elektraKeyGlob (const Key * key, const char * pattern)
 	else if (strchr (patternEnd + 1, '/') != NULL)
 	{
 		// more slashes in name, cannot match
-		free (name);
+		elektraFree (name);
 		return ELEKTRA_GLOB_NOMATCH;
 	}
 
-	char * fnmPattern = elektraToFnmatchGlob (elektraStrDup (pattern));
-	if (prefixMode)
-	{
-		// remove __ from end
-		*(fnmPattern + len - 3) = '\0';
-	}
-
-	int rc = fnmatch (fnmPattern, name, FNM_PATHNAME | FNM_NOESCAPE);
-	elektraFree (fnmPattern);
+	int rc = fnmatch (pattern->fnmPattern, name, FNM_PATHNAME | FNM_NOESCAPE);
 
 	if (rc == FNM_NOMATCH)
 	{
-		free (name);
+		elektraFree (name);
 		return ELEKTRA_GLOB_NOMATCH;
 	}
 
-	rc = checkElektraExtensions (name, pattern);
+	rc = checkElektraExtensions (name, pattern->pattern);
 
-	free (name);
+	elektraFree (name);
 
 	return rc;
 }
@@ -208,11 +344,13 @@ int elektraKsGlob (KeySet * result, KeySet * input, const char * pattern)
 	int ret = 0;
 	Key * current;
 
+	ElektraGlobPattern * compiled = elektraGlobCompile (pattern);
+
 	elektraCursor cursor = ksGetCursor (input);
 	ksRewind (input);
 	while ((current = ksNext (input)) != 0)
 	{
-		int rc = elektraKeyGlob (current, pattern);
+		int rc = elektraKeyGlobCompiled (current, compiled);
 		if (rc == 0)
 		{
 			++ret;
@@ -220,5 +358,7 @@ int elektraKsGlob (KeySet * result, KeySet * input, const char * pattern)
 		}
 	}
 	ksSetCursor (input, cursor);
+
+	elektraGlobPatternDel (compiled);
 	return ret;
 }
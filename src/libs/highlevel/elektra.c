@@ -224,6 +224,14 @@ void elektraClose (Elektra * elektra)
 	ksDel (elektra->config);
 	keyDel (elektra->lookupKey);
 
+	for (size_t i = 0; i < ELEKTRA_FIND_CACHE_SIZE; ++i)
+	{
+		if (elektra->findCache[i].name != NULL)
+		{
+			elektraFree (elektra->findCache[i].name);
+		}
+	}
+
 	if (elektra->resolvedReference != NULL)
 	{
 		elektraFree (elektra->resolvedReference);
@@ -277,6 +285,10 @@ void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
 	int ret = 0;
 	do
 	{
+		// the config KeySet is about to change, invalidate the positions
+		// memoized by elektraFindKey()
+		elektra->configGeneration++;
+
 		ksAppendKey (elektra->config, key);
 
 		ret = kdbSet (elektra->kdb, elektra->config, elektra->parentKey);
@@ -301,6 +313,9 @@ void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
 			kdbGet (elektra->kdb, elektra->config, elektra->parentKey);
 		}
 	} while (ret == -1);
+
+	// kdbSet() may have modified the config KeySet as well
+	elektra->configGeneration++;
 }
 
 void insertDefaults (KeySet * config, const Key * parentKey, KeySet * defaults)
@@ -30,26 +30,63 @@ extern "C" {
  */
 
 /**
- * Helper function for code generation.
- *
- * Finds a Key from its relative name. Also checks type metadata,
- * if @p type is not NULL.
+ * @internal
+ * FNV-1a hash of a relative key name, reduced to a find cache slot index.
+ */
+static size_t elektraFindCacheSlot (const char * name)
+{
+	size_t hash = 2166136261u;
+	for (const char * c = name; *c != '\0'; ++c)
+	{
+		hash = (hash ^ (unsigned char) *c) * 16777619u;
+	}
+	return hash & (ELEKTRA_FIND_CACHE_SIZE - 1);
+}
+
+/**
+ * @internal
+ * Finds a Key like elektraFindKey(), but additionally reports the find cache
+ * slot that memoizes the key's position.
  *
- * @param elektra The Elektra instance to use.
- * @param name    The relative name of the key.
- * @param type    The expected type metadata value.
- * @return the Key referenced by @p name or NULL, if a fatal error occurs and the fatal error handler returns to this function
- *   The returned pointer remains valid until the KeySet inside @p elektra is modified. Calls to elektraSet*() functions may
- *   cause such modifications. In any case, it becomes invalid when elektraClose() is called on @p elektra.
+ * @p slotOut is only set, if the returned key was found via the cache or its
+ * position could be memoized. The slot may then be used to memoize the key's
+ * converted native value as well.
  */
-Key * elektraFindKey (Elektra * elektra, const char * name, KDBType type)
+static Key * elektraFindKeyWithSlot (Elektra * elektra, const char * name, KDBType type, struct _ElektraFindCacheSlot ** slotOut)
 {
-	elektraSetLookupKey (elektra, name);
-	Key * const resultKey = ksLookup (elektra->config, elektra->lookupKey, 0);
-	if (resultKey == NULL)
+	Key * resultKey = NULL;
+
+	struct _ElektraFindCacheSlot * slot = &elektra->findCache[elektraFindCacheSlot (name)];
+	if (slot->name != NULL && slot->generation == elektra->configGeneration && strcmp (slot->name, name) == 0)
 	{
-		elektraFatalError (elektra, elektraErrorKeyNotFound (keyName (elektra->lookupKey)));
-		return NULL;
+		resultKey = ksAtCursor (elektra->config, slot->index);
+		*slotOut = slot;
+	}
+	else
+	{
+		elektraSetLookupKey (elektra, name);
+		// the core memo in the slot often still points at the right key
+		// (e.g. after a save that only changed values), then the lookup
+		// degenerates to a single name compare
+		resultKey = ksLookupCached (elektra->config, elektra->lookupKey, 0, &slot->hint);
+		if (resultKey == NULL)
+		{
+			elektraFatalError (elektra, elektraErrorKeyNotFound (keyName (elektra->lookupKey)));
+			return NULL;
+		}
+
+		if (slot->hint.generation != 0)
+		{
+			if (slot->name != NULL)
+			{
+				elektraFree (slot->name);
+			}
+			slot->name = elektraStrDup (name);
+			slot->generation = elektra->configGeneration;
+			slot->index = (elektraCursor) slot->hint.position;
+			slot->valueType = NULL;
+			*slotOut = slot;
+		}
 	}
 
 	if (type != NULL)
@@ -57,7 +94,7 @@ Key * elektraFindKey (Elektra * elektra, const char * name, KDBType type)
 		const char * actualType = keyString (keyGetMeta (resultKey, "type"));
 		if (strcmp (actualType, type) != 0)
 		{
-			elektraFatalError (elektra, elektraErrorWrongType (keyName (elektra->lookupKey), type, actualType));
+			elektraFatalError (elektra, elektraErrorWrongType (keyName (resultKey), type, actualType));
 			return NULL;
 		}
 	}
@@ -65,6 +102,30 @@ Key * elektraFindKey (Elektra * elektra, const char * name, KDBType type)
 	return resultKey;
 }
 
+/**
+ * Helper function for code generation.
+ *
+ * Finds a Key from its relative name. Also checks type metadata,
+ * if @p type is not NULL.
+ *
+ * The position of every found key is memoized per name, so repeated reads of
+ * the same key resolve to a direct index into the config KeySet instead of a
+ * full name lookup. The memoized positions are invalidated whenever the
+ * config KeySet is modified (see elektraSaveKey()).
+ *
+ * @param elektra The Elektra instance to use.
+ * @param name    The relative name of the key.
+ * @param type    The expected type metadata value.
+ * @return the Key referenced by @p name or NULL, if a fatal error occurs and the fatal error handler returns to this function
+ *   The returned pointer remains valid until the KeySet inside @p elektra is modified. Calls to elektraSet*() functions may
+ *   cause such modifications. In any case, it becomes invalid when elektraClose() is called on @p elektra.
+ */
+Key * elektraFindKey (Elektra * elektra, const char * name, KDBType type)
+{
+	struct _ElektraFindCacheSlot * slot = NULL;
+	return elektraFindKeyWithSlot (elektra, name, type, &slot);
+}
+
 /**
  * Resolves the reference stored in a key.
  * 1. Get the raw string value.
@@ -167,12 +228,26 @@ void elektraSetRawString (Elektra * elektra, const char * name, const char * val
 	elektraSaveKey (elektra, key, error);
 }
 
-#define ELEKTRA_GET_VALUE(KEY_TO_VALUE, KDB_TYPE, elektra, keyname, result)                                                                \
-	const Key * key = elektraFindKey (elektra, keyname, KDB_TYPE);                                                                     \
-	if (key == NULL || !KEY_TO_VALUE (key, &result))                                                                                   \
+// Converted native values are memoized in the find cache slot of the key, so
+// in the steady state a read is a direct index into the config KeySet plus a
+// copy of the stored native value. The string value is parsed again only
+// after the config KeySet was modified.
+#define ELEKTRA_GET_VALUE(KEY_TO_VALUE, KDB_TYPE, elektra, keyname, result, field)                                                         \
+	struct _ElektraFindCacheSlot * slot = NULL;                                                                                        \
+	const Key * key = elektraFindKeyWithSlot (elektra, keyname, KDB_TYPE, &slot);                                                      \
+	if (slot != NULL && slot->valueType == KDB_TYPE)                                                                                   \
+	{                                                                                                                                  \
+		result = slot->value.field;                                                                                                \
+	}                                                                                                                                  \
+	else if (key == NULL || !KEY_TO_VALUE (key, &result))                                                                              \
 	{                                                                                                                                  \
 		elektraFatalError (elektra, elektraErrorConversionFromString (KDB_TYPE, keyname, keyString (key)));                        \
 		result = 0;                                                                                                                \
+	}                                                                                                                                  \
+	else if (slot != NULL)                                                                                                             \
+	{                                                                                                                                  \
+		slot->value.field = result;                                                                                                \
+		slot->valueType = KDB_TYPE;                                                                                                \
 	}
 
 /**
@@ -188,7 +263,7 @@ void elektraSetRawString (Elektra * elektra, const char * name, const char * val
 const char * elektraGetString (Elektra * elektra, const char * keyname)
 {
 	const char * result;
-	ELEKTRA_GET_VALUE (elektraKeyToString, KDB_TYPE_STRING, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToString, KDB_TYPE_STRING, elektra, keyname, result, stringValue);
 	return result;
 }
 
@@ -202,7 +277,7 @@ const char * elektraGetString (Elektra * elektra, const char * keyname)
 kdb_boolean_t elektraGetBoolean (Elektra * elektra, const char * keyname)
 {
 	kdb_boolean_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToBoolean, KDB_TYPE_BOOLEAN, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToBoolean, KDB_TYPE_BOOLEAN, elektra, keyname, result, booleanValue);
 	return result;
 }
 
@@ -216,7 +291,7 @@ kdb_boolean_t elektraGetBoolean (Elektra * elektra, const char * keyname)
 kdb_char_t elektraGetChar (Elektra * elektra, const char * keyname)
 {
 	kdb_char_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToChar, KDB_TYPE_CHAR, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToChar, KDB_TYPE_CHAR, elektra, keyname, result, charValue);
 	return result;
 }
 
@@ -230,7 +305,7 @@ kdb_char_t elektraGetChar (Elektra * elektra, const char * keyname)
 kdb_octet_t elektraGetOctet (Elektra * elektra, const char * keyname)
 {
 	kdb_octet_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToOctet, KDB_TYPE_OCTET, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToOctet, KDB_TYPE_OCTET, elektra, keyname, result, octetValue);
 	return result;
 }
 
@@ -244,7 +319,7 @@ kdb_octet_t elektraGetOctet (Elektra * elektra, const char * keyname)
 kdb_short_t elektraGetShort (Elektra * elektra, const char * keyname)
 {
 	kdb_short_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToShort, KDB_TYPE_SHORT, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToShort, KDB_TYPE_SHORT, elektra, keyname, result, shortValue);
 	return result;
 }
 
@@ -258,7 +333,7 @@ kdb_short_t elektraGetShort (Elektra * elektra, const char * keyname)
 kdb_unsigned_short_t elektraGetUnsignedShort (Elektra * elektra, const char * keyname)
 {
 	kdb_unsigned_short_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToUnsignedShort, KDB_TYPE_UNSIGNED_SHORT, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToUnsignedShort, KDB_TYPE_UNSIGNED_SHORT, elektra, keyname, result, unsignedShortValue);
 	return result;
 }
 
@@ -272,7 +347,7 @@ kdb_unsigned_short_t elektraGetUnsignedShort (Elektra * elektra, const char * ke
 kdb_long_t elektraGetLong (Elektra * elektra, const char * keyname)
 {
 	kdb_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToLong, KDB_TYPE_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToLong, KDB_TYPE_LONG, elektra, keyname, result, longValue);
 	return result;
 }
 
@@ -286,7 +361,7 @@ kdb_long_t elektraGetLong (Elektra * elektra, const char * keyname)
 kdb_unsigned_long_t elektraGetUnsignedLong (Elektra * elektra, const char * keyname)
 {
 	kdb_unsigned_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLong, KDB_TYPE_UNSIGNED_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLong, KDB_TYPE_UNSIGNED_LONG, elektra, keyname, result, unsignedLongValue);
 	return result;
 }
 
@@ -300,7 +375,7 @@ kdb_unsigned_long_t elektraGetUnsignedLong (Elektra * elektra, const char * keyn
 kdb_long_long_t elektraGetLongLong (Elektra * elektra, const char * keyname)
 {
 	kdb_long_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToLongLong, KDB_TYPE_LONG_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToLongLong, KDB_TYPE_LONG_LONG, elektra, keyname, result, longLongValue);
 	return result;
 }
 
@@ -314,7 +389,7 @@ kdb_long_long_t elektraGetLongLong (Elektra * elektra, const char * keyname)
 kdb_unsigned_long_long_t elektraGetUnsignedLongLong (Elektra * elektra, const char * keyname)
 {
 	kdb_unsigned_long_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLongLong, KDB_TYPE_UNSIGNED_LONG_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLongLong, KDB_TYPE_UNSIGNED_LONG_LONG, elektra, keyname, result, unsignedLongLongValue);
 	return result;
 }
 
@@ -328,7 +403,7 @@ kdb_unsigned_long_long_t elektraGetUnsignedLongLong (Elektra * elektra, const ch
 kdb_float_t elektraGetFloat (Elektra * elektra, const char * keyname)
 {
 	kdb_float_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToFloat, KDB_TYPE_FLOAT, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToFloat, KDB_TYPE_FLOAT, elektra, keyname, result, floatValue);
 	return result;
 }
 
@@ -342,7 +417,7 @@ kdb_float_t elektraGetFloat (Elektra * elektra, const char * keyname)
 kdb_double_t elektraGetDouble (Elektra * elektra, const char * keyname)
 {
 	kdb_double_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToDouble, KDB_TYPE_DOUBLE, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToDouble, KDB_TYPE_DOUBLE, elektra, keyname, result, doubleValue);
 	return result;
 }
 
@@ -358,7 +433,7 @@ kdb_double_t elektraGetDouble (Elektra * elektra, const char * keyname)
 kdb_long_double_t elektraGetLongDouble (Elektra * elektra, const char * keyname)
 {
 	kdb_long_double_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToLongDouble, KDB_TYPE_LONG_DOUBLE, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToLongDouble, KDB_TYPE_LONG_DOUBLE, elektra, keyname, result, longDoubleValue);
 	return result;
 }
 
@@ -12,11 +12,23 @@
 
 #include <stdio.h>
 
+/**
+ * Cached result of a function resolution, one entry per requested name.
+ * @internal
+ */
+typedef struct _ElektraInvokeFunction
+{
+	char * name;
+	const void * function; /*!< may be NULL, if the plugin does not export the function */
+	struct _ElektraInvokeFunction * next;
+} _ElektraInvokeFunction;
+
 struct _ElektraInvokeHandle
 {
 	Plugin * plugin;
 	KeySet * modules;
 	KeySet * exports;
+	_ElektraInvokeFunction * functions;
 };
 
 /**
@@ -164,6 +176,17 @@ const void * elektraInvokeGetFunction (ElektraInvokeHandle * handle, const char
 	{
 		return NULL;
 	}
+
+	// every resolved name is cached on the handle, so repeated invocations
+	// do not walk the exports key set again
+	for (_ElektraInvokeFunction * cached = handle->functions; cached != NULL; cached = cached->next)
+	{
+		if (elektraStrCmp (cached->name, elektraPluginFunctionName) == 0)
+		{
+			return cached->function;
+		}
+	}
+
 	Plugin * plugin = handle->plugin;
 	KeySet * exports = NULL;
 
@@ -184,14 +207,20 @@ const void * elektraInvokeGetFunction (ElektraInvokeHandle * handle, const char
 	keyAddBaseName (exportParent, elektraPluginFunctionName);
 	Key * functionKey = ksLookup (exports, exportParent, 0);
 	keyDel (exportParent);
-	if (!functionKey)
-	{
-		return NULL;
-	}
-	else
+
+	const void * function = functionKey == NULL ? NULL : keyValue (functionKey);
+
+	_ElektraInvokeFunction * cached = elektraMalloc (sizeof (_ElektraInvokeFunction));
+	if (cached != NULL)
 	{
-		return keyValue (functionKey);
+		// missing functions are cached as well (function == NULL)
+		cached->name = elektraStrDup (elektraPluginFunctionName);
+		cached->function = function;
+		cached->next = handle->functions;
+		handle->functions = cached;
 	}
+
+	return function;
 }
 
 /**
@@ -334,6 +363,16 @@ void elektraInvokeClose (ElektraInvokeHandle * handle, Key * errorKey)
 	elektraModulesClose (handle->modules, NULL);
 	ksDel (handle->modules);
 	ksDel (handle->exports);
+
+	_ElektraInvokeFunction * cached = handle->functions;
+	while (cached != NULL)
+	{
+		_ElektraInvokeFunction * next = cached->next;
+		elektraFree (cached->name);
+		elektraFree (cached);
+		cached = next;
+	}
+
 	elektraFree (handle);
 }
 
@@ -45,6 +45,20 @@ struct _Module
 	} symbol;
 };
 
+#ifdef __GNUC__
+/* Registry of plugins linked directly into the library (see the
+   PRELOADED_PLUGINS build option). The weak declaration makes the registry
+   optional: without it the symbol resolves to NULL and every module is
+   loaded with dlopen(). */
+typedef struct
+{
+	const char * name;
+	void (*function) (void);
+} kdblib_preloaded_plugin;
+
+extern kdblib_preloaded_plugin kdb_preloaded_plugins[] ELEKTRA_WEAK;
+#endif
+
 int elektraModulesInit (KeySet * modules, Key * error ELEKTRA_UNUSED)
 {
 	ksAppendKey (modules, keyNew ("system:/elektra/modules", KEY_END));
@@ -70,6 +84,26 @@ elektraPluginFactory elektraModulesLoad (KeySet * modules, const char * name, Ke
 		return module->symbol.f;
 	}
 
+#ifdef __GNUC__
+	if (kdb_preloaded_plugins != NULL)
+	{
+		for (kdblib_preloaded_plugin * preloaded = kdb_preloaded_plugins; preloaded->name != NULL; ++preloaded)
+		{
+			if (strcmp (preloaded->name, name) == 0)
+			{
+				Module module;
+				module.handle = NULL;
+				module.symbol.f = (elektraPluginFactory) preloaded->function;
+
+				keySetBinary (moduleKey, &module, sizeof (Module));
+				ksAppendKey (modules, moduleKey);
+
+				return module.symbol.f;
+			}
+		}
+	}
+#endif
+
 	char * moduleName = elektraMalloc (sizeof ("libelektra-") + strlen (name) + sizeof (elektraPluginPostfix) + 1);
 
 	strcpy (moduleName, "libelektra-");
@@ -127,7 +161,8 @@ int elektraModulesClose (KeySet * modules, Key * errorKey)
 	while ((cur = ksPop (modules)) != 0)
 	{
 		Module * module = (Module *) keyValue (cur);
-		if (dlclose (module->handle) != 0)
+		// preloaded modules have no dlopen handle
+		if (module->handle != NULL && dlclose (module->handle) != 0)
 		{
 			if (ret != -1)
 			{
@@ -612,18 +612,39 @@ static int allExistHelper (Key * checkedKey, Key * keyInFirst, Key * keyInSecond
 static int checkSingleSet (KeySet * checkedSet, KeySet * firstCompared, KeySet * secondCompared, KeySet * result, bool checkedIsDominant,
 			   int baseIndicator, Key * informationKey)
 {
-	ksRewind (checkedSet);
-	ksRewind (firstCompared);
-	ksRewind (secondCompared);
-	Key * checkedKey;
-	while ((checkedKey = ksNext (checkedSet)) != NULL)
+	ssize_t firstSize = ksGetSize (firstCompared);
+	ssize_t secondSize = ksGetSize (secondCompared);
+	elektraCursor firstPos = 0;
+	elektraCursor secondPos = 0;
+	for (elektraCursor it = 0; it < ksGetSize (checkedSet); ++it)
 	{
+		Key * checkedKey = ksAtCursor (checkedSet, it);
 		/**
 		 * Check if a key with the same name exists
 		 * Nothing about values is said yet
+		 *
+		 * All three key sets were rebased below the same root and are sorted,
+		 * so advancing a cursor through each compared set replaces the two
+		 * binary searches per key
 		 */
-		Key * keyInFirst = ksLookup (firstCompared, checkedKey, 0);
-		Key * keyInSecond = ksLookup (secondCompared, checkedKey, 0);
+		while (firstPos < firstSize && keyCmp (ksAtCursor (firstCompared, firstPos), checkedKey) < 0)
+		{
+			++firstPos;
+		}
+		Key * keyInFirst = NULL;
+		if (firstPos < firstSize && keyCmp (ksAtCursor (firstCompared, firstPos), checkedKey) == 0)
+		{
+			keyInFirst = ksAtCursor (firstCompared, firstPos);
+		}
+		while (secondPos < secondSize && keyCmp (ksAtCursor (secondCompared, secondPos), checkedKey) < 0)
+		{
+			++secondPos;
+		}
+		Key * keyInSecond = NULL;
+		if (secondPos < secondSize && keyCmp (ksAtCursor (secondCompared, secondPos), checkedKey) == 0)
+		{
+			keyInSecond = ksAtCursor (secondCompared, secondPos);
+		}
 		if (keyInFirst != NULL && keyInSecond != NULL)
 		{
 			allExistHelper (checkedKey, keyInFirst, keyInSecond, result, checkedIsDominant, baseIndicator, informationKey);
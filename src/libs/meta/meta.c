@@ -803,6 +803,71 @@ char * elektraMetaArrayToString (const Key * key, const char * metaName, const c
 	return result;
 }
 
+/**
+ * @brief Assign sequential `order` metadata to a range of keys.
+ *
+ * The keys at the cursor positions [start, end) of @p ks get an `order`
+ * metakey in the `#0` array syntax, starting with @p startIndex and
+ * incremented by one per key. Storage plugins that maintain ordering
+ * metadata for round-tripping can order a freshly parsed section with
+ * one call instead of formatting the index once per key.
+ *
+ * @param ks the keyset containing the keys to order
+ * @param start the first cursor position to order
+ * @param end the cursor position after the last ordered key
+ * @param startIndex the array index assigned to the key at @p start
+ *
+ * @returns the number of ordered keys
+ * @retval -1 on NULL pointers, an invalid range or a negative @p startIndex
+ */
+ssize_t elektraMetaOrderRange (KeySet * ks, elektraCursor start, elektraCursor end, kdb_long_long_t startIndex)
+{
+	if (!ks) return -1;
+	if (start < 0 || end < start || end > ksGetSize (ks)) return -1;
+	if (startIndex < 0) return -1;
+
+	char orderName[ELEKTRA_MAX_ARRAY_SIZE];
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		elektraWriteArrayNumber (orderName, startIndex + (it - start));
+		if (keySetMeta (ksAtCursor (ks, it), "order", orderName) < 0) return -1;
+	}
+
+	return end - start;
+}
+
+/**
+ * @brief Copy all metadata of a template key to a range of keys.
+ *
+ * The keys at the cursor positions [start, end) of @p ks receive the
+ * metadata of @p source via keyCopyAllMeta(), so all n keys share the
+ * metadata of the template copy-on-write until one of them is modified.
+ * As with keyCopyAllMeta(), metadata the target keys already have is
+ * kept unless the template overrides it.
+ *
+ * @param ks the keyset containing the keys to copy the metadata to
+ * @param start the first cursor position to copy to
+ * @param end the cursor position after the last target key
+ * @param source the key acting as metadata template
+ *
+ * @returns the number of keys the metadata was copied to
+ * @retval -1 on NULL pointers, an invalid range or read-only metadata
+ */
+ssize_t elektraMetaCopyRange (KeySet * ks, elektraCursor start, elektraCursor end, const Key * source)
+{
+	if (!ks || !source) return -1;
+	if (start < 0 || end < start || end > ksGetSize (ks)) return -1;
+
+	for (elektraCursor it = start; it < end; ++it)
+	{
+		Key * dest = ksAtCursor (ks, it);
+		if (dest->meta == source->meta && dest->meta != NULL) continue; // already sharing the template
+		if (keyCopyAllMeta (dest, source) < 0) return -1;
+	}
+
+	return end - start;
+}
+
 /**
  * @}
  */
@@ -44,6 +44,12 @@ struct Specification
 	bool useSubcommands;
 };
 
+struct _ElektraOptsSpec
+{
+	struct Specification spec;
+	Key * specParent;
+};
+
 static inline const char * keyGetMetaString (const Key * key, const char * meta)
 {
 	const Key * mk = keyGetMeta (key, meta);
@@ -51,6 +57,36 @@ static inline const char * keyGetMetaString (const Key * key, const char * meta)
 	return value != NULL && value[0] == '\0' ? NULL : value;
 }
 
+/**
+ * Looks up one element of the metadata array @p metaName of @p key,
+ * without materializing the whole array as a KeySet like
+ * elektraMetaArrayToKS() would.
+ *
+ * @return the element, or NULL if there is no element with this index
+ */
+static const Key * metaArrayElement (Key * key, const char * metaName, kdb_long_long_t index)
+{
+	char elementName[64];
+	size_t length = strlen (metaName);
+	memcpy (elementName, metaName, length);
+	elementName[length] = '/';
+	elektraWriteArrayNumber (elementName + length + 1, index);
+	return keyGetMeta (key, elementName);
+}
+
+/**
+ * Last index of the metadata array whose parent metakey is @p arrayMeta.
+ */
+static kdb_long_long_t metaArrayLastIndex (const Key * arrayMeta)
+{
+	const char * value = keyString (arrayMeta); // e.g. "#_10"
+	if (*value != '#') return -1;
+	++value;
+	while (*value == '_')
+		++value;
+	return strtoll (value, NULL, 10);
+}
+
 static inline const char * keyGetMetaStringByKey (Key * key, Key * lookup)
 {
 	const Key * mk = ksLookup (keyMeta (key), lookup, KDB_O_DEL);
@@ -59,13 +95,13 @@ static inline const char * keyGetMetaStringByKey (Key * key, Key * lookup)
 }
 
 static int addProcKey (KeySet * ks, const Key * key, Key * valueKey);
-static KeySet * parseEnvp (const char ** envp);
+static const char * envpLookup (const char ** envp, const char * name);
 
 static KeySet * parseArgs (Key * command, KeySet * optionsSpec, bool useSubcommands, int argc, const char ** argv, int * endArg,
 			   Key * errorKey);
 static void setOption (Key * option, const char * value, bool repeated);
 
-static Key * splitEnvValue (const Key * envKey);
+static Key * splitEnvValue (const char * value);
 
 static KeySet * ksMetaGetSingleOrArray (Key * key, const char * metaName);
 
@@ -86,7 +122,7 @@ static bool processEnvVars (KeySet * usedEnvVars, Key * specKey, Key ** keyWithO
 static bool processArgs (Key * command, Key * specKey, KeySet * argIndices, Key ** keyWithOpt, Key * errorKey);
 
 static int writeOptionValues (KeySet * ks, Key * keyWithOpt, KeySet * options, Key * errorKey);
-static int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key * errorKey);
+static int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, const char ** envp, Key * errorKey);
 static int writeArgsValues (KeySet * ks, Key * keyWithOpt, Key * command, KeySet * argIndices, KeySet * args, Key * errorKey);
 
 static bool parseLongOption (Key * command, KeySet * optionsSpec, KeySet * options, int argc, const char ** argv, int * index,
@@ -128,44 +164,117 @@ static int writeOptions (Key * command, Key * commandKey, Key * commandArgs, boo
  * 		generated help message
  */
 int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** envp, Key * parentKey)
+{
+	ElektraOptsSpec * spec = elektraGetOptsSpecProcess (ks, parentKey);
+	if (spec == NULL)
+	{
+		return -1;
+	}
+
+	int result = elektraGetOptsSpec (spec, ks, argc, argv, envp, parentKey);
+	elektraGetOptsSpecDel (spec);
+	return result;
+}
+
+/**
+ * Processes a specification of program options into a compiled form that can be
+ * used with elektraGetOptsSpec().
+ *
+ * Processing the `opt/`, `env/` and `args/` metadata of a big specification dominates
+ * the cost of elektraGetOpts(). If the same specification is parsed more than once
+ * (e.g. against different argument vectors), process it once with this function and
+ * reuse the result, so the per-parse cost no longer depends on the size of the
+ * specification.
+ *
+ * @param ks	    The KeySet containing the specification for the options.
+ * @param parentKey The parent key below which the function will search for option
+ *                  specifications. Also used for error reporting.
+ *
+ * @return the processed specification (free with elektraGetOptsSpecDel ()),
+ * or NULL on error, the error will be set as metadata in @p parentKey
+ */
+ElektraOptsSpec * elektraGetOptsSpecProcess (KeySet * ks, Key * parentKey)
 {
 	elektraCursor initial = ksGetCursor (ks);
 
 	Key * specParent = keyDup (parentKey, KEY_CP_ALL);
 	keySetNamespace (specParent, KEY_NS_SPEC);
 
-	struct Specification spec;
-	if (!processSpec (&spec, ks, specParent, parentKey))
+	ElektraOptsSpec * spec = elektraMalloc (sizeof (ElektraOptsSpec));
+	if (!processSpec (&spec->spec, ks, specParent, parentKey))
 	{
 		keyDel (specParent);
+		elektraFree (spec);
 		ksSetCursor (ks, initial);
-		return -1;
+		return NULL;
 	}
 
+	spec->specParent = specParent;
+	ksSetCursor (ks, initial);
+	return spec;
+}
+
+/**
+ * Frees a specification processed with elektraGetOptsSpecProcess().
+ *
+ * @param spec The processed specification to free. May be NULL.
+ */
+void elektraGetOptsSpecDel (ElektraOptsSpec * spec)
+{
+	if (spec == NULL)
+	{
+		return;
+	}
+
+	ksDel (spec->spec.options);
+	ksDel (spec->spec.keys);
+	ksDel (spec->spec.argIndices);
+	ksDel (spec->spec.commands);
+	keyDel (spec->specParent);
+	elektraFree (spec);
+}
+
+/**
+ * Extracts option values from arguments and environment variables, like
+ * elektraGetOpts(), but uses a specification processed beforehand with
+ * elektraGetOptsSpecProcess().
+ *
+ * @param spec	    A specification processed with elektraGetOptsSpecProcess().
+ *                  Remains valid after this call and may be reused.
+ * @param ks	    The KeySet the resulting proc keys are written to.
+ * @param argc	    The number of strings in argv.
+ * @param argv	    The arguments to be processed.
+ * @param envp	    A list of environment variables. This needs to be a null-terminated list of
+ * 		    strings of the format 'KEY=VALUE'.
+ * @param parentKey The parent key, used for error reporting.
+ *
+ * @retval 0	on success, this is the only case in which @p ks will be modified
+ * @retval -1	on error, the error will be set as metadata in @p errorKey
+ * @retval 1	if the help option `--help` was found, use elektraGetOptsHelpMessage() access the
+ * 		generated help message
+ */
+int elektraGetOptsSpec (ElektraOptsSpec * spec, KeySet * ks, int argc, const char ** argv, const char ** envp, Key * parentKey)
+{
+	elektraCursor initial = ksGetCursor (ks);
+
 	Key * command = keyNew ("/", KEY_END);
-	Key * commandKey = keyNew (keyName (specParent), KEY_END);
+	Key * commandKey = keyNew (keyName (spec->specParent), KEY_END);
 	Key * commandArgs = keyNew ("/", KEY_END);
 
-	keyDel (specParent);
-
-	if (spec.useSubcommands)
+	if (spec->spec.useSubcommands)
 	{
 		int lastEndArg = 0;
 		while (lastEndArg < argc)
 		{
 			int endArg = -1;
 			KeySet * options =
-				parseArgs (command, spec.options, true, argc - lastEndArg, argv + lastEndArg, &endArg, parentKey);
+				parseArgs (command, spec->spec.options, true, argc - lastEndArg, argv + lastEndArg, &endArg, parentKey);
 
 			if (options == NULL)
 			{
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				ksSetCursor (ks, initial);
 				return -1;
 			}
@@ -175,15 +284,15 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 			{
 				endArg += lastEndArg;
 
-				Key * commandSpec = ksLookup (spec.keys, commandKey, 0);
+				Key * commandSpec = ksLookup (spec->spec.keys, commandKey, 0);
 				Key * commandLookup = keyNew ("meta:/command", KEY_END);
 				keyAddBaseName (commandLookup, argv[endArg]);
 				subCommand = ksLookup (keyMeta (commandSpec), commandLookup, KDB_O_DEL);
 			}
 
 			bool argsWritten = false;
-			int result = writeOptions (command, commandKey, commandArgs, subCommand == NULL, &argsWritten, options, &spec, ks,
-						   argv[0], envp, parentKey);
+			int result = writeOptions (command, commandKey, commandArgs, subCommand == NULL, &argsWritten, options,
+						   &spec->spec, ks, argv[0], envp, parentKey);
 			ksDel (options);
 
 			if (result != 0)
@@ -191,10 +300,6 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				ksSetCursor (ks, initial);
 				return result;
 			}
@@ -205,10 +310,6 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				ksSetCursor (ks, initial);
 				return -1;
 			}
@@ -222,10 +323,6 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 				keyDel (command);
 				keyDel (commandKey);
 				keyDel (commandArgs);
-				ksDel (spec.options);
-				ksDel (spec.keys);
-				ksDel (spec.argIndices);
-				ksDel (spec.commands);
 				ksSetCursor (ks, initial);
 				return 0;
 			}
@@ -245,30 +342,23 @@ int elektraGetOpts (KeySet * ks, int argc, const char ** argv, const char ** env
 	else
 	{
 		int endArg = 0;
-		KeySet * options = parseArgs (command, spec.options, false, argc, argv, &endArg, parentKey);
+		KeySet * options = parseArgs (command, spec->spec.options, false, argc, argv, &endArg, parentKey);
 
 		if (options == NULL)
 		{
 			keyDel (command);
 			keyDel (commandKey);
 			keyDel (commandArgs);
-			ksDel (spec.options);
-			ksDel (spec.keys);
-			ksDel (spec.argIndices);
-			ksDel (spec.commands);
 			ksSetCursor (ks, initial);
 			return -1;
 		}
 
-		int result = writeOptions (command, commandKey, commandArgs, true, NULL, options, &spec, ks, argv[0], envp, parentKey);
+		int result = writeOptions (command, commandKey, commandArgs, true, NULL, options, &spec->spec, ks, argv[0], envp,
+					   parentKey);
 		keyDel (command);
 		keyDel (commandKey);
 		keyDel (commandArgs);
 		ksDel (options);
-		ksDel (spec.options);
-		ksDel (spec.keys);
-		ksDel (spec.argIndices);
-		ksDel (spec.commands);
 		ksSetCursor (ks, initial);
 		return result;
 	}
@@ -1017,7 +1107,8 @@ bool processEnvVars (KeySet * usedEnvVars, Key * specKey, Key ** keyWithOpt, Key
 		{
 			*keyWithOpt = keyNew (keyName (specKey), KEY_END);
 		}
-		elektraMetaArrayAdd (*keyWithOpt, "env", keyName (envVarKey));
+		// store the raw variable name, envpLookup() matches it against "NAME=value" entries
+		elektraMetaArrayAdd (*keyWithOpt, "env", envVar);
 
 		char * tmp = elektraFormat ("%s%s, ", envsLinePart, envVar);
 		elektraFree (envsLinePart);
@@ -1174,7 +1265,7 @@ bool processArgs (Key * command, Key * specKey, KeySet * argIndices, Key ** keyW
 
 /**
  * Add keys to the proc namespace in @p ks for all options specified
- * on @p keyWithOpt. The env-vars are taken from @p envValues.
+ * on @p keyWithOpt. The option values are taken from @p options.
  * @retval -1 in case of error
  * @retval 0 if no key was added
  * @retval 1 if keys were added to @p ks
@@ -1183,21 +1274,23 @@ int writeOptionValues (KeySet * ks, Key * keyWithOpt, KeySet * options, Key * er
 {
 	bool valueFound = false;
 
-	KeySet * optMetas = elektraMetaArrayToKS (keyWithOpt, "opt");
-	if (optMetas == NULL)
+	const Key * optMeta = keyGetMeta (keyWithOpt, "opt");
+	if (optMeta == NULL)
 	{
 		return 0;
 	}
 
-	ksRewind (optMetas);
-	ksNext (optMetas); // skip count
-	Key * optMeta;
+	kdb_long_long_t lastIndex = metaArrayLastIndex (optMeta);
 	bool shortFound = false;
-	while ((optMeta = ksNext (optMetas)) != NULL)
+	for (kdb_long_long_t index = 0; index <= lastIndex; ++index)
 	{
-		Key * optLookup = keyNew (keyString (optMeta), KEY_END);
-		Key * optKey = ksLookup (options, optLookup, KDB_O_DEL);
-		bool isShort = strncmp (keyString (optMeta), "/short", 6) == 0;
+		const Key * elem = metaArrayElement (keyWithOpt, "opt", index);
+		if (elem == NULL)
+		{
+			continue;
+		}
+		Key * optKey = ksLookupByName (options, keyString (elem), 0);
+		bool isShort = strncmp (keyString (elem), "/short", 6) == 0;
 		if (shortFound && !isShort)
 		{
 			// ignore long options, if a short one was found
@@ -1219,53 +1312,53 @@ int writeOptionValues (KeySet * ks, Key * keyWithOpt, KeySet * options, Key * er
 				errorKey, "The option '%s%s' cannot be used, because another option has already been used for the key '%s'",
 				isShort ? "-" : "--", isShort ? (const char[]){ keyBaseName (optKey)[0], '\0' } : keyBaseName (optKey),
 				keyName (keyWithOpt));
-			ksDel (optMetas);
 			return -1;
 		}
 	}
 
-	ksDel (optMetas);
-
 	return valueFound ? 1 : 0;
 }
 
 /**
  * Add keys to the proc namespace in @p ks for everything that is specified
- * by the 'env' metadata on @p keyWithOpt. The env-vars are taken from @p envValues.
+ * by the 'env' metadata on @p keyWithOpt. The env-vars are looked up in @p envp.
  * @retval -1 in case of error
  * @retval 0 if no key was added
  * @retval 1 if keys were added to @p ks
  */
-int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key * errorKey)
+int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, const char ** envp, Key * errorKey)
 {
 	bool valueFound = false;
 
-	KeySet * envMetas = elektraMetaArrayToKS (keyWithOpt, "env");
-	if (envMetas == NULL)
+	const Key * envMeta = keyGetMeta (keyWithOpt, "env");
+	if (envMeta == NULL)
 	{
 		return 0;
 	}
 
-	ksRewind (envMetas);
-	ksNext (envMetas); // skip count
-	Key * envMeta;
-	while ((envMeta = ksNext (envMetas)) != NULL)
+	kdb_long_long_t lastIndex = metaArrayLastIndex (envMeta);
+	for (kdb_long_long_t index = 0; index <= lastIndex; ++index)
 	{
-		Key * envKey = ksLookupByName (envValues, keyString (envMeta), 0);
+		const Key * elem = metaArrayElement (keyWithOpt, "env", index);
+		if (elem == NULL)
+		{
+			continue;
+		}
+		const char * envValue = envpLookup (envp, keyString (elem));
 
 		bool isArray = strcmp (keyBaseName (keyWithOpt), "#") == 0;
 		Key * envValueKey;
-		if (envKey == NULL)
+		if (envValue == NULL)
 		{
 			envValueKey = NULL;
 		}
 		else if (isArray)
 		{
-			envValueKey = splitEnvValue (envKey);
+			envValueKey = splitEnvValue (envValue);
 		}
 		else
 		{
-			envValueKey = keyNew (keyName (envKey), KEY_VALUE, keyString (envKey), KEY_END);
+			envValueKey = keyNew ("/", KEY_VALUE, envValue, KEY_END);
 		}
 
 		int res = addProcKey (ks, keyWithOpt, envValueKey);
@@ -1275,9 +1368,8 @@ int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key *
 				errorKey,
 				"The environment variable '%s' cannot be used, because another variable has "
 				"already been used for the key '%s'.",
-				keyBaseName (envKey), keyName (keyWithOpt));
+				keyString (elem), keyName (keyWithOpt));
 			keyDel (envValueKey);
-			ksDel (envMetas);
 			return -1;
 		}
 		else if (res == 0)
@@ -1286,7 +1378,6 @@ int writeEnvVarValues (KeySet * ks, Key * keyWithOpt, KeySet * envValues, Key *
 		}
 		keyDel (envValueKey);
 	}
-	ksDel (envMetas);
 
 	return valueFound ? 1 : 0;
 }
@@ -1371,15 +1462,15 @@ int writeArgsValues (KeySet * ks, Key * keyWithOpt, Key * command, KeySet * argI
 }
 
 /**
- * Taken a key whose value is an environment variable like array (like $PATH)
- * and turn it into a Key with either a string value or a metadata array 'values'
- * containing the value of the variable.
+ * Takes the value of an environment variable like array (like $PATH)
+ * and turns it into a Key with a metadata array 'values' containing
+ * the values of the variable.
  */
-Key * splitEnvValue (const Key * envKey)
+Key * splitEnvValue (const char * value)
 {
-	Key * valueKey = keyNew (keyName (envKey), KEY_END);
+	Key * valueKey = keyNew ("/", KEY_END);
 
-	char * envValue = elektraStrDup (keyString (envKey));
+	char * envValue = elektraStrDup (value);
 	char * curEnvValue = envValue;
 
 	char * c = strchr (curEnvValue, SEP_ENV_VALUE);
@@ -1445,19 +1536,22 @@ int addProcKey (KeySet * ks, const Key * key, Key * valueKey)
 	{
 		Key * insertKey = keyDup (procKey, KEY_CP_NAME);
 		keyAddBaseName (insertKey, "#");
-		KeySet * values = elektraMetaArrayToKS (valueKey, "values");
-		if (values == NULL)
+		const Key * valuesMeta = keyGetMeta (valueKey, "values");
+		if (valuesMeta == NULL)
 		{
 			keyDel (procKey);
 			keyDel (insertKey);
 			return 1;
 		}
 
-		ksRewind (values);
-		Key * cur;
-		ksNext (values); // skip count
-		while ((cur = ksNext (values)) != NULL)
+		kdb_long_long_t lastIndex = metaArrayLastIndex (valuesMeta);
+		for (kdb_long_long_t index = 0; index <= lastIndex; ++index)
 		{
+			const Key * cur = metaArrayElement (valueKey, "values", index);
+			if (cur == NULL)
+			{
+				continue;
+			}
 			elektraArrayIncName (insertKey);
 
 			Key * k = keyDup (insertKey, KEY_CP_NAME);
@@ -1467,7 +1561,6 @@ int addProcKey (KeySet * ks, const Key * key, Key * valueKey)
 
 		keySetMeta (procKey, "array", keyBaseName (insertKey));
 		keyDel (insertKey);
-		ksDel (values);
 	}
 	else
 	{
@@ -1478,28 +1571,22 @@ int addProcKey (KeySet * ks, const Key * key, Key * valueKey)
 }
 
 /**
- * Parses env-vars from envp into an internal format.
+ * Looks up @p name in the null-terminated environment list @p envp,
+ * without copying the environment into a KeySet first.
+ *
+ * @return pointer to the value inside @p envp, or NULL if not found
  */
-KeySet * parseEnvp (const char ** envp)
+const char * envpLookup (const char ** envp, const char * name)
 {
-	KeySet * ks = ksNew (0, KS_END);
-
-	const char ** cur = envp;
-	while (*cur != NULL)
+	size_t length = strlen (name);
+	for (const char ** cur = envp; *cur != NULL; cur++)
 	{
-		const char * eq = strchr (*cur, '=');
-		Key * key = keyNew ("/", KEY_VALUE, eq + 1, KEY_END);
-		size_t len = eq - *cur;
-		char * name = elektraMemDup (*cur, len + 1);
-		name[len] = '\0';
-		keyAddBaseName (key, name);
-		ksAppendKey (ks, key);
-		elektraFree (name);
-
-		cur++;
+		if (strncmp (*cur, name, length) == 0 && (*cur)[length] == '=')
+		{
+			return *cur + length + 1;
+		}
 	}
-
-	return ks;
+	return NULL;
 }
 
 /**
@@ -1832,8 +1919,6 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 		return 1;
 	}
 
-	KeySet * envValues = parseEnvp (envp);
-
 	Key * argsParent = keyNew (keyName (command), KEY_END);
 	keyAddBaseName (argsParent, "args");
 	KeySet * args = elektraArrayGet (argsParent, options);
@@ -1870,7 +1955,6 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 		int result = writeOptionValues (ks, keyWithOpt, options, parentKey);
 		if (result < 0)
 		{
-			ksDel (envValues);
 			ksDel (args);
 			return -1;
 		}
@@ -1884,7 +1968,6 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 			result = writeArgsValues (ks, keyWithOpt, command, spec->argIndices, args, parentKey);
 			if (result < 0)
 			{
-				ksDel (envValues);
 				ksDel (args);
 				return -1;
 			}
@@ -1898,16 +1981,14 @@ int writeOptions (Key * command, Key * commandKey, Key * commandArgs, bool write
 			}
 		}
 
-		result = writeEnvVarValues (ks, keyWithOpt, envValues, parentKey);
+		result = writeEnvVarValues (ks, keyWithOpt, envp, parentKey);
 		if (result < 0)
 		{
-			ksDel (envValues);
 			ksDel (args);
 			return -1;
 		}
 	}
 
-	ksDel (envValues);
 	ksDel (args);
 
 	return 0;
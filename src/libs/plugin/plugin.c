@@ -38,8 +38,9 @@
  * @c ELEKTRA_PLUGIN_CLOSE,
  * @c ELEKTRA_PLUGIN_GET,
  * @c ELEKTRA_PLUGIN_SET and optionally
- * @c ELEKTRA_PLUGIN_ERROR and
- * @c ELEKTRA_PLUGIN_COMMIT.
+ * @c ELEKTRA_PLUGIN_ERROR,
+ * @c ELEKTRA_PLUGIN_COMMIT and
+ * @c ELEKTRA_PLUGIN_CONTRACT.
  *
  * The list is terminated with
  * @c ELEKTRA_PLUGIN_END.
@@ -88,6 +89,9 @@ Plugin * elektraPluginExport (const char * pluginName, ...)
 		case ELEKTRA_PLUGIN_COMMIT:
 			returned->kdbCommit = va_arg (va, kdbCommitPtr);
 			break;
+		case ELEKTRA_PLUGIN_CONTRACT:
+			returned->kdbContract = va_arg (va, kdbContractPtr);
+			break;
 		default:
 			ELEKTRA_ASSERT (0, "plugin passed something unexpected");
 		// fallthrough, will end here
@@ -4,19 +4,16 @@
  * @brief Source for the pluginprocess library
  *
  * Executes plugins in a separate process via fork and uses a simple
- * communication protocol based on the dump plugin via named pipes.
+ * communication protocol based on a serialization plugin via named pipes.
+ * By default the binary quickdump format is used for the transport, the
+ * textual dump format is available as a fallback and can be requested
+ * explicitly (see elektraPluginProcessInit).
  *
  * The communication protocol works as follows, where Child and Parent stand
  * for the child and the parent process:
- * 1)  Four pipes are created to handle the communication in a reliable way
-       - parentCommandPipe is used for a keyset containing metainformation about
-       the communication protocol, going from Parent to Child
-       - parentPayloadPipe is used for transferring the actual payload that gets passed
-       to a plugin, going from Parent to Child
-       - childCommandPipe is used for a keyset containing metainformation about
-       the communication protocol, going from Child to Parent
-       - childPayloadPipe is used for transferring the actual payload that gets passed
-       to a plugin, going from Child to Parent
+ * 1)  Two pipes are created to handle the communication in a reliable way
+       - parentCommandPipe goes from Parent to Child
+       - childCommandPipe goes from Child to Parent
  * 2)  The parent constructs a keyset called commandKeySet, containing:
  *     - /pluginprocess/parent
  *       a copy of the parent key passed to the plugin interface
@@ -29,21 +26,26 @@
  *     - /pluginprocess/version
  *       a number indicating the version of this communication
  *       protocol
- * 3)  The parent sends over the commandKeySet over the parentCommandPipe
- * 4)  For operations requiring a keyset, the parent sends the
- *     keyset (originalKeySet) that is passed to this plugin over the parentPayloadPipe
- * 5)  Child receives the commandKeySet
- * 6)  Child receives the keyset if one exists
- * 7)  Child executes the plugin on the keyset with the originalKey
- * 8)  Child adds the result value of the plugin operation to the commandKeySet
+ * 3)  For operations requiring a keyset, the parent appends the keyset
+ *     (originalKeySet) that is passed to this plugin to the commandKeySet.
+ *     Payload keys always carry a namespace, so they can be separated from
+ *     the cascading /pluginprocess control keys again on the other side.
+ * 4)  The parent sends the commandKeySet over the parentCommandPipe in a
+ *     single message
+ * 5)  Child receives the commandKeySet and cuts out the /pluginprocess keys,
+ *     the remaining keys form the payload keyset if one exists
+ * 6)  Child executes the plugin on the keyset with the originalKey
+ * 7)  Child adds the result value of the plugin operation to the commandKeySet
        into the key /pluginprocess/result
- * 9)  Child sends the commandKeySet over the childCommandPipe
- * 10) For operations requiring a keyset, Child sends the keyset
- *    over the childPayloadPipe
- * 11) Parent receives the commandKeySet and interprets /pluginprocess/result
- * 12) For operations requiring a keyset, Parent receives the keyset
- *     and copies it back to originalKeySet set
- * 13) Parent returns the result value from the child process
+ * 8)  For operations requiring a keyset, Child appends the keyset to the
+ *     commandKeySet again
+ * 9)  Child sends the commandKeySet over the childCommandPipe in a
+ *     single message
+ * 10) Parent receives the commandKeySet, cuts out the /pluginprocess keys
+ *     and interprets /pluginprocess/result
+ * 11) For operations requiring a keyset, Parent copies the remaining keys
+ *     back to originalKeySet set
+ * 12) Parent returns the result value from the child process
  *
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  */
@@ -66,38 +68,30 @@
 struct _ElektraPluginProcess
 {
 	int parentCommandPipe[2];
-	int parentPayloadPipe[2];
 	int childCommandPipe[2];
-	int childPayloadPipe[2];
 
 	Key * parentCommandPipeKey;
-	Key * parentPayloadPipeKey;
 	Key * childCommandPipeKey;
-	Key * childPayloadPipeKey;
 
 	int pid;
 	int counter;
-	ElektraInvokeHandle * dump;
+	ElektraInvokeHandle * transport;
 	void * pluginData;
 };
 
 static void cleanupPluginData (ElektraPluginProcess * pp, Key * errorKey, int cleanAllPipes)
 {
-	if (pp->dump) elektraInvokeClose (pp->dump, errorKey);
+	if (pp->transport) elektraInvokeClose (pp->transport, errorKey);
 
 	if (pp->parentCommandPipeKey) keyDel (pp->parentCommandPipeKey);
-	if (pp->parentPayloadPipeKey) keyDel (pp->parentPayloadPipeKey);
 	if (pp->childCommandPipeKey) keyDel (pp->childCommandPipeKey);
-	if (pp->childPayloadPipeKey) keyDel (pp->childPayloadPipeKey);
 
 	// twisted way to clean either both ends if something failed upon or before forking
 	// and the used ends otherwise
 	for (int pipeIdx = !elektraPluginProcessIsParent (pp); pipeIdx <= cleanAllPipes; ++pipeIdx)
 	{
 		if (pp->parentCommandPipe[!pipeIdx]) close (pp->parentCommandPipe[!pipeIdx]);
-		if (pp->parentPayloadPipe[!pipeIdx]) close (pp->parentPayloadPipe[!pipeIdx]);
 		if (pp->childCommandPipe[pipeIdx]) close (pp->childCommandPipe[pipeIdx]);
-		if (pp->childPayloadPipe[pipeIdx]) close (pp->childPayloadPipe[pipeIdx]);
 	}
 
 	elektraFree (pp);
@@ -113,6 +107,59 @@ static char * longToStr (long i)
 	return str;
 }
 
+/** Move payload keys below the reserved /pluginprocess prefix out of the way
+ *
+ * The control keys of a message are cascading keys below /pluginprocess, so payload
+ * keys below that path — in any namespace — would be cut out together with them on
+ * the receiving side. Before bundling we therefore move such keys below the escape
+ * point /pluginprocess/payload/reserved, with their original name (including the
+ * namespace) stored as a single escaped name part. Key names below the escape point
+ * itself get escaped uniformly as well, so the scheme cannot clash with itself.
+ *
+ * @param payload the payload keyset to be bundled with the control keys
+ **/
+static void escapeReservedPayloadKeys (KeySet * payload)
+{
+	Key * cutKey = keyNew ("/pluginprocess", KEY_END);
+	KeySet * reserved = ksCut (payload, cutKey);
+	keyDel (cutKey);
+	for (elektraCursor it = 0; it < ksGetSize (reserved); ++it)
+	{
+		Key * cur = ksAtCursor (reserved, it);
+		Key * escaped = keyDup (cur, KEY_CP_ALL);
+		keySetName (escaped, "/pluginprocess/payload/reserved");
+		keyAddBaseName (escaped, keyName (cur));
+		ksAppendKey (payload, escaped);
+	}
+	ksDel (reserved);
+}
+
+/** Restore payload keys escaped by escapeReservedPayloadKeys
+ *
+ * The escaped keys arrive below /pluginprocess and thus end up in the control keyset
+ * after the cut on the receiving side. This moves them back into the payload keyset
+ * under their original name.
+ *
+ * @param commandKeySet the control keyset cut out of the received message
+ * @param payload the payload keyset the restored keys are appended to
+ **/
+static void unescapeReservedPayloadKeys (KeySet * commandKeySet, KeySet * payload)
+{
+	Key * cutKey = keyNew ("/pluginprocess/payload/reserved", KEY_END);
+	KeySet * reserved = ksCut (commandKeySet, cutKey);
+	keyDel (cutKey);
+	for (elektraCursor it = 0; it < ksGetSize (reserved); ++it)
+	{
+		Key * cur = ksAtCursor (reserved, it);
+		// the escape point itself carries no payload key
+		if (strcmp (keyName (cur), "/pluginprocess/payload/reserved") == 0) continue;
+		Key * restored = keyDup (cur, KEY_CP_ALL);
+		keySetName (restored, keyBaseName (cur));
+		ksAppendKey (payload, restored);
+	}
+	ksDel (reserved);
+}
+
 /** Start the child process' command loop
  *
  * This will make the child process wait for plugin commands
@@ -130,18 +177,23 @@ void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
 
 	do
 	{
-		KeySet * commandKeySet = ksNew (6, KS_END);
+		KeySet * received = ksNew (6, KS_END);
 		KeySet * keySet = NULL;
 		ELEKTRA_LOG_DEBUG ("Child: Wait for commands on pipe %s", keyString (pp->parentCommandPipeKey));
-		elektraInvoke2Args (pp->dump, "get", commandKeySet, pp->parentCommandPipeKey);
+		elektraInvoke2Args (pp->transport, "get", received, pp->parentCommandPipeKey);
 
-		if (ksGetSize (commandKeySet) == 0)
+		if (ksGetSize (received) == 0)
 		{
 			ELEKTRA_LOG_DEBUG ("Child: Failed to read from parentCommandPipe, exiting");
-			ksDel (commandKeySet);
+			ksDel (received);
 			break;
 		}
 
+		// the control keys are cascading, the payload keys carry a namespace
+		Key * cutKey = keyNew ("/pluginprocess", KEY_END);
+		KeySet * commandKeySet = ksCut (received, cutKey);
+		keyDel (cutKey);
+
 		Key * payloadSizeKey = ksLookupByName (commandKeySet, "/pluginprocess/payload/size", KDB_O_NONE);
 		char * endPtr;
 		// We'll always write some int value into it, so this should be fine
@@ -151,10 +203,14 @@ void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
 		// in case the payload size fails to be transferred, that it shouldn't, we can only assume no payload
 		if (*endPtr == '\0' && errno != ERANGE && payloadSize >= 0)
 		{
-			keySet = ksNew (payloadSize, KS_END);
-			elektraInvoke2Args (pp->dump, "get", keySet, pp->parentPayloadPipeKey);
+			keySet = received;
+			unescapeReservedPayloadKeys (commandKeySet, keySet);
 			ELEKTRA_LOG_DEBUG ("Child: We received a KeySet with %zd keys in it", ksGetSize (keySet));
 		}
+		else
+		{
+			ksDel (received);
+		}
 		errno = prevErrno;
 
 		Key * commandKey = ksLookupByName (commandKeySet, "/pluginprocess/command", KDB_O_NONE);
@@ -211,15 +267,16 @@ void elektraPluginProcessStart (Plugin * handle, ElektraPluginProcess * pp)
 		keyDel (parentKey);
 
 		ELEKTRA_LOG_DEBUG ("Child: Writing the results back to the parent");
-		elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->childCommandPipeKey);
 		if (keySet != NULL)
 		{
 			char * resultPayloadSize = longToStr (ksGetSize (keySet));
 			keySetString (payloadSizeKey, resultPayloadSize);
 			elektraFree (resultPayloadSize);
-			elektraInvoke2Args (pp->dump, "set", keySet, pp->childPayloadPipeKey);
-			ksDel (keySet);
+			escapeReservedPayloadKeys (keySet);
+			ksAppend (commandKeySet, keySet);
 		}
+		elektraInvoke2Args (pp->transport, "set", commandKeySet, pp->childCommandPipeKey);
+		if (keySet != NULL) ksDel (keySet);
 		ksDel (commandKeySet);
 		ELEKTRA_LOG ("Child: Command handled, startup counter is at %d", counter);
 	} while (counter);
@@ -279,7 +336,7 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 	char * commandStr = longToStr (command);
 	ksAppendKey (commandKeySet, keyNew ("/pluginprocess/command", KEY_VALUE, commandStr, KEY_END));
 	elektraFree (commandStr);
-	ksAppendKey (commandKeySet, keyNew ("/pluginprocess/version", KEY_VALUE, "1", KEY_END));
+	ksAppendKey (commandKeySet, keyNew ("/pluginprocess/version", KEY_VALUE, "2", KEY_END));
 
 	// Some plugin functions don't use keysets, in that case don't send any actual payload, signal via flag
 	KeySet * keySet = originalKeySet != NULL ? ksDup (originalKeySet) : NULL;
@@ -288,40 +345,43 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 		     keyNew ("/pluginprocess/payload/size", KEY_VALUE, originalKeySet == NULL ? "-1" : payloadSizeStr, KEY_END));
 	elektraFree (payloadSizeStr);
 
-	// Serialize, currently statically use dump as our default format, this already writes everything out to the pipe
-	ELEKTRA_LOG ("Parent: Sending data to issue command %u it through pipe %s", command, keyString (pp->parentCommandPipeKey));
-	elektraInvoke2Args (pp->dump, "set", commandKeySet, pp->parentCommandPipeKey);
+	// The payload is bundled with the control keys so everything goes out in a single message,
+	// the control keys are cascading while the payload keys carry a namespace
 	if (keySet != NULL)
 	{
-		ELEKTRA_LOG ("Parent: Sending the payload keyset with %zd keys through the pipe %s", ksGetSize (keySet),
-			     keyString (pp->parentPayloadPipeKey));
-		elektraInvoke2Args (pp->dump, "set", keySet, pp->parentPayloadPipeKey);
+		ELEKTRA_LOG ("Parent: Bundling the payload keyset with %zd keys into the message", ksGetSize (keySet));
+		escapeReservedPayloadKeys (keySet);
+		ksAppend (commandKeySet, keySet);
 	}
 
-	// Deserialize
+	// Serialize using the transport plugin chosen during init, this already writes everything out to the pipe
+	ELEKTRA_LOG ("Parent: Sending data to issue command %u it through pipe %s", command, keyString (pp->parentCommandPipeKey));
+	elektraInvoke2Args (pp->transport, "set", commandKeySet, pp->parentCommandPipeKey);
+
+	// Deserialize the answer, it arrives in a single message as well
 	ELEKTRA_LOG_DEBUG ("Parent: Waiting for the result now on pipe %s", keyString (pp->childCommandPipeKey));
-	elektraInvoke2Args (pp->dump, "get", commandKeySet, pp->childCommandPipeKey);
+	KeySet * received = ksNew (6, KS_END);
+	elektraInvoke2Args (pp->transport, "get", received, pp->childCommandPipeKey);
+
+	Key * cutKey = keyNew ("/pluginprocess", KEY_END);
+	KeySet * resultCommandKeySet = ksCut (received, cutKey);
+	keyDel (cutKey);
 
 	if (keySet != NULL)
 	{
-		// clear the keyset before to avoid memleaks caused by dump
-		char * endPtr;
-		int prevErrno = errno;
-		errno = 0;
-		long payloadSize =
-			strtol (keyString (ksLookupByName (commandKeySet, "/pluginprocess/payload/size", KDB_O_NONE)), &endPtr, 10);
-		// in case the payload size fails to be transferred, that it shouldn't, we simply assume the previous size
-		if (*endPtr != '\0' || errno == ERANGE || payloadSize < 0) payloadSize = ksGetSize (keySet);
-		errno = prevErrno;
 		ksDel (keySet);
-		keySet = ksNew (payloadSize, KS_END);
-		elektraInvoke2Args (pp->dump, "get", keySet, pp->childPayloadPipeKey);
+		keySet = received;
+		unescapeReservedPayloadKeys (resultCommandKeySet, keySet);
 		ELEKTRA_LOG ("Parent: We received %zd keys in return", ksGetSize (keySet));
 	}
+	else
+	{
+		ksDel (received);
+	}
 
 	// Bring everything back in order by removing our process-related keys
-	Key * parentDeserializedKey = ksLookupByName (commandKeySet, "/pluginprocess/parent", KDB_O_NONE);
-	Key * resultKey = ksLookupByName (commandKeySet, "/pluginprocess/result", KDB_O_NONE);
+	Key * parentDeserializedKey = ksLookupByName (resultCommandKeySet, "/pluginprocess/parent", KDB_O_NONE);
+	Key * resultKey = ksLookupByName (resultCommandKeySet, "/pluginprocess/result", KDB_O_NONE);
 
 	// Parse the result value
 	char * endPtr;
@@ -374,6 +434,7 @@ int elektraPluginProcessSend (const ElektraPluginProcess * pp, pluginprocess_t c
 
 	// Command finished, cleanup the remaining memory now
 	ksDel (commandKeySet);
+	ksDel (resultCommandKeySet);
 	if (keySet != NULL) ksDel (keySet);
 
 	return lresult; // Safe, we had a bound check before, and plugins should return values in the int range
@@ -438,6 +499,12 @@ static Key * makePipeKey (const char * pipeName, const int pipeFd)
  * In order to allow users to handle custom plugin data this will not
  * automatically call elektraPluginSetData.
  *
+ * The keysets are serialized with the binary quickdump format by default.
+ * Set the metakey pluginprocess/transport to "dump" on the errorKey before
+ * calling this function to use the textual dump format instead, which is
+ * slower but easier to inspect. If quickdump is not available the dump
+ * plugin is used automatically.
+ *
  * Typically called in a plugin's open function like (assuming no custom plugin data):
  * @code
 int elektraPluginOpen (Plugin * handle, Key * errorKey)
@@ -470,18 +537,33 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 	pp->counter = 0;
 	pp->pluginData = NULL;
 	pp->parentCommandPipeKey = NULL;
-	pp->parentPayloadPipeKey = NULL;
 	pp->childCommandPipeKey = NULL;
-	pp->childPayloadPipeKey = NULL;
 
-	KeySet * config = ksNew (1, keyNew ("user:/fullname", KEY_END), KS_END);
-	pp->dump = elektraInvokeOpen ("dump", config, errorKey);
-	ksDel (config);
+	// Select the transport format. quickdump's binary stream mode avoids the text
+	// encoding overhead of dump, so it is the default. Plugins can still request
+	// dump explicitly (e.g. for debugging the communication) by setting the
+	// metakey pluginprocess/transport to "dump" on the errorKey before calling us.
+	pp->transport = NULL;
+	const Key * transportKey = keyGetMeta (errorKey, "pluginprocess/transport");
+	if (transportKey == NULL || elektraStrCmp (keyString (transportKey), "quickdump") == 0)
+	{
+		KeySet * config = ksNew (2, keyNew ("user:/stream", KEY_END), keyNew ("user:/fullname", KEY_END), KS_END);
+		pp->transport = elektraInvokeOpen ("quickdump", config, NULL);
+		ksDel (config);
+	}
+
+	if (!pp->transport)
+	{
+		// quickdump may not be compiled in or dump was requested explicitly
+		KeySet * config = ksNew (1, keyNew ("user:/fullname", KEY_END), KS_END);
+		pp->transport = elektraInvokeOpen ("dump", config, errorKey);
+		ksDel (config);
+	}
 
-	if (!pp->dump)
+	if (!pp->transport)
 	{
 		cleanupPluginData (pp, errorKey, 0);
-		ELEKTRA_SET_INSTALLATION_ERROR (errorKey, "Failed to initialize the dump plugin");
+		ELEKTRA_SET_INSTALLATION_ERROR (errorKey, "Failed to initialize a transport plugin (tried quickdump and dump)");
 		return NULL;
 	}
 
@@ -491,9 +573,7 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 
 	// Prepare the pipes
 	if (!makePipe (pp, errorKey, "parentCommandPipe", pp->parentCommandPipe) ||
-	    !makePipe (pp, errorKey, "parentPayloadPipe", pp->parentPayloadPipe) ||
-	    !makePipe (pp, errorKey, "childCommandPipe", pp->childCommandPipe) ||
-	    !makePipe (pp, errorKey, "childPayloadPipe", pp->childPayloadPipe))
+	    !makePipe (pp, errorKey, "childCommandPipe", pp->childCommandPipe))
 		return NULL;
 
 	pp->pid = fork ();
@@ -507,25 +587,17 @@ ElektraPluginProcess * elektraPluginProcessInit (Key * errorKey)
 
 	int pipeIdx = elektraPluginProcessIsParent (pp);
 	close (pp->parentCommandPipe[!pipeIdx]);
-	close (pp->parentPayloadPipe[!pipeIdx]);
 	close (pp->childCommandPipe[pipeIdx]);
-	close (pp->childPayloadPipe[pipeIdx]);
 
 	ELEKTRA_LOG_DEBUG ("parentCommandPipe[%d] has file descriptor %d", pipeIdx, pp->parentCommandPipe[pipeIdx]);
-	ELEKTRA_LOG_DEBUG ("parentPayloadPipe[%d] has file descriptor %d", pipeIdx, pp->parentPayloadPipe[pipeIdx]);
 	ELEKTRA_LOG_DEBUG ("childCommandPipe[%d] has file descriptor %d", !pipeIdx, pp->childCommandPipe[!pipeIdx]);
-	ELEKTRA_LOG_DEBUG ("childPayloadPipe[%d] has file descriptor %d", !pipeIdx, pp->childPayloadPipe[!pipeIdx]);
 
 	// Prepare the keys for the pipes to use with dump
 	pp->parentCommandPipeKey = makePipeKey ("parentCommandPipe", pp->parentCommandPipe[pipeIdx]);
-	pp->parentPayloadPipeKey = makePipeKey ("parentPayloadPipe", pp->parentPayloadPipe[pipeIdx]);
 	pp->childCommandPipeKey = makePipeKey ("childCommandPipe", pp->childCommandPipe[!pipeIdx]);
-	pp->childPayloadPipeKey = makePipeKey ("childPayloadPipe", pp->childPayloadPipe[!pipeIdx]);
 
 	ELEKTRA_LOG_DEBUG ("parentCommandPipeKey is %s on %d", keyString (pp->parentCommandPipeKey), pp->pid);
-	ELEKTRA_LOG_DEBUG ("parentPayloadPipeKey is %s on %d", keyString (pp->parentPayloadPipeKey), pp->pid);
 	ELEKTRA_LOG_DEBUG ("childCommandPipeKey is %s on %d", keyString (pp->childCommandPipeKey), pp->pid);
-	ELEKTRA_LOG_DEBUG ("childPayloadPipeKey is %s on %d", keyString (pp->childPayloadPipeKey), pp->pid);
 
 	ELEKTRA_LOG_DEBUG ("The pluginprocess is set with the pid %d", pp->pid);
 	return pp;
@@ -32,6 +32,11 @@ class AutoMergeStrategy : public MergeConflictStrategy
 {
 public:
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) override;
+
+	virtual std::string getName () const override
+	{
+		return "automerge";
+	}
 };
 } // namespace merging
 } // namespace tools
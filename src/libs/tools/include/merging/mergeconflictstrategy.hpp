@@ -12,6 +12,7 @@
 
 #include <merging/mergeresult.hpp>
 #include <merging/mergetask.hpp>
+#include <string>
 
 namespace kdb
 {
@@ -36,6 +37,14 @@ public:
 	virtual ~MergeConflictStrategy (){};
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) = 0;
 
+	/**
+	 * @return the name of this strategy, used for resolution statistics
+	 */
+	virtual std::string getName () const
+	{
+		return "unknown";
+	}
+
 protected:
 	virtual ConflictOperation getOurConflictOperation (const Key & conflictKey);
 	virtual ConflictOperation getTheirConflictOperation (const Key & conflictKey);
@@ -44,6 +44,11 @@ public:
 
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) override;
 
+	virtual std::string getName () const override
+	{
+		return "metamerge";
+	}
+
 private:
 	KeySet getMetaKeys (Key & key);
 };
@@ -30,6 +30,11 @@ public:
 	}
 
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) override;
+
+	virtual std::string getName () const override
+	{
+		return "newkey";
+	}
 };
 } // namespace merging
 } // namespace tools
@@ -34,6 +34,11 @@ public:
 	}
 
 	virtual void resolveConflict (const MergeTask & task, Key & conflictKey, MergeResult & result) override;
+
+	virtual std::string getName () const override
+	{
+		return "oneside";
+	}
 };
 } // namespace merging
 } // namespace tools
@@ -11,6 +11,7 @@
 #define THREEWAYMERGE_HPP_
 
 #include <kdb.hpp>
+#include <map>
 #include <memory>
 #include <merging/mergeconflictstrategy.hpp>
 #include <merging/mergeresult.hpp>
@@ -67,10 +68,22 @@ public:
 	void addConflictStrategy (MergeConflictStrategy * strategy)
 	{
 		strategies.push_back (strategy);
+		resolutionCounters.push_back (0);
 	}
 
+	/**
+	 * Returns how many conflicts each registered strategy resolved since the
+	 * merger was created, keyed by the strategy name. Strategies registered
+	 * several times under the same name are aggregated. Useful for tuning
+	 * the order in which strategies are registered.
+	 *
+	 * @return the number of resolved conflicts per strategy name
+	 */
+	std::map<std::string, size_t> getResolutionStatistics () const;
+
 private:
 	std::vector<MergeConflictStrategy *> strategies;
+	std::vector<size_t> resolutionCounters;
 	void detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta);
 };
 } // namespace merging
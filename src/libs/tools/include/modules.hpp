@@ -44,6 +44,15 @@ public:
 	 */
 	PluginPtr load (PluginSpec const & spec);
 
+	/**
+	 * @return the keyset used for module loading, e.g. for
+	 * ckdb::elektraPluginGetContract()
+	 */
+	KeySet & getModules ()
+	{
+		return modules;
+	}
+
 private:
 	KeySet modules;
 };
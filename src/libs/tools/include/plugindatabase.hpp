@@ -173,6 +173,36 @@ public:
 	PluginSpec lookupProvides (std::string const & provides) const;
 	std::map<int, PluginSpec> lookupAllProvidesWithStatus (std::string const & provides) const;
 	std::vector<PluginSpec> lookupAllProvides (std::string const & provides) const;
+
+	/**
+	 * @brief load the contracts of the given plugins in parallel
+	 *
+	 * Extracts each missing or outdated contract in a worker thread and
+	 * stores the result, so that subsequent lookupInfo() queries do not
+	 * load the modules one by one.
+	 *
+	 * @param plugins the names of the plugins to preload
+	 */
+	void preloadContracts (std::vector<std::string> const & plugins) const;
+
+	/**
+	 * @brief retrieve a previously resolved plugin ordering
+	 *
+	 * @param pluginSet a string uniquely describing the set of plugins to be ordered
+	 * @param [out] ordering the cached permutation
+	 *
+	 * @retval true if an ordering for the set was cached before
+	 * @retval false otherwise, @p ordering is left untouched
+	 */
+	bool lookupOrdering (std::string const & pluginSet, std::vector<size_t> & ordering) const;
+
+	/**
+	 * @brief remember a resolved plugin ordering for lookupOrdering()
+	 *
+	 * @param pluginSet a string uniquely describing the set of plugins that was ordered
+	 * @param ordering the resolved permutation
+	 */
+	void cacheOrdering (std::string const & pluginSet, std::vector<size_t> const & ordering) const;
 };
 
 class PluginVariantDatabase : public ModulesPluginDatabase
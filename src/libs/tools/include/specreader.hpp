@@ -17,6 +17,7 @@
 #include <plugindatabase.hpp>
 #include <pluginspec.hpp>
 
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 
@@ -52,6 +53,24 @@ private:
 	 */
 	Backends backends;
 
+	/**
+	 * @brief Already parsed part of a specification
+	 *
+	 * Remembers the digest of a mountpoint's spec subtree together with
+	 * all backends that were built from it, so that re-reading an
+	 * unchanged subtree reuses the prior result.
+	 */
+	struct ParsedFragment
+	{
+		uint64_t digest;
+		Backends backends;
+	};
+
+	/**
+	 * @brief Parsed fragments by mountpoint key name
+	 */
+	std::unordered_map<std::string, ParsedFragment> fragments;
+
 private:
 	/**
 	 * @brief Used for crating new BackendBuilder
@@ -77,6 +96,8 @@ public:
 	 * @brief Reads in a specification.
 	 *
 	 * Adds plugins using BackendBuilder during that.
+	 * Mountpoint subtrees that did not change since a previous call
+	 * are not parsed again, their backends are reused.
 	 *
 	 * @param ks
 	 */
@@ -92,6 +92,33 @@ MountBackendBuilder::MountBackendBuilder (BackendBuilderInit const & bbi) : Back
  */
 void BackendBuilder::sort ()
 {
+	// describe the set of plugins (names and configs), so that resolved
+	// orderings can be replayed for identical stacks
+	std::string pluginSet;
+	for (auto const & ps : toAdd)
+	{
+		pluginSet += ps.getFullName ();
+		for (Key k : ps.getConfig ())
+		{
+			pluginSet += "[" + k.getName ();
+			if (k.isString ()) pluginSet += "=" + k.getString ();
+			pluginSet += "]";
+		}
+		pluginSet += ";";
+	}
+
+	auto cachingDatabase = std::dynamic_pointer_cast<ModulesPluginDatabase> (pluginDatabase);
+	std::vector<size_t> ordering;
+	if (cachingDatabase && cachingDatabase->lookupOrdering (pluginSet, ordering) && ordering.size () == toAdd.size ())
+	{
+		PluginSpecVector replay (toAdd);
+		for (size_t j = 0; j < ordering.size (); ++j)
+		{
+			toAdd[j] = replay[ordering[j]];
+		}
+		return;
+	}
+
 	KeySet deps;
 	size_t i = 0;
 	for (auto const & ps : toAdd)
@@ -169,11 +196,16 @@ void BackendBuilder::sort ()
 
 	// now swap everything in toAdd as we have the indizes given in ordered
 	i = 0;
+	ordering.clear ();
 	for (auto const & o : ordered)
 	{
-		toAdd[i] = copy[atoi (ckdb::keyString (o))];
+		size_t pos = atoi (ckdb::keyString (o));
+		ordering.push_back (pos);
+		toAdd[i] = copy[pos];
 		++i;
 	}
+
+	if (cachingDatabase) cachingDatabase->cacheOrdering (pluginSet, ordering);
 }
 
 void BackendBuilder::needMetadata (std::string addMetadata)
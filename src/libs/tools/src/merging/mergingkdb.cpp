@@ -7,8 +7,11 @@
  *
  */
 
+#include <helper/comparison.hpp>
 #include <merging/mergingkdb.hpp>
 
+using namespace kdb::tools::helper;
+
 namespace kdb
 {
 
@@ -18,6 +21,86 @@ namespace tools
 namespace merging
 {
 
+namespace
+{
+
+/**
+ * @brief Replay the changes between base and ours onto theirs
+ *
+ * Walks base and ours linearly to determine the change-set (additions,
+ * modifications and deletions) and applies only that onto theirs, so
+ * the retry cost after a conflict is bounded by the size of the
+ * change-set instead of the size of the whole keyset.
+ *
+ * @retval true if all changes could be applied
+ * @retval false if a changed key was also changed concurrently and a
+ *         full merge is needed
+ */
+bool replayChanges (KeySet const & base, KeySet const & ours, KeySet & theirs)
+{
+	ssize_t const baseSize = base.size ();
+	ssize_t const ourSize = ours.size ();
+	ssize_t basePos = 0;
+	ssize_t ourPos = 0;
+
+	while (basePos < baseSize || ourPos < ourSize)
+	{
+		int cmp;
+		if (basePos >= baseSize)
+			cmp = 1;
+		else if (ourPos >= ourSize)
+			cmp = -1;
+		else
+			cmp = ckdb::keyCmp (base.at (basePos).getKey (), ours.at (ourPos).getKey ());
+
+		if (cmp < 0)
+		{
+			// deleted in ours
+			Key baseKey = base.at (basePos);
+			Key theirKey = theirs.lookup (baseKey);
+			if (theirKey)
+			{
+				// only delete what was not changed concurrently
+				if (!keyDataEqual (baseKey, theirKey) || !keyMetaEqual (baseKey, theirKey)) return false;
+				theirs.lookup (baseKey, KDB_O_POP);
+			}
+			++basePos;
+		}
+		else if (cmp > 0)
+		{
+			// added in ours
+			Key ourKey = ours.at (ourPos);
+			Key theirKey = theirs.lookup (ourKey);
+			if (theirKey && (!keyDataEqual (ourKey, theirKey) || !keyMetaEqual (ourKey, theirKey))) return false;
+			if (!theirKey) theirs.append (ourKey);
+			++ourPos;
+		}
+		else
+		{
+			Key baseKey = base.at (basePos);
+			Key ourKey = ours.at (ourPos);
+			if (!keyDataEqual (baseKey, ourKey) || !keyMetaEqual (baseKey, ourKey))
+			{
+				// modified in ours
+				Key theirKey = theirs.lookup (ourKey);
+				if (!theirKey) return false; // deleted concurrently
+				if (keyDataEqual (theirKey, baseKey) && keyMetaEqual (theirKey, baseKey))
+				{
+					theirs.append (ourKey);
+				}
+				else if (!keyDataEqual (theirKey, ourKey) || !keyMetaEqual (theirKey, ourKey))
+				{
+					return false; // modified concurrently with another value
+				}
+			}
+			++basePos;
+			++ourPos;
+		}
+	}
+	return true;
+}
+} // namespace
+
 MergingKDB::MergingKDB ()
 {
 }
@@ -70,7 +153,15 @@ int MergingKDB::synchronize (KeySet & returned, Key & parentKey, ThreeWayMerge &
 		KeySet theirs = returned.dup ();
 		KDB::get (theirs, parentKey);
 
-		// try to merge
+		// first try to replay only our change-set onto the fresh state
+		if (replayChanges (base, returned, theirs))
+		{
+			int ret = KDB::set (theirs, parentKey);
+			base = theirs;
+			return ret;
+		}
+
+		// concurrent changes overlap with ours, do a full merge
 		MergeResult result = merger.mergeKeySet (MergeTask (BaseMergeKeys (base, parentKey), OurMergeKeys (returned, parentKey),
 								    TheirMergeKeys (theirs, parentKey), parentKey));
 
@@ -11,6 +11,8 @@
 #include <helper/keyhelper.hpp>
 #include <merging/threewaymerge.hpp>
 
+#include <cstring>
+
 using namespace std;
 using namespace kdb::tools::helper;
 
@@ -23,6 +25,46 @@ namespace tools
 namespace merging
 {
 
+namespace
+{
+
+/**
+ * @brief Offset of the part of a key's unescaped name that is relative to the given parent
+ */
+size_t parentOffset (Key const & parent)
+{
+	size_t size = static_cast<size_t> (ckdb::keyGetUnescapedNameSize (parent.getKey ()));
+	// root keys consist of the namespace and one empty part, which children do not repeat
+	return size == 2 ? 1 : size;
+}
+
+/**
+ * @brief Compare two keys by their name relative to the respective parent, in KeySet order
+ *
+ * The namespace still takes part in the comparison, because below a
+ * cascading parent keys of several namespaces may occur.
+ */
+int relCmp (ckdb::Key const * k1, size_t offset1, ckdb::Key const * k2, size_t offset2)
+{
+	const unsigned char * u1 = static_cast<const unsigned char *> (ckdb::keyUnescapedName (k1));
+	const unsigned char * u2 = static_cast<const unsigned char *> (ckdb::keyUnescapedName (k2));
+	if (u1[0] != u2[0]) return u1[0] < u2[0] ? -1 : 1;
+
+	size_t usize1 = static_cast<size_t> (ckdb::keyGetUnescapedNameSize (k1));
+	size_t usize2 = static_cast<size_t> (ckdb::keyGetUnescapedNameSize (k2));
+	size_t s1 = usize1 > offset1 ? usize1 - offset1 : 0;
+	size_t s2 = usize2 > offset2 ? usize2 - offset2 : 0;
+	// a root parent itself keeps its empty part, normalize it away
+	if (s1 == 1 && u1[offset1] == '\0') s1 = 0;
+	if (s2 == 1 && u2[offset2] == '\0') s2 = 0;
+
+	size_t size = s1 < s2 ? s1 : s2;
+	int cmp = memcmp (u1 + offset1, u2 + offset2, size);
+	if (cmp != 0 || s1 == s2) return cmp;
+	return s1 < s2 ? -1 : 1;
+}
+} // namespace
+
 inline void addAsymmetricConflict (MergeResult & result, Key & key, ConflictOperation our, ConflictOperation their, bool reverse)
 {
 	if (!reverse)
@@ -37,14 +79,42 @@ inline void addAsymmetricConflict (MergeResult & result, Key & key, ConflictOper
 
 void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta = false)
 {
-	Key our;
-	elektraCursor savedCursor = task.ours.getCursor ();
-	task.ours.rewind ();
+	// all four keysets are sorted, so instead of a ksLookup per key we
+	// advance cursors through theirs and base in one linear walk over ours
+	size_t const ourOffset = parentOffset (task.ourParent);
+	size_t const theirOffset = parentOffset (task.theirParent);
+	size_t const baseOffset = parentOffset (task.baseParent);
 
-	while ((our = task.ours.next ()))
+	ssize_t const ourSize = task.ours.size ();
+	ssize_t const theirSize = task.theirs.size ();
+	ssize_t const baseSize = task.base.size ();
+	ssize_t theirPos = 0;
+	ssize_t basePos = 0;
+
+	for (ssize_t ourPos = 0; ourPos < ourSize; ++ourPos)
 	{
-		string theirLookup = rebasePath (our, task.ourParent, task.theirParent);
-		Key theirLookupResult = task.theirs.lookup (theirLookup);
+		Key our = task.ours.at (ourPos);
+
+		while (theirPos < theirSize &&
+		       relCmp (task.theirs.at (theirPos).getKey (), theirOffset, our.getKey (), ourOffset) < 0)
+		{
+			++theirPos;
+		}
+		Key theirLookupResult (static_cast<ckdb::Key *> (nullptr));
+		if (theirPos < theirSize && relCmp (task.theirs.at (theirPos).getKey (), theirOffset, our.getKey (), ourOffset) == 0)
+		{
+			theirLookupResult = task.theirs.at (theirPos);
+		}
+
+		while (basePos < baseSize && relCmp (task.base.at (basePos).getKey (), baseOffset, our.getKey (), ourOffset) < 0)
+		{
+			++basePos;
+		}
+		Key baseLookupResult (static_cast<ckdb::Key *> (nullptr));
+		if (basePos < baseSize && relCmp (task.base.at (basePos).getKey (), baseOffset, our.getKey (), ourOffset) == 0)
+		{
+			baseLookupResult = task.base.at (basePos);
+		}
 
 		// we have to copy it to obtain owner etc...
 		Key mergeKey = rebaseKey (our, task.ourParent, task.mergeRoot);
@@ -73,9 +143,6 @@ void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & merge
 		}
 		else
 		{
-			string baseLookup = rebasePath (our, task.ourParent, task.baseParent);
-			Key baseLookupResult = task.base.lookup (baseLookup);
-
 			// check if the keys was newly added in ours
 			if (baseLookupResult)
 			{
@@ -161,8 +228,6 @@ void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & merge
 			}
 		}
 	}
-
-	task.ours.setCursor (savedCursor);
 }
 
 
@@ -177,22 +242,37 @@ MergeResult ThreeWayMerge::mergeKeySet (const MergeTask & task)
 
 
 	// TODO: test this behaviour (would probably need mocks)
+	// each conflict flows through the strategies until one resolves it
 	Key current;
 	KeySet conflicts = result.getConflictSet ();
 	conflicts.rewind ();
 	while ((current = conflicts.next ()))
 	{
-		for (auto & elem : strategies)
+		for (size_t strategyIndex = 0; strategyIndex < strategies.size (); ++strategyIndex)
 		{
-			(elem)->resolveConflict (task, current, result);
+			strategies[strategyIndex]->resolveConflict (task, current, result);
 
-			if (!result.isConflict (current)) break;
+			if (!result.isConflict (current))
+			{
+				++resolutionCounters[strategyIndex];
+				break;
+			}
 		}
 	}
 
 	return result;
 }
 
+std::map<std::string, size_t> ThreeWayMerge::getResolutionStatistics () const
+{
+	std::map<std::string, size_t> statistics;
+	for (size_t strategyIndex = 0; strategyIndex < strategies.size (); ++strategyIndex)
+	{
+		statistics[strategies[strategyIndex]->getName ()] += resolutionCounters[strategyIndex];
+	}
+	return statistics;
+}
+
 MergeResult ThreeWayMerge::mergeKeySet (const KeySet & base, const KeySet & ours, const KeySet & theirs, const Key & mergeRoot)
 {
 	Key ourkey = ours.head ().dup ();
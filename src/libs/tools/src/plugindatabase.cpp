@@ -14,13 +14,22 @@
 #include <set>
 
 #include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <thread>
 #include <helper/keyhelper.hpp>
 #include <kdbconfig.h>
 #include <kdblogger.h>
 #include <kdbmacros.h>
+#include <kdbprivate.h> // for elektraPluginGetContract()
 
 #ifdef HAVE_GLOB
 #include <glob.h>
+#include <sys/stat.h>
+#include <sys/types.h>
 #endif
 
 namespace kdb
@@ -29,6 +38,277 @@ namespace kdb
 namespace tools
 {
 
+namespace
+{
+
+/**
+ * @brief Check for the default config used when a plugin is loaded only to read its contract
+ */
+bool isModuleConfig (KeySet conf)
+{
+	if (conf.size () != 1) return false;
+	Key k = conf.at (0);
+	return k && k.getName () == "system:/module";
+}
+
+#if defined(ELEKTRA_SHARED) && defined(HAVE_GLOB)
+
+/**
+ * @brief Persistent index of plugin contract infos
+ *
+ * Answers lookupInfo() queries for plugins loaded with the default module
+ * config from an on-disk index instead of dlopening every candidate.
+ * Entries are validated against the modification time of the plugin's
+ * shared object and lazily regenerated via the normal module loading path
+ * when they are missing or stale.
+ */
+class ContractIndex
+{
+public:
+	/**
+	 * @brief Look up a contract info from the index
+	 *
+	 * Refreshes the entry through @p modules if it is missing or stale.
+	 *
+	 * @retval true if the index answered the query (value may be empty)
+	 * @retval false if the plugin cannot be validated and the caller
+	 *         should fall back to loading the module itself
+	 */
+	bool lookup (std::string const & pluginName, std::string const & which, Modules & modules, std::string & value)
+	{
+		ensureLoaded ();
+
+		time_t mtime = pluginMtime (pluginName);
+		if (mtime == 0) return false;
+
+		auto it = m_entries.find (pluginName);
+		if (it == m_entries.end () || it->second.mtime != mtime)
+		{
+			KeySet conf (5, *Key ("system:/module", KEY_VALUE, "this plugin was loaded without a config", KEY_END), KS_END);
+			PluginPtr plugin = modules.load (pluginName, conf);
+			insert (pluginName, mtime, extractInfos (pluginName, *plugin));
+			sync ();
+			it = m_entries.find (pluginName);
+		}
+
+		auto info = it->second.infos.find (which);
+		value = info == it->second.infos.end () ? "" : info->second;
+		return true;
+	}
+
+	/**
+	 * @brief Return the plugins whose entries are missing or stale, paired with the current mtime
+	 */
+	std::vector<std::pair<std::string, time_t>> stale (std::vector<std::string> const & plugins)
+	{
+		ensureLoaded ();
+
+		std::vector<std::pair<std::string, time_t>> ret;
+		for (auto const & plugin : plugins)
+		{
+			time_t mtime = pluginMtime (plugin);
+			if (mtime == 0) continue;
+			auto it = m_entries.find (plugin);
+			if (it == m_entries.end () || it->second.mtime != mtime)
+			{
+				ret.push_back (std::make_pair (plugin, mtime));
+			}
+		}
+		return ret;
+	}
+
+	/**
+	 * @brief Add or replace an entry, without writing the index back
+	 */
+	void insert (std::string const & pluginName, time_t mtime, std::map<std::string, std::string> infos)
+	{
+		Entry entry;
+		entry.mtime = mtime;
+		entry.infos = std::move (infos);
+		m_entries[pluginName] = std::move (entry);
+	}
+
+	/**
+	 * @brief Write the index back to disk
+	 */
+	void sync () const
+	{
+		saveFile ();
+	}
+
+	/**
+	 * @brief Extract the infos section of a plugin's contract
+	 */
+	static std::map<std::string, std::string> extractInfos (std::string const & pluginName, Plugin & plugin)
+	{
+		std::map<std::string, std::string> infos;
+		Key root ("system:/elektra/modules/" + pluginName + "/infos", KEY_END);
+		for (Key k : plugin.getInfo ())
+		{
+			if (k.isBelow (root))
+			{
+				infos[k.getBaseName ()] = k.getString ();
+			}
+		}
+		return infos;
+	}
+
+private:
+	struct Entry
+	{
+		time_t mtime;
+		std::map<std::string, std::string> infos;
+	};
+
+	void ensureLoaded ()
+	{
+		if (!m_loaded)
+		{
+			loadFile ();
+			m_loaded = true;
+		}
+	}
+
+	static time_t pluginMtime (std::string const & pluginName)
+	{
+		time_t mtime = 0;
+		std::string pattern = BUILTIN_PLUGIN_FOLDER "/libelektra-" + pluginName + ".*";
+		glob_t pglob;
+		if (glob (pattern.c_str (), GLOB_NOSORT, NULL, &pglob) == 0)
+		{
+			struct stat st;
+			if (pglob.gl_pathc > 0 && stat (pglob.gl_pathv[0], &st) == 0)
+			{
+				mtime = st.st_mtime;
+			}
+			globfree (&pglob);
+		}
+		return mtime;
+	}
+
+	static std::string indexFile ()
+	{
+		std::string dir;
+		const char * cache = getenv ("XDG_CACHE_HOME");
+		if (cache && cache[0] == '/')
+		{
+			dir = std::string (cache);
+		}
+		else
+		{
+			const char * home = getenv ("HOME");
+			if (!home || home[0] != '/') return "";
+			dir = std::string (home) + "/.cache";
+			mkdir (dir.c_str (), 0700);
+		}
+		dir += "/elektra";
+		mkdir (dir.c_str (), 0700);
+		return dir + "/plugincontracts";
+	}
+
+	static std::string escape (std::string const & value)
+	{
+		std::string ret;
+		ret.reserve (value.size ());
+		for (char c : value)
+		{
+			if (c == '\\')
+				ret += "\\\\";
+			else if (c == '\n')
+				ret += "\\n";
+			else
+				ret += c;
+		}
+		return ret;
+	}
+
+	static std::string unescape (std::string const & value)
+	{
+		std::string ret;
+		ret.reserve (value.size ());
+		for (size_t i = 0; i < value.size (); ++i)
+		{
+			if (value[i] == '\\' && i + 1 < value.size ())
+			{
+				++i;
+				ret += value[i] == 'n' ? '\n' : value[i];
+			}
+			else
+			{
+				ret += value[i];
+			}
+		}
+		return ret;
+	}
+
+	void loadFile ()
+	{
+		std::string file = indexFile ();
+		if (file.empty ()) return;
+
+		std::ifstream in (file);
+		std::string line;
+		if (!std::getline (in, line) || line != "elektra-plugin-index v1") return;
+
+		std::map<std::string, Entry>::iterator current = m_entries.end ();
+		while (std::getline (in, line))
+		{
+			if (line.empty ()) continue;
+			if (line[0] == '\t')
+			{
+				size_t sep = line.find ('=');
+				if (current == m_entries.end () || sep == std::string::npos) continue;
+				current->second.infos[line.substr (1, sep - 1)] = unescape (line.substr (sep + 1));
+			}
+			else
+			{
+				size_t sep = line.find (' ');
+				if (sep == std::string::npos) continue;
+				Entry entry;
+				entry.mtime = static_cast<time_t> (strtoll (line.c_str () + sep + 1, NULL, 10));
+				current = m_entries.insert (std::make_pair (line.substr (0, sep), entry)).first;
+			}
+		}
+	}
+
+	void saveFile () const
+	{
+		std::string file = indexFile ();
+		if (file.empty ()) return;
+
+		std::string tmp = file + ".tmp";
+		{
+			std::ofstream out (tmp);
+			if (!out) return;
+			out << "elektra-plugin-index v1\n";
+			for (auto const & entry : m_entries)
+			{
+				out << entry.first << " " << entry.second.mtime << "\n";
+				for (auto const & info : entry.second.infos)
+				{
+					out << "\t" << info.first << "=" << escape (info.second) << "\n";
+				}
+			}
+			if (!out.good ())
+			{
+				std::remove (tmp.c_str ());
+				return;
+			}
+		}
+		if (std::rename (tmp.c_str (), file.c_str ()) != 0)
+		{
+			std::remove (tmp.c_str ());
+		}
+	}
+
+	bool m_loaded = false;
+	std::map<std::string, Entry> m_entries;
+};
+
+#endif
+
+} // namespace
+
 class ModulesPluginDatabase::Impl
 {
 public:
@@ -39,6 +319,10 @@ public:
 	{
 	}
 	Modules modules;
+	mutable std::map<std::string, std::vector<size_t>> orderingCache;
+#if defined(ELEKTRA_SHARED) && defined(HAVE_GLOB)
+	ContractIndex contractIndex;
+#endif
 };
 
 ModulesPluginDatabase::ModulesPluginDatabase () : impl (new ModulesPluginDatabase::Impl ())
@@ -231,10 +515,123 @@ PluginDatabase::Status ModulesPluginDatabase::status (PluginSpec const & spec) c
 
 std::string ModulesPluginDatabase::lookupInfo (PluginSpec const & spec, std::string const & which) const
 {
+#if defined(ELEKTRA_SHARED) && defined(HAVE_GLOB)
+	if (isModuleConfig (spec.getConfig ()))
+	{
+		std::string value;
+		if (impl->contractIndex.lookup (spec.getName (), which, impl->modules, value))
+		{
+			return value;
+		}
+	}
+#endif
+	if (isModuleConfig (spec.getConfig ()))
+	{
+		// a plugin registering the contract-only entry point is not
+		// instantiated at all, so plugins with a heavyweight open
+		// (sockets, child processes) answer contract queries instantly
+		Key errorKey;
+		ckdb::KeySet * contract =
+			ckdb::elektraPluginGetContract (spec.getName ().c_str (), impl->modules.getModules ().getKeySet (), *errorKey);
+		if (contract != nullptr)
+		{
+			Key infoKey ("system:/elektra/modules", KEY_END);
+			infoKey.addBaseName (spec.getName ());
+			infoKey.addName ("infos");
+			infoKey.addBaseName (which);
+			ckdb::Key * found = ckdb::ksLookup (contract, *infoKey, 0);
+			std::string value = found != nullptr ? ckdb::keyString (found) : "";
+			ckdb::ksDel (contract);
+			return value;
+		}
+	}
 	PluginPtr plugin = impl->modules.load (spec.getName (), spec.getConfig ());
 	return plugin->lookupInfo (which);
 }
 
+void ModulesPluginDatabase::preloadContracts (std::vector<std::string> const & plugins) const
+{
+#if defined(ELEKTRA_SHARED) && defined(HAVE_GLOB)
+	std::vector<std::pair<std::string, time_t>> todo = impl->contractIndex.stale (plugins);
+	if (todo.empty ()) return;
+
+	struct Loaded
+	{
+		size_t pos;
+		std::map<std::string, std::string> infos;
+	};
+
+	size_t nthreads = std::thread::hardware_concurrency ();
+	if (nthreads == 0) nthreads = 1;
+	if (nthreads > todo.size ()) nthreads = todo.size ();
+
+	std::atomic<size_t> next (0);
+	std::mutex lock;
+	std::vector<Loaded> loaded;
+
+	auto worker = [&] () {
+		// modules must not be shared across threads, each worker loads into its own instance
+		Modules modules;
+		for (size_t i = next++; i < todo.size (); i = next++)
+		{
+			try
+			{
+				KeySet conf (5, *Key ("system:/module", KEY_VALUE, "this plugin was loaded without a config", KEY_END),
+					     KS_END);
+				PluginPtr plugin = modules.load (todo[i].first, conf);
+				Loaded l;
+				l.pos = i;
+				l.infos = ContractIndex::extractInfos (todo[i].first, *plugin);
+				std::lock_guard<std::mutex> guard (lock);
+				loaded.push_back (std::move (l));
+			}
+			catch (...)
+			{
+				// broken plugins are reported when they are looked up directly
+			}
+		}
+	};
+
+	if (nthreads == 1)
+	{
+		worker ();
+	}
+	else
+	{
+		std::vector<std::thread> pool;
+		for (size_t t = 0; t < nthreads; ++t)
+		{
+			pool.emplace_back (worker);
+		}
+		for (auto & t : pool)
+		{
+			t.join ();
+		}
+	}
+
+	for (auto & l : loaded)
+	{
+		impl->contractIndex.insert (todo[l.pos].first, todo[l.pos].second, std::move (l.infos));
+	}
+	if (!loaded.empty ()) impl->contractIndex.sync ();
+#else
+	static_cast<void> (plugins);
+#endif
+}
+
+bool ModulesPluginDatabase::lookupOrdering (std::string const & pluginSet, std::vector<size_t> & ordering) const
+{
+	auto it = impl->orderingCache.find (pluginSet);
+	if (it == impl->orderingCache.end ()) return false;
+	ordering = it->second;
+	return true;
+}
+
+void ModulesPluginDatabase::cacheOrdering (std::string const & pluginSet, std::vector<size_t> const & ordering) const
+{
+	impl->orderingCache[pluginSet] = ordering;
+}
+
 PluginDatabase::func_t ModulesPluginDatabase::getSymbol (PluginSpec const & spec, std::string const & which) const
 {
 	try
@@ -251,6 +648,7 @@ PluginDatabase::func_t ModulesPluginDatabase::getSymbol (PluginSpec const & spec
 PluginSpec ModulesPluginDatabase::lookupMetadata (std::string const & which) const
 {
 	std::vector<std::string> allPlugins = listAllPlugins ();
+	preloadContracts (allPlugins);
 	std::map<int, PluginSpec> foundPlugins;
 
 	std::string errors;
@@ -327,6 +725,7 @@ std::map<int, PluginSpec> ModulesPluginDatabase::lookupAllProvidesWithStatus (st
 {
 	std::string errors;
 	std::vector<std::string> allPlugins = listAllPlugins ();
+	preloadContracts (allPlugins);
 	std::map<int, PluginSpec> foundPlugins;
 	for (auto const & plugin : allPlugins)
 	{
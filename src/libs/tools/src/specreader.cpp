@@ -58,6 +58,43 @@ bool startsWith (std::string const & str, std::string const & start)
 	return std::equal (start.begin (), start.end (), str.begin ());
 }
 
+void digestAppend (uint64_t & digest, std::string const & data)
+{
+	// FNV-1a
+	for (char c : data)
+	{
+		digest ^= static_cast<unsigned char> (c);
+		digest *= 1099511628211ULL;
+	}
+	digest ^= 0xff; // field separator
+	digest *= 1099511628211ULL;
+}
+
+/**
+ * @brief Digest of a spec subtree (names, values and metadata)
+ */
+uint64_t specDigest (KeySet const & cks)
+{
+	uint64_t digest = 14695981039346656037ULL;
+	for (Key const & ck : cks)
+	{
+		digestAppend (digest, ck.getName ());
+		if (ck.isString ())
+		{
+			digestAppend (digest, ck.getString ());
+		}
+		Key k (ck);
+		k.rewindMeta ();
+		Key m;
+		while ((m = k.nextMeta ()))
+		{
+			digestAppend (digest, m.getName ());
+			digestAppend (digest, m.getString ());
+		}
+	}
+	return digest;
+}
+
 bool isToBeIgnored (std::string const & metaName)
 {
 	const auto & name = metaName.substr (sizeof ("meta:/") - 1);
@@ -185,8 +222,25 @@ void SpecReader::readSpecification (KeySet const & cks)
 		Key m = k.getMeta<const Key> ("mountpoint");
 		if (m)
 		{
-			SpecMountpointReader smr (backends, bbi);
-			backends[k] = smr.readMountpointSpecification (ks.cut (k));
+			KeySet cut = ks.cut (k);
+			uint64_t digest = specDigest (cut);
+
+			auto it = fragments.find (k.getName ());
+			if (it == fragments.end () || it->second.digest != digest)
+			{
+				// (re)parse into a fresh fragment
+				ParsedFragment fragment;
+				fragment.digest = digest;
+				SpecMountpointReader smr (fragment.backends, bbi);
+				fragment.backends[k] = smr.readMountpointSpecification (cut);
+				fragments[k.getName ()] = std::move (fragment);
+				it = fragments.find (k.getName ());
+			}
+
+			for (auto const & b : it->second.backends)
+			{
+				backends[b.first] = b.second;
+			}
 		}
 	}
 }
@@ -91,10 +91,39 @@ TEST_F (MergingKDBTest, ThrowsIfNoConflictStrategyRegistered)
 	firstReturned.append (Key ("system:" + testRoot + "key", KEY_VALUE, "value", KEY_END));
 	first.set (firstReturned, parent);
 
-	secondReturned.append (Key ("system:" + testRoot + "key2", KEY_VALUE, "value2", KEY_END));
+	secondReturned.append (Key ("system:" + testRoot + "key", KEY_VALUE, "conflicting", KEY_END));
 	EXPECT_THROW (mergingKDB.synchronize (secondReturned, parent, merger), MergingKDBException);
 }
 
+TEST_F (MergingKDBTest, SynchronizesDisjointChangesWithoutStrategy)
+{
+	KDB first;
+	MergingKDB mergingKDB;
+	Key parent (testRoot, KEY_END);
+
+	first.get (firstReturned, parent);
+	mergingKDB.get (secondReturned, parent);
+	std::this_thread::sleep_for (std::chrono::milliseconds (100));
+
+	Key key1 ("system:" + testRoot + "key", KEY_VALUE, "value", KEY_END);
+	firstReturned.append (key1);
+	first.set (firstReturned, parent);
+
+	Key key2 ("system:" + testRoot + "key2", KEY_VALUE, "value2", KEY_END);
+	secondReturned.append (key2);
+	// changes to different keys are replayed without consulting the merger
+	mergingKDB.synchronize (secondReturned, parent, merger);
+
+	first.get (firstReturned, parent);
+	Key resultKey1 = firstReturned.lookup ("system:" + testRoot + "key");
+	Key resultKey2 = firstReturned.lookup ("system:" + testRoot + "key2");
+	EXPECT_EQ (2, firstReturned.size ()) << "Written KeySet has a wrong size";
+	ASSERT_TRUE (resultKey1);
+	EXPECT_EQ (key1, resultKey1) << "Key1 was not written correctly";
+	ASSERT_TRUE (resultKey2);
+	EXPECT_EQ (key2, resultKey2) << "Key2 was not written correctly";
+}
+
 TEST_F (MergingKDBTest, MergesResolvableConflicts)
 {
 	KDB first;
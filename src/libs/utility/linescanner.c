@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <kdbassert.h>
+#include <kdbhelper.h>
+#include <kdblogger.h>
+
+#include <kdbutility.h>
+
+/**
+ * @internal
+ *
+ * @brief This function opens a line scanner for the given file.
+ *
+ * The scanner reads the whole file into a single buffer once. The lines
+ * handed out by `elektraLineScannerNext` point into this buffer, so
+ * scanning does not allocate or copy per line.
+ *
+ * @pre The parameters `scanner` and `filename` must not be `NULL`.
+ *
+ * @param scanner The scanner this function initializes
+ * @param filename The name of the file this function reads
+ *
+ * @retval 1 if the file was read successfully
+ * @retval 0 if the file could not be opened or read
+ */
+int elektraLineScannerOpen (ElektraLineScanner * scanner, const char * filename)
+{
+	ELEKTRA_ASSERT (scanner != NULL, "The Parameter `scanner` contains `NULL` instead of a valid scanner.");
+	ELEKTRA_ASSERT (filename != NULL, "The Parameter `filename` contains `NULL` instead of a valid string.");
+
+	scanner->buffer = NULL;
+	scanner->size = 0;
+	scanner->offset = 0;
+
+	FILE * fp = fopen (filename, "rb");
+	if (!fp) return 0;
+
+	if (fseek (fp, 0, SEEK_END))
+	{
+		fclose (fp);
+		return 0;
+	}
+	long size = ftell (fp);
+	if (size < 0)
+	{
+		fclose (fp);
+		return 0;
+	}
+	rewind (fp);
+
+	char * buffer = elektraMalloc ((size_t) size + 1);
+	if (!buffer)
+	{
+		fclose (fp);
+		return 0;
+	}
+
+	size_t bytesRead = fread (buffer, 1, (size_t) size, fp);
+	fclose (fp);
+	if (bytesRead != (size_t) size)
+	{
+		elektraFree (buffer);
+		return 0;
+	}
+	buffer[bytesRead] = '\0';
+
+	scanner->buffer = buffer;
+	scanner->size = bytesRead;
+	return 1;
+}
+
+/**
+ * @internal
+ *
+ * @brief This function returns the next line of the scanned file.
+ *
+ * The returned line lives inside the scanner's buffer and stays valid until
+ * `elektraLineScannerClose` is called. The trailing newline is replaced by
+ * a terminating null byte, so the line can be used as an ordinary string.
+ *
+ * @pre The parameter `scanner` must not be `NULL`.
+ *
+ * @param scanner The scanner from which this function takes the next line
+ * @param length The location this function uses to store the length of the
+ *               line (without the newline) or `NULL`
+ *
+ * @return A pointer to the start of the line or `NULL` if the end of the
+ *         file was reached
+ */
+char * elektraLineScannerNext (ElektraLineScanner * scanner, size_t * length)
+{
+	ELEKTRA_ASSERT (scanner != NULL, "The Parameter `scanner` contains `NULL` instead of a valid scanner.");
+
+	if (!scanner->buffer || scanner->offset >= scanner->size) return NULL;
+
+	char * line = scanner->buffer + scanner->offset;
+	char * newline = memchr (line, '\n', scanner->size - scanner->offset);
+	size_t lineLength;
+	if (newline)
+	{
+		lineLength = (size_t) (newline - line);
+		*newline = '\0';
+		scanner->offset += lineLength + 1;
+	}
+	else
+	{
+		/* the last line has no trailing newline, the buffer already ends with a null byte */
+		lineLength = scanner->size - scanner->offset;
+		scanner->offset = scanner->size;
+	}
+	if (length) *length = lineLength;
+	return line;
+}
+
+/**
+ * @internal
+ *
+ * @brief This function frees all resources of the given line scanner.
+ *
+ * @pre The parameter `scanner` must not be `NULL`.
+ *
+ * @param scanner The scanner this function closes
+ */
+void elektraLineScannerClose (ElektraLineScanner * scanner)
+{
+	ELEKTRA_ASSERT (scanner != NULL, "The Parameter `scanner` contains `NULL` instead of a valid scanner.");
+
+	if (scanner->buffer) elektraFree (scanner->buffer);
+	scanner->buffer = NULL;
+	scanner->size = 0;
+	scanner->offset = 0;
+}
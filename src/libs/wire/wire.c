@@ -0,0 +1,573 @@
+/**
+ * @file
+ *
+ * @brief Compact binary KeySet codec for network byte streams
+ *
+ * The wire format follows the record model of the quickdump storage
+ * plugin (front-coded key names, varint length prefixes, interned
+ * metakey names), but works on memory buffers instead of files, so a
+ * KeySet can be sent over a socket and reconstructed on the other side
+ * without going through a storage plugin and a temporary file.
+ *
+ * A message looks like this (all lengths are quickdump varints):
+ *
+ * - the magic bytes "EKw1"
+ * - the number of keys
+ * - per key:
+ *   - length of the name prefix shared with the previous key, then the
+ *     remaining suffix of the key name (relative to the parent key)
+ *   - a type byte 's' or 'b' followed by the value; string values are
+ *     stored with their null terminator, binary values with their exact
+ *     size
+ *   - any number of 'm' records carrying a metakey (an index into the
+ *     table of previously seen metakey names, or 0 followed by a new
+ *     name) and its value, terminated by a 0 byte
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <kdbwire.h>
+
+#include <kdbhelper.h>
+#include <kdbprivate.h>
+#include <kdbtypes.h>
+
+#include <string.h>
+#include <strings.h>
+
+static const char wireMagic[4] = { 'E', 'K', 'w', '1' };
+
+/**
+ * @internal
+ * Growable output buffer, continues in the buffer passed by the caller.
+ */
+struct wireWriter
+{
+	char * buffer;
+	size_t alloc;
+	size_t offset;
+};
+
+static bool writerEnsure (struct wireWriter * writer, size_t additional)
+{
+	size_t needed = writer->offset + additional;
+	if (needed <= writer->alloc) return true;
+
+	size_t alloc = writer->alloc == 0 ? 256 : writer->alloc;
+	while (alloc < needed)
+	{
+		alloc *= 2;
+	}
+
+	if (elektraRealloc ((void **) &writer->buffer, alloc) < 0) return false;
+	writer->alloc = alloc;
+	return true;
+}
+
+// same prefix-free encoding as varintWrite in the quickdump plugin,
+// but appended to a memory buffer
+static bool writeVarint (struct wireWriter * writer, kdb_unsigned_long_long_t num)
+{
+	kdb_octet_t varint[9];
+
+	unsigned int len = 64 - __builtin_clzll (num | 1u);
+	len = 1 + (len - 1) / 7;
+
+	if (len > 8)
+	{
+		len = 9;
+		varint[0] = 0;
+	}
+	else
+	{
+		num = ((num << 1u) | 1u) << (len - 1);
+		varint[0] = num & 0xFFu;
+		num >>= 8u;
+	}
+
+	for (unsigned int i = 1; i < len; ++i)
+	{
+		varint[i] = num & 0xFFu;
+		num >>= 8u;
+	}
+
+	if (!writerEnsure (writer, len)) return false;
+	memcpy (writer->buffer + writer->offset, varint, len);
+	writer->offset += len;
+	return true;
+}
+
+static bool writeByte (struct wireWriter * writer, char c)
+{
+	if (!writerEnsure (writer, 1)) return false;
+	writer->buffer[writer->offset] = c;
+	++writer->offset;
+	return true;
+}
+
+static bool writeData (struct wireWriter * writer, const char * data, size_t size)
+{
+	if (!writeVarint (writer, size) || !writerEnsure (writer, size)) return false;
+	if (size > 0)
+	{
+		memcpy (writer->buffer + writer->offset, data, size);
+		writer->offset += size;
+	}
+	return true;
+}
+
+/**
+ * @internal
+ * Table of metakey names seen so far, for interned back references.
+ * The entries point into the keys being encoded or into the message
+ * being decoded, so they stay valid without copies.
+ */
+struct wireMetaNames
+{
+	size_t alloc;
+	size_t size;
+	const char ** names;
+};
+
+static ssize_t findWireMetaName (struct wireMetaNames * table, const char * name)
+{
+	// the number of distinct metakey names is usually small, a linear scan is fine
+	for (size_t i = 0; i < table->size; ++i)
+	{
+		if (elektraStrCmp (table->names[i], name) == 0)
+		{
+			return (ssize_t) i;
+		}
+	}
+	return -1;
+}
+
+static bool appendWireMetaName (struct wireMetaNames * table, const char * name)
+{
+	if (table->size >= table->alloc)
+	{
+		table->alloc *= 2;
+		if (elektraRealloc ((void **) &table->names, table->alloc * sizeof (const char *)) < 0) return false;
+	}
+	table->names[table->size] = name;
+	++table->size;
+	return true;
+}
+
+/**
+ * @internal
+ * Writes one key record: front-coded relative name, value and metadata.
+ */
+static bool writeKey (struct wireWriter * writer, Key * cur, size_t parentOffset, const char ** prevName, size_t * prevNameLen,
+		      struct wireMetaNames * metaNames)
+{
+	size_t fullNameSize = keyGetNameSize (cur);
+	if (fullNameSize < parentOffset) return false;
+
+	size_t nameLen = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
+	const char * name = keyName (cur) + parentOffset;
+
+	// write only the suffix after the prefix shared with the previous key name
+	size_t prefixLen = 0;
+	size_t maxPrefix = nameLen < *prevNameLen ? nameLen : *prevNameLen;
+	while (prefixLen < maxPrefix && name[prefixLen] == (*prevName)[prefixLen])
+	{
+		++prefixLen;
+	}
+
+	if (!writeVarint (writer, prefixLen) || !writeData (writer, name + prefixLen, nameLen - prefixLen)) return false;
+
+	*prevName = name;
+	*prevNameLen = nameLen;
+
+	if (keyIsBinary (cur))
+	{
+		if (!writeByte (writer, 'b')) return false;
+
+		size_t valueSize = keyValue (cur) == NULL ? 0 : (size_t) keyGetValueSize (cur);
+		if (!writeData (writer, keyValue (cur), valueSize)) return false;
+	}
+	else
+	{
+		// string values keep their null terminator, so the decoder can
+		// hand them on without an intermediate copy
+		if (!writeByte (writer, 's') || !writeData (writer, keyString (cur), elektraStrLen (keyString (cur)))) return false;
+	}
+
+	KeySet * meta = keyMeta (cur);
+	ssize_t metaCount = ksGetSize (meta);
+	for (elektraCursor m = 0; m < metaCount; ++m)
+	{
+		const Key * metaKey = ksAtCursor (meta, m);
+		// ignore the meta namespace on the wire, like quickdump does on disk
+		const char * metaName = keyName (metaKey) + sizeof ("meta:/") - 1;
+
+		if (!writeByte (writer, 'm')) return false;
+
+		ssize_t id = findWireMetaName (metaNames, metaName);
+		if (id >= 0)
+		{
+			if (!writeVarint (writer, id + 1)) return false;
+		}
+		else
+		{
+			if (!writeVarint (writer, 0) || !writeData (writer, metaName, elektraStrLen (metaName))) return false;
+			if (!appendWireMetaName (metaNames, metaName)) return false;
+		}
+
+		if (!writeData (writer, keyString (metaKey), elektraStrLen (keyString (metaKey)))) return false;
+	}
+
+	return writeByte (writer, 0);
+}
+
+/**
+ * Encodes @p ks into a wire message in @p buffer.
+ *
+ * Key names are stored relative to @p parentKey, so the decoding side
+ * can rebuild the keys below its own parent key. With @p parentKey NULL
+ * the full names including the namespace are used instead.
+ *
+ * The buffer is grown with elektraRealloc() as needed; pass a pointer to
+ * NULL (with @p bufferSize 0) for the first message and reuse the buffer
+ * for subsequent ones to avoid per-message allocations. The caller frees
+ * the buffer with elektraFree(). Both @p buffer and @p bufferSize are
+ * updated even when encoding fails.
+ *
+ * @param ks         the keys to encode
+ * @param parentKey  the common parent of all keys in @p ks, or NULL
+ * @param buffer     in/out: the message buffer
+ * @param bufferSize in/out: the allocated size of @p buffer
+ *
+ * @return the size of the encoded message in bytes
+ * @retval -1 on NULL pointers, keys outside @p parentKey or memory errors
+ *
+ * @see elektraWireDecode() for the reverse operation
+ */
+ssize_t elektraWireEncode (KeySet * ks, const Key * parentKey, void ** buffer, size_t * bufferSize)
+{
+	if (ks == NULL || buffer == NULL || bufferSize == NULL) return -1;
+
+	struct wireWriter writer = { *buffer, *bufferSize, 0 };
+
+	struct wireMetaNames metaNames;
+	metaNames.alloc = 16;
+	metaNames.size = 0;
+	metaNames.names = elektraMalloc (metaNames.alloc * sizeof (const char *));
+
+	size_t parentOffset = parentKey == NULL ? 0 : keyGetNameSize (parentKey);
+
+	bool success = writerEnsure (&writer, sizeof (wireMagic));
+	if (success)
+	{
+		memcpy (writer.buffer, wireMagic, sizeof (wireMagic));
+		writer.offset = sizeof (wireMagic);
+		success = writeVarint (&writer, ksGetSize (ks));
+	}
+
+	// front-coding state: relative name of the previously written key
+	const char * prevName = NULL;
+	size_t prevNameLen = 0;
+
+	ssize_t size = ksGetSize (ks);
+	for (elektraCursor it = 0; success && it < size; ++it)
+	{
+		Key * cur = ksAtCursor (ks, it);
+		if (parentKey != NULL &&
+		    (keyIsBelowOrSame (parentKey, cur) != 1 || keyGetNamespace (cur) != keyGetNamespace (parentKey)))
+		{
+			success = false;
+			break;
+		}
+		success = writeKey (&writer, cur, parentOffset, &prevName, &prevNameLen, &metaNames);
+	}
+
+	elektraFree (metaNames.names);
+
+	*buffer = writer.buffer;
+	*bufferSize = writer.alloc;
+	return success ? (ssize_t) writer.offset : -1;
+}
+
+/**
+ * @internal
+ * Read position in the message being decoded.
+ */
+struct wireReader
+{
+	const kdb_octet_t * data;
+	size_t size;
+	size_t pos;
+};
+
+// counterpart of varintRead in the quickdump plugin, reading from a buffer
+static bool readVarint (struct wireReader * reader, kdb_unsigned_long_long_t * result)
+{
+	if (reader->pos >= reader->size) return false;
+
+	const kdb_octet_t * varint = reader->data + reader->pos;
+
+	unsigned int ctz = ffs (varint[0]);
+	unsigned int len, cnt, i;
+	kdb_unsigned_long_long_t num;
+
+	if (ctz == 0)
+	{
+		len = 8;
+		cnt = 8;
+		i = 0;
+	}
+	else
+	{
+		len = ctz;
+		cnt = len - 1;
+		i = 1;
+	}
+
+	if (reader->size - reader->pos < cnt + 1) return false;
+
+	if (ctz == 0)
+	{
+		varint++;
+		num = 0;
+	}
+	else
+	{
+		num = varint[0] >> len;
+	}
+
+	for (; i < len; ++i)
+	{
+		unsigned int shift = i * 8u - ctz;
+		num |= (kdb_unsigned_long_long_t) varint[i] << shift;
+	}
+
+	reader->pos += cnt + 1;
+	*result = num;
+	return true;
+}
+
+static bool readByte (struct wireReader * reader, kdb_octet_t * result)
+{
+	if (reader->pos >= reader->size) return false;
+	*result = reader->data[reader->pos];
+	++reader->pos;
+	return true;
+}
+
+/**
+ * @internal
+ * Reads a length-prefixed block and checks that it ends with a null
+ * terminator, so the returned pointer can be used as a string without
+ * copying it out of the message.
+ */
+static const char * readString (struct wireReader * reader)
+{
+	kdb_unsigned_long_long_t size = 0;
+	if (!readVarint (reader, &size)) return NULL;
+	if (size == 0 || size > reader->size - reader->pos) return NULL;
+	if (reader->data[reader->pos + size - 1] != '\0') return NULL;
+
+	const char * string = (const char *) reader->data + reader->pos;
+	reader->pos += size;
+	return string;
+}
+
+/**
+ * Decodes a wire message produced by elektraWireEncode().
+ *
+ * The keys are rebuilt below @p parentKey (which may differ from the one
+ * used for encoding) in a KeySet with an attached arena, so the whole
+ * message is materialized in a single pass without per-key allocations:
+ * names are assembled once, values and metakey names are passed straight
+ * from the message into the arena. The buffer is not referenced by the
+ * returned KeySet and can be reused immediately. Bytes after the end of
+ * the message are ignored, truncated or malformed messages are rejected.
+ *
+ * @param buffer    the message to decode
+ * @param size      the size of @p buffer in bytes
+ * @param parentKey the parent key to decode below, or NULL when the
+ *                  message was encoded with full key names
+ *
+ * @return a new KeySet containing the decoded keys, to be freed with ksDel()
+ * @retval NULL on NULL @p buffer or an invalid message
+ *
+ * @see elektraWireEncode() for the reverse operation
+ * @see ksNewWithArena() for the restrictions on arena-backed KeySets
+ */
+KeySet * elektraWireDecode (const void * buffer, size_t size, const Key * parentKey)
+{
+	if (buffer == NULL || size < sizeof (wireMagic) || memcmp (buffer, wireMagic, sizeof (wireMagic)) != 0) return NULL;
+
+	struct wireReader reader = { buffer, size, sizeof (wireMagic) };
+
+	kdb_unsigned_long_long_t keyCount = 0;
+	if (!readVarint (&reader, &keyCount)) return NULL;
+
+	// assembly buffer for the front-coded key names, prefixed with the parent name
+	size_t nameAlloc = 64;
+	size_t parentSize = parentKey == NULL ? 1 : keyGetNameSize (parentKey); // includes null terminator
+	while (nameAlloc < parentSize + 1)
+	{
+		nameAlloc *= 2;
+	}
+	char * nameBuffer = elektraMalloc (nameAlloc);
+	size_t nameOffset = 0;
+	if (parentKey != NULL)
+	{
+		keyGetName (parentKey, nameBuffer, parentSize);
+		nameBuffer[parentSize - 1] = '/'; // replaces null terminator
+		nameBuffer[parentSize] = '\0';
+		nameOffset = parentSize;
+	}
+	else
+	{
+		nameBuffer[0] = '\0';
+	}
+
+	struct wireMetaNames metaNames;
+	metaNames.alloc = 16;
+	metaNames.size = 0;
+	metaNames.names = elektraMalloc (metaNames.alloc * sizeof (const char *));
+
+	KeySet * ks = ksNewWithArena (0);
+
+	// length of the relative name of the previous key, i.e. the maximum shared prefix
+	size_t currentNameLen = 0;
+
+	bool success = true;
+	for (kdb_unsigned_long_long_t keysLeft = keyCount; success && keysLeft > 0; --keysLeft)
+	{
+		kdb_unsigned_long_long_t prefixLen = 0;
+		kdb_unsigned_long_long_t suffixLen = 0;
+		if (!readVarint (&reader, &prefixLen) || prefixLen > currentNameLen || !readVarint (&reader, &suffixLen) ||
+		    suffixLen > reader.size - reader.pos)
+		{
+			success = false;
+			break;
+		}
+
+		size_t newAlloc = nameAlloc;
+		while (newAlloc < nameOffset + prefixLen + suffixLen + 1)
+		{
+			newAlloc *= 2;
+		}
+		if (newAlloc != nameAlloc)
+		{
+			if (elektraRealloc ((void **) &nameBuffer, newAlloc) < 0)
+			{
+				success = false;
+				break;
+			}
+			nameAlloc = newAlloc;
+		}
+
+		memcpy (nameBuffer + nameOffset + prefixLen, reader.data + reader.pos, suffixLen);
+		nameBuffer[nameOffset + prefixLen + suffixLen] = '\0';
+		reader.pos += suffixLen;
+		currentNameLen = prefixLen + suffixLen;
+
+		kdb_octet_t type = 0;
+		if (!readByte (&reader, &type))
+		{
+			success = false;
+			break;
+		}
+
+		Key * k = NULL;
+		switch (type)
+		{
+		case 's': {
+			const char * value = readString (&reader);
+			if (value == NULL)
+			{
+				success = false;
+				break;
+			}
+			k = ksArenaKeyNew (ks, nameBuffer, value);
+			break;
+		}
+		case 'b': {
+			kdb_unsigned_long_long_t valueSize = 0;
+			if (!readVarint (&reader, &valueSize) || valueSize > reader.size - reader.pos)
+			{
+				success = false;
+				break;
+			}
+			k = ksArenaKeyNew (ks, nameBuffer, NULL);
+			if (k != NULL)
+			{
+				keySetBinary (k, valueSize == 0 ? NULL : reader.data + reader.pos, valueSize);
+			}
+			reader.pos += valueSize;
+			break;
+		}
+		default:
+			success = false;
+			break;
+		}
+
+		if (!success || k == NULL)
+		{
+			success = false;
+			break;
+		}
+
+		for (;;)
+		{
+			kdb_octet_t c = 0;
+			if (!readByte (&reader, &c) || (c != 0 && c != 'm'))
+			{
+				success = false;
+				break;
+			}
+			if (c == 0) break;
+
+			kdb_unsigned_long_long_t id = 0;
+			if (!readVarint (&reader, &id))
+			{
+				success = false;
+				break;
+			}
+
+			const char * metaName;
+			if (id == 0)
+			{
+				metaName = readString (&reader);
+				if (metaName == NULL || !appendWireMetaName (&metaNames, metaName))
+				{
+					success = false;
+					break;
+				}
+			}
+			else if (id <= metaNames.size)
+			{
+				metaName = metaNames.names[id - 1];
+			}
+			else
+			{
+				success = false;
+				break;
+			}
+
+			const char * value = readString (&reader);
+			if (value == NULL || keySetMeta (k, metaName, value) < 0)
+			{
+				success = false;
+				break;
+			}
+		}
+	}
+
+	elektraFree (metaNames.names);
+	elektraFree (nameBuffer);
+
+	if (!success)
+	{
+		ksDel (ks);
+		return NULL;
+	}
+
+	return ks;
+}
@@ -450,29 +450,106 @@ memoryerror:
 	return -1;
 }
 
-int elektraAugeasOpen (Plugin * handle, Key * parentKey)
+/* Pool of augeas handles with already compiled lenses, keyed by lens path.
+ *
+ * Compiling a lens is by far the most expensive part of using this plugin
+ * (several hundred ms for large lenses like httpd). libaugeas offers no way
+ * to serialize a compiled lens, so the compiled form can only be kept alive
+ * inside an augeas handle. Instead of closing the handle when a plugin
+ * instance is closed, it is parked here and the next instance using the same
+ * lens picks it up - with the lens already compiled. This turns repeated
+ * open/close cycles within one process (kdb tool internals, long-running
+ * users like elektrad) into a single compilation per lens. */
+#define AUGEAS_HANDLE_CACHE_SIZE 4
+
+struct CachedHandle
 {
-	augeas * augeasHandle;
-	augeasHandle = aug_init (NULL, NULL, AUG_NO_MODL_AUTOLOAD | AUG_NO_ERR_CLOSE);
-	int ret;
+	char * lensPath;
+	augeas * handle;
+};
 
-	if (aug_error (augeasHandle) != AUG_NOERROR)
+static struct CachedHandle cachedHandles[AUGEAS_HANDLE_CACHE_SIZE];
+
+static augeas * acquireCachedHandle (const char * lensPath)
+{
+	for (int i = 0; i < AUGEAS_HANDLE_CACHE_SIZE; i++)
 	{
-		char * errormessage;
-		ret = asprintf (&errormessage, "Unable to initialize augeas: %s", aug_error_message (augeasHandle));
+		if (cachedHandles[i].handle && strcmp (cachedHandles[i].lensPath, lensPath) == 0)
+		{
+			augeas * augeasHandle = cachedHandles[i].handle;
+			elektraFree (cachedHandles[i].lensPath);
+			cachedHandles[i].lensPath = NULL;
+			cachedHandles[i].handle = NULL;
+			return augeasHandle;
+		}
+	}
 
-		if (ret >= 0)
+	return NULL;
+}
+
+static void cacheHandle (const char * lensPath, augeas * augeasHandle)
+{
+	for (int i = 0; i < AUGEAS_HANDLE_CACHE_SIZE; i++)
+	{
+		if (!cachedHandles[i].handle)
 		{
-			ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey);
-			return -1;
+			cachedHandles[i].lensPath = elektraStrDup (lensPath);
+			cachedHandles[i].handle = augeasHandle;
+			return;
 		}
+	}
 
-		ELEKTRA_SET_INSTALLATION_ERROR (parentKey, errormessage);
-		elektraFree (errormessage);
-		return -1;
+	/* cache full */
+	aug_close (augeasHandle);
+}
+
+/**
+ * Returns the augeas handle of the plugin instance, initializing it on first use.
+ *
+ * Handles parked by previously closed instances with the same lens are reused,
+ * skipping both aug_init() and the lens compilation.
+ */
+static augeas * getAugeasHandle (Plugin * handle, Key * parentKey)
+{
+	augeas * augeasHandle = elektraPluginGetData (handle);
+	if (augeasHandle) return augeasHandle;
+
+	const char * lensPath = getLensPath (handle);
+	if (lensPath)
+	{
+		augeasHandle = acquireCachedHandle (lensPath);
+	}
+
+	if (!augeasHandle)
+	{
+		augeasHandle = aug_init (NULL, NULL, AUG_NO_MODL_AUTOLOAD | AUG_NO_ERR_CLOSE);
+
+		if (aug_error (augeasHandle) != AUG_NOERROR)
+		{
+			char * errormessage;
+			int ret = asprintf (&errormessage, "Unable to initialize augeas: %s", aug_error_message (augeasHandle));
+
+			if (ret < 0)
+			{
+				ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey);
+				return NULL;
+			}
+
+			ELEKTRA_SET_INSTALLATION_ERROR (parentKey, errormessage);
+			elektraFree (errormessage);
+			return NULL;
+		}
 	}
 
 	elektraPluginSetData (handle, augeasHandle);
+	return augeasHandle;
+}
+
+int elektraAugeasOpen (Plugin * handle ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+{
+	/* aug_init() and the lens compilation are deferred to the first get/set:
+	 * kdbOpen() opens every mounted backend, so an eager initialization made
+	 * every kdb invocation pay for augeas mounts it never touches */
 	return 0;
 }
 
@@ -482,7 +559,21 @@ int elektraAugeasClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 
 	if (augeasHandle)
 	{
-		aug_close (augeasHandle);
+		const char * lensPath = getLensPath (handle);
+
+		if (lensPath)
+		{
+			/* drop the instance state, but keep the compiled lens for the next instance */
+			aug_rm (augeasHandle, AUGEAS_TREE_ROOT);
+			aug_rm (augeasHandle, AUGEAS_CONTENT_ROOT);
+			aug_rm (augeasHandle, AUGEAS_OUTPUT_ROOT);
+			cacheHandle (lensPath, augeasHandle);
+		}
+		else
+		{
+			aug_close (augeasHandle);
+		}
+
 		elektraPluginSetData (handle, 0);
 	}
 
@@ -504,8 +595,6 @@ int elektraAugeasGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		return 1;
 	}
 
-	augeas * augeasHandle = elektraPluginGetData (handle);
-
 	/* retrieve the lens to use */
 	const char * lensPath = getLensPath (handle);
 	if (!lensPath)
@@ -514,6 +603,9 @@ int elektraAugeasGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	augeas * augeasHandle = getAugeasHandle (handle, parentKey);
+	if (!augeasHandle) return ELEKTRA_PLUGIN_STATUS_ERROR;
+
 	FILE * fh = fopen (keyString (parentKey), "r");
 
 	if (fh == 0)
@@ -590,7 +682,6 @@ int elektraAugeasGet (Plugin * handle, KeySet * returned, Key * parentKey)
 int elektraAugeasSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	int errnosave = errno;
-	augeas * augeasHandle = elektraPluginGetData (handle);
 
 	const char * lensPath = getLensPath (handle);
 
@@ -600,6 +691,9 @@ int elektraAugeasSet (Plugin * handle, KeySet * returned, Key * parentKey)
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	augeas * augeasHandle = getAugeasHandle (handle, parentKey);
+	if (!augeasHandle) return ELEKTRA_PLUGIN_STATUS_ERROR;
+
 	FILE * fh = fopen (keyValue (parentKey), "w+");
 
 	if (fh == 0)
@@ -6,6 +6,24 @@ static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuv
 #define ALPHABET_LENGTH (sizeof (alphabet) - 1)
 static const char padding = '=';
 
+/* maps a character back to its index in the alphabet; 0xFF marks characters
+ * that are not part of the Base64 alphabet */
+static const kdb_octet_t reverseAlphabet[256] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+	0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x1A, 0x1B, 0x1C,
+	0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30,
+	0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+};
+
 /**
  * @brief encodes arbitrary binary data using the Base64 encoding scheme (RFC4648)
  * @param input holds the data to be encoded
@@ -33,37 +51,36 @@ char * base64Encode (const kdb_octet_t * input, const size_t inputLength)
 	char * encoded = elektraMalloc (encodedLength);
 	if (!encoded) return NULL;
 
-	for (size_t i = 0; i < inputLength; i += 3)
+	// encode all complete 3-octet blocks, keeping the padded tail out of the loop
+	const size_t fullBlocks = inputLength - (inputLength % 3);
+	for (size_t i = 0; i < fullBlocks; i += 3)
+	{
+		encoded[out++] = alphabet[input[i] >> 2];
+		encoded[out++] = alphabet[((input[i] << 4) + (input[i + 1] >> 4)) & 0x3f];
+		encoded[out++] = alphabet[((input[i + 1] << 2) + (input[i + 2] >> 6)) & 0x3f];
+		encoded[out++] = alphabet[input[i + 2] & 0x3f];
+	}
+
+	if (inputLength > fullBlocks)
 	{
-		if (inputLength - i < 3)
+		// padding required
+		kdb_octet_t padded[3] = { 0 };
+		memcpy (padded, input + fullBlocks, inputLength - fullBlocks);
+
+		encoded[out++] = alphabet[padded[0] >> 2];
+		encoded[out++] = alphabet[((padded[0] << 4) + (padded[1] >> 4)) & 0x3f];
+
+		if (inputLength - fullBlocks == 2)
 		{
-			// padding required
-			kdb_octet_t padded[3] = { 0 };
-			memcpy (padded, input + i, inputLength - i);
-
-			encoded[out++] = alphabet[padded[0] >> 2];
-			encoded[out++] = alphabet[((padded[0] << 4) + (padded[1] >> 4)) & 0x3f];
-
-			if (inputLength - i == 2)
-			{
-				// 2 octets available in input
-				encoded[out++] = alphabet[((padded[1] << 2) + (padded[2] >> 6)) & 0x3f];
-				encoded[out++] = padding;
-			}
-			else
-			{
-				// 1 octet available in input
-				encoded[out++] = padding;
-				encoded[out++] = padding;
-			}
+			// 2 octets available in input
+			encoded[out++] = alphabet[((padded[1] << 2) + (padded[2] >> 6)) & 0x3f];
+			encoded[out++] = padding;
 		}
 		else
 		{
-			// no padding required
-			encoded[out++] = alphabet[input[i] >> 2];
-			encoded[out++] = alphabet[((input[i] << 4) + (input[i + 1] >> 4)) & 0x3f];
-			encoded[out++] = alphabet[((input[i + 1] << 2) + (input[i + 2] >> 6)) & 0x3f];
-			encoded[out++] = alphabet[input[i + 2] & 0x3f];
+			// 1 octet available in input
+			encoded[out++] = padding;
+			encoded[out++] = padding;
 		}
 	}
 	encoded[out++] = '\0';
@@ -80,12 +97,13 @@ static kdb_octet_t getBase64Index (const char character, int * errorFlag)
 {
 	if (character == padding) return 0;
 
-	for (kdb_octet_t i = 0; i < ALPHABET_LENGTH; i++)
+	const kdb_octet_t index = reverseAlphabet[(kdb_octet_t) character];
+	if (index == 0xFF)
 	{
-		if (alphabet[i] == character) return i;
+		*errorFlag = 1;
+		return 0;
 	}
-	*errorFlag = 1;
-	return 0;
+	return index;
 }
 
 /**
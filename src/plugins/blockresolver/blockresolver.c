@@ -154,6 +154,79 @@ int elektraBlockresolverClose (Plugin * handle ELEKTRA_UNUSED, Key * errorKey EL
 	return 1; // success
 }
 
+#define SIDECAR_POSTFIX ".blockresolver"
+
+static char * sidecarFilename (const char * realFile)
+{
+	char * name = elektraMalloc (strlen (realFile) + sizeof (SIDECAR_POSTFIX));
+	if (!name) return NULL;
+	strcpy (name, realFile);
+	strcat (name, SIDECAR_POSTFIX);
+	return name;
+}
+
+/* best-effort persistence of the last known block offsets, so later invocations can skip the full scan */
+static void storeBlockOffsets (const char * realFile, const char * identifier, time_t mtime, long startPos, long endPos)
+{
+	char * sidecar = sidecarFilename (realFile);
+	if (!sidecar) return;
+	FILE * fp = fopen (sidecar, "w");
+	if (fp)
+	{
+		fprintf (fp, "%ld %ld %ld\n%s\n", (long) mtime, startPos, endPos, identifier);
+		fclose (fp);
+	}
+	elektraFree (sidecar);
+}
+
+/* offsets cached in the sidecar are only trusted when mtime and identifier still match */
+static int loadBlockOffsets (const char * realFile, const char * identifier, time_t mtime, long * startPos, long * endPos)
+{
+	int found = 0;
+	char * sidecar = sidecarFilename (realFile);
+	if (!sidecar) return 0;
+	FILE * fp = fopen (sidecar, "r");
+	if (fp)
+	{
+		long cachedMtime = 0;
+		long start = -1;
+		long end = -1;
+		char buffer[BUFSIZE_MAX];
+		if (fscanf (fp, "%ld %ld %ld\n", &cachedMtime, &start, &end) == 3 && fgets (buffer, sizeof (buffer), fp))
+		{
+			size_t length = strlen (buffer);
+			if (length > 0 && buffer[length - 1] == '\n') buffer[length - 1] = '\0';
+			if (cachedMtime == (long) mtime && !strcmp (buffer, identifier) && start >= 0 && end >= start)
+			{
+				*startPos = start;
+				*endPos = end;
+				found = 1;
+			}
+		}
+		fclose (fp);
+	}
+	elektraFree (sidecar);
+	return found;
+}
+
+/* bounded reread around the cached offsets: both marker lines have to be exactly where the sidecar says */
+static int verifyBlockOffsets (FILE * fp, const char * identifier, long startPos, long endPos)
+{
+	char buffer[BUFSIZE_MAX];
+	size_t idLen = strlen (identifier);
+	size_t startLineLen = idLen + 1 + strlen ("start\n");
+	size_t stopLineLen = idLen + 1 + strlen ("stop\n");
+	if (startLineLen > sizeof (buffer)) return 0;
+	if (startPos < (long) startLineLen) return 0;
+	if (fseek (fp, startPos - (long) startLineLen, SEEK_SET)) return 0;
+	if (fread (buffer, 1, startLineLen, fp) != startLineLen) return 0;
+	if (strncmp (buffer, identifier, idLen) || strncmp (buffer + idLen + 1, "start\n", strlen ("start\n"))) return 0;
+	if (fseek (fp, endPos, SEEK_SET)) return 0;
+	if (fread (buffer, 1, stopLineLen, fp) != stopLineLen) return 0;
+	if (strncmp (buffer, identifier, idLen) || strncmp (buffer + idLen + 1, "stop\n", strlen ("stop\n"))) return 0;
+	return 1;
+}
+
 static long getBlockStart (FILE * fp, const char * identifier)
 {
 	long position = -1;
@@ -250,6 +323,7 @@ int elektraBlockresolverGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned E
 	FILE * fin = NULL;
 	FILE * fout = NULL;
 	char * block = NULL;
+	time_t currentMtime = data->mtime;
 
 	if (data->getPass > 0)
 	{
@@ -260,6 +334,7 @@ int elektraBlockresolverGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned E
 			return -1;
 		}
 		if (buf.st_mtime == data->mtime) return 0;
+		currentMtime = buf.st_mtime;
 	}
 
 	fin = fopen (data->realFile, "r");
@@ -269,14 +344,26 @@ int elektraBlockresolverGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned E
 		goto GET_CLEANUP;
 	}
 
-	data->startPos = getBlockStart (fin, data->identifier);
-	if (data->startPos == -1) goto GET_CLEANUP;
-	data->endPos = getBlockEnd (fin, data->identifier, data->startPos);
-	if (data->endPos == -1)
+	long cachedStart = -1;
+	long cachedEnd = -1;
+	if (loadBlockOffsets (data->realFile, data->identifier, currentMtime, &cachedStart, &cachedEnd) &&
+	    verifyBlockOffsets (fin, data->identifier, cachedStart, cachedEnd))
 	{
-		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Couldn't find end of block %s", data->identifier);
-		retVal = -1;
-		goto GET_CLEANUP;
+		data->startPos = cachedStart;
+		data->endPos = cachedEnd;
+	}
+	else
+	{
+		data->startPos = getBlockStart (fin, data->identifier);
+		if (data->startPos == -1) goto GET_CLEANUP;
+		data->endPos = getBlockEnd (fin, data->identifier, data->startPos);
+		if (data->endPos == -1)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Couldn't find end of block %s", data->identifier);
+			retVal = -1;
+			goto GET_CLEANUP;
+		}
+		storeBlockOffsets (data->realFile, data->identifier, currentMtime, data->startPos, data->endPos);
 	}
 	block = (char *) getBlock (fin, data->startPos, data->endPos);
 	if (!block)
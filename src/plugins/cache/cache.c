@@ -21,20 +21,25 @@
 #include <kdbmodule.h>
 #include <kdbprivate.h>
 
-#include <fcntl.h>     // access()
+#include <errno.h>
+#include <fcntl.h>     // access(), shm_open()
 #include <ftw.h>       // nftw()
+#include <inttypes.h>  // PRIu64
 #include <stdint.h>    // nftw()
 #include <stdio.h>     // rename(), sprintf()
 #include <stdlib.h>    // nftw(), getenv()
 #include <string.h>    // nftw()
+#include <sys/mman.h>  // shm_open(), mmap()
 #include <sys/stat.h>  // elektraMkdirParents
 #include <sys/time.h>  // gettimeofday()
 #include <sys/types.h> // elektraMkdirParents
 #include <unistd.h>    // access()
 
 #define KDB_CACHE_STORAGE "mmapstorage"
+#define KDB_CACHE_STATS_FILE "stats"
 #define POSTFIX_SIZE 50
 #define MAX_FD_USED 32
+#define SHM_NAME_SIZE 64
 
 typedef enum
 {
@@ -50,6 +55,11 @@ struct _cacheHandle
 	Key * cachePath;
 	Plugin * resolver;
 	Plugin * cacheStorage;
+	uint64_t * shmGeneration; /**< shared generation counter, NULL if the shm tier is disabled */
+	long long budget;	  /**< cache size budget in bytes, 0 disables eviction */
+	uint64_t hits;		  /**< cache hits of this handle, persisted on close */
+	uint64_t misses;	  /**< cache misses of this handle, persisted on close */
+	uint64_t evictions;	  /**< cache files evicted by this handle, persisted on close */
 };
 
 static char * elektraStrConcat (const char * a, const char * b)
@@ -237,6 +247,53 @@ static char * kdbCacheFileName (CacheHandle * ch, Key * parentKey, PathMode mode
 	return cacheFileName;
 }
 
+/**
+ * @internal
+ * Attaches the per-user shared-memory generation counter.
+ *
+ * The counter is bumped on every cache write. A reader whose cache file
+ * recorded the current generation can skip the per-backend resolver
+ * round-trip entirely, see system:/elektra/cache/shm/uptodate.
+ *
+ * Only enabled when the plugin config contains the key /shm, because
+ * modifications bypassing Elektra are not detected while the counter
+ * matches.
+ *
+ * @param handle the plugin handle
+ * @param ch the cache handle to attach the counter to
+ */
+static void attachShmGeneration (Plugin * handle, CacheHandle * ch)
+{
+	ch->shmGeneration = NULL;
+	KeySet * config = elektraPluginGetConfig (handle);
+	if (!ksLookupByName (config, "/shm", 0)) return;
+
+	char shmName[SHM_NAME_SIZE];
+	snprintf (shmName, sizeof (shmName), "/elektra-cache-%ld", (long) getuid ());
+
+	int fd = shm_open (shmName, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+	if (fd == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not open shm segment %s: %s", shmName, strerror (errno));
+		return;
+	}
+	if (ftruncate (fd, sizeof (uint64_t)) == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not resize shm segment %s: %s", shmName, strerror (errno));
+		close (fd);
+		return;
+	}
+
+	void * mem = mmap (0, sizeof (uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close (fd);
+	if (mem == MAP_FAILED)
+	{
+		ELEKTRA_LOG_WARNING ("could not map shm segment %s: %s", shmName, strerror (errno));
+		return;
+	}
+	ch->shmGeneration = mem;
+}
+
 static int unlinkCacheFiles (const char * fpath, const struct stat * sb ELEKTRA_UNUSED, int tflag ELEKTRA_UNUSED,
 			     struct FTW * ftwbuf ELEKTRA_UNUSED)
 {
@@ -245,6 +302,140 @@ static int unlinkCacheFiles (const char * fpath, const struct stat * sb ELEKTRA_
 	return 0;
 }
 
+/**
+ * @internal
+ * Reads the persisted hit/miss/eviction counters from the stats file.
+ *
+ * All counters are set to 0 if the file is missing or malformed.
+ */
+static void loadStats (const char * statsName, uint64_t * hits, uint64_t * misses, uint64_t * evictions)
+{
+	*hits = 0;
+	*misses = 0;
+	*evictions = 0;
+	FILE * f = fopen (statsName, "r");
+	if (f == NULL) return;
+	if (fscanf (f, "hits %" SCNu64 " misses %" SCNu64 " evictions %" SCNu64, hits, misses, evictions) != 3)
+	{
+		*hits = 0;
+		*misses = 0;
+		*evictions = 0;
+	}
+	fclose (f);
+}
+
+/**
+ * @internal
+ * Adds the counters of this handle to the stats file in the cache directory.
+ *
+ * Called once on close, so the cost is a single small write per process.
+ * The file is replaced via a temp file, concurrent writers lose at most
+ * one process worth of counters.
+ */
+static void persistStats (CacheHandle * ch)
+{
+	if (ch->hits == 0 && ch->misses == 0 && ch->evictions == 0) return;
+
+	char * statsName = elektraStrConcat (keyString (ch->cachePath), "/" KDB_CACHE_STATS_FILE);
+	uint64_t hits = 0;
+	uint64_t misses = 0;
+	uint64_t evictions = 0;
+	loadStats (statsName, &hits, &misses, &evictions);
+
+	char * tmpFile = elektraGenTempFilename (statsName);
+	FILE * f = fopen (tmpFile, "w");
+	if (f != NULL)
+	{
+		fprintf (f, "hits %" PRIu64 " misses %" PRIu64 " evictions %" PRIu64 "\n", hits + ch->hits, misses + ch->misses,
+			 evictions + ch->evictions);
+		fclose (f);
+		if (rename (tmpFile, statsName) == -1) unlink (tmpFile);
+	}
+	elektraFree (tmpFile);
+	elektraFree (statsName);
+}
+
+typedef struct
+{
+	char * name;
+	time_t used;
+	off_t size;
+} CacheFile;
+
+static CacheFile * evictionFiles;
+static size_t evictionCount;
+static size_t evictionAlloc;
+static off_t evictionTotal;
+
+static int collectCacheFiles (const char * fpath, const struct stat * sb, int tflag, struct FTW * ftwbuf ELEKTRA_UNUSED)
+{
+	if (tflag != FTW_F) return 0;
+	size_t len = strlen (fpath);
+	if (len < 5 || elektraStrCmp (fpath + len - 5, ".mmap") != 0) return 0; // only generated cache files
+
+	if (evictionCount == evictionAlloc)
+	{
+		evictionAlloc *= 2;
+		elektraRealloc ((void **) &evictionFiles, evictionAlloc * sizeof (CacheFile));
+	}
+	evictionFiles[evictionCount].name = elektraStrDup (fpath);
+	// take the newer of access and modification time as recency, atime alone is unreliable on relatime mounts
+	evictionFiles[evictionCount].used = sb->st_atime > sb->st_mtime ? sb->st_atime : sb->st_mtime;
+	evictionFiles[evictionCount].size = sb->st_size;
+	++evictionCount;
+	evictionTotal += sb->st_size;
+	return 0;
+}
+
+static int compareCacheFiles (const void * a, const void * b)
+{
+	const CacheFile * fa = a;
+	const CacheFile * fb = b;
+	if (fa->used != fb->used) return fa->used < fb->used ? -1 : 1;
+	return elektraStrCmp (fa->name, fb->name);
+}
+
+/**
+ * @internal
+ * Removes the least recently used cache files until the cache directory
+ * fits into the configured size budget again.
+ *
+ * Called after every cache write. The file written last has the newest
+ * modification time and is therefore evicted last.
+ */
+static void evictCacheFiles (CacheHandle * ch)
+{
+	if (ch->budget <= 0) return;
+
+	evictionCount = 0;
+	evictionAlloc = 8;
+	evictionTotal = 0;
+	evictionFiles = elektraMalloc (evictionAlloc * sizeof (CacheFile));
+
+	nftw (keyString (ch->cachePath), collectCacheFiles, MAX_FD_USED, 0);
+
+	if (evictionTotal > ch->budget)
+	{
+		qsort (evictionFiles, evictionCount, sizeof (CacheFile), compareCacheFiles);
+		for (size_t i = 0; i < evictionCount && evictionTotal > ch->budget; ++i)
+		{
+			ELEKTRA_LOG_DEBUG ("EVICTING cache file: %s", evictionFiles[i].name);
+			if (remove (evictionFiles[i].name) == 0)
+			{
+				evictionTotal -= evictionFiles[i].size;
+				++ch->evictions;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < evictionCount; ++i)
+	{
+		elektraFree (evictionFiles[i].name);
+	}
+	elektraFree (evictionFiles);
+	evictionFiles = NULL;
+}
+
 int elektraCacheOpen (Plugin * handle, Key * errorKey)
 {
 	// plugin initialization logic
@@ -257,6 +448,14 @@ int elektraCacheOpen (Plugin * handle, Key * errorKey)
 
 	if (resolveCacheDirectory (handle, ch, errorKey) == -1) return ELEKTRA_PLUGIN_STATUS_ERROR;
 	if (loadCacheStoragePlugin (handle, ch, errorKey) == -1) return ELEKTRA_PLUGIN_STATUS_ERROR;
+	attachShmGeneration (handle, ch);
+
+	// size budget for LRU eviction, configured in MiB
+	Key * budget = ksLookupByName (elektraPluginGetConfig (handle), "/budget", 0);
+	ch->budget = budget == NULL ? 0 : strtoll (keyString (budget), NULL, 10) * 1024 * 1024;
+	ch->hits = 0;
+	ch->misses = 0;
+	ch->evictions = 0;
 
 	elektraPluginSetData (handle, ch);
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
@@ -269,6 +468,8 @@ int elektraCacheClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 	CacheHandle * ch = elektraPluginGetData (handle);
 	if (ch)
 	{
+		persistStats (ch);
+		if (ch->shmGeneration) munmap (ch->shmGeneration, sizeof (uint64_t));
 		elektraPluginClose (ch->resolver, 0);
 		elektraPluginClose (ch->cacheStorage, 0);
 
@@ -322,6 +523,26 @@ int elektraCacheGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * pa
 		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 	}
 
+	if (!elektraStrCmp (keyString (keyGetMeta (parentKey, "cache/stats")), "1"))
+	{
+		// report the persisted statistics instead of fetching a cache file
+		char * statsName = elektraStrConcat (keyString (ch->cachePath), "/" KDB_CACHE_STATS_FILE);
+		uint64_t hits = 0;
+		uint64_t misses = 0;
+		uint64_t evictions = 0;
+		loadStats (statsName, &hits, &misses, &evictions);
+		elektraFree (statsName);
+
+		char buf[MAX_LEN_INT];
+		snprintf (buf, sizeof (buf), "%" PRIu64, hits + ch->hits);
+		ksAppendKey (returned, keyNew ("system:/elektra/cache/stats/hits", KEY_VALUE, buf, KEY_END));
+		snprintf (buf, sizeof (buf), "%" PRIu64, misses + ch->misses);
+		ksAppendKey (returned, keyNew ("system:/elektra/cache/stats/misses", KEY_VALUE, buf, KEY_END));
+		snprintf (buf, sizeof (buf), "%" PRIu64, evictions + ch->evictions);
+		ksAppendKey (returned, keyNew ("system:/elektra/cache/stats/evictions", KEY_VALUE, buf, KEY_END));
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+
 	// construct cache file name from parentKey (which stores the mountpoint from mountGetMountpoint)
 	Key * cacheFile = keyDup (parentKey, KEY_CP_ALL);
 	char * cacheFileName = kdbCacheFileName (ch, cacheFile, modeFile);
@@ -330,6 +551,20 @@ int elektraCacheGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * pa
 
 	// load cache from storage
 	keySetString (cacheFile, cacheFileName);
+
+#ifdef POSIX_FADV_WILLNEED
+	/* mmapstorage pages the whole cache file in during deserialization
+	 * (header, dynarray and keyset region), so one sequential readahead of
+	 * the full footprint replaces the major faults of demand paging it in
+	 * 4 KiB at a time on a cold start. Purely advisory, the readahead
+	 * outlives the descriptor. */
+	int prefetchFd = open (cacheFileName, O_RDONLY);
+	if (prefetchFd != -1)
+	{
+		posix_fadvise (prefetchFd, 0, 0, POSIX_FADV_WILLNEED);
+		close (prefetchFd);
+	}
+#endif
 	elektraFree (cacheFileName);
 
 	// not the whole global keyset is cached
@@ -364,10 +599,25 @@ int elektraCacheGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * pa
 
 	if (result == ELEKTRA_PLUGIN_STATUS_SUCCESS)
 	{
+		++ch->hits;
+		if (ch->shmGeneration && global)
+		{
+			// cache file written at the current generation
+			// -> no Elektra write happened since, the core may
+			// skip the per-backend up-to-date checks
+			Key * gen = ksLookupByName (global, KDB_CACHE_PREFIX "/generation", 0);
+			char buf[MAX_LEN_INT];
+			snprintf (buf, sizeof (buf), "%" PRIu64, __atomic_load_n (ch->shmGeneration, __ATOMIC_RELAXED));
+			if (gen && elektraStrCmp (keyString (gen), buf) == 0)
+			{
+				ksAppendKey (global, keyNew (KDB_CACHE_PREFIX "/shm/uptodate", KEY_END));
+			}
+		}
 		keyDel (cacheFile);
 		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 	}
 
+	++ch->misses;
 	keyDel (cacheFile); // TODO: maybe propagate errors?
 	return ELEKTRA_PLUGIN_STATUS_ERROR;
 }
@@ -406,6 +656,14 @@ int elektraCacheSet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 	KeySet * global = ch->cacheStorage->global;
 
+	if (ch->shmGeneration)
+	{
+		uint64_t next = __atomic_add_fetch (ch->shmGeneration, 1, __ATOMIC_RELAXED);
+		char buf[MAX_LEN_INT];
+		snprintf (buf, sizeof (buf), "%" PRIu64, next);
+		ksAppendKey (global, keyNew (KDB_CACHE_PREFIX "/generation", KEY_VALUE, buf, KEY_END));
+	}
+
 	ch->cacheStorage->global = ksCut (global, cacheCutpoint);
 
 	KeySet * cut = ksCut (global, cachedCutpoint);
@@ -431,6 +689,8 @@ int elektraCacheSet (Plugin * handle, KeySet * returned, Key * parentKey)
 			goto error;
 		}
 
+		evictCacheFiles (ch);
+
 		elektraFree (cacheFileName);
 		elektraFree (tmpFile);
 		keyDel (cacheFile);
@@ -95,24 +95,32 @@ void Coder::readConfig (CppKeySet const & config, CppKey const & root)
  */
 string Coder::encodeString (string const & text)
 {
-	vector<unsigned char> encoded;
+	string encoded;
 	encoded.reserve (text.size ());
 
-	for (unsigned char character : text)
+	auto character = text.begin ();
+	auto end = text.end ();
+
+	while (character != end)
 	{
-		const auto & encodedChar = encode[character];
-		if (encodedChar == '\0')
+		/* append the span of characters that need no escaping in one go */
+		auto stop = character;
+		while (stop != end && encode[static_cast<unsigned char> (*stop)] == '\0')
 		{
-			encoded.push_back (character);
+			++stop;
 		}
-		else
+		encoded.append (character, stop);
+		character = stop;
+
+		if (character != end)
 		{
 			encoded.push_back (escapeCharacter);
-			encoded.push_back (encodedChar);
+			encoded.push_back (encode[static_cast<unsigned char> (*character)]);
+			++character;
 		}
 	}
 
-	return { encoded.begin (), encoded.end () };
+	return encoded;
 }
 
 /**
@@ -124,26 +132,26 @@ string Coder::encodeString (string const & text)
  */
 string Coder::decodeString (string const & text)
 {
-	vector<char> decoded;
-	decoded.reserve (text.size () / 2); // minimum required size, if everything is escaped
+	string decoded;
+	decoded.reserve (text.size ());
 
-	auto character = text.begin ();
+	size_t position = 0;
 
-	while (character != text.end ())
+	while (position < text.size ())
 	{
-		if (*character == escapeCharacter)
-		{
-			++character;
-			decoded.push_back (decode[*character]);
-		}
-		else
+		/* append the span up to the next escape sequence in one go */
+		size_t escape = text.find (static_cast<char> (escapeCharacter), position);
+		if (escape == string::npos)
 		{
-			decoded.push_back (*character);
+			decoded.append (text, position, string::npos);
+			break;
 		}
-		++character;
+		decoded.append (text, position, escape - position);
+		decoded.push_back (decode[static_cast<unsigned char> (text[escape + 1])]);
+		position = escape + 2;
 	}
 
-	return { decoded.begin (), decoded.end () };
+	return decoded;
 }
 
 /**
@@ -58,6 +58,52 @@ typedef enum
 	NOEXPR = -3,
 } CondResult;
 
+/**
+ * The fixed regexes used to split condition strings. They were compiled
+ * again for every evaluated key, which dominated the cost of validating
+ * keysets where the spec attaches conditions to many keys; now they are
+ * compiled once per get/set pass and passed down.
+ */
+typedef struct
+{
+	regex_t innerCondition; ///< innermost parenthesized group
+	regex_t ifClause;
+	regex_t thenClause;
+	regex_t elseClause;
+} CondRegexes;
+
+static int compileCondRegexes (CondRegexes * rx)
+{
+	if (regcomp (&rx->innerCondition, "((\\(([^\\(\\)]*)\\)))", REG_EXTENDED | REG_NEWLINE)) return -1;
+	if (regcomp (&rx->ifClause, "(\\(((.*)?)\\))[[:space:]]*\\?", REGEX_FLAGS_CONDITION))
+	{
+		regfree (&rx->innerCondition);
+		return -1;
+	}
+	if (regcomp (&rx->thenClause, "\\?[[:space:]]*(\\(((.*)?)\\))", REGEX_FLAGS_CONDITION))
+	{
+		regfree (&rx->innerCondition);
+		regfree (&rx->ifClause);
+		return -1;
+	}
+	if (regcomp (&rx->elseClause, "[[:space:]]*:[[:space:]]*(\\(((.*)?)\\))", REGEX_FLAGS_CONDITION))
+	{
+		regfree (&rx->innerCondition);
+		regfree (&rx->ifClause);
+		regfree (&rx->thenClause);
+		return -1;
+	}
+	return 0;
+}
+
+static void freeCondRegexes (CondRegexes * rx)
+{
+	regfree (&rx->innerCondition);
+	regfree (&rx->ifClause);
+	regfree (&rx->thenClause);
+	regfree (&rx->elseClause);
+}
+
 static int isValidSuffix (char * suffix, const Key * suffixList)
 {
 	if (!suffixList) return 0;
@@ -554,20 +600,11 @@ static const char * isAssign (Key * key, char * expr, Key * parentKey, KeySet *
 	}
 }
 
-static CondResult parseCondition (Key * key, const char * condition, const Key * suffixList, KeySet * ks, Key * parentKey)
+static CondResult parseCondition (Key * key, const char * condition, const Key * suffixList, KeySet * ks, Key * parentKey,
+				  const CondRegexes * rx)
 {
 	CondResult result = FALSE;
-	const char * regexString = "((\\(([^\\(\\)]*)\\)))";
-	regex_t regex;
-
-	if ((regcomp (&regex, regexString, REG_EXTENDED | REG_NEWLINE)))
-	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		ksDel (ks);
-		return ERROR;
-	}
+	const regex_t * regex = &rx->innerCondition;
 
 	char * localCondition = elektraStrDup (condition);
 	size_t subMatches = 4;
@@ -575,7 +612,7 @@ static CondResult parseCondition (Key * key, const char * condition, const Key *
 	char * ptr = localCondition;
 	while (1)
 	{
-		int nomatch = regexec (&regex, ptr, subMatches, m, 0);
+		int nomatch = regexec (regex, ptr, subMatches, m, 0);
 		if (nomatch)
 		{
 			break;
@@ -601,56 +638,22 @@ static CondResult parseCondition (Key * key, const char * condition, const Key *
 		elektraFree (singleCondition);
 	}
 	elektraFree (localCondition);
-	regfree (&regex);
 	return result;
 }
 
 
-static CondResult parseConditionString (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op)
+static CondResult parseConditionString (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op,
+					const CondRegexes * rx)
 {
 	const char * conditionString = keyString (meta);
-	const char * regexString1 = "(\\(((.*)?)\\))[[:space:]]*\\?";
-	const char * regexString2 = "\\?[[:space:]]*(\\(((.*)?)\\))";
-	const char * regexString3 = "[[:space:]]*:[[:space:]]*(\\(((.*)?)\\))";
-	regex_t regex1, regex2, regex3;
 	CondResult ret;
-	if ((ret = regcomp (&regex1, regexString1, REGEX_FLAGS_CONDITION)))
-	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		ksDel (ks);
-		return ERROR;
-	}
-	if ((ret = regcomp (&regex2, regexString2, REGEX_FLAGS_CONDITION)))
-	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		regfree (&regex1);
-		ksDel (ks);
-		return ERROR;
-	}
-	if ((ret = regcomp (&regex3, regexString3, REGEX_FLAGS_CONDITION)))
-	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		regfree (&regex1);
-		regfree (&regex2);
-		ksDel (ks);
-		return ERROR;
-	}
 	size_t subMatches = 6;
 	regmatch_t m[subMatches];
-	int nomatch = regexec (&regex1, conditionString, subMatches, m, 0);
+	int nomatch = regexec (&rx->ifClause, conditionString, subMatches, m, 0);
 	if (nomatch)
 	{
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
 		ksDel (ks);
 		return ERROR;
 	}
@@ -658,9 +661,6 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 	{
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
 		ksDel (ks);
 		return ERROR;
 	}
@@ -671,14 +671,12 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 	char * elseexpr = NULL;
 	strncpy (condition, conditionString + startPos, (size_t) (endPos - startPos));
 	condition[endPos - startPos] = '\0';
-	nomatch = regexec (&regex2, conditionString, subMatches, m, 0);
+	nomatch = regexec (&rx->thenClause, conditionString, subMatches, m, 0);
 	if (nomatch)
 	{
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
+		elektraFree (condition);
 		ksDel (ks);
 		return ERROR;
 	}
@@ -686,9 +684,7 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 	{
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 			parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information", conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
+		elektraFree (condition);
 		ksDel (ks);
 		return ERROR;
 	}
@@ -699,7 +695,7 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 	strncpy (thenexpr, conditionString + startPos, (size_t) (endPos - startPos));
 	thenexpr[endPos - startPos] = '\0';
 
-	nomatch = regexec (&regex3, conditionString, subMatches, m, 0);
+	nomatch = regexec (&rx->elseClause, conditionString, subMatches, m, 0);
 	if (!nomatch)
 	{
 		if (m[1].rm_so == -1)
@@ -707,9 +703,8 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 				parentKey, "Invalid syntax: '%s'. Check kdb plugin-info conditionals for additional information",
 				conditionString);
-			regfree (&regex1);
-			regfree (&regex2);
-			regfree (&regex3);
+			elektraFree (condition);
+			elektraFree (thenexpr);
 			ksDel (ks);
 			return ERROR;
 		}
@@ -721,7 +716,7 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 		elseexpr[endPos - startPos] = '\0';
 	}
 
-	ret = parseCondition (key, condition, suffixList, ks, parentKey);
+	ret = parseCondition (key, condition, suffixList, ks, parentKey, rx);
 	if (ret == TRUE)
 	{
 		if (op == ASSIGN)
@@ -741,7 +736,7 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 		}
 		else
 		{
-			ret = parseCondition (key, thenexpr, suffixList, ks, parentKey);
+			ret = parseCondition (key, thenexpr, suffixList, ks, parentKey, rx);
 			if (ret == FALSE)
 			{
 				ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Validation of Key %s: %s failed. (%s failed)",
@@ -777,7 +772,7 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 			}
 			else
 			{
-				ret = parseCondition (key, elseexpr, suffixList, ks, parentKey);
+				ret = parseCondition (key, elseexpr, suffixList, ks, parentKey, rx);
 
 				if (ret == FALSE)
 				{
@@ -809,17 +804,15 @@ CleanUp:
 	elektraFree (condition);
 	elektraFree (thenexpr);
 	if (elseexpr) elektraFree (elseexpr);
-	regfree (&regex1);
-	regfree (&regex2);
-	regfree (&regex3);
 	ksDel (ks);
 	return ret;
 }
 
-static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op)
+static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op,
+			       const CondRegexes * rx)
 {
 	CondResult result;
-	result = parseConditionString (meta, suffixList, parentKey, key, ksDup (ks), op);
+	result = parseConditionString (meta, suffixList, parentKey, key, ksDup (ks), op, rx);
 	if (result == ERROR)
 	{
 		return ERROR;
@@ -839,7 +832,8 @@ static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * p
 	return TRUE;
 }
 
-static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key * suffixList, Key * parentKey, KeySet * returned)
+static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key * suffixList, Key * parentKey, KeySet * returned,
+					  const CondRegexes * rx)
 {
 	int countSucceeded = 0;
 	int countFailed = 0;
@@ -850,7 +844,7 @@ static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key
 	while ((c = ksNext (condKS)) != NULL)
 	{
 		if (!keyCmp (c, meta)) continue;
-		result = evaluateKey (c, suffixList, parentKey, key, returned, CONDITION);
+		result = evaluateKey (c, suffixList, parentKey, key, returned, CONDITION, rx);
 		if (result == TRUE)
 			++countSucceeded;
 		else if (result == ERROR)
@@ -903,6 +897,14 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		return 1; /* success */
 	}
 	Key * cur;
+	CondRegexes rx;
+	if (compileCondRegexes (&rx) != 0)
+	{
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regexes compile so the only
+		// possible error would be out of
+		// memory
+		return -1;
+	}
 	ksRewind (returned);
 	CondResult ret = FALSE;
 	while ((cur = ksNext (returned)) != NULL)
@@ -918,7 +920,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		{
 			CondResult result;
 
-			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
+			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION, &rx);
 			if (result == NOEXPR)
 			{
 				ret |= TRUE;
@@ -931,19 +933,19 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		else if (allConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned, &rx);
 			ret |= result;
 		}
 		else if (anyConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned, &rx);
 			ret |= result;
 		}
 		else if (noneConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned, &rx);
 			ret |= result;
 		}
 
@@ -956,7 +958,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 				while ((a = ksNext (assignKS)) != NULL)
 				{
 					if (keyCmp (a, assignMeta) == 0) continue;
-					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN);
+					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN, &rx);
 					if (result == TRUE)
 					{
 						ret |= TRUE;
@@ -975,10 +977,11 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 			}
 			else
 			{
-				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
+				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN, &rx);
 			}
 		}
 	}
+	freeCondRegexes (&rx);
 	if (ret == TRUE) keySetMeta (parentKey, "error", 0);
 	return ret; /* success */
 }
@@ -987,6 +990,14 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
 {
 	Key * cur;
+	CondRegexes rx;
+	if (compileCondRegexes (&rx) != 0)
+	{
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey); // the regexes compile so the only
+		// possible error would be out of
+		// memory
+		return -1;
+	}
 	ksRewind (returned);
 	CondResult ret = FALSE;
 	while ((cur = ksNext (returned)) != NULL)
@@ -1002,7 +1013,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		{
 			CondResult result;
 
-			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
+			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION, &rx);
 			if (result == NOEXPR)
 			{
 				ret |= TRUE;
@@ -1015,19 +1026,19 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		else if (allConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned, &rx);
 			ret |= result;
 		}
 		else if (anyConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned, &rx);
 			ret |= result;
 		}
 		else if (noneConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned, &rx);
 			ret |= result;
 		}
 
@@ -1040,7 +1051,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 				while ((a = ksNext (assignKS)) != NULL)
 				{
 					if (keyCmp (a, assignMeta) == 0) continue;
-					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN);
+					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN, &rx);
 					if (result == TRUE)
 					{
 						ret |= TRUE;
@@ -1059,10 +1070,11 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 			}
 			else
 			{
-				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
+				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN, &rx);
 			}
 		}
 	}
+	freeCondRegexes (&rx);
 	if (ret == TRUE) keySetMeta (parentKey, "error", 0);
 	return ret;
 }
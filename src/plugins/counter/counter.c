@@ -10,6 +10,8 @@
 #include "kdbconfig.h"
 #endif
 
+#include <inttypes.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -18,6 +20,153 @@
 typedef int Counter;
 #define COUNTER_FMT "%d"
 
+/**
+ * Process wide operation statistics.
+ *
+ * Writers serialize on the mutex and bump the sequence to odd before
+ * and even after the update. Readers never take the mutex: they copy
+ * the table and retry when the sequence was odd or changed meanwhile
+ * (seqlock), so exporting the statistics never blocks the hot path.
+ */
+static struct
+{
+	uint64_t sequence;
+	ElektraMountStats mounts[ELEKTRA_STATS_MAX_MOUNTS];
+	size_t mountCount;
+} stats;
+
+static pthread_mutex_t statsLock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef enum
+{
+	OPERATION_GET,
+	OPERATION_SET,
+	OPERATION_ERROR
+} Operation;
+
+/**
+ * Record one operation for the mountpoint of @p parentKey.
+ */
+static void recordOperation (Operation operation, const Key * parentKey, size_t keys)
+{
+	const char * mountpoint = keyName (parentKey);
+
+	pthread_mutex_lock (&statsLock);
+
+	ElektraMountStats * entry = NULL;
+	for (size_t i = 0; i < stats.mountCount; i++)
+	{
+		if (strcmp (stats.mounts[i].mountpoint, mountpoint) == 0)
+		{
+			entry = &stats.mounts[i];
+			break;
+		}
+	}
+	if (!entry)
+	{
+		if (stats.mountCount == ELEKTRA_STATS_MAX_MOUNTS || strlen (mountpoint) >= sizeof (entry->mountpoint))
+		{
+			pthread_mutex_unlock (&statsLock);
+			return;
+		}
+		entry = &stats.mounts[stats.mountCount];
+		strcpy (entry->mountpoint, mountpoint);
+	}
+
+	__atomic_store_n (&stats.sequence, stats.sequence + 1, __ATOMIC_RELEASE);
+
+	switch (operation)
+	{
+	case OPERATION_GET:
+		entry->getCalls++;
+		entry->lastGetKeys = keys;
+		break;
+	case OPERATION_SET:
+		entry->setCalls++;
+		entry->lastSetKeys = keys;
+		break;
+	case OPERATION_ERROR:
+		entry->errorCalls++;
+		break;
+	}
+	if (entry == &stats.mounts[stats.mountCount]) stats.mountCount++;
+
+	__atomic_store_n (&stats.sequence, stats.sequence + 1, __ATOMIC_RELEASE);
+
+	pthread_mutex_unlock (&statsLock);
+}
+
+/**
+ * Take a consistent snapshot of the statistics without locking.
+ */
+static size_t snapshotStats (ElektraMountStats * mounts)
+{
+	uint64_t before;
+	uint64_t after;
+	size_t count;
+
+	do
+	{
+		before = __atomic_load_n (&stats.sequence, __ATOMIC_ACQUIRE);
+		if (before % 2 != 0) continue;
+		count = stats.mountCount;
+		memcpy (mounts, stats.mounts, count * sizeof (ElektraMountStats));
+		after = __atomic_load_n (&stats.sequence, __ATOMIC_ACQUIRE);
+	} while (before % 2 != 0 || before != after);
+
+	return count;
+}
+
+/**
+ * Append a snapshot of the statistics below ELEKTRA_STATS_ROOT.
+ */
+static void appendStats (KeySet * returned)
+{
+	ElektraMountStats mounts[ELEKTRA_STATS_MAX_MOUNTS];
+	size_t count = snapshotStats (mounts);
+
+	ksAppendKey (returned, keyNew (ELEKTRA_STATS_ROOT, KEY_VALUE, "operation statistics of this process", KEY_END));
+
+	char value[24];
+	for (size_t i = 0; i < count; i++)
+	{
+		Key * root = keyNew (ELEKTRA_STATS_ROOT, KEY_END);
+		keyAddBaseName (root, mounts[i].mountpoint);
+
+		Key * k = keyDup (root, KEY_CP_ALL);
+		keyAddBaseName (k, "get");
+		snprintf (value, sizeof (value), "%" PRIu64, mounts[i].getCalls);
+		keySetString (k, value);
+		ksAppendKey (returned, k);
+
+		k = keyDup (root, KEY_CP_ALL);
+		keyAddBaseName (k, "set");
+		snprintf (value, sizeof (value), "%" PRIu64, mounts[i].setCalls);
+		keySetString (k, value);
+		ksAppendKey (returned, k);
+
+		k = keyDup (root, KEY_CP_ALL);
+		keyAddBaseName (k, "error");
+		snprintf (value, sizeof (value), "%" PRIu64, mounts[i].errorCalls);
+		keySetString (k, value);
+		ksAppendKey (returned, k);
+
+		k = keyDup (root, KEY_CP_ALL);
+		keyAddBaseName (k, "lastgetkeys");
+		snprintf (value, sizeof (value), "%" PRIu64, mounts[i].lastGetKeys);
+		keySetString (k, value);
+		ksAppendKey (returned, k);
+
+		k = keyDup (root, KEY_CP_ALL);
+		keyAddBaseName (k, "lastsetkeys");
+		snprintf (value, sizeof (value), "%" PRIu64, mounts[i].lastSetKeys);
+		keySetString (k, value);
+		ksAppendKey (returned, k);
+
+		keyDel (root);
+	}
+}
+
 static Counter elektraCountOpen = 0;
 
 int elektraCounterOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
@@ -31,7 +180,7 @@ int elektraCounterOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 			printf ("%p elektraCounterOpen  (module) called " COUNTER_FMT " times\n", (void *) handle, elektraCountOpen);
 		}
 	}
-	else
+	else if (!ksLookupByName (config, "/silent", 0))
 	{
 		printf ("%p elektraCounterOpen           called " COUNTER_FMT " times\n", (void *) handle, elektraCountOpen);
 	}
@@ -52,7 +201,7 @@ int elektraCounterClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 			printf ("%p elektraCounterClose (module) called " COUNTER_FMT " times\n", (void *) handle, elektraCountClose);
 		}
 	}
-	else
+	else if (!ksLookupByName (config, "/silent", 0))
 	{
 		printf ("%p elektraCounterClose          called " COUNTER_FMT " times\n", (void *) handle, elektraCountClose);
 	}
@@ -60,7 +209,7 @@ int elektraCounterClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 	return 1; /* success */
 }
 
-int elektraCounterGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+int elektraCounterGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
 {
 	if (!strcmp (keyName (parentKey), "system:/elektra/modules/counter"))
 	{
@@ -79,21 +228,29 @@ int elektraCounterGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA
 
 		return 1; /* success */
 	}
-	/* get all keys */
+
+	recordOperation (OPERATION_GET, parentKey, ksGetSize (returned));
+
+	Key * root = keyNew (ELEKTRA_STATS_ROOT, KEY_END);
+	if (keyIsBelowOrSame (parentKey, root))
+	{
+		appendStats (returned);
+	}
+	keyDel (root);
 
 	return 1; /* success */
 }
 
-int elektraCounterSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+int elektraCounterSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
 {
-	/* set all keys */
+	recordOperation (OPERATION_SET, parentKey, ksGetSize (returned));
 
 	return 1; /* success */
 }
 
-int elektraCounterError (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+int elektraCounterError (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey)
 {
-	/* set all keys */
+	recordOperation (OPERATION_ERROR, parentKey, 0);
 
 	return 1; /* success */
 }
@@ -109,4 +266,3 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 		ELEKTRA_PLUGIN_ERROR,	&elektraCounterError,
 		ELEKTRA_PLUGIN_END);
 }
-
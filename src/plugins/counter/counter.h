@@ -11,6 +11,24 @@
 
 #include <kdbplugin.h>
 
+#include <stdint.h>
+
+/** root of the exported statistics keys */
+#define ELEKTRA_STATS_ROOT "system:/elektra/stats"
+
+/** maximum number of tracked mountpoints */
+#define ELEKTRA_STATS_MAX_MOUNTS (64)
+
+/** per mountpoint operation counters */
+typedef struct
+{
+	char mountpoint[256];
+	uint64_t getCalls;
+	uint64_t setCalls;
+	uint64_t errorCalls;
+	uint64_t lastGetKeys; /*!< keyset size seen by the last get */
+	uint64_t lastSetKeys; /*!< keyset size seen by the last set */
+} ElektraMountStats;
 
 int elektraCounterOpen (Plugin * handle, Key * errorKey);
 int elektraCounterClose (Plugin * handle, Key * errorKey);
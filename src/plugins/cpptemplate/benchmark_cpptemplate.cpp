@@ -0,0 +1,104 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for cpptemplate plugin
+ *
+ * Drives the get and set functions of the plugin with synthetic keysets
+ * at multiple scales, using the statistical harness from benchmarks.h
+ * (pass `--output=json` for machine readable results). New plugins
+ * created from this skeleton get a renamed copy of this file and a
+ * `benchmark_<plugin>` target automatically; adapt
+ * generateBenchmarkKeys() and the parent key to the data your plugin
+ * actually processes.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <benchmarks.h>
+
+#include <kdbmodule.h>
+#include <kdbprivate.h>
+
+#include <string>
+
+using namespace ckdb;
+
+#define PLUGIN_NAME "cpptemplate"
+
+namespace
+{
+
+struct BenchmarkData
+{
+	Plugin * plugin;
+	KeySet * keys;
+	Key * parentKey;
+};
+
+/** Generates @p size keys spread over 100 folders below the parent key. */
+KeySet * generateBenchmarkKeys (size_t const size)
+{
+	KeySet * keys = ksNew (size, KS_END);
+	for (size_t i = 0; i < size; ++i)
+	{
+		std::string name =
+			"user:/benchmark/dir" + std::to_string (i % 100) + "/key" + std::to_string (i);
+		ksAppendKey (keys, keyNew (name.c_str (), KEY_VALUE, "value", KEY_END));
+	}
+	return keys;
+}
+
+void benchmarkGet (void * data)
+{
+	BenchmarkData * benchmark = static_cast<BenchmarkData *> (data);
+	benchmark->plugin->kdbGet (benchmark->plugin, benchmark->keys, benchmark->parentKey);
+}
+
+void benchmarkSet (void * data)
+{
+	BenchmarkData * benchmark = static_cast<BenchmarkData *> (data);
+	benchmark->plugin->kdbSet (benchmark->plugin, benchmark->keys, benchmark->parentKey);
+}
+
+} // end namespace
+
+int main (int argc, char ** argv)
+{
+	benchmarkHarnessInit (argc, argv);
+
+	KeySet * modules = ksNew (0, KS_END);
+	KeySet * config = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * errorKey = keyNew ("/", KEY_END);
+	Plugin * plugin = elektraPluginOpen (PLUGIN_NAME, modules, config, errorKey);
+	keyDel (errorKey);
+	if (!plugin)
+	{
+		fprintf (stderr, "could not open %s plugin\n", PLUGIN_NAME);
+		return 1;
+	}
+
+	Key * parentKey = keyNew ("user:/benchmark", KEY_END);
+
+	for (size_t scale : { 1000, 10000, 100000 })
+	{
+		BenchmarkData data{ plugin, generateBenchmarkKeys (scale), parentKey };
+
+		std::string getName = std::string ("kdbGet/") + std::to_string (scale);
+		benchmarkMeasure (getName.c_str (), BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkGet, &data);
+
+		std::string setName = std::string ("kdbSet/") + std::to_string (scale);
+		benchmarkMeasure (setName.c_str (), BENCHMARK_WARMUPS, BENCHMARK_ITERATIONS, benchmarkSet, &data);
+
+		ksDel (data.keys);
+	}
+
+	benchmarkHarnessFinish ();
+
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	return 0;
+}
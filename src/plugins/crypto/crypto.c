@@ -192,6 +192,7 @@ static int elektraCryptoEncrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data E
 {
 	Key * k;
 	Key * masterKey = NULL;
+	elektraCryptoHandle * cryptoHandle = NULL;
 
 	KeySet * pluginConfig = elektraPluginGetConfig (handle);
 	masterKey = ELEKTRA_PLUGIN_FUNCTION (getMasterPassword) (errorKey, pluginConfig);
@@ -200,8 +201,6 @@ static int elektraCryptoEncrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data E
 		goto error; // error has been set by getMasterPassword
 	}
 
-	elektraCryptoHandle * cryptoHandle = NULL;
-
 	ksRewind (data);
 	while ((k = ksNext (data)) != 0)
 	{
@@ -210,24 +209,28 @@ static int elektraCryptoEncrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data E
 			continue;
 		}
 
-		if (elektraCryptoGcryHandleCreate (&cryptoHandle, pluginConfig, errorKey, masterKey, k, ELEKTRA_CRYPTO_ENCRYPT) != 1)
+		// one cipher context serves the whole pass; it is re-keyed per key
+		if (!cryptoHandle && elektraCryptoGcryHandleOpen (&cryptoHandle, errorKey) != 1)
 		{
 			goto error;
 		}
 
-		if (elektraCryptoGcryEncrypt (cryptoHandle, k, errorKey) != 1)
+		if (elektraCryptoGcryHandleReset (cryptoHandle, pluginConfig, errorKey, masterKey, k, ELEKTRA_CRYPTO_ENCRYPT) != 1)
 		{
-			elektraCryptoGcryHandleDestroy (cryptoHandle);
 			goto error;
 		}
 
-		elektraCryptoGcryHandleDestroy (cryptoHandle);
-		cryptoHandle = NULL;
+		if (elektraCryptoGcryEncrypt (cryptoHandle, k, errorKey) != 1)
+		{
+			goto error;
+		}
 	}
+	elektraCryptoGcryHandleDestroy (cryptoHandle);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return 1;
 
 error:
+	elektraCryptoGcryHandleDestroy (cryptoHandle);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return -1;
 }
@@ -244,6 +247,7 @@ static int elektraCryptoDecrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data,
 {
 	Key * k;
 	Key * masterKey = NULL;
+	elektraCryptoHandle * cryptoHandle = NULL;
 
 	KeySet * pluginConfig = elektraPluginGetConfig (handle);
 	masterKey = ELEKTRA_PLUGIN_FUNCTION (getMasterPassword) (errorKey, pluginConfig);
@@ -252,8 +256,6 @@ static int elektraCryptoDecrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data,
 		goto error; // error has been set by getMasterPassword
 	}
 
-	elektraCryptoHandle * cryptoHandle = NULL;
-
 	ksRewind (data);
 	while ((k = ksNext (data)) != 0)
 	{
@@ -268,24 +270,28 @@ static int elektraCryptoDecrypt (Plugin * handle ELEKTRA_UNUSED, KeySet * data,
 			goto error;
 		}
 
-		if (elektraCryptoGcryHandleCreate (&cryptoHandle, pluginConfig, errorKey, masterKey, k, ELEKTRA_CRYPTO_DECRYPT) != 1)
+		// one cipher context serves the whole pass; it is re-keyed per key
+		if (!cryptoHandle && elektraCryptoGcryHandleOpen (&cryptoHandle, errorKey) != 1)
 		{
 			goto error;
 		}
 
-		if (elektraCryptoGcryDecrypt (cryptoHandle, k, errorKey) != 1)
+		if (elektraCryptoGcryHandleReset (cryptoHandle, pluginConfig, errorKey, masterKey, k, ELEKTRA_CRYPTO_DECRYPT) != 1)
 		{
-			elektraCryptoGcryHandleDestroy (cryptoHandle);
 			goto error;
 		}
 
-		elektraCryptoGcryHandleDestroy (cryptoHandle);
-		cryptoHandle = NULL;
+		if (elektraCryptoGcryDecrypt (cryptoHandle, k, errorKey) != 1)
+		{
+			goto error;
+		}
 	}
+	elektraCryptoGcryHandleDestroy (cryptoHandle);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return 1;
 
 error:
+	elektraCryptoGcryHandleDestroy (cryptoHandle);
 	elektraCryptoSafelyReleaseKey (masterKey);
 	return -1;
 }
@@ -156,15 +156,35 @@ int elektraCryptoGcryInit (Key * errorKey)
 	return 1;
 }
 
-int elektraCryptoGcryHandleCreate (elektraCryptoHandle ** handle, KeySet * config, Key * errorKey, Key * masterKey, Key * k,
-				   const enum ElektraCryptoOperation op)
+int elektraCryptoGcryHandleOpen (elektraCryptoHandle ** handle, Key * errorKey)
+{
+	gcry_error_t gcry_err;
+
+	(*handle) = elektraMalloc (sizeof (elektraCryptoHandle));
+	if (*handle == NULL)
+	{
+		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
+		return -1;
+	}
+
+	if ((gcry_err = gcry_cipher_open (*handle, GCRY_CIPHER_AES256, GCRY_CIPHER_MODE_CBC, 0)) != 0)
+	{
+		ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to setup libgcrypt. Reason: %s", gcry_strerror (gcry_err));
+		elektraFree (*handle);
+		(*handle) = NULL;
+		return -1;
+	}
+
+	return 1;
+}
+
+int elektraCryptoGcryHandleReset (elektraCryptoHandle * handle, KeySet * config, Key * errorKey, Key * masterKey, Key * k,
+				  const enum ElektraCryptoOperation op)
 {
 	gcry_error_t gcry_err;
 	unsigned char keyBuffer[64], ivBuffer[64];
 	size_t keyLength, ivLength;
 
-	(*handle) = NULL;
-
 	// retrieve/derive the cryptographic material
 	Key * key = keyNew ("/", KEY_END);
 	Key * iv = keyNew ("/", KEY_END);
@@ -197,29 +217,18 @@ int elektraCryptoGcryHandleCreate (elektraCryptoHandle ** handle, KeySet * confi
 	keyLength = keyGetBinary (key, keyBuffer, sizeof (keyBuffer));
 	ivLength = keyGetBinary (iv, ivBuffer, sizeof (ivBuffer));
 
-	// create the handle
-	(*handle) = elektraMalloc (sizeof (elektraCryptoHandle));
-	if (*handle == NULL)
-	{
-		memset (keyBuffer, 0, sizeof (keyBuffer));
-		memset (ivBuffer, 0, sizeof (ivBuffer));
-		keyDel (key);
-		keyDel (iv);
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (errorKey);
-		return -1;
-	}
-
-	if ((gcry_err = gcry_cipher_open (*handle, GCRY_CIPHER_AES256, GCRY_CIPHER_MODE_CBC, 0)) != 0)
+	// discard the state of the previous key before re-keying the context
+	if ((gcry_err = gcry_cipher_reset (*handle)) != 0)
 	{
 		goto error;
 	}
 
-	if ((gcry_err = gcry_cipher_setkey (**handle, keyBuffer, keyLength)) != 0)
+	if ((gcry_err = gcry_cipher_setkey (*handle, keyBuffer, keyLength)) != 0)
 	{
 		goto error;
 	}
 
-	if ((gcry_err = gcry_cipher_setiv (**handle, ivBuffer, ivLength)) != 0)
+	if ((gcry_err = gcry_cipher_setiv (*handle, ivBuffer, ivLength)) != 0)
 	{
 		goto error;
 	}
@@ -234,14 +243,29 @@ error:
 	memset (keyBuffer, 0, sizeof (keyBuffer));
 	memset (ivBuffer, 0, sizeof (ivBuffer));
 	ELEKTRA_SET_INTERNAL_ERRORF (errorKey, "Failed to setup libgcrypt. Reason: %s", gcry_strerror (gcry_err));
-	gcry_cipher_close (**handle);
-	elektraFree (*handle);
-	(*handle) = NULL;
 	keyDel (key);
 	keyDel (iv);
 	return -1;
 }
 
+int elektraCryptoGcryHandleCreate (elektraCryptoHandle ** handle, KeySet * config, Key * errorKey, Key * masterKey, Key * k,
+				   const enum ElektraCryptoOperation op)
+{
+	if (elektraCryptoGcryHandleOpen (handle, errorKey) != 1)
+	{
+		return -1;
+	}
+
+	if (elektraCryptoGcryHandleReset (*handle, config, errorKey, masterKey, k, op) != 1)
+	{
+		elektraCryptoGcryHandleDestroy (*handle);
+		(*handle) = NULL;
+		return -1;
+	}
+
+	return 1;
+}
+
 int elektraCryptoGcryEncrypt (elektraCryptoHandle * handle, Key * k, Key * errorKey)
 {
 	size_t outputLen;
@@ -22,6 +22,9 @@ typedef gcry_cipher_hd_t elektraCryptoHandle;
 
 char * elektraCryptoGcryCreateRandomString (Key * errorKey, const kdb_unsigned_short_t length);
 int elektraCryptoGcryInit (Key * errorKey);
+int elektraCryptoGcryHandleOpen (elektraCryptoHandle ** handle, Key * errorKey);
+int elektraCryptoGcryHandleReset (elektraCryptoHandle * handle, KeySet * config, Key * errorKey, Key * masterKey, Key * k,
+				  const enum ElektraCryptoOperation op);
 int elektraCryptoGcryHandleCreate (elektraCryptoHandle ** handle, KeySet * config, Key * errorKey, Key * masterKey, Key * k,
 				   const enum ElektraCryptoOperation op);
 void elektraCryptoGcryHandleDestroy (elektraCryptoHandle * handle);
@@ -327,8 +327,25 @@ static KeySet * readHeaders (Key * parentKey, char * lineBuffer, char delim, int
 	return header;
 }
 
+// checks whether a column should be materialized as keys, according to
+// the /columns/select configuration (mirrors isExportKey on the write side)
+static int isSelectedColumn (const char * colName, KeySet * selectKS, Key * colAsParent)
+{
+	if (!selectKS) return 1;
+	if (colAsParent && !strcmp (colName, keyString (colAsParent)))
+	{
+		// the index column is always needed for renaming the records
+		return 1;
+	}
+	Key * lookupKey = keyNew ("/columns/select", KEY_END);
+	keyAddBaseName (lookupKey, colName);
+	int ret = ksLookupByName (selectKS, keyName (lookupKey), KDB_O_NONE) != NULL;
+	keyDel (lookupKey);
+	return ret;
+}
+
 static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsParent, short useHeader, unsigned long fixColumnCount,
-		    const char ** colNames)
+		    const char ** colNames, KeySet * selectKS, unsigned long rowStart, unsigned long rowLimit)
 {
 	const char * fileName;
 	fileName = keyString (parentKey);
@@ -398,8 +415,18 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 	keyAddName (dirKey, "#");
 	elektraFree (lineBuffer);
 	ksRewind (header);
+	unsigned long recordCounter = 0;
+	unsigned long emittedRecords = 0;
 	while (1)
 	{
+		if (rowLimit && emittedRecords >= rowLimit)
+		{
+			// the requested window is complete, the rest of the file is not needed
+			fclose (fp);
+			keyDel (dirKey);
+			ksDel (header);
+			return 1;
+		}
 		lineBuffer = readNextLine (fp, delim, &lastLine, &linesRead);
 		if (!lineBuffer)
 		{
@@ -417,6 +444,15 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 			fclose (fp);
 			return -1;
 		}
+		if (recordCounter++ < rowStart)
+		{
+			// before the requested window: keep the array index, but
+			// do not parse or materialize the record
+			lineCounter += linesRead;
+			elektraFree (lineBuffer);
+			continue;
+		}
+		++emittedRecords;
 		++nr_keys;
 		unsigned long offset = 0;
 		char * col;
@@ -428,6 +464,12 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		{
 			cur = ksNext (header);
 			offset += elektraStrLen (col);
+			if (!isSelectedColumn (keyString (cur), selectKS, colAsParent))
+			{
+				lastIndex = (char *) keyBaseName (cur);
+				++colCounter;
+				continue;
+			}
 			key = keyDup (dirKey, KEY_CP_ALL);
 			if (col[0] == '"')
 			{
@@ -589,8 +631,22 @@ int elektraCsvstorageGet (Plugin * handle, KeySet * returned, Key * parentKey)
 			ksDel (namesKS);
 		}
 	}
+	KeySet * selectKS = ksLookupByName (config, "/columns/select", 0) ? config : NULL;
+	unsigned long rowStart = 0;
+	unsigned long rowLimit = 0;
+	Key * rowStartKey = ksLookupByName (config, "/rows/start", 0);
+	if (rowStartKey)
+	{
+		rowStart = atol (keyString (rowStartKey));
+	}
+	Key * rowLimitKey = ksLookupByName (config, "/rows/limit", 0);
+	if (rowLimitKey)
+	{
+		rowLimit = atol (keyString (rowLimitKey));
+	}
 	int nr_keys;
-	nr_keys = csvRead (returned, parentKey, delim, colAsParent, useHeader, fixColumnCount, (const char **) colNames);
+	nr_keys = csvRead (returned, parentKey, delim, colAsParent, useHeader, fixColumnCount, (const char **) colNames, selectKS, rowStart,
+			   rowLimit);
 	if (colNames) elektraFree (colNames);
 	if (nr_keys == -1) return -1;
 	return 1;
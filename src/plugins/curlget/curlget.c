@@ -63,6 +63,8 @@ typedef struct
 	char * path;
 	const char * tmpFile;
 	time_t mtime;
+	char * etag;	     // entity tag of the last successful download
+	time_t remoteMtime;  // Last-Modified of the last successful download
 	unsigned char lastHash[MD5_DIGEST_LENGTH];
 	const char * getUrl;
 	const char * uploadUrl;
@@ -159,6 +161,7 @@ int elektraCurlgetClose (Plugin * handle ELEKTRA_UNUSED, Key * errorKey ELEKTRA_
 		data->path = NULL;
 	}
 	if (data->uploadFileName) elektraFree (data->__uploadFileName);
+	if (data->etag) elektraFree (data->etag);
 	elektraFree (data);
 	data = NULL;
 	elektraPluginSetData (handle, data);
@@ -482,8 +485,30 @@ static void setupSSH (CURL * curl, Data * data)
 	}
 }
 
-static FILE * fetchFile (Data * data, int fd)
+static size_t headerCallback (char * buffer, size_t size, size_t nitems, void * userdata)
 {
+	Data * data = userdata;
+	size_t total = size * nitems;
+	const char * prefix = "etag:";
+	size_t prefixLen = sizeof ("etag:") - 1;
+	if (total > prefixLen && !strncasecmp (buffer, prefix, prefixLen))
+	{
+		const char * start = buffer + prefixLen;
+		const char * end = buffer + total;
+		while (start < end && (*start == ' ' || *start == '\t'))
+			++start;
+		while (end > start && (end[-1] == '\r' || end[-1] == '\n' || end[-1] == ' '))
+			--end;
+		if (data->etag) elektraFree (data->etag);
+		data->etag = elektraCalloc (end - start + 1);
+		memcpy (data->etag, start, end - start);
+	}
+	return total;
+}
+
+static FILE * fetchFile (Data * data, int fd, int * notModified)
+{
+	if (notModified) *notModified = 0;
 	CURL * curl = curl_easy_init ();
 	if (!curl)
 	{
@@ -516,6 +541,31 @@ static FILE * fetchFile (Data * data, int fd)
 	{
 		setupSSH (curl, data);
 	}
+	struct curl_slist * headers = NULL;
+	if (data->getProto == PROTO_HTTP || data->getProto == PROTO_HTTPS)
+	{
+		curl_easy_setopt (curl, CURLOPT_FILETIME, 1L);
+		curl_easy_setopt (curl, CURLOPT_HEADERFUNCTION, headerCallback);
+		curl_easy_setopt (curl, CURLOPT_HEADERDATA, data);
+		// revalidate instead of re-downloading while we still have a local copy
+		if (data->useLocalCopy && *(data->lastHash))
+		{
+			if (data->etag)
+			{
+				size_t len = sizeof ("If-None-Match: ") + strlen (data->etag);
+				char * header = elektraMalloc (len);
+				snprintf (header, len, "If-None-Match: %s", data->etag);
+				headers = curl_slist_append (headers, header);
+				elektraFree (header);
+				curl_easy_setopt (curl, CURLOPT_HTTPHEADER, headers);
+			}
+			else if (data->remoteMtime)
+			{
+				curl_easy_setopt (curl, CURLOPT_TIMECONDITION, CURL_TIMECOND_IFMODSINCE);
+				curl_easy_setopt (curl, CURLOPT_TIMEVALUE, (long) data->remoteMtime);
+			}
+		}
+	}
 	curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION, NULL);
 	FILE * fp = fdopen (fd, "w+");
 	curl_easy_setopt (curl, CURLOPT_WRITEDATA, fp);
@@ -523,12 +573,22 @@ static FILE * fetchFile (Data * data, int fd)
 	res = curl_easy_perform (curl);
 	long respCode = 0;
 	curl_easy_getinfo (curl, CURLINFO_RESPONSE_CODE, &respCode);
+	long filetime = -1;
+	curl_easy_getinfo (curl, CURLINFO_FILETIME, &filetime);
 	curl_easy_cleanup (curl);
+	if (headers) curl_slist_free_all (headers);
+	if (res == CURLE_OK && respCode == 304)
+	{
+		if (notModified) *notModified = 1;
+		fclose (fp);
+		return NULL;
+	}
 	if (res != CURLE_OK || respCode != 200)
 	{
 		fclose (fp);
 		return NULL;
 	}
+	if (filetime > 0) data->remoteMtime = (time_t) filetime;
 	return fp;
 }
 
@@ -624,7 +684,17 @@ int elektraCurlgetGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA
 		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Failed to open %s for reading. Reason: %s", data->path, strerror (errno));
 		return -1;
 	}
-	FILE * fp = fetchFile (data, fd);
+	int notModified = 0;
+	FILE * fp = fetchFile (data, fd, &notModified);
+	if (!fp && notModified)
+	{
+		// server confirmed the remote file is unchanged: keep the local copy
+		close (fd);
+		unlink (data->tmpFile);
+		data->tmpFile = NULL;
+		keySetString (parentKey, data->path);
+		return 0;
+	}
 	if (!fp)
 	{
 		close (fd);
@@ -709,8 +779,16 @@ int elektraCurlgetSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA
 		int fd = mkstemp (name);
 		if (data->tmpFile) unlink (data->tmpFile);
 		data->tmpFile = name;
-		FILE * fp = fetchFile (data, fd);
-		if (fp)
+		int notModified = 0;
+		FILE * fp = fetchFile (data, fd, &notModified);
+		if (!fp && notModified)
+		{
+			// server confirmed the remote file is unchanged: consistent with our get
+			++(data->setPhase);
+			if (data->tmpFile) unlink (data->tmpFile);
+			data->tmpFile = NULL;
+		}
+		else if (fp)
 		{
 			fseek (fp, 0L, SEEK_END);
 			size_t size = ftell (fp);
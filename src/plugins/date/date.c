@@ -21,28 +21,107 @@
 #include <time.h>
 
 
+//
+// remembers which format matched last, so validating many keys sharing
+// one format walks the format tables only once
+//
+
+typedef struct
+{
+	const RepStruct * isoTable; /* table of the last successful individual ISO match */
+	int isoIndex;
+	const CRepStruct * combinedTable; /* entries of the last successful combined ISO match */
+	int combinedIndex;
+	int combinedDateIndex;
+	int combinedTimeIndex;
+	const char * const * rfcTable; /* format list of the last successful rfc(2)822 match */
+	int rfcIndex;
+} DateDispatch;
+
+//
+// fixed-offset field extraction for the most common ISO 8601 shapes,
+// avoiding strptime entirely. Only ever accepts values the format tables
+// would accept too; on a miss the table walk decides.
+//
+
+static int parseFixedNumber (const char * s, int digits, int min, int max)
+{
+	int value = 0;
+	for (int i = 0; i < digits; ++i)
+	{
+		if (!isdigit ((unsigned char) s[i])) return -1;
+		value = value * 10 + (s[i] - '0');
+	}
+	return (value >= min && value <= max) ? value : -1;
+}
+
+// "YYYY-MM-DD", i.e. the complete extended calendar date ("%F"); the caller checks what follows
+static int isoFastCalendarDate (const char * date)
+{
+	if (parseFixedNumber (date, 4, 0, 9999) < 0 || date[4] != '-') return 0;
+	if (parseFixedNumber (date + 5, 2, 1, 12) < 0 || date[7] != '-') return 0;
+	if (parseFixedNumber (date + 8, 2, 1, 31) < 0) return 0;
+	return 1;
+}
+
+// "hh:mm:ss", i.e. the complete extended time of day ("%T"); the caller checks what follows
+static int isoFastTimeOfDay (const char * time)
+{
+	if (parseFixedNumber (time, 2, 0, 23) < 0 || time[2] != ':') return 0;
+	if (parseFixedNumber (time + 3, 2, 0, 59) < 0 || time[5] != ':') return 0;
+	if (parseFixedNumber (time + 6, 2, 0, 60) < 0) return 0;
+	return 1;
+}
+
 //
 // use an ISO format string table to validate the key value
 //
 
-static int individualIsoStringValidation (const char * date, const RepStruct * formats, ISOType opts)
+static int tryIsoEntry (const char * date, const RepStruct * entry, ISOType opts)
 {
 	struct tm tm;
 	memset (&tm, 0, sizeof (struct tm));
+
+	if (opts & BASIC)
+	{
+		char * ptr = strptime (date, entry->basic, &tm);
+		if (ptr && !*ptr) return 1;
+	}
+	if ((opts & EXTD) && entry->extended)
+	{
+		char * ptr = strptime (date, entry->extended, &tm);
+		if (ptr && !*ptr) return 1;
+	}
+	return -1;
+}
+
+static int individualIsoStringValidation (const char * date, const RepStruct * formats, ISOType opts, DateDispatch * dispatch)
+{
+	if ((opts & CMPLT) && (opts & EXTD))
+	{
+		// fast path: complete extended representations have a fixed shape
+		if (formats == iso8601calendardate && isoFastCalendarDate (date) && date[10] == '\0') return 1;
+		if (formats == iso8601timeofday && isoFastTimeOfDay (date) && date[8] == '\0') return 1;
+	}
+
+	// try the entry that matched last time first
+	if (dispatch && dispatch->isoTable == formats && (formats[dispatch->isoIndex].rep & (opts & REPMASK)))
+	{
+		if (tryIsoEntry (date, &formats[dispatch->isoIndex], opts) == 1) return 1;
+	}
+
 	for (int i = 0; formats[i].rep != END; ++i)
 	{
 		if (formats[i].rep & (opts & REPMASK))
 		{
-
-			if (opts & BASIC)
+			if (tryIsoEntry (date, &formats[i], opts) == 1)
 			{
-				char * ptr = strptime (date, formats[i].basic, &tm);
-				if (ptr && !*ptr) return 1;
-			}
-			if ((opts & EXTD) && formats[i].extended)
-			{
-				char * ptr = strptime (date, formats[i].extended, &tm);
-				if (ptr && !*ptr) return 1;
+				if (dispatch)
+				{
+					dispatch->isoTable = formats;
+					dispatch->isoIndex = i;
+				}
+				return 1;
 			}
 		}
 	}
@@ -243,7 +322,7 @@ static int combineAndValidateISO (const char * toValidate, const RepStruct * dat
 // and pass them to combineAndValidateISO
 //
 
-static int combinedIsoStringValidation (const char * toValidate, ISOType opts)
+static int combinedIsoStringValidation (const char * toValidate, ISOType opts, DateDispatch * dispatch)
 {
 	const CRepStruct * formats;
 	ISOType strippedOpts = ((opts & REPMASK) & ~OMITT);
@@ -251,6 +330,11 @@ static int combinedIsoStringValidation (const char * toValidate, ISOType opts)
 	{
 	case CMPLT:
 		formats = iso8601CombinedComplete;
+
+		// fast path: the complete extended combined representation has a fixed shape
+		if ((opts & EXTD) && isoFastCalendarDate (toValidate) && toValidate[10] == 'T' && isoFastTimeOfDay (toValidate + 11) &&
+		    toValidate[19] == '\0')
+			return 1;
 		break;
 	case TRCT:
 		formats = iso8601CombinedOther;
@@ -258,6 +342,22 @@ static int combinedIsoStringValidation (const char * toValidate, ISOType opts)
 	default:
 		return -1;
 	}
+
+	// try the combination that matched last time first
+	if (dispatch && dispatch->combinedTable == formats)
+	{
+		const CRepStruct * e = &formats[dispatch->combinedIndex];
+		if (opts & e->dateRep)
+		{
+			const RepStruct * date = typeToTable (e->date);
+			const RepStruct * time = typeToTable (e->time);
+			if (date && time &&
+			    combineAndValidateISO (toValidate, &(date[dispatch->combinedDateIndex]), &(time[dispatch->combinedTimeIndex]),
+						   opts) == 1)
+				return 1;
+		}
+	}
+
 	for (int i = 0; formats[i].dateRep != END; ++i)
 	{
 		const CRepStruct * e = &formats[i];
@@ -277,14 +377,24 @@ static int combinedIsoStringValidation (const char * toValidate, ISOType opts)
 			{
 				if (time[k].rep != timeRep) continue;
 				int rc = combineAndValidateISO (toValidate, &(date[j]), &(time[k]), opts);
-				if (rc == 1) return 1;
+				if (rc == 1)
+				{
+					if (dispatch)
+					{
+						dispatch->combinedTable = formats;
+						dispatch->combinedIndex = i;
+						dispatch->combinedDateIndex = j;
+						dispatch->combinedTimeIndex = k;
+					}
+					return 1;
+				}
 			}
 		}
 	}
 	return -1;
 }
 
-static int isoStringValidation (const char * date, const char * fmt)
+static int isoStringValidation (const char * date, const char * fmt, DateDispatch * dispatch)
 {
 	ISOType isoToken = NA;
 	if (fmt)
@@ -297,38 +407,38 @@ static int isoStringValidation (const char * date, const char * fmt)
 		switch (strippedToken)
 		{
 		case CALENDAR:
-			rc = individualIsoStringValidation (date, iso8601calendardate, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601calendardate, strippedOpts, dispatch);
 			break;
 		case ORDINAL:
-			rc = individualIsoStringValidation (date, iso8601ordinaldate, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601ordinaldate, strippedOpts, dispatch);
 			break;
 		case WEEK:
-			rc = individualIsoStringValidation (date, iso8601weekdate, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601weekdate, strippedOpts, dispatch);
 			break;
 		case TIMEOFDAY:
-			rc = individualIsoStringValidation (date, iso8601timeofday, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601timeofday, strippedOpts, dispatch);
 			break;
 		case UTC:
-			rc = individualIsoStringValidation (date, iso8601UTC, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601UTC, strippedOpts, dispatch);
 			break;
 		case DATE:
-			rc = individualIsoStringValidation (date, iso8601calendardate, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601calendardate, strippedOpts, dispatch);
 			if (rc == 1) break;
-			rc = individualIsoStringValidation (date, iso8601ordinaldate, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601ordinaldate, strippedOpts, dispatch);
 			if (rc == 1) break;
-			rc = individualIsoStringValidation (date, iso8601weekdate, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601weekdate, strippedOpts, dispatch);
 			break;
 		case TIME:
-			rc = individualIsoStringValidation (date, iso8601timeofday, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601timeofday, strippedOpts, dispatch);
 			if (rc == 1) break;
-			rc = individualIsoStringValidation (date, iso8601UTC, strippedOpts);
+			rc = individualIsoStringValidation (date, iso8601UTC, strippedOpts, dispatch);
 			break;
 		case DATETIME:
 			if (!strchr (date, 'T'))
 			{
 				if (!(strippedOpts & OMITT)) return -1;
 			}
-			rc = combinedIsoStringValidation (date, strippedOpts);
+			rc = combinedIsoStringValidation (date, strippedOpts, dispatch);
 			break;
 		default:
 			break;
@@ -337,8 +447,8 @@ static int isoStringValidation (const char * date, const char * fmt)
 	}
 	else
 	{
-		int rc = combinedIsoStringValidation (date, (DATETIME | CMPLT));
-		if (rc != 1) rc = combinedIsoStringValidation (date, (DATETIME | TRCT));
+		int rc = combinedIsoStringValidation (date, (DATETIME | CMPLT), dispatch);
+		if (rc != 1) rc = combinedIsoStringValidation (date, (DATETIME | TRCT), dispatch);
 		return rc;
 	}
 	return -1;
@@ -368,37 +478,48 @@ static int formatStringValidation (const char * date, const char * fmt)
 // or all possible format strings derived from the specification
 //
 
-static int rfc2822StringValidation (const char * date)
+static int rfcStringValidation (const char * date, const char * const * formats, DateDispatch * dispatch)
 {
 	struct tm tm;
 	memset (&tm, 0, sizeof (struct tm));
-	for (int i = 0; rfc2822strings[i] != NULL; ++i)
+
+	// try the format that matched last time first
+	if (dispatch && dispatch->rfcTable == formats)
 	{
-		char * ptr = strptime (date, rfc2822strings[i], &tm);
-		if (ptr)
-		{
-			if (*ptr == '\0') return 1;
-		}
+		char * ptr = strptime (date, formats[dispatch->rfcIndex], &tm);
+		if (ptr && *ptr == '\0') return 1;
 	}
-	return -1;
-}
 
-static int rfc822StringValidation (const char * date)
-{
-	struct tm tm;
-	memset (&tm, 0, sizeof (struct tm));
-	for (int i = 0; rfc2822strings[i] != NULL; ++i)
+	for (int i = 0; formats[i] != NULL; ++i)
 	{
-		char * ptr = strptime (date, rfc822strings[i], &tm);
+		char * ptr = strptime (date, formats[i], &tm);
 		if (ptr)
 		{
-			if (*ptr == '\0') return 1;
+			if (*ptr == '\0')
+			{
+				if (dispatch)
+				{
+					dispatch->rfcTable = formats;
+					dispatch->rfcIndex = i;
+				}
+				return 1;
+			}
 		}
 	}
 	return -1;
 }
 
-static int validateKey (Key * key, Key * parentKey)
+static int rfc2822StringValidation (const char * date, DateDispatch * dispatch)
+{
+	return rfcStringValidation (date, rfc2822strings, dispatch);
+}
+
+static int rfc822StringValidation (const char * date, DateDispatch * dispatch)
+{
+	return rfcStringValidation (date, rfc822strings, dispatch);
+}
+
+static int validateKeyDispatch (Key * key, Key * parentKey, DateDispatch * dispatch)
 {
 	const Key * standard = keyGetMeta (key, "check/date");
 	const Key * formatStringMeta = keyGetMeta (key, "check/date/format");
@@ -417,7 +538,7 @@ static int validateKey (Key * key, Key * parentKey)
 	}
 	else if (!strcasecmp (stdString, "ISO8601"))
 	{
-		rc = isoStringValidation (date, formatString);
+		rc = isoStringValidation (date, formatString, dispatch);
 		if (rc == -1)
 		{
 			if (formatString)
@@ -434,7 +555,7 @@ static int validateKey (Key * key, Key * parentKey)
 	}
 	else if (!strcasecmp (stdString, "RFC2822"))
 	{
-		rc = rfc2822StringValidation (date);
+		rc = rfc2822StringValidation (date, dispatch);
 		if (rc == -1)
 		{
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Date '%s' doesn't match rfc2822 specification", date);
@@ -443,7 +564,7 @@ static int validateKey (Key * key, Key * parentKey)
 	}
 	else if (!strcasecmp (stdString, "RFC822"))
 	{
-		rc = rfc822StringValidation (date);
+		rc = rfc822StringValidation (date, dispatch);
 		if (rc == -1)
 		{
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Date '%s' doesn't match format string %s", date, formatString);
@@ -454,6 +575,12 @@ static int validateKey (Key * key, Key * parentKey)
 	return rc;
 }
 
+static int validateKey (Key * key, Key * parentKey)
+{
+	DateDispatch dispatch = { 0 };
+	return validateKeyDispatch (key, parentKey, &dispatch);
+}
+
 
 int elektraDateGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
 {
@@ -475,12 +602,13 @@ int elektraDateGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UN
 	// get all keys
 	Key * cur;
 	int rc = 1;
+	DateDispatch dispatch = { 0 }; // shared across keys, most of them use the same format
 	while ((cur = ksNext (returned)) != NULL)
 	{
 		const Key * meta = keyGetMeta (cur, "check/date");
 		if (meta)
 		{
-			int r = validateKey (cur, parentKey);
+			int r = validateKeyDispatch (cur, parentKey, &dispatch);
 			if (r == 0)
 			{
 				rc = -1;
@@ -496,12 +624,13 @@ int elektraDateSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UN
 	// this function is optional
 	Key * cur;
 	int rc = 1;
+	DateDispatch dispatch = { 0 }; // shared across keys, most of them use the same format
 	while ((cur = ksNext (returned)) != NULL)
 	{
 		const Key * meta = keyGetMeta (cur, "check/date");
 		if (meta)
 		{
-			int r = validateKey (cur, parentKey);
+			int r = validateKeyDispatch (cur, parentKey, &dispatch);
 			if (r == 0)
 			{
 				rc = -1;
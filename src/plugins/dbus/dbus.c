@@ -131,11 +131,23 @@ int elektraDbusSet (Plugin * handle, KeySet * returned, Key * parentKey)
 		announceSystem = !strncmp (keyName (resolvedParentKey), "system", 6);
 	}
 
-	if (!strncmp (keyString (ksLookupByName (elektraPluginGetConfig (handle), "/announce", 0)), "once", 4))
+	const char * announce = keyString (ksLookupByName (elektraPluginGetConfig (handle), "/announce", 0));
+	if (!strncmp (announce, "once", 4))
 	{
 		if (announceSession) elektraDbusSendMessage (pluginData, DBUS_BUS_SESSION, keyName (resolvedParentKey), "Commit");
 		if (announceSystem) elektraDbusSendMessage (pluginData, DBUS_BUS_SYSTEM, keyName (resolvedParentKey), "Commit");
 	}
+	else if (!strncmp (announce, "batch", 5))
+	{
+		// a single Commit signal per commit, carrying the changed paths
+		KeySet * allChanged = ksNew (0, KS_END);
+		ksAppend (allChanged, addedKeys);
+		ksAppend (allChanged, changedKeys);
+		ksAppend (allChanged, removedKeys);
+		if (announceSession) elektraDbusSendCommit (pluginData, DBUS_BUS_SESSION, keyName (resolvedParentKey), allChanged);
+		if (announceSystem) elektraDbusSendCommit (pluginData, DBUS_BUS_SYSTEM, keyName (resolvedParentKey), allChanged);
+		ksDel (allChanged);
+	}
 	else
 	{
 		if (announceSession)
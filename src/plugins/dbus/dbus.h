@@ -35,6 +35,7 @@ typedef struct
 } ElektraDbusPluginData;
 
 int elektraDbusSendMessage (ElektraDbusPluginData * data, DBusBusType type, const char * keyName, const char * signalName);
+int elektraDbusSendCommit (ElektraDbusPluginData * data, DBusBusType type, const char * parentName, KeySet * changedKeys);
 int elektraDbusReceiveMessage (DBusBusType type, DBusHandleMessageFunction filter_func);
 int elektraDbusSetupReceiveMessage (DBusConnection * connection, DBusHandleMessageFunction filter_func, void * data);
 int elektraDbusTeardownReceiveMessage (DBusConnection * connection, DBusHandleMessageFunction filter_func, void * data);
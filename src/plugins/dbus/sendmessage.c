@@ -13,6 +13,7 @@
 #include "kdbconfig.h"
 #endif
 
+#include <kdbhelper.h>
 #include <kdblogger.h>
 
 /**
@@ -115,3 +116,92 @@ int elektraDbusSendMessage (ElektraDbusPluginData * pluginData, DBusBusType type
 
 	return 1;
 }
+
+/**
+ * @internal
+ * Send Elektra's "Commit" signal message including the changed paths.
+ *
+ * In addition to the name of the committed parent key, the message carries an
+ * array with the names of all keys added, changed or removed by the commit.
+ * Consumers can invalidate precisely without receiving one signal per key.
+ *
+ * @param  pluginData  Plugin data, stores D-Bus connection, I/O binding and more
+ * @param  type        D-Bus bus type
+ * @param  parentName  Name of the committed parent key
+ * @param  changedKeys Keys added, changed or removed by the commit
+ * @retval 1 on success
+ * @retval -1 on error
+ */
+int elektraDbusSendCommit (ElektraDbusPluginData * pluginData, DBusBusType type, const char * parentName, KeySet * changedKeys)
+{
+	DBusConnection * connection;
+	DBusMessage * message;
+	const char * dest = NULL; // to all receivers
+	const char * interface = "org.libelektra";
+	const char * path = "/org/libelektra/configuration";
+
+	switch (type)
+	{
+	case DBUS_BUS_SYSTEM:
+		if (!pluginData->systemBus)
+		{
+			pluginData->systemBus = dbusGetConnection (type);
+		}
+		connection = pluginData->systemBus;
+		break;
+	case DBUS_BUS_SESSION:
+		if (!pluginData->sessionBus)
+		{
+			pluginData->sessionBus = dbusGetConnection (type);
+		}
+		connection = pluginData->sessionBus;
+		break;
+	default:
+		connection = NULL;
+	}
+	if (connection == NULL)
+	{
+		return -1;
+	}
+
+	message = dbus_message_new_signal (path, interface, "Commit");
+
+	if (message == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("Couldn't allocate D-Bus message");
+		return -1;
+	}
+
+	if (dest && !dbus_message_set_destination (message, dest))
+	{
+		ELEKTRA_LOG_WARNING ("Not enough memory");
+		dbus_message_unref (message);
+		return -1;
+	}
+
+	int numKeys = (int) ksGetSize (changedKeys);
+	const char ** changedPaths = elektraMalloc ((numKeys > 0 ? numKeys : 1) * sizeof (const char *));
+	ksRewind (changedKeys);
+	Key * k = 0;
+	int i = 0;
+	while ((k = ksNext (changedKeys)) != 0)
+	{
+		changedPaths[i++] = keyName (k);
+	}
+
+	if (!dbus_message_append_args (message, DBUS_TYPE_STRING, &parentName, DBUS_TYPE_ARRAY, DBUS_TYPE_STRING, &changedPaths, numKeys,
+				       DBUS_TYPE_INVALID))
+	{
+		ELEKTRA_LOG_WARNING ("Couldn't add message argument");
+		elektraFree (changedPaths);
+		dbus_message_unref (message);
+		return -1;
+	}
+	elektraFree (changedPaths);
+
+	dbus_connection_send (connection, message, NULL);
+
+	dbus_message_unref (message);
+
+	return 1;
+}
@@ -470,6 +470,48 @@ DirectoryValueDelegate::DirectoryValueDelegate (kdb::KeySet config ELEKTRA_UNUSE
  */
 int DirectoryValueDelegate::convertToDirectories (kdb::KeySet & keys)
 {
+	bool hasDirectoryLeaves = false;
+	bool hasArrayParents = false;
+
+	/* One linear scan decides whether any conversion work is needed at all. Arrays require the full pipeline below, since
+	   decreasing indices renames keys all over the set. */
+	for (auto key : keys)
+	{
+		if (key.hasMeta ("array"))
+		{
+			hasArrayParents = true;
+			break;
+		}
+		if (!hasDirectoryLeaves && key.getBaseName () == DIRECTORY_POSTFIX) hasDirectoryLeaves = true;
+	}
+
+	if (!hasArrayParents)
+	{
+		if (!hasDirectoryLeaves) return ELEKTRA_PLUGIN_STATUS_NO_UPDATE;
+
+		/* Without arrays the transformation only renames directory leaves back onto their parents. A single merged pass
+		   keeps the output sorted, so every append either extends the set or replaces the empty directory key. */
+		kdb::KeySet result;
+		for (auto key : keys)
+		{
+			if (key.getBaseName () == DIRECTORY_POSTFIX)
+			{
+				kdb::Key directory = key.dup ();
+				directory.delBaseName ();
+				result.append (directory);
+			}
+			else
+			{
+				result.append (key);
+			}
+		}
+
+		keys.clear ();
+		keys.append (result);
+
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+
 	kdb::KeySet directoryLeaves;
 	kdb::KeySet nonDirectoryLeaves;
 	kdb::KeySet arrayParents;
@@ -520,6 +562,57 @@ int DirectoryValueDelegate::convertToDirectories (kdb::KeySet & keys)
  */
 int DirectoryValueDelegate::convertToLeaves (kdb::KeySet & keys)
 {
+	bool hasDirectories = false;
+	bool hasArrayParents = false;
+
+	/* One linear scan decides whether any conversion work is needed at all. Arrays require the full pipeline below, since
+	   increasing indices renames keys all over the set. */
+	{
+		kdb::Key previous;
+		for (auto key : keys)
+		{
+			if (key.hasMeta ("array"))
+			{
+				hasArrayParents = true;
+				break;
+			}
+			if (!hasDirectories && previous && key.isBelow (previous)) hasDirectories = true;
+			previous = key;
+		}
+	}
+
+	if (!hasArrayParents)
+	{
+		if (!hasDirectories) return ELEKTRA_PLUGIN_STATUS_NO_UPDATE;
+
+		/* Without arrays the transformation only replaces each directory key by an empty key and a directory leaf. A single
+		   merged pass over the sorted set batches all insertions. */
+		kdb::KeySet result;
+		keys.rewind ();
+		kdb::Key previous;
+		for (previous = keys.next (); keys.next (); previous = keys.current ())
+		{
+			if (keys.current ().isBelow (previous))
+			{
+				kdb::Key emptyDirectory{ previous.getName (), KEY_END };
+				kdb::Key leaf = previous.dup ();
+				leaf.addBaseName (DIRECTORY_POSTFIX);
+				result.append (emptyDirectory);
+				result.append (leaf);
+			}
+			else
+			{
+				result.append (previous);
+			}
+		}
+		if (previous) result.append (previous);
+
+		keys.clear ();
+		keys.append (result);
+
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+
 	kdb::KeySet notArrayParents;
 	kdb::KeySet arrayParents;
 	kdb::KeySet emptyArrayParents;
@@ -8,6 +8,8 @@
 
 #include "dump.hpp"
 
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -26,7 +28,8 @@ namespace dump
 
 int serialise (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
 {
-	os << "kdbOpen 2" << std::endl;
+	os << "kdbOpen 2"
+	   << "\n";
 
 	size_t rootOffset;
 	if (useFullNames)
@@ -68,21 +71,21 @@ int serialise (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool
 			valuesize -= 1;
 		}
 
-		os << "$key " << type << " " << namesize << " " << valuesize << std::endl;
+		os << "$key " << type << " " << namesize << " " << valuesize << "\n";
 		if (namesize > 0)
 		{
 			os << &keyName (cur)[rootOffset];
 		}
-		os << std::endl;
+		os << "\n";
 
 		if (binary)
 		{
 			os.write (static_cast<const char *> (keyValue (cur)), valuesize);
-			os << std::endl;
+			os << "\n";
 		}
 		else
 		{
-			os << keyString (cur) << std::endl;
+			os << keyString (cur) << "\n";
 		}
 
 		ckdb::KeySet * metaKs = keyMeta (cur);
@@ -103,9 +106,9 @@ int serialise (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool
 				size_t metanamesize = keyGetNameSize (meta) - 1 - metaNsOffset;
 				size_t metavaluesize = keyGetValueSize (meta) - 1;
 
-				os << "$meta " << metanamesize << " " << metavaluesize << std::endl;
-				os << keyName (meta) + metaNsOffset << std::endl;
-				os << keyString (meta) << std::endl;
+				os << "$meta " << metanamesize << " " << metavaluesize << "\n";
+				os << keyName (meta) + metaNsOffset << "\n";
+				os << keyString (meta) << "\n";
 
 				std::stringstream ssv;
 				ssv << namesize << " " << metanamesize << std::endl;
@@ -128,7 +131,9 @@ int serialise (std::ostream & os, ckdb::Key * parentKey, ckdb::KeySet * ks, bool
 			}
 		}
 
-		// flush after every key to speed up streaming
+		// flush after every key to speed up streaming; within a key plain
+		// "\n" is used instead of std::endl so the record is written with
+		// one flush instead of one per line
 		os.flush ();
 	}
 	ksDel (metacopies);
@@ -280,6 +285,24 @@ int unserialiseVersion1 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
+/**
+ * @brief Parse the two decimal sizes following a command word
+ *
+ * Used by the version 2 loader to avoid a stringstream round trip per record.
+ */
+static bool parseSizes (const char * pos, size_t & firstSize, size_t & secondSize)
+{
+	char * end = nullptr;
+	unsigned long first = strtoul (pos, &end, 10);
+	if (end == pos || *end != ' ') return false;
+	pos = end + 1;
+	unsigned long second = strtoul (pos, &end, 10);
+	if (end == pos) return false;
+	firstSize = first;
+	secondSize = second;
+	return true;
+}
+
 int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet * ks, bool useFullNames)
 {
 	ckdb::Key * cur = nullptr;
@@ -297,19 +320,19 @@ int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 
 	while (std::getline (is, line))
 	{
-		std::stringstream ss (line);
-		std::string command;
-		ss >> command;
-
-		if (command == "$key")
+		if (line.compare (0, 5, "$key ") == 0)
 		{
-			std::string type;
 			size_t nameSize;
 			size_t valueSize;
 
-			ss >> type;
-			ss >> nameSize;
-			ss >> valueSize;
+			size_t typeEnd = line.find (' ', 5);
+			if (typeEnd == std::string::npos || !parseSizes (line.c_str () + typeEnd + 1, nameSize, valueSize))
+			{
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid $key record in dumpfile: %s.\n",
+									 line.c_str ());
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+			std::string type = line.substr (5, typeEnd - 5);
 
 			std::string name (nameSize, '\0');
 			is.read (&name[0], nameSize);
@@ -372,13 +395,17 @@ int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 
 			ksAppendKey (ks, cur);
 		}
-		else if (command == "$meta")
+		else if (line.compare (0, 6, "$meta ") == 0)
 		{
 			size_t nameSize;
 			size_t valueSize;
 
-			ss >> nameSize;
-			ss >> valueSize;
+			if (!parseSizes (line.c_str () + 6, nameSize, valueSize))
+			{
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid $meta record in dumpfile: %s.\n",
+									 line.c_str ());
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
 
 			std::string name (nameSize, '\0');
 			is.read (&name[0], nameSize);
@@ -406,13 +433,17 @@ int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 
 			keySetMeta (cur, name.c_str (), value.c_str ());
 		}
-		else if (command == "$copymeta")
+		else if (line.compare (0, 10, "$copymeta ") == 0)
 		{
 			size_t keyNameSize;
 			size_t metaNameSize;
 
-			ss >> keyNameSize;
-			ss >> metaNameSize;
+			if (!parseSizes (line.c_str () + 10, keyNameSize, metaNameSize))
+			{
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid $copymeta record in dumpfile: %s.\n",
+									 line.c_str ());
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
 
 			std::string keyName (keyNameSize, '\0');
 			is.read (&keyName[0], keyNameSize);
@@ -441,12 +472,13 @@ int unserialiseVersion2 (std::istream & is, ckdb::Key * parentKey, ckdb::KeySet
 			ckdb::Key * source = ckdb::ksLookupByName (ks, (rootName + keyName).c_str (), 0);
 			keyCopyMeta (cur, source, metaName.c_str ());
 		}
-		else if (command == "$end")
+		else if (line == "$end")
 		{
 			break;
 		}
 		else
 		{
+			std::string command = line.substr (0, line.find (' '));
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (
 				parentKey,
 				"Unknown command detected in dumpfile: %s.\nMaybe the file is not in dump configuration file format? "
@@ -506,21 +538,26 @@ public:
 
 extern "C" {
 
+ckdb::KeySet * elektraDumpContract (void)
+{
+	return ksNew (50, keyNew ("system:/elektra/modules/dump", KEY_VALUE, "dump plugin waits for your orders", KEY_END),
+		      keyNew ("system:/elektra/modules/dump/exports", KEY_END),
+		      keyNew ("system:/elektra/modules/dump/exports/get", KEY_FUNC, elektraDumpGet, KEY_END),
+		      keyNew ("system:/elektra/modules/dump/exports/set", KEY_FUNC, elektraDumpSet, KEY_END),
+		      keyNew ("system:/elektra/modules/dump/exports/serialise", KEY_FUNC, dump::serialise, KEY_END),
+		      keyNew ("system:/elektra/modules/dump/exports/unserialise", KEY_FUNC, dump::unserialise, KEY_END),
+		      keyNew ("system:/elektra/modules/dump/config/needs/fcrypt/textmode", KEY_VALUE, "0", KEY_END),
+#include "readme_dump.c"
+		      keyNew ("system:/elektra/modules/dump/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
+}
+
 int elektraDumpGet (ckdb::Plugin * handle, ckdb::KeySet * returned, ckdb::Key * parentKey)
 {
 	Key * root = ckdb::keyNew ("system:/elektra/modules/dump", KEY_END);
 	if (keyCmp (root, parentKey) == 0 || keyIsBelow (root, parentKey) == 1)
 	{
 		keyDel (root);
-		KeySet * n = ksNew (50, keyNew ("system:/elektra/modules/dump", KEY_VALUE, "dump plugin waits for your orders", KEY_END),
-				    keyNew ("system:/elektra/modules/dump/exports", KEY_END),
-				    keyNew ("system:/elektra/modules/dump/exports/get", KEY_FUNC, elektraDumpGet, KEY_END),
-				    keyNew ("system:/elektra/modules/dump/exports/set", KEY_FUNC, elektraDumpSet, KEY_END),
-				    keyNew ("system:/elektra/modules/dump/exports/serialise", KEY_FUNC, dump::serialise, KEY_END),
-				    keyNew ("system:/elektra/modules/dump/exports/unserialise", KEY_FUNC, dump::unserialise, KEY_END),
-				    keyNew ("system:/elektra/modules/dump/config/needs/fcrypt/textmode", KEY_VALUE, "0", KEY_END),
-#include "readme_dump.c"
-				    keyNew ("system:/elektra/modules/dump/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
+		KeySet * n = elektraDumpContract ();
 		ksAppend (returned, n);
 		ksDel (n);
 		return 1;
@@ -582,6 +619,7 @@ ckdb::Plugin * ELEKTRA_PLUGIN_EXPORT
 	return elektraPluginExport("dump",
 		ELEKTRA_PLUGIN_GET,		&elektraDumpGet,
 		ELEKTRA_PLUGIN_SET,		&elektraDumpSet,
+		ELEKTRA_PLUGIN_CONTRACT,	&elektraDumpContract,
 		ELEKTRA_PLUGIN_END);
 }
 
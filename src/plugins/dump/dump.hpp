@@ -15,6 +15,7 @@ namespace ckdb
 ssize_t keySetRaw (ckdb::Key * key, const void * newBinary, size_t dataSize);
 }
 
+ckdb::KeySet * elektraDumpContract (void);
 int elektraDumpGet (ckdb::Plugin * handle, ckdb::KeySet * ks, ckdb::Key * parentKey);
 int elektraDumpSet (ckdb::Plugin * handle, ckdb::KeySet * ks, ckdb::Key * parentKey);
 ckdb::Plugin * ELEKTRA_PLUGIN_EXPORT;
@@ -195,7 +195,8 @@ static int validateEncoding (const uint8_t * line, iconv_t conv, size_t bytesRea
 static int checkUnprintable (const uint8_t * line)
 {
 	unsigned int i;
-	for (i = 0; i < elektraStrLen ((char *) line); ++i)
+	const size_t lineLength = elektraStrLen ((char *) line);
+	for (i = 0; i < lineLength; ++i)
 	{ // \n is > 0x7E too
 		if (line[i] < 0x20 || line[i] > 0x7E || line[i] == '\r') return i;
 	}
@@ -53,6 +53,10 @@ typedef struct
 	unsigned char lastHash[MD5_DIGEST_LENGTH]; // hash of the checkdout file
 	short checkout;				   // 1 = checkout file to repo, 0 = checkout to temporary file
 	short pull;				   // 0 = don't pull repo, 1 = pull repo
+	char * refFile;				   // file currently backing the tracked ref
+	char * packedRefsFile;			   // packed-refs file of the repository
+	struct timespec refTime;		   // mtime of refFile, tv_sec -1 if missing
+	struct timespec packedRefsTime;		   // mtime of packedRefsFile, tv_sec -1 if missing
 } GitData;
 
 
@@ -158,6 +162,8 @@ int elektraGitresolverClose (Plugin * handle ELEKTRA_UNUSED, Key * errorKey ELEK
 	if (data->subdirs) elektraFree (data->subdirs);
 	if (data->file) elektraFree (data->file);
 	if (data->refName) elektraFree (data->refName);
+	if (data->refFile) elektraFree (data->refFile);
+	if (data->packedRefsFile) elektraFree (data->packedRefsFile);
 	elektraFree (data);
 	elektraPluginSetData (handle, NULL);
 	return 1; // success
@@ -308,6 +314,53 @@ static git_repository * connectToLocalRepo (GitData * data)
 	return repo;
 }
 
+static void statRefFile (const char * path, struct timespec * time)
+{
+	struct stat buf;
+	if (path && stat (path, &buf) != -1)
+	{
+		time->tv_sec = ELEKTRA_STAT_SECONDS (buf);
+		time->tv_nsec = ELEKTRA_STAT_NANO_SECONDS (buf);
+	}
+	else
+	{
+		time->tv_sec = -1;
+		time->tv_nsec = 0;
+	}
+}
+
+/* remember which files back the tracked ref, and their timestamps, so the next
+ * get can detect an unchanged ref without opening the repository. An update
+ * touches either the loose ref file or rewrites packed-refs, so watching both
+ * covers all transitions between the two storage forms */
+static void recordRefState (GitData * data, git_repository * repo)
+{
+	const char * gitPath = git_repository_path (repo);
+	if (!gitPath) return;
+	if (data->refFile) elektraFree (data->refFile);
+	if (data->packedRefsFile) elektraFree (data->packedRefsFile);
+	size_t len = strlen (gitPath) + strlen (data->refName) + 1;
+	data->refFile = elektraCalloc (len);
+	snprintf (data->refFile, len, "%s%s", gitPath, data->refName);
+	const char * packedName = "packed-refs";
+	len = strlen (gitPath) + strlen (packedName) + 1;
+	data->packedRefsFile = elektraCalloc (len);
+	snprintf (data->packedRefsFile, len, "%s%s", gitPath, packedName);
+	statRefFile (data->refFile, &(data->refTime));
+	statRefFile (data->packedRefsFile, &(data->packedRefsTime));
+}
+
+static int refStateUnchanged (GitData * data)
+{
+	if (!data->refFile || !data->packedRefsFile) return 0;
+	struct timespec ref;
+	struct timespec packed;
+	statRefFile (data->refFile, &ref);
+	statRefFile (data->packedRefsFile, &packed);
+	return ref.tv_sec == data->refTime.tv_sec && ref.tv_nsec == data->refTime.tv_nsec &&
+	       packed.tv_sec == data->packedRefsTime.tv_sec && packed.tv_nsec == data->packedRefsTime.tv_nsec;
+}
+
 static git_reference * getHeadRef (GitData * data, git_repository * repo)
 {
 	git_reference * headRef;
@@ -638,6 +691,11 @@ int elektraGitresolverGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELE
 
 	if (initData (handle, parentKey)) return -1;
 	GitData * data = elektraPluginGetData (handle);
+	if (data->tracking == HEAD && !data->pull && data->headID && refStateUnchanged (data))
+	{
+		// ref files untouched since the last checkout: still the newest commit
+		return 0;
+	}
 	git_repository * repo = connectToLocalRepo (data);
 	if (!repo)
 	{
@@ -677,6 +735,7 @@ int elektraGitresolverGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELE
 		git_libgit2_shutdown ();
 		return -1;
 	}
+	recordRefState (data, repo);
 	if (data->tracking == HEAD)
 	{
 		char * newCommit = hasNewCommit (data, headObj);
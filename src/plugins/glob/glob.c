@@ -24,7 +24,7 @@ struct GlobFlagMap
 
 struct GlobFlagMap flagMaps[] = { { "noescape", FNM_NOESCAPE }, { "pathname", FNM_PATHNAME }, { "period", FNM_PERIOD } };
 
-int elektraGlobMatch (Key * key, const Key * match, const char * globFlags)
+static int parseGlobFlags (const char * globFlags)
 {
 	char * tokenList = elektraStrDup (globFlags);
 	char delimiter[] = ",";
@@ -44,8 +44,12 @@ int elektraGlobMatch (Key * key, const Key * match, const char * globFlags)
 	}
 
 	free (tokenList);
+	return flags;
+}
 
-	if (!fnmatch (keyString (match), keyName (key), flags))
+int elektraGlobMatch (Key * key, const Key * match, const char * globFlags)
+{
+	if (!fnmatch (keyString (match), keyName (key), parseGlobFlags (globFlags)))
 	{
 		keyCopyAllMeta (key, match);
 		return 1;
@@ -138,30 +142,35 @@ static KeySet * getGlobKeys (Key * parentKey, KeySet * keys, enum GlobDirection
 
 static void applyGlob (KeySet * returned, KeySet * glob)
 {
+	size_t numPatterns = (size_t) ksGetSize (glob);
+	if (numPatterns == 0) return;
+
+	/* parse the flags of each pattern once, instead of for every key */
+	int * flags = elektraMalloc (numPatterns * sizeof (int));
+	for (size_t i = 0; i < numPatterns; i++)
+	{
+		const Key * flagKey = keyGetMeta (ksAtCursor (glob, i), "glob/flags");
+
+		/* if no flags were provided, default to FNM_PATHNAME behaviour */
+		flags[i] = flagKey ? parseGlobFlags (keyString (flagKey)) : FNM_PATHNAME;
+	}
+
 	Key * cur;
 	ksRewind (returned);
 	while ((cur = ksNext (returned)) != 0)
 	{
-		Key * match;
-		ksRewind (glob);
-		while ((match = ksNext (glob)) != 0)
+		for (size_t i = 0; i < numPatterns; i++)
 		{
-			const Key * flagKey = keyGetMeta (match, "glob/flags");
-			int matchApplied;
-
-			if (flagKey)
+			Key * match = ksAtCursor (glob, i);
+			if (!fnmatch (keyString (match), keyName (cur), flags[i]))
 			{
-				matchApplied = elektraGlobMatch (cur, match, keyString (flagKey));
+				keyCopyAllMeta (cur, match);
+				break;
 			}
-			else
-			{
-				/* if no flags were provided, default to FNM_PATHNAME behaviour */
-				matchApplied = elektraGlobMatch (cur, match, "pathname");
-			}
-
-			if (matchApplied) break;
 		}
 	}
+
+	elektraFree (flags);
 }
 
 int elektraGlobOpen (Plugin * handle ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
@@ -113,6 +113,33 @@ static int isTextMode (KeySet * conf)
 	return 1;
 }
 
+/**
+ * @brief provides the long-lived gpgme context of this plugin instance.
+ *
+ * The context is created on first use and kept in the plugin data until
+ * elektraGpgmeClose(), so repeated get/set operations reuse one context
+ * (and its crypto engine state) instead of creating a new one each time.
+ *
+ * @param handle holds the plugin instance
+ * @param errorKey will hold an error description in case of failure
+ * @return the context, or NULL if the context could not be created
+ */
+static gpgme_ctx_t getGpgmeContext (Plugin * handle, Key * errorKey)
+{
+	gpgme_ctx_t ctx = elektraPluginGetData (handle);
+	if (ctx == NULL)
+	{
+		gpgme_error_t err = gpgme_new (&ctx);
+		if (err)
+		{
+			ELEKTRA_SET_INSTALLATION_ERRORF (errorKey, "Failed to initialize gpgme. Reason: %s", gpgme_strerror (err));
+			return NULL;
+		}
+		elektraPluginSetData (handle, ctx);
+	}
+	return ctx;
+}
+
 /*
  * @brief invoke gpgme_key_unref on all keys and free the array.
  * @param recipients the array to be released.
@@ -343,24 +370,20 @@ static int gpgEncrypt (Plugin * handle, KeySet * data, Key * errorKey)
 	Key * k;
 
 	gpgme_key_t * recipients;
-	gpgme_ctx_t ctx;
 	gpgme_error_t err;
 	gpgme_encrypt_flags_t encryptFlags = GPGME_ENCRYPT_NO_ENCRYPT_TO;
 
-	err = gpgme_new (&ctx);
-	if (err)
+	gpgme_ctx_t ctx = getGpgmeContext (handle, errorKey);
+	if (ctx == NULL)
 	{
-		ELEKTRA_SET_INSTALLATION_ERRORF (errorKey, "Failed to initialize gpgme. Reason: %s", gpgme_strerror (err));
 		return -1; // at this point nothing has been initialized
 	}
 
 	KeySet * pluginConfig = elektraPluginGetConfig (handle);
 
 	textMode = isTextMode (pluginConfig);
-	if (textMode)
-	{
-		gpgme_set_armor (ctx, 1);
-	}
+	// the context is shared with previous operations, so always set the armor mode
+	gpgme_set_armor (ctx, textMode);
 
 	recipients = extractRecipientFromPluginConfig (pluginConfig, errorKey, ctx);
 	if (!recipients)
@@ -461,7 +484,6 @@ static int gpgEncrypt (Plugin * handle, KeySet * data, Key * errorKey)
 
 cleanup:
 	freeRecipientArray (recipients);
-	gpgme_release (ctx);
 	return returnValue;
 }
 
@@ -474,18 +496,16 @@ cleanup:
  * @retval 1 on success.
  * @retval -1 on failure. In this case errorKey will provide a description.
  */
-static int gpgDecrypt (ELEKTRA_UNUSED Plugin * handle, KeySet * data, Key * errorKey)
+static int gpgDecrypt (Plugin * handle, KeySet * data, Key * errorKey)
 {
 	int returnValue = 1; // success
 	Key * k;
 
-	gpgme_ctx_t ctx;
 	gpgme_error_t err;
 
-	err = gpgme_new (&ctx);
-	if (err)
+	gpgme_ctx_t ctx = getGpgmeContext (handle, errorKey);
+	if (ctx == NULL)
 	{
-		ELEKTRA_SET_INSTALLATION_ERRORF (errorKey, "Failed to initialize gpgme. Reason: %s", gpgme_strerror (err));
 		return -1; // at this point nothing has been initialized
 	}
 
@@ -542,7 +562,6 @@ static int gpgDecrypt (ELEKTRA_UNUSED Plugin * handle, KeySet * data, Key * erro
 	}
 
 cleanup:
-	gpgme_release (ctx);
 	return returnValue;
 }
 
@@ -574,9 +593,14 @@ int elektraGpgmeOpen (Plugin * handle, Key * errorKey)
 	return 1; // success
 }
 
-int elektraGpgmeClose (ELEKTRA_UNUSED Plugin * handle, ELEKTRA_UNUSED Key * errorKey)
+int elektraGpgmeClose (Plugin * handle, ELEKTRA_UNUSED Key * errorKey)
 {
-	// at the moment there is nothing to do
+	gpgme_ctx_t ctx = elektraPluginGetData (handle);
+	if (ctx != NULL)
+	{
+		gpgme_release (ctx);
+		elektraPluginSetData (handle, NULL);
+	}
 	return 1; // success
 }
 
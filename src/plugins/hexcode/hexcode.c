@@ -23,40 +23,11 @@
  */
 static inline int elektraHexcodeConvFromHex (char c)
 {
-	if (c == '0')
-		return 0;
-	else if (c == '1')
-		return 1;
-	else if (c == '2')
-		return 2;
-	else if (c == '3')
-		return 3;
-	else if (c == '4')
-		return 4;
-	else if (c == '5')
-		return 5;
-	else if (c == '6')
-		return 6;
-	else if (c == '7')
-		return 7;
-	else if (c == '8')
-		return 8;
-	else if (c == '9')
-		return 9;
-	else if (c == 'a' || c == 'A')
-		return 10;
-	else if (c == 'b' || c == 'B')
-		return 11;
-	else if (c == 'c' || c == 'C')
-		return 12;
-	else if (c == 'd' || c == 'D')
-		return 13;
-	else if (c == 'e' || c == 'E')
-		return 14;
-	else if (c == 'f' || c == 'F')
-		return 15;
-	else
-		return 0; /* Unknown escape char */
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+
+	return 0; /* Unknown escape char */
 }
 
 /** Reads the value of the key and decodes all escaping
@@ -72,28 +43,27 @@ void elektraHexcodeDecode (Key * cur, CHexData * hd)
 
 	if (!val) return;
 
+	const char * in = val;
+	const char * end = val + valsize - 1;
 	size_t out = 0;
-	for (size_t in = 0; in < valsize - 1; ++in)
+	while (in < end)
 	{
-		char c = val[in];
-		char * n = hd->buf + out;
-
-		if (c == hd->escape)
+		/* copy everything up to the next escape sequence in one go */
+		const char * esc = memchr (in, hd->escape, end - in);
+		size_t span = (esc ? esc : end) - in;
+		memcpy (hd->buf + out, in, span);
+		out += span;
+		in += span;
+
+		if (in < end)
 		{
-			in += 2; /* Advance twice (2 hex numbers) */
-			char first = val[in - 1];
-			char second = val[in];
 			int res;
-
-			res = elektraHexcodeConvFromHex (second);
-			res += elektraHexcodeConvFromHex (first) * 16;
-			*n = res & 255;
+			res = elektraHexcodeConvFromHex (in[2]);
+			res += elektraHexcodeConvFromHex (in[1]) * 16;
+			hd->buf[out] = res & 255;
+			++out;
+			in += 3; /* Advance over escape char and 2 hex numbers */
 		}
-		else
-		{
-			*n = c;
-		}
-		++out; /* Only one char is written */
 	}
 
 	hd->buf[out] = 0; // null termination for keyString()
@@ -147,50 +117,8 @@ int elektraHexcodeGet (Plugin * handle, KeySet * returned, Key * parentKey)
 }
 
 
-/**
- * Gives the integer number 0-15 to a corresponding
- * hex character '0'-'9', 'a'-'f' or 'A'-'F'.
- */
-static inline char elektraHexcodeConvToHex (int c)
-{
-	switch (c)
-	{
-	case 0:
-		return '0';
-	case 1:
-		return '1';
-	case 2:
-		return '2';
-	case 3:
-		return '3';
-	case 4:
-		return '4';
-	case 5:
-		return '5';
-	case 6:
-		return '6';
-	case 7:
-		return '7';
-	case 8:
-		return '8';
-	case 9:
-		return '9';
-	case 10:
-		return 'A';
-	case 11:
-		return 'B';
-	case 12:
-		return 'C';
-	case 13:
-		return 'D';
-	case 14:
-		return 'E';
-	case 15:
-		return 'F';
-	default:
-		return '0';
-	}
-}
+/* Gives the hex character '0'-'9' or 'A'-'F' for a corresponding integer number 0-15. */
+static const char elektraHexcodeHexDigits[] = "0123456789ABCDEF";
 
 
 /** Reads the value of the key and encodes it in
@@ -207,27 +135,29 @@ void elektraHexcodeEncode (Key * cur, CHexData * hd)
 
 	if (!val) return;
 
+	const char * in = val;
+	const char * end = val + valsize - 1;
 	size_t out = 0;
-	for (size_t in = 0; in < valsize - 1; ++in)
+	while (in < end)
 	{
-		unsigned char c = val[in];
-
-		// need to encode char?
-		if (hd->hd[c & 255])
+		// find the end of the run that needs no encoding and copy it in one go
+		const char * stop = in;
+		while (stop < end && !hd->hd[(unsigned char) *stop])
+			++stop;
+		memcpy (hd->buf + out, in, stop - in);
+		out += stop - in;
+		in = stop;
+
+		if (in < end)
 		{
+			unsigned char c = *in;
 			hd->buf[out] = hd->escape;
 			out++;
-			hd->buf[out] = elektraHexcodeConvToHex (c / 16);
-			out++;
-			hd->buf[out] = elektraHexcodeConvToHex (c % 16);
+			hd->buf[out] = elektraHexcodeHexDigits[c / 16];
 			out++;
-		}
-		else
-		{
-			// just copy one character
-			hd->buf[out] = val[in];
-			// advance out cursor
+			hd->buf[out] = elektraHexcodeHexDigits[c % 16];
 			out++;
+			++in;
 		}
 	}
 
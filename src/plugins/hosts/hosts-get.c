@@ -10,8 +10,8 @@
 #include "hosts.h"
 #include "keymetaformatting.h"
 
+#include <arpa/inet.h>
 #include <errno.h>
-#include <netdb.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 
@@ -30,24 +30,36 @@ typedef void CommentConstructor (KeySet *, size_t, const char *, const char *);
  */
 static int getAddressFamily (const char * address)
 {
-	struct addrinfo hint;
-	struct addrinfo * info;
-	memset (&hint, 0, sizeof (hint));
-
-	/* no specific family is requested and name lookups are disabled */
-	hint.ai_family = AF_UNSPEC;
-	hint.ai_flags = AI_NUMERICHOST;
+	/* inet_pton does the pure classification getaddrinfo with AI_NUMERICHOST
+	 * would do, without paying for a resolver round per line */
+	struct in_addr ipv4;
+	if (inet_pton (AF_INET, address, &ipv4) == 1)
+	{
+		return AF_INET;
+	}
 
-	int ret = getaddrinfo (address, 0, &hint, &info);
+	/* allow a scope id suffix (e.g. fe80::1%eth0), like getaddrinfo does */
+	char buffer[INET6_ADDRSTRLEN];
+	const char * scope = strchr (address, '%');
+	if (scope != NULL)
+	{
+		size_t length = (size_t) (scope - address);
+		if (length >= sizeof (buffer))
+		{
+			return -1;
+		}
+		memcpy (buffer, address, length);
+		buffer[length] = '\0';
+		address = buffer;
+	}
 
-	if (ret != 0)
+	struct in6_addr ipv6;
+	if (inet_pton (AF_INET6, address, &ipv6) == 1)
 	{
-		return -1;
+		return AF_INET6;
 	}
 
-	int result = info->ai_family;
-	freeaddrinfo (info);
-	return result;
+	return -1;
 }
 
 static void addAddressHierarchy (Key * key, char * fieldbuffer)
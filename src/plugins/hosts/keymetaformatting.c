@@ -39,11 +39,12 @@ ssize_t keySetStringF (Key * key, const char * format, ...)
 		return -1;
 	}
 
-	if (key->data.c && !test_bit (key->flags, KEY_FLAG_MMAP_DATA))
+	if (key->data.c && !test_bit (key->flags, KEY_FLAG_MMAP_DATA) && !test_bit (key->flags, KEY_FLAG_SMALL_DATA))
 	{
 		elektraFree (key->data.c);
 	}
 
+	clear_bit (key->flags, (keyflag_t) (KEY_FLAG_MMAP_DATA | KEY_FLAG_SMALL_DATA));
 	key->data.c = p;
 	key->dataSize = elektraStrLen (key->data.c);
 	set_bit (key->flags, KEY_FLAG_SYNC);
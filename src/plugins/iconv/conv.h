@@ -26,11 +26,22 @@
 #define BACKENDNAME "iconv"
 #define BACKENDVERSION "0.0.1"
 
+typedef struct
+{
+	/* set when the from and to charsets differ */
+	int needsConversion;
+
+	/* set when both charsets encode 7-bit ASCII unchanged */
+	int asciiCompatible;
+} IconvData;
+
 int kdbbNeedsUTF8Conversion (Plugin * handle);
 int kdbbUTF8Engine (Plugin * handle, int direction, char ** string, size_t * inputOutputByteSize);
 
 int elektraIconvGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraIconvSet (Plugin * handle, KeySet * ks, Key * parentKey);
+int elektraIconvOpen (Plugin * handle, Key * errorKey);
+int elektraIconvClose (Plugin * handle, Key * errorKey);
 Plugin * ELEKTRA_PLUGIN_EXPORT;
 
 #endif
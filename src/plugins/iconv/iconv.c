@@ -36,6 +36,57 @@ static inline const char * getTo (Plugin * handle)
 	return to;
 }
 
+/**
+ * Checks if the given data consists of 7-bit ASCII characters only.
+ *
+ * Such data looks the same in every ASCII compatible charset, so it
+ * does not have to run through iconv() at all. The plain byte loop
+ * is easily vectorized by the compiler.
+ *
+ * @retval 1 if all bytes are 7-bit ASCII
+ * @retval 0 otherwise
+ */
+static int isAsciiOnly (const char * data, size_t size)
+{
+	for (size_t i = 0; i < size; ++i)
+	{
+		if (((const unsigned char *) data)[i] >= 0x80) return 0;
+	}
+	return 1;
+}
+
+/**
+ * Checks whether converting from @p fromCharset to @p toCharset leaves
+ * the 7-bit ASCII range untouched, by converting a probe of all 128
+ * characters once.
+ *
+ * @retval 1 if the conversion is the identity on ASCII
+ * @retval 0 otherwise (including charsets unknown to iconv)
+ */
+static int isAsciiTransparent (const char * fromCharset, const char * toCharset)
+{
+	char probe[128];
+	char converted[sizeof (probe)];
+	char * readCursor = probe;
+	char * writeCursor = converted;
+	size_t inputSize = sizeof (probe);
+	size_t outputSize = sizeof (converted);
+
+	for (int i = 0; i < 128; ++i)
+	{
+		probe[i] = (char) i;
+	}
+
+	iconv_t converter = iconv_open (toCharset, fromCharset);
+	if (converter == (iconv_t) (-1)) return 0;
+
+	size_t result = iconv (converter, &readCursor, &inputSize, &writeCursor, &outputSize);
+	iconv_close (converter);
+
+	/* multi-byte charsets like UTF-16 overflow the output buffer and fail here */
+	return result != (size_t) (-1) && outputSize == 0 && memcmp (probe, converted, sizeof (probe)) == 0;
+}
+
 /**
  * Checks if UTF-8 conversion is needed in current context.
  * if nl_langinfo() is not available, no conversion is ever needed.
@@ -158,6 +209,8 @@ int elektraIconvGet (Plugin * handle, KeySet * returned, Key * parentKey)
 			       keyNew ("system:/elektra/modules/iconv/exports", KEY_END),
 			       keyNew ("system:/elektra/modules/iconv/exports/get", KEY_FUNC, elektraIconvGet, KEY_END),
 			       keyNew ("system:/elektra/modules/iconv/exports/set", KEY_FUNC, elektraIconvSet, KEY_END),
+			       keyNew ("system:/elektra/modules/iconv/exports/open", KEY_FUNC, elektraIconvOpen, KEY_END),
+			       keyNew ("system:/elektra/modules/iconv/exports/close", KEY_FUNC, elektraIconvClose, KEY_END),
 #include "readme_iconv.c"
 			       keyNew ("system:/elektra/modules/iconv/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
 		ksAppend (returned, pluginConfig);
@@ -165,11 +218,13 @@ int elektraIconvGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		return 1;
 	}
 
-	if (!kdbbNeedsUTF8Conversion (handle)) return 0;
+	IconvData * data = elektraPluginGetData (handle);
+	if (!data->needsConversion) return 0;
 
 	while ((cur = ksNext (returned)) != 0)
 	{
-		if (keyIsString (cur))
+		/* ASCII-only values are the same in both charsets */
+		if (keyIsString (cur) && !(data->asciiCompatible && isAsciiOnly (keyString (cur), keyGetValueSize (cur))))
 		{
 			/* String or similar type of value */
 			size_t convertedDataSize = keyGetValueSize (cur);
@@ -188,7 +243,7 @@ int elektraIconvGet (Plugin * handle, KeySet * returned, Key * parentKey)
 			elektraFree (convertedData);
 		}
 		const Key * meta = keyGetMeta (cur, "comment");
-		if (meta)
+		if (meta && !(data->asciiCompatible && isAsciiOnly (keyString (meta), keyGetValueSize (meta))))
 		{
 			/* String or similar type of value */
 			size_t convertedDataSize = keyGetValueSize (meta);
@@ -215,13 +270,15 @@ int elektraIconvSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	Key * cur;
 
-	if (!kdbbNeedsUTF8Conversion (handle)) return 0;
+	IconvData * data = elektraPluginGetData (handle);
+	if (!data->needsConversion) return 0;
 
 	ksRewind (returned);
 
 	while ((cur = ksNext (returned)) != 0)
 	{
-		if (keyIsString (cur))
+		/* ASCII-only values are the same in both charsets */
+		if (keyIsString (cur) && !(data->asciiCompatible && isAsciiOnly (keyString (cur), keyGetValueSize (cur))))
 		{
 			/* String or similar type of value */
 			size_t convertedDataSize = keyGetValueSize (cur);
@@ -241,7 +298,7 @@ int elektraIconvSet (Plugin * handle, KeySet * returned, Key * parentKey)
 			elektraFree (convertedData);
 		}
 		const Key * meta = keyGetMeta (cur, "comment");
-		if (meta)
+		if (meta && !(data->asciiCompatible && isAsciiOnly (keyString (meta), keyGetValueSize (meta))))
 		{
 			/* String or similar type of value */
 			size_t convertedDataSize = keyGetValueSize (meta);
@@ -265,12 +322,35 @@ int elektraIconvSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	return 1; /* success */
 }
 
+int elektraIconvOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	IconvData * data = elektraMalloc (sizeof (IconvData));
+
+	/* negotiate the fast paths once per handle instead of on every conversion */
+	data->needsConversion = strcmp (getFrom (handle), getTo (handle)) != 0;
+	data->asciiCompatible = !data->needsConversion || (isAsciiTransparent (getFrom (handle), getTo (handle)) &&
+							   isAsciiTransparent (getTo (handle), getFrom (handle)));
+
+	elektraPluginSetData (handle, data);
+
+	return 0;
+}
+
+int elektraIconvClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	elektraFree (elektraPluginGetData (handle));
+
+	return 0;
+}
+
 Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport(BACKENDNAME,
 		ELEKTRA_PLUGIN_GET,	&elektraIconvGet,
 		ELEKTRA_PLUGIN_SET,	&elektraIconvSet,
+		ELEKTRA_PLUGIN_OPEN,	&elektraIconvOpen,
+		ELEKTRA_PLUGIN_CLOSE,	&elektraIconvClose,
 		ELEKTRA_PLUGIN_END);
 }
 
@@ -12,6 +12,7 @@
 #include <kdb.h>
 #include <kdbassert.h>
 #include <kdbhelper.h>
+#include <kdbio.h>
 #include <kdblogger.h>
 #include <kdbnotificationinternal.h>
 
@@ -28,13 +29,29 @@ struct _KeyRegistration
 	char * name;
 	char * lastValue;
 	int sameOrBelow;
+	int indexed;
+	int matched;
 	int freeContext;
 	ElektraNotificationChangeCallback callback;
 	void * context;
 	struct _KeyRegistration * next;
+	struct _KeyRegistration * nextSameName;
 };
 typedef struct _KeyRegistration KeyRegistration;
 
+/**
+ * Structure for a queued notification callback invocation
+ * @internal
+ */
+struct _PendingNotification
+{
+	Key * key;
+	ElektraNotificationChangeCallback callback;
+	void * context;
+	struct _PendingNotification * next;
+};
+typedef struct _PendingNotification PendingNotification;
+
 /**
  * Structure for internal plugin state
  * @internal
@@ -43,11 +60,225 @@ struct _PluginState
 {
 	KeyRegistration * head;
 	KeyRegistration * last;
+	KeySet * belowIndex;
 	ElektraNotificationConversionErrorCallback conversionErrorCallback;
 	void * conversionErrorCallbackContext;
+	ElektraIoInterface * ioBinding;
+	ElektraIoIdleOperation * dispatchIdle;
+	ElektraIoTimerOperation * dispatchTimer;
+	KeySet * priorityKeys;
+	PendingNotification * pendingHead;
+	PendingNotification * pendingLast;
+	PendingNotification * priorityHead;
+	PendingNotification * priorityLast;
 };
 typedef struct _PluginState PluginState;
 
+static int checkKeyIsBelowOrSame (Key * key, Key * check);
+
+/**
+ * @internal
+ * Invoke and free a list of queued notification callbacks.
+ *
+ * @param pending head of the pending notification list
+ */
+static void elektraInternalnotificationDispatchList (PendingNotification * pending)
+{
+	while (pending != NULL)
+	{
+		PendingNotification * next = pending->next;
+		pending->callback (pending->key, pending->context);
+		keyDel (pending->key);
+		elektraFree (pending);
+		pending = next;
+	}
+}
+
+/**
+ * @internal
+ * Dispatch queued notification callbacks.
+ *
+ * Called by the I/O binding as idle operation on the event loop, i.e.
+ * outside of kdbGet() or kdbSet(). With a coalescing window configured
+ * only priority notifications are dispatched here, the rest stays
+ * queued until the window timer fires.
+ *
+ * @param idleOp idle operation
+ */
+static void elektraInternalnotificationDispatchPending (ElektraIoIdleOperation * idleOp)
+{
+	PluginState * pluginState = elektraIoIdleGetData (idleOp);
+	ELEKTRA_NOT_NULL (pluginState);
+
+	PendingNotification * priority = pluginState->priorityHead;
+	pluginState->priorityHead = pluginState->priorityLast = NULL;
+
+	PendingNotification * pending = NULL;
+	if (pluginState->dispatchTimer == NULL)
+	{
+		pending = pluginState->pendingHead;
+		pluginState->pendingHead = pluginState->pendingLast = NULL;
+	}
+
+	// stop the idle operation before invoking callbacks,
+	// so that callbacks may queue new notifications
+	elektraIoIdleSetEnabled (idleOp, 0);
+	elektraIoBindingUpdateIdle (idleOp);
+
+	elektraInternalnotificationDispatchList (priority);
+	elektraInternalnotificationDispatchList (pending);
+}
+
+/**
+ * @internal
+ * Dispatch all queued notification callbacks after a quiet window.
+ *
+ * Called by the I/O binding when the coalescing timer fires, i.e. after
+ * no further changes arrived for the configured window.
+ *
+ * @param timerOp timer operation
+ */
+static void elektraInternalnotificationDispatchCoalesced (ElektraIoTimerOperation * timerOp)
+{
+	PluginState * pluginState = elektraIoTimerGetData (timerOp);
+	ELEKTRA_NOT_NULL (pluginState);
+
+	PendingNotification * priority = pluginState->priorityHead;
+	pluginState->priorityHead = pluginState->priorityLast = NULL;
+	PendingNotification * pending = pluginState->pendingHead;
+	pluginState->pendingHead = pluginState->pendingLast = NULL;
+
+	elektraIoTimerSetEnabled (timerOp, 0);
+	elektraIoBindingUpdateTimer (timerOp);
+
+	elektraInternalnotificationDispatchList (priority);
+	elektraInternalnotificationDispatchList (pending);
+}
+
+/**
+ * @internal
+ * Check if a changed key belongs to a configured priority class.
+ *
+ * @param pluginState internal plugin data structure
+ * @param key         changed key
+ * @retval 1 if the key is same or below a priority key
+ * @retval 0 otherwise
+ */
+static int elektraInternalnotificationIsPriority (PluginState * pluginState, Key * key)
+{
+	if (pluginState->priorityKeys == NULL) return 0;
+
+	Key * current;
+	ksRewind (pluginState->priorityKeys);
+	while ((current = ksNext (pluginState->priorityKeys)) != NULL)
+	{
+		if (checkKeyIsBelowOrSame (current, key))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @internal
+ * Queue a notification callback for dispatching on the event loop.
+ *
+ * Takes ownership of @p key.
+ *
+ * With a coalescing window configured, notifications for the same
+ * registration and key replace their still queued predecessor and
+ * (re)start the window timer, so a bulk import results in a single
+ * delivery per key once the changes settle. Notifications for keys in a
+ * priority class bypass the window and are dispatched on the next event
+ * loop iteration.
+ *
+ * @param pluginState internal plugin data structure
+ * @param key         changed key (ownership is transferred)
+ * @param callback    callback for changes
+ * @param context     context for callback
+ */
+static void elektraInternalnotificationEnqueue (PluginState * pluginState, Key * key, ElektraNotificationChangeCallback callback,
+						void * context)
+{
+	int priority = pluginState->dispatchTimer != NULL && elektraInternalnotificationIsPriority (pluginState, key);
+
+	if (!priority)
+	{
+		// coalesce with a notification for the same registration that is still queued
+		for (PendingNotification * current = pluginState->pendingHead; current != NULL; current = current->next)
+		{
+			if (current->callback == callback && current->context == context &&
+			    elektraStrCmp (keyName (current->key), keyName (key)) == 0)
+			{
+				keyDel (current->key);
+				current->key = key;
+				if (pluginState->dispatchTimer != NULL)
+				{
+					// restart the quiet window
+					elektraIoTimerSetEnabled (pluginState->dispatchTimer, 0);
+					elektraIoBindingUpdateTimer (pluginState->dispatchTimer);
+					elektraIoTimerSetEnabled (pluginState->dispatchTimer, 1);
+					elektraIoBindingUpdateTimer (pluginState->dispatchTimer);
+				}
+				return;
+			}
+		}
+	}
+
+	PendingNotification * pending = elektraMalloc (sizeof *pending);
+	if (pending == NULL)
+	{
+		// fall back to synchronous dispatching
+		callback (key, context);
+		keyDel (key);
+		return;
+	}
+	pending->key = key;
+	pending->callback = callback;
+	pending->context = context;
+	pending->next = NULL;
+
+	if (priority)
+	{
+		if (pluginState->priorityHead == NULL)
+		{
+			pluginState->priorityHead = pluginState->priorityLast = pending;
+		}
+		else
+		{
+			pluginState->priorityLast->next = pending;
+			pluginState->priorityLast = pending;
+		}
+	}
+	else
+	{
+		if (pluginState->pendingHead == NULL)
+		{
+			pluginState->pendingHead = pluginState->pendingLast = pending;
+		}
+		else
+		{
+			pluginState->pendingLast->next = pending;
+			pluginState->pendingLast = pending;
+		}
+	}
+
+	if (!priority && pluginState->dispatchTimer != NULL)
+	{
+		// (re)start the quiet window instead of dispatching immediately
+		elektraIoTimerSetEnabled (pluginState->dispatchTimer, 0);
+		elektraIoBindingUpdateTimer (pluginState->dispatchTimer);
+		elektraIoTimerSetEnabled (pluginState->dispatchTimer, 1);
+		elektraIoBindingUpdateTimer (pluginState->dispatchTimer);
+	}
+	else
+	{
+		elektraIoIdleSetEnabled (pluginState->dispatchIdle, 1);
+		elektraIoBindingUpdateIdle (pluginState->dispatchIdle);
+	}
+}
+
 /**
  * @see kdbnotificationinternal.h ::ElektraNotificationSetConversionErrorCallback
  */
@@ -195,11 +426,14 @@ static KeyRegistration * elektraInternalnotificationAddNewRegistration (PluginSt
 		return NULL;
 	}
 	item->next = NULL;
+	item->nextSameName = NULL;
 	item->lastValue = NULL;
 	item->name = elektraStrDup (keyName (key));
 	item->callback = callback;
 	item->context = context;
 	item->sameOrBelow = 0;
+	item->indexed = 0;
+	item->matched = 0;
 	item->freeContext = freeContext;
 
 	if (pluginState->head == NULL)
@@ -217,6 +451,43 @@ static KeyRegistration * elektraInternalnotificationAddNewRegistration (PluginSt
 	return item;
 }
 
+/**
+ * @internal
+ * Add a sameOrBelow registration to the name index.
+ *
+ * The index maps fully qualified registration names to their registrations
+ * (several registrations for the same name are chained via nextSameName), so
+ * elektraInternalnotificationUpdateRegisteredKeys() can find the
+ * registrations interested in a changed key by walking the ancestors of its
+ * name instead of scanning all registrations per changed key.
+ *
+ * Registrations with cascading names stay on the linear scan path: their
+ * matching rules (see checkKeyIsSame()) cannot be expressed as a name lookup.
+ *
+ * @param pluginState  internal plugin data structure
+ * @param registration registration to index
+ */
+static void elektraInternalnotificationIndexRegistration (PluginState * pluginState, KeyRegistration * registration)
+{
+	if (registration->name[0] == '/')
+	{
+		return;
+	}
+
+	Key * indexKey = ksLookupByName (pluginState->belowIndex, registration->name, 0);
+	if (indexKey == NULL)
+	{
+		indexKey = keyNew (registration->name, KEY_BINARY, KEY_SIZE, sizeof (registration), KEY_VALUE, &registration, KEY_END);
+		ksAppendKey (pluginState->belowIndex, indexKey);
+	}
+	else
+	{
+		registration->nextSameName = *(KeyRegistration **) keyValue (indexKey);
+		keySetBinary (indexKey, &registration, sizeof (registration));
+	}
+	registration->indexed = 1;
+}
+
 /**
  * @internal
  * Check if a key set contains a key that is same or below a given key.
@@ -254,6 +525,32 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 	PluginState * pluginState = elektraPluginGetData (plugin);
 	ELEKTRA_ASSERT (pluginState != NULL, "plugin state was not initialized properly");
 
+	// find interested indexed (fully qualified) sameOrBelow registrations with
+	// one pass over the changed keys: each changed key looks up the ancestors
+	// of its name in the index instead of every registration scanning all keys
+	if (ksGetSize (pluginState->belowIndex) > 0)
+	{
+		Key * cur;
+		ksRewind (keySet);
+		while ((cur = ksNext (keySet)) != NULL)
+		{
+			Key * lookup = keyDup (cur, KEY_CP_NAME);
+			do
+			{
+				Key * indexKey = ksLookup (pluginState->belowIndex, lookup, 0);
+				if (indexKey != NULL)
+				{
+					for (KeyRegistration * found = *(KeyRegistration **) keyValue (indexKey); found != NULL;
+					     found = found->nextSameName)
+					{
+						found->matched = 1;
+					}
+				}
+			} while (keySetBaseName (lookup, NULL) > 0);
+			keyDel (lookup);
+		}
+	}
+
 	KeyRegistration * registeredKey = pluginState->head;
 	while (registeredKey != NULL)
 	{
@@ -262,7 +559,9 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 		if (registeredKey->sameOrBelow)
 		{
 			Key * checkKey = keyNew (registeredKey->name, KEY_END);
-			if (keySetContainsSameOrBelow (checkKey, keySet))
+			int contained = registeredKey->indexed ? registeredKey->matched : keySetContainsSameOrBelow (checkKey, keySet);
+			registeredKey->matched = 0;
+			if (contained)
 			{
 				changed = 1;
 				key = checkKey;
@@ -313,10 +612,20 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 
 			// Invoke callback
 			ElektraNotificationChangeCallback callback = *(ElektraNotificationChangeCallback) registeredKey->callback;
-			callback (key, registeredKey->context);
-			if (registeredKey->sameOrBelow)
+			if (pluginState->dispatchIdle != NULL)
+			{
+				// dispatch asynchronously on the event loop; the key set may
+				// change before the callback runs, so the key is duplicated
+				Key * dispatchKey = registeredKey->sameOrBelow ? key : keyDup (key, KEY_CP_ALL);
+				elektraInternalnotificationEnqueue (pluginState, dispatchKey, callback, registeredKey->context);
+			}
+			else
 			{
-				keyDel (key);
+				callback (key, registeredKey->context);
+				if (registeredKey->sameOrBelow)
+				{
+					keyDel (key);
+				}
 			}
 		}
 
@@ -495,6 +804,7 @@ int elektraInternalnotificationRegisterCallbackSameOrBelow (Plugin * handle, Key
 		return 0;
 	}
 	registeredKey->sameOrBelow = 1;
+	elektraInternalnotificationIndexRegistration (pluginState, registeredKey);
 
 	return 1;
 }
@@ -609,8 +919,17 @@ int elektraInternalnotificationOpen (Plugin * handle, Key * parentKey ELEKTRA_UN
 		// Initialize list pointers for registered keys
 		pluginState->head = NULL;
 		pluginState->last = NULL;
+		pluginState->belowIndex = ksNew (0, KS_END);
 		pluginState->conversionErrorCallback = NULL;
 		pluginState->conversionErrorCallbackContext = NULL;
+		pluginState->ioBinding = NULL;
+		pluginState->dispatchIdle = NULL;
+		pluginState->dispatchTimer = NULL;
+		pluginState->priorityKeys = NULL;
+		pluginState->pendingHead = NULL;
+		pluginState->pendingLast = NULL;
+		pluginState->priorityHead = NULL;
+		pluginState->priorityLast = NULL;
 	}
 
 	KeySet * config = elektraPluginGetConfig (handle);
@@ -621,6 +940,94 @@ int elektraInternalnotificationOpen (Plugin * handle, Key * parentKey ELEKTRA_UN
 		ksAppendKey (global,
 			     keyNew ("system:/elektra/notification/callback", KEY_FUNC, elektraInternalnotificationDoUpdate, KEY_END));
 
+		if (pluginState->ioBinding == NULL)
+		{
+			Key * ioBindingKey = ksLookupByName (global, "system:/elektra/io/binding", 0);
+			const void * bindingPtr = keyValue (ioBindingKey);
+			ElektraIoInterface * binding = bindingPtr == NULL ? NULL : *(ElektraIoInterface **) bindingPtr;
+
+			if (binding != NULL)
+			{
+				// with an I/O binding present, callbacks are dispatched on the event loop
+				ElektraIoIdleOperation * dispatchIdle =
+					elektraIoNewIdleOperation (0, elektraInternalnotificationDispatchPending, pluginState);
+				if (dispatchIdle != NULL && elektraIoBindingAddIdle (binding, dispatchIdle))
+				{
+					pluginState->ioBinding = binding;
+					pluginState->dispatchIdle = dispatchIdle;
+				}
+				else
+				{
+					ELEKTRA_LOG_WARNING ("could not add idle operation. dispatching synchronously");
+					if (dispatchIdle != NULL)
+					{
+						elektraFree (dispatchIdle);
+					}
+				}
+			}
+		}
+
+		if (pluginState->ioBinding != NULL && pluginState->dispatchTimer == NULL)
+		{
+			// optional coalescing window: deliver once per quiet window instead of per change
+			Key * coalescingKey = ksLookupByName (config, "/coalescing", 0);
+			if (coalescingKey != NULL)
+			{
+				char * end;
+				int prevErrno = errno;
+				errno = 0;
+				unsigned long interval = strtoul (keyString (coalescingKey), &end, 10);
+				if (*end == '\0' && errno != ERANGE && interval > 0)
+				{
+					ElektraIoTimerOperation * dispatchTimer = elektraIoNewTimerOperation (
+						(unsigned int) interval, 0, elektraInternalnotificationDispatchCoalesced, pluginState);
+					if (dispatchTimer != NULL && elektraIoBindingAddTimer (pluginState->ioBinding, dispatchTimer))
+					{
+						pluginState->dispatchTimer = dispatchTimer;
+					}
+					else
+					{
+						ELEKTRA_LOG_WARNING ("could not add timer operation. coalescing disabled");
+						if (dispatchTimer != NULL)
+						{
+							elektraFree (dispatchTimer);
+						}
+					}
+				}
+				else
+				{
+					ELEKTRA_LOG_WARNING ("invalid coalescing interval \"%s\" ignored", keyString (coalescingKey));
+				}
+				errno = prevErrno;
+			}
+		}
+
+		if (pluginState->dispatchTimer != NULL && pluginState->priorityKeys == NULL)
+		{
+			// keys below a priority key bypass the coalescing window
+			Key * priorityParent = ksLookupByName (config, "/priority", 0);
+			if (priorityParent != NULL)
+			{
+				pluginState->priorityKeys = ksNew (0, KS_END);
+				Key * current;
+				ksRewind (config);
+				while ((current = ksNext (config)) != NULL)
+				{
+					if (!keyIsBelow (priorityParent, current)) continue;
+
+					Key * priorityKey = keyNew (keyString (current), KEY_END);
+					if (priorityKey != NULL)
+					{
+						ksAppendKey (pluginState->priorityKeys, priorityKey);
+					}
+					else
+					{
+						ELEKTRA_LOG_WARNING ("invalid priority key name \"%s\" ignored", keyString (current));
+					}
+				}
+			}
+		}
+
 		Key * contextKey = ksLookupByName (config, "/context", 0);
 		if (contextKey != NULL)
 		{
@@ -648,6 +1055,52 @@ int elektraInternalnotificationClose (Plugin * handle, Key * parentKey ELEKTRA_U
 	PluginState * pluginState = elektraPluginGetData (handle);
 	if (pluginState != NULL)
 	{
+		// Discard pending notifications and detach from the I/O binding
+		PendingNotification * pending = pluginState->pendingHead;
+		while (pending != NULL)
+		{
+			PendingNotification * nextPending = pending->next;
+			keyDel (pending->key);
+			elektraFree (pending);
+			pending = nextPending;
+		}
+		pluginState->pendingHead = pluginState->pendingLast = NULL;
+
+		pending = pluginState->priorityHead;
+		while (pending != NULL)
+		{
+			PendingNotification * nextPending = pending->next;
+			keyDel (pending->key);
+			elektraFree (pending);
+			pending = nextPending;
+		}
+		pluginState->priorityHead = pluginState->priorityLast = NULL;
+
+		if (pluginState->dispatchIdle != NULL)
+		{
+			if (!elektraIoBindingRemoveIdle (pluginState->dispatchIdle))
+			{
+				ELEKTRA_LOG_WARNING ("could not remove idle operation");
+			}
+			elektraFree (pluginState->dispatchIdle);
+		}
+
+		if (pluginState->dispatchTimer != NULL)
+		{
+			if (!elektraIoBindingRemoveTimer (pluginState->dispatchTimer))
+			{
+				ELEKTRA_LOG_WARNING ("could not remove timer operation");
+			}
+			elektraFree (pluginState->dispatchTimer);
+		}
+
+		if (pluginState->priorityKeys != NULL)
+		{
+			ksDel (pluginState->priorityKeys);
+		}
+
+		ksDel (pluginState->belowIndex);
+
 		// Free registrations
 		KeyRegistration * current = pluginState->head;
 		KeyRegistration * next;
@@ -7,77 +7,98 @@
  *
  */
 
+#include <ctype.h>
 #include <kdberrors.h>
-#include <regex.h>
+#include <stdbool.h>
 #include <stdio.h>
 
 #include "ipaddr.h"
 
+/* the addresses are parsed with direct character scans instead of the
+ * POSIX regexes used previously: those were recompiled for every checked
+ * key, which dominated validation time on keysets with many addresses */
+
 static int validateIPv4 (const char * addr)
 {
 	if (!addr) return 0;
-	unsigned int a, b, c, d;
-	a = b = c = d = 0;
-	const char * regexString = "^([0-9]{1,3}\\.){3}([0-9]{1,3})$";
-	regex_t regex;
-	regmatch_t offsets;
-	int ret = regcomp (&regex, regexString, REG_NOSUB | REG_EXTENDED | REG_NEWLINE);
-	if (ret) return -1;
-	ret = regexec (&regex, addr, 1, &offsets, 0);
-	regfree (&regex);
-	if (!ret)
+	int octets = 0;
+	const char * ptr = addr;
+	while (1)
 	{
-		sscanf (addr, "%u.%u.%u.%u", &a, &b, &c, &d);
-		if (a > 255 || b > 255 || c > 255 || d > 255)
+		if (!isdigit ((unsigned char) *ptr)) return 0;
+		unsigned int value = 0;
+		int digits = 0;
+		while (isdigit ((unsigned char) *ptr) && digits < 3)
 		{
-			return 0;
+			value = value * 10 + (unsigned int) (*ptr - '0');
+			++ptr;
+			++digits;
 		}
-		else
-			return 1;
+		if (isdigit ((unsigned char) *ptr)) return 0;
+		if (value > 255) return 0;
+		++octets;
+		if (*ptr == '\0') break;
+		if (*ptr != '.') return 0;
+		++ptr;
 	}
-	return 0;
+	return octets == 4;
 }
 
 static int validateIPv6 (const char * addr)
 {
 	if (!addr) return 0;
-	const char * regexString =
-		"(^((:(([0-9A-Fa-f]{0,4}):){1,6}(([0-9A-Fa-f]{1,4})))|(([0-9A-Fa-f]{1,4})(:([0-9A-Fa-f]{0,4})){1,7}))$)|(^((:(([0-9A-Fa-f]{"
-		"0,4}):){1,4}(([0-9A-Fa-f]{1,4})))|(([0-9A-Fa-f]{1,4})(:([0-9A-Fa-f]{0,4})){1,5}))((([0-9]{1,3}\\.){3})([0-9]{1,3}))$)";
-	regex_t regex;
-	regmatch_t offsets;
-	int ret = regcomp (&regex, regexString, REG_NOSUB | REG_EXTENDED | REG_NEWLINE);
-	if (ret) return -1;
-	ret = regexec (&regex, addr, 1, &offsets, 0);
-	regfree (&regex);
-	if (ret)
-		return 0;
-	else
+	int groups = 0;
+	bool doubleColon = false;
+	const char * ptr = addr;
+
+	if (*ptr == ':')
+	{
+		if (ptr[1] != ':') return 0;
+		doubleColon = true;
+		ptr += 2;
+		if (*ptr == '\0') return 1;
+	}
+
+	while (*ptr)
 	{
-		char * ptr = (char *) addr;
-		int count = 0;
-		while (*ptr)
+		const char * start = ptr;
+		int hexDigits = 0;
+		while (isxdigit ((unsigned char) *ptr))
 		{
-			if (*ptr == ':') ++count;
 			++ptr;
+			++hexDigits;
 		}
-		if (count > 7)
+
+		if (*ptr == '.')
 		{
-			return 0;
+			/* the remainder must be an embedded IPv4 address,
+			 * which counts as two 16-bit groups */
+			if (!validateIPv4 (start)) return 0;
+			groups += 2;
+			break;
 		}
-		else if (count < 7)
+
+		if (hexDigits == 0 || hexDigits > 4) return 0;
+		++groups;
+		if (*ptr == '\0') break;
+		if (*ptr != ':') return 0;
+		++ptr;
+		if (*ptr == ':')
 		{
-			if (!strstr (addr, "::")) return 0;
+			if (doubleColon) return 0;
+			doubleColon = true;
+			++ptr;
 		}
-		if (strchr (addr, '.'))
+		else if (*ptr == '\0')
 		{
-			char * ipv4ptr = strrchr (addr, ':');
-			++ipv4ptr;
-			ret = validateIPv4 (ipv4ptr);
-			if (!ret) return 0;
+			// trailing single colon
+			return 0;
 		}
-		return 1;
 	}
+
+	// "::" has to stand for at least one group of zeros
+	if (doubleColon) return groups <= 7;
+	return groups == 8;
 }
 
 static int validateKey (Key * key, Key * parentKey)
@@ -105,11 +126,6 @@ static int validateKey (Key * key, Key * parentKey)
 		ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Validation of key %s with value %s failed", keyName (key),
 							keyString (key));
 	}
-	else if (rc == -1)
-	{
-		ELEKTRA_SET_OUT_OF_MEMORY_ERROR (parentKey);
-		rc = 0;
-	}
 
 	return rc;
 }
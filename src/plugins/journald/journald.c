@@ -11,13 +11,160 @@
 #include "kdbconfig.h"
 #endif
 
+#include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <systemd/sd-journal.h>
 #include <unistd.h>
 
+#include <kdbhelper.h>
+
 #include "journald.h"
 
-int elektraJournaldGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey ELEKTRA_UNUSED)
+#define MESSAGE_ID_NOTICE "fc65eab25c18463f97e4f9b61ea31eae"
+#define MESSAGE_ID_ERROR "fb3928ea453048649c61d62619847ef6"
+
+#define PRIORITY_NOTICE (5)
+#define PRIORITY_ERROR (3)
+
+static void sendRecord (const char * message, const char * messageId, int priority)
+{
+	sd_journal_send ("MESSAGE=%s", message, "MESSAGE_ID=%s", messageId, "PRIORITY=%i", priority, "HOME=%s", getenv ("HOME"),
+			 "USER=%s", getenv ("USER"), "PAGE_SIZE=%li", sysconf (_SC_PAGESIZE), "N_CPUS=%li",
+			 sysconf (_SC_NPROCESSORS_ONLN), NULL);
+}
+
+/**
+ * Drain the record ring until elektraJournaldClose() requests shutdown.
+ */
+static void * logRecords (void * arg)
+{
+	JournaldData * data = arg;
+
+	pthread_mutex_lock (&data->lock);
+	for (;;)
+	{
+		while (data->tail == data->head && !data->stop)
+		{
+			pthread_cond_wait (&data->newRecord, &data->lock);
+		}
+		if (data->tail == data->head) break;
+
+		JournaldRecord record = data->records[data->tail];
+		data->tail = (data->tail + 1) % ELEKTRA_JOURNALD_RING_SIZE;
+
+		// emit without holding the lock, the journal sink may block
+		pthread_mutex_unlock (&data->lock);
+		sendRecord (record.message, record.messageId, record.priority);
+		elektraFree (record.message);
+		pthread_mutex_lock (&data->lock);
+	}
+	pthread_mutex_unlock (&data->lock);
+
+	return NULL;
+}
+
+/**
+ * Log a record either directly or via the record ring.
+ *
+ * With async enabled the message is formatted and appended to the ring, so
+ * the commit path does not wait for the journal sink. Logging is best effort:
+ * when the ring is full the record is dropped.
+ */
+static void logRecord (Plugin * handle, int priority, const char * messageId, const char * format, ...)
+{
+	va_list args;
+	va_start (args, format);
+
+	va_list lengthArgs;
+	va_copy (lengthArgs, args);
+	int length = vsnprintf (NULL, 0, format, lengthArgs);
+	va_end (lengthArgs);
+
+	if (length < 0)
+	{
+		va_end (args);
+		return;
+	}
+
+	char * message = elektraMalloc (length + 1);
+	vsnprintf (message, length + 1, format, args);
+	va_end (args);
+
+	JournaldData * data = elektraPluginGetData (handle);
+	if (data && data->async)
+	{
+		pthread_mutex_lock (&data->lock);
+		size_t next = (data->head + 1) % ELEKTRA_JOURNALD_RING_SIZE;
+		if (next == data->tail)
+		{
+			elektraFree (message);
+		}
+		else
+		{
+			data->records[data->head].message = message;
+			data->records[data->head].messageId = messageId;
+			data->records[data->head].priority = priority;
+			data->head = next;
+			pthread_cond_signal (&data->newRecord);
+		}
+		pthread_mutex_unlock (&data->lock);
+	}
+	else
+	{
+		sendRecord (message, messageId, priority);
+		elektraFree (message);
+	}
+}
+
+int elektraJournaldOpen (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
+{
+	JournaldData * data = elektraMalloc (sizeof (JournaldData));
+	memset (data, 0, sizeof (JournaldData));
+	data->async = strncmp (keyString (ksLookupByName (elektraPluginGetConfig (handle), "/async", 0)), "1", 1) == 0;
+
+	if (data->async)
+	{
+		pthread_mutex_init (&data->lock, NULL);
+		pthread_cond_init (&data->newRecord, NULL);
+		if (pthread_create (&data->thread, NULL, logRecords, data) != 0)
+		{
+			// fall back to synchronous logging
+			pthread_cond_destroy (&data->newRecord);
+			pthread_mutex_destroy (&data->lock);
+			data->async = 0;
+		}
+	}
+
+	elektraPluginSetData (handle, data);
+
+	return 0; /* success */
+}
+
+int elektraJournaldClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
+{
+	JournaldData * data = elektraPluginGetData (handle);
+	if (data)
+	{
+		if (data->async)
+		{
+			// wake the logger thread and wait until the ring is drained
+			pthread_mutex_lock (&data->lock);
+			data->stop = 1;
+			pthread_cond_signal (&data->newRecord);
+			pthread_mutex_unlock (&data->lock);
+			pthread_join (data->thread, NULL);
+			pthread_cond_destroy (&data->newRecord);
+			pthread_mutex_destroy (&data->lock);
+		}
+		elektraFree (data);
+		elektraPluginSetData (handle, NULL);
+	}
+
+	return 0; /* success */
+}
+
+int elektraJournaldGet (Plugin * handle, KeySet * returned, Key * parentKey ELEKTRA_UNUSED)
 {
 	if (!strcmp (keyName (parentKey), "system:/elektra/modules/journald"))
 	{
@@ -27,6 +174,8 @@ int elektraJournaldGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key *
 			n = ksNew (30,
 				   keyNew ("system:/elektra/modules/journald", KEY_VALUE, "journald plugin waits for your orders", KEY_END),
 				   keyNew ("system:/elektra/modules/journald/exports", KEY_END),
+				   keyNew ("system:/elektra/modules/journald/exports/open", KEY_FUNC, elektraJournaldOpen, KEY_END),
+				   keyNew ("system:/elektra/modules/journald/exports/close", KEY_FUNC, elektraJournaldClose, KEY_END),
 				   keyNew ("system:/elektra/modules/journald/exports/get", KEY_FUNC, elektraJournaldGet, KEY_END),
 				   keyNew ("system:/elektra/modules/journald/exports/set", KEY_FUNC, elektraJournaldSet, KEY_END),
 				   keyNew ("system:/elektra/modules/journald/exports/error", KEY_FUNC, elektraJournaldError, KEY_END),
@@ -38,30 +187,23 @@ int elektraJournaldGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key *
 
 	if (strncmp (keyString (ksLookupByName (elektraPluginGetConfig (handle), "/log/get", 0)), "1", 1) == 0)
 	{
-		sd_journal_send ("MESSAGE=loading configuration %s", keyName (parentKey), "MESSAGE_ID=fc65eab25c18463f97e4f9b61ea31eae",
-				 "PRIORITY=5", /* notice priority */
-				 "HOME=%s", getenv ("HOME"), "USER=%s", getenv ("USER"), "PAGE_SIZE=%li", sysconf (_SC_PAGESIZE),
-				 "N_CPUS=%li", sysconf (_SC_NPROCESSORS_ONLN), NULL);
+		logRecord (handle, PRIORITY_NOTICE, MESSAGE_ID_NOTICE, "loading configuration %s", keyName (parentKey));
 	}
 
 	return 1;
 }
 
-int elektraJournaldSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraJournaldSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
-	sd_journal_send ("MESSAGE=committed configuration %s with %zd keys", keyName (parentKey), ksGetSize (returned),
-			 "MESSAGE_ID=fc65eab25c18463f97e4f9b61ea31eae", "PRIORITY=5", /* notice priority */
-			 "HOME=%s", getenv ("HOME"), "USER=%s", getenv ("USER"), "PAGE_SIZE=%li", sysconf (_SC_PAGESIZE), "N_CPUS=%li",
-			 sysconf (_SC_NPROCESSORS_ONLN), NULL);
+	logRecord (handle, PRIORITY_NOTICE, MESSAGE_ID_NOTICE, "committed configuration %s with %zd keys", keyName (parentKey),
+		   ksGetSize (returned));
 	return 1;
 }
 
-int elektraJournaldError (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraJournaldError (Plugin * handle, KeySet * returned, Key * parentKey)
 {
-	sd_journal_send ("MESSAGE=rollback configuration %s with %zd keys", keyName (parentKey), ksGetSize (returned),
-			 "MESSAGE_ID=fb3928ea453048649c61d62619847ef6", "PRIORITY=3", /* error priority */
-			 "HOME=%s", getenv ("HOME"), "USER=%s", getenv ("USER"), "PAGE_SIZE=%li", sysconf (_SC_PAGESIZE), "N_CPUS=%li",
-			 sysconf (_SC_NPROCESSORS_ONLN), NULL);
+	logRecord (handle, PRIORITY_ERROR, MESSAGE_ID_ERROR, "rollback configuration %s with %zd keys", keyName (parentKey),
+		   ksGetSize (returned));
 
 	return 1; /* success */
 }
@@ -70,6 +212,8 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport ("journald",
+		ELEKTRA_PLUGIN_OPEN,	&elektraJournaldOpen,
+		ELEKTRA_PLUGIN_CLOSE,	&elektraJournaldClose,
 		ELEKTRA_PLUGIN_GET,	&elektraJournaldGet,
 		ELEKTRA_PLUGIN_SET,	&elektraJournaldSet,
 		ELEKTRA_PLUGIN_ERROR,	&elektraJournaldError,
@@ -11,7 +11,35 @@
 #define ELEKTRA_PLUGIN_JOURNALD_H
 
 #include <kdbplugin.h>
+#include <pthread.h>
 
+/** number of slots in the asynchronous record ring */
+#define ELEKTRA_JOURNALD_RING_SIZE (256)
+
+typedef struct
+{
+	char * message;
+	const char * messageId; /*!< static string, not freed */
+	int priority;
+} JournaldRecord;
+
+typedef struct
+{
+	int async; /*!< records are emitted by the logger thread */
+
+	/** ring of records, filled by the commit path and drained by the logger thread */
+	JournaldRecord records[ELEKTRA_JOURNALD_RING_SIZE];
+	size_t head; /*!< next slot the producer fills */
+	size_t tail; /*!< next slot the logger thread drains */
+
+	pthread_mutex_t lock;
+	pthread_cond_t newRecord;
+	pthread_t thread;
+	int stop; /*!< logger thread exits once the ring is drained */
+} JournaldData;
+
+int elektraJournaldOpen (Plugin * handle, Key * parentKey);
+int elektraJournaldClose (Plugin * handle, Key * parentKey);
 int elektraJournaldGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraJournaldSet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraJournaldError (Plugin * handle, KeySet * ks, Key * parentKey);
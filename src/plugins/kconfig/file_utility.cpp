@@ -99,28 +99,28 @@ void FileUtility::skipLineIfEmptyOrComment ()
 	}
 }
 
-inline void FileUtility::readEscapedChar (std::ostream & str)
+inline void FileUtility::readEscapedChar (std::string & str)
 {
 	switch (static_cast<char> (this->file->get ()))
 	{
 	case 'n':
-		str << '\n';
+		str += '\n';
 		break;
 	case 't':
-		str << '\t';
+		str += '\t';
 		break;
 	case 'r':
-		str << '\r';
+		str += '\r';
 		break;
 	case '\\':
-		str << '\\';
+		str += '\\';
 		break;
 	default:
 		throw KConfigParserException::expect (*this, "valid escape character code ('n', 't', 'r' or '\\')");
 	}
 }
 
-void FileUtility::readUntilChar (std::ostream & str, const char & delimiter)
+void FileUtility::readUntilChar (std::string & str, const char & delimiter)
 {
 	char c;
 	while (true)
@@ -142,12 +142,12 @@ void FileUtility::readUntilChar (std::ostream & str, const char & delimiter)
 		}
 		else
 		{
-			str << c;
+			str += c;
 		}
 	}
 }
 
-void FileUtility::readUntilChar (std::ostream & str, const char & delimiterA, const char & delimiterB)
+void FileUtility::readUntilChar (std::string & str, const char & delimiterA, const char & delimiterB)
 {
 	char c;
 	while (true)
@@ -168,25 +168,25 @@ void FileUtility::readUntilChar (std::ostream & str, const char & delimiterA, co
 		}
 		else
 		{
-			str << c;
+			str += c;
 		}
 	}
 }
 
 std::string FileUtility::getUntilChar (const char & delimiter)
 {
-	// Empty the stringBuffer before re-using it
-	(this->stringBuffer).str (std::string ());
+	// Empty the stringBuffer before re-using it, keeping its allocation
+	(this->stringBuffer).clear ();
 	readUntilChar (this->stringBuffer, delimiter);
-	return (this->stringBuffer).str ();
+	return this->stringBuffer;
 }
 
 std::string FileUtility::getUntilChar (const char & delimiterA, const char & delimiterB)
 {
-	// Empty the stringBuffer before re-using it
-	(this->stringBuffer).str (std::string ());
+	// Empty the stringBuffer before re-using it, keeping its allocation
+	(this->stringBuffer).clear ();
 	readUntilChar (this->stringBuffer, delimiterA, delimiterB);
-	return (this->stringBuffer).str ();
+	return this->stringBuffer;
 }
 
 int FileUtility::getCurrentLineNumber () const
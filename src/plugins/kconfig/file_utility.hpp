@@ -12,8 +12,8 @@ class FileUtility
 private:
 	/* This file is the file stream that we want to parse  */
 	std::unique_ptr<std::istream> file;
-	/* This stringBuffer is used when reading strings from file so that we don't initialize a stringstream each time */
-	std::stringstream stringBuffer;
+	/* This stringBuffer is used when reading strings from file so that we don't allocate a new buffer each time */
+	std::string stringBuffer;
 	/* This int is used to save the current line number for the purpose of better error messages */
 	int currentLine;
 	/* This string is used to save the filename for the purpose of better error messages */
@@ -84,22 +84,22 @@ public:
 	 */
 	void skipLineIfEmptyOrComment ();
 
-	inline void readEscapedChar (std::ostream & str);
+	inline void readEscapedChar (std::string & str);
 
 	/**
 	 * @brief This method is used to read characters into a buffer until (exclusive) a given delimiter, new line or end of file
-	 * @param str This output stream is used to read the characters into it
+	 * @param str This string is used to read the characters into it
 	 * @param delimiter This character is used to determine when to stop reading
 	 */
-	void readUntilChar (std::ostream & str, const char & delimiter);
+	void readUntilChar (std::string & str, const char & delimiter);
 
 	/**
 	 * @brief This method is used to read characters into a buffer until (exclusive) any given delimiter, new line or end of file
-	 * @param str This output stream is used to read the characters into it
+	 * @param str This string is used to read the characters into it
 	 * @param delimiterA This character is used to determine when to stop reading
 	 * @param delimiterB This character is used to determine when to stop reading
 	 */
-	void readUntilChar (std::ostream & str, const char & delimiterA, const char & delimiterB);
+	void readUntilChar (std::string & str, const char & delimiterA, const char & delimiterB);
 
 	/**
 	 * @brief This method is used to read characters into a string until (exclusive) a given delimiter, new line or end of file
@@ -11,6 +11,7 @@
 #include "file_utility.hpp"
 #include "kconfig_parser.hpp"
 #include <fstream>
+#include <sstream>
 
 using kdb::Key;
 using kdb::KeySet;
@@ -42,16 +43,20 @@ kdb::KeySet KconfigDelegate::getConfig (Key const & parent)
 
 
 	ELEKTRA_LOG_DEBUG ("Parse `%s` using the kconfig plugin", parent.getString ().c_str ());
-	auto filePtr = new std::ifstream{ parent.getString () };
-	bool isFileOpen = filePtr->is_open ();
-	std::unique_ptr<std::istream> file{ filePtr };
+	std::ifstream rawFile{ parent.getString () };
 
-	if (!isFileOpen)
+	if (!rawFile.is_open ())
 	{
-		delete filePtr;
 		throw std::runtime_error ("Could not open the file.");
 	}
 
+	// slurp the file once and let the parser work on memory: it reads
+	// character by character, which is much cheaper on a stringbuf than
+	// through the file buffer
+	auto bufferPtr = new std::stringstream{};
+	*bufferPtr << rawFile.rdbuf ();
+	std::unique_ptr<std::istream> file{ bufferPtr };
+
 
 	ELEKTRA_LOG_DEBUG ("The file opened successfully. Start parsing");
 	try
@@ -23,6 +23,20 @@ static const char * CONVERT_TARGET = "convert/to";
 static const char * CONVERT_APPEND_SAMELEVEL = "convert/append/samelevel";
 static const char * CONVERT_APPENDMODE = "convert/append";
 
+typedef struct
+{
+	KeySet * converted; /* keys that were removed from the result during get */
+	KeySet * snapshots; /* metadata values as assembled during get, one key per target/metaname */
+} ConversionState;
+
+static Key * snapshotLookupKey (const char * targetName, const char * metaName)
+{
+	Key * lookup = keyNew ("/", KEY_END);
+	keyAddBaseName (lookup, targetName);
+	keyAddBaseName (lookup, metaName);
+	return lookup;
+}
+
 /*
  * Wrapper for the function comparing by order metadata. As
  * qsort is not stable returning 0 on missing order may
@@ -266,14 +280,49 @@ int elektraKeyToMetaGet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 
 	elektraFree (keyArray);
 
+	/* remember the assembled metadata values, so set can detect
+	 * which targets were modified in between
+	 */
+	KeySet * snapshots = ksNew (0, KS_END);
+	ksRewind (convertedKeys);
+	Key * cur;
+	while ((cur = ksNext (convertedKeys)) != NULL)
+	{
+		const Key * targetName = keyGetMeta (cur, CONVERT_TARGET);
+		const Key * metaName = keyGetMeta (cur, CONVERT_METANAME);
+		if (!targetName || !metaName) continue;
+
+		Key * lookup = snapshotLookupKey (keyString (targetName), keyString (metaName));
+		if (ksLookup (snapshots, lookup, 0) != NULL)
+		{
+			keyDel (lookup);
+			continue;
+		}
+
+		Key * target = ksLookupByName (returned, keyString (targetName), KDB_O_NONE);
+		const Key * valueKey = target != NULL ? keyGetMeta (target, keyString (metaName)) : NULL;
+		if (valueKey)
+		{
+			keySetString (lookup, keyString (valueKey));
+		}
+		ksAppendKey (snapshots, lookup);
+	}
+
 	/* cleanup what might have been left from a previous call */
-	KeySet * old = elektraPluginGetData (handle);
-	if (old)
+	ConversionState * state = elektraPluginGetData (handle);
+	if (state)
 	{
-		ksDel (old);
+		ksDel (state->converted);
+		ksDel (state->snapshots);
+	}
+	else
+	{
+		state = elektraMalloc (sizeof (ConversionState));
 	}
 
-	elektraPluginSetData (handle, convertedKeys);
+	state->converted = convertedKeys;
+	state->snapshots = snapshots;
+	elektraPluginSetData (handle, state);
 
 	errno = errnosave;
 	return 1; /* success */
@@ -282,17 +331,19 @@ int elektraKeyToMetaGet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 
 int elektraKeyToMetaSet (Plugin * handle, KeySet * returned, Key * parentKey ELEKTRA_UNUSED)
 {
-	KeySet * converted = elektraPluginGetData (handle);
+	ConversionState * state = elektraPluginGetData (handle);
 
 	/* nothing to do */
-	if (converted == 0) return 1;
+	if (state == 0) return 1;
 
+	KeySet * converted = state->converted;
 	ksRewind (converted);
 
 	char * saveptr = 0;
 	char * value = 0;
 	Key * current;
 	Key * previous = 0;
+	int dirty = 0;
 	while ((current = ksNext (converted)) != 0)
 	{
 		const Key * targetName = keyGetMeta (current, CONVERT_TARGET);
@@ -310,22 +361,38 @@ int elektraKeyToMetaSet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 				char * result = 0;
 				if (target != previous)
 				{
-					/* handle the first meta line this means initializing strtok and related buffers */
-					elektraFree (value);
 					const Key * valueKey = keyGetMeta (target, keyString (metaName));
-					size_t valueSize = keyGetValueSize (valueKey);
-					value = elektraMalloc (valueSize);
-					keyGetString (valueKey, value, valueSize);
+
+					/* if the metadata still looks like it did after get, the converted
+					 * keys already hold the right values and splitting is unnecessary
+					 */
+					Key * lookup = snapshotLookupKey (keyString (targetName), keyString (metaName));
+					Key * snapshot = ksLookup (state->snapshots, lookup, 0);
+					keyDel (lookup);
+					dirty = snapshot == NULL || valueKey == NULL ||
+						strcmp (keyString (snapshot), keyString (valueKey)) != 0;
+
+					if (dirty)
+					{
+						/* handle the first meta line this means initializing strtok and related buffers */
+						elektraFree (value);
+						size_t valueSize = keyGetValueSize (valueKey);
+						value = elektraMalloc (valueSize);
+						keyGetString (valueKey, value, valueSize);
+						result = strtok_r (value, "\n", &saveptr);
+					}
 					keySetMeta (target, keyString (metaName), 0);
-					result = strtok_r (value, "\n", &saveptr);
 				}
-				else
+				else if (dirty)
 				{
 					/* just continue splitting the metadata */
 					result = strtok_r (NULL, "\n", &saveptr);
 				}
 
-				keySetString (current, result);
+				if (dirty)
+				{
+					keySetString (current, result);
+				}
 
 				previous = target;
 			}
@@ -340,6 +407,8 @@ int elektraKeyToMetaSet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 	elektraFree (value);
 
 	ksDel (converted);
+	ksDel (state->snapshots);
+	elektraFree (state);
 	elektraPluginSetData (handle, 0);
 
 	return 1; /* success */
@@ -347,11 +416,13 @@ int elektraKeyToMetaSet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 
 int elektraKeyToMetaClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 {
-	KeySet * old = elektraPluginGetData (handle);
+	ConversionState * state = elektraPluginGetData (handle);
 
-	if (old)
+	if (state)
 	{
-		ksDel (old);
+		ksDel (state->converted);
+		ksDel (state->snapshots);
+		elektraFree (state);
 	}
 
 	return 1;
@@ -46,6 +46,8 @@ static Lineending strToLE (const char * str)
 	}
 	return NA;
 }
+#define BUFFER_BYTES (4096)
+
 static int checkLineEndings (const char * fileName, Lineending validLineEnding, Key * parentKey)
 {
 	FILE * fp;
@@ -57,55 +59,84 @@ static int checkLineEndings (const char * fileName, Lineending validLineEnding,
 
 	Lineending lineEnding = NA;
 	Lineending found = NA;
-	uint8_t fc, sc;
+	uint8_t buffer[BUFFER_BYTES];
+	uint8_t fc = 0;
 	unsigned long line = 1;
-	fc = sc = 0;
-	(void) fread (&fc, 1, 1, fp);
-	while (!feof (fp))
+	int havePrevious = 0;
+	int skipNext = 0;
+	size_t bytesRead;
+
+	/* one streaming read in large chunks, the state machine slides over the buffered bytes */
+	while ((bytesRead = fread (buffer, 1, sizeof (buffer), fp)) > 0)
 	{
-		(void) fread (&sc, 1, 1, fp);
-		switch (fc)
-		{
-		case LF_BYTE:
-			if (sc == CR_BYTE)
-				found = LFCR;
-			else if (sc == LF_BYTE)
-				found = LF;
-			else if (sc)
-				found = LF;
-			break;
-		case CR_BYTE:
-			if (sc == LF_BYTE)
-				found = CRLF;
-			else if (sc == CR_BYTE)
-				found = CR;
-			else if (sc)
-				found = CR;
-			break;
-		}
-		if (found == CRLF || found == LFCR)
-		{
-			(void) fread (&sc, 1, 1, fp);
-		}
-		if (lineEnding == NA && found != NA)
+		for (size_t i = 0; i < bytesRead; ++i)
 		{
-			lineEnding = found;
-			if (validLineEnding != NA && lineEnding != validLineEnding)
+			uint8_t sc = buffer[i];
+			if (skipNext || !havePrevious)
+			{
+				/* the byte was consumed by a two-byte line ending or is the very first one */
+				skipNext = 0;
+				havePrevious = 1;
+				fc = sc;
+				continue;
+			}
+			switch (fc)
+			{
+			case LF_BYTE:
+				if (sc == CR_BYTE)
+					found = LFCR;
+				else
+					found = LF;
+				break;
+			case CR_BYTE:
+				if (sc == LF_BYTE)
+					found = CRLF;
+				else
+					found = CR;
+				break;
+			}
+			if (found == CRLF || found == LFCR)
+			{
+				skipNext = 1;
+			}
+			if (lineEnding == NA && found != NA)
+			{
+				lineEnding = found;
+				if (validLineEnding != NA && lineEnding != validLineEnding)
+				{
+					fclose (fp);
+					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid line ending at line %lu", line);
+					return -2;
+				}
+				++line;
+			}
+			else if (lineEnding != found && found != NA)
 			{
 				fclose (fp);
-				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid line ending at line %lu", line);
-				return -2;
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Inconsistent line endings at line %lu", line);
+				return -3;
 			}
-			++line;
+			fc = sc;
+			found = NA;
+		}
+	}
+
+	/* a CR or LF as very last byte of the file still forms a line ending on its own */
+	if (havePrevious && !skipNext && (fc == CR_BYTE || fc == LF_BYTE))
+	{
+		found = fc == CR_BYTE ? CR : LF;
+		if (lineEnding == NA && validLineEnding != NA && found != validLineEnding)
+		{
+			fclose (fp);
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid line ending at line %lu", line);
+			return -2;
 		}
-		else if (lineEnding != found && found != NA)
+		if (lineEnding != NA && lineEnding != found)
 		{
 			fclose (fp);
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Inconsistent line endings at line %lu", line);
 			return -3;
 		}
-		fc = sc;
-		found = NA;
 	}
 	fclose (fp);
 	return 0;
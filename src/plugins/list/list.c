@@ -292,6 +292,7 @@ int elektraListClose (Plugin * handle, Key * errorKey)
 	return 1; /* success */
 }
 
+// configOrig is only read; ownership stays with the caller
 static int runPlugins (KeySet * pluginKS, KeySet * modules, KeySet * plugins, KeySet * configOrig, KeySet * returned, KeySet * global,
 		       Key * parentKey, OP op, Key * (*traversalFunction) (KeySet *), ElektraDeferredCallList * deferredCalls)
 {
@@ -355,7 +356,6 @@ static int runPlugins (KeySet * pluginKS, KeySet * modules, KeySet * plugins, Ke
 				ksDel (realPluginConfig);
 				if (!slave)
 				{
-					ksDel (configOrig);
 					return -1;
 				}
 				Key * slaveKey = keyNew ("/", KEY_BINARY, KEY_SIZE, sizeof (Plugin *), KEY_VALUE, &slave, KEY_END);
@@ -371,11 +371,9 @@ static int runPlugins (KeySet * pluginKS, KeySet * modules, KeySet * plugins, Ke
 		    (op == SET && slave->kdbSet && (slave->kdbSet (slave, returned, parentKey)) == -1) ||
 		    (op == ERR && slave->kdbError && (slave->kdbError (slave, returned, parentKey)) == -1))
 		{
-			ksDel (configOrig);
 			return -1;
 		}
 	}
-	ksDel (configOrig);
 	return 1;
 }
 
@@ -405,38 +403,46 @@ int elektraListGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		return 1;
 	}
 	Placements * placements = elektraPluginGetData (handle);
-	KeySet * config = elektraPluginGetConfig (handle);
 	GetPlacements currentPlacement = placements->getCurrent;
-	KeySet * pluginKS = ksDup ((placements)->getKS[currentPlacement]);
-	ksRewind (pluginKS);
-	int ret = runPlugins (pluginKS, placements->modules, placements->plugins, ksDup (config), returned,
-			      elektraPluginGetGlobalKeySet (handle), parentKey, GET, ksNext, placements->deferredCalls);
+	int ret = 1;
+	// an empty placement costs one size check, without copying any keysets
+	if (ksGetSize (placements->getKS[currentPlacement]) > 0)
+	{
+		KeySet * config = elektraPluginGetConfig (handle);
+		KeySet * pluginKS = ksDup ((placements)->getKS[currentPlacement]);
+		ksRewind (pluginKS);
+		ret = runPlugins (pluginKS, placements->modules, placements->plugins, config, returned,
+				  elektraPluginGetGlobalKeySet (handle), parentKey, GET, ksNext, placements->deferredCalls);
+		ksDel (pluginKS);
+	}
 	placements->getCurrent = ((++currentPlacement) % getEnd);
 	while (currentPlacement < getEnd && !placements->getPlacements[currentPlacement])
 	{
 		placements->getCurrent = ((++currentPlacement) % getEnd);
 	}
-	ksDel (pluginKS);
 	return ret;
 }
 
 int elektraListSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	Placements * placements = elektraPluginGetData (handle);
-	KeySet * config = elektraPluginGetConfig (handle);
 	SetPlacements currentPlacement = placements->setCurrent;
-	KeySet * pluginKS = ksDup ((placements)->setKS[currentPlacement]);
-	ksRewind (pluginKS);
-	int ret = 0;
-	ret = runPlugins (pluginKS, placements->modules, placements->plugins, ksDup (config), returned,
-			  elektraPluginGetGlobalKeySet (handle), parentKey, SET, ksPop, placements->deferredCalls);
+	int ret = 1;
+	if (ksGetSize (placements->setKS[currentPlacement]) > 0)
+	{
+		KeySet * config = elektraPluginGetConfig (handle);
+		KeySet * pluginKS = ksDup ((placements)->setKS[currentPlacement]);
+		ksRewind (pluginKS);
+		ret = runPlugins (pluginKS, placements->modules, placements->plugins, config, returned,
+				  elektraPluginGetGlobalKeySet (handle), parentKey, SET, ksPop, placements->deferredCalls);
+		ksDel (pluginKS);
+	}
 	placements->setCurrent = ((++currentPlacement) % setEnd);
 	while (currentPlacement < setEnd && !placements->setPlacements[currentPlacement])
 	{
 		placements->setCurrent = ((++currentPlacement) % setEnd);
 	}
 	elektraPluginSetData (handle, placements);
-	ksDel (pluginKS);
 
 	return ret;
 }
@@ -444,18 +450,22 @@ int elektraListSet (Plugin * handle, KeySet * returned, Key * parentKey)
 int elektraListError (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	Placements * placements = elektraPluginGetData (handle);
-	KeySet * config = elektraPluginGetConfig (handle);
 	ErrPlacements currentPlacement = placements->errCurrent;
-	KeySet * pluginKS = ksDup ((placements)->errKS[currentPlacement]);
-	ksRewind (pluginKS);
-	int ret = runPlugins (pluginKS, placements->modules, placements->plugins, ksDup (config), returned,
-			      elektraPluginGetGlobalKeySet (handle), parentKey, ERR, ksPop, placements->deferredCalls);
+	int ret = 1;
+	if (ksGetSize (placements->errKS[currentPlacement]) > 0)
+	{
+		KeySet * config = elektraPluginGetConfig (handle);
+		KeySet * pluginKS = ksDup ((placements)->errKS[currentPlacement]);
+		ksRewind (pluginKS);
+		ret = runPlugins (pluginKS, placements->modules, placements->plugins, config, returned,
+				  elektraPluginGetGlobalKeySet (handle), parentKey, ERR, ksPop, placements->deferredCalls);
+		ksDel (pluginKS);
+	}
 	placements->errCurrent = ((++currentPlacement) % errEnd);
 	while (currentPlacement < errEnd && !placements->errPlacements[currentPlacement])
 	{
 		placements->errCurrent = ((++currentPlacement) % errEnd);
 	}
-	ksDel (pluginKS);
 	return ret;
 }
 
@@ -65,28 +65,39 @@ int elektraLogchangeSet (Plugin * handle, KeySet * returned, Key * parentKey ELE
 	KeySet * oldKeys = (KeySet *) elektraPluginGetData (handle);
 	// because elektraLogchangeGet will always be executed before elektraLogchangeSet
 	// we know that oldKeys must exist here!
-	ksRewind (oldKeys);
-	ksRewind (returned);
 
-	KeySet * addedKeys = ksDup (returned);
+	KeySet * addedKeys = ksNew (0, KS_END);
 	KeySet * changedKeys = ksNew (0, KS_END);
 	KeySet * removedKeys = ksNew (0, KS_END);
 
+	// the core marks added and changed keys with the sync flag,
+	// so only those need a lookup into the previous keyset
+	ksRewind (returned);
 	Key * k = 0;
-	while ((k = ksNext (oldKeys)) != 0)
+	while ((k = ksNext (returned)) != 0)
 	{
-		Key * p = ksLookup (addedKeys, k, KDB_O_POP);
-		// Note: keyDel not needed, because at least two references exist
-		if (p)
+		if (!keyNeedSync (k)) continue;
+		if (ksLookup (oldKeys, k, 0))
 		{
-			if (keyNeedSync (p))
-			{
-				ksAppendKey (changedKeys, p);
-			}
+			ksAppendKey (changedKeys, k);
 		}
 		else
 		{
-			ksAppendKey (removedKeys, k);
+			ksAppendKey (addedKeys, k);
+		}
+	}
+
+	// the sizes tell whether keys were removed, so the full scan of the
+	// previous keyset only happens when a removal actually occurred
+	if (ksGetSize (oldKeys) + ksGetSize (addedKeys) != ksGetSize (returned))
+	{
+		ksRewind (oldKeys);
+		while ((k = ksNext (oldKeys)) != 0)
+		{
+			if (!ksLookup (returned, k, 0))
+			{
+				ksAppendKey (removedKeys, k);
+			}
 		}
 	}
 
@@ -18,6 +18,9 @@
 #include <key.hpp>
 #include <keyset.hpp>
 #include <libgen.h>
+#include <map>
+#include <mutex>
+#include <string>
 
 #include <lua.hpp>
 extern "C" {
@@ -62,6 +65,41 @@ static void Lua_Shutdown (lua_State * L)
 	if (L) lua_close (L);
 }
 
+/* precompiled script chunks, shared between all plugin instances of this process */
+static std::mutex scriptCacheLock;
+static std::map<std::string, std::string> scriptCache;
+
+static int Lua_ChunkWriter (lua_State * L ELEKTRA_UNUSED, const void * chunk, size_t size, void * bytecode)
+{
+	static_cast<std::string *> (bytecode)->append (static_cast<const char *> (chunk), size);
+	return 0;
+}
+
+/* load & run a script like luaL_dofile, but compile each script only once per process */
+static int Lua_LoadScript (lua_State * L, const char * script)
+{
+	{
+		std::lock_guard<std::mutex> lock (scriptCacheLock);
+		std::map<std::string, std::string>::iterator cached = scriptCache.find (script);
+		if (cached != scriptCache.end ())
+		{
+			if (luaL_loadbuffer (L, cached->second.data (), cached->second.size (), script) != LUA_OK) return 1;
+		}
+		else
+		{
+			if (luaL_loadfile (L, script) != LUA_OK) return 1;
+			std::string bytecode;
+#if LUA_VERSION_NUM >= 503
+			lua_dump (L, Lua_ChunkWriter, &bytecode, 0);
+#else
+			lua_dump (L, Lua_ChunkWriter, &bytecode);
+#endif
+			scriptCache[script] = bytecode;
+		}
+	}
+	return lua_pcall (L, 0, LUA_MULTRET, 0);
+}
+
 static int Lua_Require (lua_State * L, const char * name)
 {
 	lua_getglobal (L, "require");
@@ -157,8 +195,8 @@ int elektraLuaOpen (ckdb::Plugin * handle, ckdb::Key * errorKey)
 	/* require kdb */
 	if (Lua_Require (data->L, "kdb") != LUA_OK) goto error_print;
 
-	/* load lua script */
-	if (luaL_dofile (data->L, keyString (script))) goto error_print;
+	/* load lua script, reusing its bytecode if another instance already compiled it */
+	if (Lua_LoadScript (data->L, keyString (script))) goto error_print;
 
 	/* store module data after everything is set up */
 	elektraPluginSetData (handle, data);
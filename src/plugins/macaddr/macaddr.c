@@ -14,7 +14,6 @@
 #include <kdberrors.h>
 #include <kdbhelper.h>
 #include <kdbprivate.h>
-#include <regex.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -56,22 +55,44 @@ void transformMac (Key * key)
 }
 
 /**
- * Checks if the first string parameter conforms to the regex of the second string parameter
+ * Checks if the string parameter is a MAC address in one of the separated formats,
+ * i.e. six hex octet pairs joined with ':' or '-', or two hex triplets joined with '-'.
+ * A direct scan instead of the regexes used previously, which were recompiled for
+ * every checked key.
  * @param mac the string to check
- * @param regexString the regex to apply
- * @retval VALIDATION_SUCCESS if a match has been found, else VALIDATION_ERROR
+ * @retval VALIDATION_SUCCESS if the string is a separated MAC address, else VALIDATION_ERROR
  */
-int checkRegex (const char * mac, const char * regexString)
+static int checkMacFormats (const char * mac)
 {
-	regex_t regex;
-
-	int reg = regcomp (&regex, regexString, REG_NOSUB | REG_EXTENDED | REG_NEWLINE);
-	if (reg) return -1;
-
-	reg = regexec (&regex, mac, 0, NULL, 0);
-	regfree (&regex);
-
-	return reg == REG_NOMATCH ? VALIDATION_ERROR : VALIDATION_SUCCESS;
+	size_t len = strlen (mac);
+	if (len == 17) // XX:XX:XX:XX:XX:XX or XX-XX-XX-XX-XX-XX
+	{
+		char separator = mac[2];
+		if (separator != ':' && separator != '-') return VALIDATION_ERROR;
+		for (size_t i = 0; i < len; ++i)
+		{
+			if ((i + 1) % 3 == 0)
+			{
+				if (mac[i] != separator) return VALIDATION_ERROR;
+			}
+			else if (!isxdigit ((unsigned char) mac[i]))
+			{
+				return VALIDATION_ERROR;
+			}
+		}
+		return VALIDATION_SUCCESS;
+	}
+	if (len == 13) // XXXXXX-XXXXXX
+	{
+		if (mac[6] != '-') return VALIDATION_ERROR;
+		for (size_t i = 0; i < len; ++i)
+		{
+			if (i == 6) continue;
+			if (!isxdigit ((unsigned char) mac[i])) return VALIDATION_ERROR;
+		}
+		return VALIDATION_SUCCESS;
+	}
+	return VALIDATION_ERROR;
 }
 
 /**
@@ -106,21 +127,11 @@ int validateMac (Key * key)
 
 	const char * mac = keyString (key);
 
-	const char * regexColon = "^([0-9A-Fa-f]{2}:){5}([0-9A-Fa-f]{2})$";
-	const char * regexHyphen = "^([0-9A-Fa-f]{2}-){5}([0-9A-Fa-f]{2})$";
-	const char * regexHyphenSingle = "^([0-9A-Fa-f]{6}-)([0-9A-Fa-f]{6})$";
-
-	const char * regexStrings[] = { regexColon, regexHyphen, regexHyphenSingle };
-
-	int ret;
-	int i = 0;
-
-	ret = checkIntMac (mac);
+	int ret = checkIntMac (mac);
 
-	while (ret == VALIDATION_ERROR && i < 3)
+	if (ret == VALIDATION_ERROR)
 	{
-		ret = checkRegex (mac, regexStrings[i]);
-		++i;
+		ret = checkMacFormats (mac);
 	}
 
 	return ret;
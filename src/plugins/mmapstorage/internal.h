@@ -57,7 +57,10 @@
 #define ELEKTRA_MAGIC_MMAP_NUMBER (0x0A3472746B656C45)
 
 /** Mmap format version (1 byte). Increment on breaking changes to invalidate old files. */
-#define ELEKTRA_MMAP_FORMAT_VERSION (2)
+#define ELEKTRA_MMAP_FORMAT_VERSION (4)
+
+/** Block size, in bytes, for the per-block CRC32 checksums of the `mmapstorage_crc` variant. */
+#define ELEKTRA_MMAP_CRC_BLOCKSIZE (64 * 1024)
 
 /** Mmap temp file template */
 #define ELEKTRA_MMAP_TMP_NAME "/tmp/elektraMmapTmpXXXXXX"
@@ -138,7 +141,7 @@ struct _mmapHeader
 	uint64_t allocSize;		/**<Size of the complete allocation in bytes */
 	uint64_t cksumSize;		/**<Size of the critical data for checksum (structs, pointers, sizes)*/
 
-	uint32_t checksum;		/**<Checksum of the data */
+	uint32_t checksum;		/**<Checksum of the per-block checksum table */
 	uint8_t formatFlags;		/**<Mmap format flags (e.g. checksum ON/OFF) */
 	uint8_t formatVersion;		/**<Mmap format version */
 
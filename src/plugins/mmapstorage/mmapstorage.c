@@ -577,33 +577,153 @@ static int verifyMagicData (char * mappedRegion)
 }
 
 #ifdef ELEKTRA_MMAP_CHECKSUM
+/**
+ * @brief Number of checksum blocks covering the critical mmap data.
+ *
+ * @param mmapHeader containing the size of the checksum region
+ *
+ * @return number of blocks of size ELEKTRA_MMAP_CRC_BLOCKSIZE
+ */
+static size_t checksumNumBlocks (const MmapHeader * mmapHeader)
+{
+	return (mmapHeader->cksumSize + ELEKTRA_MMAP_CRC_BLOCKSIZE - 1) / ELEKTRA_MMAP_CRC_BLOCKSIZE;
+}
+
+/**
+ * @brief Location of the per-block checksum table within the mapped region.
+ *
+ * The table is stored directly after the critical data, aligned for uint32_t access.
+ *
+ * @param mappedRegion pointer to mapped region
+ * @param mmapHeader containing the size of the checksum region
+ *
+ * @return pointer to the first block checksum
+ */
+static uint32_t * checksumBlockTable (char * mappedRegion, const MmapHeader * mmapHeader)
+{
+	size_t tablePadding = sizeof (uint32_t) - (mmapHeader->cksumSize % sizeof (uint32_t)); // alignment for the block table
+	return (uint32_t *) (mappedRegion + SIZEOF_MMAPHEADER + mmapHeader->cksumSize + tablePadding);
+}
+
+/**
+ * @brief CRC32 checksum of one block of the critical mmap data.
+ *
+ * @param mappedRegion pointer to mapped region
+ * @param mmapHeader containing the size of the checksum region
+ * @param block index of the block to checksum
+ *
+ * @return checksum of the block
+ */
+static uint32_t checksumBlock (const char * mappedRegion, const MmapHeader * mmapHeader, size_t block)
+{
+	size_t offset = block * ELEKTRA_MMAP_CRC_BLOCKSIZE;
+	size_t blockSize = mmapHeader->cksumSize - offset;
+	if (blockSize > ELEKTRA_MMAP_CRC_BLOCKSIZE) blockSize = ELEKTRA_MMAP_CRC_BLOCKSIZE;
+
+	uint32_t checksum = crc32 (0L, Z_NULL, 0);
+	return crc32 (checksum, (const unsigned char *) (mappedRegion + SIZEOF_MMAPHEADER + offset), blockSize);
+}
+
+/**
+ * @brief Write the per-block checksum table of the critical mmap data.
+ *
+ * Computes a CRC32 checksum for every block of the critical data and stores it in the
+ * block table after the critical data. The checksum of the table itself is stored in
+ * the header, so a corrupted table is detected as well.
+ *
+ * @param dest pointer to mapped region
+ * @param mmapHeader where the checksum of the block table is stored
+ */
+static void writeChecksumBlocks (char * dest, MmapHeader * mmapHeader)
+{
+	size_t numBlocks = checksumNumBlocks (mmapHeader);
+	uint32_t * blockTable = checksumBlockTable (dest, mmapHeader);
+
+	for (size_t block = 0; block < numBlocks; ++block)
+	{
+		blockTable[block] = checksumBlock (dest, mmapHeader, block);
+	}
+
+	uint32_t tableChecksum = crc32 (0L, Z_NULL, 0);
+	mmapHeader->checksum = crc32 (tableChecksum, (const unsigned char *) blockTable, numBlocks * sizeof (uint32_t));
+}
+
+/**
+ * @brief Verify the checksums of a range of blocks of the critical mmap data.
+ *
+ * @param mappedRegion pointer to mapped region
+ * @param mmapHeader containing the size of the checksum region
+ * @param blockTable the per-block checksum table
+ * @param firstBlock index of the first block to verify
+ * @param lastBlock index of the last block to verify (inclusive)
+ *
+ * @retval 0 if all checksums were correct
+ * @retval -1 if there was a checksum mismatch
+ */
+static int verifyChecksumBlocks (char * mappedRegion, MmapHeader * mmapHeader, const uint32_t * blockTable, size_t firstBlock,
+				 size_t lastBlock, PluginMode mode)
+{
+	for (size_t block = firstBlock; block <= lastBlock; ++block)
+	{
+		uint32_t checksum = checksumBlock (mappedRegion, mmapHeader, block);
+		if (checksum != blockTable[block])
+		{
+			ELEKTRA_MMAP_LOG_WARNING ("block: %zu", block);
+			ELEKTRA_MMAP_LOG_WARNING ("old checksum: %ul", blockTable[block]);
+			ELEKTRA_MMAP_LOG_WARNING ("new checksum: %ul", checksum);
+			return -1;
+		}
+	}
+	return 0;
+}
+
 /**
  * @brief Verify checksum of the critical mmap data.
  *
- * Verifies the CRC32 checksum of all KeySet and Key structs (including pointers/pointer arrays)
- * as well as the MmapMetaData. Does not check Key name and value.
+ * Verifies the CRC32 checksums of all KeySet and Key structs (including pointers/pointer arrays)
+ * as well as the MmapMetaData. The critical data is checksummed in blocks, so only the blocks
+ * containing structs, pointers and sizes have to be read here. Key names and values are not
+ * checked, thus their pages are not faulted in eagerly. Their checksums remain in the block
+ * table, so those blocks can still be verified externally.
  *
  * @param mappedRegion pointer to mapped region
  * @param mmapHeader containing the stored checksum and size of the checksum region
+ * @param mmapMetaData containing the number of KeySets and Keys
  *
- * @retval 0 if checksum was correct
+ * @retval 0 if all checksums were correct
  * @retval -1 if there was a checksum mismatch
  */
-static int verifyChecksum (char * mappedRegion, MmapHeader * mmapHeader, PluginMode mode)
+static int verifyChecksum (char * mappedRegion, MmapHeader * mmapHeader, MmapMetaData * mmapMetaData, PluginMode mode)
 {
 	// if file was written without checksum, we skip the check
 	if (!test_bit (mmapHeader->formatFlags, MMAP_FLAG_CHECKSUM)) return 0;
 
-	uint32_t checksum = crc32 (0L, Z_NULL, 0);
-	checksum = crc32 (checksum, (const unsigned char *) (mappedRegion + SIZEOF_MMAPHEADER), mmapHeader->cksumSize);
+	size_t numBlocks = checksumNumBlocks (mmapHeader);
+	const uint32_t * blockTable = checksumBlockTable (mappedRegion, mmapHeader);
 
-	if (checksum != mmapHeader->checksum)
+	uint32_t tableChecksum = crc32 (0L, Z_NULL, 0);
+	tableChecksum = crc32 (tableChecksum, (const unsigned char *) blockTable, numBlocks * sizeof (uint32_t));
+	if (tableChecksum != mmapHeader->checksum)
 	{
 		ELEKTRA_MMAP_LOG_WARNING ("old checksum: %ul", mmapHeader->checksum);
-		ELEKTRA_MMAP_LOG_WARNING ("new checksum: %ul", checksum);
+		ELEKTRA_MMAP_LOG_WARNING ("new checksum: %ul", tableChecksum);
 		return -1;
 	}
-	return 0;
+
+	// the first block contains the MmapMetaData, verify it before trusting the sizes stored there
+	if (verifyChecksumBlocks (mappedRegion, mmapHeader, blockTable, 0, 0, mode) != 0) return -1;
+
+	size_t structRegionSize = (OFFSET_GLOBAL_KEYSET - SIZEOF_MMAPHEADER) + (SIZEOF_KEYSET * mmapMetaData->numKeySets) +
+				  (SIZEOF_KEY_PTR * mmapMetaData->ksAlloc) + (SIZEOF_KEY * mmapMetaData->numKeys);
+	if (structRegionSize > mmapHeader->cksumSize)
+	{
+		ELEKTRA_MMAP_LOG_WARNING ("struct region exceeds checksummed region, file was altered");
+		return -1;
+	}
+
+	size_t lastBlock = (structRegionSize - 1) / ELEKTRA_MMAP_CRC_BLOCKSIZE;
+	if (lastBlock == 0) return 0; // everything critical was covered by the first block
+	return verifyChecksumBlocks (mappedRegion, mmapHeader, blockTable, 1, lastBlock, mode);
 }
 #endif
 
@@ -713,6 +833,12 @@ static void calculateMmapDataSize (MmapHeader * mmapHeader, MmapMetaData * mmapM
 				dataBlocksSize + (mmapMetaData->ksAlloc * SIZEOF_KEY_PTR);
 	mmapHeader->cksumSize = mmapHeader->allocSize; // cksumSize now contains size of all critical data
 
+#ifdef ELEKTRA_MMAP_CHECKSUM
+	// reserve space for the per-block checksum table after the critical data
+	size_t tablePadding = sizeof (uint32_t) - (mmapHeader->allocSize % sizeof (uint32_t)); // alignment for the block table
+	mmapHeader->allocSize += tablePadding + (checksumNumBlocks (mmapHeader) * sizeof (uint32_t));
+#endif
+
 	size_t padding = sizeof (uint64_t) - (mmapHeader->allocSize % sizeof (uint64_t)); // alignment for MMAP Footer at end of mapping
 	mmapHeader->allocSize += SIZEOF_MMAPHEADER + padding + SIZEOF_MMAPFOOTER;
 
@@ -765,12 +891,14 @@ static void writeMetaKeys (MmapAddr * mmapAddr, DynArray * dynArray)
 			mmapMetaKey->flags |= KEY_FLAG_MMAP_KEY;
 		}
 
-		// move Key value
-		if (curMeta->data.v)
+		// move Key value; inline (small) values are written to the data
+		// section like any other value
+		if (keyDataPtr (curMeta))
 		{
-			memcpy (mmapAddr->dataPtr, curMeta->data.v, curMeta->dataSize);
+			memcpy (mmapAddr->dataPtr, keyDataPtr (curMeta), curMeta->dataSize);
 			mmapMetaKey->data.v = mmapAddr->dataPtr - mmapAddr->mmapAddrInt;
 			mmapAddr->dataPtr += curMeta->dataSize;
+			clear_bit (mmapMetaKey->flags, (keyflag_t) KEY_FLAG_SMALL_DATA);
 			mmapMetaKey->flags |= KEY_FLAG_MMAP_DATA;
 		}
 
@@ -877,12 +1005,14 @@ static void writeKeys (KeySet * keySet, MmapAddr * mmapAddr, DynArray * dynArray
 			mmapKey->flags |= KEY_FLAG_MMAP_KEY;
 		}
 
-		// move Key value
-		if (cur->data.v)
+		// move Key value; inline (small) values are written to the data
+		// section like any other value
+		if (keyDataPtr (cur))
 		{
-			memcpy (mmapAddr->dataPtr, cur->data.v, cur->dataSize);
+			memcpy (mmapAddr->dataPtr, keyDataPtr (cur), cur->dataSize);
 			mmapKey->data.v = mmapAddr->dataPtr - mmapAddr->mmapAddrInt;
 			mmapAddr->dataPtr += cur->dataSize;
+			clear_bit (mmapKey->flags, (keyflag_t) KEY_FLAG_SMALL_DATA);
 			mmapKey->flags |= KEY_FLAG_MMAP_DATA;
 		}
 		else
@@ -1043,9 +1173,7 @@ static int copyKeySetToMmap (char * const dest, KeySet * keySet, KeySet * global
 
 	memcpy ((dest + OFFSET_MMAPMETADATA), mmapMetaData, SIZEOF_MMAPMETADATA);
 #ifdef ELEKTRA_MMAP_CHECKSUM
-	uint32_t checksum = crc32 (0L, Z_NULL, 0);
-	checksum = crc32 (checksum, (const unsigned char *) (dest + SIZEOF_MMAPHEADER), mmapHeader->cksumSize);
-	mmapHeader->checksum = checksum;
+	writeChecksumBlocks (dest, mmapHeader);
 #endif
 	memcpy (dest, mmapHeader, SIZEOF_MMAPHEADER);
 
@@ -1243,6 +1371,266 @@ static void updatePointers (MmapMetaData * mmapMetaData, char * dest)
 	}
 }
 
+/**
+ * @brief Wrapper for msync() flushing only the pages containing a byte range.
+ *
+ * @param mappedRegion pointer to mapped region (page aligned)
+ * @param offset start of the dirty range, relative to the mapped region
+ * @param size size of the dirty range in bytes
+ *
+ * @retval 0 on success
+ * @retval -1 if msync() failed
+ */
+static int msyncRange (char * mappedRegion, size_t offset, size_t size)
+{
+	size_t pageSize = (size_t) sysconf (_SC_PAGESIZE);
+	size_t start = offset - (offset % pageSize);
+	return msync ((void *) (mappedRegion + start), (offset + size) - start, MS_SYNC);
+}
+
+#ifdef ELEKTRA_MMAP_CHECKSUM
+/**
+ * @brief Recomputes the checksums of the blocks containing a byte range.
+ *
+ * Only the block table is updated here. The checksum of the block table itself,
+ * stored in the header, has to be recomputed once after all patches.
+ *
+ * @param mappedRegion pointer to mapped region
+ * @param mmapHeader containing the size of the checksum region
+ * @param offset start of the dirty range, relative to the mapped region
+ * @param size size of the dirty range in bytes
+ */
+static void updateChecksumBlocks (char * mappedRegion, MmapHeader * mmapHeader, size_t offset, size_t size)
+{
+	uint32_t * blockTable = checksumBlockTable (mappedRegion, mmapHeader);
+	size_t firstBlock = (offset - SIZEOF_MMAPHEADER) / ELEKTRA_MMAP_CRC_BLOCKSIZE;
+	size_t lastBlock = ((offset + size - 1) - SIZEOF_MMAPHEADER) / ELEKTRA_MMAP_CRC_BLOCKSIZE;
+
+	for (size_t block = firstBlock; block <= lastBlock; ++block)
+	{
+		blockTable[block] = checksumBlock (mappedRegion, mmapHeader, block);
+	}
+}
+#endif
+
+/**
+ * @brief Checks whether a keyset still matches the layout of a mapped keyset.
+ *
+ * The layout of a mapped file only depends on the number of keys, their names,
+ * their value sizes and their meta-keys. When all of those are unchanged, new
+ * values can be patched directly into the mapped region. Meta-keys have to be
+ * completely unchanged, because their values are deduplicated and may be shared
+ * between keys.
+ *
+ * @param mappedRegion pointer to mapped region
+ * @param fileKs mapped keyset, holding relative pointers
+ * @param keySet keyset to compare against the mapped keyset
+ *
+ * @retval 1 if only key values of unchanged size differ
+ * @retval 0 if the layout differs
+ */
+static int mappedLayoutMatches (char * mappedRegion, const KeySet * fileKs, const KeySet * keySet)
+{
+	if (fileKs->size != keySet->size) return 0;
+	if (keySet->size == 0) return 1;
+	if (!fileKs->array) return 0;
+
+	uintptr_t regionInt = (uintptr_t) mappedRegion;
+	Key ** fileArray = (Key **) ((char *) fileKs->array + regionInt);
+
+	for (size_t i = 0; i < keySet->size; ++i)
+	{
+		const Key * fileKey = (Key *) ((char *) fileArray[i] + regionInt);
+		const Key * cur = keySet->array[i];
+
+		if (fileKey->keySize != cur->keySize || fileKey->keyUSize != cur->keyUSize || fileKey->dataSize != cur->dataSize)
+		{
+			return 0;
+		}
+		if ((fileKey->key == 0) != (cur->key == 0) || (fileKey->ukey == 0) != (cur->ukey == 0) ||
+		    (fileKey->data.v == 0) != (keyDataPtr (cur) == 0))
+		{
+			return 0;
+		}
+		if (cur->key && memcmp (fileKey->key + regionInt, cur->key, cur->keySize) != 0) return 0;
+		if (cur->ukey && memcmp (fileKey->ukey + regionInt, cur->ukey, cur->keyUSize) != 0) return 0;
+
+		const KeySet * fileMeta = fileKey->meta ? (KeySet *) ((char *) fileKey->meta + regionInt) : 0;
+		size_t curMetaSize = (cur->meta && cur->meta->size > 0) ? cur->meta->size : 0;
+		if ((fileMeta ? fileMeta->size : 0) != curMetaSize) return 0;
+		if (curMetaSize == 0) continue;
+
+		Key ** fileMetaArray = (Key **) ((char *) fileMeta->array + regionInt);
+		for (size_t j = 0; j < curMetaSize; ++j)
+		{
+			const Key * fileMetaKey = (Key *) ((char *) fileMetaArray[j] + regionInt);
+			const Key * curMeta = cur->meta->array[j];
+
+			if (fileMetaKey->keySize != curMeta->keySize || fileMetaKey->keyUSize != curMeta->keyUSize ||
+			    fileMetaKey->dataSize != curMeta->dataSize)
+			{
+				return 0;
+			}
+			if (memcmp (fileMetaKey->key + regionInt, curMeta->key, curMeta->keySize) != 0) return 0;
+			if ((fileMetaKey->data.v == 0) != (keyDataPtr (curMeta) == 0)) return 0;
+			if (keyDataPtr (curMeta) && memcmp (fileMetaKey->data.c + regionInt, keyDataPtr (curMeta), curMeta->dataSize) != 0)
+			{
+				return 0;
+			}
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * @brief Patches changed key values into a mapped keyset.
+ *
+ * Copies the value of every key whose value bytes differ into the mapped
+ * region and flushes only the dirty pages. The layout has to match already,
+ * see mappedLayoutMatches().
+ *
+ * @param mappedRegion pointer to mapped region
+ * @param mmapHeader containing the size of the checksum region
+ * @param fileKs mapped keyset, holding relative pointers
+ * @param keySet keyset holding the new values
+ *
+ * @retval 0 on success
+ * @retval -1 if msync() failed
+ */
+static int patchMappedValues (char * mappedRegion, MmapHeader * mmapHeader ELEKTRA_UNUSED, const KeySet * fileKs, const KeySet * keySet)
+{
+	if (keySet->size == 0) return 0;
+
+	uintptr_t regionInt = (uintptr_t) mappedRegion;
+	Key ** fileArray = (Key **) ((char *) fileKs->array + regionInt);
+
+	for (size_t i = 0; i < keySet->size; ++i)
+	{
+		const Key * fileKey = (Key *) ((char *) fileArray[i] + regionInt);
+		const Key * cur = keySet->array[i];
+
+		const void * curData = keyDataPtr (cur);
+		if (curData == 0 || memcmp (fileKey->data.c + regionInt, curData, cur->dataSize) == 0) continue;
+
+		size_t offset = (size_t) fileKey->data.c;
+		memcpy (mappedRegion + offset, curData, cur->dataSize);
+#ifdef ELEKTRA_MMAP_CHECKSUM
+		updateChecksumBlocks (mappedRegion, mmapHeader, offset, cur->dataSize);
+#endif
+		if (msyncRange (mappedRegion, offset, cur->dataSize) != 0) return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Tries to update an existing mapped file in place.
+ *
+ * When only key values of unchanged size were modified since the file was
+ * written, the layout of the file is identical and the new values can be
+ * patched directly into the mapped region. Only the dirty pages and the
+ * affected checksum blocks are written back, instead of rewriting the
+ * whole file. On any mismatch the file is left for a complete rewrite.
+ *
+ * @param keySet the keyset to be written
+ * @param global the global keyset
+ * @param parentKey holding the filename
+ * @param mode the current plugin mode
+ *
+ * @retval 1 if the file was updated in place
+ * @retval 0 if the file has to be rewritten completely
+ */
+static int updateFileInPlace (KeySet * keySet, KeySet * global, Key * parentKey, PluginMode mode)
+{
+	int errnosave = errno;
+	int fd = -1;
+	char * mappedRegion = MAP_FAILED;
+	struct stat sbuf;
+	sbuf.st_size = 0;
+
+	if ((fd = open (keyString (parentKey), O_RDWR)) == -1) goto fallback;
+	if (fstatFile (fd, &sbuf, parentKey, mode) != 1) goto fallback;
+	if (sbuf.st_size < 0 || (size_t) sbuf.st_size < ELEKTRA_MMAP_MINSIZE) goto fallback;
+
+	mappedRegion = mmapFile ((void *) 0, fd, sbuf.st_size, MAP_SHARED, parentKey, mode);
+	if (mappedRegion == MAP_FAILED) goto fallback;
+	if (verifyMagicData (mappedRegion) != 0) goto fallback;
+
+	MmapHeader * mmapHeader;
+	MmapMetaData * mmapMetaData;
+	if (readHeader (mappedRegion, &mmapHeader, &mmapMetaData) == -1) goto fallback;
+
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	if (!test_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM)) goto fallback;
+#else
+	if (test_bit (mmapHeader->formatFlags, MMAP_FLAG_OPMPHM)) goto fallback;
+#endif
+
+#ifdef ELEKTRA_MMAP_CHECKSUM
+	if (!test_bit (mmapHeader->formatFlags, MMAP_FLAG_CHECKSUM)) goto fallback;
+#else
+	if (test_bit (mmapHeader->formatFlags, MMAP_FLAG_CHECKSUM)) goto fallback;
+#endif
+
+	if ((size_t) sbuf.st_size != mmapHeader->allocSize) goto fallback;
+
+#ifdef ELEKTRA_MMAP_CHECKSUM
+	if (verifyChecksum (mappedRegion, mmapHeader, mmapMetaData, mode) != 0) goto fallback;
+#endif
+
+	if (readFooter (mappedRegion, mmapHeader) == -1) goto fallback;
+	if ((global != 0) != (test_bit (mmapHeader->formatFlags, MMAP_FLAG_TIMESTAMPS) != 0)) goto fallback;
+
+	KeySet * fileKs = (KeySet *) (mappedRegion + OFFSET_KEYSET);
+	KeySet * fileGlobal = (KeySet *) (mappedRegion + OFFSET_GLOBAL_KEYSET);
+	if (mappedLayoutMatches (mappedRegion, fileKs, keySet) != 1) goto fallback;
+	if (global && mappedLayoutMatches (mappedRegion, fileGlobal, global) != 1) goto fallback;
+
+#ifdef ELEKTRA_ENABLE_OPTIMIZATIONS
+	// an OPMPHM stored in the file stays valid, because the key names are
+	// unchanged, but one built only in memory since the last full write
+	// would be lost by patching, so the file has to be rewritten
+	if (keySet->opmphm && fileKs->opmphm == 0) goto fallback;
+	if (keySet->opmphmPredictor && fileKs->opmphmPredictor == 0) goto fallback;
+#endif
+
+	if (patchMappedValues (mappedRegion, mmapHeader, fileKs, keySet) != 0) goto fallback;
+	if (global && patchMappedValues (mappedRegion, mmapHeader, fileGlobal, global) != 0) goto fallback;
+
+#ifdef ELEKTRA_MMAP_CHECKSUM
+	// the block table was patched, so the checksum of the table has to be renewed
+	uint32_t * blockTable = checksumBlockTable (mappedRegion, mmapHeader);
+	size_t numBlocks = checksumNumBlocks (mmapHeader);
+	uint32_t tableChecksum = crc32 (0L, Z_NULL, 0);
+	mmapHeader->checksum = crc32 (tableChecksum, (const unsigned char *) blockTable, numBlocks * sizeof (uint32_t));
+	if (msyncRange (mappedRegion, (char *) blockTable - mappedRegion, numBlocks * sizeof (uint32_t)) != 0) goto fallback;
+	if (msyncRange (mappedRegion, 0, SIZEOF_MMAPHEADER) != 0) goto fallback;
+#endif
+
+	if (munmap (mappedRegion, sbuf.st_size) != 0)
+	{
+		ELEKTRA_MMAP_LOG_WARNING ("could not munmap");
+	}
+	if (close (fd) != 0)
+	{
+		ELEKTRA_MMAP_LOG_WARNING ("could not close");
+	}
+	return 1;
+
+fallback:
+	if ((mappedRegion != MAP_FAILED) && (munmap (mappedRegion, sbuf.st_size) != 0))
+	{
+		ELEKTRA_MMAP_LOG_WARNING ("could not munmap");
+	}
+	if ((fd != -1) && close (fd) != 0)
+	{
+		ELEKTRA_MMAP_LOG_WARNING ("could not close");
+	}
+	errno = errnosave;
+	return 0;
+}
+
 /* -- Exported Elektra Plugin Functions ------------------------------------------------------------------------------------------------- */
 
 /**
@@ -1439,7 +1827,7 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 	}
 
 #ifdef ELEKTRA_MMAP_CHECKSUM
-	if (verifyChecksum (mappedRegion, mmapHeader, mode) != 0)
+	if (verifyChecksum (mappedRegion, mmapHeader, mmapMetaData, mode) != 0)
 	{
 		ELEKTRA_MMAP_LOG_WARNING ("checksum failed");
 		goto error;
@@ -1533,6 +1921,14 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 	}
 	else
 	{
+		if (updateFileInPlace (ks, global, parentKey, mode) == 1)
+		{
+			ELEKTRA_LOG_DEBUG ("updated mmap file %s in place", keyString (parentKey));
+			keySetString (parentKey, keyString (initialParent));
+			if (initialParent) keyDel (initialParent);
+			return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
+
 		if (unlink (keyString (parentKey)) != 0 && errno != ENOENT)
 		{
 			ELEKTRA_MMAP_LOG_WARNING ("could not unlink");
@@ -127,6 +127,78 @@ static void test_mmap_crc_wrong_checksum (const char * tmpFile)
 	}
 }
 
+static void test_mmap_crc_wrong_block_checksum (const char * tmpFile)
+{
+	// first write a mmap file
+	{
+		Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("mmapstorage_crc");
+
+		KeySet * ks = ksNew (1, keyNew (TEST_ROOT_KEY "/key", KEY_VALUE, "value", KEY_END), KS_END);
+		succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "kdbSet was not successful");
+
+		keyDel (parentKey);
+		ksDel (ks);
+		PLUGIN_CLOSE ();
+	}
+
+	// corrupt a byte within the critical struct data
+	FILE * fp;
+	if ((fp = fopen (tmpFile, "r+")) == 0)
+	{
+		yield_error ("fopen() error");
+	}
+	struct stat sbuf;
+	if (stat (tmpFile, &sbuf) == -1)
+	{
+		yield_error ("stat() error");
+	}
+
+	int fd = fileno (fp);
+	char * mappedRegion = mmap (0, sbuf.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (mappedRegion == MAP_FAILED)
+	{
+		ELEKTRA_LOG_WARNING ("error mapping file %s\nmmapSize: " ELEKTRA_STAT_ST_SIZE_F, tmpFile, sbuf.st_size);
+		yield_error ("mmap() error");
+		return;
+	}
+	if (fp)
+	{
+		fclose (fp);
+	}
+
+	mappedRegion[OFFSET_KEYSET]++;
+
+	if (msync ((void *) mappedRegion, sbuf.st_size, MS_SYNC) != 0)
+	{
+		yield_error ("msync() error");
+		return;
+	}
+
+	if (munmap (mappedRegion, sbuf.st_size) != 0)
+	{
+		yield_error ("munmap() error");
+		return;
+	}
+
+	// the corrupted block should be detected now
+	{
+		// we expect an error here
+		Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("mmapstorage_crc");
+
+		KeySet * ks = ksNew (0, KS_END);
+		succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR,
+			    "kdbGet did not detect wrong block checksum");
+
+		keyDel (parentKey);
+		ksDel (ks);
+		PLUGIN_CLOSE ();
+	}
+}
+
 /* -- Main ------------------------------------------------------------------------------------------------------------------------------ */
 
 int main (int argc, char ** argv)
@@ -138,6 +210,7 @@ int main (int argc, char ** argv)
 	const char * tmpFile = elektraFilename ();
 	test_mmap_crc_no_checksum (tmpFile);
 	test_mmap_crc_wrong_checksum (tmpFile);
+	test_mmap_crc_wrong_block_checksum (tmpFile);
 
 	printf ("\ntestmod_mmapstorage_crc RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
@@ -30,56 +30,48 @@ typedef enum
 const char * function[] = { "pref", "user_pref", "lockPref", "sticky_pref" };
 const char * prefix[] = { "pref", "user", "lock", "sticky" };
 
-static Key * prefToKey (Key * parentKey, PrefType type, const char * pref)
+static Key * prefToKey (Key * parentKey, PrefType type, char * pref)
 {
+	// the line handed in by the caller is scratch space inside the scanner's
+	// buffer, so the pref can be split and unquoted in place without copies
 	Key * key = keyNew (keyName (parentKey), KEY_END);
 	keyAddBaseName (key, prefix[type]);
-	char * localString = elektraStrDup (pref);
-	char * cPtr = strstr (localString, ",");
+	char * cPtr = strstr (pref, ",");
 	*cPtr = '\0';
-	char * sPtr = localString;
+	char * sPtr = pref;
 	++sPtr;
 	*sPtr++ = '\0';
 	char * ePtr = cPtr - 1;
 	elektraRstrip (sPtr, &ePtr);
-	size_t keyLen = ePtr - sPtr;
-	char * prefKey = elektraMalloc (keyLen + 1);
-	snprintf (prefKey, keyLen + 1, "%s", sPtr);
-	char * tPtr = strtok (prefKey, ".");
+	*ePtr = '\0'; // drop the closing quote of the pref name
+	char * tPtr = strtok (sPtr, ".");
 	if (tPtr) keyAddBaseName (key, tPtr);
 	while ((tPtr = strtok (NULL, ".")) != NULL)
 	{
 		keyAddBaseName (key, tPtr);
 	}
-	elektraFree (prefKey);
 	sPtr = cPtr + 1;
 	sPtr = elektraLskip (sPtr);
 	ePtr = strrchr (sPtr, ')');
 	*ePtr-- = '\0';
 	elektraRstrip (sPtr, &ePtr);
-	size_t argLen = ePtr - sPtr + 1;
-	char * prefArg = elektraMalloc (argLen + 1);
-	snprintf (prefArg, argLen + 1, "%s", sPtr);
-	if (!strcmp (prefArg, "true") || !(strcmp (prefArg, "false")))
+	if (!strcmp (sPtr, "true") || !(strcmp (sPtr, "false")))
 	{
 		keySetMeta (key, "type", "boolean");
-		keySetString (key, prefArg);
+		keySetString (key, sPtr);
 	}
-	else if (prefArg[0] == '"' && prefArg[strlen (prefArg) - 1] == '"')
+	else if (sPtr[0] == '"' && sPtr[strlen (sPtr) - 1] == '"')
 	{
 		// TODO: else if list
 		keySetMeta (key, "type", "string");
-		*prefArg = '\0';
-		*(prefArg + (strlen (prefArg + 1))) = '\0';
-		keySetString (key, (prefArg + 1));
+		sPtr[strlen (sPtr) - 1] = '\0';
+		keySetString (key, sPtr + 1);
 	}
 	else
 	{
 		keySetMeta (key, "type", "integer");
-		keySetString (key, prefArg);
+		keySetString (key, sPtr);
 	}
-	elektraFree (prefArg);
-	elektraFree (localString);
 	return key;
 }
 
@@ -102,41 +94,26 @@ int elektraMozprefsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key *
 	}
 	// get all keys
 	const char * fileName = keyString (parentKey);
-	FILE * fp = fopen (fileName, "r");
-	int len = 1024;
-	char * buffer = elektraMalloc (len * sizeof (char));
+	ElektraLineScanner scanner;
+	if (!elektraLineScannerOpen (&scanner, fileName)) return 1;
+	char * line;
 	Key * key;
 
-	while (fgets (buffer, len, fp))
+	while ((line = elektraLineScannerNext (&scanner, NULL)) != NULL)
 	{
-		if (buffer[strlen (buffer) - 1] != '\n')
-		{
-			fseek (fp, ((len - 1) * (-1)), SEEK_CUR);
-			len *= 2;
-			elektraRealloc ((void **) &buffer, len * sizeof (char));
-			continue;
-		}
-		else
-		{
-			buffer[strlen (buffer) - 1] = '\0';
-		}
-		char * ptr = buffer;
-		ptr = elektraLskip (ptr);
-		if (!strncmp (buffer, "//", 2)) continue;
+		char * ptr = elektraLskip (line);
+		if (!strncmp (line, "//", 2)) continue;
 		for (PrefType p = PREF; p < PREF_END; ++p)
 		{
 			if (!strncmp (ptr, function[p], strlen (function[p])))
 			{
 				key = prefToKey (parentKey, p, ptr + strlen (function[p]));
 				ksAppendKey (returned, key);
-				goto loop_end;
+				break;
 			}
 		}
-	loop_end:
-		continue;
 	}
-	elektraFree (buffer);
-	fclose (fp);
+	elektraLineScannerClose (&scanner);
 	return 1; // success
 }
 
@@ -497,6 +497,13 @@ static Codes doGetStorage (MultiConfig * mc, Key * parentKey)
 		// When we reach this stage, we will need to load
 		// any successfully resolved files (as it is done in the kdb core)
 		if (s->rcResolver < 0) continue;
+		// the child resolver reported this file as unchanged: reuse the
+		// keys parsed in the previous get instead of parsing it again
+		if ((s->rcResolver == NOUPDATE || s->rcResolver == CACHE_HIT) && s->ks != NULL)
+		{
+			rc = SUCCESS;
+			continue;
+		}
 		keySetName (parentKey, s->parentString);
 		keySetString (parentKey, s->fullPath);
 		Plugin * storage = s->storage;
@@ -12,42 +12,192 @@
 #include "kdbconfig.h"
 #endif
 
-/* Obtain address(es) matching host/port */
-int elektraNetworkAddrInfo (Key * toCheck)
-{
-	struct addrinfo * result;
-	int s;
+#include <pthread.h>
+#include <time.h>
 
-	const Key * meta = keyGetMeta (toCheck, "check/ipaddr");
+/* getaddrinfo does not expose the TTL of the DNS records it used, so cached
+ * results expire after a fixed, conservative time instead. */
+#define RESOLVER_CACHE_TTL 60
+#define RESOLVER_CACHE_SIZE 64
 
-	if (!meta) return 0; /* No check to do */
+#define RESOLVER_MAX_THREADS 8
 
-	struct addrinfo hints;
-	memset (&hints, 0, sizeof (struct addrinfo));
-	hints.ai_family = AF_UNSPEC; /* Allow IPv4 or IPv6 */
+struct ResolverCacheEntry
+{
+	char * host;
+	int family;
+	int result;
+	time_t expires;
+};
+
+static struct ResolverCacheEntry resolverCache[RESOLVER_CACHE_SIZE];
+static size_t resolverCacheNext = 0;
+static pthread_mutex_t resolverCacheLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Fill getaddrinfo hints according to the value of the check/ipaddr metakey */
+static void buildAddrInfoHints (struct addrinfo * hints, const Key * meta)
+{
+	memset (hints, 0, sizeof (struct addrinfo));
+	hints->ai_family = AF_UNSPEC; /* Allow IPv4 or IPv6 */
 	if (!strcmp (keyString (meta), "ipv4"))
 	{
-		hints.ai_family = AF_INET;
-		hints.ai_flags = AI_NUMERICHOST; /* Only accept numeric hosts */
+		hints->ai_family = AF_INET;
+		hints->ai_flags = AI_NUMERICHOST; /* Only accept numeric hosts */
 	}
 	else if (!strcmp (keyString (meta), "ipv6"))
 	{
-		hints.ai_family = AF_INET6;
-		hints.ai_flags = AI_NUMERICHOST; /* Only accept numeric hosts */
+		hints->ai_family = AF_INET6;
+		hints->ai_flags = AI_NUMERICHOST; /* Only accept numeric hosts */
+	}
+	hints->ai_socktype = SOCK_DGRAM; /* Datagram socket */
+	hints->ai_protocol = 0;		 /* Any protocol */
+}
+
+/* Look up a still valid cached result for host, or a negative value if there is none */
+static int resolverCacheLookup (const char * host, int family)
+{
+	int result = -1;
+	time_t now = time (NULL);
+	pthread_mutex_lock (&resolverCacheLock);
+	for (size_t i = 0; i < RESOLVER_CACHE_SIZE; ++i)
+	{
+		struct ResolverCacheEntry * entry = &resolverCache[i];
+		if (entry->host && entry->family == family && entry->expires > now && !strcmp (entry->host, host))
+		{
+			result = entry->result;
+			break;
+		}
 	}
-	hints.ai_socktype = SOCK_DGRAM; /* Datagram socket */
-	hints.ai_protocol = 0;		/* Any protocol */
+	pthread_mutex_unlock (&resolverCacheLock);
+	return result;
+}
 
-	s = getaddrinfo (keyString (toCheck), NULL, &hints, &result);
+static void resolverCacheStore (const char * host, int family, int result)
+{
+	pthread_mutex_lock (&resolverCacheLock);
+	struct ResolverCacheEntry * entry = &resolverCache[resolverCacheNext];
+	resolverCacheNext = (resolverCacheNext + 1) % RESOLVER_CACHE_SIZE;
+	if (entry->host) elektraFree (entry->host);
+	entry->host = elektraStrDup (host);
+	entry->family = family;
+	entry->result = result;
+	entry->expires = time (NULL) + RESOLVER_CACHE_TTL;
+	pthread_mutex_unlock (&resolverCacheLock);
+}
 
-	if (s != 0)
+/* Resolve host, consulting and filling the result cache for real DNS lookups.
+ * Purely numeric checks (AI_NUMERICHOST) never hit DNS and bypass the cache. */
+static int resolveAddrInfo (const char * host, const struct addrinfo * hints)
+{
+	if (!(hints->ai_flags & AI_NUMERICHOST))
 	{
-		return s;
+		int cached = resolverCacheLookup (host, hints->ai_family);
+		if (cached >= 0) return cached;
 	}
 
-	freeaddrinfo (result);
+	struct addrinfo * result;
+	int s = getaddrinfo (host, NULL, hints, &result);
+	if (s == 0) freeaddrinfo (result);
 
-	return 0;
+	if (!(hints->ai_flags & AI_NUMERICHOST))
+	{
+		resolverCacheStore (host, hints->ai_family, s);
+	}
+
+	return s;
+}
+
+struct ResolverJobs
+{
+	const char ** hosts;
+	size_t count;
+	size_t next;
+	pthread_mutex_t lock;
+};
+
+static void * resolverWorker (void * arg)
+{
+	struct ResolverJobs * jobs = arg;
+	for (;;)
+	{
+		pthread_mutex_lock (&jobs->lock);
+		size_t i = jobs->next++;
+		pthread_mutex_unlock (&jobs->lock);
+		if (i >= jobs->count) return NULL;
+
+		/* hostnames always get the AF_UNSPEC hints, see buildAddrInfoHints */
+		struct addrinfo hints;
+		memset (&hints, 0, sizeof (struct addrinfo));
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_DGRAM;
+		resolveAddrInfo (jobs->hosts[i], &hints);
+	}
+}
+
+/* Warm the result cache for all keys whose check/ipaddr needs a real DNS
+ * lookup, resolving concurrently so n unresolvable hosts cost one DNS
+ * timeout instead of n. Errors are reported by the per-key checks later. */
+static void resolveAllConcurrently (KeySet * returned)
+{
+	size_t count = 0;
+	const char ** hosts = elektraMalloc (ksGetSize (returned) * sizeof (const char *));
+	if (!hosts) return;
+
+	for (elektraCursor it = 0; it < ksGetSize (returned); ++it)
+	{
+		Key * cur = ksAtCursor (returned, it);
+		const Key * meta = keyGetMeta (cur, "check/ipaddr");
+		if (!meta) continue;
+
+		struct addrinfo hints;
+		buildAddrInfoHints (&hints, meta);
+		if (hints.ai_flags & AI_NUMERICHOST) continue; /* no DNS involved */
+		if (resolverCacheLookup (keyString (cur), hints.ai_family) >= 0) continue;
+
+		size_t i = 0;
+		while (i < count && strcmp (hosts[i], keyString (cur)) != 0)
+			++i;
+		if (i == count) hosts[count++] = keyString (cur);
+	}
+
+	if (count > 1)
+	{
+		struct ResolverJobs jobs;
+		jobs.hosts = hosts;
+		jobs.count = count;
+		jobs.next = 0;
+		pthread_mutex_init (&jobs.lock, NULL);
+
+		pthread_t threads[RESOLVER_MAX_THREADS];
+		size_t nthreads = count < RESOLVER_MAX_THREADS ? count : RESOLVER_MAX_THREADS;
+		size_t started = 0;
+		for (size_t i = 0; i < nthreads; ++i)
+		{
+			if (pthread_create (&threads[i], NULL, resolverWorker, &jobs) != 0) break;
+			++started;
+		}
+		if (started == 0) resolverWorker (&jobs); /* fall back to sequential resolution */
+		for (size_t i = 0; i < started; ++i)
+		{
+			pthread_join (threads[i], NULL);
+		}
+		pthread_mutex_destroy (&jobs.lock);
+	}
+
+	elektraFree (hosts);
+}
+
+/* Obtain address(es) matching host/port */
+int elektraNetworkAddrInfo (Key * toCheck)
+{
+	const Key * meta = keyGetMeta (toCheck, "check/ipaddr");
+
+	if (!meta) return 0; /* No check to do */
+
+	struct addrinfo hints;
+	buildAddrInfoHints (&hints, meta);
+
+	return resolveAddrInfo (keyString (toCheck), &hints);
 }
 
 int elektraPortInfo (Key * toCheck, Key * parentKey)
@@ -164,7 +314,9 @@ int elektraNetworkGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key *
 
 int elektraNetworkSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
 {
-	/* check all keys */
+	/* resolve all hostnames in one concurrent pass, then check all keys */
+	resolveAllConcurrently (returned);
+
 	Key * cur;
 	ksRewind (returned);
 	while ((cur = ksNext (returned)) != 0)
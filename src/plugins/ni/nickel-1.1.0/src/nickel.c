@@ -235,7 +235,7 @@ elektraNi_PUBLIC elektraNi_node elektraNi_GetChild (elektraNi_node restrict n, c
 
 		hash = Hash (name, (size_t) name_len, 0xbadc0de5);
 
-		if ((e = Ds_SearchHashTable (&n->children, name, name_len, hash, Compare)) != NULL)
+		if (n->children.num > 0 && (e = Ds_SearchHashTable (&n->children, name, name_len, hash, Compare)) != NULL)
 			child = GetItem (e);
 		else if (add_if_new)
 		{
@@ -740,9 +740,10 @@ static elektraNi_node AddNode (elektraNi_node restrict n, elektraNi_node restric
 		n->name[n->name_len = name_len] = '\0';
 
 		// check for space (requires 25% free space in the table) and grow the
-		// table by a factor of 2 if it's too small
+		// table by a factor of 2 if it's too small; leaf nodes never
+		// allocate buckets at all, so the first child starts the table
 		if (parent->children.num >= ((parent->children.cap >> 2) + (parent->children.cap >> 1)) &&
-		    !Ds_ResizeHashTable (&parent->children, parent->children.cap << 1))
+		    !Ds_ResizeHashTable (&parent->children, parent->children.cap ? parent->children.cap << 1 : INITIAL_BUCKETS))
 			break;
 
 		// insert it
@@ -772,8 +773,9 @@ static int InitNode (elektraNi_node restrict n, elektraNi_node restrict parent)
 	n->root = (parent ? parent->root : n);
 	n->parent = parent;
 
-	// make space for children
-	return Ds_InitHashTable (&n->children, INITIAL_BUCKETS);
+	// children bucket space is allocated lazily on the first insert in
+	// AddNode(); most nodes are key=value leaves that never need it
+	return Ds_InitHashTable (&n->children, 0);
 }
 
 /* Frees the contents of the node.
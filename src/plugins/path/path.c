@@ -14,6 +14,9 @@
 
 #endif
 
+#include <string.h>
+#include <time.h>
+
 static int createModeBits (const char * modes);
 
 static int handleNoUserCase (Key * parentKey, const char * validPath, const char * modes, Key * key);
@@ -41,7 +44,90 @@ static bool isUserInGroup (unsigned int val, gid_t * groups, unsigned int size)
 	return false;
 }
 
-static int validateKey (Key * key, Key * parentKey)
+typedef struct
+{
+	time_t ttl; /* lifetime of a cache entry in seconds */
+	KeySet * entries; /* one key per cached path, holding a CachedStat */
+} StatCache;
+
+typedef struct
+{
+	time_t fetched; /* when stat was last called for this path */
+	int result; /* return value of that stat call */
+	int error; /* errno of that stat call, if result was -1 */
+	struct stat buf;
+} CachedStat;
+
+int elektraPathOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	KeySet * config = elektraPluginGetConfig (handle);
+	Key * ttlKey = ksLookupByName (config, "/cache/ttl", 0);
+
+	/* without the config the plugin stats the filesystem directly, as before */
+	if (ttlKey == NULL) return 1;
+
+	StatCache * cache = elektraMalloc (sizeof (StatCache));
+	cache->ttl = atol (keyString (ttlKey));
+	cache->entries = ksNew (0, KS_END);
+	elektraPluginSetData (handle, cache);
+	return 1;
+}
+
+int elektraPathClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	StatCache * cache = elektraPluginGetData (handle);
+	if (cache != NULL)
+	{
+		ksDel (cache->entries);
+		elektraFree (cache);
+		elektraPluginSetData (handle, NULL);
+	}
+	return 1;
+}
+
+/**
+ * stat() replacement backed by the per-instance cache.
+ *
+ * Results are reused until they are older than the configured TTL.
+ * Failed calls are cached as well (with their errno), so repeatedly
+ * validating a missing path does not hit the filesystem every time.
+ * With @p cache == NULL every call goes to the filesystem directly.
+ */
+static int cachedStat (StatCache * cache, const char * path, struct stat * buf)
+{
+	if (cache == NULL)
+	{
+		return stat (path, buf);
+	}
+
+	Key * lookup = keyNew ("/", KEY_END);
+	keyAddBaseName (lookup, path);
+	Key * found = ksLookup (cache->entries, lookup, 0);
+
+	CachedStat entry;
+	if (found != NULL)
+	{
+		memcpy (&entry, keyValue (found), sizeof (entry));
+		if (time (NULL) - entry.fetched <= cache->ttl)
+		{
+			keyDel (lookup);
+			*buf = entry.buf;
+			if (entry.result == -1) errno = entry.error;
+			return entry.result;
+		}
+	}
+
+	entry.result = stat (path, &entry.buf);
+	entry.error = errno;
+	entry.fetched = time (NULL);
+	keySetBinary (lookup, &entry, sizeof (entry));
+	ksAppendKey (cache->entries, lookup);
+
+	*buf = entry.buf;
+	return entry.result;
+}
+
+static int validateKeyCached (Key * key, Key * parentKey, StatCache * cache)
 {
 	struct stat buf;
 	/* TODO: make exceptions configurable using path/allow */
@@ -65,7 +151,7 @@ static int validateKey (Key * key, Key * parentKey)
 	}
 	int errnosave = errno;
 	const Key * meta = keyGetMeta (key, "check/path");
-	if (stat (keyString (key), &buf) == -1)
+	if (cachedStat (cache, keyString (key), &buf) == -1)
 	{
 		char * errmsg = elektraMalloc (ERRORMSG_LENGTH + 1 + keyGetNameSize (key) + keyGetValueSize (key) +
 					       sizeof ("name:  value:  message: "));
@@ -100,6 +186,11 @@ static int validateKey (Key * key, Key * parentKey)
 	return 1;
 }
 
+static int validateKey (Key * key, Key * parentKey)
+{
+	return validateKeyCached (key, parentKey, NULL);
+}
+
 /**
  * This method validates the file permission for a certain user
  * @param key The key containing all metadata
@@ -107,7 +198,7 @@ static int validateKey (Key * key, Key * parentKey)
  * @retval 1 if success
  * @retval -1 for failure
  */
-static int validatePermission (Key * key, Key * parentKey)
+static int validatePermission (Key * key, Key * parentKey, StatCache * cache)
 {
 
 	uid_t currentUID = geteuid ();
@@ -176,7 +267,7 @@ static int validatePermission (Key * key, Key * parentKey)
 
 	// Get groupID of file being checked
 	struct stat sb;
-	stat (validPath, &sb);
+	cachedStat (cache, validPath, &sb);
 	struct group * gr = getgrgid (sb.st_gid);
 
 	bool isUserInGroupBool = isUserInGroup ((int) gr->gr_gid, groups, (unsigned int) ngroups);
@@ -351,6 +442,8 @@ int elektraPathGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 	KeySet * n;
 	ksAppend (returned, n = ksNew (30, keyNew ("system:/elektra/modules/path", KEY_VALUE, "path plugin waits for your orders", KEY_END),
 				       keyNew ("system:/elektra/modules/path/exports", KEY_END),
+				       keyNew ("system:/elektra/modules/path/exports/open", KEY_FUNC, elektraPathOpen, KEY_END),
+				       keyNew ("system:/elektra/modules/path/exports/close", KEY_FUNC, elektraPathClose, KEY_END),
 				       keyNew ("system:/elektra/modules/path/exports/get", KEY_FUNC, elektraPathGet, KEY_END),
 				       keyNew ("system:/elektra/modules/path/exports/set", KEY_FUNC, elektraPathSet, KEY_END),
 				       keyNew ("system:/elektra/modules/path/exports/validateKey", KEY_FUNC, validateKey, KEY_END),
@@ -363,8 +456,10 @@ int elektraPathGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 	return 1; /* success */
 }
 
-int elektraPathSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraPathSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
+	StatCache * cache = elektraPluginGetData (handle);
+
 	/* set all keys */
 	Key * cur;
 	ksRewind (returned);
@@ -373,12 +468,12 @@ int elektraPathSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 	{
 		const Key * pathMeta = keyGetMeta (cur, "check/path");
 		if (!pathMeta) continue;
-		rc = validateKey (cur, parentKey);
+		rc = validateKeyCached (cur, parentKey, cache);
 		if (rc <= 0) return -1;
 
 		const Key * accessMeta = keyGetMeta (cur, "check/path/mode");
 		if (!accessMeta) continue;
-		rc = validatePermission (cur, parentKey);
+		rc = validatePermission (cur, parentKey, cache);
 		if (!rc) return -1;
 	}
 
@@ -389,6 +484,8 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport ("path",
+				    ELEKTRA_PLUGIN_OPEN, &elektraPathOpen,
+				    ELEKTRA_PLUGIN_CLOSE, &elektraPathClose,
 				    ELEKTRA_PLUGIN_GET, &elektraPathGet,
 				    ELEKTRA_PLUGIN_SET, &elektraPathSet,
 				    ELEKTRA_PLUGIN_END);
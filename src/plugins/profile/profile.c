@@ -14,6 +14,8 @@
 #include <kdb.h>     //actual namespaces
 #include <kdbease.h> //elektraKeyGetRelativeName
 #include <kdbos.h>   //elektraNamespace
+#include <kdbprivate.h> //ksFindHierarchy
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -22,22 +24,99 @@
 #define PROFILEPATH "*/sw/*/*/#*/profile"
 #define CURRENTPATH "*/sw/*/*/#*/current"
 
+#define PROFILE_VIEW_CACHE_SIZE 16
+
+typedef struct
+{
+	char * fingerprint; /* selected profile plus a hash of the source subtrees */
+	KeySet * links;	    /* compiled override keys, shared with the returned keyset */
+} ProfileView;
+
+typedef struct
+{
+	KeySet * appendedKeys;
+	ProfileView views[PROFILE_VIEW_CACHE_SIZE];
+	size_t nextView;
+} ProfileState;
+
 int elektraProfileOpen (Plugin * handle ELEKTRA_UNUSED, Key * errorKey ELEKTRA_UNUSED)
 {
 	// plugin initialization logic
-	KeySet * appendedKeys = NULL;
-	elektraPluginSetData (handle, appendedKeys);
+	ProfileState * state = elektraCalloc (sizeof (ProfileState));
+	elektraPluginSetData (handle, state);
 	return 1; // success
 }
 
+static void clearViews (ProfileState * state)
+{
+	for (size_t i = 0; i < PROFILE_VIEW_CACHE_SIZE; ++i)
+	{
+		if (!state->views[i].fingerprint) continue;
+		elektraFree (state->views[i].fingerprint);
+		ksDel (state->views[i].links);
+		state->views[i].fingerprint = NULL;
+		state->views[i].links = NULL;
+	}
+	state->nextView = 0;
+}
+
 int elektraProfileClose (Plugin * handle ELEKTRA_UNUSED, Key * errorKey ELEKTRA_UNUSED)
 {
 	// free all plugin resources and shut it down
-	KeySet * appendedKeys = elektraPluginGetData (handle);
-	if (appendedKeys) ksDel (appendedKeys);
+	ProfileState * state = elektraPluginGetData (handle);
+	if (state)
+	{
+		if (state->appendedKeys) ksDel (state->appendedKeys);
+		clearViews (state);
+		elektraFree (state);
+	}
 	return 1; // success
 }
 
+static ProfileView * findView (ProfileState * state, const char * fingerprint)
+{
+	for (size_t i = 0; i < PROFILE_VIEW_CACHE_SIZE; ++i)
+	{
+		if (state->views[i].fingerprint && !strcmp (state->views[i].fingerprint, fingerprint))
+		{
+			return &state->views[i];
+		}
+	}
+	return NULL;
+}
+
+/* takes ownership of fingerprint and links */
+static ProfileView * storeView (ProfileState * state, char * fingerprint, KeySet * links)
+{
+	ProfileView * view = &state->views[state->nextView];
+	state->nextView = (state->nextView + 1) % PROFILE_VIEW_CACHE_SIZE;
+	if (view->fingerprint)
+	{
+		elektraFree (view->fingerprint);
+		ksDel (view->links);
+	}
+	view->fingerprint = fingerprint;
+	view->links = links;
+	return view;
+}
+
+/* FNV-1a over the key names of the hierarchy below root, so a compiled view
+ * is invalidated whenever keys appear in or vanish from its source subtrees */
+static uint32_t hashHierarchyNames (KeySet * ks, const Key * root, uint32_t hash)
+{
+	elektraCursor end;
+	for (elektraCursor it = ksFindHierarchy (ks, root, &end); it < end; ++it)
+	{
+		const char * name = keyName (ksAtCursor (ks, it));
+		while (*name)
+		{
+			hash = (hash ^ (uint32_t) (unsigned char) *name++) * 16777619u;
+		}
+		hash = (hash ^ 0xffu) * 16777619u;
+	}
+	return hash;
+}
+
 static Key * keyDupWithNS (const Key * origKey, elektraNamespace ns)
 {
 	Key * newKey = NULL;
@@ -79,7 +158,7 @@ static Key * keyDupWithNS (const Key * origKey, elektraNamespace ns)
 	return newKey;
 }
 
-static void linkProfileKeys (KeySet * swKS, KeySet * profileKeys, KeySet * appendedKeys)
+static void linkProfileKeys (KeySet * swKS, KeySet * profileKeys, ProfileState * state)
 {
 	Key * profileCutKey = NULL;
 	Key * profileKey = NULL;
@@ -95,32 +174,54 @@ static void linkProfileKeys (KeySet * swKS, KeySet * profileKeys, KeySet * appen
 			Key * currentProfileKey = keyDup (profileCutKey, KEY_CP_ALL);
 			keyAddBaseName (currentProfileKey, "current");
 			keyAddBaseName (profileCutKey, profileString);
-			KeySet * profileKS = ksCut (swKS, profileCutKey);
-			ksRewind (profileKS);
-			Key * cur;
-			while ((cur = ksNext (profileKS)) != NULL)
+
+			/* a compiled view only depends on the selected profile and on which
+			 * keys exist below the profile and current subtrees */
+			uint32_t hash = 2166136261u;
+			hash = hashHierarchyNames (swKS, profileCutKey, hash);
+			hash = hashHierarchyNames (swKS, currentProfileKey, hash);
+			char * fingerprint = elektraFormat ("%s %" PRIu32, keyName (profileCutKey), hash);
+
+			ProfileView * view = findView (state, fingerprint);
+			if (view)
 			{
-				if (!strcmp (keyName (cur), keyName (profileCutKey))) continue;
-				Key * overrideKey = keyDupWithNS (currentProfileKey, KEY_NS_SPEC);
-				const char * relativeName = elektraKeyGetRelativeName (cur, profileCutKey);
-				keyAddName (overrideKey, relativeName);
-				Key * lookupKey = keyDupWithNS (overrideKey, keyGetNamespace (currentProfileKey));
-				if (ksLookup (swKS, lookupKey, KDB_O_NONE))
+				elektraFree (fingerprint);
+			}
+			else
+			{
+				KeySet * links = ksNew (0, KS_END);
+				KeySet * profileKS = ksCut (swKS, profileCutKey);
+				ksRewind (profileKS);
+				Key * cur;
+				while ((cur = ksNext (profileKS)) != NULL)
 				{
+					if (!strcmp (keyName (cur), keyName (profileCutKey))) continue;
+					Key * overrideKey = keyDupWithNS (currentProfileKey, KEY_NS_SPEC);
+					const char * relativeName = elektraKeyGetRelativeName (cur, profileCutKey);
+					keyAddName (overrideKey, relativeName);
+					Key * lookupKey = keyDupWithNS (overrideKey, keyGetNamespace (currentProfileKey));
+					if (ksLookup (swKS, lookupKey, KDB_O_NONE))
+					{
+						keyDel (lookupKey);
+						keyDel (overrideKey);
+						continue;
+					}
 					keyDel (lookupKey);
-					keyDel (overrideKey);
-					continue;
+					keySetMeta (overrideKey, "override/#0", keyName (cur));
+					ksAppendKey (links, overrideKey);
 				}
-				keyDel (lookupKey);
-				keySetMeta (overrideKey, "override/#0", keyName (cur));
-				ksAppendKey (swKS, keyDup (overrideKey, KEY_CP_ALL));
-				ksAppendKey (appendedKeys, keyDup (overrideKey, KEY_CP_ALL));
-				keyDel (overrideKey);
+				ksAppend (swKS, profileKS);
+				ksDel (profileKS);
+				view = storeView (state, fingerprint, links);
 			}
+
+			/* switching back to a cached profile only bumps the reference counts
+			 * of the shared link keys instead of re-walking the subtree */
+			ksAppend (swKS, view->links);
+			ksAppend (state->appendedKeys, view->links);
+
 			keyDel (currentProfileKey);
 			keyDel (profileCutKey);
-			ksAppend (swKS, profileKS);
-			ksDel (profileKS);
 		}
 	}
 }
@@ -190,8 +291,8 @@ int elektraProfileGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA
 	ksRewind (swKS);
 	Key * cur;
 
-	KeySet * appendedKeys = elektraPluginGetData (handle);
-	if (!appendedKeys) appendedKeys = ksNew (0, KS_END);
+	ProfileState * state = elektraPluginGetData (handle);
+	if (!state->appendedKeys) state->appendedKeys = ksNew (0, KS_END);
 	KeySet * profileKeys = ksNew (0, KS_END);
 	while ((cur = ksNext (swKS)) != NULL)
 	{
@@ -200,9 +301,8 @@ int elektraProfileGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA
 			ksAppendKey (profileKeys, cur);
 		}
 	}
-	linkProfileKeys (swKS, profileKeys, appendedKeys);
+	linkProfileKeys (swKS, profileKeys, state);
 	ksDel (profileKeys);
-	ksDel (appendedKeys);
 	ksRewind (swKS);
 	KeySet * profileParents = ksNew (0, KS_END);
 	while ((cur = ksNext (swKS)) != NULL)
@@ -215,7 +315,7 @@ int elektraProfileGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA
 			keyDel (profileParent);
 		}
 	}
-	linkDefaultKeys (swKS, profileParents, appendedKeys);
+	linkDefaultKeys (swKS, profileParents, state->appendedKeys);
 	ksDel (profileParents);
 	ksAppend (returned, swKS);
 	ksDel (swKS);
@@ -226,16 +326,18 @@ int elektraProfileGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA
 int elektraProfileSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
 {
 	// get all keys
-	KeySet * appendedKeys = elektraPluginGetData (handle);
-	if (!appendedKeys) return 1;
-	ksRewind (appendedKeys);
+	ProfileState * state = elektraPluginGetData (handle);
+	if (!state || !state->appendedKeys) return 1;
+	ksRewind (state->appendedKeys);
 	Key * cur;
-	while ((cur = ksNext (appendedKeys)) != NULL)
+	while ((cur = ksNext (state->appendedKeys)) != NULL)
 	{
 		keyDel (ksLookup (returned, cur, KDB_O_POP));
 	}
-	ksDel (appendedKeys);
-	elektraPluginSetData (handle, NULL);
+	ksDel (state->appendedKeys);
+	state->appendedKeys = NULL;
+	/* the configuration is about to change on disk, drop the compiled views */
+	clearViews (state);
 	return 1; // success
 }
 
@@ -164,9 +164,31 @@ static int Python_CallFunction_Helper2 (moduleData * data, const char * funcName
 	return ret;
 }
 
+/* the interpreter is shared between all plugin instances of this process,
+ * each instance runs in its own sub interpreter */
+static std::mutex pythonStateLock;
+static unsigned pythonInstances = 0;
+
+static int Python_AcquireInterpreter (void)
+{
+	std::lock_guard<std::mutex> lock (pythonStateLock);
+	if (!Py_IsInitialized ())
+	{
+		Py_Initialize ();
+		if (!Py_IsInitialized ()) return 0;
+	}
+	++pythonInstances;
+	return 1;
+}
+
+static void Python_ReleaseInterpreter (void)
+{
+	std::lock_guard<std::mutex> lock (pythonStateLock);
+	if (pythonInstances > 0 && --pythonInstances == 0 && Py_IsInitialized ()) Py_Finalize ();
+}
+
 static void Python_Shutdown (moduleData * data)
 {
-	/* destroy python if plugin isn't used anymore */
 	if (Py_IsInitialized ())
 	{
 		// Do we have a sub interpreter?
@@ -180,9 +202,11 @@ static void Python_Shutdown (moduleData * data)
 
 			/* destroy sub interpreter */
 			Py_EndInterpreter (data->tstate);
+			data->tstate = nullptr;
 		}
-		Py_Finalize ();
 	}
+	/* destroy python if plugin isn't used anymore */
+	Python_ReleaseInterpreter ();
 }
 
 static moduleData * createModuleData (ckdb::Plugin * handle)
@@ -235,14 +259,10 @@ int PYTHON_PLUGIN_FUNCTION (Open) (ckdb::Plugin * handle, ckdb::Key * errorKey)
 
 	if (data->instance == nullptr)
 	{
-		/* initialize python interpreter if necessary */
-		if (!Py_IsInitialized ())
+		/* take a reference to the shared interpreter, initializing it on first use */
+		if (!Python_AcquireInterpreter ())
 		{
-			Py_Initialize ();
-			if (!Py_IsInitialized ())
-			{
-				goto error;
-			}
+			goto error;
 		}
 		/* init threads */
 		PyEval_InitThreads ();
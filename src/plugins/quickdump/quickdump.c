@@ -14,6 +14,8 @@
 
 #include <kdberrors.h>
 #include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #define MAGIC_NUMBER_BASE (0x454b444200000000UL) // EKDB (in ASCII) + Version placeholder
 
@@ -21,6 +23,17 @@
 #define MAGIC_NUMBER_V2 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 2))
 #define MAGIC_NUMBER_V3 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 3))
 
+// v4 front-codes key names (shared prefix length + suffix) and interns repeated
+// metakey names into a string table, which shrinks exports with deep hierarchies
+// considerably; v3 files are still read
+#define MAGIC_NUMBER_V4 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 4))
+
+// stream variant ("EKDBS"): same key format, but prefixed with a key count
+// instead of being terminated by the end of the file, so it can be read from a
+// pipe that stays open (see the pluginprocess library)
+#define MAGIC_NUMBER_STREAM_V3 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 0x5300000000UL + 3))
+#define MAGIC_NUMBER_STREAM_V4 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 0x5300000000UL + 4))
+
 struct metaLink
 {
 	const void * meta;
@@ -97,7 +110,251 @@ static inline bool readStringIntoBuffer (FILE * file, struct stringbuffer * buff
 	return true;
 }
 
-int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+// like readStringIntoBuffer, but keeps the first prefixLen bytes after the buffer
+// offset intact; used for the front-coded key names of the v4 format
+static inline bool readSuffixIntoBuffer (FILE * file, struct stringbuffer * buffer, size_t prefixLen, size_t * nameLen, Key * errorKey)
+{
+	kdb_unsigned_long_long_t size = 0;
+	if (!varintRead (file, &size))
+	{
+		ELEKTRA_SET_RESOURCE_ERROR (errorKey, feof (file) ? "Premature end of file" : "Unknown error");
+		return false;
+	}
+
+	size_t newSize = buffer->offset + prefixLen + size + 1;
+	ensureBufferSize (buffer, newSize);
+
+	if (size > 0)
+	{
+		if (fread (&buffer->string[buffer->offset + prefixLen], sizeof (char), size, file) < size)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (errorKey, feof (file) ? "Premature end of file" : "Unknown error");
+			return false;
+		}
+	}
+	buffer->string[newSize - 1] = '\0';
+	*nameLen = prefixLen + size;
+	return true;
+}
+
+// string table for the interned metakey names of the v4 format
+struct metaNameTable
+{
+	size_t alloc;
+	size_t size;
+	char ** names;
+};
+
+static void appendMetaName (struct metaNameTable * table, const char * name)
+{
+	if (table->size >= table->alloc)
+	{
+		table->alloc *= 2;
+		elektraRealloc ((void **) &table->names, table->alloc * sizeof (char *));
+	}
+	table->names[table->size] = elektraStrDup (name);
+	++table->size;
+}
+
+// resolves the metakey name of a v4 record: either a back reference into the
+// string table or a new name that is added to it
+static const char * readMetaName (FILE * file, struct stringbuffer * metaNameBuffer, struct metaNameTable * metaNames, Key * errorKey)
+{
+	kdb_unsigned_long_long_t id = 0;
+	if (!varintRead (file, &id))
+	{
+		ELEKTRA_SET_RESOURCE_ERROR (errorKey, feof (file) ? "Premature end of file" : "Unknown error");
+		return NULL;
+	}
+
+	if (id == 0)
+	{
+		if (!readStringIntoBuffer (file, metaNameBuffer, errorKey))
+		{
+			return NULL;
+		}
+		appendMetaName (metaNames, metaNameBuffer->string);
+		return metaNames->names[metaNames->size - 1];
+	}
+
+	if (id > metaNames->size)
+	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (errorKey, "Invalid metakey name reference");
+		return NULL;
+	}
+
+	return metaNames->names[id - 1];
+}
+
+static ssize_t findMetaName (struct metaNameTable * table, const char * name)
+{
+	// the number of distinct metakey names is usually small, a linear scan is fine
+	for (size_t i = 0; i < table->size; ++i)
+	{
+		if (elektraStrCmp (table->names[i], name) == 0)
+		{
+			return (ssize_t) i;
+		}
+	}
+	return -1;
+}
+
+// writes a v4 metakey name: a back reference into the string table if the name
+// was written before, otherwise 0 followed by the name itself
+static bool writeMetaName (FILE * file, const Key * meta, struct metaNameTable * metaNames, Key * errorKey)
+{
+	// ignore meta namespace when writing to file
+	const char * metaName = keyName (meta) + sizeof ("meta:/") - 1;
+	ssize_t id = findMetaName (metaNames, metaName);
+	if (id >= 0)
+	{
+		return varintWrite (file, id + 1);
+	}
+
+	if (!varintWrite (file, 0))
+	{
+		return false;
+	}
+
+	kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
+	if (!writeData (file, metaName, metaNameSize, errorKey))
+	{
+		return false;
+	}
+
+	appendMetaName (metaNames, metaName);
+	return true;
+}
+
+/**
+ * @internal
+ * State for the append-only journal mode (config key `/journal`).
+ *
+ * Records what the plugin last read from or wrote to a file, so that a
+ * later set on the same handle can append just the changed keys instead
+ * of rewriting the whole file. See tryJournalAppend().
+ */
+struct journalState
+{
+	char * filename;		/**< the file this state describes */
+	int version;			/**< format version of the file, appended records must match */
+	off_t fileSize;			/**< size of the file after our last read/write */
+	KeySet * keys;			/**< flat copy of the last persisted keyset, for removal detection */
+	struct metaNameTable metaNames; /**< continuation of the interned metakey name table */
+	size_t patchKeys;		/**< keys appended since the last full write */
+};
+
+static void clearJournalState (struct journalState * state)
+{
+	elektraFree (state->filename);
+	state->filename = NULL;
+	if (state->keys != NULL) ksDel (state->keys);
+	state->keys = NULL;
+	for (size_t i = 0; i < state->metaNames.size; ++i)
+	{
+		elektraFree (state->metaNames.names[i]);
+	}
+	elektraFree (state->metaNames.names);
+	state->metaNames.names = NULL;
+	state->metaNames.size = 0;
+	state->metaNames.alloc = 0;
+	state->patchKeys = 0;
+	state->fileSize = 0;
+}
+
+/**
+ * @internal
+ * Records the persisted state of @p filename after a successful full read
+ * or write. Takes ownership of the interned metakey names in @p metaNames
+ * and resets the table, so the caller must not free or reuse it.
+ */
+static void captureJournalState (Plugin * handle, const char * filename, int version, off_t fileSize, KeySet * ks,
+				 struct metaNameTable * metaNames)
+{
+	struct journalState * state = elektraPluginGetData (handle);
+	if (state == NULL)
+	{
+		state = elektraCalloc (sizeof (struct journalState));
+		elektraPluginSetData (handle, state);
+	}
+	else
+	{
+		clearJournalState (state);
+	}
+
+	state->filename = elektraStrDup (filename);
+	state->version = version;
+	state->fileSize = fileSize;
+	state->keys = ksDup (ks);
+	state->metaNames = *metaNames;
+	metaNames->names = NULL;
+	metaNames->size = 0;
+	metaNames->alloc = 0;
+}
+
+static void freeReadBuffers (struct stringbuffer * nameBuffer, struct stringbuffer * metaNameBuffer, struct stringbuffer * valueBuffer,
+			     struct stringbuffer * sourceNameBuffer, struct metaNameTable * metaNames)
+{
+	elektraFree (nameBuffer->string);
+	elektraFree (metaNameBuffer->string);
+	elektraFree (valueBuffer->string);
+	elektraFree (sourceNameBuffer->string);
+	for (size_t i = 0; i < metaNames->size; ++i)
+	{
+		elektraFree (metaNames->names[i]);
+	}
+	elektraFree (metaNames->names);
+}
+
+// skips over a length-prefixed data block without reading it into memory
+static inline bool skipData (FILE * file, Key * errorKey)
+{
+	kdb_unsigned_long_long_t size = 0;
+	if (!varintRead (file, &size))
+	{
+		ELEKTRA_SET_RESOURCE_ERROR (errorKey, feof (file) ? "Premature end of file" : "Unknown error");
+		return false;
+	}
+
+	if (size > 0 && fseek (file, (long) size, SEEK_CUR) != 0)
+	{
+		ELEKTRA_SET_RESOURCE_ERROR (errorKey, "Premature end of file");
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @internal
+ * Checks whether the escaped key name @p name is below or the same as
+ * @p below. If @p below is cascading, the namespace of @p name is ignored.
+ * Both names must be in canonical form.
+ */
+static bool nameIsBelowOrSame (const char * below, const char * name)
+{
+	if (below[0] == '/')
+	{
+		const char * colon = strchr (name, ':');
+		if (colon != NULL) name = colon + 1;
+	}
+
+	size_t belowLen = strlen (below);
+	if (strncmp (below, name, belowLen) != 0)
+	{
+		return false;
+	}
+	// either the names are the same, or name continues with a new part,
+	// or below is a namespace root (only then it ends with a slash)
+	return name[belowLen] == '\0' || name[belowLen] == '/' || below[belowLen - 1] == '/';
+}
+
+// returned by quickdumpRead() when a subtree-limited read hit a copymeta
+// record whose source key was skipped; the caller has to read again in full
+#define QUICKDUMP_READ_RESTART (-2)
+
+static int quickdumpRead (Plugin * handle, KeySet * returned, Key * parentKey, const char * below);
+
+int elektraQuickdumpGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	if (!elektraStrCmp (keyName (parentKey), "system:/elektra/modules/quickdump"))
 	{
@@ -106,6 +363,7 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			keyNew ("system:/elektra/modules/quickdump/exports", KEY_END),
 			keyNew ("system:/elektra/modules/quickdump/exports/get", KEY_FUNC, elektraQuickdumpGet, KEY_END),
 			keyNew ("system:/elektra/modules/quickdump/exports/set", KEY_FUNC, elektraQuickdumpSet, KEY_END),
+			keyNew ("system:/elektra/modules/quickdump/exports/close", KEY_FUNC, elektraQuickdumpClose, KEY_END),
 #include ELEKTRA_README
 			keyNew ("system:/elektra/modules/quickdump/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
 		ksAppend (returned, contract);
@@ -115,6 +373,37 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	}
 	// get all keys
 
+	// when the core only needs a subtree (deep parent key in kdbGet(), see the
+	// get/below and get/partial metadata there), skip all records outside of it
+	char * below = NULL;
+	const Key * belowMeta = keyGetMeta (parentKey, "get/below");
+	if (belowMeta != NULL)
+	{
+		Key * belowKey = keyNew (keyString (belowMeta), KEY_END);
+		if (belowKey != NULL)
+		{
+			if (keyIsBelow (parentKey, belowKey) == 1)
+			{
+				below = elektraStrDup (keyName (belowKey));
+			}
+			keyDel (belowKey);
+		}
+	}
+
+	int ret = quickdumpRead (handle, returned, parentKey, below);
+	if (ret == QUICKDUMP_READ_RESTART)
+	{
+		// a copymeta record referenced a key outside the requested subtree,
+		// fall back to reading the whole file
+		ksCopy (returned, NULL);
+		ret = quickdumpRead (handle, returned, parentKey, NULL);
+	}
+	elektraFree (below);
+	return ret;
+}
+
+static int quickdumpRead (Plugin * handle, KeySet * returned, Key * parentKey, const char * below)
+{
 	FILE * file = fopen (keyString (parentKey), "rb");
 
 	if (file == NULL)
@@ -139,6 +428,10 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	}
 	magic = be64toh (magic); // magic number is written big endian so EKDB magic string is readable
 
+	bool streamMode = false;
+	int version = 3;
+	kdb_unsigned_long_long_t keysLeft = 0;
+
 	switch (magic)
 	{
 	case MAGIC_NUMBER_V1:
@@ -148,7 +441,22 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		ELEKTRA_SET_RESOURCE_ERROR (parentKey, "Quickdump v2 no longer supported");
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	case MAGIC_NUMBER_V3:
-		// break, current version implemented below
+		// old version, still readable
+		break;
+	case MAGIC_NUMBER_V4:
+		version = 4;
+		break;
+	case MAGIC_NUMBER_STREAM_V4:
+		version = 4;
+		// FALLTHROUGH
+	case MAGIC_NUMBER_STREAM_V3:
+		if (!varintRead (file, &keysLeft))
+		{
+			fclose (file);
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Missing key count in stream");
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+		streamMode = true;
 		break;
 	default:
 		fclose (file);
@@ -156,6 +464,10 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	// skipping records needs fseek, which does not work on the pipes the
+	// stream variant is used on
+	const char * belowName = streamMode ? NULL : below;
+
 	// setup buffers
 	struct stringbuffer valueBuffer;
 	setupBuffer (&valueBuffer, 4);
@@ -169,21 +481,67 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	size_t parentSize = keyGetNameSize (parentKey); // includes null terminator
 	setupBuffer (&nameBuffer, parentSize + 4);
 
-	keyGetName (parentKey, nameBuffer.string, parentSize);
-	nameBuffer.string[parentSize - 1] = '/'; // replaces null terminator
-	nameBuffer.string[parentSize] = '\0';	 // set new null terminator
-	nameBuffer.offset = parentSize;		 // set offset to null terminator
+	if (ksLookupByName (elektraPluginGetConfig (handle), "/fullname", 0) != NULL)
+	{
+		// key names were written out in full (including the namespace), don't prefix the parent key
+		nameBuffer.string[0] = '\0';
+		nameBuffer.offset = 0;
+	}
+	else
+	{
+		keyGetName (parentKey, nameBuffer.string, parentSize);
+		nameBuffer.string[parentSize - 1] = '/'; // replaces null terminator
+		nameBuffer.string[parentSize] = '\0';	 // set new null terminator
+		nameBuffer.offset = parentSize;		 // set offset to null terminator
+	}
+
+	// v4 keeps the previous key name in nameBuffer for front-coding, so the source
+	// key names of copymeta records need their own buffer with the same prefix
+	struct stringbuffer sourceNameBuffer;
+	setupBuffer (&sourceNameBuffer, nameBuffer.offset + 4);
+	memcpy (sourceNameBuffer.string, nameBuffer.string, nameBuffer.offset + 1);
+	sourceNameBuffer.offset = nameBuffer.offset;
+
+	// interned metakey names of the v4 format
+	struct metaNameTable metaNames;
+	metaNames.alloc = 16;
+	metaNames.size = 0;
+	metaNames.names = elektraMalloc (metaNames.alloc * sizeof (char *));
 
-	char c;
-	while ((c = fgetc (file)) != EOF)
+	// length of the (relative) name of the previous key, i.e. the maximum shared prefix
+	size_t currentNameLen = 0;
+
+	for (;;)
 	{
-		ungetc (c, file);
+		if (streamMode)
+		{
+			if (keysLeft == 0) break;
+			--keysLeft;
+		}
+		else
+		{
+			// in the file based format the keys simply end with the file
+			int c = fgetc (file);
+			if (c == EOF) break;
+			ungetc (c, file);
+		}
 
-		if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+		if (version == 4)
 		{
-			elektraFree (nameBuffer.string);
-			elektraFree (metaNameBuffer.string);
-			elektraFree (valueBuffer.string);
+			// front-coded name: length of the prefix shared with the previous key, then the suffix
+			kdb_unsigned_long_long_t prefixLen = 0;
+			if (!varintRead (file, &prefixLen) || prefixLen > currentNameLen ||
+			    !readSuffixIntoBuffer (file, &nameBuffer, prefixLen, &currentNameLen, parentKey))
+			{
+				freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+				fclose (file);
+				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Invalid front-coded key name");
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+		}
+		else if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+		{
+			freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 			fclose (file);
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
 		}
@@ -191,27 +549,38 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		char type = fgetc (file);
 		if (type == EOF)
 		{
-			elektraFree (nameBuffer.string);
-			elektraFree (metaNameBuffer.string);
-			elektraFree (valueBuffer.string);
+			freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 			fclose (file);
 			ELEKTRA_SET_VALIDATION_SEMANTIC_ERROR (parentKey, "Missing key type");
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
 		}
 
-		Key * k;
+		// a skipped record still has to be walked through, so that the front
+		// coding and the metakey name table stay consistent
+		bool skip = belowName != NULL && !nameIsBelowOrSame (belowName, nameBuffer.string);
+
+		Key * k = NULL;
 
 		switch (type)
 		{
 		case 'b': {
+			if (skip)
+			{
+				if (!skipData (file, parentKey))
+				{
+					freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+				break;
+			}
+
 			// binary key value
 			kdb_unsigned_long_long_t valueSize = 0;
 			if (!varintRead (file, &valueSize))
 			{
 				ELEKTRA_SET_RESOURCE_ERROR (parentKey, feof (file) ? "Premature end of file" : "Unknown error");
-				elektraFree (nameBuffer.string);
-				elektraFree (metaNameBuffer.string);
-				elektraFree (valueBuffer.string);
+				freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 				fclose (file);
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
@@ -225,8 +594,8 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 				void * value = elektraMalloc (valueSize);
 				if (fread (value, sizeof (char), valueSize, file) < valueSize)
 				{
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
+					elektraFree (value);
+					freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 					fclose (file);
 					ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Error while reading file");
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
@@ -237,12 +606,21 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			break;
 		}
 		case 's': {
+			if (skip)
+			{
+				if (!skipData (file, parentKey))
+				{
+					freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+				break;
+			}
+
 			// string key value
 			if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
 			{
-				elektraFree (nameBuffer.string);
-				elektraFree (metaNameBuffer.string);
-				elektraFree (valueBuffer.string);
+				freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 				fclose (file);
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
@@ -250,19 +628,19 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			break;
 		}
 		default:
-			elektraFree (nameBuffer.string);
-			elektraFree (metaNameBuffer.string);
-			elektraFree (valueBuffer.string);
+			freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 			fclose (file);
 			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, "Unknown key type %c", type);
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
 		}
 
+		int c;
 		while ((c = fgetc (file)) != 0)
 		{
 			if (c == EOF)
 			{
 				keyDel (k);
+				freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 				fclose (file);
 				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERROR (parentKey, "Missing key end");
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
@@ -272,73 +650,131 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			{
 			case 'm': {
 				// meta key
-				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				const char * metaName = NULL;
+				if (version == 4)
 				{
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					// even for skipped keys the reference has to be resolved,
+					// it may add a new name to the string table
+					metaName = readMetaName (file, &metaNameBuffer, &metaNames, parentKey);
+					if (metaName == NULL)
+					{
+						keyDel (k);
+						freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+						fclose (file);
+						return ELEKTRA_PLUGIN_STATUS_ERROR;
+					}
+				}
+				else if (!skip)
+				{
+					if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+					{
+						keyDel (k);
+						freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+						fclose (file);
+						return ELEKTRA_PLUGIN_STATUS_ERROR;
+					}
+					metaName = metaNameBuffer.string;
+				}
+
+				if (skip)
+				{
+					// v3 stores the metakey name inline, the value follows in both versions
+					if ((version != 4 && !skipData (file, parentKey)) || !skipData (file, parentKey))
+					{
+						freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+						fclose (file);
+						return ELEKTRA_PLUGIN_STATUS_ERROR;
+					}
+					break;
 				}
 
 				if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
 				{
 					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
+					freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 					fclose (file);
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
-				const char * metaValue = valueBuffer.string;
 
-				keySetMeta (k, metaNameBuffer.string, metaValue);
+				keySetMeta (k, metaName, valueBuffer.string);
 				break;
 			}
 			case 'c': {
 				// copy meta
-				if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+				const char * metaName = NULL;
+				const char * sourceName = NULL;
+				if (version == 4)
 				{
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					// the metakey name reference comes first, then the source key name;
+					// nameBuffer must stay intact for the front-coding
+					metaName = readMetaName (file, &metaNameBuffer, &metaNames, parentKey);
+					if (metaName == NULL ||
+					    (skip ? !skipData (file, parentKey) : !readStringIntoBuffer (file, &sourceNameBuffer, parentKey)))
+					{
+						keyDel (k);
+						freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+						fclose (file);
+						return ELEKTRA_PLUGIN_STATUS_ERROR;
+					}
+					sourceName = sourceNameBuffer.string;
+				}
+				else if (skip)
+				{
+					if (!skipData (file, parentKey) || !skipData (file, parentKey))
+					{
+						freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+						fclose (file);
+						return ELEKTRA_PLUGIN_STATUS_ERROR;
+					}
+				}
+				else
+				{
+					// v3 stores the source key name first; it may clobber nameBuffer,
+					// because v3 rereads the full key name for every key anyway
+					if (!readStringIntoBuffer (file, &nameBuffer, parentKey) ||
+					    !readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+					{
+						keyDel (k);
+						freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+						fclose (file);
+						return ELEKTRA_PLUGIN_STATUS_ERROR;
+					}
+					sourceName = nameBuffer.string;
+					metaName = metaNameBuffer.string;
 				}
 
-				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				if (skip)
 				{
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					break;
 				}
 
-				const Key * sourceKey = ksLookupByName (returned, nameBuffer.string, 0);
+				const Key * sourceKey = ksLookupByName (returned, sourceName, 0);
 				if (sourceKey == NULL)
 				{
+					if (belowName != NULL)
+					{
+						// the source key is probably outside the requested subtree,
+						// the whole file has to be read again without skipping
+						keyDel (k);
+						freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
+						fclose (file);
+						return QUICKDUMP_READ_RESTART;
+					}
+
 					ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not copy meta data from key '%s': Key not found",
-								     nameBuffer.string);
+								     sourceName);
 					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
+					freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 					fclose (file);
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
 
-				if (keyCopyMeta (k, sourceKey, metaNameBuffer.string) != 1)
+				if (keyCopyMeta (k, sourceKey, metaName) != 1)
 				{
 					ELEKTRA_SET_INTERNAL_ERRORF (parentKey, "Could not copy meta data from key '%s': Error during copy",
-								     &nameBuffer.string[nameBuffer.offset]);
+								     sourceName);
 					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
+					freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 					fclose (file);
 					return ELEKTRA_PLUGIN_STATUS_ERROR;
 				}
@@ -346,193 +782,420 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			}
 			default:
 				keyDel (k);
-				elektraFree (nameBuffer.string);
-				elektraFree (metaNameBuffer.string);
-				elektraFree (valueBuffer.string);
+				freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 				fclose (file);
 				ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Unknown meta type %c", type);
 				return ELEKTRA_PLUGIN_STATUS_ERROR;
 			}
 		}
 
-		ksAppendKey (returned, k);
+		if (!skip)
+		{
+			ksAppendKey (returned, k);
+		}
 	}
 
-	elektraFree (nameBuffer.string);
-	elektraFree (metaNameBuffer.string);
-	elektraFree (valueBuffer.string);
+	if (!streamMode && belowName == NULL && ksLookupByName (elektraPluginGetConfig (handle), "/journal", 0) != NULL)
+	{
+		// remember what the file contains, so the next set can append to it;
+		// a partial read must not become the journal baseline
+		captureJournalState (handle, keyString (parentKey), version, ftell (file), returned, &metaNames);
+	}
+
+	freeReadBuffers (&nameBuffer, &metaNameBuffer, &valueBuffer, &sourceNameBuffer, &metaNames);
 
 	fclose (file);
 
+	if (belowName != NULL)
+	{
+		// tell the core that everything outside the requested subtree was left out
+		keySetMeta (parentKey, "get/partial", "1");
+	}
+
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 }
 
-int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
+/**
+ * @internal
+ * Offset into the key names that is not written to the file,
+ * depending on the /noparent and /fullname config keys.
+ */
+static size_t getParentOffset (KeySet * config, Key * parentKey)
 {
-	elektraCursor cursor = ksGetCursor (returned);
-	ksRewind (returned);
-
-	FILE * file;
+	// we assume all keys in returned are below parentKey
+	size_t parentOffset = keyGetNameSize (parentKey);
 
-	// cannot open stdout for writing, because its already open
-	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
-	{
-		file = stdout;
-	}
-	else
+	// ... unless /noparent is in config, then we just take the full
+	// (cascading) keynames as relative to the parentKey
+	if (ksLookupByName (config, "/noparent", 0) != NULL)
 	{
-		file = fopen (keyString (parentKey), "wb");
+		parentOffset = 1;
 	}
 
-	if (file == NULL)
+	// ... and with /fullname the names are written out in full, including the
+	// namespace, so keys from arbitrary namespaces survive a roundtrip
+	if (ksLookupByName (config, "/fullname", 0) != NULL)
 	{
-		ELEKTRA_SET_ERROR_SET (parentKey);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
+		parentOffset = 0;
 	}
 
-	// magic number is written big endian so EKDB magic string is readable
-	kdb_unsigned_long_long_t magic = htobe64 (MAGIC_NUMBER_V3);
-	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	return parentOffset;
+}
+
+/**
+ * @internal
+ * Writes one key record (front-coded name, value, metadata) to @p file.
+ */
+static bool writeKey (FILE * file, int version, Key * cur, size_t parentOffset, const char ** prevName, size_t * prevNameSize,
+		      struct list * metaKeys, struct metaNameTable * metaNames, Key * parentKey)
+{
+	size_t fullNameSize = keyGetNameSize (cur);
+	if (fullNameSize < parentOffset)
 	{
-		fclose (file);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
+		return false;
 	}
 
-	struct list metaKeys;
-	metaKeys.alloc = 16;
-	metaKeys.size = 0;
-	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
+	kdb_unsigned_long_long_t nameSize = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
+	const char * name = keyName (cur) + parentOffset;
 
-	// we assume all keys in returned are below parentKey
-	size_t parentOffset = keyGetNameSize (parentKey);
+	if (version == 4)
+	{
+		// write only the suffix after the prefix shared with the previous key name
+		size_t prefixLen = 0;
+		size_t maxPrefix = nameSize < *prevNameSize ? nameSize : *prevNameSize;
+		while (prefixLen < maxPrefix && name[prefixLen] == (*prevName)[prefixLen])
+		{
+			++prefixLen;
+		}
 
-	// ... unless /noparent is in config, then we just take the full
-	// (cascading) keynames as relative to the parentKey
-	KeySet * config = elektraPluginGetConfig (handle);
-	if (ksLookupByName (config, "/noparent", 0) != NULL)
+		if (!varintWrite (file, prefixLen) || !writeData (file, name + prefixLen, nameSize - prefixLen, parentKey))
+		{
+			return false;
+		}
+
+		*prevName = name;
+		*prevNameSize = nameSize;
+	}
+	else if (!writeData (file, name, nameSize, parentKey))
 	{
-		parentOffset = 1;
+		return false;
 	}
 
-	Key * cur;
-	while ((cur = ksNext (returned)) != NULL)
+	if (keyIsBinary (cur))
 	{
-		size_t fullNameSize = keyGetNameSize (cur);
-		if (fullNameSize < parentOffset)
+		if (fputc ('b', file) == EOF)
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			return false;
 		}
 
-		kdb_unsigned_long_long_t nameSize = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
-		if (!writeData (file, keyName (cur) + parentOffset, nameSize, parentKey))
+		kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur);
+
+		char * value = NULL;
+		if (valueSize > 0)
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			value = elektraMalloc (valueSize);
+			if (keyGetBinary (cur, value, valueSize) == -1)
+			{
+				elektraFree (value);
+				return false;
+			}
+		}
+
+		if (!writeData (file, value, valueSize, parentKey))
+		{
+			elektraFree (value);
+			return false;
+		}
+		elektraFree (value);
+	}
+	else
+	{
+		if (fputc ('s', file) == EOF)
+		{
+			return false;
+		}
+
+		kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur) - 1;
+		if (!writeData (file, keyString (cur), valueSize, parentKey))
+		{
+			return false;
 		}
+	}
 
-		if (keyIsBinary (cur))
+	keyRewindMeta (cur);
+	const Key * meta;
+	while ((meta = keyNextMeta (cur)) != NULL)
+	{
+		ssize_t result = findMetaLink (metaKeys, meta);
+		if (result < 0)
 		{
-			if (fputc ('b', file) == EOF)
+			if (fputc ('m', file) == EOF)
 			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
 			}
 
-			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur);
-
-			char * value = NULL;
-			if (valueSize > 0)
+			if (version == 4)
 			{
-				value = elektraMalloc (valueSize);
-				if (keyGetBinary (cur, value, valueSize) == -1)
+				if (!writeMetaName (file, meta, metaNames, parentKey))
 				{
-					fclose (file);
-					elektraFree (value);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					return false;
+				}
+			}
+			else
+			{
+				// ignore meta namespace when writing to file
+				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
+				if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
+				{
+					return false;
 				}
 			}
 
-			if (!writeData (file, value, valueSize, parentKey))
+			kdb_unsigned_long_long_t metaValueSize = keyGetValueSize (meta) - 1;
+			if (!writeData (file, keyString (meta), metaValueSize, parentKey))
 			{
-				fclose (file);
-				elektraFree (value);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
 			}
-			elektraFree (value);
+
+			insertMetaLink (metaKeys, -result - 1, meta, cur, parentOffset);
 		}
 		else
 		{
-			if (fputc ('s', file) == EOF)
+			if (fputc ('c', file) == EOF)
 			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
 			}
 
-			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur) - 1;
-			if (!writeData (file, keyString (cur), valueSize, parentKey))
-			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
-			}
-		}
+			kdb_unsigned_long_long_t keyNameSize = metaKeys->array[result]->keyNameSize;
 
-		keyRewindMeta (cur);
-		const Key * meta;
-		while ((meta = keyNextMeta (cur)) != NULL)
-		{
-			ssize_t result = findMetaLink (&metaKeys, meta);
-			if (result < 0)
+			if (version == 4)
 			{
-				if (fputc ('m', file) == EOF)
+				// the metakey name reference comes first, then the source key name
+				if (!writeMetaName (file, meta, metaNames, parentKey) ||
+				    !writeData (file, metaKeys->array[result]->keyName, keyNameSize, parentKey))
 				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					return false;
 				}
-
-				// ignore meta namespace when writing to file
-				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
-				if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
-
-				kdb_unsigned_long_long_t metaValueSize = keyGetValueSize (meta) - 1;
-				if (!writeData (file, keyString (meta), metaValueSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
-
-				insertMetaLink (&metaKeys, -result - 1, meta, cur, parentOffset);
 			}
 			else
 			{
-				if (fputc ('c', file) == EOF)
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
-
-				kdb_unsigned_long_long_t keyNameSize = metaKeys.array[result]->keyNameSize;
-				if (!writeData (file, metaKeys.array[result]->keyName, keyNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
-
-				// ignore meta namespace when writing to file
+				// v3 stores the source key name first, then the metakey name inline
 				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1 - (sizeof ("meta:/") - 1);
-				if (!writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
+				if (!writeData (file, metaKeys->array[result]->keyName, keyNameSize, parentKey) ||
+				    !writeData (file, keyName (meta) + sizeof ("meta:/") - 1, metaNameSize, parentKey))
 				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					return false;
 				}
 			}
 		}
+	}
+
+	return fputc (0, file) != EOF;
+}
+
+/**
+ * @internal
+ * Appends the keys carrying the sync flag to the existing file instead of
+ * rewriting it. Only possible when the file on disk is exactly the one
+ * whose content is recorded in the journal state (with a resolver that
+ * commits via a temporary file this never matches, so set falls back to a
+ * full write) and no key was removed since then. The appended segment is a
+ * valid continuation of the format: duplicate names are overridden on read
+ * because the reader inserts via ksAppendKey(), the first appended key is
+ * written with prefix length 0 and the interned metakey name table is
+ * continued from the recorded state.
+ *
+ * @retval 1 the changed keys were appended, nothing else to do
+ * @retval 0 a full write is needed
+ * @retval -1 write error, the file was truncated back to its previous size
+ */
+static int tryJournalAppend (Plugin * handle, KeySet * returned, KeySet * config, Key * parentKey)
+{
+	struct journalState * state = elektraPluginGetData (handle);
+	if (state == NULL || state->filename == NULL || elektraStrCmp (state->filename, keyString (parentKey)) != 0)
+	{
+		return 0;
+	}
 
-		if (fputc (0, file) == EOF)
+	struct stat buf;
+	if (stat (state->filename, &buf) != 0 || buf.st_size != state->fileSize)
+	{
+		// somebody else wrote the file, the recorded state is worthless
+		return 0;
+	}
+
+	// every key of the recorded state must still be present,
+	// an appended segment cannot express removals
+	ssize_t oldSize = ksGetSize (state->keys);
+	ssize_t newSize = ksGetSize (returned);
+	ssize_t j = 0;
+	for (ssize_t i = 0; i < oldSize; ++i)
+	{
+		int cmp = -1;
+		while (j < newSize && (cmp = keyCmp (ksAtCursor (state->keys, i), ksAtCursor (returned, j))) > 0)
+		{
+			++j; // key inserted since the last write
+		}
+		if (j >= newSize || cmp != 0)
+		{
+			return 0;
+		}
+		++j;
+	}
+
+	KeySet * changed = ksNew ((size_t) newSize, KS_END);
+	for (ssize_t i = 0; i < newSize; ++i)
+	{
+		Key * k = ksAtCursor (returned, i);
+		if (keyNeedSync (k)) ksAppendKey (changed, k);
+	}
+
+	size_t changedCount = (size_t) ksGetSize (changed);
+
+	// rewrite when there is nothing to append or when the patch segments
+	// would outgrow the base keys
+	if (changedCount == 0 || (state->patchKeys + changedCount) * 2 > (size_t) newSize)
+	{
+		ksDel (changed);
+		return 0;
+	}
+
+	FILE * file = fopen (state->filename, "ab");
+	if (file == NULL)
+	{
+		ksDel (changed);
+		return 0;
+	}
+
+	size_t parentOffset = getParentOffset (config, parentKey);
+
+	struct list metaKeys;
+	metaKeys.alloc = 16;
+	metaKeys.size = 0;
+	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
+
+	// the front coding starts fresh, the first appended key is written in full
+	const char * prevName = NULL;
+	size_t prevNameSize = 0;
+
+	bool success = true;
+	for (size_t i = 0; success && i < changedCount; ++i)
+	{
+		success = writeKey (file, state->version, ksAtCursor (changed, (ssize_t) i), parentOffset, &prevName, &prevNameSize,
+				    &metaKeys, &state->metaNames, parentKey);
+	}
+
+	for (size_t i = 0; i < metaKeys.size; ++i)
+	{
+		elektraFree (metaKeys.array[i]);
+	}
+	elektraFree (metaKeys.array);
+	ksDel (changed);
+
+	if (!success || fflush (file) != 0)
+	{
+		// roll the file back to the last consistent state
+		if (ftruncate (fileno (file), state->fileSize) != 0)
+		{
+			ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not roll back journal append on '%s'", state->filename);
+		}
+		fclose (file);
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		return -1;
+	}
+
+	state->fileSize = ftell (file);
+	state->patchKeys += changedCount;
+	ksDel (state->keys);
+	state->keys = ksDup (returned);
+	fclose (file);
+
+	return 1;
+}
+
+int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	elektraCursor cursor = ksGetCursor (returned);
+	ksRewind (returned);
+
+	KeySet * config = elektraPluginGetConfig (handle);
+	bool streamMode = ksLookupByName (config, "/stream", 0) != NULL;
+	bool stdoutMode = elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0;
+	bool journalMode = !streamMode && !stdoutMode && ksLookupByName (config, "/journal", 0) != NULL;
+	// v3 stays the default write format, the more compact v4 is opt-in
+	int version = ksLookupByName (config, "/v4", 0) != NULL ? 4 : 3;
+
+	if (journalMode)
+	{
+		int appended = tryJournalAppend (handle, returned, config, parentKey);
+		if (appended != 0)
+		{
+			ksSetCursor (returned, cursor);
+			return appended > 0 ? ELEKTRA_PLUGIN_STATUS_SUCCESS : ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+	}
+
+	FILE * file;
+
+	// cannot open stdout for writing, because its already open
+	if (stdoutMode)
+	{
+		file = stdout;
+	}
+	else
+	{
+		file = fopen (keyString (parentKey), "wb");
+	}
+
+	if (file == NULL)
+	{
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	// magic number is written big endian so EKDB magic string is readable
+	kdb_unsigned_long_long_t magic;
+	if (version == 4)
+	{
+		magic = htobe64 (streamMode ? MAGIC_NUMBER_STREAM_V4 : MAGIC_NUMBER_V4);
+	}
+	else
+	{
+		magic = htobe64 (streamMode ? MAGIC_NUMBER_STREAM_V3 : MAGIC_NUMBER_V3);
+	}
+	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	{
+		fclose (file);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	// in stream mode the reader cannot rely on an end of file, tell it how many keys follow
+	if (streamMode && !varintWrite (file, ksGetSize (returned)))
+	{
+		fclose (file);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+
+	struct list metaKeys;
+	metaKeys.alloc = 16;
+	metaKeys.size = 0;
+	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
+
+	struct metaNameTable metaNames;
+	metaNames.alloc = 16;
+	metaNames.size = 0;
+	metaNames.names = elektraMalloc (metaNames.alloc * sizeof (char *));
+
+	size_t parentOffset = getParentOffset (config, parentKey);
+
+	// front-coding state: name of the previously written key
+	const char * prevName = NULL;
+	size_t prevNameSize = 0;
+
+	Key * cur;
+	while ((cur = ksNext (returned)) != NULL)
+	{
+		if (!writeKey (file, version, cur, parentOffset, &prevName, &prevNameSize, &metaKeys, &metaNames, parentKey))
 		{
 			fclose (file);
 			return ELEKTRA_PLUGIN_STATUS_ERROR;
@@ -545,6 +1208,18 @@ int elektraQuickdumpSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	}
 	elektraFree (metaKeys.array);
 
+	if (journalMode)
+	{
+		// a full write resets the journal baseline; takes over metaNames
+		captureJournalState (handle, keyString (parentKey), version, ftell (file), returned, &metaNames);
+	}
+
+	for (size_t i = 0; i < metaNames.size; ++i)
+	{
+		elektraFree (metaNames.names[i]);
+	}
+	elektraFree (metaNames.names);
+
 	fclose (file);
 
 	ksSetCursor (returned, cursor);
@@ -639,12 +1314,26 @@ void ensureBufferSize (struct stringbuffer * buffer, size_t minSize)
 	}
 }
 
+int elektraQuickdumpClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	struct journalState * state = elektraPluginGetData (handle);
+	if (state != NULL)
+	{
+		clearJournalState (state);
+		elektraFree (state);
+		elektraPluginSetData (handle, NULL);
+	}
+
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
+
 Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport ("quickdump",
 				    ELEKTRA_PLUGIN_GET,	&elektraQuickdumpGet,
 				    ELEKTRA_PLUGIN_SET,	&elektraQuickdumpSet,
+				    ELEKTRA_PLUGIN_CLOSE, &elektraQuickdumpClose,
 				    ELEKTRA_PLUGIN_END);
 	// clang-format on
 }
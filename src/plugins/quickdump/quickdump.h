@@ -15,6 +15,7 @@
 
 int elektraQuickdumpGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraQuickdumpSet (Plugin * handle, KeySet * ks, Key * parentKey);
+int elektraQuickdumpClose (Plugin * handle, Key * errorKey);
 
 Plugin * ELEKTRA_PLUGIN_EXPORT;
 
@@ -122,6 +122,55 @@ static void test_basics (void)
 	ksDel (ks);
 }
 
+static void test_v4 (void)
+{
+	printf ("test v4 format\n");
+
+	KeySet * ks = ksNew (0, KS_END);
+	char * infile = elektraStrDup (srcdir_file ("quickdump/test.v4.quickdump"));
+	char * outfile = elektraStrDup (elektraFilename ());
+
+	{
+		Key * getKey = keyNew ("dir:/tests/bench", KEY_VALUE, infile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("quickdump");
+
+		KeySet * expected = test_quickdump_expected ();
+
+		succeed_if (plugin->kdbGet (plugin, ks, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+		compare_keyset (expected, ks);
+
+		Key * k1 = ksLookupByName (ks, "dir:/tests/bench/__112", 0);
+		Key * k8 = ksLookupByName (ks, "dir:/tests/bench/__911", 0);
+		succeed_if (keyGetMeta (k1, "meta/_35") == keyGetMeta (k8, "meta/_35"), "copy meta failed");
+
+		ksDel (expected);
+
+		keyDel (getKey);
+		PLUGIN_CLOSE ();
+	}
+
+	{
+		Key * setKey = keyNew ("dir:/tests/bench", KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (1, keyNew ("user:/v4", KEY_END), KS_END);
+		PLUGIN_OPEN ("quickdump");
+
+		succeed_if (plugin->kdbSet (plugin, ks, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+		succeed_if (compare_binary_files (infile, outfile) == 0, "files differ");
+		remove (outfile);
+
+		keyDel (setKey);
+		PLUGIN_CLOSE ();
+	}
+
+	elektraFree (infile);
+	elektraFree (outfile);
+	ksDel (ks);
+}
+
 static void test_noParent (void)
 {
 	printf ("test noparent\n");
@@ -276,6 +325,7 @@ int main (int argc, char ** argv)
 	test_varint ();
 
 	test_basics ();
+	test_v4 ();
 	test_noParent ();
 	test_parentKeyValue ();
 
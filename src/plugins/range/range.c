@@ -243,24 +243,81 @@ static int rangeStringToRange (const char * rangeString, RangeValue * min, Range
 }
 
 
-static int validateSingleRange (const char * valueStr, const char * rangeString, RangeType type)
+typedef struct
+{
+	RangeValue min;
+	RangeValue max;
+} Range;
+
+/**
+ * A range expression pre-parsed into its list of numeric bounds.
+ *
+ * Parsing the expression is far more expensive than checking a value
+ * against it, and within one keyset the same expression usually repeats
+ * across many keys, so the parsed form is cached between keys.
+ */
+typedef struct
+{
+	char * rangeString;
+	RangeType type;
+	Range * ranges;
+	size_t count;
+} ParsedRanges;
+
+static void clearParsedRanges (ParsedRanges * parsed)
+{
+	if (parsed->rangeString != NULL) elektraFree (parsed->rangeString);
+	if (parsed->ranges != NULL) elektraFree (parsed->ranges);
+	parsed->rangeString = NULL;
+	parsed->ranges = NULL;
+	parsed->count = 0;
+	parsed->type = NA;
+}
+
+// parse a (possibly comma separated) range expression into min - max pairs
+// return -1 and set an error on parentKey on invalid syntax, 0 on success
+static int parseRanges (const char * rangeString, RangeType type, ParsedRanges * parsed, Key * parentKey)
 {
-	RangeValue min, max;
-	min.Value.i = 0;
-	max.Value.i = 0;
-	min.type = type;
-	max.type = type;
-	int rc = rangeStringToRange (rangeString, &min, &max, type);
-	if (rc)
+	char * localCopy = elektraStrDup (rangeString);
+	char * savePtr = NULL;
+	for (char * token = strtok_r (localCopy, ",", &savePtr); token != NULL; token = strtok_r (NULL, ",", &savePtr))
+	{
+		Range range;
+		range.min.type = type;
+		range.max.type = type;
+		range.min.Value.i = 0;
+		range.max.Value.i = 0;
+		if (rangeStringToRange (token, &range.min, &range.max, type) != 0)
+		{
+			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid syntax: %s", token);
+			elektraFree (localCopy);
+			return -1;
+		}
+		elektraRealloc ((void **) &parsed->ranges, (parsed->count + 1) * sizeof (Range));
+		parsed->ranges[parsed->count] = range;
+		++parsed->count;
+	}
+	elektraFree (localCopy);
+	if (parsed->count == 0)
 	{
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid syntax: %s", rangeString);
 		return -1;
 	}
+	parsed->type = type;
+	parsed->rangeString = elektraStrDup (rangeString);
+	return 0;
+}
+
+// convert the value once and compare it against the pre-parsed bounds
+// return 1 if the value lies in one of the ranges, 0 if not, -1 on conversion error
+static int checkValue (const char * valueStr, const ParsedRanges * parsed)
+{
 	RangeValue val;
-	val.type = type;
+	val.type = parsed->type;
 	val.Value.i = 0;
 	char * endPtr;
 	errno = 0; // the c std library doesn't reset errno, so do it before conversions to be safe
-	switch (type)
+	switch (parsed->type)
 	{
 	case INT:
 	case UINT:
@@ -282,79 +339,36 @@ static int validateSingleRange (const char * valueStr, const char * rangeString,
 	{
 		return -1;
 	}
-	switch (type)
-	{
-	case INT:
-	case HEX:
-	case CHAR:
-		if ((long long) val.Value.i < (long long) min.Value.i || (long long) val.Value.i > (long long) max.Value.i)
-		{
-			return 0;
-		}
-		else
-		{
-			return 1;
-		}
-		break;
-	case UINT:
-		if (val.Value.i < min.Value.i || val.Value.i > max.Value.i)
-		{
-			return 0;
-		}
-		else
-		{
-			return 1;
-		}
-		break;
-	case FLOAT:
-		if (val.Value.f < min.Value.f || val.Value.f > max.Value.f)
-		{
-			return 0;
-		}
-		else
-		{
-			return 1;
-		}
-		break;
-	default:
-		return -1;
-		break;
-	}
-}
-
-static int validateMultipleRanges (const char * valueStr, const char * rangeString, Key * parentKey, RangeType type)
-{
-	char * localCopy = elektraStrDup (rangeString);
-	char * savePtr = NULL;
-	char * token = strtok_r (localCopy, ",", &savePtr);
-	int rc = validateSingleRange (valueStr, token, type);
-	if (rc == 1)
-	{
-		elektraFree (localCopy);
-		return 1;
-	}
-	else if (rc == -1)
-	{
-		elektraFree (localCopy);
-		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid syntax: %s", token);
-		return -1;
-	}
-	while ((token = strtok_r (NULL, ",", &savePtr)) != NULL)
+	for (size_t i = 0; i < parsed->count; ++i)
 	{
-		rc = validateSingleRange (valueStr, token, type);
-		if (rc == 1)
-		{
-			elektraFree (localCopy);
-			return 1;
-		}
-		else if (rc == -1)
+		const RangeValue * min = &parsed->ranges[i].min;
+		const RangeValue * max = &parsed->ranges[i].max;
+		switch (parsed->type)
 		{
-			elektraFree (localCopy);
-			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid syntax: %s", token);
+		case INT:
+		case HEX:
+		case CHAR:
+			if ((long long) val.Value.i >= (long long) min->Value.i && (long long) val.Value.i <= (long long) max->Value.i)
+			{
+				return 1;
+			}
+			break;
+		case UINT:
+			if (val.Value.i >= min->Value.i && val.Value.i <= max->Value.i)
+			{
+				return 1;
+			}
+			break;
+		case FLOAT:
+			if (val.Value.f >= min->Value.f && val.Value.f <= max->Value.f)
+			{
+				return 1;
+			}
+			break;
+		default:
 			return -1;
 		}
 	}
-	elektraFree (localCopy);
 	return 0;
 }
 
@@ -412,7 +426,7 @@ static RangeType getType (const Key * key)
 		return type;
 }
 
-static int validateKey (Key * key, Key * parentKey)
+static int validateKeyCached (Key * key, Key * parentKey, ParsedRanges * cache)
 {
 	const Key * rangeMeta = keyGetMeta (key, "check/range");
 	const char * rangeString = keyString (rangeMeta);
@@ -434,35 +448,35 @@ static int validateKey (Key * key, Key * parentKey)
 		}
 	}
 
-	if (!strchr (rangeString, ','))
+	if (cache->rangeString == NULL || cache->type != type || strcmp (cache->rangeString, rangeString) != 0)
 	{
-		int rc = validateSingleRange (keyString (key), rangeString, type);
-		if (rc == -1)
+		clearParsedRanges (cache);
+		if (parseRanges (rangeString, type, cache, parentKey) == -1)
 		{
-			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid syntax: %s", keyString (rangeMeta));
+			clearParsedRanges (cache);
 			return -1;
 		}
-		else if (rc == 0)
-		{
-			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, RANGE_ERROR_MESSAGE, keyString (key), keyName (key),
-								rangeString);
-			return 0;
-		}
-		else
-		{
-			return rc;
-		}
 	}
-	else
+
+	int rc = checkValue (keyString (key), cache);
+	if (rc == -1)
 	{
-		int rc = validateMultipleRanges (keyString (key), rangeString, parentKey, type);
-		if (rc == 0)
-		{
-			ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, RANGE_ERROR_MESSAGE, keyString (key), keyName (key),
-								rangeString);
-		}
-		return rc;
+		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Invalid syntax: %s", rangeString);
+		return -1;
 	}
+	else if (rc == 0)
+	{
+		ELEKTRA_SET_VALIDATION_SEMANTIC_ERRORF (parentKey, RANGE_ERROR_MESSAGE, keyString (key), keyName (key), rangeString);
+	}
+	return rc;
+}
+
+static int validateKey (Key * key, Key * parentKey)
+{
+	ParsedRanges parsed = { NULL, NA, NULL, 0 };
+	int rc = validateKeyCached (key, parentKey, &parsed);
+	clearParsedRanges (&parsed);
+	return rc;
 }
 
 int elektraRangeGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
@@ -491,19 +505,24 @@ int elektraRangeSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_U
 {
 	// set all keys
 	// this function is optional
+	// the parsed form of the last range expression is carried from key to
+	// key, so keys sharing an expression do not re-parse it
+	ParsedRanges cache = { NULL, NA, NULL, 0 };
 	Key * cur;
 	while ((cur = ksNext (returned)) != NULL)
 	{
 		const Key * meta = keyGetMeta (cur, "check/range");
 		if (meta)
 		{
-			int rc = validateKey (cur, parentKey);
+			int rc = validateKeyCached (cur, parentKey, &cache);
 			if (rc <= 0)
 			{
+				clearParsedRanges (&cache);
 				return -1;
 			}
 		}
 	}
+	clearParsedRanges (&cache);
 	return 1; // success
 }
 
@@ -230,13 +230,21 @@ static int filterAlternatives (const Key * key, void * argument)
 	return metaValue != NULL && keyIsDirectlyBelow (referenceParent, key) && strcmp (metaValue, CHECK_REFERNCE_VALUE_ALTERNATIVE) == 0;
 }
 
-static int checkRecursiveReference (const Key * rootKey, KeySet * allKeys, Key * parentKey)
+static int checkRecursiveReference (const Key * rootKey, KeySet * allKeys, Key * parentKey, KeySet * validated)
 {
 	if (rootKey == NULL)
 	{
 		return ELEKTRA_PLUGIN_STATUS_NO_UPDATE;
 	}
 
+	// already visited as part of the graph of an earlier recursive check
+	// in this pass; that graph covered the whole reachable component,
+	// including the acyclicity check
+	if (ksLookupByName (validated, keyName (rootKey), 0) != NULL)
+	{
+		return ELEKTRA_PLUGIN_STATUS_NO_UPDATE;
+	}
+
 	RefGraph * referenceGraph = rgNew ();
 	KeySet * allRefnames = ksNew (0, KS_END);
 	KeySet * refnameRoots = ksNew (0, KS_END);
@@ -275,7 +283,7 @@ static int checkRecursiveReference (const Key * rootKey, KeySet * allKeys, Key *
 			Key * tmp = keyNew (curName, KEY_END);
 			keyAddBaseName (tmp, refname);
 			Key * baseKey = ksLookup (allKeys, tmp, 0);
-			keyDel (tmp);
+			ksAppendKey (validated, tmp);
 
 			const char * reference = keyString (baseKey);
 			if (reference == NULL || strlen (reference) == 0)
@@ -424,6 +432,7 @@ int elektraReferenceSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	Key * cur;
 	ksRewind (returned);
 
+	KeySet * validated = ksNew (0, KS_END);
 	int status = ELEKTRA_PLUGIN_STATUS_NO_UPDATE;
 	while ((cur = ksNext (returned)) != NULL)
 	{
@@ -443,11 +452,12 @@ int elektraReferenceSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 
 		if (strcmp (metaValue, CHECK_REFERNCE_VALUE_RECURSIVE) == 0)
 		{
-			status |= checkRecursiveReference (cur, returned, parentKey);
+			status |= checkRecursiveReference (cur, returned, parentKey, validated);
 		}
 		ksSetCursor (returned, cursor);
 	}
 
+	ksDel (validated);
 
 	return status;
 }
@@ -84,19 +84,26 @@ Key * elektraKeyCreateNewName (const Key * key, const Key * parentKey, const cha
 	char * newName = elektraCalloc (maxNewLength + 1);
 	short replace = 0;
 
-	char * parentKeyName = elektraMalloc (keyGetNameSize (parentKey));
-	keyGetName (parentKey, parentKeyName, keyGetNameSize (parentKey));
-	char * curKeyName = elektraMalloc (keyGetNameSize (key));
-	keyGetName (key, curKeyName, keyGetNameSize (key));
-
-	char * afterParentString = curKeyName + (strlen (parentKeyName));
-	char * ptr;
+	size_t parentNameLen = keyGetNameSize (parentKey) - 1;
+	char * curKeyName = 0;
+	const char * afterParentString;
+	const char * ptr;
 
 	if (initialConversion != UNCHNGD)
 	{
-		doConversion (afterParentString, 0, initialConversion);
+		/* the initial conversion modifies the name in place, so it needs a writable copy */
+		curKeyName = elektraMalloc (keyGetNameSize (key));
+		keyGetName (key, curKeyName, keyGetNameSize (key));
+		char * writableName = curKeyName + parentNameLen;
+		doConversion (writableName, 0, initialConversion);
+		afterParentString = writableName;
 		replace = 1;
 	}
+	else
+	{
+		/* the name is only read below, the key's own buffer suffices */
+		afterParentString = keyName (key) + parentNameLen;
+	}
 
 	if (cutPath && (cutPath[0] != '/') && ((ptr = strstr (afterParentString, cutPath)) != NULL))
 	{
@@ -142,8 +149,7 @@ Key * elektraKeyCreateNewName (const Key * key, const Key * parentKey, const cha
 			replace = 1;
 		}
 	}
-	elektraFree (parentKeyName);
-	elektraFree (curKeyName);
+	if (curKeyName) elektraFree (curKeyName);
 	if (replace)
 	{
 		Key * result = keyDup (key, KEY_CP_ALL);
@@ -267,9 +273,6 @@ int elektraRenameGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 
 	KeySet * config = elektraPluginGetConfig (handle);
-	KeySet * iterateKs = ksDup (returned);
-
-	ksRewind (iterateKs);
 
 	Key * cutConfig = ksLookupByName (config, "/cut", KDB_O_NONE);
 	Key * toUpper = ksLookupByName (config, "/toupper", KDB_O_NONE);
@@ -277,45 +280,35 @@ int elektraRenameGet (Plugin * handle, KeySet * returned, Key * parentKey)
 	Key * replaceWith = ksLookupByName (config, "/replacewith", KDB_O_NONE);
 	Key * getCase = ksLookupByName (config, "/get/case", KDB_O_NONE);
 
+	/*
+	 * a fixed prefix transform preserves the relative order of the keys,
+	 * so the renamed keys can be collected into a preallocated result set
+	 * in one pass instead of popping and re-inserting each key
+	 */
+	KeySet * result = ksNew (ksGetSize (returned), KS_END);
 
+	ksRewind (returned);
 	Key * key;
-	while ((key = ksNext (iterateKs)) != 0)
+	while ((key = ksNext (returned)) != 0)
 	{
-
 		Key * renamedKey = renameGet (key, parentKey, cutConfig, replaceWith, toUpper, toLower, getCase);
 
 		if (renamedKey)
 		{
 			keySetMeta (renamedKey, ELEKTRA_ORIGINAL_NAME_META, keyName (key));
-			ksLookup (returned, key, KDB_O_POP);
-			keyDel (key);
-
-			/*
-			 * if the parentKey is replaced by a rename operation
-			 * make sure that we do not loose its reference (ksAppendKey
-			 * would otherwise delete it)
-			 */
-			if (keyCmp (renamedKey, parentKey) == 0)
-			{
-				/* make sure the parent key is not deleted */
-				keyIncRef (parentKey);
-				ksAppendKey (returned, renamedKey);
-				keyDecRef (parentKey);
-			}
-			else
-			{
-				ksAppendKey (returned, renamedKey);
-			}
+			ksAppendKey (result, renamedKey);
 		}
 		else
 		{
 			keySetMeta (key, ELEKTRA_ORIGINAL_NAME_META, keyName (key));
+			ksAppendKey (result, key);
 		}
 	}
 
 	/* make sure the parent key is not deleted */
 	keyIncRef (parentKey);
-	ksDel (iterateKs);
+	ksCopy (returned, result);
+	ksDel (result);
 	keyDecRef (parentKey);
 
 	return 1; /* success */
@@ -323,9 +316,6 @@ int elektraRenameGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 int elektraRenameSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
-
-	KeySet * iterateKs = ksDup (returned);
-
 	KeySet * config = elektraPluginGetConfig (handle);
 	Key * cutConfig = ksLookupByName (config, "/cut", KDB_O_NONE);
 
@@ -352,57 +342,56 @@ int elektraRenameSet (Plugin * handle, KeySet * returned, Key * parentKey)
 			writeConversion = UNCHNGD;
 		}
 	}
-	ksRewind (iterateKs);
-	Key * key;
-	char * parentKeyName = elektraMalloc (keyGetNameSize (parentKey));
-	keyGetName (parentKey, parentKeyName, keyGetNameSize (parentKey));
-	while ((key = ksNext (iterateKs)) != 0)
+
+	/* the renamed names are written as-is, nothing has to be restored */
+	if (writeConversion == KEYNAME)
 	{
-		Key * renamedKey = NULL;
-		if (writeConversion != KEYNAME)
-		{
-			renamedKey = restoreKeyName (key, parentKey, cutConfig);
+		ksRewind (returned);
+		return 1; /* success */
+	}
 
-			if (!renamedKey) renamedKey = keyDup (key, KEY_CP_ALL);
-			if (writeConversion == TOUPPER || writeConversion == TOLOWER)
-			{
-				char * curKeyName = elektraMalloc (keyGetNameSize (renamedKey));
-				keyGetName (renamedKey, curKeyName, keyGetNameSize (renamedKey));
+	/*
+	 * a fixed prefix transform preserves the relative order of the keys,
+	 * so the restored keys can be collected into a preallocated result set
+	 * in one pass instead of popping and re-inserting each key
+	 */
+	KeySet * result = ksNew (ksGetSize (returned), KS_END);
 
-				char * afterParentString = curKeyName + (strlen (parentKeyName));
+	size_t parentNameLen = keyGetNameSize (parentKey) - 1;
+	ksRewind (returned);
+	Key * key;
+	while ((key = ksNext (returned)) != 0)
+	{
+		Key * renamedKey = restoreKeyName (key, parentKey, cutConfig);
 
-				doConversion (afterParentString, 0, writeConversion);
+		if (!renamedKey) renamedKey = keyDup (key, KEY_CP_ALL);
+		if (writeConversion == TOUPPER || writeConversion == TOLOWER)
+		{
+			char * curKeyName = elektraMalloc (keyGetNameSize (renamedKey));
+			keyGetName (renamedKey, curKeyName, keyGetNameSize (renamedKey));
 
-				keySetName (renamedKey, curKeyName);
-				elektraFree (curKeyName);
-			}
-			/*
-			 * if something is restored from the parentKey, do
-			 * not delete the parentKey (might cause troubles)
-			 */
-			if (keyCmp (key, parentKey) != 0)
-			{
-				keyDel (ksLookup (returned, key, KDB_O_POP));
-			}
-			ksAppendKey (returned, renamedKey);
-			keyDel (renamedKey);
+			doConversion (curKeyName + parentNameLen, 0, writeConversion);
+
+			keySetName (renamedKey, curKeyName);
+			elektraFree (curKeyName);
 		}
-		else
+		/*
+		 * if something is restored from the parentKey, do
+		 * not delete the parentKey (might cause troubles)
+		 */
+		if (keyCmp (key, parentKey) == 0)
 		{
-			if (keyCmp (key, parentKey) != 0)
-			{
-				keyDel (ksLookupByName (returned, keyString (keyGetMeta (key, ELEKTRA_ORIGINAL_NAME_META)), KDB_O_POP));
-			}
-			ksAppendKey (returned, key);
+			ksAppendKey (result, key);
 		}
+		ksAppendKey (result, renamedKey);
 	}
 
 	keyIncRef (parentKey);
-	ksDel (iterateKs);
+	ksCopy (returned, result);
+	ksDel (result);
 	keyDecRef (parentKey);
 
 	ksRewind (returned);
-	elektraFree (parentKeyName);
 	return 1; /* success */
 }
 
@@ -21,9 +21,28 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#ifdef ELEKTRA_LOCK_MUTEX
+#include <pthread.h>
+#endif
+
 
 #define POSTFIX_SIZE 50
 
+/**
+ * The home directory from passwd, looked up once per process.
+ *
+ * The uid of a process does not change underneath us, so all resolver
+ * instances (one per mounted backend, across all KDB handles) share the
+ * first getpwuid_r() result and later resolutions of `~` paths cost
+ * only string concatenation. The allocation intentionally lives until
+ * the process exits.
+ */
+static char * elektraResolvedPasswdHome = NULL;
+
+#ifdef ELEKTRA_LOCK_MUTEX
+static pthread_mutex_t elektraResolvePasswdMutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
 
 /**
  * Check if supplied filename is ok.
@@ -130,27 +149,40 @@ static void elektraResolveUsingHome (ElektraResolved * handle, const char * home
 
 static char * elektraResolvePasswd (Key * warningsKey)
 {
-	ssize_t bufSize = sysconf (_SC_GETPW_R_SIZE_MAX);
-	if (bufSize == -1) bufSize = 16384; // man 3 getpwuid
-
-	char * buf = elektraMalloc (bufSize);
-	if (!buf) return NULL;
-	struct passwd pwd;
-	struct passwd * result;
-
-	int s = getpwuid_r (getuid (), &pwd, buf, bufSize, &result);
-	if (result == NULL)
+#ifdef ELEKTRA_LOCK_MUTEX
+	pthread_mutex_lock (&elektraResolvePasswdMutex);
+#endif
+	if (elektraResolvedPasswdHome == NULL)
 	{
-		elektraFree (buf);
-		if (s != 0)
+		ssize_t bufSize = sysconf (_SC_GETPW_R_SIZE_MAX);
+		if (bufSize == -1) bufSize = 16384; // man 3 getpwuid
+
+		char * buf = elektraMalloc (bufSize);
+		if (buf != NULL)
 		{
-			ELEKTRA_ADD_INSTALLATION_WARNINGF (warningsKey, "Could not retrieve from passwd using getpwuid_r. Reason: %s",
-							   strerror (s));
+			struct passwd pwd;
+			struct passwd * result;
+
+			int s = getpwuid_r (getuid (), &pwd, buf, bufSize, &result);
+			if (result == NULL)
+			{
+				if (s != 0)
+				{
+					ELEKTRA_ADD_INSTALLATION_WARNINGF (
+						warningsKey, "Could not retrieve from passwd using getpwuid_r. Reason: %s", strerror (s));
+				}
+			}
+			else
+			{
+				elektraResolvedPasswdHome = elektraStrDup (pwd.pw_dir);
+			}
+			elektraFree (buf);
 		}
-		return NULL;
 	}
-	char * resolved = elektraStrDup (pwd.pw_dir);
-	elektraFree (buf);
+	char * resolved = elektraResolvedPasswdHome == NULL ? NULL : elektraStrDup (elektraResolvedPasswdHome);
+#ifdef ELEKTRA_LOCK_MUTEX
+	pthread_mutex_unlock (&elektraResolvePasswdMutex);
+#endif
 	return resolved;
 }
 
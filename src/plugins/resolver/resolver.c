@@ -28,13 +28,14 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
-#include <dirent.h>
 
 #include <kdberrors.h>
 #include <kdblogger.h>
 #include <kdbmacros.h>
+#include <kdbrand.h> // jitter for the lock backoff
 
 #ifdef ELEKTRA_LOCK_MUTEX
 #include <pthread.h>
@@ -67,6 +68,7 @@ static void resolverInit (resolverHandle * p, const char * path)
 	p->filename = 0;
 	p->dirname = 0;
 	p->tempfile = 0;
+	p->cacheKeyName = 0;
 
 	p->path = path;
 
@@ -110,6 +112,8 @@ static void resolverCloseOne (resolverHandle * p)
 	p->dirname = 0;
 	elektraFree (p->tempfile);
 	p->tempfile = 0;
+	elektraFree (p->cacheKeyName);
+	p->cacheKeyName = 0;
 }
 
 static void resolverClose (resolverHandles * p)
@@ -121,13 +125,52 @@ static void resolverClose (resolverHandles * p)
 	elektraFree (p);
 }
 
+#ifdef ELEKTRA_LOCK_FILE
+/** how often a contended file lock is retried before a conflict is reported */
+#define ELEKTRA_RESOLVER_LOCK_RETRIES (8)
+
+/** first backoff sleep on a contended file lock, in microseconds */
+#define ELEKTRA_RESOLVER_LOCK_BACKOFF_MIN_US (500)
+
+/** upper bound for a single backoff sleep, in microseconds */
+#define ELEKTRA_RESOLVER_LOCK_BACKOFF_MAX_US (32 * 1000)
+
+/**
+ * @internal
+ *
+ * @brief The timer section charged for waiting on the file lock.
+ *
+ * One section per namespace, so `KDB_TIMER` output shows which
+ * part of the configuration the contention is on.
+ */
+static const char * elektraLockWaitSection (const Key * parentKey)
+{
+	switch (keyGetNamespace (parentKey))
+	{
+	case KEY_NS_SPEC:
+		return "resolver/lockwait/spec";
+	case KEY_NS_DIR:
+		return "resolver/lockwait/dir";
+	case KEY_NS_USER:
+		return "resolver/lockwait/user";
+	case KEY_NS_SYSTEM:
+		return "resolver/lockwait/system";
+	default:
+		return "resolver/lockwait";
+	}
+}
+#endif
+
 /**
  * Locks file for exclusive read/write mode.
  *
- * This function will not block until all reader
- * and writer have left the file.
- * -> conflict with other cooperative process detected,
- *    but we were later (and lost)
+ * A lock held by another cooperative process is retried with
+ * exponentially growing, jittered sleeps (up to roughly a tenth of a
+ * second in total), so short contention - another process in the middle
+ * of its commit - resolves without bothering the application. Only a
+ * lock still held after the retries is reported as conflict. The time
+ * spent waiting is charged to a per namespace timer section
+ * (`resolver/lockwait/<namespace>`, see elektraTimerDump()).
  *
  * @exception 27 set if locking failed, most likely a conflict
  *
@@ -144,12 +187,35 @@ static int elektraLockFile (int fd ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSE
 	l.l_start = 0;	    /*Start at begin*/
 	l.l_whence = SEEK_SET;
 	l.l_len = 0; /*Do it with whole file*/
-	int ret = fcntl (fd, F_SETLK, &l);
+
+	static int32_t jitterSeed = 0;
+	unsigned int backoffUs = ELEKTRA_RESOLVER_LOCK_BACKOFF_MIN_US;
+	const char * section = elektraLockWaitSection (parentKey);
+
+	elektraTimerBegin (section);
+	int ret;
+	for (int attempt = 0;; ++attempt)
+	{
+		ret = fcntl (fd, F_SETLK, &l);
+		if (ret != -1 || (errno != EAGAIN && errno != EACCES)) break;
+		if (attempt >= ELEKTRA_RESOLVER_LOCK_RETRIES) break;
+
+		// sleep a random fraction of the current backoff (full jitter),
+		// so colliding writers do not retry in lockstep
+		if (jitterSeed == 0) jitterSeed = elektraRandGetInitSeed ();
+		elektraRand (&jitterSeed);
+		unsigned int sleepUs = 1 + (unsigned int) jitterSeed % backoffUs;
+		struct timespec sleep = { sleepUs / 1000000, (sleepUs % 1000000) * 1000 };
+		nanosleep (&sleep, NULL);
+		if (backoffUs < ELEKTRA_RESOLVER_LOCK_BACKOFF_MAX_US) backoffUs *= 2;
+	}
+	elektraTimerEnd (section);
 
 	if (ret == -1)
 	{
 		if (errno == EAGAIN || errno == EACCES)
 		{
+			elektraTimerAdd ("resolver/lockconflict", 1);
 			ELEKTRA_SET_RESOURCE_ERROR (parentKey,
 						    "Conflict because other process writes to configuration indicated by file lock");
 		}
@@ -514,6 +580,95 @@ int ELEKTRA_PLUGIN_FUNCTION (close) (Plugin * handle, Key * errorKey ELEKTRA_UNU
 }
 
 
+/**
+ * @brief Replay an interrupted commit that spanned multiple backends
+ *
+ * kdbSet() writes a small journal next to every configuration file involved
+ * in a commit of more than one backend (see elektraSetJournalWrite() in the
+ * core). If the process crashed after the journal became durable but before
+ * all temporary files were renamed into place, the files would stay in a
+ * mixed state. Finding such a journal on get therefore first finishes the
+ * renames of the whole transaction and then removes the journal copies.
+ *
+ * The replay is idempotent: a pair whose temporary file no longer exists was
+ * already committed and is skipped, so concurrent recoveries and recoveries
+ * racing the committing process itself are harmless.
+ */
+static void elektraJournalRecover (resolverHandle * pk, Key * parentKey)
+{
+	char * journalName = elektraFormat ("%s%s", pk->filename, ELEKTRA_COMMIT_JOURNAL_SUFFIX);
+	if (access (journalName, F_OK) != 0)
+	{
+		elektraFree (journalName);
+		return;
+	}
+
+	FILE * journal = fopen (journalName, "r");
+	if (journal == NULL)
+	{
+		elektraFree (journalName);
+		return;
+	}
+
+	char * line = NULL;
+	size_t lineAlloc = 0;
+	ssize_t lineLen = getline (&line, &lineAlloc, journal);
+	if (lineLen < 0 || strncmp (line, ELEKTRA_COMMIT_JOURNAL_HEADER, sizeof (ELEKTRA_COMMIT_JOURNAL_HEADER) - 1) != 0)
+	{
+		ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Ignoring corrupt commit journal '%s'", journalName);
+		elektraFree (line);
+		fclose (journal);
+		elektraFree (journalName);
+		return;
+	}
+
+	ELEKTRA_LOG ("replaying commit journal \"%s\"", journalName);
+
+	char * tempfile = NULL;
+	size_t tempfileAlloc = 0;
+	// first pass: finish the renames of the interrupted commit
+	while ((lineLen = getline (&tempfile, &tempfileAlloc, journal)) > 0)
+	{
+		if (tempfile[lineLen - 1] == '\n') tempfile[lineLen - 1] = '\0';
+		lineLen = getline (&line, &lineAlloc, journal);
+		if (lineLen <= 0) break;
+		if (line[lineLen - 1] == '\n') line[lineLen - 1] = '\0';
+
+		if (access (tempfile, F_OK) == 0 && rename (tempfile, line) == -1)
+		{
+			ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not replay commit journal rename to '%s'. Reason: %s", line,
+						       strerror (errno));
+		}
+	}
+
+	// make the renames durable before dropping the journal, like a normal commit does
+	int dirFd = open (pk->dirname, O_RDONLY | O_DIRECTORY);
+	if (dirFd != -1)
+	{
+		fsync (dirFd);
+		close (dirFd);
+	}
+
+	// second pass: remove the journal copy next to every involved file
+	rewind (journal);
+	getline (&line, &lineAlloc, journal); // skip the header
+	while (getline (&tempfile, &tempfileAlloc, journal) > 0)
+	{
+		lineLen = getline (&line, &lineAlloc, journal);
+		if (lineLen <= 0) break;
+		if (line[lineLen - 1] == '\n') line[lineLen - 1] = '\0';
+
+		char * copyName = elektraFormat ("%s%s", line, ELEKTRA_COMMIT_JOURNAL_SUFFIX);
+		unlink (copyName);
+		elektraFree (copyName);
+	}
+
+	elektraFree (tempfile);
+	elektraFree (line);
+	fclose (journal);
+	elektraFree (journalName);
+}
+
 int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	Key * root = keyNew ("system:/elektra/modules/" ELEKTRA_PLUGIN_NAME, KEY_END);
@@ -532,6 +687,9 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * returned, Key * par
 	resolverHandle * pk = elektraGetResolverHandle (handle, parentKey);
 	keySetString (parentKey, pk->filename);
 
+	// finish the renames of a commit that was interrupted by a crash
+	elektraJournalRecover (pk, parentKey);
+
 	int errnoSave = errno;
 	struct stat buf;
 
@@ -567,7 +725,13 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * returned, Key * par
 
 	/* Check if cache update needed */
 	KeySet * global;
-	char * name = elektraCacheKeyName (pk->filename);
+	/* the cache key name only depends on the resolved filename, so it is
+	 * computed once per handle instead of on every kdbGet() */
+	if (pk->cacheKeyName == NULL)
+	{
+		pk->cacheKeyName = elektraCacheKeyName (pk->filename);
+	}
+	const char * name = pk->cacheKeyName;
 
 	if ((global = elektraPluginGetGlobalKeySet (handle)) != NULL && ELEKTRA_STAT_NANO_SECONDS (buf) != 0)
 	{
@@ -588,7 +752,6 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * returned, Key * par
 				pk->mtime.tv_sec = ELEKTRA_STAT_SECONDS (buf);
 				pk->mtime.tv_nsec = ELEKTRA_STAT_NANO_SECONDS (buf);
 
-				if (name) elektraFree (name);
 				errno = errnoSave;
 				return ELEKTRA_PLUGIN_STATUS_CACHE_HIT;
 			}
@@ -606,7 +769,20 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * returned, Key * par
 		ksAppendKey (global, time);
 	}
 
-	if (name) elektraFree (name);
+#ifdef POSIX_FADV_WILLNEED
+	/* The storage plugin will read this file, but only after the resolvers of
+	 * all other backends have run. Starting kernel readahead now overlaps the
+	 * disk reads of all mounted files on a cold kdbGet instead of paging each
+	 * file in serially during its storage phase. Purely advisory, the readahead
+	 * outlives the descriptor. */
+	int prefetchFd = open (pk->filename, O_RDONLY);
+	if (prefetchFd != -1)
+	{
+		posix_fadvise (prefetchFd, 0, 0, POSIX_FADV_WILLNEED);
+		close (prefetchFd);
+	}
+#endif
+
 	errno = errnoSave;
 	return 1;
 }
@@ -1049,13 +1225,15 @@ static int elektraSetCommit (resolverHandle * pk, Key * parentKey)
 	// file is present now!
 	pk->isMissing = 0;
 
-	DIR * dirp = opendir (pk->dirname);
-	// checking dirp not needed, fsync will have EBADF
-	if (fsync (dirfd (dirp)) == -1)
+	// make the rename durable; opening the directory directly avoids the
+	// DIR stream opendir would allocate just to get at the descriptor
+	int dirFd = open (pk->dirname, O_RDONLY | O_DIRECTORY);
+	// checking dirFd not needed, fsync will have EBADF
+	if (fsync (dirFd) == -1)
 	{
 		ELEKTRA_ADD_RESOURCE_WARNINGF (parentKey, "Could not sync directory '%s'. Reason: %s", pk->dirname, strerror (errno));
 	}
-	closedir (dirp);
+	if (dirFd != -1) close (dirFd);
 
 	elektraUnlockFile (pk->fd, parentKey);
 	elektraCloseFile (pk->fd, parentKey);
@@ -1104,6 +1282,13 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle, KeySet * ks, Key * parentKey
 			{
 				ret = -1;
 			}
+			else
+			{
+				// tell the core where the temporary file will be committed
+				// to, so it can journal commits spanning multiple backends
+				// (see elektraSetJournalWrite() in the core)
+				keySetMeta (parentKey, "commit/realfile", pk->filename);
+			}
 		}
 	}
 	else if (pk->fd == -2)
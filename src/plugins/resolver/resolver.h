@@ -34,9 +34,10 @@ struct _resolverHandle
 	unsigned int isMissing : 1;	///< when doing kdbGet(), no file was there
 	int timeFix;			///< time increment to use for fixing the time
 
-	char * dirname;	 ///< directory where real+temp file is
-	char * filename; ///< the full path to the configuration file
-	char * tempfile; ///< temporary file storages write to
+	char * dirname;	     ///< directory where real+temp file is
+	char * filename;     ///< the full path to the configuration file
+	char * tempfile;     ///< temporary file storages write to
+	char * cacheKeyName; ///< name of the mtime key in the global keyset, computed on first kdbGet()
 
 	const char * path; ///< the configuration file name as passed from config
 	const char * env;  ///< environment variables to search for files
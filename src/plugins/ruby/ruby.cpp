@@ -48,17 +48,21 @@ typedef struct _moduleData
  */
 
 /* create a new Ruby Kdb::Key object from the given ckdb::Key
- * will be deleted by the Ruby gc. */
+ * will be deleted by the Ruby gc.
+ * the type queries are cached: they walk the SWIG runtime type table on every
+ * call, which adds up since we create new proxy objects for each phase call */
 static inline VALUE newRubyObject (ckdb::Key * key)
 {
-	return SWIG_NewPointerObj (new kdb::Key (key), SWIG_TypeQuery ("kdb::Key *"), 1);
+	static swig_type_info * ti = SWIG_TypeQuery ("kdb::Key *");
+	return SWIG_NewPointerObj (new kdb::Key (key), ti, 1);
 }
 
 /* create a new Ruby object and take ownership of this object, thus given keySet will be deleted by
  * the Ruby gc. */
 static inline VALUE newRubyObject (kdb::KeySet * keySet)
 {
-	return SWIG_NewPointerObj (keySet, SWIG_TypeQuery ("kdb::KeySet *"), 1);
+	static swig_type_info * ti = SWIG_TypeQuery ("kdb::KeySet *");
+	return SWIG_NewPointerObj (keySet, ti, 1);
 }
 
 /*
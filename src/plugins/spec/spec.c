@@ -16,6 +16,7 @@
 #include <kdbhelper.h>
 #include <kdblogger.h>
 #include <kdbmeta.h>
+#include <kdbprivate.h> // ksSearchInternal(), keySetNamespace()
 #include <kdbtypes.h>
 
 #include <fnmatch.h>
@@ -59,15 +60,90 @@ typedef struct
 
 static void copyMeta (Key * dest, Key * src);
 
-static bool specMatches (Key * specKey, Key * otherKey)
+static bool specMatches (const ElektraGlobPattern * specGlob, Key * otherKey)
 {
 	// ignore namespaces for globbing
 	Key * globKey = keyNew (strchr (keyName (otherKey), '/'), KEY_END);
-	bool matches = elektraKeyGlob (globKey, strchr (keyName (specKey), '/')) == 0;
+	bool matches = elektraKeyGlobCompiled (globKey, specGlob) == 0;
 	keyDel (globKey);
 	return matches;
 }
 
+/**
+ * Builds the cascading key of the literal leading parts of @p specGlob.
+ *
+ * Only keys below (or same as) this key can match the pattern; for
+ * patterns starting with a glob part it degenerates to "/".
+ */
+static Key * specLiteralPrefix (const ElektraGlobPattern * specGlob)
+{
+	const char * prefix;
+	size_t prefixLen = elektraGlobPatternPrefix (specGlob, &prefix);
+
+	char * prefixName = elektraMemDup (prefix, prefixLen + 1);
+	prefixName[prefixLen] = '\0';
+	Key * prefixKey = keyNew (prefixName, KEY_END);
+	elektraFree (prefixName);
+	return prefixKey;
+}
+
+/**
+ * Finds the next key at or after @p from that is below or same as @p prefix.
+ *
+ * Exploits the sorted order of @p ks: when the current key is outside the
+ * subtree of @p prefix, the scan jumps via binary search to where the subtree
+ * starts in the current (or a later) namespace, so whole subtrees without
+ * spec coverage are never visited.
+ *
+ * @retval the size of @p ks if there is no further key below @p prefix
+ */
+static elektraCursor specFindBelow (KeySet * ks, const Key * prefix, elektraCursor from)
+{
+	ssize_t size = ksGetSize (ks);
+	if (keyGetUnescapedNameSize (prefix) == 3)
+	{
+		// root prefix: every key qualifies (and root keys never pass keyIsBelowOrSame with a cascading root)
+		return from < size ? from : size;
+	}
+	while (from < size)
+	{
+		Key * cur = ksAtCursor (ks, from);
+		if (keyIsBelowOrSame (prefix, cur) == 1)
+		{
+			return from;
+		}
+
+		elektraNamespace ns = keyGetNamespace (cur);
+		Key * search = keyDup (prefix, KEY_CP_NAME);
+		keySetNamespace (search, ns);
+		ssize_t pos = ksSearchInternal (ks, search);
+		keyDel (search);
+		if (pos < 0)
+		{
+			pos = -pos - 1;
+		}
+
+		if (pos > from)
+		{
+			from = pos;
+			continue;
+		}
+
+		// the subtree in this namespace is already behind us, skip to the next namespace
+		if (ns >= KEY_NS_DEFAULT)
+		{
+			return size;
+		}
+
+		search = keyNew ("/", KEY_END);
+		keySetNamespace (search, ns + 1);
+		pos = ksSearchInternal (ks, search);
+		keyDel (search);
+		from = pos < 0 ? -pos - 1 : pos;
+	}
+	return size;
+}
+
 
 static inline void safeFree (void * ptr)
 {
@@ -448,19 +524,16 @@ static void validateEmptyArray (KeySet * ks, Key * arraySpecParent, Key * parent
 		arrayParent = keyNew (keyName (parentLookup), KEY_END);
 	}
 
-	// TODO: [improvement] ksExtract?, like ksCut, but doesn't remove -> no need for ksDup
-	KeySet * ksCopy = ksDup (ks);
-	KeySet * subKeys = ksCut (ksCopy, parentLookup);
-	ksDel (ksCopy);
-
 	ssize_t parentLen = keyGetUnescapedNameSize (parentLookup);
 
 	bool haveConflict = false;
 	Key * cur;
-	ksRewind (subKeys);
-	while ((cur = ksNext (subKeys)) != NULL)
+	ssize_t size = ksGetSize (ks);
+	// read-only scan instead of ksDup + ksCut; metadata updates don't reorder ks
+	for (elektraCursor it = 0; it < size; ++it)
 	{
-		if (keyIsBelow (parentLookup, cur) == 0 || keyGetNamespace (cur) == KEY_NS_SPEC)
+		cur = ksAtCursor (ks, it);
+		if (keyIsBelow (parentLookup, cur) != 1 || keyGetNamespace (cur) == KEY_NS_SPEC)
 		{
 			continue;
 		}
@@ -491,7 +564,6 @@ static void validateEmptyArray (KeySet * ks, Key * arraySpecParent, Key * parent
 		keyDel (arrayParent);
 	}
 
-	ksDel (subKeys);
 	keyDel (parentLookup);
 
 	if (!immediate)
@@ -513,18 +585,15 @@ static void validateArrayMembers (KeySet * ks, Key * arraySpec)
 		return;
 	}
 
-	// TODO: [improvement] ksExtract?, like ksCut, but doesn't remove -> no need for ksDup
-	KeySet * ksCopy = ksDup (ks);
-	KeySet * subKeys = ksCut (ksCopy, parentLookup);
-	ksDel (ksCopy);
-
 	ssize_t parentLen = keyGetUnescapedNameSize (parentLookup);
 
 	Key * cur;
-	ksRewind (subKeys);
-	while ((cur = ksNext (subKeys)) != NULL)
+	ssize_t size = ksGetSize (ks);
+	// read-only scan instead of ksDup + ksCut; metadata updates don't reorder ks
+	for (elektraCursor it = 0; it < size; ++it)
 	{
-		if (keyIsBelow (parentLookup, cur) == 0 || keyGetNamespace (cur) == KEY_NS_SPEC ||
+		cur = ksAtCursor (ks, it);
+		if (keyIsBelow (parentLookup, cur) != 1 || keyGetNamespace (cur) == KEY_NS_SPEC ||
 		    keyGetNamespace (cur) == KEY_NS_CASCADING)
 		{
 			continue;
@@ -540,7 +609,6 @@ static void validateArrayMembers (KeySet * ks, Key * arraySpec)
 		}
 	}
 
-	ksDel (subKeys);
 	keyDel (parentLookup);
 
 	keySetMeta (arrayParent, "internal/spec/array/validated", "");
@@ -707,10 +775,11 @@ static void validateWildcardSubs (KeySet * ks, Key * key)
 	Key * parent = keyDup (key, KEY_CP_ALL);
 	keySetBaseName (parent, NULL);
 
-	// TODO: [improvement] ksExtract?, like ksCut, but doesn't remove -> no need for ksDup
-	KeySet * ksCopy = ksDup (ks);
-	KeySet * subKeys = ksCut (ksCopy, parent);
-	ksDel (ksCopy);
+	// keep only the subtree below parent; the copy is compacted in place instead of cut into yet another KeySet
+	KeySet * subKeys = ksDup (ks);
+	elektraCursor end;
+	elektraCursor start = ksFindHierarchy (subKeys, parent, &end);
+	ksRetainRange (subKeys, start, end);
 
 	Key * cur;
 	while ((cur = ksNext (subKeys)) != NULL)
@@ -730,6 +799,28 @@ static void validateWildcardSubs (KeySet * ks, Key * key)
 
 // endregion Wildcard (_) handling
 
+/**
+ * Predicate for ksRemoveIf(): matches keys in the spec namespace.
+ */
+static int keyIsSpecNamespace (Key * key, void * argument ELEKTRA_UNUSED)
+{
+	return keyGetNamespace (key) == KEY_NS_SPEC;
+}
+
+/**
+ * Predicate for ksRemoveIf(): matches keys that only exist for internal
+ * bookkeeping (instantiated array members and keys marked for removal).
+ * Also drops the `internal/spec/array/validated` marker from kept keys.
+ */
+static int keyIsSpecInternal (Key * key, void * argument ELEKTRA_UNUSED)
+{
+	if (keyGetNamespace (key) == KEY_NS_SPEC) return 1;
+
+	keySetMeta (key, "internal/spec/array/validated", NULL);
+
+	return keyGetMeta (key, "internal/spec/array") != NULL || keyGetMeta (key, "internal/spec/remove") != NULL;
+}
+
 /**
  * Copies all metadata (except for internal/ and conflict/) from @p dest to @p src
  */
@@ -804,11 +895,19 @@ static int processSpecKey (Key * specKey, Key * parentKey, KeySet * ks, const Co
 		return 0;
 	}
 
+	// compile the spec glob once, it is matched against every candidate key in ks
+	ElektraGlobPattern * specGlob = elektraGlobCompile (strchr (keyName (specKey), '/'));
+
+	// ks is sorted, so only the subtrees below the literal leading parts
+	// of the pattern (one per namespace) need to be scanned at all
+	Key * literalPrefix = specLiteralPrefix (specGlob);
+
 	int found = 0;
-	for (elektraCursor cursor = 0; cursor < ksGetSize (ks); ++cursor)
+	for (elektraCursor cursor = specFindBelow (ks, literalPrefix, 0); cursor < ksGetSize (ks);
+	     cursor = specFindBelow (ks, literalPrefix, cursor + 1))
 	{
 		Key * cur = ksAtCursor (ks, cursor);
-		if (!specMatches (specKey, cur))
+		if (!specMatches (specGlob, cur))
 		{
 			continue;
 		}
@@ -823,6 +922,9 @@ static int processSpecKey (Key * specKey, Key * parentKey, KeySet * ks, const Co
 		copyMeta (cur, specKey);
 	}
 
+	keyDel (literalPrefix);
+	elektraGlobPatternDel (specGlob);
+
 
 	int ret = 0;
 	if (!found)
@@ -908,7 +1010,14 @@ int elektraSpecGet (Plugin * handle, KeySet * returned, Key * parentKey)
 	ksRewind (returned);
 	while ((cur = ksNext (returned)) != NULL)
 	{
-		if (keyGetNamespace (cur) == KEY_NS_SPEC)
+		elektraNamespace ns = keyGetNamespace (cur);
+		if (ns > KEY_NS_SPEC)
+		{
+			// keysets are sorted by namespace; no more spec keys can follow
+			break;
+		}
+
+		if (ns == KEY_NS_SPEC)
 		{
 			if (isArraySpec (cur))
 			{
@@ -927,10 +1036,8 @@ int elektraSpecGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		ret = ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
-	// remove spec namespace from returned
-	Key * specParent = keyNew ("spec:/", KEY_END);
-	ksDel (ksCut (returned, specParent));
-	keyDel (specParent);
+	// remove spec namespace from returned; one compaction pass instead of cutting into a throwaway KeySet
+	ksRemoveIf (returned, keyIsSpecNamespace, NULL);
 
 	// extract other namespaces
 	KeySet * ks = ksCut (returned, parentKey);
@@ -979,7 +1086,14 @@ int elektraSpecSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	ksRewind (returned);
 	while ((cur = ksNext (returned)) != NULL)
 	{
-		if (keyGetNamespace (cur) == KEY_NS_SPEC)
+		elektraNamespace ns = keyGetNamespace (cur);
+		if (ns > KEY_NS_SPEC)
+		{
+			// keysets are sorted by namespace; no more spec keys can follow
+			break;
+		}
+
+		if (ns == KEY_NS_SPEC)
 		{
 			if (isArraySpec (cur))
 			{
@@ -998,10 +1112,8 @@ int elektraSpecSet (Plugin * handle, KeySet * returned, Key * parentKey)
 		ret = ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
-	// remove spec namespace from returned
-	Key * specParent = keyNew ("spec:/", KEY_END);
-	ksDel (ksCut (returned, specParent));
-	keyDel (specParent);
+	// remove spec namespace from returned; one compaction pass instead of cutting into a throwaway KeySet
+	ksRemoveIf (returned, keyIsSpecNamespace, NULL);
 
 	// extract other namespaces
 	KeySet * ks = ksCut (returned, parentKey);
@@ -1030,21 +1142,8 @@ int elektraSpecSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	}
 
 	// reconstruct KeySet
-	ksRewind (ks);
-	while ((cur = ksNext (ks)) != NULL)
-	{
-		if (keyGetNamespace (cur) == KEY_NS_SPEC)
-		{
-			continue;
-		}
-
-		keySetMeta (cur, "internal/spec/array/validated", NULL);
-
-		if (keyGetMeta (cur, "internal/spec/array") == NULL && keyGetMeta (cur, "internal/spec/remove") == NULL)
-		{
-			ksAppendKey (returned, cur);
-		}
-	}
+	ksRemoveIf (ks, keyIsSpecInternal, NULL);
+	ksAppend (returned, ks);
 
 	// cleanup
 	ksDel (ks);
@@ -17,6 +17,7 @@
 #include <kdbmodule.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <utime.h>
 
@@ -46,6 +47,7 @@ static struct change allowedChanges[] = { { "meta:/description", true, true, tru
 static bool readConfig (KeySet * conf, char ** directFilePtr, char ** appPtr, char *** argvPtr, Key * errorKey);
 static bool loadSpec (KeySet * returned, const char * directFile, const char * app, char * argv[], Key * parentKey,
 		      ElektraInvokeHandle * quickDump);
+static bool getSpec (Specload * specload, KeySet * returned, Key * parentKey);
 static int isChangeAllowed (Key * oldKey, Key * newKey);
 static KeySet * calculateMetaDiff (Key * oldKey, Key * newKey);
 
@@ -94,6 +96,9 @@ int elektraSpecloadOpen (Plugin * handle, Key * errorKey)
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	specload->cachedSpec = NULL;
+	specload->cachedMtime = 0;
+
 	specload->quickDumpConfig = ksNew (0, KS_END);
 	specload->quickDump = elektraInvokeOpen ("quickdump", specload->quickDumpConfig, errorKey);
 
@@ -118,6 +123,11 @@ int elektraSpecloadClose (Plugin * handle, Key * errorKey)
 
 		ksDel (specload->quickDumpConfig);
 
+		if (specload->cachedSpec != NULL)
+		{
+			ksDel (specload->cachedSpec);
+		}
+
 		if (specload->directFile != NULL)
 		{
 			elektraFree (specload->directFile);
@@ -206,7 +216,7 @@ int elektraSpecloadGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 	KeySet * spec = ksNew (0, KS_END);
 
-	if (!loadSpec (spec, specload->directFile, specload->app, specload->argv, parentKey, specload->quickDump))
+	if (!getSpec (specload, spec, parentKey))
 	{
 		ksDel (spec);
 		ELEKTRA_SET_INSTALLATION_ERROR (
@@ -249,7 +259,7 @@ int elektraSpecloadSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	Specload * specload = elektraPluginGetData (handle);
 
 	KeySet * spec = ksNew (0, KS_END);
-	if (!loadSpec (spec, specload->directFile, specload->app, specload->argv, parentKey, specload->quickDump))
+	if (!getSpec (specload, spec, parentKey))
 	{
 		ksDel (spec);
 		ELEKTRA_SET_INSTALLATION_ERROR (
@@ -459,6 +469,44 @@ bool readConfig (KeySet * conf, char ** directFilePtr, char ** appPtr, char ***
 	return true;
 }
 
+/**
+ * Like loadSpec, but serves the base specification from the in-memory cache
+ * while the app binary keeps its mtime, so repeated gets and sets on the same
+ * handle do not spawn the app again.
+ */
+static bool getSpec (Specload * specload, KeySet * returned, Key * parentKey)
+{
+	struct stat appStat;
+	bool hasMtime = specload->app != NULL && stat (specload->app, &appStat) == 0;
+
+	if (hasMtime && specload->cachedSpec != NULL && specload->cachedMtime == appStat.st_mtime)
+	{
+		ksAppend (returned, specload->cachedSpec);
+		return true;
+	}
+
+	KeySet * spec = ksNew (0, KS_END);
+	if (!loadSpec (spec, specload->directFile, specload->app, specload->argv, parentKey, specload->quickDump))
+	{
+		ksDel (spec);
+		return false;
+	}
+
+	if (hasMtime)
+	{
+		if (specload->cachedSpec != NULL)
+		{
+			ksDel (specload->cachedSpec);
+		}
+		specload->cachedSpec = ksDup (spec);
+		specload->cachedMtime = appStat.st_mtime;
+	}
+
+	ksAppend (returned, spec);
+	ksDel (spec);
+	return true;
+}
+
 bool loadSpec (KeySet * returned, const char * directFile, const char * app, char * argv[], Key * parentKey,
 	       ElektraInvokeHandle * quickDump)
 {
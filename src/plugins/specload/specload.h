@@ -13,6 +13,8 @@
 #include <kdbinvoke.h>
 #include <kdbplugin.h>
 
+#include <time.h>
+
 typedef struct
 {
 	char * directFile;
@@ -20,6 +22,9 @@ typedef struct
 	char ** argv;
 	KeySet * quickDumpConfig;
 	ElektraInvokeHandle * quickDump;
+	/** base spec already received from the app, valid while the app binary keeps its mtime */
+	KeySet * cachedSpec;
+	time_t cachedMtime;
 } Specload;
 
 int elektraSpecloadOpen (Plugin * handle, Key * errorKey);
@@ -22,6 +22,48 @@
 
 #define ERROR_SIZE 1024
 
+typedef enum
+{
+	POLICY_FSYNC,	  /* flush file data and metadata (default) */
+	POLICY_FDATASYNC, /* flush file data only, for files whose metadata is unchanged */
+	POLICY_SYNCFS,	  /* flush the whole filesystem, batches mountpoints sharing one filesystem */
+	POLICY_NONE,	  /* eventual durability, leave flushing to the kernel writeback */
+} SyncPolicy;
+
+/**
+ * @brief Reads the sync policy from the plugin configuration
+ *
+ * @param handle the plugin handle holding the mountpoint configuration
+ * @param parentKey where an error is set for an unknown policy
+ * @param policy gets set to the configured policy, POLICY_FSYNC if none is configured
+ *
+ * @retval 0 on success
+ * @retval -1 if an unknown policy was configured
+ */
+static int getPolicy (Plugin * handle, Key * parentKey, SyncPolicy * policy)
+{
+	*policy = POLICY_FSYNC;
+	const Key * policyKey = ksLookupByName (elektraPluginGetConfig (handle), "/policy", 0);
+	if (!policyKey) return 0;
+
+	const char * policyString = keyString (policyKey);
+	if (!strcmp (policyString, "fsync"))
+		*policy = POLICY_FSYNC;
+	else if (!strcmp (policyString, "fdatasync"))
+		*policy = POLICY_FDATASYNC;
+	else if (!strcmp (policyString, "syncfs"))
+		*policy = POLICY_SYNCFS;
+	else if (!strcmp (policyString, "none"))
+		*policy = POLICY_NONE;
+	else
+	{
+		ELEKTRA_SET_INSTALLATION_ERRORF (parentKey, "Unknown sync policy '%s', valid policies are fsync, fdatasync, syncfs, none",
+						 policyString);
+		return -1;
+	}
+	return 0;
+}
+
 
 int elektraSyncGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
 {
@@ -47,6 +89,10 @@ int elektraSyncGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UN
 int elektraSyncSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey)
 {
 	/* set all keys */
+	SyncPolicy policy;
+	if (getPolicy (handle, parentKey, &policy) == -1) return -1;
+	if (policy == POLICY_NONE) return 1; // durability left to the kernel writeback
+
 	const char * configFile = keyString (parentKey);
 	if (!strcmp (configFile, "")) return 0; // no underlying config file
 	int fd = open (configFile, O_RDWR);
@@ -55,9 +101,33 @@ int elektraSyncSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UN
 		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not open config file %s. Reason: %s", configFile, strerror (errno));
 		return -1;
 	}
-	if (fsync (fd) == -1)
+
+	const char * syncFunction = "fsync";
+	int result;
+	switch (policy)
+	{
+	case POLICY_FDATASYNC:
+		syncFunction = "fdatasync";
+		result = fdatasync (fd);
+		break;
+	case POLICY_SYNCFS:
+#ifdef HAVE_SYNCFS
+		/* flushing the filesystem once makes the flushes of further
+		 * mountpoints committed to the same filesystem near no-ops */
+		syncFunction = "syncfs";
+		result = syncfs (fd);
+		break;
+#endif
+	// FALLTHROUGH: without syncfs the full fsync is the closest policy
+	default:
+		result = fsync (fd);
+		break;
+	}
+
+	if (result == -1)
 	{
-		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not fsync config file %s. Reason: %s", configFile, strerror (errno));
+		ELEKTRA_SET_RESOURCE_ERRORF (parentKey, "Could not %s config file %s. Reason: %s", syncFunction, configFile,
+					     strerror (errno));
 		close (fd);
 		return -1;
 	}
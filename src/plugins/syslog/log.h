@@ -9,8 +9,27 @@
 #define ELEKTRA_PLUGIN_SYSLOG_H
 
 #include <kdbplugin.h>
+#include <pthread.h>
 #include <syslog.h>
 
+/** number of slots in the asynchronous message ring */
+#define ELEKTRA_SYSLOG_RING_SIZE (1024)
+
+typedef struct
+{
+	int async; /*!< messages are emitted by the logger thread */
+
+	/** ring of formatted messages, filled by the commit path and drained by the logger thread */
+	char * messages[ELEKTRA_SYSLOG_RING_SIZE];
+	size_t head; /*!< next slot the producer fills */
+	size_t tail; /*!< next slot the logger thread drains */
+
+	pthread_mutex_t lock;
+	pthread_cond_t newMessage;
+	pthread_t thread;
+	int stop; /*!< logger thread exits once the ring is drained */
+} SyslogData;
+
 int elektraSyslogOpen (Plugin * handle, Key * parentKey);
 int elektraSyslogClose (Plugin * handle, Key * parentKey);
 int elektraSyslogGet (Plugin * handle, KeySet * ks, Key * parentKey);
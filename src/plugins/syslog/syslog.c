@@ -12,6 +12,89 @@
 
 #include "log.h"
 
+#include <kdbhelper.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+
+/**
+ * Drain the message ring until elektraSyslogClose() requests shutdown.
+ */
+static void * logMessages (void * arg)
+{
+	SyslogData * data = arg;
+
+	pthread_mutex_lock (&data->lock);
+	for (;;)
+	{
+		while (data->tail == data->head && !data->stop)
+		{
+			pthread_cond_wait (&data->newMessage, &data->lock);
+		}
+		if (data->tail == data->head) break;
+
+		char * message = data->messages[data->tail];
+		data->tail = (data->tail + 1) % ELEKTRA_SYSLOG_RING_SIZE;
+
+		// emit without holding the lock, the syslog sink may block
+		pthread_mutex_unlock (&data->lock);
+		syslog (LOG_NOTICE, "%s", message);
+		elektraFree (message);
+		pthread_mutex_lock (&data->lock);
+	}
+	pthread_mutex_unlock (&data->lock);
+
+	return NULL;
+}
+
+/**
+ * Log a notice either directly or via the message ring.
+ *
+ * With async enabled the message is formatted and appended to the ring, so
+ * the commit path does not wait for the syslog sink. Logging is best effort:
+ * when the ring is full the message is dropped.
+ */
+static void logNotice (Plugin * handle, const char * format, ...)
+{
+	SyslogData * data = elektraPluginGetData (handle);
+	va_list args;
+	va_start (args, format);
+
+	if (data && data->async)
+	{
+		va_list lengthArgs;
+		va_copy (lengthArgs, args);
+		int length = vsnprintf (NULL, 0, format, lengthArgs);
+		va_end (lengthArgs);
+
+		if (length >= 0)
+		{
+			char * message = elektraMalloc (length + 1);
+			vsnprintf (message, length + 1, format, args);
+
+			pthread_mutex_lock (&data->lock);
+			size_t next = (data->head + 1) % ELEKTRA_SYSLOG_RING_SIZE;
+			if (next == data->tail)
+			{
+				elektraFree (message);
+			}
+			else
+			{
+				data->messages[data->head] = message;
+				data->head = next;
+				pthread_cond_signal (&data->newMessage);
+			}
+			pthread_mutex_unlock (&data->lock);
+		}
+	}
+	else
+	{
+		vsyslog (LOG_NOTICE, format, args);
+	}
+
+	va_end (args);
+}
+
 int elektraSyslogOpen (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 {
 	/* plugin initialization logic */
@@ -21,6 +104,25 @@ int elektraSyslogOpen (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 		openlog ("elektra", LOG_PID, LOG_USER);
 	}
 
+	SyslogData * data = elektraMalloc (sizeof (SyslogData));
+	memset (data, 0, sizeof (SyslogData));
+	data->async = strncmp (keyString (ksLookupByName (elektraPluginGetConfig (handle), "/async", 0)), "1", 1) == 0;
+
+	if (data->async)
+	{
+		pthread_mutex_init (&data->lock, NULL);
+		pthread_cond_init (&data->newMessage, NULL);
+		if (pthread_create (&data->thread, NULL, logMessages, data) != 0)
+		{
+			// fall back to synchronous logging
+			pthread_cond_destroy (&data->newMessage);
+			pthread_mutex_destroy (&data->lock);
+			data->async = 0;
+		}
+	}
+
+	elektraPluginSetData (handle, data);
+
 	return 0; /* success */
 }
 
@@ -28,6 +130,24 @@ int elektraSyslogClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 {
 	/* free all plugin resources and shut it down */
 
+	SyslogData * data = elektraPluginGetData (handle);
+	if (data)
+	{
+		if (data->async)
+		{
+			// wake the logger thread and wait until the ring is drained
+			pthread_mutex_lock (&data->lock);
+			data->stop = 1;
+			pthread_cond_signal (&data->newMessage);
+			pthread_mutex_unlock (&data->lock);
+			pthread_join (data->thread, NULL);
+			pthread_cond_destroy (&data->newMessage);
+			pthread_mutex_destroy (&data->lock);
+		}
+		elektraFree (data);
+		elektraPluginSetData (handle, NULL);
+	}
+
 	if (!ksLookupByName (elektraPluginGetConfig (handle), "/dontopensyslog", 0))
 	{
 		closelog ();
@@ -59,13 +179,13 @@ int elektraSyslogGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 	if (strncmp (keyString (ksLookupByName (elektraPluginGetConfig (handle), "/log/get", 0)), "1", 1) == 0)
 	{
-		syslog (LOG_NOTICE, "loading configuration %s", keyName (parentKey));
+		logNotice (handle, "loading configuration %s", keyName (parentKey));
 	}
 
 	return 1;
 }
 
-int elektraSyslogSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraSyslogSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	size_t changed = 0;
 	Key * k = 0;
@@ -74,19 +194,19 @@ int elektraSyslogSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * p
 	{
 		if (keyNeedSync (k))
 		{
-			syslog (LOG_NOTICE, "change %s to %s", keyName (k), keyString (k));
+			logNotice (handle, "change %s to %s", keyName (k), keyString (k));
 			changed++;
 		}
 	}
 
-	syslog (LOG_NOTICE, "committed configuration %s with %zd keys (%zu changed)", keyName (parentKey), ksGetSize (returned), changed);
+	logNotice (handle, "committed configuration %s with %zd keys (%zu changed)", keyName (parentKey), ksGetSize (returned), changed);
 
 	return 1;
 }
 
-int elektraSyslogError (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraSyslogError (Plugin * handle, KeySet * returned, Key * parentKey)
 {
-	syslog (LOG_NOTICE, "rollback configuration %s with %zd keys", keyName (parentKey), ksGetSize (returned));
+	logNotice (handle, "rollback configuration %s with %zd keys", keyName (parentKey), ksGetSize (returned));
 
 	return 1;
 }
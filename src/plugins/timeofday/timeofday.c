@@ -10,49 +10,114 @@
 
 #include "timeofday.h"
 
+#include <fcntl.h>    // shm_open()
 #include <string.h>
+#include <sys/mman.h> // shm_open(), mmap()
+#include <sys/stat.h>
+#include <unistd.h>   // getpid(), ftruncate()
 
 #define ARRAY_LENGTH 25
 
-static inline void timeofday (char * t, struct timeval * start, struct timeval * now)
+static inline uint64_t nanoseconds (struct timespec ts)
 {
-	struct timeval tv;
+	return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+}
 
-	tv.tv_sec = now->tv_sec - start->tv_sec;
-	if ((tv.tv_usec = now->tv_usec - start->tv_usec) < 0)
-	{
-		tv.tv_sec--;
-		tv.tv_usec += 1000000;
-	}
+/**
+ * Format @p ns as seconds and microseconds, like the historic
+ * gettimeofday based output did.
+ */
+static inline void timeofday (char * t, uint64_t ns)
+{
+	uint64_t sec = ns / 1000000000;
+	uint64_t usec = (ns % 1000000000) / 1000;
 
 	for (int i = 9; i >= 4; --i)
 	{
-		t[i] = tv.tv_usec % 10 + '0';
-		tv.tv_usec /= 10;
+		t[i] = usec % 10 + '0';
+		usec /= 10;
 	}
 	for (int i = 3; i >= 0; --i)
 	{
-		t[i] = tv.tv_sec % 10 + '0';
-		tv.tv_sec /= 10;
+		t[i] = sec % 10 + '0';
+		sec /= 10;
 	}
 	t[10] = 0;
 }
 
 const char * elektraTimeofdayHelper (char * t, TimeofdayInfo * ti)
 {
-	struct timeval now;
-	gettimeofday (&now, 0);
-	timeofday (t, &ti->start, &now);
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	timeofday (t, nanoseconds (now) - nanoseconds (ti->start));
 	t[10] = '\t';
 	t[11] = 'd';
 	t[12] = 'i';
 	t[13] = '\t';
-	timeofday (&t[14], &ti->last, &now);
+	timeofday (&t[14], nanoseconds (now) - nanoseconds (ti->last));
 	ti->last = now;
 
 	return t;
 }
 
+/**
+ * Record one invocation into the shared memory trace ring.
+ *
+ * The slot is claimed with an atomic increment, so concurrent
+ * processes never write to the same slot. Readers may observe a
+ * slot while it is written; the trace tool tolerates that.
+ */
+static void recordSpan (TimeofdayInfo * ti, const char * position, const Key * parentKey)
+{
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	uint64_t timestamp = nanoseconds (now);
+
+	uint64_t slot = __atomic_fetch_add (&ti->ring->head, 1, __ATOMIC_RELAXED);
+	ElektraTraceSpan * span = &ti->ring->spans[slot % ELEKTRA_TRACE_RING_SIZE];
+
+	span->timestamp = timestamp;
+	span->delta = timestamp - nanoseconds (ti->last);
+	span->pid = getpid ();
+	strncpy (span->position, position, sizeof (span->position) - 1);
+	span->position[sizeof (span->position) - 1] = '\0';
+	strncpy (span->parent, parentKey ? keyName (parentKey) : "", sizeof (span->parent) - 1);
+	span->parent[sizeof (span->parent) - 1] = '\0';
+
+	// without output on stderr elektraTimeofdayHelper() never runs
+	if (ti->silent) ti->last = now;
+}
+
+/**
+ * Map the shared memory trace ring when the config enables it.
+ */
+static ElektraTraceRing * attachTraceRing (KeySet * config)
+{
+	if (!ksLookupByName (config, "/shm", 0)) return NULL;
+
+	char shmName[64];
+	snprintf (shmName, sizeof (shmName), ELEKTRA_TRACE_SHM_NAME_FORMAT, (long) getuid ());
+
+	int fd = shm_open (shmName, O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+	if (fd == -1)
+	{
+		return NULL;
+	}
+	if (ftruncate (fd, sizeof (ElektraTraceRing)) == -1)
+	{
+		close (fd);
+		return NULL;
+	}
+
+	void * mem = mmap (0, sizeof (ElektraTraceRing), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close (fd);
+	if (mem == MAP_FAILED)
+	{
+		return NULL;
+	}
+	return mem;
+}
+
 int elektraTimeofdayOpen (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 {
 	TimeofdayInfo * ti = calloc (1, sizeof (TimeofdayInfo));
@@ -61,18 +126,23 @@ int elektraTimeofdayOpen (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 	elektraPluginSetData (handle, ti);
 
 	// init time
-	gettimeofday (&ti->start, 0);
+	clock_gettime (CLOCK_MONOTONIC, &ti->start);
 	ti->last = ti->start;
 
 	KeySet * config = elektraPluginGetConfig (handle);
+	ti->silent = ksLookupByName (config, "/silent", 0) != NULL;
+	ti->ring = attachTraceRing (config);
+
+	if (ti->ring) recordSpan (ti, "open", parentKey);
+
 	if (ksLookupByName (config, "/module", 0))
 	{
-		if (ksLookupByName (config, "/logmodule", 0))
+		if (ksLookupByName (config, "/logmodule", 0) && !ti->silent)
 		{
 			fprintf (stderr, "open (module)\t%s\n", elektraTimeofdayHelper (t, ti));
 		}
 	}
-	else
+	else if (!ti->silent)
 	{
 		fprintf (stderr, "open\t%s\n", elektraTimeofdayHelper (t, ti));
 	}
@@ -85,19 +155,22 @@ int elektraTimeofdayClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 	char t[ARRAY_LENGTH];
 	TimeofdayInfo * ti = elektraPluginGetData (handle);
 
+	if (ti->ring) recordSpan (ti, "close", parentKey);
+
 	KeySet * config = elektraPluginGetConfig (handle);
 	if (ksLookupByName (config, "/module", 0))
 	{
-		if (ksLookupByName (config, "/logmodule", 0))
+		if (ksLookupByName (config, "/logmodule", 0) && !ti->silent)
 		{
 			fprintf (stderr, "close (module)\t%s\n", elektraTimeofdayHelper (t, ti));
 		}
 	}
-	else
+	else if (!ti->silent)
 	{
 		fprintf (stderr, "close\t%s\n", elektraTimeofdayHelper (t, ti));
 	}
 
+	if (ti->ring) munmap (ti->ring, sizeof (ElektraTraceRing));
 	elektraFree (ti);
 
 	return 0; /* success */
@@ -134,8 +207,10 @@ int elektraTimeofdayGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		ksAppend (returned, pluginConfig);
 		ksDel (pluginConfig);
 
+		if (ti->ring) recordSpan (ti, "postmodulesconf", parentKey);
+
 		KeySet * config = elektraPluginGetConfig (handle);
-		if (ksLookupByName (config, "/logmodule", 0))
+		if (ksLookupByName (config, "/logmodule", 0) && !ti->silent)
 		{
 			fprintf (stderr, "get\t%s\tpos\t%s\n", elektraTimeofdayHelper (t, ti), "postmodulesconf");
 		}
@@ -143,7 +218,9 @@ int elektraTimeofdayGet (Plugin * handle, KeySet * returned, Key * parentKey)
 		return 1;
 	}
 
-	fprintf (stderr, "get\t%s\tpos\t%s\n", elektraTimeofdayHelper (t, ti), position);
+	if (ti->ring) recordSpan (ti, position, parentKey);
+
+	if (!ti->silent) fprintf (stderr, "get\t%s\tpos\t%s\n", elektraTimeofdayHelper (t, ti), position);
 
 	return 1;
 }
@@ -166,7 +243,9 @@ int elektraTimeofdaySet (Plugin * handle, KeySet * returned ELEKTRA_UNUSED, Key
 		position = "postcommit";
 	}
 
-	fprintf (stderr, "set\t%s\tpos\t%s\n", elektraTimeofdayHelper (t, ti), position);
+	if (ti->ring) recordSpan (ti, position, parentKey);
+
+	if (!ti->silent) fprintf (stderr, "set\t%s\tpos\t%s\n", elektraTimeofdayHelper (t, ti), position);
 
 	return 1;
 }
@@ -188,7 +267,9 @@ int elektraTimeofdayError (Plugin * handle, KeySet * returned ELEKTRA_UNUSED, Ke
 		position = "postrollback";
 	}
 
-	fprintf (stderr, "err\t%s\tpos\t%s\n", elektraTimeofdayHelper (t, ti), position);
+	if (ti->ring) recordSpan (ti, position, parentKey);
+
+	if (!ti->silent) fprintf (stderr, "err\t%s\tpos\t%s\n", elektraTimeofdayHelper (t, ti), position);
 
 	return 1;
 }
@@ -204,4 +285,3 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 		ELEKTRA_PLUGIN_ERROR,	&elektraTimeofdayError,
 		ELEKTRA_PLUGIN_END);
 }
-
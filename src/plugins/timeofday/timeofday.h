@@ -8,21 +8,47 @@
 
 #include <kdbplugin.h>
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#include <time.h>
 
 
 #define BACKENDNAME "timeofday"
 #define BACKENDVERSION "0.0.1"
 
+/** name of the shared memory trace ring, instantiated with the user id */
+#define ELEKTRA_TRACE_SHM_NAME_FORMAT "/elektra-trace-%ld"
+
+/** number of span slots in the shared memory trace ring */
+#define ELEKTRA_TRACE_RING_SIZE (4096)
+
+/** one plugin invocation, recorded into the shared memory trace ring */
+typedef struct
+{
+	uint64_t timestamp; /*!< monotonic time of the invocation in nanoseconds */
+	uint64_t delta;	    /*!< nanoseconds since the previous invocation of this handle */
+	int32_t pid;
+	char position[16]; /*!< plugin placement, e.g. "pregetstorage" */
+	char parent[92];   /*!< parent key name, truncated */
+} ElektraTraceSpan;
+
+/** shared memory trace ring, written by plugins and read by the trace tool */
+typedef struct
+{
+	uint64_t head; /*!< total number of spans written, slot = head % ring size */
+	ElektraTraceSpan spans[ELEKTRA_TRACE_RING_SIZE];
+} ElektraTraceRing;
+
 struct _TimeofdayInfo
 {
-	struct timeval start;
-	struct timeval last;
+	struct timespec start;
+	struct timespec last;
 	int nrget;
 	int nrset;
 	int nrerr;
+	int silent;		 /*!< suppress output on stderr */
+	ElektraTraceRing * ring; /*!< mapped trace ring or NULL */
 };
 
 typedef struct _TimeofdayInfo TimeofdayInfo;
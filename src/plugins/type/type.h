@@ -35,6 +35,8 @@ typedef struct
 	kdb_long_long_t booleanRestore;
 	struct boolean_pair * booleans;
 	kdb_long_long_t booleanCount;
+	/** entry of the types table resolved last, see findTypeCached() */
+	const Type * lastType;
 } TypeData;
 
 int elektraTypeOpen (Plugin * handle, Key * errorKey);
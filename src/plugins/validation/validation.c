@@ -19,6 +19,84 @@
 
 static int validateKey (Key *, Key *);
 
+int elektraValidationOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	/* compiled regexes are shared across keys and invocations through this
+	 * per-instance cache, keyed by compile flags and pattern string */
+	KeySet * cache = ksNew (0, KS_END);
+	elektraPluginSetData (handle, cache);
+	return 1;
+}
+
+int elektraValidationClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	KeySet * cache = elektraPluginGetData (handle);
+	if (cache != NULL)
+	{
+		Key * cur = 0;
+		ksRewind (cache);
+		while ((cur = ksNext (cache)) != 0)
+		{
+			regex_t * regex;
+			memcpy (&regex, keyValue (cur), sizeof (regex));
+			regfree (regex);
+			elektraFree (regex);
+		}
+		ksDel (cache);
+		elektraPluginSetData (handle, NULL);
+	}
+	return 1;
+}
+
+/**
+ * Returns the compiled form of a regex, compiling it only when the cache
+ * holds no entry for the pattern/flags combination yet.
+ *
+ * With @p cache == NULL the compiled regex is not cached and the caller
+ * has to free it with regfree() and elektraFree().
+ *
+ * @retval NULL if the pattern does not compile; errorBuffer then holds the
+ *         regerror() message
+ */
+static regex_t * getCompiledRegex (KeySet * cache, const char * regexString, int cflags, char * errorBuffer, size_t errorBufferSize)
+{
+	Key * lookup = NULL;
+	if (cache != NULL)
+	{
+		char flagString[12];
+		snprintf (flagString, sizeof (flagString), "%d", cflags);
+		lookup = keyNew ("/", KEY_END);
+		keyAddBaseName (lookup, flagString);
+		keyAddBaseName (lookup, regexString);
+		Key * found = ksLookup (cache, lookup, 0);
+		if (found != NULL)
+		{
+			keyDel (lookup);
+			regex_t * compiled;
+			memcpy (&compiled, keyValue (found), sizeof (compiled));
+			return compiled;
+		}
+	}
+
+	regex_t * regex = elektraMalloc (sizeof (regex_t));
+	int ret = regcomp (regex, regexString, cflags);
+	if (ret != 0)
+	{
+		regerror (ret, regex, errorBuffer, errorBufferSize);
+		regfree (regex);
+		elektraFree (regex);
+		if (lookup != NULL) keyDel (lookup);
+		return NULL;
+	}
+
+	if (cache != NULL)
+	{
+		keySetBinary (lookup, &regex, sizeof (regex));
+		ksAppendKey (cache, lookup);
+	}
+	return regex;
+}
+
 int elektraValidationGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey ELEKTRA_UNUSED)
 {
 	KeySet * n;
@@ -26,6 +104,8 @@ int elektraValidationGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		  n = ksNew (30,
 			     keyNew ("system:/elektra/modules/validation", KEY_VALUE, "validation plugin waits for your orders", KEY_END),
 			     keyNew ("system:/elektra/modules/validation/exports", KEY_END),
+			     keyNew ("system:/elektra/modules/validation/exports/open", KEY_FUNC, elektraValidationOpen, KEY_END),
+			     keyNew ("system:/elektra/modules/validation/exports/close", KEY_FUNC, elektraValidationClose, KEY_END),
 			     keyNew ("system:/elektra/modules/validation/exports/get", KEY_FUNC, elektraValidationGet, KEY_END),
 			     keyNew ("system:/elektra/modules/validation/exports/set", KEY_FUNC, elektraValidationSet, KEY_END),
 			     keyNew ("system:/elektra/modules/validation/exports/ksLookupRE", KEY_FUNC, ksLookupRE, KEY_END),
@@ -36,7 +116,7 @@ int elektraValidationGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	return 1;
 }
 
-static int validateKey (Key * key, Key * parentKey)
+static int validateKeyCached (Key * key, Key * parentKey, KeySet * cache)
 {
 	const Key * regexMeta = keyGetMeta (key, "check/validation");
 
@@ -103,24 +183,22 @@ static int validateKey (Key * key, Key * parentKey)
 		regexString = (char *) keyString (regexMeta);
 	}
 
-	regex_t regex;
-	regmatch_t offsets;
-	int ret = regcomp (&regex, regexString, cflags);
+	char errorBuffer[1000];
+	regex_t * regex = getCompiledRegex (cache, regexString, cflags, errorBuffer, sizeof (errorBuffer));
 
-	if (ret != 0)
+	if (regex == NULL)
 	{
-		char buffer[1000];
-		regerror (ret, &regex, buffer, 999);
 		ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey, "Could not compile regex '%s' of the key '%s'. Reason: %s",
-							 keyString (regexMeta), keyName (key), buffer);
-		regfree (&regex);
+							 keyString (regexMeta), keyName (key), errorBuffer);
 		if (freeString) elektraFree (regexString);
 		return 0;
 	}
+	regmatch_t offsets;
+	int ret = 0;
 	int match = 0;
 	if (!wordValidation)
 	{
-		ret = regexec (&regex, keyString (key), 1, &offsets, 0);
+		ret = regexec (regex, keyString (key), 1, &offsets, 0);
 		if (ret == 0) match = 1;
 	}
 	else
@@ -130,7 +208,7 @@ static int validateKey (Key * key, Key * parentKey)
 		char * string = (char *) keyString (key);
 		while ((token = strtok_r (string, " \t\n", &savePtr)) != NULL)
 		{
-			ret = regexec (&regex, token, 1, &offsets, 0);
+			ret = regexec (regex, token, 1, &offsets, 0);
 			if (ret == 0)
 			{
 				match = 1;
@@ -141,6 +219,7 @@ static int validateKey (Key * key, Key * parentKey)
 	}
 	if (invertValidation) match = !match;
 
+	int result = 1;
 	if (!match)
 	{
 		const Key * msg = keyGetMeta (key, "check/validation/message");
@@ -149,30 +228,35 @@ static int validateKey (Key * key, Key * parentKey)
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
 								 "The key '%s' with value '%s' does not confirm to '%s'. Reason: %s",
 								 keyName (key), keyString (key), regexString, keyString (msg));
-			regfree (&regex);
-			if (freeString) elektraFree (regexString);
-			return 0;
 		}
 		else
 		{
 			char buffer[1000];
-			regerror (ret, &regex, buffer, 999);
+			regerror (ret, regex, buffer, 999);
 			ELEKTRA_SET_VALIDATION_SYNTACTIC_ERRORF (parentKey,
 								 "The key '%s' with value '%s' does not confirm to '%s'. Reason: %s",
 								 keyName (key), keyString (key), regexString, buffer);
-			regfree (&regex);
-			if (freeString) elektraFree (regexString);
-			return 0;
 		}
+		result = 0;
 	}
 
-	regfree (&regex);
+	if (cache == NULL)
+	{
+		regfree (regex);
+		elektraFree (regex);
+	}
 	if (freeString) elektraFree (regexString);
-	return 1;
+	return result;
+}
+
+static int validateKey (Key * key, Key * parentKey)
+{
+	return validateKeyCached (key, parentKey, NULL);
 }
 
-int elektraValidationSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraValidationSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
+	KeySet * cache = elektraPluginGetData (handle);
 	Key * cur = 0;
 
 	while ((cur = ksNext (returned)) != 0)
@@ -180,7 +264,7 @@ int elektraValidationSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		const Key * regexMeta = keyGetMeta (cur, "check/validation");
 
 		if (!regexMeta) continue;
-		int rc = validateKey (cur, parentKey);
+		int rc = validateKeyCached (cur, parentKey, cache);
 		if (!rc) return -1;
 	}
 
@@ -191,6 +275,8 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 {
 	// clang-format off
 	return elektraPluginExport("validation",
+			ELEKTRA_PLUGIN_OPEN,	&elektraValidationOpen,
+			ELEKTRA_PLUGIN_CLOSE,	&elektraValidationClose,
 			ELEKTRA_PLUGIN_GET,	&elektraValidationGet,
 			ELEKTRA_PLUGIN_SET,	&elektraValidationSet,
 			ELEKTRA_PLUGIN_END);
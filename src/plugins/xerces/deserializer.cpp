@@ -16,7 +16,6 @@
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/parsers/XercesDOMParser.hpp>
 
-#include <algorithm>
 #include <iostream>
 #include <locale>
 #include <map>
@@ -44,14 +43,23 @@ XercesPtr<DOMDocument> doc2dom (std::string const & src)
 
 string trim (string const & str)
 {
-	stringstream ss (str);
-	string to;
+	// one locale for the whole scan: constructing it per character dominated
+	// the text handling of large pretty-printed documents
+	locale const loc;
 	string trimmed;
+	size_t start = 0;
 
-	while (getline (ss, to, '\n'))
+	while (start < str.size ())
 	{
+		size_t end = str.find ('\n', start);
+		size_t len = (end == string::npos ? str.size () : end) - start;
 		// Remove whitespace lines, most likely caused by pretty printing
-		if (!all_of (to.begin (), to.end (), [] (char c) { return isspace (c, locale ()); })) trimmed += to;
+		bool onlyWhitespace = true;
+		for (size_t i = start; onlyWhitespace && i < start + len; ++i)
+			onlyWhitespace = isspace (str[i], loc);
+		if (!onlyWhitespace) trimmed.append (str, start, len);
+		if (end == string::npos) break;
+		start = end + 1;
 	}
 
 	return trimmed;
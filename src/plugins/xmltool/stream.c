@@ -181,7 +181,7 @@ ssize_t keyToStreamBasename (const Key * key, FILE * stream, const char * parent
 			written += fprintf (stream, "<key name=\"%s\"", key->key);
 	}
 
-	if (!key->data.v && !keyComment (key))
+	if (!keyValue (key) && !keyComment (key))
 	{ /* no data AND no comment */
 		written += fprintf (stream, "/>");
 		if (!(options & KDB_O_CONDENSED)) written += fprintf (stream, "\n\n");
@@ -190,10 +190,10 @@ ssize_t keyToStreamBasename (const Key * key, FILE * stream, const char * parent
 	}
 	else
 	{
-		if (key->data.v)
+		if (keyValue (key))
 		{
 			if ((key->dataSize <= 16) && keyIsString (key) && /*TODO: is this for string?*/
-			    !strchr (key->data.c, '\n'))
+			    !strchr (keyString (key), '\n'))
 			{
 
 				/* we'll use a "value" attribute instead of a <value> node,
@@ -205,7 +205,7 @@ ssize_t keyToStreamBasename (const Key * key, FILE * stream, const char * parent
 				else
 					written += fprintf (stream, "\n\t");
 
-				written += fprintf (stream, "value=\"%s\"", key->data.c);
+				written += fprintf (stream, "value=\"%s\"", keyString (key));
 
 				if (keyComment (key))
 					written += fprintf (stream, ">\n");
@@ -228,7 +228,7 @@ ssize_t keyToStreamBasename (const Key * key, FILE * stream, const char * parent
 					written += fprintf (stream, "<![CDATA[");
 					fflush (stream);
 					/* must chop ending \\0 */
-					written += fwrite (key->data.v, sizeof (char), key->dataSize - 1, stream);
+					written += fwrite (keyValue (key), sizeof (char), key->dataSize - 1, stream);
 					written += fprintf (stream, "]]>");
 				}
 				else
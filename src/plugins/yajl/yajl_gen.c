@@ -163,8 +163,13 @@ static void elektraGenValue (yajl_gen g, Key * parentKey, const Key * cur)
 			yajl_gen_string (g, (const unsigned char *) keyString (cur), keyGetValueSize (cur) - 1);
 		}
 	}
-	else if (!strcmp (keyString (type), "double"))
+	else if (!strcmp (keyString (type), "double") || !strcmp (keyString (type), "float") || !strcmp (keyString (type), "short") ||
+		 !strcmp (keyString (type), "unsigned_short") || !strcmp (keyString (type), "long") ||
+		 !strcmp (keyString (type), "unsigned_long") || !strcmp (keyString (type), "long_long") ||
+		 !strcmp (keyString (type), "unsigned_long_long"))
 	{
+		// emit numeric types directly, which also avoids the escaping
+		// walk yajl_gen_string does over every value
 		yajl_gen_number (g, keyString (cur), keyGetValueSize (cur) - 1);
 	}
 	else
@@ -222,26 +227,39 @@ int elektraGenEmpty (yajl_gen g, KeySet * returned, Key * parentKey)
 	return did_something;
 }
 
-int elektraGenWriteFile (yajl_gen g, Key * parentKey)
+/**
+ * @brief Print callback of the generator, streams directly into the file
+ *
+ * Keeps the generator's memory flat: without a callback yajl would
+ * buffer the complete serialized document before it can be written out.
+ */
+static void elektraGenPrintToFile (void * ctx, const char * str, yajl_size_type len)
+{
+	fwrite (str, 1, len, (FILE *) ctx);
+}
+
+/**
+ * @brief Finish writing the streamed output file
+ *
+ * @retval 1 on success
+ * @retval -1 if a write error occurred
+ */
+static int elektraGenWriteClose (FILE * fp, Key * parentKey)
 {
 	int errnosave = errno;
-	FILE * fp = fopen (keyString (parentKey), "w");
+	int hasError = ferror (fp);
+	if (fclose (fp) != 0)
+	{
+		hasError = 1;
+	}
 
-	if (!fp)
+	if (hasError)
 	{
 		ELEKTRA_SET_ERROR_SET (parentKey);
 		errno = errnosave;
 		return -1;
 	}
 
-	const unsigned char * buf;
-	yajl_size_type len;
-	yajl_gen_get_buf (g, &buf, &len);
-	fwrite (buf, 1, len, fp);
-	yajl_gen_clear (g);
-
-	fclose (fp);
-
 	errno = errnosave;
 	return 1; /* success */
 }
@@ -274,12 +292,24 @@ static void elektraCheckForEmptyArray (KeySet * ks)
 
 int elektraYajlSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
 {
+	int errnosave = errno;
+	FILE * fp = fopen (keyString (parentKey), "w");
+	if (!fp)
+	{
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		errno = errnosave;
+		return -1;
+	}
+	// stream through a fixed buffer, like the 64k chunks on the get side
+	setvbuf (fp, NULL, _IOFBF, 65536);
+
 #if YAJL_MAJOR == 1
 	yajl_gen_config conf = { 1, "    " };
-	yajl_gen g = yajl_gen_alloc (&conf, NULL);
+	yajl_gen g = yajl_gen_alloc2 (elektraGenPrintToFile, &conf, NULL, fp);
 #else
 	yajl_gen g = yajl_gen_alloc (NULL);
 	yajl_gen_config (g, yajl_gen_beautify, 1);
+	yajl_gen_config (g, yajl_gen_print_callback, elektraGenPrintToFile, fp);
 #endif
 
 	elektraCheckForEmptyArray (returned);
@@ -288,16 +318,14 @@ int elektraYajlSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 	    keyGetValueSize (ksHead (returned)) > 1)
 	{
 		elektraGenValue (g, parentKey, ksHead (returned));
-		int ret = elektraGenWriteFile (g, parentKey);
 		yajl_gen_free (g);
-		return ret;
+		return elektraGenWriteClose (fp, parentKey);
 	}
 
 	if (elektraGenEmpty (g, returned, parentKey))
 	{
-		int ret = elektraGenWriteFile (g, parentKey);
 		yajl_gen_free (g);
-		return ret;
+		return elektraGenWriteClose (fp, parentKey);
 	}
 
 	ksRewind (returned);
@@ -307,6 +335,7 @@ int elektraYajlSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 		// empty config should be handled by resolver
 		// (e.g. remove file)
 		yajl_gen_free (g);
+		fclose (fp);
 		return 0;
 	}
 
@@ -331,8 +360,7 @@ int elektraYajlSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 
 	elektraGenCloseFinally (g, cur, parentKey);
 
-	int ret = elektraGenWriteFile (g, parentKey);
 	yajl_gen_free (g);
 
-	return ret;
+	return elektraGenWriteClose (fp, parentKey);
 }
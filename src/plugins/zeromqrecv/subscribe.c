@@ -11,6 +11,8 @@
 #include <kdbhelper.h>
 #include <kdblogger.h>
 
+#include <string.h> // strlen(), memcpy()
+
 static int setupNotificationCallback (Plugin * handle)
 {
 	ELEKTRA_NOT_NULL (handle);
@@ -42,11 +44,63 @@ static int setupNotificationCallback (Plugin * handle)
 	return 0;
 }
 
+/**
+ * @internal
+ * Receive one message part as null-terminated string.
+ *
+ * @param  socket  ZeroMq socket
+ * @param  message initialized message
+ * @return         string (has to be freed by the caller) or NULL if
+ *                 no message part was available
+ */
+static char * receiveMessagePart (void * socket, zmq_msg_t * message)
+{
+	int result = zmq_msg_recv (message, socket, ZMQ_DONTWAIT);
+	if (result == -1)
+	{
+		return NULL;
+	}
+	int length = zmq_msg_size (message);
+	char * part = elektraMemDup (zmq_msg_data (message), length + 1);
+	part[length] = '\0';
+	return part;
+}
+
+/**
+ * @internal
+ * Notify about a changed key, either directly or conflated.
+ *
+ * With conflation enabled the key is added to @p pending and notified
+ * after the socket has been drained. Since key sets contain each key
+ * name only once, duplicates from a backlog collapse into a single
+ * notification.
+ *
+ * @param data    plugin data
+ * @param pending pending keys for conflation (NULL if conflation is disabled)
+ * @param name    name of the changed key
+ */
+static void notifyChangedKey (ElektraZeroMqRecvPluginData * data, KeySet * pending, const char * name)
+{
+	Key * changedKey = keyNew (name, KEY_END);
+	if (pending != NULL)
+	{
+		ksAppendKey (pending, changedKey);
+	}
+	else
+	{
+		data->notificationCallback (changedKey, data->notificationContext);
+	}
+}
+
 /**
  * @internal
  * Called whenever the socket becomes readable.
  * ZeroMq since sends multipart messages atomically (all or nothing)
- * both message parts are instantly available.
+ * all message parts are instantly available.
+ *
+ * All queued messages are drained, so that a backlog from a large
+ * commit or a slow consumer is processed at once instead of one
+ * message per event loop iteration.
  *
  * @param socket  ZeroMq socket
  * @param context context passed to elektraIoAdapterZeroMqAttach()
@@ -67,50 +121,73 @@ static void zeroMqRecvSocketReadable (void * socket, void * context)
 		}
 	}
 
-	char * changeType;
-	char * changedKeyName;
+	KeySet * pending = data->conflate ? ksNew (0, KS_END) : NULL;
 
 	zmq_msg_t message;
 	zmq_msg_init (&message);
 
-	int result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
-	if (result == -1)
+	for (;;)
 	{
-		ELEKTRA_LOG_WARNING ("receiving change type failed: %s; aborting", zmq_strerror (zmq_errno ()));
-		zmq_msg_close (&message);
-		return;
-	}
-	if (!zmq_msg_more (&message))
-	{
-		ELEKTRA_LOG_WARNING ("message has only one part; aborting");
-		zmq_msg_close (&message);
-		return;
-	}
-	int length = zmq_msg_size (&message);
-	changeType = elektraMemDup (zmq_msg_data (&message), length + 1);
-	changeType[length] = '\0';
-	ELEKTRA_LOG_DEBUG ("received change type %s", changeType);
+		char * changeType = receiveMessagePart (socket, &message);
+		if (changeType == NULL)
+		{
+			// no more messages available
+			break;
+		}
+		if (!zmq_msg_more (&message))
+		{
+			ELEKTRA_LOG_WARNING ("message has only one part; aborting");
+			elektraFree (changeType);
+			break;
+		}
+		ELEKTRA_LOG_DEBUG ("received change type %s", changeType);
+
+		char * changedKeyName = receiveMessagePart (socket, &message);
+		if (changedKeyName == NULL)
+		{
+			ELEKTRA_LOG_WARNING ("receiving key name failed: %s; aborting", zmq_strerror (zmq_errno ()));
+			elektraFree (changeType);
+			break;
+		}
+		ELEKTRA_LOG_DEBUG ("received key name %s", changedKeyName);
+
+		// additional message parts contain the keys changed by the commit
+		int hasChangedKeys = 0;
+		while (zmq_msg_more (&message))
+		{
+			char * name = receiveMessagePart (socket, &message);
+			if (name == NULL)
+			{
+				break;
+			}
+			hasChangedKeys = 1;
+			notifyChangedKey (data, pending, name);
+			elektraFree (name);
+		}
+
+		if (!hasChangedKeys)
+		{
+			// batched messages notify per changed key, plain messages
+			// notify with the committed (parent) key
+			notifyChangedKey (data, pending, changedKeyName);
+		}
 
-	result = zmq_msg_recv (&message, socket, ZMQ_DONTWAIT);
-	if (result == -1)
-	{
-		ELEKTRA_LOG_WARNING ("receiving key name failed: %s; aborting", zmq_strerror (zmq_errno ()));
 		elektraFree (changeType);
-		zmq_msg_close (&message);
-		return;
+		elektraFree (changedKeyName);
 	}
-	length = zmq_msg_size (&message);
-	changedKeyName = elektraMemDup (zmq_msg_data (&message), length + 1);
-	changedKeyName[length] = '\0';
-	ELEKTRA_LOG_DEBUG ("received key name %s", changedKeyName);
-
-	// notify about changes
-	Key * changedKey = keyNew (changedKeyName, KEY_END);
-	data->notificationCallback (changedKey, data->notificationContext);
 
 	zmq_msg_close (&message);
-	elektraFree (changeType);
-	elektraFree (changedKeyName);
+
+	if (pending != NULL)
+	{
+		// the callback takes ownership of the key, so keys are popped
+		Key * changedKey;
+		while ((changedKey = ksPop (pending)) != NULL)
+		{
+			data->notificationCallback (changedKey, data->notificationContext);
+		}
+		ksDel (pending);
+	}
 }
 
 /**
@@ -147,11 +224,19 @@ void elektraZeroMqRecvSetup (Plugin * handle)
 		}
 
 		// subscribe to notifications
-		char * keyCommitType = "Commit";
-		if (zmq_setsockopt (data->zmqSubscriber, ZMQ_SUBSCRIBE, keyCommitType, elektraStrLen (keyCommitType)) != 0)
+		// the topic is "<changeType>\0<parent key name>", so appending a
+		// key prefix makes the hub drop commits outside of that subtree
+		const char * keyCommitType = "Commit";
+		size_t commitTypeSize = elektraStrLen (keyCommitType);
+		size_t prefixLength = strlen (data->subscribePrefix);
+		char * subscription = elektraMalloc (commitTypeSize + prefixLength);
+		memcpy (subscription, keyCommitType, commitTypeSize);
+		memcpy (subscription + commitTypeSize, data->subscribePrefix, prefixLength);
+		if (zmq_setsockopt (data->zmqSubscriber, ZMQ_SUBSCRIBE, subscription, commitTypeSize + prefixLength) != 0)
 		{
 			ELEKTRA_LOG_WARNING ("failed to subscribe to %s messages", keyCommitType);
 		}
+		elektraFree (subscription);
 
 		// connect to endpoint
 		int result = zmq_connect (data->zmqSubscriber, data->endpoint);
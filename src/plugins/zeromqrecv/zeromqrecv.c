@@ -31,6 +31,14 @@ int elektraZeroMqRecvOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 		endpoint = ELEKTRA_ZEROMQ_DEFAULT_SUB_ENDPOINT;
 	}
 
+	// conflation is enabled by default; set "conflate=0" to disable
+	Key * conflateKey = ksLookupByName (elektraPluginGetConfig (handle), "/conflate", 0);
+	int conflate = conflateKey == NULL || strcmp (keyString (conflateKey), "0") != 0;
+
+	// optional key prefix, only commits below this prefix are received
+	Key * subscribeKey = ksLookupByName (elektraPluginGetConfig (handle), "/subscribe", 0);
+	const char * subscribePrefix = subscribeKey == NULL ? "" : keyString (subscribeKey);
+
 	ElektraZeroMqRecvPluginData * data = elektraPluginGetData (handle);
 	if (data == NULL)
 	{
@@ -40,6 +48,8 @@ int elektraZeroMqRecvOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 		data->zmqSubscriber = NULL;
 		data->zmqAdapter = NULL;
 		data->endpoint = endpoint;
+		data->subscribePrefix = subscribePrefix;
+		data->conflate = conflate;
 		data->notificationCallback = NULL;
 		data->notificationContext = NULL;
 		elektraPluginSetData (handle, data);
@@ -41,6 +41,12 @@ typedef struct
 	// endpoint for subscribe socket
 	const char * endpoint;
 
+	// key prefix for subscription filtering (empty = all keys)
+	const char * subscribePrefix;
+
+	// conflate pending notifications (keep only one per key name)
+	int conflate;
+
 	// ZeroMQ I/O adapter handle (NULL without I/O binding)
 	ElektraIoAdapterZeroMqHandle * zmqAdapter;
 
@@ -11,6 +11,7 @@
 #include <kdbhelper.h>
 #include <kdblogger.h>
 
+#include <string.h> // memcpy()
 #include <time.h>   // clock_gettime()
 #include <unistd.h> // usleep()
 
@@ -315,15 +316,16 @@ int elektraZeroMqSendConnect (ElektraZeroMqSendPluginData * data)
 /**
  * Publish notification on ZeroMq connection.
  *
- * @param changeType type of change
- * @param keyName    name of changed key
- * @param data       plugin data
+ * @param changeType  type of change
+ * @param keyName     name of changed key
+ * @param changedKeys keys changed by the commit (optional)
+ * @param data        plugin data
  * @retval 1 on success
  * @retval -1 on connection timeout
  * @retval -2 on subscription timeout
  * @retval 0 on other errors
  */
-int elektraZeroMqSendPublish (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data)
+int elektraZeroMqSendPublish (const char * changeType, const char * keyName, KeySet * changedKeys, ElektraZeroMqSendPluginData * data)
 {
 	if (!elektraZeroMqSendConnect (data))
 	{
@@ -360,7 +362,7 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
 	}
 
 	// send notification
-	if (!elektraZeroMqSendNotification (data->zmqPublisher, changeType, keyName))
+	if (!elektraZeroMqSendNotification (data->zmqPublisher, changeType, keyName, changedKeys))
 	{
 		ELEKTRA_LOG_WARNING ("could not send notification");
 		return 0;
@@ -369,6 +371,34 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
 	return 1;
 }
 
+/**
+ * @internal
+ * Send the names of changed keys as additional message parts.
+ *
+ * @param  socket      ZeroMq socket
+ * @param  changedKeys keys changed by the commit
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+static int sendChangedKeyParts (void * socket, KeySet * changedKeys)
+{
+	ssize_t remaining = ksGetSize (changedKeys);
+	ksRewind (changedKeys);
+	Key * k = 0;
+	while ((k = ksNext (changedKeys)) != 0)
+	{
+		--remaining;
+		const char * name = keyName (k);
+		unsigned int size = zmq_send (socket, name, elektraStrLen (name), remaining > 0 ? ZMQ_SNDMORE : 0);
+		if (size != elektraStrLen (name))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 /**
  * @internal
  * Send notification over ZeroMq socket.
@@ -376,28 +406,56 @@ int elektraZeroMqSendPublish (const char * changeType, const char * keyName, Ele
  * zmq_send() asynchronous.
  * Processing already handled in a thread created by ZeroMq.
  *
- * @param  socket     ZeroMq socket
- * @param  changeType type of change
- * @param  keyName    name of changed key
+ * All message parts are sent and delivered atomically as one multipart
+ * message: subscribers receive one message per commit, independent of
+ * the number of changed keys.
+ *
+ * @param  socket      ZeroMq socket
+ * @param  changeType  type of change
+ * @param  keyName     name of changed key
+ * @param  changedKeys keys changed by the commit; their names are appended
+ *                     as additional message parts (optional, may be NULL)
  * @retval 1 on success
  * @retval 0 on error
  */
-int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName)
+int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName, KeySet * changedKeys)
 {
 	unsigned int size;
+	ssize_t remaining = changedKeys == NULL ? 0 : ksGetSize (changedKeys);
+
+	// The first part doubles as the subscription topic. The key name is
+	// appended after the terminating '\0' of the change type, so
+	// subscribers can filter on "<changeType>\0<key prefix>" while
+	// subscriptions to the plain change type still match.
+	size_t changeTypeSize = elektraStrLen (changeType);
+	size_t keyNameSize = elektraStrLen (keyName);
+	char * topic = elektraMalloc (changeTypeSize + keyNameSize);
+	if (topic == NULL)
+	{
+		return 0;
+	}
+	memcpy (topic, changeType, changeTypeSize);
+	memcpy (topic + changeTypeSize, keyName, keyNameSize);
 
-	// Send change type
-	size = zmq_send (socket, changeType, elektraStrLen (changeType), ZMQ_SNDMORE);
-	if (size != elektraStrLen (changeType))
+	// Send change type with key name as topic
+	size = zmq_send (socket, topic, changeTypeSize + keyNameSize, ZMQ_SNDMORE);
+	elektraFree (topic);
+	if (size != changeTypeSize + keyNameSize)
 	{
 		return 0;
 	}
 
-	size = zmq_send (socket, keyName, elektraStrLen (keyName), 0);
+	size = zmq_send (socket, keyName, elektraStrLen (keyName), remaining > 0 ? ZMQ_SNDMORE : 0);
 	if (size != elektraStrLen (keyName))
 	{
 		return 0;
 	}
 
+	// Send one additional part per changed key
+	if (changedKeys != NULL && !sendChangedKeyParts (socket, changedKeys))
+	{
+		return 0;
+	}
+
 	return 1;
 }
@@ -72,6 +72,7 @@ int elektraZeroMqSendOpen (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
 		data->connectTimeout = connectTimeout;
 		data->subscribeTimeout = subscribeTimeout;
 		data->hasSubscriber = 0;
+		data->keys = NULL;
 	}
 	elektraPluginSetData (handle, data);
 
@@ -97,15 +98,59 @@ int elektraZeroMqSendGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		return 1; /* success */
 	}
 
+	// remember all keys for detecting changes in elektraZeroMqSendSet()
+	ElektraZeroMqSendPluginData * pluginData = elektraPluginGetData (handle);
+	ELEKTRA_NOT_NULL (pluginData);
+	if (pluginData->keys) ksDel (pluginData->keys);
+	pluginData->keys = ksDup (returned);
+
 	return 1; /* success */
 }
 
-int elektraZeroMqSendSet (Plugin * handle, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+int elektraZeroMqSendSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	ElektraZeroMqSendPluginData * pluginData = elektraPluginGetData (handle);
 	ELEKTRA_NOT_NULL (pluginData);
 
-	int result = elektraZeroMqSendPublish ("Commit", keyName (parentKey), pluginData);
+	// collect added, changed and removed keys, so that the notification
+	// for a commit stays a single (multipart) message independent of the
+	// number of keys it touched
+	KeySet * changedKeys = ksNew (0, KS_END);
+	KeySet * oldKeys = pluginData->keys;
+	if (oldKeys != NULL)
+	{
+		KeySet * addedKeys = ksDup (returned);
+		ksRewind (oldKeys);
+		Key * k = 0;
+		while ((k = ksNext (oldKeys)) != 0)
+		{
+			Key * p = ksLookup (addedKeys, k, KDB_O_POP);
+			// Note: keyDel not needed, because at least two references exist
+			if (p)
+			{
+				if (keyNeedSync (p))
+				{
+					ksAppendKey (changedKeys, p);
+				}
+			}
+			else
+			{
+				// key was removed
+				ksAppendKey (changedKeys, k);
+			}
+		}
+		// all keys remaining in addedKeys are new
+		ksAppend (changedKeys, addedKeys);
+		ksDel (addedKeys);
+	}
+
+	int result = elektraZeroMqSendPublish ("Commit", keyName (parentKey), changedKeys, pluginData);
+	ksDel (changedKeys);
+
+	// remember current keys for the next commit
+	if (oldKeys) ksDel (oldKeys);
+	pluginData->keys = ksDup (returned);
+
 	switch (result)
 	{
 	case 1:
@@ -146,6 +191,12 @@ int elektraZeroMqSendClose (Plugin * handle, Key * parentKey ELEKTRA_UNUSED)
 		pluginData->zmqContext = NULL;
 	}
 
+	if (pluginData->keys)
+	{
+		ksDel (pluginData->keys);
+		pluginData->keys = NULL;
+	}
+
 	elektraFree (pluginData);
 	elektraPluginSetData (handle, NULL);
 
@@ -45,11 +45,14 @@ typedef struct
 	long subscribeTimeout;
 
 	int hasSubscriber;
+
+	// remembered key set from elektraZeroMqSendGet() for detecting changed keys
+	KeySet * keys;
 } ElektraZeroMqSendPluginData;
 
 int elektraZeroMqSendConnect (ElektraZeroMqSendPluginData * data);
-int elektraZeroMqSendPublish (const char * changeType, const char * keyName, ElektraZeroMqSendPluginData * data);
-int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName);
+int elektraZeroMqSendPublish (const char * changeType, const char * keyName, KeySet * changedKeys, ElektraZeroMqSendPluginData * data);
+int elektraZeroMqSendNotification (void * socket, const char * changeType, const char * keyName, KeySet * changedKeys);
 
 int elektraZeroMqSendOpen (Plugin * handle, Key * errorKey);
 int elektraZeroMqSendClose (Plugin * handle, Key * errorKey);
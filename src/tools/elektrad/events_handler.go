@@ -0,0 +1,166 @@
+package main
+
+import (
+	"encoding/json"
+	"fmt"
+	"net/http"
+	"strings"
+	"sync"
+
+	elektra "go.libelektra.org/kdb"
+)
+
+// delta describes a single change that was made through this server.
+// It is the record pushed to event stream subscribers.
+type delta struct {
+	// Type is one of "set", "delete", "meta", "metadelete" or "move".
+	Type string `json:"type"`
+	// Key is the canonical name of the changed key.
+	Key string `json:"key"`
+	// Value is the new value for "set" deltas.
+	Value string `json:"value,omitempty"`
+	// Meta is the name of the metakey for "meta" and "metadelete" deltas.
+	Meta string `json:"meta,omitempty"`
+	// To is the target key name for "move" deltas.
+	To string `json:"to,omitempty"`
+}
+
+type subscriber struct {
+	prefix string
+	ch     chan delta
+}
+
+// eventHub fans out deltas to the subscribed event streams.
+// It is idle (and free) while nobody is subscribed and nothing changes.
+type eventHub struct {
+	mut  sync.Mutex
+	subs map[*subscriber]struct{}
+}
+
+func newEventHub() *eventHub {
+	return &eventHub{subs: make(map[*subscriber]struct{})}
+}
+
+func (h *eventHub) subscribe(prefix string) *subscriber {
+	s := &subscriber{
+		prefix: prefix,
+		ch:     make(chan delta, 64),
+	}
+
+	h.mut.Lock()
+	h.subs[s] = struct{}{}
+	h.mut.Unlock()
+
+	return s
+}
+
+func (h *eventHub) unsubscribe(s *subscriber) {
+	h.mut.Lock()
+	delete(h.subs, s)
+	h.mut.Unlock()
+}
+
+// publish pushes a delta to every subscriber whose subtree contains the
+// changed key. Subscribers that do not drain their channel fast enough
+// lose deltas instead of blocking the writing request.
+func (h *eventHub) publish(d delta) {
+	h.mut.Lock()
+	defer h.mut.Unlock()
+
+	for s := range h.subs {
+		if !keyIsBelowOrSame(s.prefix, d.Key) && (d.To == "" || !keyIsBelowOrSame(s.prefix, d.To)) {
+			continue
+		}
+
+		select {
+		case s.ch <- d:
+		default:
+		}
+	}
+}
+
+// keyIsBelowOrSame reports whether name is the same key as prefix or
+// below it. Both names must be canonical, i.e. as returned by Key.Name().
+// A cascading prefix (leading slash) matches the path in every namespace.
+func keyIsBelowOrSame(prefix, name string) bool {
+	if strings.HasPrefix(prefix, "/") {
+		if colon := strings.Index(name, ":"); colon >= 0 {
+			name = name[colon+1:]
+		}
+	}
+
+	if name == prefix {
+		return true
+	}
+
+	if strings.HasSuffix(prefix, "/") {
+		// a namespace root like "user:/" or the cascading root "/"
+		return strings.HasPrefix(name, prefix)
+	}
+
+	return strings.HasPrefix(name, prefix+"/")
+}
+
+// canonicalKeyName returns the canonical form of a key name,
+// so it can be compared against names returned by Key.Name().
+func canonicalKeyName(name string) (string, error) {
+	key, err := elektra.NewKey(name)
+
+	if err != nil {
+		return "", err
+	}
+
+	defer key.Close()
+
+	return key.Name(), nil
+}
+
+// getEventsHandler streams every change made through this server below
+// a key as server-sent events, one `delta` JSON record per event. The
+// stream stays open until the client disconnects and pushes nothing
+// while the subtree is unchanged, so clients should prefer it over
+// polling with repeated GET requests.
+//
+// Arguments:
+//		keyName		the root of the subtree to watch, URL path param.
+//					Defaults to "/", i.e. everything.
+//
+// Response Code:
+//		200 OK with Content-Type text/event-stream.
+// 		400 Bad Request if the key name is invalid.
+//
+// Example: `curl -N localhost:33333/kdbEvents/user:/test`
+func (s *server) getEventsHandler(w http.ResponseWriter, r *http.Request) {
+	flusher, ok := w.(http.Flusher)
+
+	if !ok {
+		internalServerError(w)
+		return
+	}
+
+	prefix, err := canonicalKeyName(parseKeyNameFromURL(r))
+
+	if err != nil {
+		badRequest(w)
+		return
+	}
+
+	sub := s.events.subscribe(prefix)
+	defer s.events.unsubscribe(sub)
+
+	w.Header().Set("Content-Type", "text/event-stream")
+	w.Header().Set("Cache-Control", "no-cache")
+	w.WriteHeader(http.StatusOK)
+	flusher.Flush()
+
+	for {
+		select {
+		case <-r.Context().Done():
+			return
+		case d := <-sub.ch:
+			js, _ := json.Marshal(d)
+			fmt.Fprintf(w, "data: %s\n\n", js)
+			flusher.Flush()
+		}
+	}
+}
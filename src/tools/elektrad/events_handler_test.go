@@ -0,0 +1,74 @@
+package main
+
+import (
+	"testing"
+)
+
+func TestKeyIsBelowOrSame(t *testing.T) {
+	tests := []struct {
+		prefix string
+		name   string
+		want   bool
+	}{
+		{"user:/test", "user:/test", true},
+		{"user:/test", "user:/test/hello", true},
+		{"user:/test", "user:/test/hello/deep", true},
+		{"user:/test", "user:/testing", false},
+		{"user:/test", "user:/other", false},
+		{"user:/test", "system:/test/hello", false},
+		{"user:/", "user:/test/hello", true},
+		{"user:/", "system:/test", false},
+		{"/", "user:/test/hello", true},
+		{"/", "system:/test", true},
+		{"/test", "user:/test/hello", true},
+		{"/test", "system:/test", true},
+		{"/test", "user:/other", false},
+	}
+
+	for _, tt := range tests {
+		got := keyIsBelowOrSame(tt.prefix, tt.name)
+		Assertf(t, got == tt.want, "keyIsBelowOrSame(%q, %q) == %v, want %v", tt.prefix, tt.name, got, tt.want)
+	}
+}
+
+func TestEventHubFiltersBySubtree(t *testing.T) {
+	hub := newEventHub()
+
+	matching := hub.subscribe("user:/tests/elektrad/events")
+	defer hub.unsubscribe(matching)
+
+	other := hub.subscribe("user:/tests/elektrad/other")
+	defer hub.unsubscribe(other)
+
+	hub.publish(delta{Type: "set", Key: "user:/tests/elektrad/events/hello", Value: "world"})
+
+	select {
+	case d := <-matching.ch:
+		Assertf(t, d.Key == "user:/tests/elektrad/events/hello", "wrong key in delta: %v", d.Key)
+		Assertf(t, d.Value == "world", "wrong value in delta: %v", d.Value)
+	default:
+		t.Fatal("subscriber did not receive the delta")
+	}
+
+	select {
+	case d := <-other.ch:
+		t.Fatalf("subscriber of unrelated subtree received a delta: %v", d)
+	default:
+	}
+}
+
+func TestEventHubMatchesMoveTarget(t *testing.T) {
+	hub := newEventHub()
+
+	sub := hub.subscribe("user:/tests/elektrad/events/to")
+	defer hub.unsubscribe(sub)
+
+	hub.publish(delta{Type: "move", Key: "user:/tests/elektrad/events/from", To: "user:/tests/elektrad/events/to"})
+
+	select {
+	case d := <-sub.ch:
+		Assertf(t, d.To == "user:/tests/elektrad/events/to", "wrong move target in delta: %v", d.To)
+	default:
+		t.Fatal("subscriber did not receive the move delta")
+	}
+}
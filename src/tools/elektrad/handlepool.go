@@ -1,6 +1,8 @@
 package main
 
 import (
+	"log"
+
 	elektra "go.libelektra.org/kdb"
 )
 
@@ -71,11 +73,14 @@ func (p *handlePool) pop() *handle {
 
 func (p *handlePool) refillLoop() {
 	for range p.doRefill {
-		for l := len(p.handles); l < p.size; {
+		for len(p.handles) < p.size {
 			h, err := newHandle()
 
 			if err != nil {
-				panic("could not create new handle: " + err.Error())
+				// a transient error must not kill the server,
+				// the next Get() triggers another refill attempt
+				log.Printf("could not create new handle: %v", err)
+				break
 			}
 
 			p.handles <- h
@@ -88,3 +93,15 @@ func (p *handlePool) Get() *handle {
 
 	return p.pop()
 }
+
+// Put returns a borrowed handle to the pool so it can be reused
+// by the next request. If the pool is already full the handle is
+// closed instead.
+func (p *handlePool) Put(h *handle) {
+	select {
+	case p.handles <- h:
+	default:
+		h.kdb.Close()
+		h.keySet.Close()
+	}
+}
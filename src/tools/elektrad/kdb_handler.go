@@ -152,6 +152,8 @@ func (s *server) putKdbHandler(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
+	s.events.publish(delta{Type: "set", Key: key.Name(), Value: value})
+
 	if existingKey == nil {
 		created(w)
 	}
@@ -212,6 +214,8 @@ func (s *server) deleteKdbHandler(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
+	s.events.publish(delta{Type: "delete", Key: key.Name()})
+
 	noContent(w)
 }
 
@@ -20,7 +20,7 @@ func main() {
 		log.Fatal(err)
 	}
 
-	app := &server{pool: initPool(*initHandles)}
+	app := &server{pool: initPool(*initHandles), events: newEventHub()}
 
 	r := setupRouter(app)
 
@@ -30,7 +30,8 @@ func main() {
 }
 
 type server struct {
-	pool *handlePool
+	pool   *handlePool
+	events *eventHub
 }
 
 type elektraVersion struct {
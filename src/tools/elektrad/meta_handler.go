@@ -93,6 +93,12 @@ func (s *server) postMetaHandler(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
+	if meta.Value == nil {
+		s.events.publish(delta{Type: "metadelete", Key: k.Name(), Meta: meta.Key})
+	} else {
+		s.events.publish(delta{Type: "meta", Key: k.Name(), Meta: meta.Key, Value: *meta.Value})
+	}
+
 	noContent(w)
 }
 
@@ -167,5 +173,7 @@ func (s *server) deleteMetaHandler(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
+	s.events.publish(delta{Type: "metadelete", Key: k.Name(), Meta: meta.Key})
+
 	noContent(w)
 }
@@ -1,6 +1,7 @@
 package main
 
 import (
+	"context"
 	"log"
 	"net/http"
 	"sync"
@@ -16,13 +17,23 @@ var (
 	maxAge   = 60 * 60 // 1 hour
 )
 
+type contextKey int
+
+const handleContextKey contextKey = 0
+
 type session struct {
 	handle *handle
-	mut    sync.Mutex
+	mut    sync.RWMutex
 
 	expiry time.Time
 }
 
+// isReadRequest reports whether the request only reads from the KDB
+// and can therefore share the session with other read requests.
+func isReadRequest(r *http.Request) bool {
+	return r.Method == http.MethodGet || r.Method == http.MethodHead
+}
+
 func handleMiddleware(pool *handlePool) mux.MiddlewareFunc {
 	go freeHandles()
 
@@ -48,9 +59,22 @@ func handleMiddleware(pool *handlePool) mux.MiddlewareFunc {
 				}
 			}
 
-			// prevent the handle from being used in parallel
-			s.mut.Lock()
-			defer s.mut.Unlock()
+			if isReadRequest(r) {
+				// read requests may run concurrently, each on its
+				// own handle borrowed from the pool, as long as no
+				// write request holds the session exclusively
+				s.mut.RLock()
+				defer s.mut.RUnlock()
+
+				h := pool.Get()
+				defer pool.Put(h)
+
+				r = r.WithContext(context.WithValue(r.Context(), handleContextKey, h))
+			} else {
+				// write requests get the session handle exclusively
+				s.mut.Lock()
+				defer s.mut.Unlock()
+			}
 
 			next.ServeHTTP(w, r)
 		})
@@ -121,6 +145,10 @@ func cookieFromUUID(uuid string) *http.Cookie {
 }
 
 func getHandle(r *http.Request) (elektra.KDB, elektra.KeySet) {
+	if h, ok := r.Context().Value(handleContextKey).(*handle); ok {
+		return h.kdb, h.keySet
+	}
+
 	cookie, err := r.Cookie("session")
 
 	if err != nil {
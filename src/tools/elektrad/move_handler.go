@@ -88,6 +88,8 @@ func (s *server) postMoveHandler(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
+	s.events.publish(delta{Type: "move", Key: fromKey.Name(), To: toKey.Name()})
+
 	noContent(w)
 }
 
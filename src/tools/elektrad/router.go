@@ -10,26 +10,33 @@ import (
 func setupRouter(app *server) http.Handler {
 	r := mux.NewRouter()
 
-	r.Use(handleMiddleware(app.pool))
+	// the event stream stays open indefinitely and must not pin a
+	// session or a pooled handle, so it bypasses the handle middleware
+	r.HandleFunc("/kdbEvents", app.getEventsHandler).Methods("GET")
+	r.HandleFunc("/kdbEvents/{path:.*}", app.getEventsHandler).Methods("GET")
 
-	r.HandleFunc("/", app.getDocHandler).Methods("GET")
+	api := r.PathPrefix("/").Subrouter()
 
-	r.HandleFunc("/version", app.getVersionHandler).Methods("GET")
+	api.Use(handleMiddleware(app.pool))
 
-	r.HandleFunc("/kdb", app.getKdbHandler).Methods("GET")
-	r.HandleFunc("/kdb/{path:.*}", app.getKdbHandler).Methods("GET")
-	r.HandleFunc("/kdb/{path:.*}", app.putKdbHandler).Methods("PUT")
-	r.HandleFunc("/kdb/{path:.*}", app.deleteKdbHandler).Methods("DELETE")
+	api.HandleFunc("/", app.getDocHandler).Methods("GET")
 
-	r.HandleFunc("/kdbFind/{path:.*}", app.getFindHandler).Methods("GET")
+	api.HandleFunc("/version", app.getVersionHandler).Methods("GET")
 
-	r.HandleFunc("/kdbMv/{path:.*}", app.postMoveHandler).Methods("POST")
+	api.HandleFunc("/kdb", app.getKdbHandler).Methods("GET")
+	api.HandleFunc("/kdb/{path:.*}", app.getKdbHandler).Methods("GET")
+	api.HandleFunc("/kdb/{path:.*}", app.putKdbHandler).Methods("PUT")
+	api.HandleFunc("/kdb/{path:.*}", app.deleteKdbHandler).Methods("DELETE")
+
+	api.HandleFunc("/kdbFind/{path:.*}", app.getFindHandler).Methods("GET")
+
+	api.HandleFunc("/kdbMv/{path:.*}", app.postMoveHandler).Methods("POST")
 
 	// TODO
-	// r.HandleFunc("/kdbCp/{path:.*", app.postCopyHandler).Methods("POST")
+	// api.HandleFunc("/kdbCp/{path:.*", app.postCopyHandler).Methods("POST")
 
-	r.HandleFunc("/kdbMeta/{path:.*}", app.postMetaHandler).Methods("POST")
-	r.HandleFunc("/kdbMeta/{path:.*}", app.deleteMetaHandler).Methods("DELETE")
+	api.HandleFunc("/kdbMeta/{path:.*}", app.postMetaHandler).Methods("POST")
+	api.HandleFunc("/kdbMeta/{path:.*}", app.deleteMetaHandler).Methods("DELETE")
 
 	return r
 }
@@ -100,45 +100,83 @@ def _stat_kdb_file(os_path):
     resolved_file_path = get_kdb_file(os_path)
     return os.stat(resolved_file_path)
 
+#builds the stat attributes of a directory entry from the keyset snapshot alone.
+#the backing file is deliberately not resolved here ("kdb file" spawns a subprocess per call),
+#default permission bits are served instead.
+def _snapshot_attrs(entry_path, is_dir):
+    common = dict(
+        st_ctime = startup_time,
+        st_mtime = startup_time,
+        st_atime = startup_time
+    )
+
+    if is_dir:
+        return dict(st_mode = (stat.S_IFDIR | 0o755), st_nlink = 2, **common)
+
+    try:
+        size = size_of_file(entry_path)
+    except KeyError:
+        size = 0
+
+    permission_bits = 0o644 if _namespace_is_writable(entry_path) else 0o444
+    return dict(st_mode = (stat.S_IFREG | permission_bits), st_nlink = 1, st_size = size, **common)
+
 #returns a list of files of a directory.
 #On the root level, Elektras namespaces are listed,
 #on deeper levels, the key hierarchy is mirroed.
 #".", ".." are always included.
+#Entries are returned together with their attributes (readdirplus), all served from
+#one keyset snapshot, so listing a directory does not trigger a getattr per entry.
 def readdir(path, fh):
     if path == "/":
         return [".", "..", *elektra_namespaces]
 
     dir_set, file_set = ls(path)
 
-    return ['.', '..', *dir_set, *file_set]
+    entries = ['.', '..']
+    for name in sorted(dir_set):
+        entries.append((name, _snapshot_attrs(str(Path(path) / name), True), 0))
+    for name in sorted(file_set):
+        entries.append((name, _snapshot_attrs(str(Path(path) / name), False), 0))
+
+    return entries
 
 #returns a chunk of a file, i.e a part of an Elektra key value
 def read(path, size, offset, fh):
     return file_contents(path)[offset:offset+size]
 
-#updates a chunk of a file, i.e a part of an Elektra key value
+#buffers a chunk of a file, i.e a part of an Elektra key value.
+#bursts of writes are coalesced and written back with a single kdb.set in flush()/release()
 def write(path, data, offset, fh):
     _ensure_namespace_is_writable(path)
 
     try:
-        old_value = file_contents(path)
-        new_value = old_value[:offset] + data + old_value[offset + len(data):]
-
-        update_key_value(path, new_value)
-
-        return len(data)
+        return buffer_write(path, data, offset)
     except KeyError:
         raise OSError(errno.ENOENT)
-    except kdb.KDBException:
-        raise OSError(errno.EROFS) #TODO differentiate between validation error, write only keys etc
 
 #truncates a file (discards all but a prefix of specified length) of a part of an Elektra key value
 def truncate(path, length, fh=None):
     _ensure_namespace_is_writable(path)
 
-    old_value = file_contents(path)
-    new_value = old_value[:length].ljust(length, '\x00'.encode()) #if length increased, fill new space with zeros
-    update_key_value(path, new_value)
+    try:
+        buffer_truncate(path, length)
+    except KeyError:
+        raise OSError(errno.ENOENT)
+
+#writes all buffered chunks of the given path back with a single kdb.set
+def flush(path, fh):
+    try:
+        flush_pending(path)
+    except KeyError:
+        raise OSError(errno.ENOENT)
+    except kdb.KDBException:
+        raise OSError(errno.EROFS) #TODO differentiate between validation error, write only keys etc
+
+#last chance to write back buffered chunks (flush is not guaranteed to be called)
+def release(path, fh):
+    flush(path, fh)
+    return 0
 
 #creates a file, i.e. a new Elektra key
 def create(path, mode):
@@ -230,6 +268,7 @@ def unlink(path):
     #delete_key(path) keyset.cut behaved unexpected and deleted child keys => using kdb directly
 
     returncode = subprocess.run(["kdb", "rm", os_path_to_elektra_path(path)]).returncode
+    invalidate_cache()
     if returncode != 0:
         raise OSError(errno.EROFS) #TODO: differentiate between different error
 
@@ -253,6 +292,7 @@ def rename(old_path, new_path):
     else:
         #clumsy to implement using the python api => using kdb directly
         returncode = subprocess.run(["kdb", "mv", "-r", os_path_to_elektra_path(old_path), os_path_to_elektra_path(new_path)]).returncode
+    invalidate_cache()
     if returncode != 0:
         raise OSError(errno.EROFS) #TODO: differentiate between different errors
 
@@ -1,5 +1,5 @@
 from pathlib import Path
-import os, re, errno, sys, subprocess
+import os, re, errno, sys, subprocess, time
 import kdb
 
 elektra_namespaces = ["user:", "system:", "dir:", "spec:", "cascading:", "proc:"]
@@ -7,6 +7,46 @@ elektra_namespaces = ["user:", "system:", "dir:", "spec:", "cascading:", "proc:"
 parent_key = None # not yet set
 dir_file_special_name = "®elektra.value"
 xattr_kdb_file = "®elektra.file"
+
+#snapshot cache: one kdb.get per namespace serves all lookups (getattr, readdir, read, xattr)
+#until either a write bumps the generation or the snapshot expires.
+#external modifications of the kdb are only picked up after the ttl, which is the usual
+#trade-off of attribute caching filesystems (cf. the nfs actimeo option).
+cache_ttl_seconds = 2.0
+_cache_generation = 0
+_snapshots = dict() # namespace root -> (generation, fetch time, keyset)
+
+#write buffers: fuse issues writes in small chunks (often 4k), writing each chunk through
+#kdb.set made bursts (cp, editors) quadratic. chunks are coalesced here and written back
+#with a single kdb.set on flush/release.
+_pending_writes = dict() # os_path -> bytearray
+
+#discards all cached snapshots (to be called after every modification of the kdb)
+def invalidate_cache():
+    global _cache_generation
+    _cache_generation += 1
+    _snapshots.clear()
+
+#returns the root of the namespace the given elektra path belongs to (e.g. 'user:/dir/key' -> 'user:/', '/key' -> '/')
+def _namespace_root(elektra_path):
+    if elektra_path.startswith("/"):
+        return "/"
+    return elektra_path.split("/", 1)[0] + "/"
+
+#returns a (potentially cached) keyset snapshot covering the whole namespace of the given elektra path
+def _get_snapshot(elektra_path):
+    root = _namespace_root(elektra_path)
+    entry = _snapshots.get(root)
+    now = time.monotonic()
+    if entry is not None and entry[0] == _cache_generation and now - entry[1] < cache_ttl_seconds:
+        return entry[2]
+
+    with _get_kdb_instance() as db:
+        ks = kdb.KeySet()
+        db.get(ks, root)
+
+    _snapshots[root] = (_cache_generation, now, ks)
+    return ks
 #translates from filesystem (that are below the "pid"-level) paths to elektra paths (e.g. '/user:/dir/@elektra.value' -> 'user:/dir', '/cascading:/key' -> '/key', assuming parent_key == "/") 
 def os_path_to_elektra_path(os_path):
 
@@ -85,10 +125,44 @@ def update_key_value(os_path: str, new_value: bytes):
             raise OSError(errno.ENOTSUP) #general binary meta-keys are not supported
 
         db.set(ks, path) #using key instead of path here deleted the key
-
+    invalidate_cache()
+
+#buffers a chunk of a write burst. the buffer is seeded from the current key value,
+#subsequent chunks only touch memory. may throw KeyError.
+def buffer_write(os_path, data, offset):
+    buf = _pending_writes.get(os_path)
+    if buf is None:
+        buf = bytearray(file_contents(os_path))
+        _pending_writes[os_path] = buf
+    if len(buf) < offset:
+        buf.extend(b'\x00' * (offset - len(buf)))
+    buf[offset:offset + len(data)] = data
+    return len(data)
+
+#buffers a truncation like buffer_write. may throw KeyError.
+def buffer_truncate(os_path, length):
+    buf = _pending_writes.get(os_path)
+    if buf is None:
+        buf = bytearray(file_contents(os_path))
+        _pending_writes[os_path] = buf
+    del buf[length:]
+    buf.extend(b'\x00' * (length - len(buf))) #if length increased, fill new space with zeros
+
+#writes the coalesced buffer of the given path back with a single kdb.set.
+#does nothing if no writes are pending. kdb.kdb.KDBException may be thrown.
+def flush_pending(os_path):
+    buf = _pending_writes.pop(os_path, None)
+    if buf is None:
+        return
+    update_key_value(os_path, bytes(buf))
 
 #may throw KeyError
 def file_contents(os_path):
+    #serve pending writes so reads observe them before the flush
+    pending = _pending_writes.get(os_path)
+    if pending is not None:
+        return bytes(pending)
+
     key, _ = get_key_and_keyset(os_path)
 
     if key.isString():
@@ -108,6 +182,7 @@ def create_key(os_path):
             key = kdb.Key(path)
             ks.append(key)
         keys_modified = db.set(ks, path)
+        invalidate_cache()
         if keys_modified != 1:
             raise OSError(errno.EIO)
             #could also be an attempt to create an already existing key. in this rare case the error code does not fit.
@@ -149,16 +224,15 @@ def update_meta_map(os_path, new_meta_map):
             key.setMeta(keyname, new_meta_map[keyname])
 
         db.set(ks, path)
+    invalidate_cache()
 
 #may throw KeyError
 def get_key_and_keyset(os_path):
     path = os_path_to_elektra_path(os_path)
 
-    with _get_kdb_instance() as db:
-        ks = kdb.KeySet()
-        db.get(ks, path)
-        key = ks[path]
-        return (key, ks)
+    ks = _get_snapshot(path)
+    key = ks[path]
+    return (key, ks)
 
 #returns tuple inidicating if path is dir, is file
 def key_type(os_path):
@@ -193,26 +267,23 @@ def ls(os_path):
 
     is_root_level = len(path) > 1 and path.endswith("/") # special case
 
+    ks = _get_snapshot(path)
 
-    with _get_kdb_instance() as db:
-        ks = kdb.KeySet()
-        db.get(ks, root)
-
-        #only retain keys that are below the root (kdb.get does not gurantee this property)
-        ks_filtered = kdb.KeySet()
-        for key in ks:
-            if key.isBelowOrSame(root):
-                ks_filtered.append(key) 
+    #only retain keys that are below the root (the snapshot covers the whole namespace)
+    ks_filtered = kdb.KeySet()
+    for key in ks:
+        if key.isBelowOrSame(root):
+            ks_filtered.append(key)
 
-        path_without_namespace = _remove_namespace_prefix(path)
-        result_keys_without_namespace = map(_remove_namespace_prefix, ks_filtered.unpack_names())
-        below = {name.split(path_without_namespace)[1] for name in result_keys_without_namespace if is_path_prefix(path_without_namespace, name)}
+    path_without_namespace = _remove_namespace_prefix(path)
+    result_keys_without_namespace = map(_remove_namespace_prefix, ks_filtered.unpack_names())
+    below = {name.split(path_without_namespace)[1] for name in result_keys_without_namespace if is_path_prefix(path_without_namespace, name)}
 
-        dirs = {name.split("/")[0 if is_root_level else 1] for name in below if "/" in name}
-        files = {name for name in below if not "/" in name}.difference(dirs)
+    dirs = {name.split("/")[0 if is_root_level else 1] for name in below if "/" in name}
+    files = {name for name in below if not "/" in name}.difference(dirs)
 
-        if '' in files:
-            files.remove('')
-            files.add(dir_file_special_name)
+    if '' in files:
+        files.remove('')
+        files.add(dir_file_special_name)
 
-        return (dirs, files)
+    return (dirs, files)
@@ -76,6 +76,36 @@ def _mock_process_context_and_run(process_context, func, args, kwargs):
     except PermissionError:
         raise OSError(errno.EACCES)
 
+#one worker per inspected pid is kept alive and reused.
+#forking a fresh worker per fuse operation threw away the snapshot and write caches
+#of elektra_util with every call (and paid the fork + import cost each time).
+#a worker is only ever reused for the same pid, so the irreversibly dropped
+#user/group ids of the worker always match.
+_max_pools = 32
+_pools = dict() # pid -> multiprocessing pool with one worker
+
+def _retire_pool(pid):
+    pool = _pools.pop(pid, None)
+    if pool is not None:
+        pool.terminate()
+
+def _pool_for_pid(pid):
+    pool = _pools.get(pid)
+    if pool is None:
+        if len(_pools) >= _max_pools:
+            _retire_pool(next(iter(_pools)))
+        pool = multiprocessing.Pool(processes = 1)
+        _pools[pid] = pool
+    return pool
+
 def run_as(process_context, func, *args, **kwargs):
-    with multiprocessing.Pool(processes = 1) as pool:
+    pool = _pool_for_pid(process_context.pid)
+    try:
+        return pool.starmap(_mock_process_context_and_run, [ [process_context, func, args, kwargs] ])[0]
+    except OSError:
+        raise
+    except Exception:
+        #the worker died (e.g. the inspected process went away mid-call); retire it and retry once with a fresh one
+        _retire_pool(process_context.pid)
+        pool = _pool_for_pid(process_context.pid)
         return pool.starmap(_mock_process_context_and_run, [ [process_context, func, args, kwargs] ])[0]
@@ -173,6 +173,22 @@ class RootlevelResolver(LoggingMixIn, Operations):
         process_context, path_suffix = self.resolve_proc_path(path)
         return mock_context.run_as(process_context, elektra_fuse_interface.truncate, path_suffix, length, fh=fh)
 
+    @with_translated_exceptions
+    def flush(self, path, fh):
+        if RootlevelResolver.is_rootlevel_path(path):
+            return 0
+
+        process_context, path_suffix = self.resolve_proc_path(path)
+        return mock_context.run_as(process_context, elektra_fuse_interface.flush, path_suffix, fh)
+
+    @with_translated_exceptions
+    def release(self, path, fh):
+        if RootlevelResolver.is_rootlevel_path(path):
+            return 0
+
+        process_context, path_suffix = self.resolve_proc_path(path)
+        return mock_context.run_as(process_context, elektra_fuse_interface.release, path_suffix, fh)
+
     @with_translated_exceptions
     def create(self, path, mode):
         if RootlevelResolver.is_rootlevel_path(path):
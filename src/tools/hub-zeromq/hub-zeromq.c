@@ -10,15 +10,32 @@
  */
 #include <signal.h> // signal
 #include <stdio.h>  // printf
+#include <stdlib.h> // strtol
+#include <string.h> // memcmp
+#include <time.h>   // clock_gettime
 
-#include <kdb.h> // KDB
+#include <kdb.h>       // KDB
+#include <kdbhelper.h> // elektraMalloc
 
 #include <zmq.h> // ZeroMq function
 
+/** default time window for coalescing notification bursts (milliseconds) */
+#define DEFAULT_COALESCE_WINDOW_MS (100)
+
+/** maximum number of buffered notification messages */
+#define MAX_PENDING (256)
+
 void * context;
 void * xSubSocket;
 void * xPubSocket;
 
+typedef struct
+{
+	zmq_msg_t * frames;
+	size_t frameCount;
+	struct timespec deadline;
+} PendingMessage;
+
 static void onSignal (int signal)
 {
 	if (signal == SIGINT)
@@ -33,6 +50,241 @@ static void onSignal (int signal)
 	}
 }
 
+/**
+ * Receive all parts of a multipart message.
+ *
+ * @param  socket     socket to receive from
+ * @param  frames     receives an allocated array of message parts
+ * @param  frameCount receives the number of message parts
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+static int receiveMultipart (void * socket, zmq_msg_t ** frames, size_t * frameCount)
+{
+	zmq_msg_t * parts = NULL;
+	size_t count = 0;
+	size_t capacity = 0;
+	int more = 1;
+
+	while (more)
+	{
+		if (count == capacity)
+		{
+			capacity = capacity == 0 ? 4 : capacity * 2;
+			if (elektraRealloc ((void **) &parts, capacity * sizeof (zmq_msg_t)) < 0)
+			{
+				return 0;
+			}
+		}
+		zmq_msg_init (&parts[count]);
+		if (zmq_msg_recv (&parts[count], socket, 0) == -1)
+		{
+			zmq_msg_close (&parts[count]);
+			for (size_t i = 0; i < count; i++)
+			{
+				zmq_msg_close (&parts[i]);
+			}
+			elektraFree (parts);
+			return 0;
+		}
+		more = zmq_msg_more (&parts[count]);
+		count++;
+	}
+
+	*frames = parts;
+	*frameCount = count;
+	return 1;
+}
+
+/**
+ * Send all parts of a multipart message and free it.
+ *
+ * @param socket     socket to send to
+ * @param frames     message parts; closed and freed by this function
+ * @param frameCount number of message parts
+ */
+static void sendMultipart (void * socket, zmq_msg_t * frames, size_t frameCount)
+{
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		if (zmq_msg_send (&frames[i], socket, i + 1 < frameCount ? ZMQ_SNDMORE : 0) == -1)
+		{
+			zmq_msg_close (&frames[i]);
+		}
+	}
+	elektraFree (frames);
+}
+
+/**
+ * Close and free a multipart message without sending it.
+ *
+ * @param frames     message parts
+ * @param frameCount number of message parts
+ */
+static void discardMultipart (zmq_msg_t * frames, size_t frameCount)
+{
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		zmq_msg_close (&frames[i]);
+	}
+	elektraFree (frames);
+}
+
+/**
+ * Compare a buffered message with a newly received one.
+ *
+ * @retval 1 if all message parts are identical
+ * @retval 0 otherwise
+ */
+static int isSameMessage (PendingMessage * pending, zmq_msg_t * frames, size_t frameCount)
+{
+	if (pending->frameCount != frameCount)
+	{
+		return 0;
+	}
+	for (size_t i = 0; i < frameCount; i++)
+	{
+		size_t size = zmq_msg_size (&frames[i]);
+		if (zmq_msg_size (&pending->frames[i]) != size ||
+		    memcmp (zmq_msg_data (&pending->frames[i]), zmq_msg_data (&frames[i]), size) != 0)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * Milliseconds from @p now until @p deadline.
+ *
+ * @retval 0 if the deadline has passed
+ */
+static long millisecondsUntil (struct timespec deadline, struct timespec now)
+{
+	long milliseconds = (deadline.tv_sec - now.tv_sec) * 1000 + (deadline.tv_nsec - now.tv_nsec) / (1000 * 1000);
+	return milliseconds > 0 ? milliseconds : 0;
+}
+
+/**
+ * Forward messages between the sockets.
+ *
+ * Subscription messages from the XPUB socket are forwarded upstream
+ * immediately, so the XPUB socket only delivers subscribed topics to
+ * each subscriber. Notifications are buffered for @p coalesceWindow
+ * milliseconds and duplicates arriving within that window are dropped,
+ * so a burst of identical notifications reaches subscribers only once.
+ *
+ * Returns when the context is destroyed by the signal handler.
+ *
+ * @param coalesceWindow time window in milliseconds (0 disables buffering)
+ */
+static void forwardMessages (long coalesceWindow)
+{
+	PendingMessage pending[MAX_PENDING];
+	size_t pendingCount = 0;
+
+	zmq_pollitem_t items[2] = {
+		{ xSubSocket, 0, ZMQ_POLLIN, 0 },
+		{ xPubSocket, 0, ZMQ_POLLIN, 0 },
+	};
+
+	for (;;)
+	{
+		struct timespec now;
+		long timeout = -1;
+		if (pendingCount > 0)
+		{
+			clock_gettime (CLOCK_MONOTONIC, &now);
+			// messages are buffered in arrival order, the first one expires next
+			timeout = millisecondsUntil (pending[0].deadline, now);
+		}
+
+		if (zmq_poll (items, 2, timeout) == -1)
+		{
+			break;
+		}
+
+		if (items[1].revents & ZMQ_POLLIN)
+		{
+			// forward subscriptions upstream, like zmq_proxy() does
+			zmq_msg_t * frames;
+			size_t frameCount;
+			if (!receiveMultipart (xPubSocket, &frames, &frameCount))
+			{
+				break;
+			}
+			sendMultipart (xSubSocket, frames, frameCount);
+		}
+
+		if (items[0].revents & ZMQ_POLLIN)
+		{
+			zmq_msg_t * frames;
+			size_t frameCount;
+			if (!receiveMultipart (xSubSocket, &frames, &frameCount))
+			{
+				break;
+			}
+
+			if (coalesceWindow == 0 || pendingCount == MAX_PENDING)
+			{
+				sendMultipart (xPubSocket, frames, frameCount);
+			}
+			else
+			{
+				int duplicate = 0;
+				for (size_t i = 0; i < pendingCount; i++)
+				{
+					if (isSameMessage (&pending[i], frames, frameCount))
+					{
+						duplicate = 1;
+						break;
+					}
+				}
+
+				if (duplicate)
+				{
+					discardMultipart (frames, frameCount);
+				}
+				else
+				{
+					clock_gettime (CLOCK_MONOTONIC, &now);
+					pending[pendingCount].frames = frames;
+					pending[pendingCount].frameCount = frameCount;
+					pending[pendingCount].deadline = now;
+					pending[pendingCount].deadline.tv_sec += coalesceWindow / 1000;
+					pending[pendingCount].deadline.tv_nsec += (coalesceWindow % 1000) * 1000 * 1000;
+					if (pending[pendingCount].deadline.tv_nsec >= 1000 * 1000 * 1000)
+					{
+						pending[pendingCount].deadline.tv_sec += 1;
+						pending[pendingCount].deadline.tv_nsec -= 1000 * 1000 * 1000;
+					}
+					pendingCount++;
+				}
+			}
+		}
+
+		// flush buffered messages whose window elapsed
+		if (pendingCount > 0)
+		{
+			clock_gettime (CLOCK_MONOTONIC, &now);
+			while (pendingCount > 0 && millisecondsUntil (pending[0].deadline, now) == 0)
+			{
+				sendMultipart (xPubSocket, pending[0].frames, pending[0].frameCount);
+				pendingCount--;
+				for (size_t i = 0; i < pendingCount; i++)
+				{
+					pending[i] = pending[i + 1];
+				}
+			}
+		}
+	}
+
+	for (size_t i = 0; i < pendingCount; i++)
+	{
+		discardMultipart (pending[i].frames, pending[i].frameCount);
+	}
+}
+
 int main (void)
 {
 	printf ("\nlightweight zeromq message hub\n");
@@ -47,6 +299,8 @@ int main (void)
 	keyAddBaseName (configXSubEndpoint, "bind_xsub");
 	Key * configXPubEndpoint = keyDup (parentKey, KEY_CP_ALL);
 	keyAddBaseName (configXPubEndpoint, "bind_xpub");
+	Key * configCoalesceWindow = keyDup (parentKey, KEY_CP_ALL);
+	keyAddBaseName (configCoalesceWindow, "coalesce_window");
 	KDB * kdb = kdbOpen (NULL, parentKey);
 	if (kdb == NULL)
 	{
@@ -56,6 +310,7 @@ int main (void)
 
 	const char * xSubEndpoint = "tcp://127.0.0.1:6000";
 	const char * xPubEndpoint = "tcp://127.0.0.1:6001";
+	long coalesceWindow = DEFAULT_COALESCE_WINDOW_MS;
 	kdbGet (kdb, config, parentKey);
 	Key * xSubEndpointKey = ksLookup (config, configXSubEndpoint, 0);
 	if (xSubEndpointKey)
@@ -67,9 +322,20 @@ int main (void)
 	{
 		xPubEndpoint = keyString (xPubEndpointKey);
 	}
+	Key * coalesceWindowKey = ksLookup (config, configCoalesceWindow, 0);
+	if (coalesceWindowKey)
+	{
+		char * end;
+		long value = strtol (keyString (coalesceWindowKey), &end, 10);
+		if (*end == '\0' && value >= 0)
+		{
+			coalesceWindow = value;
+		}
+	}
 
 	keyDel (configXSubEndpoint);
 	keyDel (configXPubEndpoint);
+	keyDel (configCoalesceWindow);
 	kdbClose (kdb, parentKey);
 	keyDel (parentKey);
 
@@ -98,12 +364,13 @@ int main (void)
 
 	printf ("listening on %s (XSUB for zeromqsend)\n", xSubEndpoint);
 	printf ("listening on %s (XPUB for zeromqrecv)\n", xPubEndpoint);
+	printf ("coalescing time window is %ld ms\n", coalesceWindow);
 	printf ("hub is running\n");
 	ksDel (config);
 
 	// forward messages between sockets
 	// will return on zmq_ctx_destroy()
-	zmq_proxy (xPubSocket, xSubSocket, NULL);
+	forwardMessages (coalesceWindow);
 
 	return 0;
 }
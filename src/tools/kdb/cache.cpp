@@ -65,6 +65,55 @@ int CacheCommand::execute (Cmdline const & cl)
 		parentKey.setMeta ("cache/clear", "1");
 		plugin->get (ks, parentKey);
 	}
+	else if (cmd == "warm")
+	{
+		KeySet mountConf;
+		Key mountParent (Backends::mountpointsPath, KEY_END);
+		kdb.get (mountConf, mountParent);
+		printWarnings (cerr, mountParent, cl.verbose, cl.debug);
+
+		// one fresh handle per mountpoint, so the cache plugin sees a cold kdbGet and stores the result
+		Backends::BackendInfoVector backends = Backends::getBackendInfo (mountConf);
+		for (Backends::BackendInfoVector::const_iterator it = backends.begin (); it != backends.end (); ++it)
+		{
+			if (it->mountpoint.empty ()) continue;
+			try
+			{
+				KDB backendKdb;
+				KeySet ks;
+				Key mp (it->mountpoint, KEY_END);
+				backendKdb.get (ks, mp);
+				if (cl.verbose) cout << "warmed cache for " << it->mountpoint << endl;
+			}
+			catch (KDBException const & e)
+			{
+				cerr << "could not warm cache for " << it->mountpoint << ": " << e.what () << endl;
+			}
+		}
+
+		// the default backend is cached under a cascading parent
+		KDB defaultKdb;
+		KeySet ks;
+		Key root ("/", KEY_END);
+		defaultKdb.get (ks, root);
+		if (cl.verbose) cout << "warmed cache for the default backend" << endl;
+	}
+	else if (cmd == "stats")
+	{
+		Modules modules;
+		PluginPtr plugin = modules.load ("cache", cl.getPluginsConfig ());
+
+		KeySet ks;
+		parentKey.setMeta ("cache/stats", "1");
+		plugin->get (ks, parentKey);
+
+		Key root ("system:/elektra/cache/stats", KEY_END);
+		ks.rewind ();
+		while (Key k = ks.next ())
+		{
+			if (k.isBelow (root)) cout << k.getBaseName () << " = " << k.getString () << endl;
+		}
+	}
 	else
 	{
 		throw invalid_argument ("not a valid subcommand");
@@ -25,12 +25,12 @@ public:
 
 	virtual std::string getSynopsis () override
 	{
-		return "{enable,disable,default,clear}";
+		return "{enable,disable,default,clear,warm,stats}";
 	}
 
 	virtual std::string getShortHelpText () override
 	{
-		return "Enable, disable, clear the cache or revert to default.";
+		return "Enable, disable, clear, warm the cache, show statistics or revert to default.";
 	}
 
 	virtual std::string getLongHelpText () override
@@ -38,7 +38,10 @@ public:
 		return "This command is used to enable or disable the cache and to revert\n"
 		       "to the default settings. The default settings will let the system\n"
 		       "decide whether to use the cache or not. The clear command will\n"
-		       "remove the generated cache files in a safe way.\n";
+		       "remove the generated cache files in a safe way. The warm command\n"
+		       "pre-populates the caches of all mountpoints, so the first kdbGet()\n"
+		       "after a boot is served from the cache. The stats command shows the\n"
+		       "accumulated cache hit, miss and eviction counters.\n";
 	}
 
 	virtual int execute (Cmdline const & cmdline) override;
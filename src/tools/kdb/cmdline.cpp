@@ -39,7 +39,7 @@ Cmdline::Cmdline (int argc, char ** argv, Command * command)
   /*XXX: Step 2: initialise your option here.*/
   debug (), force (), load (), humanReadable (), help (), interactive (), minDepth (0), maxDepth (numeric_limits<int>::max ()),
   noNewline (), test (), recursive (), resolver (KDB_RESOLVER), strategy ("preserve"), verbose (), quiet (), version (), withoutElektra (),
-  inputFile (""), null (), first (true), second (true), third (true), withRecommends (false), all (), format (KDB_STORAGE), plugins (""),
+  inputFile (""), null (), first (true), second (true), third (true), withRecommends (false), all (), batchFile (""), format (KDB_STORAGE), plugins (""),
   globalPlugins ("spec"), pluginsConfig (""), color ("auto"), ns (""), editor (), bookmarks (), profile ("current"),
 
   executable (), commandName ()
@@ -71,6 +71,14 @@ Cmdline::Cmdline (int argc, char ** argv, Command * command)
 		long_options.push_back (o);
 		helpText += "-a --all                 Consider all of the keys.\n";
 	}
+	optionPos = acceptedOptions.find ('B');
+	if (optionPos != string::npos)
+	{
+		acceptedOptions.insert (optionPos + 1, ":");
+		option o = { "batch", required_argument, nullptr, 'B' };
+		long_options.push_back (o);
+		helpText += "-B --batch <manifest>    Mount all backends listed in the manifest file in one transaction.\n";
+	}
 	if (acceptedOptions.find ('d') != string::npos)
 	{
 		option o = { "debug", no_argument, nullptr, 'd' };
@@ -371,6 +379,9 @@ Cmdline::Cmdline (int argc, char ** argv, Command * command)
 		case 'a':
 			all = true;
 			break;
+		case 'B':
+			batchFile = optarg;
+			break;
 		case 'C':
 			color = optarg;
 			if (color != "never" && color != "auto" && color != "always")
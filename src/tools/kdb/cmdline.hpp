@@ -79,7 +79,8 @@ public:
 	bool second;
 	bool third;
 	bool withRecommends;
-	bool all; /*!< Consider all keys for lookup */
+	bool all;	       /*!< Consider all keys for lookup */
+	std::string batchFile; /*!< Manifest file for batch mounting. */
 	std::string format;
 	std::string plugins;
 	std::string globalPlugins;
@@ -59,7 +59,7 @@ void CompleteCommand::complete (string const & argument, Cmdline const & cl)
 	if (argument.empty ())
 	{ // No argument, show all completions by analyzing everything including namespaces, so adjust the offset for that
 		const Key root = Key ("/", KEY_END);
-		printResults (root, cl.minDepth, cl.maxDepth, cl, analyze (getKeys (root, false, cl), cl),
+		printResults (root, cl.minDepth, cl.maxDepth, cl, analyze (getKeys (root, false, cl), getAnalyzeBound (cl.maxDepth, 0), cl),
 			      bind (filterDepth, cl.minDepth, cl.maxDepth, _1), printResult);
 	}
 	else if (!argument.empty () && argument[0] == '+')
@@ -74,7 +74,7 @@ void CompleteCommand::complete (string const & argument, Cmdline const & cl)
 		{ // Bookmark not resolvable, so try a bookmark completion
 			// since for legacy reasons its probably /sw/kdb, we use /sw as a root
 			const Key root = Key ("/sw", KEY_END);
-			printResults (root, 0, cl.maxDepth, cl, analyze (getKeys (root, true, cl), cl),
+			printResults (root, 0, cl.maxDepth, cl, analyze (getKeys (root, true, cl), numeric_limits<int>::max (), cl),
 				      bind (filterBookmarks, argument, _1), printBookmarkResult);
 		}
 	}
@@ -98,7 +98,8 @@ void CompleteCommand::complete (string const & argument, Cmdline const & cl)
 			const auto filter = [&] (const pair<Key, pair<int, int>> & c) {
 				return filterDepth (cl.minDepth, cl.maxDepth, c) && filterName (argument, c);
 			};
-			printResults (root, cl.minDepth, cl.maxDepth, cl, analyze (getKeys (root, false, cl), cl), filter, printResult);
+			printResults (root, cl.minDepth, cl.maxDepth, cl, analyze (getKeys (root, false, cl), getAnalyzeBound (cl.maxDepth, 0), cl),
+				      filter, printResult);
 		}
 		else
 		{ // the "normal" completion cases
@@ -120,11 +121,18 @@ void CompleteCommand::completeNormal (string const & argument, Key const & parse
 	{
 		root = parent;
 	}
-	const auto result = analyze (ks, cl);
+
+	// only the subtree below the completion level can contribute results,
+	// so bound the analysis to it instead of scanning the whole namespace
+	if (!parent.getBaseName ().empty ())
+	{
+		ks = ks.cut (parent);
+	}
 
 	// we see depth relative to the completion level, if the root exists, distance will be higher so subtract 1
 	// to add up for the offset added my shallShowNextLevel
 	const int offset = getKeyDepth (root) - rootExists + shallShowNextLevel (argument);
+	const auto result = analyze (ks, getAnalyzeBound (cl.maxDepth, offset), cl);
 	if (cl.debug)
 	{
 		cout << "Root is " << root << " with a key depth of " << getKeyDepth (root) << endl;
@@ -146,7 +154,7 @@ void CompleteCommand::completeNormal (string const & argument, Key const & parse
 /*
  * McCabe complexity of 12, 3 caused by debug switches so its ok
  */
-const map<Key, pair<int, int>> CompleteCommand::analyze (KeySet const & ks, Cmdline const & cl)
+const map<Key, pair<int, int>> CompleteCommand::analyze (KeySet const & ks, const int maxAnalyzeDepth, Cmdline const & cl)
 {
 	map<Key, pair<int, int>> hierarchy;
 	stack<Key> keyStack;
@@ -154,13 +162,34 @@ const map<Key, pair<int, int>> CompleteCommand::analyze (KeySet const & ks, Cmdl
 	Key last;
 	addNamespaces (hierarchy, cl);
 
+	// keys deeper than the bound cannot show up in the result, but their
+	// ancestors up to the boundary level can: truncate them to the boundary
+	// instead of skipping them, so those ancestors still appear as nodes
+	const auto nextRelevant = [&] () -> Key {
+		while (ks.next ())
+		{
+			Key candidate = ks.current ();
+			if (maxAnalyzeDepth != numeric_limits<int>::max () && getKeyDepth (candidate) > maxAnalyzeDepth)
+			{
+				candidate = candidate.dup ();
+				do
+				{
+					ckdb::keySetBaseName (candidate.getKey (), NULL);
+				} while (getKeyDepth (candidate) > maxAnalyzeDepth);
+				// several keys below the same boundary ancestor truncate to the same key
+				if (last.isValid () && candidate == last) continue;
+			}
+			return candidate;
+		}
+		return Key (static_cast<ckdb::Key *> (nullptr));
+	};
+
 	ks.rewind ();
-	if (!(ks.next ()))
+	const Key first = nextRelevant ();
+	if (!first)
 	{
 		return hierarchy;
 	}
-
-	const Key first = ks.current ();
 	int curDepth = getKeyDepth (first) - 1;
 	hierarchy[first] = pair<int, int> (0, curDepth);
 	keyStack.push (first);
@@ -208,9 +237,10 @@ const map<Key, pair<int, int>> CompleteCommand::analyze (KeySet const & ks, Cmdl
 			}
 		}
 
-		if (keyStack.empty () && (ks.next ()))
+		if (keyStack.empty ())
 		{ // Current hierarchy processed, we can resume with the next
-			keyStack.push (ks.current ());
+			const Key next = nextRelevant ();
+			if (next) keyStack.push (next);
 		}
 		last = current;
 	}
@@ -256,6 +286,16 @@ int CompleteCommand::getKeyDepth (Key const & key)
 	return std::distance (key.begin (), key.end ());
 }
 
+/**
+ * The deepest absolute depth the analysis has to visit: one level below the
+ * deepest displayed key (which sits at maxDepth + offset), so the node/leaf
+ * property of the displayed keys stays correct.
+ */
+int CompleteCommand::getAnalyzeBound (const int maxDepth, const int offset)
+{
+	return maxDepth > numeric_limits<int>::max () - offset - 1 ? numeric_limits<int>::max () : maxDepth + offset + 1;
+}
+
 const Key CompleteCommand::getParentKey (Key const & key)
 {
 	Key parentKey = key.dup (); // We can't set baseName on keys in keysets, so duplicate it
@@ -50,7 +50,7 @@ private:
 	void complete (std::string const & argument, Cmdline const & cmdLine);
 	void completeNormal (std::string const & argument, kdb::Key const & parsedArgument, Cmdline const & cmdLine);
 
-	const std::map<kdb::Key, std::pair<int, int>> analyze (const kdb::KeySet & ks, Cmdline const & cmdLine);
+	const std::map<kdb::Key, std::pair<int, int>> analyze (const kdb::KeySet & ks, const int maxAnalyzeDepth, Cmdline const & cmdLine);
 	void printResults (
 		kdb::Key const & root, const int minDepth, const int maxDepth, Cmdline const & cmdLine,
 		std::map<kdb::Key, std::pair<int, int>> const & result,
@@ -59,6 +59,7 @@ private:
 
 	// helper functions
 	int getKeyDepth (kdb::Key const & key);
+	int getAnalyzeBound (const int maxDepth, const int offset);
 	const kdb::Key getParentKey (kdb::Key const & key);
 	kdb::KeySet getKeys (kdb::Key root, bool cutAtRoot, Cmdline const & cl);
 	bool shallShowNextLevel (std::string const & argument);
@@ -38,6 +38,9 @@ int ExportCommand::execute (Cmdline const & cl)
 	printWarnings (cerr, root, cl.verbose, cl.debug);
 
 	KeySet part (ks.cut (root));
+	// release the keys outside the exported part, so only the part itself
+	// stays resident while the storage plugin serializes it
+	ks.clear ();
 
 	if (cl.withoutElektra)
 	{
@@ -39,6 +39,7 @@ const char * HighlevelGenTemplate::Params::AdditionalHeaders = "headers";
 const char * HighlevelGenTemplate::Params::GenerateSetters = "genSetters";
 const char * HighlevelGenTemplate::Params::EmbeddedSpec = "embeddedSpec";
 const char * HighlevelGenTemplate::Params::SpecValidation = "specValidation";
+const char * HighlevelGenTemplate::Params::Sealed = "sealed";
 const char * HighlevelGenTemplate::Params::InstallPrefix = "installPrefix";
 const char * HighlevelGenTemplate::Params::EmbedHelpFallback = "embedHelpFallback";
 const char * HighlevelGenTemplate::Params::UseCommands = "useCommands";
@@ -262,6 +263,19 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 										      { "strcmp", EnumConversion::Strcmp } });
 	auto useCommands = getBoolParameter (Params::UseCommands, false);
 	auto initWithPointers = getBoolParameter (Params::InitWithPointers, true);
+	auto sealed = getBoolParameter (Params::Sealed, false);
+
+	if (sealed && specHandling != EmbeddedSpec::Defaults)
+	{
+		throw CommandAbortException ("With 'sealed' enabled, 'embeddedSpec' must be set to 'defaults', "
+					     "because sealed deployments rely on the defaults baked into the generated code.");
+	}
+
+	if (sealed && specValidation != SpecValidation::None)
+	{
+		throw CommandAbortException ("With 'sealed' enabled, 'specValidation' must be 'none', "
+					     "because a sealed deployment does not mount a spec backend to validate against.");
+	}
 
 
 	std::string cascadingParent;
@@ -384,6 +398,7 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 			       { "mount_file", appName + ".overlay.spec.eqd" },
 			       { "spec_mount_file", mountpoint },
 			       { "direct_file?", specHandling != EmbeddedSpec::Full },
+			       { "sealed?", sealed },
 			       { "org_and_app", appNameWithOrg },
 			       { "app", appName } };
 	}
@@ -450,6 +465,13 @@ kainjow::mustache::data HighlevelGenTemplate::getTemplateData (const std::string
 						     "' doesn't have a default value and is not marked with 'require'!");
 		}
 
+		if (sealed && !key.hasMeta ("default"))
+		{
+			throw CommandAbortException ("The key '" + name +
+						     "' doesn't have a default value! With 'sealed' enabled, required keys cannot be "
+						     "enforced at runtime, so every key needs a default value.");
+		}
+
 		kdb::Key defaultsKey (key.getName ().substr (parentLength), KEY_END);
 		defaultsKey.setMeta ("default", key.getMeta<std::string> ("default"));
 		defaultsKey.setMeta ("type", key.getMeta<std::string> ("type"));
@@ -715,8 +737,9 @@ std::string HighlevelGenTemplate::escapeFunction (const std::string & str) const
 std::vector<std::string> HighlevelGenTemplate::getActualParts () const
 {
 	std::vector<std::string> parts (GenTemplate::getActualParts ());
-	if (getParameter (Params::EmbeddedSpec, "full") == "full")
+	if (getParameter (Params::EmbeddedSpec, "full") == "full" || getBoolParameter (Params::Sealed, false))
 	{
+		// sealed deployments never mount a spec backend, so no spec file is needed
 		parts.erase (std::remove (parts.begin (), parts.end (), ".spec.eqd"), parts.end ());
 	}
 	if (!getBoolParameter (Params::UseCommands, false))
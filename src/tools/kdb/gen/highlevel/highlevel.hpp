@@ -25,6 +25,7 @@ class HighlevelGenTemplate : public GenTemplate
 		static const char * GenerateSetters;
 		static const char * EmbeddedSpec;
 		static const char * SpecValidation;
+		static const char * Sealed;
 		static const char * InstallPrefix;
 		static const char * EmbedHelpFallback;
 		static const char * UseCommands;
@@ -46,6 +47,7 @@ public:
 			 { Params::GenerateSetters, false },
 			 { Params::EmbeddedSpec, false },
 			 { Params::SpecValidation, false },
+			 { Params::Sealed, false },
 			 { Params::InstallPrefix, false },
 			 { Params::EmbedHelpFallback, false },
 			 { Params::UseCommands, false },
@@ -112,6 +112,24 @@ int ImportCommand::execute (Cmdline const & cl)
 	MergeHelper helper;
 
 	helper.configureMerger (cl, merger);
+
+	if (base.size () == 0 && !cl.interactive)
+	{
+		// nothing to merge against: hand the parsed keys to the backend directly
+		// instead of running the merge machinery, which duplicates the whole dataset
+		if (cl.verbose)
+		{
+			cout << "importing " << importedKeys.size () << " keys into an empty subtree, skipping merge" << endl;
+		}
+
+		originalKeys.append (importedKeys);
+		kdb.set (originalKeys, root);
+
+		printWarnings (cerr, root, cl.verbose, cl.debug);
+		printError (cerr, root, cl.verbose, cl.debug);
+		return 0;
+	}
+
 	MergeResult result = merger.mergeKeySet (
 		MergeTask (BaseMergeKeys (base, root), OurMergeKeys (base, root), TheirMergeKeys (importedKeys, root), root));
 
@@ -15,9 +15,41 @@
 #include <kdb.hpp>
 #include <keysetio.hpp>
 
+#include <kdbprivate.h> // for kdbGetStream()
+
 using namespace kdb;
 using namespace std;
 
+namespace
+{
+
+struct CollectContext
+{
+	ckdb::KeySet * names; /**< name-only duplicates of the requested keys */
+	ckdb::Key * root; /**< the requested parent key */
+	ssize_t mountPointSize; /**< total number of keys seen, including keys outside root */
+};
+
+/**
+ * Appends name-only duplicates of the requested part of a streamed chunk,
+ * so the values and metadata of the chunk are released again when
+ * kdbGetStream() deletes it.
+ */
+extern "C" int collectNames (ckdb::KeySet * chunk, ckdb::Key *, void * context)
+{
+	CollectContext * collect = static_cast<CollectContext *> (context);
+	collect->mountPointSize += ckdb::ksGetSize (chunk);
+	ckdb::KeySet * below = ckdb::ksCut (chunk, collect->root);
+	for (ssize_t i = 0; i < ckdb::ksGetSize (below); ++i)
+	{
+		ckdb::ksAppendKey (collect->names, ckdb::keyDup (ckdb::ksAtCursor (below, i), KEY_CP_NAME));
+	}
+	ckdb::ksDel (below);
+	return 0;
+}
+
+} // namespace
+
 LsCommand::LsCommand () : kdb (root)
 {
 }
@@ -30,20 +62,22 @@ int LsCommand::execute (Cmdline const & cl)
 
 	root = cl.createKey (0);
 
-	kdb.get (ks, root);
-
-	if (cl.verbose) cout << "size of all keys in mount point: " << ks.size () << endl;
-
-	KeySet part (ks.cut (root));
+	// only the names are needed: stream one backend at a time and keep
+	// name-only duplicates, so values and metadata never stay resident
+	CollectContext collect = { ks.getKeySet (), root.getKey (), 0 };
+	if (ckdb::kdbGetStream (kdb.getKdb (), root.getKey (), collectNames, &collect) == -1)
+	{
+		throw kdb::KDBException (root);
+	}
 
-	if (cl.verbose) cout << "size of requested keys: " << part.size () << endl;
-	cout.setf (std::ios_base::unitbuf);
+	if (cl.verbose) cout << "size of all keys in mount point: " << collect.mountPointSize << endl;
+	if (cl.verbose) cout << "size of requested keys: " << ks.size () << endl;
 	if (cl.null)
 	{
 		cout.unsetf (std::ios_base::skipws);
 	}
 
-	printResults (part, getDepth (root), cl);
+	printResults (ks, getDepth (root), cl);
 
 	printWarnings (cerr, root, cl.verbose, cl.debug);
 
@@ -82,12 +116,14 @@ void LsCommand::printResults (KeySet const & part, const int rootDepth, Cmdline
 		     << " and the relative maximum depth is " << relativeMaxDepth << endl;
 	}
 
-	for (const auto & it : part)
+	const ssize_t size = part.size ();
+	for (ssize_t pos = 0; pos < size; ++pos)
 	{
-		const int depth = getDepth (it);
+		const Key key = part.at (pos);
+		const int depth = getDepth (key);
 		if ((depth >= relativeMinDepth && depth < relativeMaxDepth) || cl.debug)
 		{
-			cout << it;
+			cout << key;
 			if (cl.debug)
 			{
 				cout << " " << depth;
@@ -99,10 +135,21 @@ void LsCommand::printResults (KeySet const & part, const int rootDepth, Cmdline
 			}
 			else
 			{
-				cout << endl;
+				cout << "\n";
+			}
+		}
+
+		if (depth >= relativeMaxDepth && !cl.debug)
+		{
+			// the keyset is sorted, so everything below a too deep key is even
+			// deeper: skip the whole subtree without looking at each name
+			while (pos + 1 < size && part.at (pos + 1).isBelow (key))
+			{
+				++pos;
 			}
 		}
 	}
+	cout << std::flush;
 }
 
 int LsCommand::getDepth (Key const & key)
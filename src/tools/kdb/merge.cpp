@@ -101,6 +101,14 @@ int MergeCommand::execute (Cmdline const & cl)
 
 	helper.reportResult (cl, result, cout, cerr);
 
+	if (cl.verbose)
+	{
+		for (auto const & statistic : merger.getResolutionStatistics ())
+		{
+			cout << statistic.second << " conflicts were resolved by the " << statistic.first << " strategy" << endl;
+		}
+	}
+
 	int ret = 0;
 	if (!result.hasConflicts ())
 	{
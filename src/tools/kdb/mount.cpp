@@ -19,6 +19,7 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -197,6 +198,72 @@ void MountCommand::buildBackend (Cmdline const & cl)
 	}
 }
 
+/**
+ * @brief Build the backends for all lines of a batch manifest
+ *
+ * Every line consists of a path, a mountpoint and an optional list of
+ * plugins, in the same syntax as the positional arguments. All backends
+ * end up in mountConf, so a single kdbSet persists them together.
+ */
+void MountCommand::batchMount (Cmdline const & cl)
+{
+	ifstream manifest (cl.batchFile);
+	if (!manifest.is_open ())
+	{
+		throw invalid_argument ("could not open manifest file " + cl.batchFile);
+	}
+
+	// one builder init, so the plugin database resolves contracts only once for all lines
+	BackendBuilderInit bbi;
+
+	string line;
+	int lineNumber = 0;
+	while (getline (manifest, line))
+	{
+		++lineNumber;
+		istringstream is (line);
+		vector<string> tokens{ istream_iterator<string>{ is }, istream_iterator<string>{} };
+
+		if (tokens.empty () || tokens[0][0] == '#') continue;
+		if (tokens.size () < 2)
+		{
+			throw invalid_argument ("line " + to_string (lineNumber) + " of " + cl.batchFile +
+						" needs at least a path and a mountpoint");
+		}
+
+		Key mpk (tokens[1], KEY_END);
+		if (!mpk.isValid ())
+		{
+			throw invalid_argument (tokens[1] + " is not a valid mountpoint (line " + to_string (lineNumber) + " of " +
+						cl.batchFile + ")");
+		}
+
+		if (cl.force)
+		{
+			Key cutKey (Backends::mountpointsPath, KEY_END);
+			cutKey.addBaseName (mpk.getName ());
+			mountConf.cut (cutKey);
+		}
+
+		if (cl.verbose)
+		{
+			cout << "mounting " << tokens[0] << " at " << mpk.getName () << endl;
+		}
+
+		MountBackendBuilder backend (bbi);
+		backend.setMountpoint (mpk, mountConf);
+		backend.setBackendConfig (cl.getPluginsConfig ("system:/"));
+		backend.addPlugin (PluginSpec (cl.resolver));
+		backend.useConfigFile (tokens[0]);
+		backend.needPlugin ("storage");
+		backend.needPlugin ("sync");
+		backend.addPlugins (parseArguments (cl.plugins));
+		backend.addPlugins (parseArguments (tokens.begin () + 2, tokens.end ()));
+		outputMissingRecommends (backend.resolveNeeds (cl.withRecommends));
+		backend.serialize (mountConf);
+	}
+}
+
 void MountCommand::readPluginConfig (KeySet & pluginConfig)
 {
 	string keyName;
@@ -274,6 +341,20 @@ int MountCommand::execute (Cmdline const & cl)
 {
 	readMountConf (cl);
 
+	if (!cl.batchFile.empty ())
+	{
+		if (cl.interactive || !cl.arguments.empty ())
+		{
+			throw invalid_argument ("--batch cannot be combined with interactive mode or positional arguments");
+		}
+
+		batchMount (cl);
+		askForConfirmation (cl);
+		doIt ();
+
+		return 0;
+	}
+
 	if (!cl.interactive && cl.arguments.empty ())
 	{
 		// no interactive mode, so lets output the mtab
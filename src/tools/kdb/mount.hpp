@@ -26,6 +26,7 @@ class MountCommand : public MountBaseCommand
 	void outputMtab (Cmdline const & cl);
 	void processArguments (Cmdline const & cl);
 	void buildBackend (Cmdline const & cl);
+	void batchMount (Cmdline const & cl);
 	void appendPlugins (kdb::tools::MountBackendInterface & backend);
 	void readPluginConfig (kdb::KeySet & config);
 
@@ -35,7 +36,7 @@ public:
 
 	virtual std::string getShortOptions () override
 	{
-		return "fqisR0123cW";
+		return "fqisR0123cWB";
 	}
 
 	virtual std::string getSynopsis () override
@@ -58,6 +59,10 @@ public:
 		       "\n"
 		       "With the -i option, the mounting will be done interactively\n"
 		       "\n"
+		       "With the -B option, all backends listed in the manifest file\n"
+		       "(one `path mountpoint [plugin [..]]` per line, # starts a comment)\n"
+		       "are validated together and written in a single transaction\n"
+		       "\n"
 		       "With no arguments and not in interactive mode, the current mountpoints will be listed\n"
 		       "Then the options -0123 take effect (otherwise these options can be used to suppress warnings).\n"
 		       "1,2 and 3 will suppress the output of the respective column\n";
@@ -11,14 +11,21 @@
 #include <cmdline.hpp>
 #include <kdb.hpp>
 
+#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
+
+#include <unistd.h>
 
 using namespace std;
 using namespace kdb;
 
 ShellCommand::ShellCommand ()
 : supportedCommands (
+	  "get <name> .. print the value of a key\n"
+	  "set <name> <string> .. change the value of a key and write it back\n"
+	  "rm <name> .. remove a key and write the change back\n"
 	  "kdbGet <name> .. get conf into current keyset\n"
 	  "kdbSet <name> .. set conf from current keyset\n"
 	  "keyClear .. clears the current key\n"
@@ -27,26 +34,129 @@ ShellCommand::ShellCommand ()
 	  "keySetString <string> .. set string of current key\n"
 	  "ksAppendKey .. append current key to current keyset\n"
 	  "ksCut <name> .. cut current keyset\n"
-	  "ksOutput .. outputs all keys of current keyset\n")
+	  "ksOutput .. outputs all keys of current keyset\n"
+	  "exit .. leave the shell\n")
 {
 }
 
-int ShellCommand::execute (Cmdline const &)
+int ShellCommand::execute (Cmdline const & cl)
 {
+	if (cl.arguments.size () > 1) throw invalid_argument ("need at most one argument");
+
+	ifstream script;
+	istream * input = &cin;
+	if (cl.arguments.size () == 1)
+	{
+		script.open (cl.arguments[0]);
+		if (!script.is_open ()) throw invalid_argument ("could not open script file " + cl.arguments[0]);
+		input = &script;
+	}
+
+	// suppress the prompt when commands are piped in or read from a script
+	bool interactive = input == &cin && isatty (STDIN_FILENO);
+	string prompt = interactive ? "> " : "";
+
 	KeySet current;
 	Key currentKey;
 
+	int failed = 0;
 	string commandline;
-	string prompt = "> ";
 
 	cout << prompt;
-	while (getline (cin, commandline))
+	while (getline (*input, commandline))
 	{
 		istringstream is (commandline);
 		string command;
 
 		is >> command;
-		if (command == "kdbGet")
+		try
+		{
+			if (executeLine (command, is, current, currentKey, failed)) break;
+		}
+		catch (std::exception const & e)
+		{
+			// one failing command must not end the batch
+			++failed;
+			cerr << "error: " << command << ": " << e.what () << endl;
+		}
+
+		cout << prompt;
+	}
+
+	return failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Execute a single shell command
+ *
+ * @retval true if the shell should exit
+ */
+bool ShellCommand::executeLine (std::string const & command, std::istringstream & is, kdb::KeySet & current, kdb::Key & currentKey,
+				int & failed)
+{
+	if (command.empty () || command[0] == '#')
+	{
+		// ignore comments and empty lines
+	}
+	else if (command == "get")
+	{
+		string name;
+		is >> name;
+		Key parentKey (name, KEY_END);
+		KeySet ks;
+		kdb.get (ks, parentKey);
+		Key k = ks.lookup (name);
+		if (!k) throw invalid_argument ("key " + name + " not found");
+		if (k.isString ())
+		{
+			cout << k.getString () << endl;
+		}
+		else
+		{
+			cout << "binary key (length: " << k.getBinarySize () << ")" << endl;
+		}
+	}
+	else if (command == "set")
+	{
+		string name;
+		is >> name;
+		string value;
+		is >> value;
+		std::string tmp;
+		getline (is, tmp);
+		value += tmp;
+		Key parentKey (name, KEY_END);
+		KeySet ks;
+		kdb.get (ks, parentKey);
+		Key k = ks.lookup (name);
+		if (k)
+		{
+			k.setString (value);
+		}
+		else
+		{
+			ks.append (Key (name, KEY_VALUE, value.c_str (), KEY_END));
+		}
+		kdb.set (ks, parentKey);
+		cout << "ok: set " << name << endl;
+	}
+	else if (command == "rm")
+	{
+		string name;
+		is >> name;
+		Key parentKey (name, KEY_END);
+		KeySet ks;
+		kdb.get (ks, parentKey);
+		Key k = ks.lookup (name, KDB_O_POP);
+		if (!k) throw invalid_argument ("key " + name + " not found");
+		kdb.set (ks, parentKey);
+		cout << "ok: rm " << name << endl;
+	}
+	else if (command == "exit" || command == "quit")
+	{
+		return true;
+	}
+	else if (command == "kdbGet")
 		{
 			string parent;
 			is >> parent;
@@ -120,17 +230,15 @@ int ShellCommand::execute (Cmdline const &)
 				}
 			}
 		}
-		else
-		{
-			cout << "unknown command!\n"
-				"supported are:\n"
-			     << supportedCommands << endl;
-		}
-
-		cout << prompt;
+	else
+	{
+		++failed;
+		cerr << "unknown command!\n"
+			"supported are:\n"
+		     << supportedCommands << endl;
 	}
 
-	return 0;
+	return false;
 }
 
 ShellCommand::~ShellCommand ()
@@ -13,11 +13,15 @@
 
 #include <kdb.hpp>
 
+#include <sstream>
+
 class ShellCommand : public Command
 {
 	kdb::KDB kdb;
 	std::string supportedCommands;
 
+	bool executeLine (std::string const & command, std::istringstream & is, kdb::KeySet & current, kdb::Key & currentKey, int & failed);
+
 public:
 	ShellCommand ();
 	~ShellCommand ();
@@ -29,7 +33,7 @@ public:
 
 	virtual std::string getSynopsis () override
 	{
-		return "";
+		return "[<script>]";
 	}
 
 	virtual std::string getShortHelpText () override
@@ -42,6 +46,11 @@ public:
 		return "Use an interactive mode to view or edit\n"
 		       "the key database.\n"
 		       "\n"
+		       "When a script file is given or commands are\n"
+		       "piped in, all commands run against one\n"
+		       "long-lived handle and a status is reported\n"
+		       "for each command.\n"
+		       "\n"
 		       "Supported commands are:\n" +
 		       supportedCommands +
 		       "\n"
@@ -12,31 +12,27 @@
 using namespace kdb;
 
 ConfigNode::ConfigNode (QString name, QString path, const Key & key, TreeViewModel * parentModel)
-: m_name (std::move (name)), m_path (std::move (path)), m_key (key), m_children (new TreeViewModel), m_metaData (nullptr),
+: m_name (std::move (name)), m_path (std::move (path)), m_key (key), m_children (nullptr), m_metaData (nullptr),
   m_parentModel (parentModel), m_isExpanded (false), m_isDirty (false)
 {
 	setValue ();
 
-	if (m_key)
-	{
-		m_metaData = new TreeViewModel;
-		populateMetaModel ();
-	}
+	// the child and metadata models are created lazily in getChildren ()
+	// and getMetaKeys (), most nodes are leaves and never need them
 
-	connect (m_children, SIGNAL (expandNode (bool)), this, SLOT (setIsExpanded (bool)));
 	connect (this, SIGNAL (showMessage (QString, QString, QString)), parentModel,
 		 SLOT (showConfigNodeMessage (QString, QString, QString)));
 }
 
 ConfigNode::ConfigNode (const ConfigNode & other)
 : QObject (), m_name (other.m_name), m_path (other.m_path), m_value (other.m_value), m_key (other.m_key.dup ()),
-  m_children (new TreeViewModel), m_metaData (nullptr), m_parentModel (nullptr), m_isExpanded (other.m_isExpanded), m_isDirty (false)
+  m_children (nullptr), m_metaData (nullptr), m_parentModel (nullptr), m_isExpanded (other.m_isExpanded), m_isDirty (false)
 {
 	if (other.m_children)
 	{
 		foreach (ConfigNodePtr node, other.m_children->model ())
 		{
-			m_children->append (ConfigNodePtr (new ConfigNode (*node)));
+			getChildren ()->append (ConfigNodePtr (new ConfigNode (*node)));
 		}
 	}
 
@@ -48,8 +44,6 @@ ConfigNode::ConfigNode (const ConfigNode & other)
 			m_metaData->append (ConfigNodePtr (new ConfigNode (*node)));
 		}
 	}
-
-	connect (m_children, SIGNAL (expandNode (bool)), this, SLOT (setIsExpanded (bool)));
 }
 
 ConfigNode::ConfigNode () : m_children (nullptr), m_metaData (nullptr), m_parentModel (nullptr), m_isExpanded (false), m_isDirty (false)
@@ -241,7 +235,9 @@ void ConfigNode::updateNode (Key key)
 {
 	m_key = key;
 	setValue ();
-	populateMetaModel ();
+	// only refresh the metadata model if it was materialized already,
+	// otherwise getMetaKeys () populates it from the new key on demand
+	if (m_metaData) populateMetaModel ();
 }
 
 void ConfigNode::setIsExpanded (bool value)
@@ -307,7 +303,7 @@ void ConfigNode::setKeyName (const QString & name)
 
 void ConfigNode::appendChild (ConfigNodePtr node)
 {
-	m_children->append (node);
+	getChildren ()->append (node);
 }
 
 bool ConfigNode::hasChild (const QString & name) const
@@ -328,11 +324,23 @@ bool ConfigNode::hasChild (const QString & name) const
 
 TreeViewModel * ConfigNode::getChildren () const
 {
+	if (!m_children)
+	{
+		m_children = new TreeViewModel;
+		connect (m_children, SIGNAL (expandNode (bool)), const_cast<ConfigNode *> (this), SLOT (setIsExpanded (bool)));
+	}
+
 	return m_children;
 }
 
 TreeViewModel * ConfigNode::getMetaKeys () const
 {
+	if (!m_metaData && m_key)
+	{
+		m_metaData = new TreeViewModel;
+		const_cast<ConfigNode *> (this)->populateMetaModel ();
+	}
+
 	return m_metaData;
 }
 
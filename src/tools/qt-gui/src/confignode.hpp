@@ -110,14 +110,16 @@ public:
 	bool hasChild (const QString & name) const;
 
 	/**
-	 * @brief Get the children of this ConfigNode.
+	 * @brief Get the children of this ConfigNode. The model is created
+	 * lazily on the first call.
 	 *
 	 * @return The children of this ConfigNode as model.
 	 */
 	TreeViewModel * getChildren () const;
 
 	/**
-	 * @brief Get the metakeys of this ConfigNode.
+	 * @brief Get the metakeys of this ConfigNode. The model is created
+	 * lazily on the first call.
 	 *
 	 * @return The metakeys of this ConfigNode as model.
 	 */
@@ -251,8 +253,10 @@ private:
 	QVariant m_value;
 
 	kdb::Key m_key;
-	TreeViewModel * m_children;
-	TreeViewModel * m_metaData;
+	// created on demand by getChildren () and getMetaKeys (), most nodes
+	// are leaves without metadata and never pay for the sub-models
+	mutable TreeViewModel * m_children;
+	mutable TreeViewModel * m_metaData;
 	TreeViewModel * m_parentModel;
 
 	bool m_isExpanded;
@@ -466,21 +466,24 @@ void TreeViewModel::sink (ConfigNodePtr node, QStringList keys, const Key & key)
 
 	QString name = keys.takeFirst ();
 
-	if (node->hasChild (name) && !node->getChildByName (name)->isDirty ())
+	// the keyset is sorted, so the child a key descends into is almost
+	// always the one appended last; check it first to avoid a linear
+	// scan over all siblings for every single key
+	ConfigNodePtr child = node->getChildByIndex (node->getChildCount () - 1);
+	if (!child || child->getName () != name) child = node->getChildByName (name);
+
+	if (child && !child->isDirty ())
 	{
-		if (node->getChildByName (name)->getKey () && node->getChildByName (name)->getKey ().getName () == key.getName ())
+		if (child->getKey () && child->getKey ().getName () == key.getName ())
 		{
-			if (node->getChildByName (name)->getKey ().getName () == key.getName ())
-			{
-				node->getChildByName (name)->updateNode (key);
-			}
+			child->updateNode (key);
 		}
 
-		sink (node->getChildByName (name), keys, key);
+		sink (child, keys, key);
 	}
 	else
 	{
-		if (node->hasChild (name)) node->getChildren ()->removeRow (node->getChildIndexByName (name));
+		if (child) node->getChildren ()->removeRow (node->getChildIndexByName (name));
 
 		ConfigNodePtr newNode;
 
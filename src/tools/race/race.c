@@ -12,17 +12,68 @@
 
 #include <fcntl.h>
 #include <pthread.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
+#include <time.h>
 #include <unistd.h>
 
-pthread_barrier_t * bar;
+/** power-of-two latency buckets, bucket n counts latencies in [2^n, 2^(n+1)) microseconds */
+#define HISTOGRAM_BUCKETS (32)
 
-void * writer (void * pV_data ELEKTRA_UNUSED)
+/** per worker counters, each worker only writes its own slot */
+typedef struct
 {
+	unsigned long getOperations;
+	unsigned long setOperations;
+	unsigned long conflicts;
+	unsigned long getHistogram[HISTOGRAM_BUCKETS];
+	unsigned long setHistogram[HISTOGRAM_BUCKETS];
+	unsigned long commitHistogram[HISTOGRAM_BUCKETS]; /* first kdbSet attempt until the commit succeeded */
+} WorkerStats;
+
+/** shared between all processes via shm */
+typedef struct
+{
+	pthread_barrier_t barrier;
+	WorkerStats stats[];
+} SharedState;
+
+SharedState * shared;
+
+int num_threads;
+int num_writers;
+int iterations;
+int benchmarkMode;
+int proc_index;
+
+static long elapsedMicroseconds (struct timespec start, struct timespec end)
+{
+	return (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+static void recordLatency (unsigned long * histogram, struct timespec start, struct timespec end)
+{
+	long microseconds = elapsedMicroseconds (start, end);
+	int bucket = 0;
+	while (microseconds > 1 && bucket < HISTOGRAM_BUCKETS - 1)
+	{
+		microseconds >>= 1;
+		bucket++;
+	}
+	histogram[bucket]++;
+}
+
+void * writer (void * pV_data)
+{
+	int index = (int) (intptr_t) pV_data;
+	WorkerStats * stats = &shared->stats[index];
+	int isWriter = index < num_writers;
+
 	Key * parent = keyNew ("user:/test/race", KEY_END);
 	KDB * h = kdbOpen (NULL, parent);
 	char buffer[4096];
@@ -31,31 +82,95 @@ void * writer (void * pV_data ELEKTRA_UNUSED)
 	sprintf (buffer, "user:/test/race/keys/%d/%lu", pid, tid);
 	KeySet * ks = ksNew (20, KS_END);
 
+	struct timespec start;
+	struct timespec end;
+
+	clock_gettime (CLOCK_MONOTONIC, &start);
 	int retg = kdbGet (h, ks, parent);
-	ksAppendKey (ks, keyNew (buffer, KEY_VALUE, "a value", KEY_END));
+	clock_gettime (CLOCK_MONOTONIC, &end);
+	stats->getOperations++;
+	recordLatency (stats->getHistogram, start, end);
+
+	if (isWriter) ksAppendKey (ks, keyNew (buffer, KEY_VALUE, "a value", KEY_END));
 
-	pthread_barrier_wait (bar);
-	int rets = kdbSet (h, ks, parent);
+	pthread_barrier_wait (&shared->barrier);
 
-	if (rets != -1)
+	if (!benchmarkMode)
 	{
-		int retg2 = kdbGet (h, ks, parent);
-		printf ("I (%d/%lu) won the race! Got return values from first get %d,"
-			" from set %d, from second get %d\n",
-			pid, tid, retg, rets, retg2);
-		ksRewind (ks);
-		/*
-		Key * c;
-		while ((c = ksNext(ks)))
+		// single-shot race: no retry, report winners and losers
+		clock_gettime (CLOCK_MONOTONIC, &start);
+		int rets = kdbSet (h, ks, parent);
+		clock_gettime (CLOCK_MONOTONIC, &end);
+		stats->setOperations++;
+		recordLatency (stats->setHistogram, start, end);
+
+		if (rets != -1)
 		{
-			printf ("Got key: %s - %s\n",
-				keyName(c), keyString(c));
+			clock_gettime (CLOCK_MONOTONIC, &start);
+			int retg2 = kdbGet (h, ks, parent);
+			clock_gettime (CLOCK_MONOTONIC, &end);
+			stats->getOperations++;
+			recordLatency (stats->getHistogram, start, end);
+			printf ("I (%d/%lu) won the race! Got return values from first get %d,"
+				" from set %d, from second get %d\n",
+				pid, tid, retg, rets, retg2);
+		}
+		else
+		{
+			stats->conflicts++;
+			printf ("I (%d/%lu) lost the race! Got %d and from set %d\n", pid, tid, retg, rets);
 		}
-		*/
 	}
 	else
 	{
-		printf ("I (%d/%lu) lost the race! Got %d and from set %d\n", pid, tid, retg, rets);
+		for (int i = 0; i < iterations; i++)
+		{
+			if (isWriter)
+			{
+				char value[30];
+				snprintf (value, sizeof (value), "iteration %d", i);
+				ksAppendKey (ks, keyNew (buffer, KEY_VALUE, value, KEY_END));
+
+				// retry on conflict like applications do: rebase with
+				// kdbGet, reapply the change and attempt kdbSet again
+				struct timespec commitStart;
+				clock_gettime (CLOCK_MONOTONIC, &commitStart);
+				for (;;)
+				{
+					clock_gettime (CLOCK_MONOTONIC, &start);
+					int rets = kdbSet (h, ks, parent);
+					clock_gettime (CLOCK_MONOTONIC, &end);
+					stats->setOperations++;
+					recordLatency (stats->setHistogram, start, end);
+
+					if (rets != -1)
+					{
+						// the contended-commit latency: how long a writer
+						// needed until its change actually landed
+						recordLatency (stats->commitHistogram, commitStart, end);
+						break;
+					}
+
+					stats->conflicts++;
+
+					clock_gettime (CLOCK_MONOTONIC, &start);
+					kdbGet (h, ks, parent);
+					clock_gettime (CLOCK_MONOTONIC, &end);
+					stats->getOperations++;
+					recordLatency (stats->getHistogram, start, end);
+
+					ksAppendKey (ks, keyNew (buffer, KEY_VALUE, value, KEY_END));
+				}
+			}
+			else
+			{
+				clock_gettime (CLOCK_MONOTONIC, &start);
+				kdbGet (h, ks, parent);
+				clock_gettime (CLOCK_MONOTONIC, &end);
+				stats->getOperations++;
+				recordLatency (stats->getHistogram, start, end);
+			}
+		}
 	}
 
 	ksDel (ks);
@@ -66,23 +181,77 @@ void * writer (void * pV_data ELEKTRA_UNUSED)
 	return 0;
 }
 
+static void printStatistics (int num_workers)
+{
+	WorkerStats total;
+	memset (&total, 0, sizeof (total));
+
+	for (int i = 0; i < num_workers; i++)
+	{
+		total.getOperations += shared->stats[i].getOperations;
+		total.setOperations += shared->stats[i].setOperations;
+		total.conflicts += shared->stats[i].conflicts;
+		for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+		{
+			total.getHistogram[bucket] += shared->stats[i].getHistogram[bucket];
+			total.setHistogram[bucket] += shared->stats[i].setHistogram[bucket];
+			total.commitHistogram[bucket] += shared->stats[i].commitHistogram[bucket];
+		}
+	}
+
+	printf ("\nworkers: %d (%d writers, %d readers), iterations per worker: %d\n", num_workers, num_writers, num_workers - num_writers,
+		iterations);
+	printf ("kdbGet operations: %lu\n", total.getOperations);
+	printf ("kdbSet operations: %lu, conflicts: %lu", total.setOperations, total.conflicts);
+	if (total.setOperations > 0)
+	{
+		printf (" (conflict rate %.2f%%)", 100.0 * (double) total.conflicts / (double) total.setOperations);
+	}
+	printf ("\n");
+
+	printf ("\nlatency histogram (microseconds):\n");
+	printf ("%15s %12s %12s %12s\n", "at least", "kdbGet", "kdbSet", "commit");
+	for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++)
+	{
+		if (total.getHistogram[bucket] == 0 && total.setHistogram[bucket] == 0 && total.commitHistogram[bucket] == 0) continue;
+		printf ("%12lu us %12lu %12lu %12lu\n", bucket == 0 ? 0UL : 1UL << bucket, total.getHistogram[bucket],
+			total.setHistogram[bucket], total.commitHistogram[bucket]);
+	}
+}
+
 int main (int argc, char ** argv)
 {
-	if (argc != 4)
+	if (argc < 4 || argc > 6)
 	{
-		printf ("Usage %s <procs> <threads> <barriers>\n", argv[0]);
+		printf ("Usage %s <procs> <threads> <barriers> [iterations [writers]]\n", argv[0]);
 		printf ("This program tests race condition in Elektra\n");
 		printf ("If you set barriers procs*threads, all threads will\n");
 		printf ("start kdbSet() at roughly the same time\n");
+		printf ("With iterations given the tool runs as concurrency\n");
+		printf ("benchmark: each worker performs that many operations,\n");
+		printf ("writers retry conflicting kdbSet() calls after a kdbGet()\n");
+		printf ("and latency histograms and the conflict rate are reported.\n");
+		printf ("writers limits how many workers write (default: all),\n");
+		printf ("the remaining workers only call kdbGet().\n");
 		return 1;
 	}
 
 	// on error (0) is safe
 	int num_procs = atoi (argv[1]);
-	int num_threads = atoi (argv[2]);
+	num_threads = atoi (argv[2]);
 	int num_barriers = atoi (argv[3]);
+	int num_workers = num_procs * num_threads;
+
+	benchmarkMode = argc >= 5;
+	iterations = benchmarkMode ? atoi (argv[4]) : 1;
+	num_writers = argc >= 6 ? atoi (argv[5]) : num_workers;
+
+	if (num_barriers > num_workers)
+	{
+		return 1;
+	}
 
-	if (num_barriers > num_procs * num_threads)
+	if (iterations < 1 || num_writers < 0 || num_writers > num_workers)
 	{
 		return 1;
 	}
@@ -108,20 +277,21 @@ int main (int argc, char ** argv)
 		return 6;
 	}
 
-	if (ftruncate (shm_fd, sizeof (pthread_barrier_t)) != 0)
+	size_t shm_size = sizeof (SharedState) + num_workers * sizeof (WorkerStats);
+	if (ftruncate (shm_fd, shm_size) != 0)
 	{
 		return 7;
 	}
 
-	bar = mmap (NULL, sizeof (pthread_barrier_t), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+	shared = mmap (NULL, shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
 
-	if (bar == MAP_FAILED)
+	if (shared == MAP_FAILED)
 	{
 		shm_unlink (shm_name);
 		return 8;
 	}
 
-	if (pthread_barrier_init (bar, &attr, num_barriers) != 0)
+	if (pthread_barrier_init (&shared->barrier, &attr, num_barriers) != 0)
 	{
 		return 10;
 	}
@@ -145,10 +315,12 @@ int main (int argc, char ** argv)
 		else if (pid == 0)
 		{
 			// child
+			proc_index = i;
 			pthread_t * pwriter = elektraMalloc (num_threads * sizeof (pthread_t));
 			if (!pwriter) return 13;
 			for (i = 0; i < num_threads; i++)
-				if (pthread_create (&pwriter[i], NULL, writer, (void *) 0) != 0) return 14;
+				if (pthread_create (&pwriter[i], NULL, writer, (void *) (intptr_t) (proc_index * num_threads + i)) != 0)
+					return 14;
 			for (i = 0; i < num_threads; i++)
 				pthread_join (pwriter[i], NULL);
 			elektraFree (pwriter);
@@ -169,8 +341,9 @@ int main (int argc, char ** argv)
 		}
 	}
 
+	printStatistics (num_workers);
 
-	if (pthread_barrier_destroy (bar) != 0)
+	if (pthread_barrier_destroy (&shared->barrier) != 0)
 	{
 		return 40;
 	}
@@ -0,0 +1,189 @@
+/**
+ * @file
+ *
+ * @brief Reads the shared memory trace ring written by the timeofday plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../../plugins/timeofday/timeofday.h"
+
+/** aggregation table, one entry per (parent, position) pair */
+typedef struct
+{
+	char position[sizeof (((ElektraTraceSpan *) 0)->position)];
+	char parent[sizeof (((ElektraTraceSpan *) 0)->parent)];
+	unsigned long count;
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+} Aggregate;
+
+static ElektraTraceRing * openRing (int * unlinkRequested)
+{
+	char shmName[64];
+	snprintf (shmName, sizeof (shmName), ELEKTRA_TRACE_SHM_NAME_FORMAT, (long) getuid ());
+
+	if (*unlinkRequested)
+	{
+		if (shm_unlink (shmName) == -1)
+		{
+			perror ("shm_unlink");
+			return NULL;
+		}
+		return NULL;
+	}
+
+	int fd = shm_open (shmName, O_RDONLY, 0);
+	if (fd == -1)
+	{
+		fprintf (stderr, "could not open trace ring %s: mount the timeofday plugin with shm=1 first\n", shmName);
+		return NULL;
+	}
+
+	void * mem = mmap (0, sizeof (ElektraTraceRing), PROT_READ, MAP_SHARED, fd, 0);
+	close (fd);
+	if (mem == MAP_FAILED)
+	{
+		perror ("mmap");
+		return NULL;
+	}
+	return mem;
+}
+
+/**
+ * Copy the spans still present in the ring, oldest first.
+ *
+ * @return number of spans copied
+ */
+static size_t snapshotSpans (ElektraTraceRing * ring, ElektraTraceSpan * spans)
+{
+	uint64_t head = __atomic_load_n (&ring->head, __ATOMIC_RELAXED);
+	uint64_t first = head > ELEKTRA_TRACE_RING_SIZE ? head - ELEKTRA_TRACE_RING_SIZE : 0;
+
+	size_t count = 0;
+	for (uint64_t i = first; i < head; i++)
+	{
+		spans[count++] = ring->spans[i % ELEKTRA_TRACE_RING_SIZE];
+	}
+	return count;
+}
+
+static void dumpSpans (ElektraTraceSpan * spans, size_t count)
+{
+	printf ("%20s %12s %8s %-16s %s\n", "timestamp (ns)", "delta (ns)", "pid", "position", "parent");
+	for (size_t i = 0; i < count; i++)
+	{
+		printf ("%20llu %12llu %8ld %-16s %s\n", (unsigned long long) spans[i].timestamp,
+			(unsigned long long) spans[i].delta, (long) spans[i].pid, spans[i].position, spans[i].parent);
+	}
+}
+
+static void aggregateSpans (ElektraTraceSpan * spans, size_t count)
+{
+	Aggregate * aggregates = calloc (count > 0 ? count : 1, sizeof (Aggregate));
+	if (!aggregates)
+	{
+		return;
+	}
+	size_t aggregateCount = 0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Aggregate * entry = NULL;
+		for (size_t j = 0; j < aggregateCount; j++)
+		{
+			if (strcmp (aggregates[j].position, spans[i].position) == 0 &&
+			    strcmp (aggregates[j].parent, spans[i].parent) == 0)
+			{
+				entry = &aggregates[j];
+				break;
+			}
+		}
+		if (!entry)
+		{
+			entry = &aggregates[aggregateCount++];
+			strcpy (entry->position, spans[i].position);
+			strcpy (entry->parent, spans[i].parent);
+			entry->min = UINT64_MAX;
+		}
+
+		entry->count++;
+		entry->total += spans[i].delta;
+		if (spans[i].delta < entry->min) entry->min = spans[i].delta;
+		if (spans[i].delta > entry->max) entry->max = spans[i].delta;
+	}
+
+	printf ("%8s %12s %12s %12s %-16s %s\n", "count", "avg (ns)", "min (ns)", "max (ns)", "position", "parent");
+	for (size_t i = 0; i < aggregateCount; i++)
+	{
+		printf ("%8lu %12llu %12llu %12llu %-16s %s\n", aggregates[i].count,
+			(unsigned long long) (aggregates[i].total / aggregates[i].count), (unsigned long long) aggregates[i].min,
+			(unsigned long long) aggregates[i].max, aggregates[i].position, aggregates[i].parent);
+	}
+
+	free (aggregates);
+}
+
+int main (int argc, char ** argv)
+{
+	int aggregate = 0;
+	int unlinkRequested = 0;
+
+	if (argc == 2 && strcmp (argv[1], "aggregate") == 0)
+	{
+		aggregate = 1;
+	}
+	else if (argc == 2 && strcmp (argv[1], "clear") == 0)
+	{
+		unlinkRequested = 1;
+	}
+	else if (argc != 1)
+	{
+		printf ("Usage: %s [aggregate|clear]\n", argv[0]);
+		printf ("Dumps the spans recorded by the timeofday plugin (shm=1).\n");
+		printf ("With \"aggregate\" spans are summarized per parent key and\n");
+		printf ("placement, with \"clear\" the trace ring is removed.\n");
+		return 1;
+	}
+
+	ElektraTraceRing * ring = openRing (&unlinkRequested);
+	if (unlinkRequested)
+	{
+		return 0;
+	}
+	if (!ring)
+	{
+		return 1;
+	}
+
+	ElektraTraceSpan * spans = malloc (ELEKTRA_TRACE_RING_SIZE * sizeof (ElektraTraceSpan));
+	if (!spans)
+	{
+		munmap (ring, sizeof (ElektraTraceRing));
+		return 1;
+	}
+	size_t count = snapshotSpans (ring, spans);
+
+	if (aggregate)
+	{
+		aggregateSpans (spans, count);
+	}
+	else
+	{
+		dumpSpans (spans, count);
+	}
+
+	free (spans);
+	munmap (ring, sizeof (ElektraTraceRing));
+	return 0;
+}
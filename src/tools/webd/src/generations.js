@@ -0,0 +1,32 @@
+/**
+ * @file
+ *
+ * @brief tracks a generation token per instance to short-circuit polling
+ *
+ * Every write through webd bumps the generation of the affected instance.
+ * Clients receive the generation as an ETag and send it back via
+ * `If-None-Match`, so unchanged subtrees answer with 304 without asking
+ * elektrad at all. Writes that bypass webd are not detected, a full
+ * response is only guaranteed after the next write through webd or a
+ * restart.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+import randomString from "crypto-random-string";
+
+// changes on every restart, so tokens from a previous webd never match
+const boot = randomString({ length: 8 });
+
+const generations = new Map();
+
+export const getGeneration = (instanceId) => {
+  if (!generations.has(instanceId)) {
+    generations.set(instanceId, 1);
+  }
+  return `${boot}-${generations.get(instanceId)}`;
+};
+
+export const bumpGeneration = (instanceId) => {
+  generations.set(instanceId, (generations.get(instanceId) || 1) + 1);
+};
@@ -9,12 +9,15 @@
 import {
   APIError,
   successResponse,
+  compressedResponse,
   errorResponse,
   dontShowDB,
   setSessionID,
   getSessionID,
 } from "./utils";
 
+import { getGeneration, bumpGeneration } from "../generations";
+
 import {
   getInstances as getDBInstances,
   createInstance,
@@ -106,8 +109,13 @@ export default function initInstanceRoutes(app) {
       .catch((err) => errorResponse(res, err))
   );
 
-  app.get("/api/instances/:id/kdb", (req, res) =>
-    getInstance(req.params.id)
+  app.get("/api/instances/:id/kdb", (req, res) => {
+    const etag = `"${getGeneration(req.params.id)}"`;
+    if (req.headers["if-none-match"] === etag) {
+      // nothing was written through webd since the client's last poll
+      return res.status(304).end();
+    }
+    return getInstance(req.params.id)
       .then((instance) => {
         if (!instance || !instance.host) {
           throw new APIError("Instance not found or invalid (no host)");
@@ -121,14 +129,22 @@ export default function initInstanceRoutes(app) {
       )
       .then((res) => res.json())
       .then(dontShowDB)
-      .then((output) => successResponse(res, output))
-      .catch((err) => errorResponse(res, err))
-  );
+      .then((output) => {
+        res.set("ETag", etag);
+        return compressedResponse(req, res, output);
+      })
+      .catch((err) => errorResponse(res, err));
+  });
 
   app
     .route("/api/instances/:id/kdb/*")
-    .get((req, res) =>
-      getInstance(req.params.id)
+    .get((req, res) => {
+      const etag = `"${getGeneration(req.params.id)}"`;
+      if (req.headers["if-none-match"] === etag) {
+        // nothing was written through webd since the client's last poll
+        return res.status(304).end();
+      }
+      return getInstance(req.params.id)
         .then((instance) => {
           const qs = req._parsedUrl.query;
           return remoteKdb.get(instance.host, {
@@ -142,9 +158,12 @@ export default function initInstanceRoutes(app) {
         )
         .then((res) => res.json())
         .then(dontShowDB)
-        .then((output) => successResponse(res, output))
-        .catch((err) => errorResponse(res, err))
-    )
+        .then((output) => {
+          res.set("ETag", etag);
+          return compressedResponse(req, res, output);
+        })
+        .catch((err) => errorResponse(res, err));
+    })
     .put((req, res) =>
       getInstance(req.params.id)
         .then((instance) =>
@@ -153,7 +172,10 @@ export default function initInstanceRoutes(app) {
         .then((instanceRes) =>
           setSessionID(req.params.id, req.session, instanceRes)
         )
-        .then((output) => successResponse(res, output))
+        .then((output) => {
+          bumpGeneration(req.params.id);
+          return successResponse(res, output);
+        })
         .catch((err) => errorResponse(res, err))
     )
     .delete((req, res) =>
@@ -162,7 +184,10 @@ export default function initInstanceRoutes(app) {
         .then((instanceRes) =>
           setSessionID(req.params.id, req.session, instanceRes)
         )
-        .then((output) => successResponse(res, output))
+        .then((output) => {
+          bumpGeneration(req.params.id);
+          return successResponse(res, output);
+        })
         .catch((err) => errorResponse(res, err))
     );
 
@@ -182,7 +207,10 @@ export default function initInstanceRoutes(app) {
       .then((instanceRes) =>
         setSessionID(req.params.id, req.session, instanceRes)
       )
-      .then(() => res.status(204).send())
+      .then(() => {
+        bumpGeneration(req.params.id);
+        return res.status(204).send();
+      })
       .catch((err) => errorResponse(res, err))
   );
 
@@ -192,7 +220,10 @@ export default function initInstanceRoutes(app) {
       .then((instanceRes) =>
         setSessionID(req.params.id, req.session, instanceRes)
       )
-      .then(() => res.status(204).send())
+      .then(() => {
+        bumpGeneration(req.params.id);
+        return res.status(204).send();
+      })
       .catch((err) => errorResponse(res, err))
   );
 
@@ -211,7 +242,10 @@ export default function initInstanceRoutes(app) {
         .then((instanceRes) =>
           setSessionID(req.params.id, req.session, instanceRes)
         )
-        .then(() => res.status(204).send())
+        .then(() => {
+          bumpGeneration(req.params.id);
+          return res.status(204).send();
+        })
         .catch((err) => errorResponse(res, err))
     )
     .delete((req, res) =>
@@ -222,7 +256,10 @@ export default function initInstanceRoutes(app) {
         .then((instanceRes) =>
           setSessionID(req.params.id, req.session, instanceRes)
         )
-        .then(() => res.status(204).send())
+        .then(() => {
+          bumpGeneration(req.params.id);
+          return res.status(204).send();
+        })
         .catch((err) => errorResponse(res, err))
     );
 }
@@ -6,6 +6,8 @@
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  */
 
+import zlib from "zlib";
+
 import { ROOT_PATH } from "../config";
 
 export function APIError(message) {
@@ -19,6 +21,22 @@ export const prettyprint = (obj) => JSON.stringify(obj, null, 2);
 export const successResponse = (res, output) =>
   output ? res.json(output) : res.send();
 
+// send JSON gzipped when the client accepts it, subtree dumps can be large
+export const compressedResponse = (req, res, output) => {
+  if (!output) return res.send();
+  const body = JSON.stringify(output);
+  const acceptsGzip = String(req.headers["accept-encoding"] || "").includes(
+    "gzip"
+  );
+  if (acceptsGzip && body.length > 1024) {
+    return res
+      .type("application/json")
+      .set("Content-Encoding", "gzip")
+      .send(zlib.gzipSync(body));
+  }
+  return res.type("application/json").send(body);
+};
+
 export const errorResponse = (res, err) => {
   if (process.env.NODE_ENV !== "production") {
     if (!(err instanceof APIError)) console.error(err);
@@ -162,6 +162,49 @@ static void test_getArray (void)
 }
 
 
+static void test_getArrayRange (void)
+{
+	printf ("Test get array range");
+
+	KeySet * keys = ksNew (20, keyNew ("user:/test/key1", KEY_END), keyNew ("user:/test/array", KEY_END),
+			       keyNew ("user:/test/array/#0", KEY_END), keyNew ("user:/test/array/#0/below", KEY_END),
+			       keyNew ("user:/test/array/#1", KEY_END), keyNew ("user:/test/array/#2", KEY_END),
+			       keyNew ("user:/test/array/#3", KEY_END), keyNew ("user:/test/array/#3/below", KEY_END),
+			       keyNew ("user:/test/array/#4", KEY_END), keyNew ("user:/test/yetanotherkey", KEY_END), KS_END);
+
+	Key * arrayParent = keyNew ("user:/test/array", KEY_END);
+	KeySet * range = elektraArrayGetRange (arrayParent, keys, 1, 4);
+
+	succeed_if (range, "the getrange function did not return a proper keyset");
+	succeed_if (ksGetSize (range) == 3, "the range contains a wrong number of elements");
+	succeed_if (ksLookupByName (range, "user:/test/array/#1", KDB_O_NONE), "the range does not contain #1");
+	succeed_if (ksLookupByName (range, "user:/test/array/#2", KDB_O_NONE), "the range does not contain #2");
+	succeed_if (ksLookupByName (range, "user:/test/array/#3", KDB_O_NONE), "the range does not contain #3");
+	succeed_if (!ksLookupByName (range, "user:/test/array/#0", KDB_O_NONE), "the range must not contain #0");
+	succeed_if (!ksLookupByName (range, "user:/test/array/#4", KDB_O_NONE), "the range must not contain #4");
+	succeed_if (!ksLookupByName (range, "user:/test/array/#3/below", KDB_O_NONE), "the range must not contain subkeys");
+	ksDel (range);
+
+	// a range past the end of the array is cut off
+	range = elektraArrayGetRange (arrayParent, keys, 4, 100);
+	succeed_if (range, "the getrange function did not return a proper keyset");
+	succeed_if (ksGetSize (range) == 1, "the cut off range contains a wrong number of elements");
+	succeed_if (ksLookupByName (range, "user:/test/array/#4", KDB_O_NONE), "the cut off range does not contain #4");
+	ksDel (range);
+
+	range = elektraArrayGetRange (arrayParent, keys, 2, 2);
+	succeed_if (range && ksGetSize (range) == 0, "an empty range must yield an empty keyset");
+	ksDel (range);
+
+	succeed_if (!elektraArrayGetRange (arrayParent, keys, -1, 2), "a negative start index must fail");
+	succeed_if (!elektraArrayGetRange (arrayParent, keys, 3, 2), "a reversed range must fail");
+	succeed_if (!elektraArrayGetRange (0, keys, 0, 2), "null pointer");
+	succeed_if (!elektraArrayGetRange (arrayParent, 0, 0, 2), "null pointer");
+
+	keyDel (arrayParent);
+	ksDel (keys);
+}
+
 static void test_getArrayNext (void)
 {
 	printf ("Test get array next");
@@ -184,6 +227,30 @@ static void test_getArrayNext (void)
 	ksDel (array);
 }
 
+static void test_appendNextKey (void)
+{
+	printf ("Test append next key");
+
+	KeySet * array = ksNew (10, keyNew ("user:/test/array/#0", KEY_END), keyNew ("user:/test/array/#1", KEY_END), KS_END);
+
+	Key * nextKey = elektraArrayAppendNextKey (array);
+	exit_if_fail (nextKey, "the append function did not return a proper key");
+	succeed_if_same_string (keyName (nextKey), "user:/test/array/#2");
+	succeed_if (ksGetSize (array) == 3, "the new key was not appended to the array");
+	succeed_if (ksLookupByName (array, "user:/test/array/#2", KDB_O_NONE) == nextKey, "the array does not contain the new key");
+
+	nextKey = elektraArrayAppendNextKey (array);
+	exit_if_fail (nextKey, "the append function did not return a proper key");
+	succeed_if_same_string (keyName (nextKey), "user:/test/array/#3");
+	succeed_if (ksGetSize (array) == 4, "the new key was not appended to the array");
+
+	ksClear (array);
+	succeed_if (!elektraArrayAppendNextKey (array), "the append function did not return NULL on an empty array");
+	succeed_if (!elektraArrayAppendNextKey (0), "null pointer");
+
+	ksDel (array);
+}
+
 static void test_baseName (void)
 {
 	printf ("Test validate base name");
@@ -211,7 +278,9 @@ int main (int argc, char ** argv)
 	test_noArray ();
 	test_startArray ();
 	test_getArray ();
+	test_getArrayRange ();
 	test_getArrayNext ();
+	test_appendNextKey ();
 	test_baseName ();
 
 	printf ("\ntest_array RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
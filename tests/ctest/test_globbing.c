@@ -130,6 +130,34 @@ static void test_prefix (void)
 	should_not_match (BASE_KEY "/door/key", BASE_KEY "/key/__");
 }
 
+static void check_prefix (const char * pattern, const char * expected)
+{
+	ElektraGlobPattern * compiled = elektraGlobCompile (pattern);
+	const char * prefix;
+	size_t len = elektraGlobPatternPrefix (compiled, &prefix);
+	succeed_if (len == strlen (expected) && strncmp (prefix, expected, len) == 0, pattern);
+	elektraGlobPatternDel (compiled);
+}
+
+static void test_literal_prefix (void)
+{
+	printf ("literal prefix\n");
+
+	check_prefix ("/server/port", "/server/port");
+	check_prefix ("/server/po*", "/server");
+	check_prefix ("/server/*/timeout", "/server");
+	check_prefix ("/server/instances/#/port", "/server/instances");
+	check_prefix ("/server/_/port", "/server");
+	check_prefix ("/server/__", "/server");
+	check_prefix ("/*", "/");
+	check_prefix ("/#", "/");
+	check_prefix ("/", "/");
+
+	const char * prefix = (const char *) 1;
+	succeed_if (elektraGlobPatternPrefix (NULL, &prefix) == 0, "NULL pattern should have empty prefix");
+	succeed_if (prefix == NULL, "NULL pattern should set prefix to NULL");
+}
+
 static void test_keyset (void)
 {
 	printf ("keyset");
@@ -173,6 +201,7 @@ int main (int argc, char ** argv)
 	test_hash ();
 	test_underscore ();
 	test_prefix ();
+	test_literal_prefix ();
 	test_keyset ();
 
 	print_result ("test_globbing");
@@ -450,6 +450,364 @@ void test_ksFindHierarchy (void)
 	ksDel (ks);
 }
 
+static void test_ksFindNextChild (void)
+{
+	printf ("Test ksFindNextChild\n");
+
+	KeySet * ks =
+		ksNew (24,
+		       // clang-format off
+		       keyNew ("system:/bar", KEY_VALUE, "1", KEY_END),
+		       keyNew ("system:/bar/a", KEY_VALUE, "2", KEY_END),
+		       keyNew ("system:/bar/a/x", KEY_VALUE, "3", KEY_END),
+		       keyNew ("system:/bar/b", KEY_VALUE, "4", KEY_END),
+		       keyNew ("system:/baz/deep/deeper", KEY_VALUE, "5", KEY_END),
+		       keyNew ("system:/foo", KEY_VALUE, "6", KEY_END),
+		       // clang-format on
+		       KS_END);
+
+	Key * root = keyNew ("system:/", KEY_END);
+
+	succeed_if (ksFindNextChild (ks, NULL, 0) == -1, "shouldn't accept NULL");
+	succeed_if (ksFindNextChild (NULL, root, 0) == -1, "shouldn't accept NULL");
+	succeed_if (ksFindNextChild (ks, root, -1) == -1, "shouldn't accept negative position");
+
+	// children of system:/ are bar, baz (implicit) and foo
+	succeed_if (ksFindNextChild (ks, root, 0) == 0, "should find first key of bar");
+	succeed_if (ksFindNextChild (ks, root, 1) == 4, "should skip the bar hierarchy");
+	succeed_if (ksFindNextChild (ks, root, 5) == 5, "should find foo");
+	succeed_if (ksFindNextChild (ks, root, 6) == -1, "should find no further child");
+
+	keySetName (root, "system:/bar");
+	succeed_if (ksFindNextChild (ks, root, 0) == 1, "should skip the root key itself");
+	succeed_if (ksFindNextChild (ks, root, 2) == 3, "should skip the grandchild");
+	succeed_if (ksFindNextChild (ks, root, 4) == -1, "should find no further child");
+
+	keySetName (root, "system:/bar/a");
+	succeed_if (ksFindNextChild (ks, root, 0) == 2, "should find the only child");
+	succeed_if (ksFindNextChild (ks, root, 3) == -1, "should find no further child");
+
+	keySetName (root, "system:/baz");
+	succeed_if (ksFindNextChild (ks, root, 0) == 4, "should find first key of the implicit child");
+	succeed_if (ksFindNextChild (ks, root, 5) == -1, "should find no further child");
+
+	keySetName (root, "system:/foo");
+	succeed_if (ksFindNextChild (ks, root, 0) == -1, "leaf should have no children");
+
+	keySetName (root, "system:/zoo");
+	succeed_if (ksFindNextChild (ks, root, 0) == -1, "shouldn't find absent hierarchy");
+
+	keyDel (root);
+	ksDel (ks);
+}
+
+static void test_ksArena (void)
+{
+	printf ("Test ks arena\n");
+
+	KeySet * ks = ksNewWithArena (0);
+	exit_if_fail (ks != NULL, "could not create arena keyset");
+	succeed_if (ks->arena != NULL, "arena is not attached");
+
+	// long enough to not be stored inline in the key struct
+	Key * k = ksArenaKeyNew (ks, "user:/arena/a", "a value for arena key a");
+	exit_if_fail (k != NULL, "could not create arena key");
+	succeed_if_same_string (keyName (k), "user:/arena/a");
+	succeed_if_same_string (keyString (k), "a value for arena key a");
+
+	succeed_if (ksArenaKeyNew (ks, "user:/arena/b", NULL) != NULL, "could not create valueless arena key");
+	succeed_if (ksArenaKeyNew (ks, "invalid name", "x") == NULL, "invalid name should be rejected");
+	succeed_if (ksGetSize (ks) == 2, "wrong size");
+
+	Key * small = ksArenaKeyNew (ks, "user:/arena/c", "small");
+	exit_if_fail (small != NULL, "could not create arena key with inline value");
+	succeed_if_same_string (keyString (small), "small");
+	succeed_if (ksGetSize (ks) == 3, "wrong size");
+
+	succeed_if (ksLookupByName (ks, "user:/arena/a", 0) == k, "lookup did not find arena key");
+
+	// duplicating a borrowed-buffer key must not copy the payloads
+	Key * dup = keyDup (k, KEY_CP_ALL);
+	succeed_if (keyName (dup) == keyName (k), "borrowed name was copied");
+	succeed_if (keyString (dup) == keyString (k), "borrowed value was copied");
+	keyDel (dup);
+
+	// modifying an arena key must move the affected buffer to the heap
+	keySetString (k, "changed");
+	succeed_if_same_string (keyString (k), "changed");
+
+	ksDel (ks);
+
+	// arena keysets must survive many keys spanning multiple slabs
+	ks = ksNewWithArena (256);
+	for (int i = 0; i < 1000; ++i)
+	{
+		char name[40];
+		snprintf (name, sizeof (name), "user:/arena/key%d", i);
+		succeed_if (ksArenaKeyNew (ks, name, "v") != NULL, "could not create arena key");
+	}
+	succeed_if (ksGetSize (ks) == 1000, "wrong size after bulk create");
+	ksDel (ks);
+}
+
+static void test_ksCowDup (void)
+{
+	printf ("Test ksCowDup\n");
+
+	KeySet * ks = ksNew (10, keyNew ("user:/cow/a", KEY_VALUE, "orig", KEY_META, "type", "string", KEY_END),
+			     keyNew ("user:/cow/b", KEY_VALUE, "other", KEY_END), KS_END);
+
+	KeySet * snap = ksCowDup (ks);
+	exit_if_fail (snap != NULL, "could not cow-dup");
+	succeed_if (ksGetSize (snap) == 2, "wrong size");
+
+	Key * o = ksLookupByName (ks, "user:/cow/a", 0);
+	Key * c = ksLookupByName (snap, "user:/cow/a", 0);
+	exit_if_fail (o && c, "keys not found");
+	succeed_if (o != c, "key objects are shared");
+	succeed_if (keyName (o) == keyName (c), "name buffers are not shared");
+	succeed_if_same_string (keyString (keyGetMeta (c, "type")), "string");
+
+	// values must be independent
+	keySetString (o, "changed");
+	succeed_if_same_string (keyString (c), "orig");
+
+	// metadata must materialize on write
+	keySetMeta (c, "type", "long");
+	succeed_if_same_string (keyString (keyGetMeta (o, "type")), "string");
+
+	// the snapshot may outlive the source
+	ksDel (ks);
+	succeed_if_same_string (keyName (c), "user:/cow/a");
+	succeed_if_same_string (keyString (c), "orig");
+
+	ksDel (snap);
+}
+
+static void test_ksAppendBatch (void)
+{
+	printf ("Test ksAppendBatch\n");
+
+	KeySet * ks = ksNew (2, keyNew ("user:/b", KEY_VALUE, "old-b", KEY_END), keyNew ("user:/d", KEY_VALUE, "d", KEY_END), KS_END);
+
+	Key * batch[4];
+	batch[0] = keyNew ("user:/c", KEY_VALUE, "c", KEY_END);
+	batch[1] = keyNew ("user:/a", KEY_VALUE, "a", KEY_END);
+	batch[2] = keyNew ("user:/b", KEY_VALUE, "new-b1", KEY_END);
+	batch[3] = keyNew ("user:/b", KEY_VALUE, "new-b2", KEY_END);
+
+	succeed_if (ksAppendBatch (ks, batch, 4) == 4, "wrong size after batch append");
+
+	succeed_if_same_string (keyName (ksAtCursor (ks, 0)), "user:/a");
+	succeed_if_same_string (keyName (ksAtCursor (ks, 1)), "user:/b");
+	succeed_if_same_string (keyName (ksAtCursor (ks, 2)), "user:/c");
+	succeed_if_same_string (keyName (ksAtCursor (ks, 3)), "user:/d");
+
+	// the last duplicate wins, exactly like repeated ksAppendKey calls
+	succeed_if_same_string (keyString (ksLookupByName (ks, "user:/b", 0)), "new-b2");
+
+	succeed_if (ksAppendBatch (ks, NULL, 0) == 4, "empty batch changed the keyset");
+	succeed_if (ksAppendBatch (ks, NULL, 3) == -1, "NULL batch not rejected");
+
+	ksDel (ks);
+}
+
+static void test_ksFindByMeta (void)
+{
+	printf ("Test ksFindByMeta\n");
+
+	KeySet * ks = ksNew (6,
+			     // clang-format off
+			     keyNew ("user:/a", KEY_VALUE, "1", KEY_META, "type", "string", KEY_END),
+			     keyNew ("user:/b", KEY_VALUE, "2", KEY_END),
+			     keyNew ("user:/c", KEY_VALUE, "3", KEY_META, "type", "long", KEY_META, "check/range", "0-10", KEY_END),
+			     keyNew ("user:/d", KEY_VALUE, "4", KEY_END),
+			     keyNew ("user:/e", KEY_VALUE, "5", KEY_META, "type", "string", KEY_END),
+			     // clang-format on
+			     KS_END);
+
+	succeed_if (ksFindByMeta (NULL, "type", 0) == -1, "shouldn't accept NULL");
+	succeed_if (ksFindByMeta (ks, NULL, 0) == -1, "shouldn't accept NULL");
+	succeed_if (ksFindByMeta (ks, "type", -1) == -1, "shouldn't accept negative position");
+	succeed_if (ksFindByMeta (ks, "type", ksGetSize (ks)) == -1, "shouldn't accept position behind the keyset");
+
+	succeed_if (ksFindByMeta (ks, "type", 0) == 0, "should find user:/a");
+	succeed_if (ksFindByMeta (ks, "type", 1) == 2, "should find user:/c");
+	succeed_if (ksFindByMeta (ks, "type", 3) == 4, "should find user:/e");
+	succeed_if (ksFindByMeta (ks, "meta:/type", 3) == 4, "should accept the meta:/ prefix");
+	succeed_if (ksFindByMeta (ks, "check/range", 0) == 2, "should find user:/c");
+	succeed_if (ksFindByMeta (ks, "check/range", 3) == -1, "shouldn't find another key");
+	succeed_if (ksFindByMeta (ks, "comment", 0) == -1, "shouldn't find unused metakey");
+
+	// the index is discarded when keys are inserted
+	ksAppendKey (ks, keyNew ("user:/aa", KEY_VALUE, "6", KEY_META, "type", "boolean", KEY_END));
+	succeed_if (ksFindByMeta (ks, "type", 1) == 1, "should find freshly inserted user:/aa");
+
+	// the index is discarded when keys are removed
+	keyDel (ksLookupByName (ks, "user:/aa", KDB_O_POP));
+	succeed_if (ksFindByMeta (ks, "type", 1) == 2, "should find user:/c again");
+
+	// metadata changes need an explicit invalidation
+	keySetMeta (ksAtCursor (ks, 1), "type", "string");
+	ksMetaIndexInvalidate (ks);
+	succeed_if (ksFindByMeta (ks, "type", 1) == 1, "should find user:/b after invalidation");
+
+	ksDel (ks);
+}
+
+static void test_ksLookupCached (void)
+{
+	printf ("Test ksLookupCached\n");
+
+	KeySet * ks = ksNew (6,
+			     // clang-format off
+			     keyNew ("user:/a", KEY_VALUE, "1", KEY_END),
+			     keyNew ("user:/b", KEY_VALUE, "2", KEY_END),
+			     keyNew ("user:/c", KEY_VALUE, "3", KEY_END),
+			     keyNew ("user:/d", KEY_VALUE, "4", KEY_END),
+			     keyNew ("user:/e", KEY_VALUE, "5", KEY_END),
+			     // clang-format on
+			     KS_END);
+
+	Key * lookup = keyNew ("user:/c", KEY_END);
+	ElektraLookupHint hint = { 0, 0 };
+
+	succeed_if (ksLookupCached (NULL, lookup, 0, &hint) == NULL, "shouldn't accept NULL keyset");
+	succeed_if (ksLookupCached (ks, NULL, 0, &hint) == NULL, "shouldn't accept NULL key");
+
+	Key * found = ksLookupCached (ks, lookup, 0, &hint);
+	succeed_if (found != NULL && !strcmp (keyName (found), "user:/c"), "should find user:/c");
+	succeed_if (hint.generation != 0, "hint should be recorded");
+	size_t generation = hint.generation;
+
+	succeed_if (ksLookupCached (ks, lookup, 0, &hint) == found, "repeated lookup should hit the memo");
+	succeed_if (hint.generation == generation, "hit shouldn't change the hint");
+	succeed_if (ksLookupCached (ks, lookup, 0, NULL) == found, "should also work without a hint");
+
+	// value changes are not structural, the memo stays valid
+	keySetString (found, "33");
+	succeed_if (ksLookupCached (ks, lookup, 0, &hint) == found, "value change shouldn't invalidate the memo");
+
+	// inserting shifts positions and has to re-record the hint
+	ksAppendKey (ks, keyNew ("user:/aa", KEY_VALUE, "6", KEY_END));
+	succeed_if (ksLookupCached (ks, lookup, 0, &hint) == found, "should find user:/c after insert");
+	succeed_if (hint.generation != generation, "insert should re-record the hint");
+
+	// a memo of another name must not short-circuit the lookup
+	Key * lookupB = keyNew ("user:/b", KEY_END);
+	Key * foundB = ksLookupCached (ks, lookupB, 0, &hint);
+	succeed_if (foundB != NULL && !strcmp (keyName (foundB), "user:/b"), "should find user:/b despite the stale memo");
+
+	// a miss clears the hint
+	Key * lookupMissing = keyNew ("user:/nonexistent", KEY_END);
+	succeed_if (ksLookupCached (ks, lookupMissing, 0, &hint) == NULL, "shouldn't find user:/nonexistent");
+	succeed_if (hint.generation == 0, "miss should clear the hint");
+
+	// KDB_O_POP modifies the keyset and bypasses the memo
+	Key * popped = ksLookupCached (ks, lookupB, KDB_O_POP, &hint);
+	succeed_if (popped == foundB, "should pop user:/b");
+	succeed_if (hint.generation == 0, "POP shouldn't record a hint");
+	keyDel (popped);
+
+	keyDel (lookup);
+	keyDel (lookupB);
+	keyDel (lookupMissing);
+	ksDel (ks);
+}
+
+static int predicateValueIsOdd (Key * key, void * argument)
+{
+	(*(int *) argument)++;
+	return atoi (keyString (key)) % 2 != 0;
+}
+
+static int predicateAlways (Key * key ELEKTRA_UNUSED, void * argument ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static void test_ksRemoveIf (void)
+{
+	printf ("Test ksRemoveIf\n");
+
+	KeySet * ks = ksNew (6,
+			     // clang-format off
+			     keyNew ("user:/a", KEY_VALUE, "1", KEY_END),
+			     keyNew ("user:/b", KEY_VALUE, "2", KEY_END),
+			     keyNew ("user:/c", KEY_VALUE, "3", KEY_END),
+			     keyNew ("user:/d", KEY_VALUE, "4", KEY_END),
+			     keyNew ("user:/e", KEY_VALUE, "5", KEY_END),
+			     // clang-format on
+			     KS_END);
+
+	int calls = 0;
+	succeed_if (ksRemoveIf (NULL, predicateValueIsOdd, &calls) == -1, "shouldn't accept NULL");
+	succeed_if (ksRemoveIf (ks, NULL, NULL) == -1, "shouldn't accept NULL");
+
+	succeed_if (ksRemoveIf (ks, predicateValueIsOdd, &calls) == 3, "should remove three keys");
+	succeed_if (calls == 5, "predicate should be called once per key");
+	succeed_if (ksGetSize (ks) == 2, "wrong size");
+	succeed_if (ksLookupByName (ks, "user:/b", 0) != NULL, "user:/b should be kept");
+	succeed_if (ksLookupByName (ks, "user:/d", 0) != NULL, "user:/d should be kept");
+	succeed_if (ksLookupByName (ks, "user:/a", 0) == NULL, "user:/a should be removed");
+
+	calls = 0;
+	succeed_if (ksRemoveIf (ks, predicateValueIsOdd, &calls) == 0, "shouldn't remove anything");
+	succeed_if (calls == 2, "predicate should be called once per key");
+	succeed_if (ksGetSize (ks) == 2, "wrong size");
+
+	// keys still referenced elsewhere survive the removal
+	Key * shared = ksLookupByName (ks, "user:/b", 0);
+	keyIncRef (shared);
+	succeed_if (ksRemoveIf (ks, predicateAlways, NULL) == 2, "should remove the remaining keys");
+	succeed_if (ksGetSize (ks) == 0, "keyset should be empty");
+	succeed_if_same_string (keyString (shared), "2");
+	keyDecRef (shared);
+	keyDel (shared);
+
+	ksDel (ks);
+}
+
+static void test_ksRetainRange (void)
+{
+	printf ("Test ksRetainRange\n");
+
+	KeySet * ks = ksNew (8,
+			     // clang-format off
+			     keyNew ("user:/bar", KEY_VALUE, "1", KEY_END),
+			     keyNew ("user:/baz", KEY_VALUE, "2", KEY_END),
+			     keyNew ("user:/baz/a", KEY_VALUE, "3", KEY_END),
+			     keyNew ("user:/baz/b", KEY_VALUE, "4", KEY_END),
+			     keyNew ("user:/foo", KEY_VALUE, "5", KEY_END),
+			     // clang-format on
+			     KS_END);
+
+	succeed_if (ksRetainRange (NULL, 0, 0) == -1, "shouldn't accept NULL");
+	succeed_if (ksRetainRange (ks, -1, 2) == -1, "shouldn't accept negative start");
+	succeed_if (ksRetainRange (ks, 3, 2) == -1, "shouldn't accept end before start");
+	succeed_if (ksRetainRange (ks, 0, 6) == -1, "shouldn't accept end behind the keyset");
+
+	succeed_if (ksRetainRange (ks, 0, 5) == 0, "full range shouldn't remove anything");
+	succeed_if (ksGetSize (ks) == 5, "wrong size");
+
+	Key * root = keyNew ("user:/baz", KEY_END);
+	elektraCursor end;
+	elektraCursor start = ksFindHierarchy (ks, root, &end);
+	succeed_if (start == 1 && end == 4, "hierarchy should be present");
+	succeed_if (ksRetainRange (ks, start, end) == 2, "should remove two keys");
+	succeed_if (ksGetSize (ks) == 3, "wrong size");
+	succeed_if (ksLookupByName (ks, "user:/baz", 0) != NULL, "user:/baz should be kept");
+	succeed_if (ksLookupByName (ks, "user:/baz/b", 0) != NULL, "user:/baz/b should be kept");
+	succeed_if (ksLookupByName (ks, "user:/bar", 0) == NULL, "user:/bar should be removed");
+	succeed_if (ksLookupByName (ks, "user:/foo", 0) == NULL, "user:/foo should be removed");
+	keyDel (root);
+
+	succeed_if (ksRetainRange (ks, 0, 0) == 3, "empty range should clear the keyset");
+	succeed_if (ksGetSize (ks) == 0, "keyset should be empty");
+
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KS         TESTS\n");
@@ -464,6 +822,14 @@ int main (int argc, char ** argv)
 	test_ksNoAlloc ();
 	test_ksRename ();
 	test_ksFindHierarchy ();
+	test_ksFindNextChild ();
+	test_ksFindByMeta ();
+	test_ksLookupCached ();
+	test_ksRemoveIf ();
+	test_ksRetainRange ();
+	test_ksArena ();
+	test_ksCowDup ();
+	test_ksAppendBatch ();
 
 	printf ("\ntest_ks RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
@@ -208,8 +208,25 @@ void test_Invalidate (void)
 		exit_if_fail (ks->opmphm, "build opmphm");
 		succeed_if (opmphmIsBuild (ks->opmphm), "build opmphm");
 
-		// insert new one
-		succeed_if (ksAppendKey (ks, keyNew ("/k", KEY_END)) > 0, "invalidate");
+		// insert new one, goes to the side-table and keeps the OPMPHM build
+		succeed_if (ksAppendKey (ks, keyNew ("/k", KEY_END)) > 0, "not invalidate");
+
+		exit_if_fail (ks->opmphm, "build opmphm");
+		succeed_if (opmphmIsBuild (ks->opmphm), "empty opmphm");
+		succeed_if (ks->opmphmInsertCount == 1, "insert not recorded");
+
+		// both old and new keys must be found while the side-table is active
+		succeed_if (ksLookupByName (ks, "/a", KDB_O_OPMPHM), "old key not found");
+		succeed_if (ksLookupByName (ks, "/k", KDB_O_OPMPHM), "inserted key not found");
+		succeed_if (!ksLookupByName (ks, "/nothere", KDB_O_OPMPHM), "absent key found");
+
+		// overflowing the side-table discards the OPMPHM
+		for (int i = 0; i < OPMPHM_MAX_INSERTS; ++i)
+		{
+			char name[16];
+			snprintf (name, sizeof (name), "/n%d", i);
+			succeed_if (ksAppendKey (ks, keyNew (name, KEY_END)) > 0, "append failed");
+		}
 
 		exit_if_fail (ks->opmphm, "build opmphm");
 		succeed_if (!opmphmIsBuild (ks->opmphm), "empty opmphm");
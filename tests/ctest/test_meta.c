@@ -309,6 +309,63 @@ static void test_top (void)
 	ksDel (testCycleOrder3);
 	elektraFree (array);
 }
+static void test_orderRange (void)
+{
+	printf ("Test order range\n");
+
+	KeySet * ks = ksNew (10, keyNew ("user:/test/a", KEY_END), keyNew ("user:/test/b", KEY_END), keyNew ("user:/test/c", KEY_END),
+			     keyNew ("user:/test/d", KEY_END), KS_END);
+
+	succeed_if (elektraMetaOrderRange (ks, 0, 4, 0) == 4, "could not order the whole keyset");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 0), "order")), "#0");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 3), "order")), "#3");
+
+	succeed_if (elektraMetaOrderRange (ks, 1, 3, 10) == 2, "could not order a sub range");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 1), "order")), "#_10");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 2), "order")), "#_11");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 3), "order")), "#3");
+
+	succeed_if (elektraMetaOrderRange (ks, 2, 2, 0) == 0, "an empty range must succeed");
+	succeed_if (elektraMetaOrderRange (0, 0, 1, 0) == -1, "null pointer");
+	succeed_if (elektraMetaOrderRange (ks, -1, 1, 0) == -1, "negative start position");
+	succeed_if (elektraMetaOrderRange (ks, 0, 5, 0) == -1, "range beyond the keyset");
+	succeed_if (elektraMetaOrderRange (ks, 3, 1, 0) == -1, "reversed range");
+	succeed_if (elektraMetaOrderRange (ks, 0, 1, -1) == -1, "negative start index");
+
+	ksDel (ks);
+}
+
+static void test_copyRange (void)
+{
+	printf ("Test copy range\n");
+
+	Key * template = keyNew ("user:/test/template", KEY_META, "type", "string", KEY_META, "check/length/max", "80", KEY_END);
+	KeySet * ks = ksNew (10, keyNew ("user:/test/a", KEY_END), keyNew ("user:/test/b", KEY_META, "old", "1", KEY_END),
+			     keyNew ("user:/test/c", KEY_END), KS_END);
+
+	succeed_if (elektraMetaCopyRange (ks, 0, 3, template) == 3, "could not copy to the whole keyset");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 0), "type")), "string");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 1), "check/length/max")), "80");
+	succeed_if (keyGetMeta (ksAtCursor (ks, 1), "old") != 0, "existing metadata must be kept");
+	succeed_if (keyGetMeta (ksAtCursor (ks, 0), "type") == keyGetMeta (template, "type"), "the metadata is not shared");
+
+	// the copy must be repeatable without detaching the shared metadata
+	succeed_if (elektraMetaCopyRange (ks, 0, 3, template) == 3, "could not copy a second time");
+	succeed_if (keyGetMeta (ksAtCursor (ks, 2), "type") == keyGetMeta (template, "type"), "the metadata is not shared anymore");
+
+	// modifying one key must not affect the others
+	keySetMeta (ksAtCursor (ks, 1), "type", "long");
+	succeed_if_same_string (keyString (keyGetMeta (ksAtCursor (ks, 0), "type")), "string");
+	succeed_if_same_string (keyString (keyGetMeta (template, "type")), "string");
+
+	succeed_if (elektraMetaCopyRange (0, 0, 1, template) == -1, "null pointer");
+	succeed_if (elektraMetaCopyRange (ks, 0, 1, 0) == -1, "null pointer");
+	succeed_if (elektraMetaCopyRange (ks, 0, 4, template) == -1, "range beyond the keyset");
+
+	keyDel (template);
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KEY META     TESTS\n");
@@ -321,6 +378,8 @@ int main (int argc, char ** argv)
 
 	test_metaArrayToKS ();
 	test_top ();
+	test_orderRange ();
+	test_copyRange ();
 	printf ("\ntest_meta RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
 	return nbError;
@@ -754,6 +754,56 @@ static void test_userroot (void)
 	keyDel (mp);
 }
 
+static void test_finalize (void)
+{
+	printf ("Test finalized trie\n");
+
+	Trie * trie = test_insert (0, "", "");
+	trie = test_insert (trie, "user:/tests/hosts", "hosts");
+	trie = test_insert (trie, "user:/tests/hosts/below", "below");
+	trie = test_insert (trie, "user:/umlauts/", "/");
+	trie = test_insert (trie, "user:/umlauts/a/", "a");
+	trie = test_insert (trie, "system:/", "s");
+
+	exit_if_fail (trie, "trie was not build up successfully");
+
+	const char * names[] = { "/",
+				 "user:/",
+				 "user:/tests",
+				 "user:/tests/hosts",
+				 "user:/tests/hosts/below",
+				 "user:/tests/hosts/other/deep/below",
+				 "user:/tests/hosts/below/other/deep/below",
+				 "user:/umlauts",
+				 "user:/umlauts/a",
+				 "user:/umlauts/b",
+				 "system:/anywhere/deep/below",
+				 0 };
+
+	Backend * before[sizeof (names) / sizeof (names[0])];
+	for (size_t i = 0; names[i]; ++i)
+	{
+		before[i] = trieLookup (trie, names[i]);
+	}
+
+	succeed_if (trie->flat == NULL, "flat copy should only exist after trieFinalize");
+	trieFinalize (trie);
+	exit_if_fail (trie->flat, "trieFinalize should build the flat copy");
+
+	for (size_t i = 0; names[i]; ++i)
+	{
+		succeed_if (trieLookup (trie, names[i]) == before[i], "finalized trie should find the same backend");
+	}
+
+	trieFinalize (trie); // second call should be a no-op
+	succeed_if (trie->flat != NULL, "flat copy should survive another trieFinalize");
+
+	trie = test_insert (trie, "user:/other", "other");
+	succeed_if (trie->flat == NULL, "trieInsert should discard the flat copy");
+
+	trieClose (trie, 0);
+}
+
 
 int main (int argc, char ** argv)
 {
@@ -774,6 +824,7 @@ int main (int argc, char ** argv)
 	test_double ();
 	test_emptyvalues ();
 	test_userroot ();
+	test_finalize ();
 
 	printf ("\ntest_trie RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
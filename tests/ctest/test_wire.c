@@ -0,0 +1,242 @@
+/**
+ * @file
+ *
+ * @brief
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbwire.h>
+
+#include "tests.h"
+
+static void compare_decoded (KeySet * expected, KeySet * actual)
+{
+	succeed_if (actual != NULL, "decoding failed");
+	if (actual == NULL) return;
+
+	succeed_if (ksGetSize (actual) == ksGetSize (expected), "not same number of keys");
+
+	ssize_t size = ksGetSize (expected);
+	for (elektraCursor it = 0; it < size && it < ksGetSize (actual); ++it)
+	{
+		Key * e = ksAtCursor (expected, it);
+		Key * a = ksAtCursor (actual, it);
+
+		succeed_if_same_string (keyName (a), keyName (e));
+		succeed_if (keyIsBinary (a) == keyIsBinary (e), "value type changed");
+		succeed_if (keyGetValueSize (a) == keyGetValueSize (e), "value size changed");
+		if (keyValue (e) != NULL)
+		{
+			succeed_if (keyValue (a) != NULL && memcmp (keyValue (a), keyValue (e), keyGetValueSize (e)) == 0,
+				    "value changed");
+		}
+
+		KeySet * expectedMeta = keyMeta (e);
+		succeed_if (ksGetSize (keyMeta (a)) == ksGetSize (expectedMeta), "not same number of metakeys");
+		for (elektraCursor m = 0; m < ksGetSize (expectedMeta); ++m)
+		{
+			const Key * metaKey = ksAtCursor (expectedMeta, m);
+			const Key * actualMeta = ksLookupByName (keyMeta (a), keyName (metaKey), 0);
+			succeed_if (actualMeta != NULL, "metakey missing");
+			if (actualMeta != NULL)
+			{
+				succeed_if_same_string (keyString (actualMeta), keyString (metaKey));
+			}
+		}
+	}
+}
+
+static void test_roundtrip (void)
+{
+	printf ("roundtrip\n");
+
+	Key * parentKey = keyNew ("user:/tests/wire", KEY_END);
+	KeySet * ks = ksNew (10, keyNew ("user:/tests/wire", KEY_VALUE, "root value", KEY_END),
+			     keyNew ("user:/tests/wire/a", KEY_VALUE, "", KEY_END),
+			     keyNew ("user:/tests/wire/a/deep/down/key", KEY_VALUE, "deep", KEY_META, "type", "string", KEY_END),
+			     keyNew ("user:/tests/wire/a/deep/down/other", KEY_META, "type", "string", KEY_META, "check/email", "",
+				     KEY_END),
+			     keyNew ("user:/tests/wire/binary", KEY_BINARY, KEY_SIZE, 4, KEY_VALUE, "\x01\x00\x02\x03", KEY_END),
+			     keyNew ("user:/tests/wire/binary/empty", KEY_BINARY, KEY_SIZE, 0, KEY_END), KS_END);
+
+	void * buffer = NULL;
+	size_t bufferSize = 0;
+	ssize_t messageSize = elektraWireEncode (ks, parentKey, &buffer, &bufferSize);
+	succeed_if (messageSize > 0, "encoding failed");
+	succeed_if (bufferSize >= (size_t) messageSize, "message larger than buffer");
+
+	KeySet * decoded = elektraWireDecode (buffer, messageSize, parentKey);
+	compare_decoded (ks, decoded);
+	if (decoded != NULL) ksDel (decoded);
+
+	elektraFree (buffer);
+	ksDel (ks);
+	keyDel (parentKey);
+}
+
+static void test_reparent (void)
+{
+	printf ("reparent\n");
+
+	Key * parentKey = keyNew ("system:/source", KEY_END);
+	KeySet * ks = ksNew (2, keyNew ("system:/source/host", KEY_VALUE, "localhost", KEY_END),
+			     keyNew ("system:/source/port", KEY_VALUE, "8080", KEY_END), KS_END);
+
+	void * buffer = NULL;
+	size_t bufferSize = 0;
+	ssize_t messageSize = elektraWireEncode (ks, parentKey, &buffer, &bufferSize);
+	succeed_if (messageSize > 0, "encoding failed");
+
+	// decode below a different parent key, like a fan-out receiver would
+	Key * targetKey = keyNew ("user:/target/tree", KEY_END);
+	KeySet * decoded = elektraWireDecode (buffer, messageSize, targetKey);
+	exit_if_fail (decoded != NULL, "decoding failed");
+
+	succeed_if (ksGetSize (decoded) == 2, "not same number of keys");
+	Key * host = ksLookupByName (decoded, "user:/target/tree/host", 0);
+	succeed_if (host != NULL, "host key missing");
+	if (host != NULL) succeed_if_same_string (keyString (host), "localhost");
+
+	ksDel (decoded);
+	keyDel (targetKey);
+	elektraFree (buffer);
+	ksDel (ks);
+	keyDel (parentKey);
+}
+
+static void test_full_names (void)
+{
+	printf ("full names\n");
+
+	KeySet * ks = ksNew (3, keyNew ("system:/hosts/example", KEY_VALUE, "127.0.0.1", KEY_END),
+			     keyNew ("user:/hosts/example", KEY_VALUE, "192.168.0.1", KEY_END), KS_END);
+
+	void * buffer = NULL;
+	size_t bufferSize = 0;
+	ssize_t messageSize = elektraWireEncode (ks, NULL, &buffer, &bufferSize);
+	succeed_if (messageSize > 0, "encoding failed");
+
+	KeySet * decoded = elektraWireDecode (buffer, messageSize, NULL);
+	compare_decoded (ks, decoded);
+	if (decoded != NULL) ksDel (decoded);
+
+	elektraFree (buffer);
+	ksDel (ks);
+}
+
+static void test_buffer_reuse (void)
+{
+	printf ("buffer reuse\n");
+
+	Key * parentKey = keyNew ("user:/tests/wire", KEY_END);
+
+	void * buffer = NULL;
+	size_t bufferSize = 0;
+
+	KeySet * large = ksNew (0, KS_END);
+	for (int i = 0; i < 1000; ++i)
+	{
+		char name[64];
+		snprintf (name, sizeof (name), "user:/tests/wire/dir%d/key%d", i % 10, i);
+		ksAppendKey (large, keyNew (name, KEY_VALUE, "value", KEY_END));
+	}
+
+	ssize_t messageSize = elektraWireEncode (large, parentKey, &buffer, &bufferSize);
+	succeed_if (messageSize > 0, "encoding failed");
+	size_t allocAfterLarge = bufferSize;
+
+	// a smaller message must reuse the buffer without reallocating
+	KeySet * small = ksNew (1, keyNew ("user:/tests/wire/key", KEY_VALUE, "value", KEY_END), KS_END);
+	ssize_t smallSize = elektraWireEncode (small, parentKey, &buffer, &bufferSize);
+	succeed_if (smallSize > 0, "encoding failed");
+	succeed_if (bufferSize == allocAfterLarge, "buffer was reallocated for a smaller message");
+	succeed_if (smallSize < messageSize, "smaller message not smaller");
+
+	KeySet * decoded = elektraWireDecode (buffer, smallSize, parentKey);
+	compare_decoded (small, decoded);
+	if (decoded != NULL) ksDel (decoded);
+
+	elektraFree (buffer);
+	ksDel (small);
+	ksDel (large);
+	keyDel (parentKey);
+}
+
+static void test_empty (void)
+{
+	printf ("empty\n");
+
+	Key * parentKey = keyNew ("user:/tests/wire", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+
+	void * buffer = NULL;
+	size_t bufferSize = 0;
+	ssize_t messageSize = elektraWireEncode (ks, parentKey, &buffer, &bufferSize);
+	succeed_if (messageSize > 0, "encoding failed");
+
+	KeySet * decoded = elektraWireDecode (buffer, messageSize, parentKey);
+	succeed_if (decoded != NULL, "decoding failed");
+	if (decoded != NULL)
+	{
+		succeed_if (ksGetSize (decoded) == 0, "empty keyset not empty after roundtrip");
+		ksDel (decoded);
+	}
+
+	elektraFree (buffer);
+	ksDel (ks);
+	keyDel (parentKey);
+}
+
+static void test_invalid (void)
+{
+	printf ("invalid\n");
+
+	Key * parentKey = keyNew ("user:/tests/wire", KEY_END);
+	KeySet * ks = ksNew (3, keyNew ("user:/tests/wire/a", KEY_VALUE, "value", KEY_META, "type", "string", KEY_END),
+			     keyNew ("user:/tests/wire/b", KEY_META, "type", "string", KEY_END), KS_END);
+
+	void * buffer = NULL;
+	size_t bufferSize = 0;
+	ssize_t messageSize = elektraWireEncode (ks, parentKey, &buffer, &bufferSize);
+	exit_if_fail (messageSize > 0, "encoding failed");
+
+	succeed_if (elektraWireDecode (NULL, 0, parentKey) == NULL, "accepted NULL buffer");
+	succeed_if (elektraWireDecode ("nonsense", sizeof ("nonsense"), parentKey) == NULL, "accepted bad magic");
+
+	// any truncation must be rejected, not decoded into a partial keyset
+	for (ssize_t cut = 0; cut < messageSize; ++cut)
+	{
+		KeySet * decoded = elektraWireDecode (buffer, cut, parentKey);
+		succeed_if (decoded == NULL, "accepted truncated message");
+		if (decoded != NULL) ksDel (decoded);
+	}
+
+	// keys outside the parent key cannot be encoded relative to it
+	KeySet * outside = ksNew (1, keyNew ("system:/elsewhere", KEY_VALUE, "value", KEY_END), KS_END);
+	succeed_if (elektraWireEncode (outside, parentKey, &buffer, &bufferSize) == -1, "encoded key outside the parent key");
+	ksDel (outside);
+
+	elektraFree (buffer);
+	ksDel (ks);
+	keyDel (parentKey);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("   WIRE   TESTS\n");
+	printf ("================\n\n");
+
+	init (argc, argv);
+
+	test_roundtrip ();
+	test_reparent ();
+	test_full_names ();
+	test_buffer_reuse ();
+	test_empty ();
+	test_invalid ();
+
+	print_result ("test_wire");
+
+	return nbError;
+}
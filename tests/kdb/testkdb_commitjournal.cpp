@@ -0,0 +1,196 @@
+/**
+ * @file
+ *
+ * @brief Tests for the commit journal of multi-backend kdbSet() transactions
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <keysetio.hpp>
+
+#include <gtest/gtest-elektra.h>
+
+#include <kdbprivate.h> // for ELEKTRA_COMMIT_JOURNAL_*
+
+#include <fstream>
+#include <sstream>
+
+class CommitJournal : public ::testing::Test
+{
+protected:
+	static const std::string rootA;
+	static const std::string rootB;
+	static const std::string configFileA;
+	static const std::string configFileB;
+
+	testing::Namespaces namespaces;
+	testing::MountpointPtr mpA;
+	testing::MountpointPtr mpB;
+
+	CommitJournal () : namespaces ()
+	{
+	}
+
+	virtual void SetUp () override
+	{
+		mpA.reset (new testing::Mountpoint (rootA, configFileA));
+		mpB.reset (new testing::Mountpoint (rootB, configFileB));
+	}
+
+	virtual void TearDown () override
+	{
+		::unlink (journalFor (mpA->userConfigFile).c_str ());
+		::unlink (journalFor (mpB->userConfigFile).c_str ());
+		mpB.reset ();
+		mpA.reset ();
+	}
+
+	// one kdbSet() spanning both mounted backends
+	void commitBoth (const std::string & value)
+	{
+		using namespace kdb;
+		KDB kdb;
+		KeySet ks;
+		Key parentKey ("user:/tests", KEY_END);
+		kdb.get (ks, parentKey);
+		ks.append (Key ("user:" + rootA + "key", KEY_VALUE, value.c_str (), KEY_END));
+		ks.append (Key ("user:" + rootB + "key", KEY_VALUE, value.c_str (), KEY_END));
+		kdb.set (ks, parentKey);
+	}
+
+	static std::string journalFor (const std::string & configFile)
+	{
+		return configFile + ELEKTRA_COMMIT_JOURNAL_SUFFIX;
+	}
+
+	static std::string readFile (const std::string & name)
+	{
+		std::ifstream in (name, std::ios::binary);
+		std::ostringstream content;
+		content << in.rdbuf ();
+		return content.str ();
+	}
+
+	static void writeFile (const std::string & name, const std::string & content)
+	{
+		std::ofstream out (name, std::ios::binary | std::ios::trunc);
+		out << content;
+		ASSERT_TRUE (out.good ()) << "could not write " << name;
+	}
+
+	static bool exists (const std::string & name)
+	{
+		return std::ifstream (name).good ();
+	}
+};
+
+const std::string CommitJournal::rootA = "/tests/commitjournal/";
+const std::string CommitJournal::rootB = "/tests/commitjournalother/";
+const std::string CommitJournal::configFileA = "kdbFileCommitJournal.dump";
+const std::string CommitJournal::configFileB = "kdbFileCommitJournalOther.dump";
+
+TEST_F (CommitJournal, SuccessfulCommitLeavesNoJournal)
+{
+	commitBoth ("value");
+
+	EXPECT_TRUE (exists (mpA->userConfigFile));
+	EXPECT_TRUE (exists (mpB->userConfigFile));
+	EXPECT_FALSE (exists (journalFor (mpA->userConfigFile))) << "journal not removed after successful commit";
+	EXPECT_FALSE (exists (journalFor (mpB->userConfigFile))) << "journal not removed after successful commit";
+}
+
+TEST_F (CommitJournal, CrashJournalIsReplayedOnNextAccess)
+{
+	// capture valid configuration files for both states of the transaction
+	commitBoth ("new");
+	const std::string newA = readFile (mpA->userConfigFile);
+	const std::string newB = readFile (mpB->userConfigFile);
+	commitBoth ("old");
+
+	// fake a crash between the two renames: backend A already holds the
+	// new state, backend B still has its temporary file pending
+	writeFile (mpA->userConfigFile, newA);
+	const std::string tempA = mpA->userConfigFile + ".tmp.crash";
+	const std::string tempB = mpB->userConfigFile + ".tmp.crash";
+	writeFile (tempB, newB);
+
+	const std::string journal = std::string (ELEKTRA_COMMIT_JOURNAL_HEADER) + "\n" + tempA + "\n" + mpA->userConfigFile + "\n" +
+				    tempB + "\n" + mpB->userConfigFile + "\n";
+	writeFile (journalFor (mpA->userConfigFile), journal);
+	writeFile (journalFor (mpB->userConfigFile), journal);
+
+	// the next access finishes the transaction: the already renamed pair
+	// is skipped, the pending one is renamed, the journal copies vanish
+	using namespace kdb;
+	KDB kdb;
+	KeySet ks;
+	Key parentKey ("user:/tests", KEY_END);
+	kdb.get (ks, parentKey);
+
+	EXPECT_EQ (readFile (mpB->userConfigFile), newB) << "pending rename was not replayed";
+	EXPECT_FALSE (exists (tempB));
+	EXPECT_FALSE (exists (journalFor (mpA->userConfigFile))) << "journal copy not removed after replay";
+	EXPECT_FALSE (exists (journalFor (mpB->userConfigFile))) << "journal copy not removed after replay";
+
+	Key keyA = ks.lookup ("user:" + rootA + "key");
+	Key keyB = ks.lookup ("user:" + rootB + "key");
+	ASSERT_TRUE (keyA);
+	ASSERT_TRUE (keyB);
+	EXPECT_EQ (keyA.getString (), "new");
+	EXPECT_EQ (keyB.getString (), "new") << "replayed state not visible";
+}
+
+TEST_F (CommitJournal, CorruptJournalIsIgnored)
+{
+	commitBoth ("value");
+	writeFile (journalFor (mpA->userConfigFile), "not a journal\n");
+
+	using namespace kdb;
+	KDB kdb;
+	KeySet ks;
+	Key parentKey ("user:" + rootA, KEY_END);
+	kdb.get (ks, parentKey);
+
+	// the corrupt journal must neither break the read nor touch the data
+	Key found = ks.lookup ("user:" + rootA + "key");
+	ASSERT_TRUE (found);
+	EXPECT_EQ (found.getString (), "value");
+}
+
+TEST_F (CommitJournal, ParallelSetRoundTrip)
+{
+	using namespace kdb;
+	{
+		ckdb::KeySet * contract = ckdb::ksNew (1, ckdb::keyNew ("system:/elektra/contract/parallelset", KEY_END), KS_END);
+		ckdb::Key * parentKey = ckdb::keyNew ("user:/tests", KEY_END);
+		ckdb::KDB * handle = ckdb::kdbOpen (contract, parentKey);
+		ckdb::ksDel (contract);
+		ASSERT_NE (handle, nullptr) << "could not open handle with parallelset contract";
+
+		ckdb::KeySet * ks = ckdb::ksNew (0, KS_END);
+		ASSERT_NE (ckdb::kdbGet (handle, ks, parentKey), -1);
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + rootA + "key").c_str (), KEY_VALUE, "parallel", KEY_END));
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + rootB + "key").c_str (), KEY_VALUE, "parallel", KEY_END));
+		ASSERT_EQ (ckdb::kdbSet (handle, ks, parentKey), 1);
+
+		ckdb::ksDel (ks);
+		ckdb::kdbClose (handle, parentKey);
+		ckdb::keyDel (parentKey);
+	}
+
+	// an independent session reads back what the parallel commit wrote
+	KDB kdb;
+	KeySet ks;
+	Key parentKey ("user:/tests", KEY_END);
+	kdb.get (ks, parentKey);
+	Key keyA = ks.lookup ("user:" + rootA + "key");
+	Key keyB = ks.lookup ("user:" + rootB + "key");
+	ASSERT_TRUE (keyA);
+	ASSERT_TRUE (keyB);
+	EXPECT_EQ (keyA.getString (), "parallel");
+	EXPECT_EQ (keyB.getString (), "parallel");
+
+	EXPECT_FALSE (exists (journalFor (mpA->userConfigFile)));
+	EXPECT_FALSE (exists (journalFor (mpB->userConfigFile)));
+}
@@ -0,0 +1,245 @@
+/**
+ * @file
+ *
+ * @brief Tests for the change journal of kdbSet() and kdbJournalRead()
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <keysetio.hpp>
+
+#include <gtest/gtest-elektra.h>
+
+#include <kdbprivate.h> // for kdbJournalRead()
+
+#include <dirent.h>
+
+#include <cstdio>
+
+class Journal : public ::testing::Test
+{
+protected:
+	static const std::string testRoot;
+	static const std::string configFile;
+
+	testing::Namespaces namespaces;
+	testing::MountpointPtr mp;
+	std::string journalDir;
+
+	ckdb::KDB * handle = nullptr;
+	ckdb::Key * parent = nullptr;
+	ckdb::KeySet * workingSet = nullptr;
+
+	Journal () : namespaces ()
+	{
+	}
+
+	virtual void SetUp () override
+	{
+		mp.reset (new testing::Mountpoint (testRoot, configFile));
+
+		char dirTemplate[] = "/tmp/elektra-test-journal-XXXXXX";
+		ASSERT_NE (mkdtemp (dirTemplate), nullptr) << "could not create journal directory";
+		journalDir = dirTemplate;
+
+		ckdb::KeySet * contract =
+			ckdb::ksNew (1, ckdb::keyNew ("system:/elektra/contract/journal", KEY_VALUE, journalDir.c_str (), KEY_END), KS_END);
+		parent = ckdb::keyNew (("user:" + testRoot).c_str (), KEY_END);
+		handle = ckdb::kdbOpen (contract, parent);
+		ckdb::ksDel (contract);
+		ASSERT_NE (handle, nullptr) << "could not open handle with journal contract";
+		workingSet = ckdb::ksNew (0, KS_END);
+	}
+
+	virtual void TearDown () override
+	{
+		if (workingSet != nullptr) ckdb::ksDel (workingSet);
+		if (handle != nullptr) ckdb::kdbClose (handle, parent);
+		if (parent != nullptr) ckdb::keyDel (parent);
+
+		DIR * dir = opendir (journalDir.c_str ());
+		if (dir != nullptr)
+		{
+			struct dirent * entry;
+			while ((entry = readdir (dir)) != nullptr)
+			{
+				if (entry->d_name[0] == '.') continue;
+				std::remove ((journalDir + "/" + entry->d_name).c_str ());
+			}
+			closedir (dir);
+			rmdir (journalDir.c_str ());
+		}
+
+		mp.reset ();
+	}
+
+	// one kdbGet() + kdbSet() cycle applying @p change to the working
+	// keyset, which persists across commits like in a real application
+	void commit (std::function<void (ckdb::KeySet *)> change)
+	{
+		ASSERT_NE (ckdb::kdbGet (handle, workingSet, parent), -1) << "could not retrieve keys";
+		change (workingSet);
+		ASSERT_EQ (ckdb::kdbSet (handle, workingSet, parent), 1) << "could not store keys";
+	}
+
+	std::string journalFile ()
+	{
+		// mirrors elektraChangeJournalFileName()
+		std::string escaped = ckdb::keyName (parent);
+		for (auto & c : escaped)
+		{
+			if (c == '/' || c == ':' || c == '\\') c = '_';
+		}
+		return journalDir + "/" + escaped + ".changes";
+	}
+};
+
+const std::string Journal::configFile = "kdbFileJournal.dump";
+const std::string Journal::testRoot = "/tests/journal/";
+
+TEST_F (Journal, RoundTrip)
+{
+	using namespace kdb;
+	commit ([&] (ckdb::KeySet * ks) {
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + testRoot + "k2").c_str (), KEY_VALUE, "v2", KEY_END));
+	});
+
+	kdb_unsigned_long_long_t lastSeq = 0;
+	ckdb::KeySet * changes = ckdb::kdbJournalRead (handle, parent, 0, &lastSeq);
+	ASSERT_NE (changes, nullptr) << "no journal was written";
+	EXPECT_EQ (lastSeq, 1u);
+	EXPECT_EQ (ckdb::ksGetSize (changes), 2);
+
+	ckdb::Key * changed = ckdb::ksLookupByName (changes, ("user:" + testRoot + "k1").c_str (), 0);
+	ASSERT_NE (changed, nullptr) << "changed path missing from journal";
+	EXPECT_STREQ (ckdb::keyString (ckdb::keyGetMeta (changed, "journal/seq")), "1");
+	EXPECT_NE (ckdb::keyGetMeta (changed, "journal/hash"), nullptr) << "value hash missing";
+	EXPECT_EQ (ckdb::keyGetMeta (changed, "journal/removed"), nullptr);
+	ckdb::ksDel (changes);
+
+	// a second commit only changing k1 yields one new record
+	commit ([&] (ckdb::KeySet * ks) {
+		ckdb::keySetString (ckdb::ksLookupByName (ks, ("user:" + testRoot + "k1").c_str (), 0), "changed");
+	});
+
+	changes = ckdb::kdbJournalRead (handle, parent, lastSeq, &lastSeq);
+	ASSERT_NE (changes, nullptr) << "could not resume reading the journal";
+	EXPECT_EQ (lastSeq, 2u);
+	ASSERT_EQ (ckdb::ksGetSize (changes), 1);
+	changed = ckdb::ksLookupByName (changes, ("user:" + testRoot + "k1").c_str (), 0);
+	ASSERT_NE (changed, nullptr) << "changed path missing from journal";
+	EXPECT_STREQ (ckdb::keyString (ckdb::keyGetMeta (changed, "journal/seq")), "2");
+	ckdb::ksDel (changes);
+
+	// reading from the beginning keeps only the newest record per path
+	changes = ckdb::kdbJournalRead (handle, parent, 0, &lastSeq);
+	ASSERT_NE (changes, nullptr);
+	EXPECT_EQ (ckdb::ksGetSize (changes), 2);
+	changed = ckdb::ksLookupByName (changes, ("user:" + testRoot + "k1").c_str (), 0);
+	ASSERT_NE (changed, nullptr);
+	EXPECT_STREQ (ckdb::keyString (ckdb::keyGetMeta (changed, "journal/seq")), "2");
+	ckdb::ksDel (changes);
+
+	// caught up: nothing newer than lastSeq
+	changes = ckdb::kdbJournalRead (handle, parent, lastSeq, nullptr);
+	ASSERT_NE (changes, nullptr);
+	EXPECT_EQ (ckdb::ksGetSize (changes), 0);
+	ckdb::ksDel (changes);
+}
+
+TEST_F (Journal, Removal)
+{
+	using namespace kdb;
+	commit ([&] (ckdb::KeySet * ks) {
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + testRoot + "k2").c_str (), KEY_VALUE, "v2", KEY_END));
+	});
+	commit ([&] (ckdb::KeySet * ks) { ckdb::keyDel (ckdb::ksLookup (ks, ckdb::keyNew (("user:" + testRoot + "k2").c_str (), KEY_END), KDB_O_POP | KDB_O_DEL)); });
+
+	kdb_unsigned_long_long_t lastSeq = 0;
+	ckdb::KeySet * changes = ckdb::kdbJournalRead (handle, parent, 1, &lastSeq);
+	ASSERT_NE (changes, nullptr) << "could not read the journal";
+	EXPECT_EQ (lastSeq, 2u);
+
+	// a removal cannot name the removed keys, the mountpoint key carries
+	// the marker for a full comparison instead
+	ckdb::Key * marker = ckdb::ksLookupByName (changes, ("user:" + testRoot).c_str (), 0);
+	ASSERT_NE (marker, nullptr) << "removal marker missing" << kdb::KeySet (ckdb::ksDup (changes));
+	EXPECT_STREQ (ckdb::keyString (ckdb::keyGetMeta (marker, "journal/removed")), "1");
+	ckdb::ksDel (changes);
+}
+
+TEST_F (Journal, TornRecord)
+{
+	using namespace kdb;
+	commit ([&] (ckdb::KeySet * ks) {
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	});
+
+	// fake a crash in the middle of an append: a record header promising
+	// far more payload than the file holds
+	FILE * file = fopen (journalFile ().c_str (), "ab");
+	ASSERT_NE (file, nullptr) << "journal file missing";
+	const unsigned char torn[] = { (100 << 1) | 1, 'g', 'a', 'r', 'b', 'a', 'g', 'e' };
+	ASSERT_EQ (fwrite (torn, 1, sizeof (torn), file), sizeof (torn));
+	fclose (file);
+
+	// the torn tail is ignored, the intact records are still delivered
+	kdb_unsigned_long_long_t lastSeq = 0;
+	ckdb::KeySet * changes = ckdb::kdbJournalRead (handle, parent, 0, &lastSeq);
+	ASSERT_NE (changes, nullptr) << "torn tail made the whole journal unreadable";
+	EXPECT_EQ (lastSeq, 1u);
+	EXPECT_EQ (ckdb::ksGetSize (changes), 1);
+	ckdb::ksDel (changes);
+
+	// the next commit overwrites the torn tail instead of extending it
+	commit ([&] (ckdb::KeySet * ks) {
+		ckdb::keySetString (ckdb::ksLookupByName (ks, ("user:" + testRoot + "k1").c_str (), 0), "changed");
+	});
+
+	changes = ckdb::kdbJournalRead (handle, parent, 0, &lastSeq);
+	ASSERT_NE (changes, nullptr) << "journal unreadable after recovered append";
+	EXPECT_EQ (lastSeq, 2u);
+	EXPECT_EQ (ckdb::ksGetSize (changes), 1);
+	ckdb::Key * changed = ckdb::ksLookupByName (changes, ("user:" + testRoot + "k1").c_str (), 0);
+	ASSERT_NE (changed, nullptr);
+	EXPECT_STREQ (ckdb::keyString (ckdb::keyGetMeta (changed, "journal/seq")), "2");
+	ckdb::ksDel (changes);
+}
+
+TEST_F (Journal, CorruptHeader)
+{
+	using namespace kdb;
+	commit ([&] (ckdb::KeySet * ks) {
+		ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	});
+
+	FILE * file = fopen (journalFile ().c_str (), "r+b");
+	ASSERT_NE (file, nullptr) << "journal file missing";
+	ASSERT_EQ (fwrite ("XXXX", 1, 4, file), 4u);
+	fclose (file);
+
+	// an unreadable journal is reported as NULL, never as fake data
+	kdb_unsigned_long_long_t lastSeq = 0;
+	EXPECT_EQ (ckdb::kdbJournalRead (handle, parent, 0, &lastSeq), nullptr) << "corrupt journal was not rejected";
+
+	// the next commit starts the journal over
+	commit ([&] (ckdb::KeySet * ks) {
+		ckdb::keySetString (ckdb::ksLookupByName (ks, ("user:" + testRoot + "k1").c_str (), 0), "changed");
+	});
+
+	ckdb::KeySet * changes = ckdb::kdbJournalRead (handle, parent, 0, &lastSeq);
+	ASSERT_NE (changes, nullptr) << "journal was not started over";
+	EXPECT_EQ (ckdb::ksGetSize (changes), 1);
+	ckdb::ksDel (changes);
+}
+
+TEST_F (Journal, NotConfigured)
+{
+	using namespace kdb;
+	KDB plain; // no contract, no journal
+	Key parentKey ("user:" + testRoot, KEY_END);
+	EXPECT_EQ (ckdb::kdbJournalRead (plain.getKdb (), *parentKey, 0, nullptr), nullptr);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file
+ *
+ * @brief Tests for kdbGetMulti()
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <keysetio.hpp>
+
+#include <gtest/gtest-elektra.h>
+
+#include <kdbprivate.h> // for kdbGetMulti()
+
+class Multi : public ::testing::Test
+{
+protected:
+	static const std::string testRoot;
+	static const std::string otherRoot;
+	static const std::string configFile;
+	static const std::string otherConfigFile;
+
+	testing::Namespaces namespaces;
+	testing::MountpointPtr mp;
+	testing::MountpointPtr otherMp;
+
+	Multi () : namespaces ()
+	{
+	}
+
+	virtual void SetUp () override
+	{
+		mp.reset (new testing::Mountpoint (testRoot, configFile));
+		otherMp.reset (new testing::Mountpoint (otherRoot, otherConfigFile));
+	}
+
+	virtual void TearDown () override
+	{
+		otherMp.reset ();
+		mp.reset ();
+	}
+
+	void writeInitialData ()
+	{
+		using namespace kdb;
+		KDB kdb;
+		KeySet ks;
+		kdb.get (ks, "/tests");
+		ks.append (Key ("user:" + testRoot + "sub1/key", KEY_VALUE, "one", KEY_END));
+		ks.append (Key ("user:" + testRoot + "sub1/other", KEY_VALUE, "two", KEY_END));
+		ks.append (Key ("user:" + testRoot + "sub2/key", KEY_VALUE, "three", KEY_END));
+		ks.append (Key ("user:" + otherRoot + "key", KEY_VALUE, "four", KEY_END));
+		kdb.set (ks, "/tests");
+	}
+};
+
+const std::string Multi::configFile = "kdbFileMulti.dump";
+const std::string Multi::otherConfigFile = "kdbFileMultiOther.dump";
+const std::string Multi::testRoot = "/tests/multi/";
+const std::string Multi::otherRoot = "/tests/multiother/";
+
+TEST_F (Multi, DistinctBackends)
+{
+	using namespace kdb;
+	writeInitialData ();
+
+	KDB kdb;
+	Key parentA ("user:" + testRoot, KEY_END);
+	Key parentB ("user:" + otherRoot, KEY_END);
+	KeySet resultA;
+	KeySet resultB;
+
+	ckdb::Key * parents[2] = { *parentA, *parentB };
+	ckdb::KeySet * results[2] = { resultA.getKeySet (), resultB.getKeySet () };
+	ASSERT_EQ (ckdb::kdbGetMulti (kdb.getKdb (), parents, 2, results), 1) << "could not retrieve keys";
+
+	EXPECT_EQ (resultA.size (), 3) << "wrong keys for first parent" << resultA;
+	EXPECT_EQ (resultB.size (), 1) << "wrong keys for second parent" << resultB;
+	EXPECT_EQ (resultA.lookup ("user:" + testRoot + "sub1/key").getString (), "one");
+	EXPECT_EQ (resultB.lookup ("user:" + otherRoot + "key").getString (), "four");
+	EXPECT_FALSE (resultA.lookup ("user:" + otherRoot + "key")) << "key of other backend leaked into result" << resultA;
+}
+
+TEST_F (Multi, OverlappingBackends)
+{
+	using namespace kdb;
+	writeInitialData ();
+
+	KDB kdb;
+	// the first two parents share one backend, the third lives in another
+	Key parentA ("user:" + testRoot + "sub1", KEY_END);
+	Key parentB ("user:" + testRoot + "sub2", KEY_END);
+	Key parentC ("user:" + otherRoot, KEY_END);
+	KeySet resultA;
+	KeySet resultB;
+	KeySet resultC;
+
+	ckdb::Key * parents[3] = { *parentA, *parentB, *parentC };
+	ckdb::KeySet * results[3] = { resultA.getKeySet (), resultB.getKeySet (), resultC.getKeySet () };
+	ASSERT_EQ (ckdb::kdbGetMulti (kdb.getKdb (), parents, 3, results), 1) << "could not retrieve keys";
+
+	EXPECT_EQ (resultA.size (), 2) << "wrong keys for first parent" << resultA;
+	EXPECT_EQ (resultB.size (), 1) << "wrong keys for second parent" << resultB;
+	EXPECT_EQ (resultC.size (), 1) << "wrong keys for third parent" << resultC;
+	EXPECT_EQ (resultA.lookup ("user:" + testRoot + "sub1/other").getString (), "two");
+	EXPECT_EQ (resultB.lookup ("user:" + testRoot + "sub2/key").getString (), "three");
+	EXPECT_FALSE (resultA.lookup ("user:" + testRoot + "sub2/key")) << "keys of the shared backend were not distributed correctly"
+								       << resultA;
+	EXPECT_FALSE (resultB.lookup ("user:" + testRoot + "sub1/key")) << "keys of the shared backend were not distributed correctly"
+								       << resultB;
+}
+
+TEST_F (Multi, NoUpdate)
+{
+	using namespace kdb;
+	writeInitialData ();
+
+	KDB kdb;
+	Key parentA ("user:" + testRoot, KEY_END);
+	Key parentB ("user:" + otherRoot, KEY_END);
+	KeySet resultA;
+	KeySet resultB;
+
+	ckdb::Key * parents[2] = { *parentA, *parentB };
+	ckdb::KeySet * results[2] = { resultA.getKeySet (), resultB.getKeySet () };
+	ASSERT_EQ (ckdb::kdbGetMulti (kdb.getKdb (), parents, 2, results), 1) << "could not retrieve keys";
+
+	// nothing changed since this handle last read the backends, so the
+	// second pass reports no update and leaves the results alone
+	EXPECT_EQ (ckdb::kdbGetMulti (kdb.getKdb (), parents, 2, results), 0) << "update reported on unchanged backends";
+	EXPECT_EQ (resultA.size (), 3) << "result changed without an update" << resultA;
+	EXPECT_EQ (resultB.size (), 1) << "result changed without an update" << resultB;
+}
+
+TEST_F (Multi, RejectsInvalidParents)
+{
+	using namespace kdb;
+	KDB kdb;
+	Key metaParent ("meta:/tests/multi", KEY_END);
+	KeySet result;
+
+	ckdb::Key * parents[1] = { *metaParent };
+	ckdb::KeySet * results[1] = { result.getKeySet () };
+	EXPECT_EQ (ckdb::kdbGetMulti (kdb.getKdb (), parents, 1, results), -1) << "metakey accepted as parent";
+	EXPECT_EQ (ckdb::kdbGetMulti (kdb.getKdb (), nullptr, 1, results), -1);
+	EXPECT_EQ (ckdb::kdbGetMulti (kdb.getKdb (), parents, 0, results), 0) << "zero parents are not an error";
+}
@@ -0,0 +1,234 @@
+/**
+ * @file
+ *
+ * @brief Tests for the snapshot API of KDB
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <keysetio.hpp>
+
+#include <gtest/gtest-elektra.h>
+
+#include <kdbprivate.h> // for kdbSnapshot() and friends
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int nrMetaKeys = 20; // enough to make lookups use the namespace slice index
+}
+
+class Snapshot : public ::testing::Test
+{
+protected:
+	static const std::string testRoot;
+	static const std::string configFile;
+
+	testing::Namespaces namespaces;
+	testing::MountpointPtr mp;
+
+	Snapshot () : namespaces ()
+	{
+	}
+
+	virtual void SetUp () override
+	{
+		mp.reset (new testing::Mountpoint (testRoot, configFile));
+	}
+
+	virtual void TearDown () override
+	{
+		mp.reset ();
+	}
+
+	void writeInitialData ()
+	{
+		using namespace kdb;
+		KDB kdb;
+		KeySet ks;
+		kdb.get (ks, testRoot);
+		for (int k = 0; k < 5; ++k)
+		{
+			Key key ("user:" + testRoot + "key" + std::to_string (k), KEY_VALUE, "value", KEY_END);
+			for (int m = 0; m < nrMetaKeys; ++m)
+			{
+				std::string metaName = "meta" + std::to_string (m);
+				key.setMeta (metaName, metaName);
+			}
+			ks.append (key);
+		}
+		kdb.set (ks, testRoot);
+	}
+};
+
+const std::string Snapshot::configFile = "kdbFileSnapshot.dump";
+const std::string Snapshot::testRoot = "/tests/snapshot/";
+
+TEST_F (Snapshot, AcquireRelease)
+{
+	using namespace kdb;
+	writeInitialData ();
+
+	KDB kdb;
+	Key parent (testRoot, KEY_END);
+	ckdb::KdbSnapshot * snapshot = ckdb::kdbSnapshot (kdb.getKdb (), *parent);
+	ASSERT_NE (snapshot, nullptr) << "could not create snapshot";
+	EXPECT_EQ (ckdb::kdbSnapshotGeneration (snapshot), 1u);
+
+	ckdb::KeySet * view = ckdb::kdbSnapshotAcquire (snapshot);
+	ASSERT_NE (view, nullptr) << "could not acquire view";
+	EXPECT_EQ (ckdb::ksGetSize (view), 5);
+
+	ckdb::Key * key = ckdb::ksLookupByName (view, ("user:" + testRoot + "key0").c_str (), 0);
+	ASSERT_NE (key, nullptr) << "key missing from view";
+	EXPECT_STREQ (ckdb::keyString (key), "value");
+
+	// the keys of a view are locked, the configuration cannot be
+	// modified through it
+	EXPECT_EQ (ckdb::keySetString (key, "other"), -1);
+	EXPECT_EQ (ckdb::keySetMeta (key, "meta0", "other"), -1);
+
+	ckdb::kdbSnapshotRelease (snapshot, view);
+	ckdb::kdbSnapshotDel (snapshot);
+}
+
+TEST_F (Snapshot, MetadataLookupIsReadOnly)
+{
+	using namespace kdb;
+	writeInitialData ();
+
+	KDB kdb;
+	Key parent (testRoot, KEY_END);
+	ckdb::KdbSnapshot * snapshot = ckdb::kdbSnapshot (kdb.getKdb (), *parent);
+	ASSERT_NE (snapshot, nullptr) << "could not create snapshot";
+
+	ckdb::KeySet * view = ckdb::kdbSnapshotAcquire (snapshot);
+	ASSERT_NE (view, nullptr) << "could not acquire view";
+
+	ckdb::Key * key = ckdb::ksLookupByName (view, ("user:" + testRoot + "key0").c_str (), 0);
+	ASSERT_NE (key, nullptr) << "key missing from view";
+	ASSERT_NE (key->meta, nullptr) << "key lost its metadata";
+	ASSERT_GT (key->meta->metaRefs, 0u) << "metadata of a view has to be shared with its generation";
+
+	// remember the mutable parts of the shared metadata KeySet: a lookup
+	// on it must not touch any of them
+	ASSERT_GE (ckdb::ksGetSize (key->meta), 16); // big enough for a namespace slice index
+	auto * nsIndexBefore = key->meta->nsIndex;
+	size_t currentBefore = key->meta->current;
+
+	for (int m = 0; m < nrMetaKeys; ++m)
+	{
+		std::string metaName = "meta" + std::to_string (m);
+		const ckdb::Key * meta = ckdb::keyGetMeta (key, metaName.c_str ());
+		ASSERT_NE (meta, nullptr) << "metakey " << metaName << " missing";
+		EXPECT_EQ (ckdb::keyString (meta), metaName);
+	}
+	EXPECT_EQ (ckdb::keyGetMeta (key, "does/not/exist"), nullptr);
+
+	EXPECT_EQ (key->meta->nsIndex, nsIndexBefore) << "metadata lookup built an index on a shared KeySet";
+	EXPECT_EQ (key->meta->current, currentBefore) << "metadata lookup moved the cursor of a shared KeySet";
+
+	ckdb::kdbSnapshotRelease (snapshot, view);
+	ckdb::kdbSnapshotDel (snapshot);
+}
+
+TEST_F (Snapshot, ConcurrentMetadataLookups)
+{
+	using namespace kdb;
+	writeInitialData ();
+
+	KDB kdb;
+	Key parent (testRoot, KEY_END);
+	ckdb::KdbSnapshot * snapshot = ckdb::kdbSnapshot (kdb.getKdb (), *parent);
+	ASSERT_NE (snapshot, nullptr) << "could not create snapshot";
+
+	// every thread queries its own view; the metadata KeySets behind the
+	// views are shared, so this races unless the lookup path is genuinely
+	// read-only (run with a thread sanitizer to also catch benign-looking
+	// unordered writes)
+	const int nrThreads = 4;
+	const int nrRounds = 500;
+	std::vector<std::thread> threads;
+	std::vector<int> errors (nrThreads, 0);
+	for (int t = 0; t < nrThreads; ++t)
+	{
+		threads.emplace_back ([this, snapshot, &errors, t] {
+			for (int round = 0; round < nrRounds; ++round)
+			{
+				ckdb::KeySet * view = ckdb::kdbSnapshotAcquire (snapshot);
+				if (view == nullptr)
+				{
+					++errors[t];
+					continue;
+				}
+				for (int k = 0; k < 5; ++k)
+				{
+					std::string name = "user:" + testRoot + "key" + std::to_string (k);
+					ckdb::Key * key = ckdb::ksLookupByName (view, name.c_str (), 0);
+					if (key == nullptr)
+					{
+						++errors[t];
+						continue;
+					}
+					for (int m = 0; m < nrMetaKeys; ++m)
+					{
+						std::string metaName = "meta" + std::to_string (m);
+						const ckdb::Key * meta = ckdb::keyGetMeta (key, metaName.c_str ());
+						if (meta == nullptr || metaName != ckdb::keyString (meta)) ++errors[t];
+					}
+				}
+				ckdb::kdbSnapshotRelease (snapshot, view);
+			}
+		});
+	}
+	for (auto & thread : threads)
+	{
+		thread.join ();
+	}
+	for (int t = 0; t < nrThreads; ++t)
+	{
+		EXPECT_EQ (errors[t], 0) << "thread " << t << " saw wrong metadata";
+	}
+
+	ckdb::kdbSnapshotDel (snapshot);
+}
+
+TEST_F (Snapshot, Refresh)
+{
+	using namespace kdb;
+	writeInitialData ();
+
+	KDB kdb;
+	Key parent (testRoot, KEY_END);
+	ckdb::KdbSnapshot * snapshot = ckdb::kdbSnapshot (kdb.getKdb (), *parent);
+	ASSERT_NE (snapshot, nullptr) << "could not create snapshot";
+
+	ckdb::KeySet * oldView = ckdb::kdbSnapshotAcquire (snapshot);
+	ASSERT_NE (oldView, nullptr) << "could not acquire view";
+
+	{
+		// another session changes the configuration
+		KDB writer;
+		KeySet ks;
+		writer.get (ks, testRoot);
+		ks.lookup ("user:" + testRoot + "key0").setString ("changed");
+		writer.set (ks, testRoot);
+	}
+
+	EXPECT_EQ (ckdb::kdbSnapshotRefresh (snapshot, kdb.getKdb (), *parent), 1) << "refresh found no update";
+	EXPECT_EQ (ckdb::kdbSnapshotGeneration (snapshot), 2u);
+
+	ckdb::KeySet * newView = ckdb::kdbSnapshotAcquire (snapshot);
+	ASSERT_NE (newView, nullptr) << "could not acquire view";
+
+	// the old view keeps showing its generation, the new one the change
+	EXPECT_STREQ (ckdb::keyString (ckdb::ksLookupByName (oldView, ("user:" + testRoot + "key0").c_str (), 0)), "value");
+	EXPECT_STREQ (ckdb::keyString (ckdb::ksLookupByName (newView, ("user:" + testRoot + "key0").c_str (), 0)), "changed");
+
+	ckdb::kdbSnapshotRelease (snapshot, newView);
+	ckdb::kdbSnapshotRelease (snapshot, oldView);
+	ckdb::kdbSnapshotDel (snapshot);
+}
@@ -0,0 +1,198 @@
+/**
+ * @file
+ *
+ * @brief Tests for the write-behind contract, kdbFlush() and the implicit flush points
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <keysetio.hpp>
+
+#include <gtest/gtest-elektra.h>
+
+#include <kdbprivate.h> // for kdbFlush()
+
+#include <chrono>
+#include <thread>
+
+class WriteBehind : public ::testing::Test
+{
+protected:
+	static const std::string testRoot;
+	static const std::string configFile;
+
+	testing::Namespaces namespaces;
+	testing::MountpointPtr mp;
+
+	ckdb::KDB * handle = nullptr;
+	ckdb::Key * parent = nullptr;
+	ckdb::KeySet * workingSet = nullptr;
+
+	WriteBehind () : namespaces ()
+	{
+	}
+
+	virtual void SetUp () override
+	{
+		mp.reset (new testing::Mountpoint (testRoot, configFile));
+
+		// an interval long enough to never elapse during a test run, so
+		// every flush observed below was triggered explicitly
+		ckdb::KeySet * contract =
+			ckdb::ksNew (1, ckdb::keyNew ("system:/elektra/contract/writebehind", KEY_VALUE, "3600000", KEY_END), KS_END);
+		parent = ckdb::keyNew (("user:" + testRoot).c_str (), KEY_END);
+		handle = ckdb::kdbOpen (contract, parent);
+		ckdb::ksDel (contract);
+		ASSERT_NE (handle, nullptr) << "could not open handle with write-behind contract";
+		workingSet = ckdb::ksNew (0, KS_END);
+	}
+
+	virtual void TearDown () override
+	{
+		if (workingSet != nullptr) ckdb::ksDel (workingSet);
+		if (handle != nullptr) ckdb::kdbClose (handle, parent);
+		if (parent != nullptr) ckdb::keyDel (parent);
+
+		mp.reset ();
+	}
+
+	// what an independent session without the contract reads from disk
+	std::string onDisk (const std::string & name)
+	{
+		using namespace kdb;
+		KDB plain;
+		KeySet ks;
+		Key parentKey ("user:" + testRoot, KEY_END);
+		plain.get (ks, parentKey);
+		Key found = ks.lookup (name);
+		return found ? found.getString () : "";
+	}
+};
+
+const std::string WriteBehind::configFile = "kdbFileWriteBehind.dump";
+const std::string WriteBehind::testRoot = "/tests/writebehind/";
+
+TEST_F (WriteBehind, DefersAndFlushes)
+{
+	using namespace kdb;
+	ASSERT_NE (ckdb::kdbGet (handle, workingSet, parent), -1);
+	ckdb::ksAppendKey (workingSet, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	ASSERT_EQ (ckdb::kdbSet (handle, workingSet, parent), 1);
+
+	// the commit was only recorded, nothing reached the disk yet
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "");
+
+	// the explicit barrier writes it out
+	EXPECT_EQ (ckdb::kdbFlush (handle, parent), 1);
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "v1");
+
+	// nothing pending anymore
+	EXPECT_EQ (ckdb::kdbFlush (handle, parent), 0);
+}
+
+TEST_F (WriteBehind, OnlyNewestCommitIsWritten)
+{
+	using namespace kdb;
+	ASSERT_NE (ckdb::kdbGet (handle, workingSet, parent), -1);
+	ckdb::ksAppendKey (workingSet, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	ASSERT_EQ (ckdb::kdbSet (handle, workingSet, parent), 1);
+
+	// a high-rate update: the second commit replaces the pending one
+	ckdb::keySetString (ckdb::ksLookupByName (workingSet, ("user:" + testRoot + "k1").c_str (), 0), "v2");
+	ASSERT_EQ (ckdb::kdbSet (handle, workingSet, parent), 1);
+
+	EXPECT_EQ (ckdb::kdbFlush (handle, parent), 1);
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "v2");
+}
+
+TEST_F (WriteBehind, ReadYourWrites)
+{
+	using namespace kdb;
+	ASSERT_NE (ckdb::kdbGet (handle, workingSet, parent), -1);
+	ckdb::ksAppendKey (workingSet, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	ASSERT_EQ (ckdb::kdbSet (handle, workingSet, parent), 1);
+
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "");
+
+	// a kdbGet() on the same handle must not read past the deferred
+	// commit: it is forced out to disk before the backends are consulted
+	ckdb::KeySet * readBack = ckdb::ksNew (0, KS_END);
+	ASSERT_NE (ckdb::kdbGet (handle, readBack, parent), -1);
+	ckdb::ksDel (readBack);
+
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "v1") << "kdbGet() did not flush the deferred commit";
+	EXPECT_EQ (ckdb::kdbFlush (handle, parent), 0);
+}
+
+TEST_F (WriteBehind, ParentChangeForcesFlush)
+{
+	using namespace kdb;
+	ASSERT_NE (ckdb::kdbGet (handle, workingSet, parent), -1);
+	ckdb::ksAppendKey (workingSet, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	ASSERT_EQ (ckdb::kdbSet (handle, workingSet, parent), 1);
+
+	// a commit under a different parent key cannot share the pending
+	// snapshot, so the pending commit is written first
+	ckdb::Key * subParent = ckdb::keyNew (("user:" + testRoot + "sub").c_str (), KEY_END);
+	ckdb::ksAppendKey (workingSet, ckdb::keyNew (("user:" + testRoot + "sub/k2").c_str (), KEY_VALUE, "v2", KEY_END));
+	ASSERT_EQ (ckdb::kdbSet (handle, workingSet, subParent), 1);
+
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "v1") << "pending commit not flushed on parent change";
+	EXPECT_EQ (onDisk ("user:" + testRoot + "sub/k2"), "") << "new commit was not deferred";
+
+	EXPECT_EQ (ckdb::kdbFlush (handle, subParent), 1);
+	EXPECT_EQ (onDisk ("user:" + testRoot + "sub/k2"), "v2");
+	ckdb::keyDel (subParent);
+}
+
+TEST_F (WriteBehind, IntervalTriggersFlush)
+{
+	using namespace kdb;
+	// a separate handle with a 1 ms interval: the second commit after a
+	// short sleep must hit the disk without any explicit flush
+	ckdb::KeySet * contract = ckdb::ksNew (1, ckdb::keyNew ("system:/elektra/contract/writebehind", KEY_VALUE, "1", KEY_END), KS_END);
+	ckdb::KDB * fast = ckdb::kdbOpen (contract, parent);
+	ckdb::ksDel (contract);
+	ASSERT_NE (fast, nullptr);
+
+	ckdb::KeySet * ks = ckdb::ksNew (0, KS_END);
+	ASSERT_NE (ckdb::kdbGet (fast, ks, parent), -1);
+	ckdb::ksAppendKey (ks, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	ASSERT_EQ (ckdb::kdbSet (fast, ks, parent), 1);
+
+	std::this_thread::sleep_for (std::chrono::milliseconds (10));
+	ckdb::keySetString (ckdb::ksLookupByName (ks, ("user:" + testRoot + "k1").c_str (), 0), "v2");
+	ASSERT_EQ (ckdb::kdbSet (fast, ks, parent), 1);
+
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "v2") << "elapsed interval did not trigger a flush";
+
+	ckdb::ksDel (ks);
+	ckdb::kdbClose (fast, parent);
+}
+
+TEST_F (WriteBehind, FlushOnClose)
+{
+	using namespace kdb;
+	ASSERT_NE (ckdb::kdbGet (handle, workingSet, parent), -1);
+	ckdb::ksAppendKey (workingSet, ckdb::keyNew (("user:" + testRoot + "k1").c_str (), KEY_VALUE, "v1", KEY_END));
+	ASSERT_EQ (ckdb::kdbSet (handle, workingSet, parent), 1);
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "");
+
+	// closing the session is the last flush point
+	ASSERT_EQ (ckdb::kdbClose (handle, parent), 0);
+	handle = nullptr;
+
+	EXPECT_EQ (onDisk ("user:" + testRoot + "k1"), "v1") << "deferred commit lost on close";
+}
+
+TEST_F (WriteBehind, WithoutContract)
+{
+	using namespace kdb;
+	KDB plain;
+	Key parentKey ("user:" + testRoot, KEY_END);
+
+	// nothing is ever pending without the contract
+	EXPECT_EQ (ckdb::kdbFlush (plain.getKdb (), *parentKey), 0);
+	EXPECT_EQ (ckdb::kdbFlush (nullptr, *parentKey), -1);
+}